@@ -0,0 +1,36 @@
+// Upsamples the ambient occlusion computed by ge::AmbientOcclusion at a lower resolution
+// than the scene
+
+uniform bool ambientOcclusionEnabled;
+
+// Ambient occlusion and linear depth
+uniform sampler2D ambientOcclusionTexture;
+
+// Inverse of the scene's resolution
+uniform vec2 ambientOcclusionUvScale;
+
+float sampleAmbientOcclusion(float viewDistance) {
+    if (!ambientOcclusionEnabled) return 1.0;
+
+    // Bilinear weights of the 4 closest texels, scaled down for texels whose depth differs
+    // from the fragment's so that occlusion does not bleed across edges
+    vec2 size = vec2(textureSize(ambientOcclusionTexture, 0));
+    vec2 position = gl_FragCoord.xy * ambientOcclusionUvScale * size - 0.5;
+    ivec2 baseTexel = ivec2(floor(position));
+    vec2 f = position - vec2(baseTexel);
+    ivec2 maxTexel = ivec2(size) - 1;
+
+    float occlusion = 0.0;
+    float totalWeight = 0.0;
+    for (int y = 0; y <= 1; ++y) {
+        for (int x = 0; x <= 1; ++x) {
+            vec2 tap = texelFetch(ambientOcclusionTexture, clamp(baseTexel + ivec2(x, y), ivec2(0), maxTexel), 0).rg;
+            vec2 bilinear = mix(1.0 - f, f, vec2(x, y));
+            float weight = bilinear.x * bilinear.y / (0.0001 + abs(tap.g - viewDistance) / viewDistance);
+            occlusion += tap.r * weight;
+            totalWeight += weight;
+        }
+    }
+
+    return occlusion / totalWeight;
+}
@@ -0,0 +1,52 @@
+#version 330 core
+out vec4 fragColor;
+
+in vec2 fragTextureCoordinates;
+
+uniform sampler2D sourceTexture;
+uniform vec2 texelSize;
+
+#ifdef DOWNSAMPLE
+uniform bool prefilter;
+uniform float threshold;
+
+vec3 applyThreshold(vec3 color) {
+    // Quadratic soft knee, so that colors fade in as they approach the threshold
+    float brightness = max(color.r, max(color.g, color.b));
+    float knee = 0.5 * threshold;
+    float soft = clamp(brightness - threshold + knee, 0.0, 2.0 * knee);
+    soft = soft * soft / (4.0 * knee + 0.00001);
+    return color * max(soft, brightness - threshold) / max(brightness, 0.00001);
+}
+
+void main(void) {
+    // Dual Kawase downsampling: the center and 4 diagonal bilinear taps
+    vec2 uv = fragTextureCoordinates;
+    vec3 color = texture(sourceTexture, uv).rgb * 4.0;
+    color += texture(sourceTexture, uv + vec2(-texelSize.x, -texelSize.y)).rgb;
+    color += texture(sourceTexture, uv + vec2(texelSize.x, -texelSize.y)).rgb;
+    color += texture(sourceTexture, uv + vec2(-texelSize.x, texelSize.y)).rgb;
+    color += texture(sourceTexture, uv + vec2(texelSize.x, texelSize.y)).rgb;
+    color /= 8.0;
+
+    fragColor = vec4(prefilter ? applyThreshold(color) : color, 1.0);
+}
+#endif
+
+#ifdef UPSAMPLE
+void main(void) {
+    // Dual Kawase upsampling: 4 edge taps and 4 diagonal taps weighted twice
+    vec2 uv = fragTextureCoordinates;
+    vec3 color = texture(sourceTexture, uv + vec2(-texelSize.x, 0.0)).rgb;
+    color += texture(sourceTexture, uv + vec2(texelSize.x, 0.0)).rgb;
+    color += texture(sourceTexture, uv + vec2(0.0, -texelSize.y)).rgb;
+    color += texture(sourceTexture, uv + vec2(0.0, texelSize.y)).rgb;
+    color += texture(sourceTexture, uv + 0.5 * vec2(-texelSize.x, -texelSize.y)).rgb * 2.0;
+    color += texture(sourceTexture, uv + 0.5 * vec2(texelSize.x, -texelSize.y)).rgb * 2.0;
+    color += texture(sourceTexture, uv + 0.5 * vec2(-texelSize.x, texelSize.y)).rgb * 2.0;
+    color += texture(sourceTexture, uv + 0.5 * vec2(texelSize.x, texelSize.y)).rgb * 2.0;
+
+    // Added onto the next larger level by blending
+    fragColor = vec4(color / 12.0, 1.0);
+}
+#endif
@@ -10,56 +10,167 @@ struct DirectionalLight {
     Lighting lighting;
 };
 
-struct Material {
-    sampler2D diffuseTexture0;
-    sampler2D specularTexture0;
-    float specularExponent;
-};
+#include "materials.glsl"
+#include "velocity.glsl"
+#include "ambient_occlusion.glsl"
+
+#ifdef IMPOSTER
+#include "imposter.glsl"
+
+uniform sampler2D imposterAlbedo;
+uniform sampler2D imposterNormalDepth;
+
+// Samples of the views, see sampleImposter()
+vec4 imposterAlbedoSample;
+vec4 imposterNormalDepthSample;
+#endif
 
-out vec4 fragColor;
+layout (location = 0) out vec4 fragColor;
+layout (location = 1) out vec2 fragVelocity;
 
 in VS_OUT {
     vec3 fragPosition;
     vec3 fragNormal;
     vec2 fragTextureCoordinates;
+    vec4 clipPosition;
+    vec4 previousClipPosition;
+#ifdef IMPOSTER
+    vec2 imposterGridPosition;
+    vec2 imposterClipDepthChange;
+    mat3 imposterNormalMatrix;
+#endif
 } fs_in;
 
 uniform vec3 viewPosition;
-uniform Material material;
 
 uniform DirectionalLight directionalLight;
 
+// Ambient light of the skybox, see Skybox. Without a skybox, the coefficients only
+// hold the constant ambient color of the directional light.
+uniform vec3 irradianceSh[9];
+uniform bool hasSpecularMap;
+uniform samplerCube specularMap;
+uniform float maxSpecularMapLevel;
+
+vec4 sampleTexture(sampler2DArray textureSampler, vec4 uvTransform, float layer);
+void sampleImposter();
+vec3 calculateIrradiance(vec3 normal);
 Lighting calculateBaseLight(vec3 lightDirection, Lighting lighting);
 vec3 calculateDirectionalLight();
 
 void main(void) {
+#ifdef IMPOSTER
+    sampleImposter();
+    if (imposterAlbedoSample.a < 0.5) discard;
+
+    // Move the quad's depth onto the baked surface
+    vec2 clipDepth = fs_in.clipPosition.zw + fs_in.imposterClipDepthChange * (imposterNormalDepthSample.a - 0.5);
+    gl_FragDepth = clipDepth.x / clipDepth.y * 0.5 + 0.5;
+#endif
+
+    // The depth pre-pass only writes depth
+#ifndef DEPTH_ONLY
     vec3 color = calculateDirectionalLight();
 
     fragColor = vec4(color, 1.0);
+    fragVelocity = calculateVelocity(fs_in.clipPosition, fs_in.previousClipPosition);
+#endif
+}
+
+vec4 sampleTexture(sampler2DArray textureSampler, vec4 uvTransform, float layer) {
+    // Textures may be packed into an atlas page. Coordinates are wrapped manually and
+    // gradients are taken before wrapping so that mip selection has no seams.
+    vec2 uv = fs_in.fragTextureCoordinates;
+    return textureGrad(textureSampler, vec3(fract(uv) * uvTransform.xy + uvTransform.zw, layer),
+                       dFdx(uv) * uvTransform.xy, dFdy(uv) * uvTransform.xy);
+}
+
+#ifdef IMPOSTER
+void sampleImposter() {
+    // Blend the 4 views closest to the direction of the camera, which hides the switches
+    // between them
+    float maxView = imposterNumViewsPerSide - 1.0;
+    vec2 baseView = clamp(floor(fs_in.imposterGridPosition), 0.0, max(maxView - 1.0, 0.0));
+    vec2 f = clamp(fs_in.imposterGridPosition - baseView, 0.0, 1.0);
+
+    imposterAlbedoSample = vec4(0.0);
+    imposterNormalDepthSample = vec4(0.0);
+    for (int y = 0; y <= 1; ++y) {
+        for (int x = 0; x <= 1; ++x) {
+            vec2 weights = mix(1.0 - f, f, vec2(x, y));
+            vec2 uv = (min(baseView + vec2(x, y), maxView) + fs_in.fragTextureCoordinates) / imposterNumViewsPerSide;
+            imposterAlbedoSample += texture(imposterAlbedo, uv) * weights.x * weights.y;
+            imposterNormalDepthSample += texture(imposterNormalDepth, uv) * weights.x * weights.y;
+        }
+    }
+
+    // Uncovered texels are zero, so filtered texels are weighted by their coverage
+    float coverage = max(imposterAlbedoSample.a, 0.0001);
+    imposterAlbedoSample.rgb /= coverage;
+    imposterNormalDepthSample /= coverage;
+}
+#endif
+
+vec3 calculateIrradiance(vec3 normal) {
+    // Evaluates the spherical harmonics of the irradiance divided by pi
+    return irradianceSh[0] * 0.282095
+            + irradianceSh[1] * (0.488603 * normal.y)
+            + irradianceSh[2] * (0.488603 * normal.z)
+            + irradianceSh[3] * (0.488603 * normal.x)
+            + irradianceSh[4] * (1.092548 * normal.x * normal.y)
+            + irradianceSh[5] * (1.092548 * normal.y * normal.z)
+            + irradianceSh[6] * (0.315392 * (3.0 * normal.z * normal.z - 1.0))
+            + irradianceSh[7] * (1.092548 * normal.x * normal.z)
+            + irradianceSh[8] * (0.546274 * (normal.x * normal.x - normal.y * normal.y));
 }
 
 Lighting calculateBaseLight(vec3 lightDirection, Lighting lighting) {
     // Calculates Blinn-Phong lighting
     Lighting result;
 
+#ifdef IMPOSTER
+    vec3 normal = normalize(fs_in.imposterNormalMatrix * (imposterNormalDepthSample.rgb * 2.0 - 1.0));
+    vec3 materialDiffuse = imposterAlbedoSample.rgb;
+#else
+    MaterialData material = getMaterial(materialId);
+
+    vec3 normal = normalize(fs_in.fragNormal);
+
     // Sets ambient color the same as the diffuse color
-    vec3 materialDiffuse = texture2D(material.diffuseTexture0, fs_in.fragTextureCoordinates).rgb;
-    result.ambient = lighting.ambient * materialDiffuse;
+    vec3 materialDiffuse = sampleTexture(diffuseTextures, material.diffuseUvTransform,
+                                         material.parameters.x).rgb;
+#endif
+    float ambientOcclusion = sampleAmbientOcclusion(fs_in.clipPosition.w);
+    result.ambient = calculateIrradiance(normal) * materialDiffuse * ambientOcclusion;
 
     // Fragment is brighter the closer it is aligned to the light ray direction
-    float lightAngle = max(dot(fs_in.fragNormal, -lightDirection),
+    float lightAngle = max(dot(normal, -lightDirection),
                            0.0);
     result.diffuse = lighting.diffuse * lightAngle * materialDiffuse;
 
+#if defined(SPECULAR_MAP) && !defined(IMPOSTER)
     // Specular light is brighter the closer the angle btwn the reflected
     // light ray and the viewing vector.
     vec3 viewDirection = normalize(viewPosition - fs_in.fragPosition);
     vec3 halfwayDirection = normalize(-lightDirection + viewDirection);
-    float specularAngle = dot(halfwayDirection, fs_in.fragNormal);
-
-    result.specular = lighting.specular *
-            pow(max(specularAngle, 0.0), material.specularExponent) *
-            texture2D(material.specularTexture0, fs_in.fragTextureCoordinates).rgb;
+    float specularAngle = dot(halfwayDirection, normal);
+
+    // The sky reflected by a GGX lobe about as wide as the Blinn-Phong one, whose
+    // exponent n matches an alpha of sqrt(2 / (n + 2))
+    vec3 ambientSpecular = vec3(0.0);
+    if (hasSpecularMap) {
+        float roughness = sqrt(sqrt(2.0 / (material.parameters.z + 2.0)));
+        ambientSpecular = textureLod(specularMap, reflect(-viewDirection, normal),
+                                     roughness * maxSpecularMapLevel).rgb * ambientOcclusion;
+    }
+
+    result.specular = (lighting.specular * pow(max(specularAngle, 0.0), material.parameters.z) +
+                       ambientSpecular) *
+            sampleTexture(specularTextures, material.specularUvTransform,
+                          material.parameters.y).rgb;
+#else
+    result.specular = vec3(0.0);
+#endif
 
     return result;
 }
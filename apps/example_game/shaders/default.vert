@@ -5,22 +5,108 @@ layout (location = 2) in vec2 vertexTextureCoordinates;
 
 layout (std140) uniform Matrices {
     mat4 view;
+    // Jittered by the offset in normalized device coordinates, see ge::PostProcessor
     mat4 projection;
+    mat4 previousViewProjection;
+    vec2 jitter;
 };
 
+#ifdef INSTANCING
+layout (location = 3) in mat4 instanceModel;
+layout (location = 7) in mat3 instanceNormal;
+#else
 uniform mat4 model;
 uniform mat3 normal;
+uniform mat4 previousModel;
+#endif
+
+#ifdef SKINNING
+#include "skinning.glsl"
+#endif
+
+#ifdef VERTEX_ANIMATION
+#include "vertex_animation.glsl"
+#endif
+
+#ifdef IMPOSTER
+#include "imposter.glsl"
+
+uniform vec3 viewPosition;
+#endif
 
 out VS_OUT {
     vec3 fragPosition;
     vec3 fragNormal;
     vec2 fragTextureCoordinates;
+    vec4 clipPosition;
+    vec4 previousClipPosition;
+#ifdef IMPOSTER
+    // Position of the direction of the camera in the grid of views
+    vec2 imposterGridPosition;
+    // Change of the clip depth and w per unit of the baked depth
+    vec2 imposterClipDepthChange;
+    mat3 imposterNormalMatrix;
+#endif
 } vs_out;
 
+// The depth pre-pass is drawn with another variant, whose depths must match exactly
+invariant gl_Position;
+
 void main(void)
 {
-    gl_Position = projection * view * model * vec4(vertexPosition, 1.0);
-    vs_out.fragPosition = vertexPosition;
-    vs_out.fragNormal = normalize(vec3(projection * vec4(normal * vertexNormal, 0)));
+#ifdef INSTANCING
+    mat4 model = instanceModel;
+    mat3 normal = instanceNormal;
+#else
+    // Previous model matrices that were not set are all zeros
+    mat4 previousModelMatrix = previousModel[3][3] == 0.0 ? model : previousModel;
+#endif
+
+#if defined(IMPOSTER)
+    // Quad around the bounding sphere facing the camera. The normal matrix holds the
+    // inverse of the model's rotation and scale.
+    vec3 center = vec3(model * vec4(imposterBoundingSphere.xyz, 1.0));
+    vec3 viewDirectionModel = clampToHemisphere(transpose(normal) * (viewPosition - center));
+    vec3 position = imposterBoundingSphere.xyz +
+            getImposterBasis(viewDirectionModel) * vec3(vertexPosition.xy * imposterBoundingSphere.w, 0.0);
+    vec3 vertexNormalModel = viewDirectionModel;
+#elif defined(VERTEX_ANIMATION)
+    vec3 position;
+    vec3 vertexNormalModel;
+    getAnimatedVertex(position, vertexNormalModel);
+#elif defined(SKINNING)
+    mat4 skin = getSkinMatrix();
+    vec3 position = vec3(skin * vec4(vertexPosition, 1.0));
+    vec3 vertexNormalModel = mat3(skin) * vertexNormal;
+#else
+    vec3 position = vertexPosition;
+    vec3 vertexNormalModel = vertexNormal;
+#endif
+
+    // Lighting is computed in world space
+    vec4 worldPosition = model * vec4(position, 1.0);
+    gl_Position = projection * view * worldPosition;
+    vs_out.clipPosition = gl_Position - vec4(jitter * gl_Position.w, 0.0, 0.0);
+#ifdef INSTANCING
+    // The previous model matrices of instances are not kept, so their velocity moves the
+    // history off the screen, which temporal anti-aliasing rejects instead of ghosting
+    // behind moving instances
+    vs_out.previousClipPosition = vs_out.clipPosition - vec4(4.0 * vs_out.clipPosition.w, 0.0, 0.0, 0.0);
+#else
+    vs_out.previousClipPosition = previousViewProjection * previousModelMatrix * vec4(position, 1.0);
+#endif
+    vs_out.fragPosition = vec3(worldPosition);
+    vs_out.fragNormal = normalize(normal * vertexNormalModel);
     vs_out.fragTextureCoordinates = vertexTextureCoordinates;
+
+#ifdef IMPOSTER
+    vs_out.fragTextureCoordinates = vertexPosition.xy * 0.5 + 0.5;
+    vs_out.imposterGridPosition = (encodeHemiOctahedron(viewDirectionModel) * 0.5 + 0.5) *
+            (imposterNumViewsPerSide - 1.0);
+
+    // Baked depths go from 0 at the camera side of the sphere to 1 at the other
+    vec3 depthChange = mat3(model) * viewDirectionModel * (-2.0 * imposterBoundingSphere.w);
+    vs_out.imposterClipDepthChange = (projection * view * vec4(depthChange, 0.0)).zw;
+    vs_out.imposterNormalMatrix = normal;
+#endif
 }
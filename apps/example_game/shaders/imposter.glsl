@@ -0,0 +1,24 @@
+// Views of a model baked over the upper hemisphere by ge::Imposter
+
+// Center and radius of the model's bounding sphere in model space
+uniform vec4 imposterBoundingSphere;
+uniform float imposterNumViewsPerSide;
+
+vec3 clampToHemisphere(vec3 direction) {
+    // Views from below the horizon show the model from the horizon
+    direction.z = max(direction.z, 0.0);
+    return length(direction) > 0.0 ? normalize(direction) : vec3(0.0, 0.0, 1.0);
+}
+
+vec2 encodeHemiOctahedron(vec3 direction) {
+    // Inverse of the mapping of the views' grid onto the hemisphere, in [-1, 1]
+    direction /= abs(direction.x) + abs(direction.y) + direction.z;
+    return vec2(direction.x + direction.y, direction.x - direction.y);
+}
+
+mat3 getImposterBasis(vec3 direction) {
+    // Right, up and view directions of the view of the direction, like glm::lookAt()
+    vec3 up = abs(direction.z) > 0.999 ? vec3(0.0, 1.0, 0.0) : vec3(0.0, 0.0, 1.0);
+    vec3 right = normalize(cross(up, direction));
+    return mat3(right, cross(direction, right), direction);
+}
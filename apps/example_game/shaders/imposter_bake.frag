@@ -0,0 +1,23 @@
+#version 330 core
+#include "materials.glsl"
+
+layout (location = 0) out vec4 fragAlbedo;
+layout (location = 1) out vec4 fragNormalDepth;
+
+in VS_OUT {
+    vec3 fragNormal;
+    vec2 fragTextureCoordinates;
+} fs_in;
+
+void main(void) {
+    // Sampled like default.frag, which the imposters are lit by
+    MaterialData material = getMaterial(materialId);
+    vec2 uv = fs_in.fragTextureCoordinates;
+    vec4 uvTransform = material.diffuseUvTransform;
+    vec3 albedo = textureGrad(diffuseTextures, vec3(fract(uv) * uvTransform.xy + uvTransform.zw, material.parameters.x),
+                              dFdx(uv) * uvTransform.xy, dFdy(uv) * uvTransform.xy).rgb;
+
+    // Full coverage, the depth is 0.5 on the plane through the center of the sphere
+    fragAlbedo = vec4(albedo, 1.0);
+    fragNormalDepth = vec4(normalize(fs_in.fragNormal) * 0.5 + 0.5, gl_FragCoord.z);
+}
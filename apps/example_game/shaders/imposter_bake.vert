@@ -0,0 +1,20 @@
+#version 330 core
+layout (location = 0) in vec3 vertexPosition;
+layout (location = 1) in vec3 vertexNormal;
+layout (location = 2) in vec2 vertexTextureCoordinates;
+
+// Orthographic view of the model's bounding sphere, see ge::Imposter
+uniform mat4 viewProjection;
+
+out VS_OUT {
+    vec3 fragNormal;
+    vec2 fragTextureCoordinates;
+} vs_out;
+
+void main(void)
+{
+    // Meshes are baked in model space and their bind pose
+    gl_Position = viewProjection * vec4(vertexPosition, 1.0);
+    vs_out.fragNormal = vertexNormal;
+    vs_out.fragTextureCoordinates = vertexTextureCoordinates;
+}
@@ -0,0 +1,20 @@
+struct MaterialData {
+    vec4 diffuseUvTransform;
+    vec4 specularUvTransform;
+    vec4 parameters; // diffuse layer, specular layer, specular exponent, padding
+};
+
+// 3 texels per material, see MaterialRegistry
+uniform samplerBuffer materials;
+
+uniform int materialId;
+uniform sampler2DArray diffuseTextures;
+uniform sampler2DArray specularTextures;
+
+MaterialData getMaterial(int id) {
+    MaterialData material;
+    material.diffuseUvTransform = texelFetch(materials, 3 * id);
+    material.specularUvTransform = texelFetch(materials, 3 * id + 1);
+    material.parameters = texelFetch(materials, 3 * id + 2);
+    return material;
+}
@@ -0,0 +1,27 @@
+#version 330 core
+out vec4 fragColor;
+
+in VS_OUT {
+    vec2 fragTextureCoordinates;
+    vec4 fragColor;
+} fs_in;
+
+uniform bool hasTexture;
+uniform sampler2DArray particleTexture;
+uniform vec4 uvTransform;
+uniform float textureLayer;
+
+void main(void) {
+    vec4 color = fs_in.fragColor;
+    vec2 uv = fs_in.fragTextureCoordinates;
+
+    if (hasTexture) {
+        color *= texture(particleTexture, vec3(uv * uvTransform.xy + uvTransform.zw, textureLayer));
+    } else {
+        // Soft round particle
+        float distance = length(uv * 2.0 - 1.0);
+        color.a *= 1.0 - smoothstep(0.5, 1.0, distance);
+    }
+
+    fragColor = color;
+}
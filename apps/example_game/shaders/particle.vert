@@ -0,0 +1,30 @@
+#version 330 core
+layout (location = 0) in vec2 vertexCorner;
+layout (location = 1) in vec4 instancePositionSize;
+layout (location = 2) in vec4 instanceColor;
+layout (location = 3) in float instanceNormalizedAge;
+
+layout (std140) uniform Matrices {
+    mat4 view;
+    mat4 projection;
+};
+
+out VS_OUT {
+    vec2 fragTextureCoordinates;
+    vec4 fragColor;
+} vs_out;
+
+void main(void)
+{
+    // The camera's right and up vectors are the first two rows of the view rotation
+    vec3 right = vec3(view[0][0], view[1][0], view[2][0]);
+    vec3 up = vec3(view[0][1], view[1][1], view[2][1]);
+    vec3 position = instancePositionSize.xyz
+            + (right * vertexCorner.x + up * vertexCorner.y) * instancePositionSize.w;
+
+    gl_Position = projection * view * vec4(position, 1.0);
+    vs_out.fragTextureCoordinates = vertexCorner + 0.5;
+
+    // Fade out over the particle's lifetime
+    vs_out.fragColor = vec4(instanceColor.rgb, instanceColor.a * (1.0 - instanceNormalizedAge));
+}
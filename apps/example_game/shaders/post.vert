@@ -0,0 +1,11 @@
+#version 330 core
+out vec2 fragTextureCoordinates;
+
+void main(void)
+{
+    // Triangle (-1, -1), (3, -1), (-1, 3) covering the whole render target
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+    gl_Position = vec4(position, 0.0, 1.0);
+
+    fragTextureCoordinates = position * 0.5 + 0.5;
+}
@@ -0,0 +1,33 @@
+#define MAX_BONES 128
+
+layout (location = 10) in ivec4 vertexBoneIds;
+layout (location = 11) in vec4 vertexBoneWeights;
+
+#ifdef INSTANCING
+// Skin matrices of all instances, numBones per instance, each stored as 4 texels (columns).
+uniform samplerBuffer boneMatrices;
+uniform int numBones;
+
+mat4 getBoneMatrix(int bone) {
+    int texel = 4 * (gl_InstanceID * numBones + bone);
+    return mat4(texelFetch(boneMatrices, texel),
+                texelFetch(boneMatrices, texel + 1),
+                texelFetch(boneMatrices, texel + 2),
+                texelFetch(boneMatrices, texel + 3));
+}
+#else
+layout (std140) uniform Bones {
+    mat4 bones[MAX_BONES];
+};
+
+mat4 getBoneMatrix(int bone) {
+    return bones[bone];
+}
+#endif
+
+mat4 getSkinMatrix() {
+    return vertexBoneWeights.x * getBoneMatrix(vertexBoneIds.x)
+            + vertexBoneWeights.y * getBoneMatrix(vertexBoneIds.y)
+            + vertexBoneWeights.z * getBoneMatrix(vertexBoneIds.z)
+            + vertexBoneWeights.w * getBoneMatrix(vertexBoneIds.w);
+}
@@ -1,11 +1,17 @@
 #version 330 core
 #extension GL_NV_shadow_samplers_cube : enable
-out vec4 fragColor;
+#include "velocity.glsl"
+
+layout (location = 0) out vec4 fragColor;
+layout (location = 1) out vec2 fragVelocity;
 
 in vec3 fragTextureCoordinates;
+in vec4 clipPosition;
+in vec4 previousClipPosition;
 
 uniform samplerCube skybox;
 
 void main(void) {
     fragColor = textureCube(skybox, fragTextureCoordinates);
+    fragVelocity = calculateVelocity(clipPosition, previousClipPosition);
 }
@@ -3,15 +3,23 @@ layout (location = 0) in vec3 vertexPosition;
 
 layout (std140) uniform Matrices {
     mat4 view;
+    // Jittered by the offset in normalized device coordinates, see ge::PostProcessor
     mat4 projection;
+    mat4 previousViewProjection;
+    vec2 jitter;
 };
 
 out vec3 fragTextureCoordinates;
+out vec4 clipPosition;
+out vec4 previousClipPosition;
 
 void main(void)
 {
+    // Drawn at infinity, so the view matrices only hold the camera's rotation
     vec4 position = projection * view * vec4(vertexPosition, 1.0);
     gl_Position = position.xyww;
 
     fragTextureCoordinates = vertexPosition;
+    clipPosition = gl_Position - vec4(jitter * gl_Position.w, 0.0, 0.0);
+    previousClipPosition = (previousViewProjection * vec4(vertexPosition, 1.0)).xyww;
 }
@@ -0,0 +1,108 @@
+#version 330 core
+out vec2 fragOcclusion;
+
+in vec2 fragTextureCoordinates;
+
+#define NUM_SAMPLES 8
+
+uniform sampler2D depthTexture;
+
+// Elements (0, 0), (1, 1), (2, 0) and (2, 1) of the projection, and (2, 2) and (3, 2)
+uniform vec4 projectionParameters;
+uniform vec2 depthParameters;
+
+// Ratio of the depth texture's resolution to the occlusion's
+uniform int downsampleFactor;
+
+uniform float radius;
+uniform float intensity;
+
+// Offsets the noise in every frame, 0 if the noise is static
+uniform float noiseFrame;
+
+// Points in the hemisphere around +z, denser towards its center
+const vec3 kernel[NUM_SAMPLES] = vec3[](
+    vec3(0.0397, 0.0000, 0.1069),
+    vec3(-0.0672, 0.0615, 0.1270),
+    vec3(0.0144, -0.1639, 0.1558),
+    vec3(0.1635, 0.2132, 0.1828),
+    vec3(-0.3998, -0.0707, 0.1976),
+    vec3(0.4859, -0.3091, 0.1895),
+    vec3(-0.2012, 0.7485, 0.1479),
+    vec3(-0.4600, -0.8857, 0.0625)
+);
+
+float linearizeDepth(float depth) {
+    // Distance along the view direction, i.e. -z in view space
+    return depthParameters.y / (depth * 2.0 - 1.0 + depthParameters.x);
+}
+
+vec3 getViewPosition(ivec2 texel) {
+    vec2 size = vec2(textureSize(depthTexture, 0));
+    vec2 ndc = (vec2(texel) + 0.5) / size * 2.0 - 1.0;
+    float viewDistance = linearizeDepth(texelFetch(depthTexture, texel, 0).r);
+    return vec3((ndc + projectionParameters.zw) * viewDistance / projectionParameters.xy, -viewDistance);
+}
+
+vec3 calculateNormal(ivec2 texel, vec3 position) {
+    // Differences towards the neighbors on the same surface, i.e. the closer ones in
+    // depth, so that normals do not bend around edges
+    ivec2 maxTexel = textureSize(depthTexture, 0) - 1;
+    vec3 left = getViewPosition(clamp(texel - ivec2(1, 0), ivec2(0), maxTexel)) - position;
+    vec3 right = getViewPosition(clamp(texel + ivec2(1, 0), ivec2(0), maxTexel)) - position;
+    vec3 bottom = getViewPosition(clamp(texel - ivec2(0, 1), ivec2(0), maxTexel)) - position;
+    vec3 top = getViewPosition(clamp(texel + ivec2(0, 1), ivec2(0), maxTexel)) - position;
+
+    vec3 dx = abs(right.z) < abs(left.z) ? right : -left;
+    vec3 dy = abs(top.z) < abs(bottom.z) ? top : -bottom;
+    return normalize(cross(dx, dy));
+}
+
+float interleavedGradientNoise(vec2 pixel) {
+    pixel += noiseFrame * 5.588238;
+    return fract(52.9829189 * fract(dot(pixel, vec2(0.06711056, 0.00583715))));
+}
+
+void main(void) {
+    ivec2 texel = ivec2(gl_FragCoord.xy) * downsampleFactor + downsampleFactor / 2;
+    texel = min(texel, textureSize(depthTexture, 0) - 1);
+
+    float depth = texelFetch(depthTexture, texel, 0).r;
+    if (depth == 1.0) {
+        // Nothing was drawn, e.g. the sky
+        fragOcclusion = vec2(1.0, linearizeDepth(depth));
+        return;
+    }
+
+    vec3 position = getViewPosition(texel);
+    vec3 normal = calculateNormal(texel, position);
+
+    // Rotate the kernel around the normal by a different angle in every pixel
+    float angle = interleavedGradientNoise(gl_FragCoord.xy) * 6.2831853;
+    vec3 helper = abs(normal.z) < 0.999 ? vec3(0.0, 0.0, 1.0) : vec3(1.0, 0.0, 0.0);
+    vec3 tangent = normalize(cross(helper, normal));
+    vec3 bitangent = cross(normal, tangent);
+    vec3 rotatedTangent = tangent * cos(angle) + bitangent * sin(angle);
+    vec3 rotatedBitangent = cross(normal, rotatedTangent);
+    mat3 tbn = mat3(rotatedTangent, rotatedBitangent, normal);
+
+    float occlusion = 0.0;
+    for (int i = 0; i < NUM_SAMPLES; ++i) {
+        vec3 samplePosition = position + tbn * kernel[i] * radius;
+
+        // Project the sample onto the depth texture
+        vec2 ndc = samplePosition.xy * projectionParameters.xy / -samplePosition.z - projectionParameters.zw;
+        vec2 uv = ndc * 0.5 + 0.5;
+        if (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0)))) continue;
+
+        float sceneDistance = linearizeDepth(textureLod(depthTexture, uv, 0.0).r);
+
+        // Occluded if the scene is in front of the sample, fading out for surfaces far in
+        // front of the pixel so that foreground objects do not darken the background
+        float bias = 0.02 * radius;
+        float rangeCheck = smoothstep(0.0, 1.0, radius / abs(-position.z - sceneDistance));
+        occlusion += (sceneDistance <= -samplePosition.z - bias ? 1.0 : 0.0) * rangeCheck;
+    }
+
+    fragOcclusion = vec2(pow(1.0 - occlusion / float(NUM_SAMPLES), intensity), -position.z);
+}
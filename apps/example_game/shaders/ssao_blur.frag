@@ -0,0 +1,37 @@
+#version 330 core
+out vec2 fragOcclusion;
+
+in vec2 fragTextureCoordinates;
+
+// Ambient occlusion and linear depth
+uniform sampler2D sourceTexture;
+
+// Step between the taps in texels, (1, 0) or (0, 1)
+uniform vec2 direction;
+
+// Gaussian weights of the taps at offsets 0 to 4
+const float weights[5] = float[](0.2270, 0.1946, 0.1216, 0.0541, 0.0162);
+
+void main(void) {
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    ivec2 maxTexel = textureSize(sourceTexture, 0) - 1;
+    ivec2 offset = ivec2(direction);
+
+    vec2 center = texelFetch(sourceTexture, texel, 0).rg;
+    float occlusion = center.r * weights[0];
+    float totalWeight = weights[0];
+
+    for (int i = 1; i <= 4; ++i) {
+        for (int side = -1; side <= 1; side += 2) {
+            vec2 tap = texelFetch(sourceTexture, clamp(texel + offset * i * side, ivec2(0), maxTexel), 0).rg;
+
+            // Taps on other surfaces, relative to the distance, barely contribute
+            float depthDifference = abs(tap.g - center.g) / max(center.g, 0.0001);
+            float weight = weights[i] * exp(-depthDifference * depthDifference * 1000.0);
+            occlusion += tap.r * weight;
+            totalWeight += weight;
+        }
+    }
+
+    fragOcclusion = vec2(occlusion / totalWeight, center.g);
+}
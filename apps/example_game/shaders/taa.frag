@@ -0,0 +1,135 @@
+#version 330 core
+out vec4 fragColor;
+
+in vec2 fragTextureCoordinates;
+
+// Jittered scene, possibly at a lower resolution than the output
+uniform sampler2D sceneTexture;
+uniform sampler2D velocityTexture;
+uniform sampler2D depthTexture;
+
+// Resolved output of the previous frame
+uniform sampler2D historyTexture;
+uniform bool historyValid;
+
+// Offset of the scene's samples in texels
+uniform vec2 jitter;
+
+// Weight of the current frame where its samples cover the pixel
+uniform float blendFactor;
+
+vec3 rgbToYcocg(vec3 color) {
+    return vec3(0.25 * color.r + 0.5 * color.g + 0.25 * color.b,
+                0.5 * color.r - 0.5 * color.b,
+                -0.25 * color.r + 0.5 * color.g - 0.25 * color.b);
+}
+
+vec3 ycocgToRgb(vec3 color) {
+    return vec3(color.x + color.y - color.z, color.x + color.z, color.x - color.y - color.z);
+}
+
+float luminance(vec3 color) {
+    return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
+
+vec3 sampleHistory(vec2 uv) {
+    // Catmull-Rom filtering with 5 bilinear taps, the corners barely contribute. It keeps
+    // the history sharp when reprojected between texels.
+    vec2 size = vec2(textureSize(historyTexture, 0));
+    vec2 position = uv * size;
+    vec2 center = floor(position - 0.5) + 0.5;
+    vec2 f = position - center;
+
+    vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+    vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+    vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+    vec2 w3 = f * f * (-0.5 + 0.5 * f);
+    vec2 w12 = w1 + w2;
+
+    vec2 uv0 = (center - 1.0) / size;
+    vec2 uv12 = (center + w2 / w12) / size;
+    vec2 uv3 = (center + 2.0) / size;
+
+    vec3 color = texture(historyTexture, vec2(uv12.x, uv0.y)).rgb * w12.x * w0.y;
+    color += texture(historyTexture, vec2(uv0.x, uv12.y)).rgb * w0.x * w12.y;
+    color += texture(historyTexture, uv12).rgb * w12.x * w12.y;
+    color += texture(historyTexture, vec2(uv3.x, uv12.y)).rgb * w3.x * w12.y;
+    color += texture(historyTexture, vec2(uv12.x, uv3.y)).rgb * w12.x * w3.y;
+    float weight = w12.x * w0.y + w0.x * w12.y + w12.x * w12.y + w3.x * w12.y + w12.x * w3.y;
+
+    return max(color / weight, 0.0);
+}
+
+vec3 clipToBox(vec3 color, vec3 boxMin, vec3 boxMax) {
+    // Move the color towards the center of the box until it is inside
+    vec3 center = 0.5 * (boxMax + boxMin);
+    vec3 extents = 0.5 * (boxMax - boxMin) + 0.00001;
+    vec3 offset = color - center;
+    vec3 units = abs(offset / extents);
+    float maxUnit = max(units.x, max(units.y, units.z));
+    return maxUnit > 1.0 ? center + offset / maxUnit : color;
+}
+
+void main(void) {
+    vec2 sceneSize = vec2(textureSize(sceneTexture, 0));
+    ivec2 maxTexel = ivec2(sceneSize) - 1;
+
+    // Position of the pixel in the scene, and the texel whose jittered sample is closest
+    vec2 position = fragTextureCoordinates * sceneSize;
+    ivec2 centerTexel = ivec2(floor(position + jitter));
+
+    // Reconstruct the pixel from the 3x3 samples around it, weighted by their distance to
+    // its center, and gather the statistics of the neighborhood
+    vec3 color = vec3(0.0);
+    float totalWeight = 0.0;
+    float maxWeight = 0.0;
+    vec3 moment1 = vec3(0.0);
+    vec3 moment2 = vec3(0.0);
+    float closestDepth = 1.0;
+    ivec2 closestTexel = centerTexel;
+
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            ivec2 texel = clamp(centerTexel + ivec2(x, y), ivec2(0), maxTexel);
+            vec3 sampleColor = texelFetch(sceneTexture, texel, 0).rgb;
+
+            // Gaussian approximation of the Blackman-Harris window
+            vec2 offset = vec2(texel) + 0.5 - jitter - position;
+            float weight = exp(-2.29 * dot(offset, offset));
+            color += sampleColor * weight;
+            totalWeight += weight;
+            maxWeight = max(maxWeight, weight);
+
+            vec3 ycocg = rgbToYcocg(sampleColor);
+            moment1 += ycocg;
+            moment2 += ycocg * ycocg;
+
+            // Dilate the velocities, so that edges move with the closest surface
+            float depth = texelFetch(depthTexture, texel, 0).r;
+            if (depth < closestDepth) {
+                closestDepth = depth;
+                closestTexel = texel;
+            }
+        }
+    }
+    color /= totalWeight;
+
+    vec2 historyUv = fragTextureCoordinates - texelFetch(velocityTexture, closestTexel, 0).rg;
+    if (!historyValid || any(lessThan(historyUv, vec2(0.0))) || any(greaterThan(historyUv, vec2(1.0)))) {
+        fragColor = vec4(color, 1.0);
+        return;
+    }
+
+    // Clamp the history to the colors of the neighborhood, which rejects the history of
+    // surfaces that were occluded or changed
+    vec3 mean = moment1 / 9.0;
+    vec3 deviation = sqrt(abs(moment2 / 9.0 - mean * mean));
+    vec3 history = ycocgToRgb(clipToBox(rgbToYcocg(sampleHistory(historyUv)),
+                                        mean - deviation, mean + deviation));
+
+    // Samples far from the pixel contribute less, and bright samples are weighted down so
+    // that they do not flicker as they move between pixels
+    float currentWeight = blendFactor * maxWeight / (1.0 + luminance(color));
+    float historyWeight = (1.0 - blendFactor * maxWeight) / (1.0 + luminance(history));
+    fragColor = vec4((color * currentWeight + history * historyWeight) / (currentWeight + historyWeight), 1.0);
+}
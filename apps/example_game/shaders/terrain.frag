@@ -0,0 +1,73 @@
+#version 330 core
+struct Lighting {
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+struct DirectionalLight {
+    vec3 direction;
+    Lighting lighting;
+};
+
+#include "velocity.glsl"
+#include "ambient_occlusion.glsl"
+
+layout (location = 0) out vec4 fragColor;
+layout (location = 1) out vec2 fragVelocity;
+
+in VS_OUT {
+    vec3 fragPosition;
+    vec2 fragTerrainCoordinates;
+    vec4 clipPosition;
+    vec4 previousClipPosition;
+} fs_in;
+
+uniform sampler2D heightmap;
+uniform vec2 terrainSize;
+uniform vec2 heightRange;
+
+uniform bool hasTexture;
+uniform sampler2DArray terrainTexture;
+uniform vec4 uvTransform;
+uniform float textureLayer;
+uniform vec2 numTextureRepeat;
+
+uniform DirectionalLight directionalLight;
+
+vec3 calculateNormal()
+{
+    // Central differences of the heightmap, so that lighting does not change with
+    // the level of detail
+    vec2 size = vec2(textureSize(heightmap, 0));
+    vec2 texelSize = 1.0 / size;
+    vec2 uv = (fs_in.fragTerrainCoordinates * (size - 1.0) + 0.5) / size;
+
+    float left = textureLod(heightmap, uv - vec2(texelSize.x, 0.0), 0.0).r;
+    float right = textureLod(heightmap, uv + vec2(texelSize.x, 0.0), 0.0).r;
+    float bottom = textureLod(heightmap, uv - vec2(0.0, texelSize.y), 0.0).r;
+    float top = textureLod(heightmap, uv + vec2(0.0, texelSize.y), 0.0).r;
+
+    vec2 texelSize_m = terrainSize / (size - 1.0);
+    float heightScale = heightRange.y - heightRange.x;
+    return normalize(vec3((left - right) * heightScale / (2.0 * texelSize_m.x),
+                          (bottom - top) * heightScale / (2.0 * texelSize_m.y),
+                          1.0));
+}
+
+void main(void)
+{
+    vec3 color = vec3(0.5);
+    if (hasTexture) {
+        // Coordinates are wrapped manually as in default.frag so that atlas pages work
+        vec2 uv = fs_in.fragTerrainCoordinates * numTextureRepeat;
+        color = textureGrad(terrainTexture, vec3(fract(uv) * uvTransform.xy + uvTransform.zw, textureLayer),
+                            dFdx(uv) * uvTransform.xy, dFdy(uv) * uvTransform.xy).rgb;
+    }
+
+    vec3 lightDirection = normalize(directionalLight.direction);
+    float lightAngle = max(dot(calculateNormal(), -lightDirection), 0.0);
+    vec3 ambient = directionalLight.lighting.ambient * sampleAmbientOcclusion(fs_in.clipPosition.w);
+    fragColor = vec4((ambient + directionalLight.lighting.diffuse * lightAngle) * color, 1.0);
+    fragVelocity = calculateVelocity(fs_in.clipPosition, fs_in.previousClipPosition);
+}
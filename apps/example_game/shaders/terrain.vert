@@ -0,0 +1,60 @@
+#version 330 core
+layout (location = 0) in vec2 gridPosition;
+layout (location = 1) in vec4 instanceChunk;
+
+layout (std140) uniform Matrices {
+    mat4 view;
+    // Jittered by the offset in normalized device coordinates, see ge::PostProcessor
+    mat4 projection;
+    mat4 previousViewProjection;
+    vec2 jitter;
+};
+
+const int MAX_LODS = 16;
+
+uniform sampler2D heightmap;
+uniform vec2 terrainOrigin;
+uniform vec2 terrainSize;
+uniform vec2 heightRange;
+uniform float chunkResolution;
+uniform vec2 morphRanges[MAX_LODS];
+uniform vec3 viewPosition;
+
+out VS_OUT {
+    vec3 fragPosition;
+    vec2 fragTerrainCoordinates;
+    vec4 clipPosition;
+    vec4 previousClipPosition;
+} vs_out;
+
+float sampleHeight(vec2 uv)
+{
+    // Map [0, 1] onto the centers of the first and last texels
+    vec2 size = vec2(textureSize(heightmap, 0));
+    float value = textureLod(heightmap, (uv * (size - 1.0) + 0.5) / size, 0.0).r;
+    return mix(heightRange.x, heightRange.y, value);
+}
+
+void main(void)
+{
+    vec2 chunkOrigin = instanceChunk.xy;
+    float chunkSize = instanceChunk.z;
+    vec2 morphRange = morphRanges[int(instanceChunk.w)];
+
+    vec2 uv = chunkOrigin + gridPosition * chunkSize;
+    vec3 position = vec3(terrainOrigin + uv * terrainSize, sampleHeight(uv));
+
+    // Move odd vertices onto their even neighbors as the chunk approaches the distance
+    // at which it is replaced by its coarser parent
+    float morph = clamp((distance(position, viewPosition) - morphRange.x) / (morphRange.y - morphRange.x),
+                        0.0, 1.0);
+    vec2 morphOffset = fract(gridPosition * chunkResolution * 0.5) * 2.0 / chunkResolution;
+    uv = chunkOrigin + (gridPosition - morphOffset * morph) * chunkSize;
+    position = vec3(terrainOrigin + uv * terrainSize, sampleHeight(uv));
+
+    gl_Position = projection * view * vec4(position, 1.0);
+    vs_out.clipPosition = gl_Position - vec4(jitter * gl_Position.w, 0.0, 0.0);
+    vs_out.previousClipPosition = previousViewProjection * vec4(position, 1.0);
+    vs_out.fragPosition = position;
+    vs_out.fragTerrainCoordinates = uv;
+}
@@ -0,0 +1,27 @@
+#version 330 core
+out vec4 fragColor;
+
+in vec2 fragTextureCoordinates;
+
+uniform sampler2D sceneTexture;
+
+uniform bool bloomEnabled;
+uniform sampler2D bloomTexture;
+uniform float bloomIntensity;
+
+uniform bool tonemappingEnabled;
+uniform float exposure;
+
+vec3 tonemapAces(vec3 color) {
+    // Narkowicz's fit of the ACES filmic curve
+    return clamp((color * (2.51 * color + 0.03)) / (color * (2.43 * color + 0.59) + 0.14), 0.0, 1.0);
+}
+
+void main(void) {
+    vec3 color = texture(sceneTexture, fragTextureCoordinates).rgb;
+    if (bloomEnabled) {
+        color += texture(bloomTexture, fragTextureCoordinates).rgb * bloomIntensity;
+    }
+
+    fragColor = vec4(tonemappingEnabled ? tonemapAces(color * exposure) : clamp(color, 0.0, 1.0), 1.0);
+}
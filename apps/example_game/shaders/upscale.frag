@@ -0,0 +1,35 @@
+#version 330 core
+out vec4 fragColor;
+
+in vec2 fragTextureCoordinates;
+
+uniform sampler2D sourceTexture;
+uniform vec2 texelSize;
+
+uniform bool sharpeningEnabled;
+uniform float sharpness;
+
+void main(void) {
+    // Bilinear upscaling
+    vec2 uv = fragTextureCoordinates;
+    vec3 center = texture(sourceTexture, uv).rgb;
+    if (!sharpeningEnabled) {
+        fragColor = vec4(center, 1.0);
+        return;
+    }
+
+    vec3 north = texture(sourceTexture, uv + vec2(0.0, texelSize.y)).rgb;
+    vec3 south = texture(sourceTexture, uv - vec2(0.0, texelSize.y)).rgb;
+    vec3 east = texture(sourceTexture, uv + vec2(texelSize.x, 0.0)).rgb;
+    vec3 west = texture(sourceTexture, uv - vec2(texelSize.x, 0.0)).rgb;
+
+    // Contrast adaptive sharpening: the negative lobe shrinks where the neighborhood
+    // already spans the displayable range, so that edges do not ring
+    vec3 minColor = min(center, min(min(north, south), min(east, west)));
+    vec3 maxColor = max(center, max(max(north, south), max(east, west)));
+    vec3 amount = sqrt(clamp(min(minColor, 1.0 - maxColor) / max(maxColor, 0.00001), 0.0, 1.0));
+    vec3 weight = -amount / mix(8.0, 5.0, sharpness);
+
+    vec3 color = (center + (north + south + east + west) * weight) / (1.0 + 4.0 * weight);
+    fragColor = vec4(clamp(color, 0.0, 1.0), 1.0);
+}
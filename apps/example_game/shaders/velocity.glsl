@@ -0,0 +1,6 @@
+// Motion of a fragment since the previous frame in texture coordinates, from its clip
+// space positions without jitter in both frames. Written to the velocity buffer read
+// by temporal anti-aliasing.
+vec2 calculateVelocity(vec4 clipPosition, vec4 previousClipPosition) {
+    return (clipPosition.xy / clipPosition.w - previousClipPosition.xy / previousClipPosition.w) * 0.5;
+}
@@ -0,0 +1,36 @@
+#define MAX_ANIMATION_CLIPS 32
+
+// Baked clip index and phase in seconds of the instance
+layout (location = 12) in vec2 instanceAnimation;
+
+// Vertices of every baked frame, see ge::VertexAnimationTexture.
+uniform sampler2D animationPositions;
+uniform sampler2D animationNormals;
+uniform int animationRowsPerFrame;
+
+// First frame, number of frames and frames per second of each baked clip
+uniform vec3 animationClips[MAX_ANIMATION_CLIPS];
+uniform float animationTime;
+
+ivec2 getAnimationTexel(int frame) {
+    int width = textureSize(animationPositions, 0).x;
+    return ivec2(gl_VertexID % width, frame * animationRowsPerFrame + gl_VertexID / width);
+}
+
+void getAnimatedVertex(out vec3 position, out vec3 normal) {
+    vec3 clip = animationClips[int(instanceAnimation.x)];
+    int numFrames = int(clip.y);
+
+    // Baked clips loop, so the last frame blends back into the first one
+    float frame = mod((animationTime + instanceAnimation.y) * clip.z, clip.y);
+    int frame0 = min(int(frame), numFrames - 1);
+    int frame1 = (frame0 + 1) % numFrames;
+    float t = frame - float(frame0);
+
+    ivec2 texel0 = getAnimationTexel(int(clip.x) + frame0);
+    ivec2 texel1 = getAnimationTexel(int(clip.x) + frame1);
+    position = mix(texelFetch(animationPositions, texel0, 0).xyz,
+                   texelFetch(animationPositions, texel1, 0).xyz, t);
+    normal = mix(texelFetch(animationNormals, texel0, 0).xyz,
+                 texelFetch(animationNormals, texel1, 0).xyz, t);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <glm/mat4x4.hpp>
+
+#include "RenderGraph.h"
+#include "ShaderProgram.h"
+
+namespace ge {
+
+///
+/// \brief The AmbientOcclusion class adds the passes computing screen-space ambient
+/// occlusion from the depth of a scene to a render graph.
+///
+/// - Occlusion: at a fraction of the scene's resolution, the view-space position and
+///   normal of every pixel are reconstructed from the depth, and the depths of samples
+///   in the hemisphere above the surface are compared to the scene. The hemisphere is
+///   rotated per pixel by interleaved gradient noise, which the blur and temporal
+///   anti-aliasing turn into a smooth result.
+/// - Blur: a separable 9-tap bilateral filter, which does not blur across depth edges.
+///
+/// The result holds the ambient occlusion and the linear depth of every pixel, so that
+/// shaders upsample it without bleeding across edges either, see ambient_occlusion.glsl.
+/// The graph measures the GPU time of the passes, named "ambient occlusion", "ambient
+/// occlusion blur horizontal" and "ambient occlusion blur vertical".
+///
+/// Must only be used on the thread that owns the GL context.
+///
+class AmbientOcclusion {
+public:
+    ///
+    /// \brief AmbientOcclusion Builds the shaders of the passes.
+    /// \param vertexShaderPath Filepath of the vertex shader drawing a fullscreen triangle.
+    /// \param occlusionShaderPath Filepath of the fragment shader sampling the occlusion.
+    /// \param blurShaderPath Filepath of the fragment shader blurring the occlusion along
+    ///                       one direction.
+    /// \exception std::ios_base::failure Failed to open a file.
+    ///
+    AmbientOcclusion(const std::string &vertexShaderPath, const std::string &occlusionShaderPath,
+                     const std::string &blurShaderPath);
+    ~AmbientOcclusion();
+
+    AmbientOcclusion(const AmbientOcclusion &) = delete;
+    AmbientOcclusion(AmbientOcclusion &&) = delete;
+    AmbientOcclusion& operator=(const AmbientOcclusion &) = delete;
+    AmbientOcclusion& operator=(AmbientOcclusion &&) = delete;
+
+    ///
+    /// \brief addPasses Adds the passes computing the ambient occlusion of a scene.
+    /// \param graph Graph of the frame.
+    /// \param scene Render target whose depth texture holds the opaque surfaces.
+    /// \param projectionMatrix Projection the scene was rendered with, possibly jittered.
+    /// \param temporal Whether the noise should change every frame, to be accumulated by
+    ///                 temporal anti-aliasing.
+    /// \return Render target holding the ambient occlusion in its red channel, and the
+    ///         linear depth in its green channel.
+    /// \exception ge::Error The scene has no depth texture.
+    ///
+    RenderGraph::Resource addPasses(RenderGraph *graph, RenderGraph::Resource scene,
+                                    const glm::mat4 &projectionMatrix, bool temporal);
+
+    /// Whether the game should add the passes and apply the occlusion.
+    AmbientOcclusion& setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /// Radius of the hemisphere sampled around every pixel in world units.
+    AmbientOcclusion& setRadius(float radius);
+    float getRadius() const;
+
+    /// Exponent applied to the ambient occlusion, higher values darken it.
+    AmbientOcclusion& setIntensity(float intensity);
+    float getIntensity() const;
+
+    ///
+    /// \brief setDownsampleFactor Sets the ratio of the scene's resolution to the one the
+    ///                            occlusion is computed at, e.g. 2 for half resolution or
+    ///                            4 for quarter resolution on slower platforms.
+    ///
+    AmbientOcclusion& setDownsampleFactor(int downsampleFactor);
+    int getDownsampleFactor() const;
+
+private:
+    ///
+    /// \brief drawFullscreenTriangle Draws a triangle covering the bound render target
+    ///                               without depth testing.
+    ///
+    void drawFullscreenTriangle() const;
+
+    std::unique_ptr<ShaderProgram> occlusionShader;
+    std::unique_ptr<ShaderProgram> blurShader;
+
+    /// Empty vertex array, fullscreen triangles are generated from their vertex IDs.
+    unsigned int vao = 0;
+
+    unsigned int frameIndex = 0;
+
+    bool enabled = true;
+    float radius = 0.5f;
+    float intensity = 1.0f;
+    int downsampleFactor = 2;
+};
+
+inline bool AmbientOcclusion::isEnabled() const {return this->enabled;}
+inline float AmbientOcclusion::getRadius() const {return this->radius;}
+inline float AmbientOcclusion::getIntensity() const {return this->intensity;}
+inline int AmbientOcclusion::getDownsampleFactor() const {return this->downsampleFactor;}
+
+} // namespace ge
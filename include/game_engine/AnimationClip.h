@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <assimp/anim.h>
+#include <assimp/scene.h>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/vec3.hpp>
+
+#include "Skeleton.h"
+
+namespace ge {
+
+///
+/// \brief The KeyframeTolerances struct holds the maximum errors allowed when removing
+/// keyframes that can be interpolated from their neighbors.
+///
+struct KeyframeTolerances {
+    float translation = 1e-4f;
+    float rotation_rad = 1e-3f;
+    float scale = 1e-4f;
+};
+
+///
+/// \brief The AnimationClip class holds compressed keyframes animating the joints of a
+/// skeleton.
+///
+/// Keyframes that linear interpolation reproduces within the tolerances are removed and
+/// rotations are quantized to 48 bits. Clips are immutable after construction, so they
+/// can be shared by every instance playing them, each with its own Animator.
+///
+class AnimationClip {
+public:
+    ///
+    /// \brief The QuantizedQuat struct stores a unit quaternion in 48 bits by dropping
+    /// its largest component ("smallest three" encoding).
+    ///
+    /// The three remaining components are stored with 15 bits each and the index of
+    /// the dropped component in the top bits of the first two.
+    ///
+    struct QuantizedQuat {
+        static QuantizedQuat quantize(const glm::quat &rotation);
+        glm::quat dequantize() const;
+
+        std::uint16_t components[3];
+    };
+
+    ///
+    /// \brief The JointKeyframes struct holds the uncompressed keyframes of a joint as
+    /// (time in s, value) pairs sorted by time.
+    ///
+    struct JointKeyframes {
+        size_t joint = 0;
+        std::vector<std::pair<float, glm::vec3>> translations;
+        std::vector<std::pair<float, glm::quat>> rotations;
+        std::vector<std::pair<float, glm::vec3>> scales;
+    };
+
+    ///
+    /// \brief loadAnimationClips Creates clips from all animations of a scene.
+    /// \param scene Scene to load the animations of.
+    /// \param skeleton Skeleton created from the scene.
+    /// \param tolerances Maximum errors of the keyframe reduction.
+    ///
+    static std::vector<std::shared_ptr<const AnimationClip>> loadAnimationClips(
+            const aiScene &scene, const Skeleton &skeleton,
+            const KeyframeTolerances &tolerances = KeyframeTolerances());
+
+    ///
+    /// \brief AnimationClip Compresses keyframes.
+    /// \param name Name of the clip.
+    /// \param duration_s Duration of the clip (s).
+    /// \param keyframes Keyframes of the animated joints.
+    /// \param tolerances Maximum errors of the keyframe reduction.
+    ///
+    AnimationClip(std::string name, float duration_s, const std::vector<JointKeyframes> &keyframes,
+                  const KeyframeTolerances &tolerances = KeyframeTolerances());
+
+    ///
+    /// \brief AnimationClip Compresses the channels of an Assimp animation. Channels of
+    ///                      nodes that are not joints of the skeleton are ignored.
+    /// \param animation Animation to compress.
+    /// \param skeleton Skeleton created from the scene of the animation.
+    /// \param tolerances Maximum errors of the keyframe reduction.
+    ///
+    AnimationClip(const aiAnimation &animation, const Skeleton &skeleton,
+                  const KeyframeTolerances &tolerances = KeyframeTolerances());
+
+    ///
+    /// \brief sample Interpolates the local transforms of the animated joints.
+    ///
+    /// Joints without keyframes keep their transform in the pose.
+    ///
+    /// \param time_s Time in the clip (s). Clamped to the first and last keyframes.
+    /// \param pose Pose to write. Must have an entry for every joint of the skeleton.
+    ///
+    void sample(float time_s, Pose *pose) const;
+
+    const std::string& getName() const;
+    float getDuration() const;
+
+    ///
+    /// \brief getNumKeyframes Returns the number of keyframes left after compression.
+    ///
+    size_t getNumKeyframes() const;
+
+private:
+    template<typename T>
+    struct Channel {
+        std::vector<float> times;
+        std::vector<T> values;
+    };
+
+    struct Track {
+        size_t joint;
+        Channel<glm::vec3> translations;
+        Channel<QuantizedQuat> rotations;
+        Channel<glm::vec3> scales;
+    };
+
+    std::string name;
+    float duration_s;
+    std::vector<Track> tracks;
+};
+
+inline const std::string& AnimationClip::getName() const {return this->name;}
+inline float AnimationClip::getDuration() const {return this->duration_s;}
+
+} // namespace ge
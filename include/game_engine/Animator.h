@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+
+#include "AnimationClip.h"
+#include "Skeleton.h"
+
+namespace ge {
+
+///
+/// \brief The Animator class plays animation clips on a skeleton.
+///
+/// An animator holds the playback state of a single instance (clip, time, speed), while
+/// the skeleton and clips are shared, so crowds of instances only pay for their own
+/// playback state and pose. Switching clips cross-fades from the current pose.
+///
+class Animator {
+public:
+    explicit Animator(std::shared_ptr<const Skeleton> skeleton);
+
+    ///
+    /// \brief play Starts playing a clip from its beginning.
+    /// \param clip Clip to play. nullptr to return to the bind pose.
+    /// \param fadeDuration Duration of the cross-fade from the current clip.
+    /// \param loop Whether to wrap around at the end of the clip instead of holding the last pose.
+    ///
+    void play(std::shared_ptr<const AnimationClip> clip,
+              std::chrono::duration<float> fadeDuration = std::chrono::duration<float>(0.0f),
+              bool loop = true);
+
+    ///
+    /// \brief update Advances the playback and evaluates the pose and the model space
+    ///               transforms of the joints.
+    /// \param updateDuration Elapsed time since the last update.
+    ///
+    void update(std::chrono::duration<float> updateDuration);
+
+    ///
+    /// \brief computeSkinMatrices Computes the skin matrices of the last evaluated pose.
+    /// \param skinMatrices Array of Skeleton::getNumBones() matrices to write.
+    ///
+    void computeSkinMatrices(glm::mat4 *skinMatrices) const;
+
+    const Pose& getPose() const;
+    const std::vector<glm::mat4>& getModelTransforms() const;
+
+    const std::shared_ptr<const Skeleton>& getSkeleton() const;
+    const std::shared_ptr<const AnimationClip>& getClip() const;
+
+    void setTime(float time_s);
+    float getTime() const;
+
+    ///
+    /// \brief setSpeed Sets the playback speed relative to real time.
+    ///
+    void setSpeed(float speed);
+    float getSpeed() const;
+
+private:
+    struct Playback {
+        std::shared_ptr<const AnimationClip> clip;
+        float time_s = 0.0f;
+        bool loop = true;
+    };
+
+    void advance(Playback *playback, float duration_s) const;
+    void samplePose(const Playback &playback, Pose *pose) const;
+
+    std::shared_ptr<const Skeleton> skeleton;
+
+    Playback current;
+    Playback previous;
+    float fadeDuration_s = 0.0f;
+    float fadeTime_s = 0.0f;
+    float speed = 1.0f;
+
+    Pose pose;
+    Pose previousPose;
+    std::vector<glm::mat4> modelTransforms;
+};
+
+inline const Pose& Animator::getPose() const {return this->pose;}
+inline const std::vector<glm::mat4>& Animator::getModelTransforms() const {return this->modelTransforms;}
+inline const std::shared_ptr<const Skeleton>& Animator::getSkeleton() const {return this->skeleton;}
+inline const std::shared_ptr<const AnimationClip>& Animator::getClip() const {return this->current.clip;}
+inline void Animator::setTime(float time_s) {this->current.time_s = time_s;}
+inline float Animator::getTime() const {return this->current.time_s;}
+inline void Animator::setSpeed(float speed) {this->speed = speed;}
+inline float Animator::getSpeed() const {return this->speed;}
+
+} // namespace ge
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Entity.h"
+
+namespace ge {
+
+using ComponentTypeId = unsigned int;
+
+constexpr ComponentTypeId MAX_COMPONENT_TYPES = 64;
+
+using ComponentMask = std::bitset<MAX_COMPONENT_TYPES>;
+
+///
+/// \brief The ComponentInfo struct describes how to move and destroy a
+/// type-erased component stored in an Archetype.
+///
+struct ComponentInfo {
+    size_t size;
+    size_t alignment;
+    void (*moveConstruct)(void *destination, void *source);
+    void (*destroy)(void *component);
+};
+
+///
+/// \brief The ComponentRegistry class assigns a unique ComponentTypeId to each
+/// component type on first use.
+///
+class ComponentRegistry {
+public:
+    /// Largest supported component alignment, which is also the alignment of each chunk.
+    static constexpr size_t MAX_ALIGNMENT = 64;
+
+    ///
+    /// \brief getTypeId Returns the id of component type T, registering T if needed.
+    ///
+    /// Const/volatile qualifiers are ignored so that "const T" queries map onto T.
+    ///
+    /// \exception ge::Error More than MAX_COMPONENT_TYPES component types were registered.
+    ///
+    template<typename T>
+    static ComponentTypeId getTypeId();
+
+    static const ComponentInfo& getInfo(ComponentTypeId typeId);
+
+private:
+    template<typename T>
+    struct TypeIdHolder {
+        static ComponentTypeId getTypeId();
+    };
+
+    static ComponentTypeId registerType(const ComponentInfo &info);
+};
+
+///
+/// \brief makeComponentMask Returns the mask with the bits of every given component type set.
+///
+template<typename... Ts>
+ComponentMask makeComponentMask();
+
+///
+/// \brief The Archetype class stores every entity that has exactly the same set of
+/// component types.
+///
+/// Entities are stored in fixed size chunks. Within a chunk, each component type
+/// is stored in its own contiguous array (structure of arrays) so that queries
+/// only touch the memory of the components they ask for.
+///
+/// Rows are addressed globally: row = chunkIdx * chunkCapacity + index in chunk.
+/// Every chunk except the last one is always full.
+///
+class Archetype {
+public:
+    /// Target number of bytes per chunk.
+    static constexpr size_t CHUNK_SIZE_BYTES = 16 * 1024;
+
+    explicit Archetype(const ComponentMask &mask);
+
+    ///
+    /// \brief Destroys every component stored in this archetype.
+    ///
+    ~Archetype();
+
+    Archetype(const Archetype &) = delete;
+    Archetype(Archetype &&) = delete;
+    Archetype& operator=(const Archetype &) = delete;
+    Archetype& operator=(Archetype &&) = delete;
+
+    const ComponentMask& getMask() const;
+    bool hasComponent(ComponentTypeId typeId) const;
+
+    ///
+    /// \brief pushBack Reserves a row for the entity.
+    ///
+    /// The components of the new row are NOT constructed. The caller must construct
+    /// every component of this archetype in place before the row is used.
+    ///
+    /// \param entity Entity owning the new row.
+    /// \return Row of the entity.
+    ///
+    size_t pushBack(Entity entity);
+
+    ///
+    /// \brief swapRemove Destroys the components of a row and fills the hole with the last row.
+    /// \param row Row to remove.
+    /// \return Entity that was moved into the removed row or an invalid
+    ///         entity if the removed row was the last row.
+    ///
+    Entity swapRemove(size_t row);
+
+    void* getComponent(ComponentTypeId typeId, size_t row);
+    Entity getEntity(size_t row) const;
+
+    /// \name Chunk Access
+    /// Allows iterating over the structure of arrays of each chunk.
+    ///@{
+    size_t getNumChunks() const;
+    size_t getChunkCapacity() const;
+    size_t getChunkSize(size_t chunkIdx) const;
+    Entity* getEntityArray(size_t chunkIdx);
+    void* getComponentArray(ComponentTypeId typeId, size_t chunkIdx);
+    ///@}
+
+    size_t size() const;
+
+    /// \name Edges
+    /// Caches the archetype reached by adding/removing a single component type.
+    ///@{
+    Archetype* getAddEdge(ComponentTypeId typeId) const;
+    Archetype* getRemoveEdge(ComponentTypeId typeId) const;
+    void setAddEdge(ComponentTypeId typeId, Archetype *archetype);
+    void setRemoveEdge(ComponentTypeId typeId, Archetype *archetype);
+    ///@}
+
+private:
+    struct Column {
+        ComponentTypeId typeId;
+        size_t offset_bytes; ///< Offset of the component array within a chunk
+        const ComponentInfo *info;
+    };
+
+    struct Chunk {
+        std::unique_ptr<unsigned char[]> storage;
+        unsigned char *data;
+        size_t size;
+    };
+
+    void addChunk();
+
+    ComponentMask mask;
+    std::vector<Column> columns;
+    std::array<int, MAX_COMPONENT_TYPES> columnIndices; ///< -1 if type is not in this archetype
+
+    size_t chunkCapacity;
+    size_t chunkSize_bytes;
+    std::vector<Chunk> chunks;
+    size_t numRows = 0;
+
+    std::unordered_map<ComponentTypeId, Archetype*> addEdges;
+    std::unordered_map<ComponentTypeId, Archetype*> removeEdges;
+};
+
+template<typename T>
+ComponentTypeId ComponentRegistry::getTypeId() {
+    return TypeIdHolder<typename std::remove_cv<T>::type>::getTypeId();
+}
+
+template<typename T>
+ComponentTypeId ComponentRegistry::TypeIdHolder<T>::getTypeId() {
+    static_assert(alignof(T) <= MAX_ALIGNMENT, "Component alignment is too large");
+    static_assert(std::is_move_constructible<T>::value, "Components must be move constructible");
+
+    static const ComponentTypeId typeId = registerType({
+        sizeof(T),
+        alignof(T),
+        [](void *destination, void *source){
+            new (destination) T(std::move(*static_cast<T*>(source)));
+        },
+        [](void *component){
+            static_cast<T*>(component)->~T();
+        }
+    });
+
+    return typeId;
+}
+
+template<typename... Ts>
+ComponentMask makeComponentMask() {
+    ComponentMask mask;
+    using Expand = int[];
+    static_cast<void>(Expand{0, (mask.set(ComponentRegistry::getTypeId<Ts>()), 0)...});
+    return mask;
+}
+
+inline const ComponentMask& Archetype::getMask() const {return this->mask;}
+
+inline bool Archetype::hasComponent(ComponentTypeId typeId) const {
+    return this->columnIndices[typeId] >= 0;
+}
+
+inline void* Archetype::getComponent(ComponentTypeId typeId, size_t row) {
+    const auto &column = this->columns[static_cast<size_t>(this->columnIndices[typeId])];
+    auto &chunk = this->chunks[row / this->chunkCapacity];
+    return chunk.data + column.offset_bytes + (row % this->chunkCapacity) * column.info->size;
+}
+
+inline Entity Archetype::getEntity(size_t row) const {
+    const auto &chunk = this->chunks[row / this->chunkCapacity];
+    return reinterpret_cast<const Entity*>(chunk.data)[row % this->chunkCapacity];
+}
+
+inline size_t Archetype::getNumChunks() const {return this->chunks.size();}
+inline size_t Archetype::getChunkCapacity() const {return this->chunkCapacity;}
+inline size_t Archetype::getChunkSize(size_t chunkIdx) const {return this->chunks[chunkIdx].size;}
+
+inline Entity* Archetype::getEntityArray(size_t chunkIdx) {
+    return reinterpret_cast<Entity*>(this->chunks[chunkIdx].data);
+}
+
+inline void* Archetype::getComponentArray(ComponentTypeId typeId, size_t chunkIdx) {
+    const auto &column = this->columns[static_cast<size_t>(this->columnIndices[typeId])];
+    return this->chunks[chunkIdx].data + column.offset_bytes;
+}
+
+inline size_t Archetype::size() const {return this->numRows;}
+
+} // namespace ge
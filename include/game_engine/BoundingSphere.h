@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+
+#include <glm/fwd.hpp>
+#include <glm/vec3.hpp>
+
+namespace ge {
+
+///
+/// \brief The BoundingSphere struct is a sphere enclosing a mesh or model, used for
+/// visibility tests.
+///
+struct BoundingSphere {
+    ///
+    /// \brief fromPoints Returns a sphere around the bounding box of the points.
+    /// \param positions Tightly packed xyz coordinates of the points.
+    /// \param numPoints Number of points.
+    /// \return The sphere, or an empty sphere if there are no points.
+    ///
+    static BoundingSphere fromPoints(const float *positions, size_t numPoints);
+
+    ///
+    /// \brief merged Returns the smallest sphere enclosing this sphere and another one.
+    ///
+    /// Empty spheres are ignored.
+    ///
+    BoundingSphere merged(const BoundingSphere &other) const;
+
+    ///
+    /// \brief transformed Returns a sphere enclosing this sphere transformed by a model matrix.
+    ///
+    /// The radius is scaled by the largest scale factor of the matrix.
+    ///
+    BoundingSphere transformed(const glm::mat4 &modelMatrix) const;
+
+    bool isEmpty() const;
+
+    glm::vec3 center {0.0f};
+    float radius = -1.0f; ///< Negative if the sphere is empty.
+};
+
+inline bool BoundingSphere::isEmpty() const {return this->radius < 0.0f;}
+
+} // namespace ge
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "GameObject.h"
+#include "Input.h"
 
 #include <chrono>
+#include <vector>
 
 #include <GLFW/glfw3.h>
 
@@ -41,6 +43,16 @@ public:
     ///
     void onUpdate(std::chrono::duration<float> updateDuration) override;
 
+    ///
+    /// \brief subscribeToInput Subscribes the camera controls to input events.
+    ///
+    /// Game::setCam() calls this with the game's input. The base implementation
+    /// does nothing.
+    ///
+    /// \param input Input to subscribe to. It must outlive the camera.
+    ///
+    virtual void subscribeToInput(Input &input);
+
     void setMaxFov(float fov_deg);
 
     ///
@@ -89,6 +101,13 @@ public:
     void setHorizontalRotationAxis(const glm::vec3& horizontalRotationAxis);
     glm::vec3 getHorizontalRotationAxis() const;
 
+protected:
+    ///
+    /// \brief addInputSubscription Keeps an input subscription alive for the
+    ///                             lifetime of the camera.
+    ///
+    void addInputSubscription(Input::Subscription subscription);
+
 private:
     float maxFov_deg;
     float currentFov_deg;
@@ -105,6 +124,8 @@ private:
     glm::vec3 horizontalRotationAxis;
 
     glm::mat4 projectionMatrix {1.0f};
+
+    std::vector<Input::Subscription> inputSubscriptions;
 };
 
 inline float Camera::getCurrentFov_deg() const {return this->currentFov_deg;}
@@ -14,44 +14,40 @@ public:
     CameraFPV(float maxFov_deg, float aspectRatioWidthToHeight, float nearPlane, float farPlane);
 
     ///
-    /// \brief Camera movement controls through keyboard input.
+    /// \brief subscribeToInput Subscribes the camera controls to input events.
     ///
-    /// Implements the following movement controls:
-    ///     1. 'w' - forward
-    ///     2. 's' - backward
-    ///     3. 'a' - left
-    ///     4. 'd' - right
+    /// Implements the following movement controls through input actions.
+    /// Actions without mappings are mapped to the default keys in parentheses:
+    ///     1. "MoveForward"  ('w') - forward
+    ///     2. "MoveBackward" ('s') - backward
+    ///     3. "MoveLeft"     ('a') - left
+    ///     4. "MoveRight"    ('d') - right
     ///
     /// This movement speed may be modified through Camera::setLinearSpeed().
     ///
-    /// \param window The window that received the event.
-    /// \param key The key that was pressed/released.
-    /// \param action GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT.
-    /// \param mods Bit field describing which modifier keys were held down.
+    /// The camera rotates in place following the cursor movement. The sensitivity
+    /// of this movement may be modified through Camera::setCursorSensitivity().
     ///
-    void keyCallback(GLFWwindow *window, int key, int action, int mods) override;
-
+    /// Scrolling zooms the camera.
     ///
-    /// \brief Controls camera through cursor movement.
+    /// \param input Input to subscribe to. It must outlive the camera.
     ///
-    /// The camera rotates in place following the cursor movement.
-    /// The sensitivity of this movement may be modified through Camera::setCursorSensitivity().
+    void subscribeToInput(Input &input) override;
+
+private:
     ///
-    /// \param window The window that received the event.
-    /// \param cursorX The new cursor x-coordinate, relative to the left edge of the client area.
-    /// \param cursorY The new cursor y-coordinate, relative to the top edge of the client area.
+    /// \brief updateMovement Updates the camera's velocity from the movement actions.
+    /// \param input Input holding the state of the movement actions.
     ///
-    void cursorPositionCallback(GLFWwindow *window, double cursorX, double cursorY) override;
+    void updateMovement(const Input &input);
 
     ///
-    /// \brief onScrollInput Controls camera zoom through scrolling.
-    /// \param window The window that received the event
-    /// \param xOffset The scroll offset along the x-axis.
-    /// \param yOffset The scroll offset along the y-axis.
+    /// \brief rotateTowardsCursor Rotates the camera in place following the cursor movement.
+    /// \param cursorX The new cursor x-coordinate, relative to the left edge of the client area.
+    /// \param cursorY The new cursor y-coordinate, relative to the top edge of the client area.
     ///
-    void scrollCallback(GLFWwindow *window, double xOffset, double yOffset) override;
+    void rotateTowardsCursor(double cursorX, double cursorY);
 
-private:
     bool firstCursorPositionReceived = false;
 
     double lastCursorX = 0.0;
@@ -12,40 +12,37 @@ public:
     CameraNav(float maxFov_deg, float aspectRatioWidthToHeight, float nearPlane, float farPlane);
 
     ///
-    /// \brief Controls pan and tilt of the camera.
+    /// \brief subscribeToInput Subscribes the camera controls to input events.
     ///
-    /// Press and drag either the left or right mouse button to rotate the camera in place
-    /// following the cursor movement. The sensitivity of this movement may be modified through
-    /// Camera::setCursorSensitivity().
+    /// Implements the following controls:
+    ///     1. Press and drag either the left or right mouse button to rotate the camera in place
+    ///        following the cursor movement. The sensitivity of this movement may be modified
+    ///        through Camera::setCursorSensitivity().
+    ///     2. Press the right mouse button to move forward. Press the right button while pressing
+    ///        the left SHIFT key to move backward. Release the mouse button to stop.
+    ///     3. Scroll to change the movement speed.
     ///
-    /// \param window The window that received the event.
-    /// \param cursorX The new cursor x-coordinate, relative to the left edge of the client area.
-    /// \param cursorY The new cursor y-coordinate, relative to the top edge of the client area.
+    /// \param input Input to subscribe to. It must outlive the camera.
     ///
-    void cursorPositionCallback(GLFWwindow *window, double cursorX, double cursorY) override;
+    void subscribeToInput(Input &input) override;
 
+private:
     ///
-    /// \brief mouseButtonCallback Controls forward and backward movement of the camera.
+    /// \brief onCursorPosition Controls pan and tilt of the camera.
+    /// \param input Input holding the mouse button state.
+    /// \param cursorX The new cursor x-coordinate, relative to the left edge of the client area.
+    /// \param cursorY The new cursor y-coordinate, relative to the top edge of the client area.
     ///
-    /// Press the right mouse button to move forward. Press the right button while pressing the
-    /// left SHIFT key to move backward. Release the mouse button to stop.
+    void onCursorPosition(const Input &input, double cursorX, double cursorY);
+
     ///
-    /// \param window The window that received the event.
+    /// \brief onMouseButton Controls forward and backward movement of the camera.
+    /// \param input Input holding the key state.
     /// \param button The button that was pressed/released.
     /// \param action GLFW_PRESS/GLFW_RELEASE.
-    /// \param mods Bit field describing which modifier keys were held down.
     ///
-    void mouseButtonCallback(GLFWwindow *window, int button, int action, int mods) override;
+    void onMouseButton(const Input &input, int button, int action);
 
-    ///
-    /// \brief onScrollInput Controls camera zoom through scrolling.
-    /// \param window The window that received the event
-    /// \param xOffset The scroll offset along the x-axis.
-    /// \param yOffset The scroll offset along the y-axis.
-    ///
-    void scrollCallback(GLFWwindow *window, double xOffset, double yOffset) override;
-
-private:
     double lastCursorX = 0.0;
     double lastCursorY = 0.0;
 };
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include "Entity.h"
+#include "GameObject.h"
+#include "Model.h"
+
+namespace ge {
+
+class EntityRegistry;
+struct FramePacket;
+
+///
+/// \brief The TransformComponent class holds the pose of an entity.
+///
+/// It reuses all of the pose logic of Model.
+///
+class TransformComponent : public Model {};
+
+///
+/// \brief The MeshRendererComponent struct holds the (shared) meshes drawn for an entity.
+///
+/// Each mesh is drawn with its own Material.
+///
+struct MeshRendererComponent {
+    MeshRendererComponent() = default;
+
+    explicit MeshRendererComponent(std::shared_ptr<GameObject::Meshes> meshes);
+
+    ///
+    /// \brief MeshRendererComponent Loads (or reuses cached) meshes from a model file.
+    /// \param modelFilepath Filepath to the model data.
+    /// \exception ge::LoadError Failed to load mesh data from model file.
+    /// \exception ge::LoadError Failed to load texture image from file.
+    ///
+    explicit MeshRendererComponent(const std::string &modelFilepath);
+
+    std::shared_ptr<GameObject::Meshes> meshes;
+};
+
+///
+/// \brief The LightComponent struct holds the colors of a directional light.
+///
+/// The light shines along the look at direction of the entity's TransformComponent
+/// in the same manner as DirectionalLight.
+///
+struct LightComponent {
+    glm::vec3 ambient {0.3f};
+    glm::vec3 diffuse {0.75f};
+    glm::vec3 specular {1.0f};
+};
+
+///
+/// \brief The CameraComponent struct holds the perspective projection parameters
+/// of a camera entity. The view matrix is given by the entity's TransformComponent.
+///
+struct CameraComponent {
+    float fov_deg = 45.0f;
+    float aspectRatioWidthToHeight = 1.0f;
+    float nearPlane = 0.1f; ///< m
+    float farPlane = 1000.0f; ///< m
+
+    glm::mat4 getProjectionMatrix() const;
+};
+
+///
+/// \brief createEntity Creates an entity with the pose and meshes of a game object
+///                     so that it is updated and drawn by the ECS.
+///
+/// The meshes are shared with the game object. Virtual callbacks of the game object
+/// are NOT carried over.
+///
+/// \param registry Registry to create the entity in.
+/// \param gameObject Game object to copy.
+/// \return The created entity.
+///
+Entity createEntity(EntityRegistry &registry, const GameObject &gameObject);
+
+///
+/// \brief addEntitiesToFramePacket Appends a draw item for every entity with a
+///                                 TransformComponent and a MeshRendererComponent.
+///
+/// An entity with a LightComponent and a TransformComponent overrides the
+/// directional light of the frame packet.
+///
+/// \param registry Registry of entities to draw.
+/// \param framePacket Frame packet being built for the render thread.
+///
+void addEntitiesToFramePacket(EntityRegistry &registry, FramePacket &framePacket);
+
+} // namespace ge
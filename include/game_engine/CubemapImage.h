@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+namespace ge {
+
+///
+/// \brief The CubemapImage struct holds the faces of a cubemap and their mip levels in
+/// CPU memory, so that cubemaps can be processed and cached without a GL context.
+///
+/// Faces are stored in the order right, left, top, bottom, front, back (+X, -X, +Y,
+/// -Y, +Z, -Z), first row first, with the orientation OpenGL expects for cubemaps.
+///
+struct CubemapImage {
+    enum Format {
+        /// 4 bytes per texel.
+        RGBA8,
+        /// 8 bytes per block of 4x4 texels, see compressCubemapBc1().
+        BC1
+    };
+
+    static constexpr int NUM_FACES = 6;
+
+    using Face = std::vector<unsigned char>;
+    using Level = std::array<Face, NUM_FACES>;
+
+    Format format = RGBA8;
+
+    /// Width and height of the faces of the base level in pixels.
+    int size = 0;
+
+    /// Faces of every mip level, base level first.
+    std::vector<Level> levels;
+
+    int getLevelSize(size_t level) const;
+
+    ///
+    /// \brief getFaceSize_bytes Returns the size of every face of a mip level in memory.
+    ///
+    size_t getFaceSize_bytes(size_t level) const;
+};
+
+///
+/// \brief decodeCubemap Decodes the faces of a cubemap in parallel on the job system.
+/// \param imageFilepaths 6 square images of the same size for each face in the order of:
+///                       right, left, top, bottom, front, back
+/// \return RGBA8 cubemap with a single level.
+/// \exception ge::LoadError Failed to load image data from file or the faces do not
+///                          have the same square size.
+///
+CubemapImage decodeCubemap(const std::array<std::string, 6> &imageFilepaths);
+
+///
+/// \brief generateCubemapMipmaps Replaces the mip levels of an RGBA8 cubemap by the
+///                               base level downsampled with a box filter, down to 1x1.
+///
+void generateCubemapMipmaps(CubemapImage *image);
+
+///
+/// \brief computeIrradiance Convolves an RGBA8 cubemap with a cosine lobe.
+///
+/// Every texel of the result holds the irradiance of a surface facing its direction
+/// divided by pi, i.e. the diffuse ambient light reflected by a white surface with
+/// that normal. The integral is computed in linear color space from the smallest mip
+/// level of at least twice the requested size, in parallel on the job system.
+///
+/// \param radiance Cubemap with mip levels, see generateCubemapMipmaps().
+/// \param size Width and height of the faces of the irradiance map.
+/// \return RGBA8 cubemap with a single level.
+///
+CubemapImage computeIrradiance(const CubemapImage &radiance, int size);
+
+///
+/// \brief The ShCoefficients type holds the RGB coefficients of the first 3 bands (9
+/// functions) of real spherical harmonics, ordered Y00, Y1-1, Y10, Y11, Y2-2, Y2-1, Y20,
+/// Y21, Y22.
+///
+using ShCoefficients = std::array<glm::vec3, 9>;
+
+///
+/// \brief projectIrradianceSh9 Projects an RGBA8 cubemap into spherical harmonics and
+///                             convolves them with a cosine lobe.
+///
+/// Evaluated with a surface normal, the result gives the same light as computeIrradiance()
+/// at a cost of 9 multiply-adds. The projection is computed in linear color space from a
+/// level of at most 64x64 texels, in parallel on the job system and with SSE if available.
+///
+/// \param radiance Cubemap with mip levels, see generateCubemapMipmaps().
+///
+ShCoefficients projectIrradianceSh9(const CubemapImage &radiance);
+
+///
+/// \brief prefilterSpecular Convolves an RGBA8 cubemap with GGX lobes of increasing
+///                          roughness, one per mip level.
+///
+/// The roughness of level i is i / (numLevels - 1), so the base level is a copy of the
+/// radiance and the last level reflects a fully rough surface. Like the split sum
+/// approximation, the view direction is assumed to be the surface normal. Each level is
+/// integrated in linear color space from a level of at most 32x32 texels, in parallel on
+/// the job system and with SSE if available.
+///
+/// \param radiance Cubemap with mip levels, see generateCubemapMipmaps().
+/// \param size Width and height of the faces of the base level. The smallest level of
+///             the radiance of at least this size is used, so the result may be larger.
+/// \param numLevels Number of mip levels of the result, at least 1.
+/// \return RGBA8 cubemap with numLevels levels.
+///
+CubemapImage prefilterSpecular(const CubemapImage &radiance, int size, int numLevels);
+
+///
+/// \brief compressCubemapBc1 Compresses every level of an RGBA8 cubemap into BC1
+///                           (S3TC DXT1) blocks in parallel on the job system.
+///
+/// Alpha is dropped. Levels smaller than a block are padded by repeating their edges.
+///
+CubemapImage compressCubemapBc1(const CubemapImage &image);
+
+///
+/// \brief saveCubemaps Writes cubemaps into a binary container file.
+///
+/// Failing to write the file is not an error since the cubemaps can always be
+/// computed again, so failures are only logged.
+///
+/// \param values Values derived from the cubemaps stored along with them, e.g. spherical
+///               harmonics coefficients.
+///
+void saveCubemaps(const std::string &filepath, const std::vector<CubemapImage> &images,
+                  const std::vector<float> &values = {});
+
+///
+/// \brief loadCubemaps Reads the cubemaps written by saveCubemaps().
+/// \param values If not null, receives the values stored along with the cubemaps.
+/// \return The cubemaps, or none if the file does not exist or is not a valid container.
+///
+std::vector<CubemapImage> loadCubemaps(const std::string &filepath, std::vector<float> *values = nullptr);
+
+inline int CubemapImage::getLevelSize(size_t level) const {return std::max(1, this->size >> level);}
+
+inline size_t CubemapImage::getFaceSize_bytes(size_t level) const {
+    const auto levelSize = static_cast<size_t>(this->getLevelSize(level));
+    if (this->format == RGBA8) return levelSize * levelSize * 4;
+
+    const auto numBlocks = (levelSize + 3) / 4;
+    return numBlocks * numBlocks * 8;
+}
+
+} // namespace ge
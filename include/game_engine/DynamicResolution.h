@@ -0,0 +1,95 @@
+#pragma once
+
+namespace ge {
+
+///
+/// \brief The DynamicResolution class chooses the scale of the resolution the scene is
+/// rendered at so that the GPU time of a frame stays within a budget.
+///
+/// A PID controller adjusts the scale from the error between the measured GPU time and
+/// the budget every frame. The scale moves in steps of DynamicResolution::SCALE_STEP and
+/// only changes once the controller drifts a whole step away from it, so that render
+/// targets are not reallocated every frame while the GPU time hovers around the budget.
+/// For the same reason, the scale is only raised when the GPU time is well under the
+/// budget.
+///
+class DynamicResolution {
+public:
+    /// Granularity of the scale returned by DynamicResolution::getScale().
+    static constexpr float SCALE_STEP = 0.05f;
+
+    ///
+    /// \brief update Adjusts the scale from the GPU time of the latest frame.
+    /// \param gpuFrameTime_ms GPU time of the latest measured frame in milliseconds, or 0
+    ///                        if no measurement is available yet.
+    ///
+    void update(float gpuFrameTime_ms);
+
+    ///
+    /// \brief getScale Returns the scale to apply to both dimensions of the framebuffer,
+    ///                 or the maximum scale when disabled.
+    ///
+    float getScale() const;
+
+    ///
+    /// \brief setEnabled Enables or disables scaling. Disabling resets the controller.
+    ///
+    DynamicResolution& setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /// GPU time of a frame the controller aims for.
+    DynamicResolution& setTargetFrameTime_ms(float targetFrameTime_ms);
+    float getTargetFrameTime_ms() const;
+
+    ///
+    /// \brief setScaleRange Sets the range of the scale. The minimum bounds how blurry
+    ///                      the scene may get under load.
+    ///
+    DynamicResolution& setScaleRange(float minScale, float maxScale);
+    float getMinScale() const;
+    float getMaxScale() const;
+
+    ///
+    /// \brief setGains Sets the gains of the controller, applied to the error relative to
+    ///                 the target frame time.
+    /// \param proportionalGain Reaction to changes of the error, e.g. load spikes.
+    /// \param integralGain Scale change per frame per unit of error, which converges to the
+    ///                     budget.
+    /// \param derivativeGain Damping of the changes of the error.
+    ///
+    DynamicResolution& setGains(float proportionalGain, float integralGain, float derivativeGain);
+
+private:
+    ///
+    /// \brief reset Returns to the maximum scale and forgets the previous errors.
+    ///
+    void reset();
+
+    bool enabled = true;
+
+    float targetFrameTime_ms = 15.0f;
+    float minScale = 0.5f;
+    float maxScale = 1.0f;
+
+    float proportionalGain = 0.2f;
+    float integralGain = 0.05f;
+    float derivativeGain = 0.05f;
+
+    /// Output of the controller, before quantization.
+    float controlledScale = 1.0f;
+    float scale = 1.0f;
+
+    /// Relative errors of the two previous frames, the velocity form of the controller
+    /// only needs them rather than an accumulated integral.
+    float previousError = 0.0f;
+    float secondPreviousError = 0.0f;
+};
+
+inline float DynamicResolution::getScale() const {return this->enabled ? this->scale : this->maxScale;}
+
+inline bool DynamicResolution::isEnabled() const {return this->enabled;}
+inline float DynamicResolution::getTargetFrameTime_ms() const {return this->targetFrameTime_ms;}
+inline float DynamicResolution::getMinScale() const {return this->minScale;}
+inline float DynamicResolution::getMaxScale() const {return this->maxScale;}
+
+} // namespace ge
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace ge {
+
+///
+/// \brief The Entity struct is a lightweight handle to an entity stored in
+/// an EntityRegistry.
+///
+/// The generation is incremented every time an index is recycled so that
+/// stale handles to destroyed entities can be detected.
+///
+struct Entity {
+    static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+    std::uint32_t index = INVALID_INDEX;
+    std::uint32_t generation = 0;
+
+    bool isValid() const;
+};
+
+inline bool Entity::isValid() const {return this->index != INVALID_INDEX;}
+
+inline bool operator==(const Entity &lhs, const Entity &rhs) {
+    return lhs.index == rhs.index && lhs.generation == rhs.generation;
+}
+
+inline bool operator!=(const Entity &lhs, const Entity &rhs) {return !(lhs == rhs);}
+
+} // namespace ge
+
+namespace std {
+
+template<>
+struct hash<ge::Entity> {
+    size_t operator()(const ge::Entity &entity) const noexcept {
+        return hash<std::uint64_t>()(static_cast<std::uint64_t>(entity.generation) << 32 | entity.index);
+    }
+};
+
+} // namespace std
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Archetype.h"
+#include "Entity.h"
+#include "Exception.h"
+#include "JobSystem.h"
+
+namespace ge {
+
+///
+/// \brief The EntityRegistry class owns entities and their components.
+///
+/// Components are stored by archetype (the set of component types an entity has)
+/// in chunked structure of arrays storage, so iterating over a query only touches
+/// the memory of the queried component types.
+///
+/// Structural changes (creating/destroying entities and adding/removing components)
+/// invalidate component references and must not be made while iterating over a query
+/// or while systems are running in parallel.
+///
+class EntityRegistry {
+public:
+    EntityRegistry() = default;
+
+    EntityRegistry(const EntityRegistry &) = delete;
+    EntityRegistry(EntityRegistry &&) = delete;
+    EntityRegistry& operator=(const EntityRegistry &) = delete;
+    EntityRegistry& operator=(EntityRegistry &&) = delete;
+
+    ///
+    /// \brief createEntity Creates an entity with the given components.
+    /// \param components Initial components of the entity. Each component type may appear once.
+    /// \return Handle to the new entity.
+    ///
+    template<typename... Ts>
+    Entity createEntity(Ts&&... components);
+
+    ///
+    /// \brief destroyEntity Destroys the entity and all of its components.
+    ///
+    /// Destroying an entity that is no longer alive does nothing.
+    ///
+    void destroyEntity(Entity entity);
+
+    bool isAlive(Entity entity) const;
+
+    ///
+    /// \brief addComponent Constructs a component on the entity, replacing the existing
+    ///                     component of the same type.
+    /// \param entity Entity to add the component to.
+    /// \param args Arguments used to brace-initialize the component, so aggregate
+    ///             components may be initialized member by member.
+    /// \return The added component.
+    /// \exception ge::Error Entity is not alive.
+    ///
+    template<typename T, typename... Args>
+    T& addComponent(Entity entity, Args&&... args);
+
+    ///
+    /// \brief removeComponent Removes a component from the entity if it has one.
+    /// \exception ge::Error Entity is not alive.
+    ///
+    template<typename T>
+    void removeComponent(Entity entity);
+
+    template<typename T>
+    bool hasComponent(Entity entity) const;
+
+    ///
+    /// \brief getComponent Returns a component of the entity.
+    /// \exception ge::Error Entity is not alive or does not have the component.
+    ///
+    template<typename T>
+    T& getComponent(Entity entity);
+
+    /// \name Queries
+    /// Iterates over every entity that has (at least) all of the component types Ts.
+    /// Const qualified component types are passed as const references/pointers.
+    ///@{
+
+    ///
+    /// \brief forEach Calls fn(Entity, Ts&...) for each matching entity.
+    ///
+    template<typename... Ts, typename F>
+    void forEach(F &&fn);
+
+    ///
+    /// \brief forEachChunk Calls fn(size_t count, const Entity*, Ts*...) for each
+    ///                     chunk of matching entities.
+    ///
+    /// This gives direct access to the contiguous component arrays of a chunk
+    /// for vectorized processing.
+    ///
+    template<typename... Ts, typename F>
+    void forEachChunk(F &&fn);
+
+    ///
+    /// \brief parallelForEach Same as EntityRegistry::forEach() except that chunks are
+    ///                        distributed across the job system's threads.
+    ///
+    /// fn is called concurrently so it must only write to the components it is given.
+    ///
+    template<typename... Ts, typename F>
+    void parallelForEach(F &&fn, JobSystem &jobSystem = JobSystem::getInstance());
+
+    ///
+    /// \brief parallelForEachChunk Same as EntityRegistry::forEachChunk() except that chunks are
+    ///                             distributed across the job system's threads.
+    ///
+    template<typename... Ts, typename F>
+    void parallelForEachChunk(F &&fn, JobSystem &jobSystem = JobSystem::getInstance());
+    ///@}
+
+    ///
+    /// \brief size Returns the number of alive entities.
+    ///
+    size_t size() const;
+
+    ///
+    /// \brief clear Destroys all entities.
+    ///
+    void clear();
+
+private:
+    struct EntityRecord {
+        Archetype *archetype = nullptr;
+        size_t row = 0;
+        std::uint32_t generation = 0;
+    };
+
+    struct ChunkRef {
+        Archetype *archetype;
+        size_t chunkIdx;
+    };
+
+    Entity allocateEntity(Archetype *archetype);
+
+    ///
+    /// \brief moveComponents Move constructs components into the unconstructed row of
+    ///                       an archetype.
+    ///
+    template<typename... Ts, size_t... Is>
+    static void moveComponents(Archetype *archetype, size_t row, std::tuple<Ts...> *values,
+                               std::index_sequence<Is...>);
+    const EntityRecord& getRecord(Entity entity) const;
+
+    Archetype* getArchetype(const ComponentMask &mask);
+    Archetype* getArchetypeWith(Archetype *source, ComponentTypeId typeId);
+    Archetype* getArchetypeWithout(Archetype *source, ComponentTypeId typeId);
+
+    ///
+    /// \brief moveEntity Moves the entity's components into another archetype.
+    ///
+    /// Components that the destination archetype does not have are destroyed.
+    /// Components that the source archetype does not have are left unconstructed.
+    ///
+    /// \return Row of the entity in the destination archetype.
+    ///
+    size_t moveEntity(Entity entity, Archetype *destination);
+
+    ///
+    /// \brief getMatchingArchetypes Returns (and caches) every archetype containing the mask.
+    ///
+    /// This is safe to call concurrently from systems running in parallel.
+    ///
+    const std::vector<Archetype*>& getMatchingArchetypes(const ComponentMask &mask);
+
+    std::vector<ChunkRef> getMatchingChunks(const ComponentMask &mask);
+
+    template<typename T>
+    static T* getComponentArray(Archetype *archetype, size_t chunkIdx);
+
+    std::vector<EntityRecord> records;
+    std::vector<std::uint32_t> freeIndices;
+    size_t numEntities = 0;
+
+    std::unordered_map<ComponentMask, std::unique_ptr<Archetype>> archetypes;
+    std::vector<Archetype*> archetypeList;
+
+    struct QueryCache {
+        std::vector<Archetype*> archetypes;
+        size_t numArchetypesChecked = 0;
+    };
+    std::unordered_map<ComponentMask, QueryCache> queryCaches;
+    std::mutex queryCachesMutex;
+};
+
+template<typename... Ts>
+Entity EntityRegistry::createEntity(Ts&&... components) {
+    // Construct first so that a throwing constructor does not leave a row with
+    // unconstructed components behind
+    std::tuple<typename std::decay<Ts>::type...> values(std::forward<Ts>(components)...);
+
+    auto archetype = this->getArchetype(makeComponentMask<typename std::decay<Ts>::type...>());
+    auto entity = this->allocateEntity(archetype);
+    this->moveComponents(archetype, this->records[entity.index].row, &values,
+                         std::index_sequence_for<Ts...>());
+
+    return entity;
+}
+
+template<typename... Ts, size_t... Is>
+void EntityRegistry::moveComponents(Archetype *archetype, size_t row, std::tuple<Ts...> *values,
+                                    std::index_sequence<Is...>) {
+    using Expand = int[];
+    static_cast<void>(Expand{0, (new (archetype->getComponent(ComponentRegistry::getTypeId<Ts>(), row))
+            Ts(std::move(std::get<Is>(*values))), 0)...});
+}
+
+template<typename T, typename... Args>
+T& EntityRegistry::addComponent(Entity entity, Args&&... args) {
+    const auto typeId = ComponentRegistry::getTypeId<T>();
+    const auto &record = this->getRecord(entity);
+
+    // Construct first so that a throwing constructor leaves the entity untouched
+    T value{std::forward<Args>(args)...};
+
+    void *component;
+    if (record.archetype->hasComponent(typeId)) {
+        component = record.archetype->getComponent(typeId, record.row);
+        static_cast<T*>(component)->~T();
+    } else {
+        auto destination = this->getArchetypeWith(record.archetype, typeId);
+        component = destination->getComponent(typeId, this->moveEntity(entity, destination));
+    }
+
+    return *new (component) T(std::move(value));
+}
+
+template<typename T>
+void EntityRegistry::removeComponent(Entity entity) {
+    const auto typeId = ComponentRegistry::getTypeId<T>();
+    const auto &record = this->getRecord(entity);
+
+    if (record.archetype->hasComponent(typeId)) {
+        this->moveEntity(entity, this->getArchetypeWithout(record.archetype, typeId));
+    }
+}
+
+template<typename T>
+bool EntityRegistry::hasComponent(Entity entity) const {
+    return this->isAlive(entity) &&
+            this->getRecord(entity).archetype->hasComponent(ComponentRegistry::getTypeId<T>());
+}
+
+template<typename T>
+T& EntityRegistry::getComponent(Entity entity) {
+    const auto typeId = ComponentRegistry::getTypeId<T>();
+    const auto &record = this->getRecord(entity);
+
+    if (!record.archetype->hasComponent(typeId)) {
+        throw Error("Entity " + std::to_string(entity.index) + " does not have the requested component");
+    }
+
+    return *static_cast<T*>(record.archetype->getComponent(typeId, record.row));
+}
+
+template<typename... Ts, typename F>
+void EntityRegistry::forEach(F &&fn) {
+    this->forEachChunk<Ts...>([&fn](size_t count, const Entity *entities, Ts*... components){
+        for (size_t i = 0; i < count; ++i) {
+            fn(entities[i], components[i]...);
+        }
+    });
+}
+
+template<typename... Ts, typename F>
+void EntityRegistry::forEachChunk(F &&fn) {
+    for (auto archetype : this->getMatchingArchetypes(makeComponentMask<Ts...>())) {
+        for (size_t chunkIdx = 0; chunkIdx < archetype->getNumChunks(); ++chunkIdx) {
+            fn(archetype->getChunkSize(chunkIdx),
+               static_cast<const Entity*>(archetype->getEntityArray(chunkIdx)),
+               getComponentArray<Ts>(archetype, chunkIdx)...);
+        }
+    }
+}
+
+template<typename... Ts, typename F>
+void EntityRegistry::parallelForEach(F &&fn, JobSystem &jobSystem) {
+    this->parallelForEachChunk<Ts...>([&fn](size_t count, const Entity *entities, Ts*... components){
+        for (size_t i = 0; i < count; ++i) {
+            fn(entities[i], components[i]...);
+        }
+    }, jobSystem);
+}
+
+template<typename... Ts, typename F>
+void EntityRegistry::parallelForEachChunk(F &&fn, JobSystem &jobSystem) {
+    const auto chunks = this->getMatchingChunks(makeComponentMask<Ts...>());
+
+    jobSystem.parallelFor(chunks.size(), 1, [&chunks, &fn](size_t begin, size_t end){
+        for (auto i = begin; i < end; ++i) {
+            auto archetype = chunks[i].archetype;
+            const auto chunkIdx = chunks[i].chunkIdx;
+            fn(archetype->getChunkSize(chunkIdx),
+               static_cast<const Entity*>(archetype->getEntityArray(chunkIdx)),
+               getComponentArray<Ts>(archetype, chunkIdx)...);
+        }
+    });
+}
+
+template<typename T>
+T* EntityRegistry::getComponentArray(Archetype *archetype, size_t chunkIdx) {
+    return static_cast<T*>(archetype->getComponentArray(ComponentRegistry::getTypeId<T>(), chunkIdx));
+}
+
+inline size_t EntityRegistry::size() const {return this->numEntities;}
+
+} // namespace ge
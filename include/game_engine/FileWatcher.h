@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <ctime>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ge {
+
+///
+/// \brief The FileWatcher class reports changes to files.
+///
+/// On Linux, the directories of the watched files are watched with inotify, so that
+/// files replaced by editors (written to a temporary file and renamed) are reported
+/// too. Elsewhere, or if inotify is unavailable, the modification times of the files
+/// are polled.
+///
+class FileWatcher {
+public:
+    /// Interval at which modification times are polled without inotify.
+    static constexpr std::chrono::milliseconds POLL_INTERVAL {500};
+
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher(FileWatcher &&) = delete;
+    FileWatcher& operator=(const FileWatcher &) = delete;
+    FileWatcher& operator=(FileWatcher &&) = delete;
+
+    ///
+    /// \brief watch Starts watching files. Files already watched are ignored.
+    /// \param filepaths Canonical paths of the files, see ResourceManager::getCanonicalPath().
+    ///
+    void watch(const std::vector<std::string> &filepaths);
+
+    ///
+    /// \brief poll Returns the watched files that changed since the last call, without
+    ///             blocking.
+    ///
+    std::vector<std::string> poll();
+
+    bool isUsingInotify() const;
+
+private:
+    struct FileStatus {
+        std::time_t modificationTime = 0;
+        long long size_bytes = -1;
+    };
+
+    static FileStatus getStatus(const std::string &filepath);
+
+    std::map<std::string, FileStatus> watchedFiles;
+
+    /// inotify instance and watched directories by watch descriptor, or -1 to poll.
+    int inotifyFd = -1;
+    std::map<int, std::string> watchedDirectories;
+    std::set<std::string> directories;
+
+    std::chrono::steady_clock::time_point lastPollTime;
+};
+
+inline bool FileWatcher::isUsingInotify() const {return this->inotifyFd >= 0;}
+
+} // namespace ge
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include "GameObject.h"
+#include "ParticleSystem.h"
+#include "Terrain.h"
+
+namespace ge {
+
+class Skybox;
+class Texture2D;
+
+///
+/// \brief The FramePacket struct is an immutable snapshot of everything the
+/// renderer needs to draw one frame.
+///
+/// Packets are produced by the simulation thread in Game::update() and consumed by
+/// the render thread, so they must not point to state that the simulation keeps
+/// modifying. Meshes and the skybox are shared so that they stay alive (and are
+/// destroyed on the render thread) while the packet is in flight.
+///
+struct FramePacket {
+    struct DrawItem {
+        std::shared_ptr<const GameObject::Meshes> meshes;
+        glm::mat4 modelMatrix {1.0f};
+        glm::mat3 normalMatrix {1.0f};
+
+        /// Range of the meshes to draw, e.g. the meshes of a single node of a model.
+        size_t firstMesh = 0;
+        size_t numMeshes = std::numeric_limits<size_t>::max();
+
+        /// Skin matrices of the skinned meshes in the range, or nullptr.
+        std::shared_ptr<const std::vector<glm::mat4>> skinMatrices;
+
+        /// Model matrix of the previous frame, from which the motion of the meshes is
+        /// computed. All zeros if unknown, in which case only the camera moves them.
+        glm::mat4 previousModelMatrix {0.0f};
+    };
+
+    struct ParticleBatch {
+        std::shared_ptr<const std::vector<ParticleInstance>> instances;
+
+        /// Texture of the particles, or nullptr for soft round particles.
+        std::shared_ptr<const Texture2D> texture;
+
+        ParticleBlendMode blendMode;
+    };
+
+    struct TerrainBatch {
+        std::shared_ptr<const Terrain> terrain;
+
+        /// Chunks visible from the camera, by the part of the chunk to draw.
+        Terrain::Selection chunks;
+    };
+
+    struct DirectionalLightData {
+        glm::vec3 direction {0.0f, 0.0f, -1.0f};
+        glm::vec3 ambient {0.0f};
+        glm::vec3 diffuse {0.0f};
+        glm::vec3 specular {0.0f};
+    };
+
+    ///
+    /// \brief reset Clears the packet so that it can be filled for a new frame.
+    ///
+    /// Called on the simulation thread. Game publishes packets with
+    /// TripleBuffer::waitAndPublish(), so a packet is only reset unrendered when the
+    /// render thread stopped. Its resources are then kept until
+    /// FramePacket::releaseResources() so that they are never destroyed without a
+    /// current GL context.
+    ///
+    void reset();
+
+    ///
+    /// \brief releaseResources Drops the references to the meshes, terrains, particle
+    ///                         textures and skybox held by this packet and the packets
+    ///                         it replaced.
+    ///
+    /// Called on the render thread after the packet is rendered.
+    ///
+    void releaseResources();
+
+    int frameBufferWidth = 0;
+    int frameBufferHeight = 0;
+
+    glm::mat4 viewMatrix {1.0f};
+    glm::mat4 projectionMatrix {1.0f};
+    glm::vec3 viewPosition {0.0f};
+
+    /// Camera of the previous frame, from which the motion of the pixels is computed.
+    glm::mat4 previousViewMatrix {1.0f};
+    glm::mat4 previousProjectionMatrix {1.0f};
+
+    DirectionalLightData directionalLight;
+
+    std::vector<DrawItem> drawList;
+
+    /// Terrains drawn after the draw list.
+    std::vector<TerrainBatch> terrainBatches;
+
+    /// Particles drawn after the draw list and the skybox, in order.
+    std::vector<ParticleBatch> particleBatches;
+
+    std::shared_ptr<Skybox> skybox;
+
+private:
+    std::vector<std::shared_ptr<const void>> pendingReleases;
+};
+
+} // namespace ge
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+
+#include <glm/fwd.hpp>
+#include <glm/vec4.hpp>
+
+#include "BoundingSphere.h"
+
+namespace ge {
+
+///
+/// \brief The Frustum class holds the clip planes of a camera's view volume for
+/// visibility tests.
+///
+class Frustum {
+public:
+    ///
+    /// \brief Frustum Extracts the planes of the view volume of a camera.
+    /// \param viewProjectionMatrix Projection matrix multiplied by the view matrix.
+    ///
+    explicit Frustum(const glm::mat4 &viewProjectionMatrix);
+
+    ///
+    /// \brief intersects Returns whether a sphere is at least partially inside the frustum.
+    ///
+    /// Spheres near the corners of the frustum may be reported as intersecting
+    /// although they are outside.
+    ///
+    /// \param sphere Sphere in world space.
+    ///
+    bool intersects(const BoundingSphere &sphere) const;
+
+    ///
+    /// \brief intersects Returns whether an axis-aligned box is at least partially
+    ///                   inside the frustum.
+    ///
+    /// Boxes near the corners of the frustum may be reported as intersecting
+    /// although they are outside.
+    ///
+    /// \param boxMin Minimum corner of the box in world space.
+    /// \param boxMax Maximum corner of the box in world space.
+    ///
+    bool intersects(const glm::vec3 &boxMin, const glm::vec3 &boxMax) const;
+
+    ///
+    /// \brief getPlanes Returns the left, right, bottom, top, near and far planes.
+    ///
+    /// Plane normals (xyz) are normalized and point inside the frustum, so the signed
+    /// distance of a point p to a plane is dot(plane.xyz, p) + plane.w.
+    ///
+    const std::array<glm::vec4, 6>& getPlanes() const;
+
+private:
+    std::array<glm::vec4, 6> planes;
+};
+
+inline const std::array<glm::vec4, 6>& Frustum::getPlanes() const {return this->planes;}
+
+} // namespace ge
@@ -1,23 +1,48 @@
 #pragma once
 
+#include <array>
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <game_engine/AmbientOcclusion.h>
 #include <game_engine/Camera.h>
 #include <game_engine/DirectionalLight.h>
+#include <game_engine/DynamicResolution.h>
+#include <game_engine/EntityRegistry.h>
+#include <game_engine/FramePacket.h>
 #include <game_engine/GameObject.h>
+#include <game_engine/HotReloader.h>
+#include <game_engine/Input.h>
+#include <game_engine/Material.h>
+#include <game_engine/ParticleRenderer.h>
+#include <game_engine/ParticleSystem.h>
+#include <game_engine/PostProcessor.h>
+#include <game_engine/RenderGraph.h>
+#include <game_engine/RenderTargetPool.h>
+#include <game_engine/ResourceManager.h>
+#include <game_engine/SceneGraph.h>
 #include <game_engine/UniformBuffer.h>
 #include <game_engine/ShaderProgram.h>
+#include <game_engine/ShaderVariants.h>
 #include <game_engine/Skybox.h>
+#include <game_engine/SystemScheduler.h>
+#include <game_engine/Terrain.h>
+#include <game_engine/TerrainRenderer.h>
+#include <game_engine/TerrainStreamer.h>
+#include <game_engine/TripleBuffer.h>
+#include <game_engine/WorldStreamer.h>
 
 namespace ge {
 
+class InstancingGameObjects;
+
 ///
 /// \brief The Game class is a template for making a game. It sets up OpenGL and
 /// runs a game loop providing default rendering behavior. In order to work with
@@ -31,8 +56,59 @@ public:
     ///@{
     static int glContextMajorVersion;
     static int glContextMinorVersion;
+
+    ///
+    /// \brief renderThreadEnabled Renders on a dedicated thread that owns the GL context.
+    ///
+    /// The simulation (input, Game::update()) then runs on the main thread and hands
+    /// frame packets to the render thread through a triple buffer, so that it may run
+    /// one frame ahead while the GPU and driver are busy. GL objects must then be
+    /// created and destroyed in Game::loadWorld() or through Game::runOnRenderThread().
+    ///
+    static bool renderThreadEnabled;
+
+    ///
+    /// \brief hotReloadEnabled Reloads the shaders, textures and models whose files change
+    ///                         while the game runs, see HotReloader.
+    ///
+    static bool hotReloadEnabled;
     ///@}
 
+    ///
+    /// \brief The DefaultShaderFeature enum lists the features of the default shader
+    /// variants.
+    ///
+    enum DefaultShaderFeature : ShaderVariants::Features {
+        /// Reads model and normal matrices from the per-instance attributes 3 to 9
+        /// set up by InstancingMesh instead of the "model" and "normal" uniforms.
+        DEFAULT_SHADER_INSTANCING = 1u << 0,
+
+        /// Adds specular highlights sampled from the material's specular texture.
+        DEFAULT_SHADER_SPECULAR_MAP = 1u << 1,
+        /// Deforms skinned meshes with the skin matrices in the "Bones" uniform block or,
+        /// combined with DEFAULT_SHADER_INSTANCING, the "boneMatrices" texture buffer
+        /// set up by InstancingGameObjects.
+        DEFAULT_SHADER_SKINNING = 1u << 2,
+
+        /// Reads vertices from the vertex animation textures of InstancingGameObjects
+        /// with baked vertex animations. Requires DEFAULT_SHADER_INSTANCING.
+        DEFAULT_SHADER_VERTEX_ANIMATION = 1u << 3,
+
+        /// Only writes depth, for the depth pre-pass the ambient occlusion is computed from.
+        DEFAULT_SHADER_DEPTH_ONLY = 1u << 4,
+
+        /// Draws the camera-facing quads of an Imposter, with the "viewPosition" uniform
+        /// set. Requires DEFAULT_SHADER_INSTANCING.
+        DEFAULT_SHADER_IMPOSTER = 1u << 5
+    };
+
+    ///
+    /// \brief InputCallbackSubscriptions Subscriptions of the key, mouse button, cursor
+    ///                                   position and scroll callbacks of a game object,
+    ///                                   see Game::subscribeToInputCallbacks().
+    ///
+    using InputCallbackSubscriptions = std::array<Input::Subscription, 4>;
+
     ///
     /// \brief New Builds an instance of game. This function should be provided for each
     ///            subclass of game.
@@ -53,10 +129,13 @@ public:
     ///
     /// \brief startGameLoop Starts the game loop until user presses 'ESC'
     ///
+    /// Must be called from the main thread.
+    ///
     void startGameLoop();
 
     /// \name GLFW callbacks
-    /// Callbacks to be hooked up to GLFW callback functions
+    /// Callbacks to be hooked up to GLFW callback functions. Input events are
+    /// buffered and dispatched to their subscribers at the start of the next update.
     ///@{
     void frameBufferSizeCallback(GLFWwindow *window, int width, int height);
     virtual void keyCallback(GLFWwindow *window, int key, int scancode, int action, int mods);
@@ -73,7 +152,7 @@ protected:
     ///
     /// \brief init Configure global states for OpenGL, GLFW, etc.
     ///
-    /// Default behavior enables depth testing.
+    /// Default behavior enables depth testing and seamless cubemap filtering.
     ///
     virtual void init();
 
@@ -84,17 +163,225 @@ protected:
 
     ///
     /// \brief bindMatricesUbo Binds shaders to UBO for view and projection matrices.
+    ///
+    /// The "Matrices" block holds the view matrix, the projection matrix jittered for
+    /// temporal anti-aliasing, the view projection matrix of the previous frame and the
+    /// jitter, see default.vert.
+    ///
     /// \param shader Shader to bind.
     ///
     void bindMatricesUbo(ShaderProgram *shader);
 
+    ///
+    /// \brief useDefaultShader Activates the default shader variant with the given
+    ///                         features and sets its camera and light uniforms.
+    ///
+    /// Must be called on the thread that owns the GL context, e.g. to draw
+    /// InstancingGameObjects with DEFAULT_SHADER_INSTANCING from Game::renderOpaque().
+    ///
+    /// \param features Mask of DefaultShaderFeature values.
+    /// \param framePacket Frame packet being rendered.
+    /// \return The active shader variant.
+    ///
+    ShaderProgram& useDefaultShader(ShaderVariants::Features features, const FramePacket &framePacket);
+
+    ///
+    /// \brief renderOpaque Draws opaque surfaces that are not in the frame packet, e.g.
+    ///                     InstancingGameObjects with Game::renderInstancing().
+    ///
+    /// Called by the "depth prepass" pass if ambient occlusion is enabled, then by the
+    /// "opaque" pass, after the draw list. The surfaces thus take part in the depth test
+    /// and ambient occlusion, and write their motion for temporal anti-aliasing like the
+    /// draw list does, except instances, which reject the history. Runs on the thread that
+    /// owns the GL context, so what it draws must be modified through
+    /// Game::runOnRenderThread() when the render thread is enabled.
+    ///
+    /// The base implementation draws nothing.
+    ///
+    /// \param framePacket Frame packet being rendered.
+    /// \param depthOnly Whether this is the depth pre-pass, which must only write depth
+    ///                  with DEFAULT_SHADER_DEPTH_ONLY variants.
+    ///
+    virtual void renderOpaque(const FramePacket &framePacket, bool depthOnly);
+
+    ///
+    /// \brief renderInstancing Culls and draws instancing game objects with the default
+    ///                         shader variant matching their animation.
+    ///
+    /// Instances at or beyond the imposter distance are drawn as imposters if they are
+    /// baked, see InstancingGameObjects::bakeImposters(). Like the meshes, imposters
+    /// write depth in the depth pre-pass and their motion in the opaque pass.
+    ///
+    /// \param gameObjects Instancing game objects to draw.
+    /// \param framePacket Frame packet being rendered.
+    /// \param depthOnly Whether to only write depth, see Game::renderOpaque().
+    ///
+    void renderInstancing(InstancingGameObjects *gameObjects, const FramePacket &framePacket, bool depthOnly);
+
+    ///
+    /// \brief runOnRenderThread Queues a command to run with the GL context current,
+    ///                          before the next frame is rendered.
+    ///
+    /// This is the place to create, modify or destroy GL objects from Game::update().
+    ///
+    /// \param command Command to run on the render thread.
+    ///
+    void runOnRenderThread(std::function<void()> command);
+
     ///
     /// \brief pushBackInWorldList Pushes game object into world list to allow
     ///                            updating and rendering during the game loop.
+    ///
+    /// The game object is added to the scene graph as a root node.
+    ///
     /// \param gameObject Game object to push into the world list.
     ///
     void pushBackInWorldList(std::shared_ptr<GameObject> gameObject);
 
+    ///
+    /// \brief subscribeToInputCallbacks Subscribes the GLFW-style input callbacks of a
+    ///                                  game object to all input events.
+    ///
+    /// Game objects no longer receive input events by being in the world list. This
+    /// keeps objects overriding GameObject::keyCallback(), etc. working. New code should
+    /// subscribe to the events or actions it needs through getInput() instead.
+    ///
+    /// \param gameObject Game object to subscribe. The subscriptions do not keep it
+    ///                   alive and ignore events once it is destroyed.
+    /// \return Subscriptions of the callbacks, which unsubscribe them when destroyed.
+    ///
+    InputCallbackSubscriptions subscribeToInputCallbacks(const std::shared_ptr<GameObject> &gameObject);
+
+    ///
+    /// \brief getInput Returns the input that buffers the GLFW input events and
+    ///                 dispatches them to its subscribers on every update.
+    ///
+    Input& getInput();
+
+    ///
+    /// \brief getPostProcessor Returns the chain of passes applied to the HDR scene
+    ///                         before it is displayed, e.g. to toggle bloom.
+    ///
+    /// Must only be used on the thread that owns the GL context, e.g. through
+    /// Game::runOnRenderThread().
+    ///
+    PostProcessor& getPostProcessor();
+
+    ///
+    /// \brief getDynamicResolution Returns the controller scaling the resolution the scene
+    ///                             is rendered at to keep the GPU time of the frames
+    ///                             within a budget, e.g. to change the budget.
+    ///
+    /// The scaled scene is upscaled to the framebuffer by the post processor.
+    ///
+    /// Must only be used on the thread that owns the GL context, e.g. through
+    /// Game::runOnRenderThread().
+    ///
+    DynamicResolution& getDynamicResolution();
+
+    ///
+    /// \brief getAmbientOcclusion Returns the screen-space ambient occlusion darkening the
+    ///                            ambient light of the default and terrain shaders, e.g.
+    ///                            to disable it or lower its resolution.
+    ///
+    /// While enabled, the opaque surfaces are drawn in a depth pre-pass first.
+    ///
+    /// Must only be used on the thread that owns the GL context, e.g. through
+    /// Game::runOnRenderThread().
+    ///
+    AmbientOcclusion& getAmbientOcclusion();
+
+    ///
+    /// \brief getRenderGraph Returns the graph running the render passes of every frame,
+    ///                       e.g. to read their GPU times.
+    ///
+    /// The passes of the default rendering are "depth prepass", "opaque", "skybox",
+    /// "particles" and those of the ambient occlusion and the post processor, see
+    /// AmbientOcclusion and PostProcessor. Their total GPU time drives the
+    /// dynamic resolution.
+    ///
+    /// Must only be used on the thread that owns the GL context.
+    ///
+    const RenderGraph& getRenderGraph() const;
+
+    ///
+    /// \brief getSceneGraph Returns the scene graph holding the world transforms of the
+    ///                      game objects in the world list and the camera.
+    ///
+    /// Game objects are drawn with their world transforms, so attaching a game object's
+    /// node to the node of another game object (or one of its model nodes) makes it
+    /// follow that game object, e.g.
+    ///
+    ///     getSceneGraph().setParent(weapon->getSceneNode(), character->findSceneNode("hand"));
+    ///
+    /// World transforms are updated after Game::update().
+    ///
+    SceneGraph& getSceneGraph();
+
+    ///
+    /// \brief getEntityRegistry Returns the registry of entities that are updated by the
+    ///                          registered systems and rendered every frame.
+    ///
+    /// Entities with a TransformComponent and a MeshRendererComponent are rendered
+    /// with the default shader after the world list.
+    ///
+    EntityRegistry& getEntityRegistry();
+
+    ///
+    /// \brief getSystemScheduler Returns the scheduler whose systems are run on the
+    ///                           entity registry on every update.
+    ///
+    SystemScheduler& getSystemScheduler();
+
+    ///
+    /// \brief addParticleSystem Adds a particle system to update and draw every frame.
+    ///
+    /// Particle systems are drawn in the order they were added, after the world and
+    /// the skybox.
+    ///
+    /// \param particleSystem Particle system to add.
+    ///
+    void addParticleSystem(std::shared_ptr<ParticleSystem> particleSystem);
+
+    ///
+    /// \brief removeParticleSystem Stops updating and drawing a particle system.
+    /// \param particleSystem Particle system to remove.
+    ///
+    void removeParticleSystem(const std::shared_ptr<ParticleSystem> &particleSystem);
+
+    ///
+    /// \brief addTerrain Adds a terrain to draw every frame.
+    /// \param terrain Terrain to add.
+    ///
+    void addTerrain(std::shared_ptr<Terrain> terrain);
+
+    ///
+    /// \brief removeTerrain Stops drawing a terrain.
+    /// \param terrain Terrain to remove.
+    ///
+    void removeTerrain(const std::shared_ptr<Terrain> &terrain);
+
+    ///
+    /// \brief setTerrainStreamer Sets the streamer loading the terrain tiles around the
+    ///                           camera, or nullptr to stop streaming.
+    ///
+    /// The streamer is updated with the camera's position after Game::update() and its
+    /// loaded tiles are drawn with the terrains.
+    ///
+    void setTerrainStreamer(std::unique_ptr<TerrainStreamer> terrainStreamer);
+    TerrainStreamer* getTerrainStreamer();
+
+    ///
+    /// \brief setWorldStreamer Sets the streamer loading the cells of the world around
+    ///                         the camera, or nullptr to stop streaming.
+    ///
+    /// The streamer is updated with the camera's position and direction on every update,
+    /// and the game objects of its loaded cells are drawn after the world list. The cells
+    /// of the previous streamer are released on the render thread.
+    ///
+    void setWorldStreamer(std::unique_ptr<WorldStreamer> worldStreamer);
+    WorldStreamer* getWorldStreamer();
+
     void setCam(std::unique_ptr<Camera> cam);
     Camera* getCam();
 
@@ -114,34 +401,149 @@ private:
     virtual void update(std::chrono::duration<float> updateDuration);
 
     ///
-    /// \brief render Renders all game objects using the default shaders.
+    /// \brief buildFramePacket Takes a snapshot of the camera, lights and all game
+    ///                         objects and entities to draw.
+    ///
+    /// Runs on the simulation thread after Game::update().
+    ///
+    /// \param framePacket Empty frame packet to fill.
+    ///
+    virtual void buildFramePacket(FramePacket &framePacket);
+
+    ///
+    /// \brief render Renders a frame packet using the default shaders into an HDR render
+    ///               target, then post-processes it into the default framebuffer.
+    ///
+    /// The render target is scaled by the dynamic resolution, which is then updated with
+    /// the GPU time of the frame.
+    ///
+    /// The passes are declared to the render graph and run by it, see addRenderPasses().
+    ///
+    /// Runs on the thread that owns the GL context.
+    ///
+    /// \param framePacket Frame packet to render.
+    ///
+    virtual void render(const FramePacket &framePacket);
+
+    ///
+    /// \brief addRenderPasses Declares the passes drawing a frame packet into the scene.
+    ///
+    /// Opaque surfaces write their motion since the previous frame to the second draw
+    /// buffer, if the scene has a velocity texture.
+    ///
+    /// \param scene HDR render target with a depth buffer the world is drawn into.
+    /// \param matrices Uniform buffer of the view and projection matrices.
+    /// \param projectionMatrix Projection of the frame, including its jitter.
     ///
-    virtual void render();
+    void addRenderPasses(const FramePacket &framePacket, RenderGraph::Resource scene,
+                         RenderGraph::Resource matrices, const glm::mat4 &projectionMatrix);
+
+    ///
+    /// \brief renderDrawList Draws the meshes of a frame packet with the default shaders.
+    /// \param depthOnly Whether to only write depth, without binding the materials.
+    ///
+    void renderDrawList(const FramePacket &framePacket, bool depthOnly = false);
+
+    ///
+    /// \brief setAmbientOcclusionUniforms Sets the uniforms of ambient_occlusion.glsl on an
+    ///                                    active shader.
+    ///
+    void setAmbientOcclusionUniforms(ShaderProgram *shader) const;
+
+    void runSingleThreadedGameLoop();
+    void runMultiThreadedGameLoop();
+
+    ///
+    /// \brief simulateFrame Updates the game and publishes its frame packet.
+    ///
+    void simulateFrame();
+
+    ///
+    /// \brief renderFrame Runs the queued render commands, renders the frame packet
+    ///                    and swaps buffers.
+    ///
+    void renderFrame(FramePacket &framePacket);
 
     using WindowPtr = std::unique_ptr<GLFWwindow, std::function<void(GLFWwindow*)>>;
 
     WindowPtr window;
+
+    /// Destroyed right before the window, so that cached resources are released with
+    /// the GL context current.
+    std::shared_ptr<ResourceManager> resourceManager;
+
+    /// Null unless Game::hotReloadEnabled.
+    std::unique_ptr<HotReloader> hotReloader;
+
     int frameBufferWidth, frameBufferHeight;
 
     std::chrono::system_clock::time_point lastUpdateTime;
 
-    std::unique_ptr<ShaderProgram> defaultShader;
+    std::unique_ptr<ShaderVariants> defaultShaders;
     std::unique_ptr<ShaderProgram> skyboxShader;
+    std::unique_ptr<TerrainRenderer> terrainRenderer;
+    std::unique_ptr<ParticleRenderer> particleRenderer;
+    std::unique_ptr<RenderTargetPool> renderTargetPool;
+    std::unique_ptr<RenderGraph> renderGraph;
+    std::unique_ptr<PostProcessor> postProcessor;
+    DynamicResolution dynamicResolution;
+    std::unique_ptr<AmbientOcclusion> ambientOcclusion;
     std::unique_ptr<UniformBuffer> matricesUbo;
+    std::unique_ptr<UniformBuffer> bonesUbo;
+    std::shared_ptr<MaterialRegistry> materialRegistry;
+
+    std::unique_ptr<Input> input;
 
     std::unique_ptr<Camera> cam;
 
+    /// Projection matrix of the camera in the last frame packet.
+    glm::mat4 previousProjectionMatrix {1.0f};
+
+    /// Inverse of the scene's resolution while the opaque pass samples the ambient
+    /// occlusion, zero otherwise.
+    glm::vec2 ambientOcclusionUvScale {0.0f};
+
     ///
     /// \brief worldList Container of all game objects to be updated and rendered
     /// during each frame in the game loop.
     ///
     std::vector<std::shared_ptr<GameObject>> worldList;
 
-    std::unique_ptr<Skybox> skybox;
+    SceneGraph sceneGraph;
+
+    std::unique_ptr<WorldStreamer> worldStreamer;
+
+    EntityRegistry entityRegistry;
+    SystemScheduler systemScheduler;
+
+    std::vector<std::shared_ptr<Terrain>> terrains;
+    std::unique_ptr<TerrainStreamer> terrainStreamer;
+
+    std::vector<std::shared_ptr<ParticleSystem>> particleSystems;
+
+    std::shared_ptr<Skybox> skybox;
 
     std::unique_ptr<DirectionalLight> directionalLight;
+
+    TripleBuffer<FramePacket> framePackets;
+
+    std::mutex renderCommandsMutex;
+    std::vector<std::function<void()>> renderCommands;
 };
 
+inline Input& Game::getInput() {return *this->input;}
+inline PostProcessor& Game::getPostProcessor() {return *this->postProcessor;}
+inline DynamicResolution& Game::getDynamicResolution() {return this->dynamicResolution;}
+inline AmbientOcclusion& Game::getAmbientOcclusion() {return *this->ambientOcclusion;}
+inline const RenderGraph& Game::getRenderGraph() const {return *this->renderGraph;}
+inline SceneGraph& Game::getSceneGraph() {return this->sceneGraph;}
+
+inline EntityRegistry& Game::getEntityRegistry() {return this->entityRegistry;}
+inline SystemScheduler& Game::getSystemScheduler() {return this->systemScheduler;}
+
+inline WorldStreamer* Game::getWorldStreamer() {return this->worldStreamer.get();}
+inline TerrainStreamer* Game::getTerrainStreamer() {return this->terrainStreamer.get();}
+
 inline int Game::getFrameBufferWidth() const {return this->frameBufferWidth;}
 inline int Game::getFrameBufferHeight() const {return this->frameBufferHeight;}
 
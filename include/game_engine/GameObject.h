@@ -1,23 +1,53 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include <GLFW/glfw3.h>
 #include <glm/fwd.hpp>
+#include <glm/mat4x4.hpp>
 
 #include "Model.h"
+#include "SceneGraph.h"
 
 namespace ge {
 
+class AnimationClip;
+class Animator;
+struct FramePacket;
 class Mesh;
 class ShaderProgram;
+class Skeleton;
 
 ///
 /// \brief The GameObject class represents an object in the 3D virtual world.
 ///
 class GameObject {
 public:
+    using Meshes = std::vector<std::unique_ptr<Mesh>>;
+
+    ///
+    /// \brief The ModelNode struct is a node of the hierarchy of a model file.
+    ///
+    /// Nodes are sorted breadth-first, starting with the root node, and the meshes of
+    /// each node are stored contiguously in the model's Meshes.
+    ///
+    struct ModelNode {
+        std::string name;
+        size_t parent = 0; ///< Index of the parent node. The root node (index 0) has no parent.
+        glm::mat4 localTransform {1.0f}; ///< Transform relative to the parent node.
+        size_t firstMesh = 0;
+        size_t numMeshes = 0;
+    };
+
+    using ModelNodes = std::vector<ModelNode>;
+
+    using AnimationClips = std::vector<std::shared_ptr<const AnimationClip>>;
+
     GameObject();
 
     ///
@@ -35,7 +65,7 @@ public:
                const std::vector<unsigned int> &indices,
                const std::string &textureFilepath="");
 
-    virtual ~GameObject() = default;
+    virtual ~GameObject();
 
     ///
     /// \brief onUpdate Updates the game object's state.
@@ -47,6 +77,21 @@ public:
     ///
     virtual void onUpdate(std::chrono::duration<float> updateDuration);
 
+    ///
+    /// \brief updateAnimation Advances the animator of a skinned game object and computes
+    ///                        the skin matrices of its new pose.
+    ///
+    /// Does nothing if the model has no skeleton.
+    ///
+    /// \param updateDuration Elapsed time since the last frame.
+    ///
+    void updateAnimation(std::chrono::duration<float> updateDuration);
+
+    ///
+    /// \brief render Sets the model and normal matrices of every node of the model on the
+    ///               shader and renders the node's meshes.
+    /// \param shader Active shader program.
+    ///
     virtual void render(ShaderProgram *shader);
 
     ///
@@ -95,8 +140,162 @@ public:
     ///
     virtual void scrollCallback(GLFWwindow *window, double xOffset, double yOffset);
 
+    ///
+    /// \brief setMesh Replaces the meshes of the game object with a single mesh, which
+    ///                drops the node hierarchy loaded from a model file.
+    ///
+    /// Scene graph nodes created for the dropped hierarchy are no longer used until
+    /// the game object is added to a scene graph again.
+    ///
     void setMesh(std::unique_ptr<Mesh> mesh);
 
+    ///
+    /// \brief loadMeshes Loads and caches mesh data from model file.
+    ///
+    /// Mesh caches will automatically be cleaned up as the last
+    /// reference to the returned shared_ptr<Meshes> is destroyed.
+    ///
+    /// \param modelFilepath Filepath to the model data.
+    /// \return Shared pointer to the model data (meshes).
+    /// \exception ge::LoadError Failed to load mesh data from model file.
+    /// \exception ge::LoadError Failed to load texture image from file.
+    ///
+    static std::shared_ptr<Meshes> loadMeshes(const std::string &modelFilepath);
+
+    ///
+    /// \brief loadModelNodes Loads and caches the node hierarchy of a model file.
+    ///
+    /// The hierarchy is cached together with the meshes of GameObject::loadMeshes().
+    ///
+    /// \param modelFilepath Filepath to the model data.
+    /// \return Shared pointer to the nodes of the model.
+    /// \exception ge::LoadError Failed to load mesh data from model file.
+    /// \exception ge::LoadError Failed to load texture image from file.
+    ///
+    static std::shared_ptr<const ModelNodes> loadModelNodes(const std::string &modelFilepath);
+
+    ///
+    /// \brief importModel Reads a model file and decodes the textures of its materials
+    ///                    on the calling thread.
+    ///
+    /// Loading the model on the render thread afterwards (e.g. with
+    /// GameObject(const std::string&)) then only uploads it, so that files may be read
+    /// on background threads. Models that are already loaded are not imported again.
+    ///
+    /// \param modelFilepath Filepath to the model data.
+    /// \param gpuSize_bytes Set to an estimate of the GPU memory the model will take when
+    ///                      loaded, or 0 if it is already loaded. May be nullptr.
+    /// \return Handle keeping the imported data alive until the model is loaded, or
+    ///         nullptr if the model is already loaded.
+    /// \exception ge::LoadError Failed to load mesh data from model file.
+    /// \exception ge::LoadError Failed to load texture image from file.
+    ///
+    static std::shared_ptr<const void> importModel(const std::string &modelFilepath,
+                                                   size_t *gpuSize_bytes = nullptr);
+
+    ///
+    /// \brief prepareReload Reads a model file that changed on the calling thread.
+    ///
+    /// The meshes and materials of the loaded model are replaced in place, so game
+    /// objects need not be recreated. The node hierarchy must keep its layout and
+    /// meshes; node transforms, skeletons and animation clips are not reloaded.
+    ///
+    /// \param filepath Canonical path of the model file.
+    /// \return Command replacing the meshes of the loaded model, to run on the render
+    ///         thread, or nullptr if no model was loaded from the file. The command
+    ///         throws ge::LoadError if the layout of the model changed.
+    /// \exception ge::LoadError Failed to load mesh data from model file.
+    ///
+    static std::function<void()> prepareReload(const std::string &filepath);
+
+    std::shared_ptr<Meshes> getMeshes() const;
+
+    ///
+    /// \brief getSkeleton Returns the skeleton of the model file the game object was
+    ///                    loaded from, or nullptr if it has no skinned meshes.
+    ///
+    std::shared_ptr<const Skeleton> getSkeleton() const;
+
+    ///
+    /// \brief getAnimationClips Returns the animations of the model file, which are shared
+    ///                          by every game object loaded from it, or nullptr if it has
+    ///                          no skeleton.
+    ///
+    std::shared_ptr<const AnimationClips> getAnimationClips() const;
+
+    ///
+    /// \brief findAnimationClip Returns the animation clip with the given name or nullptr.
+    ///
+    std::shared_ptr<const AnimationClip> findAnimationClip(const std::string &name) const;
+
+    ///
+    /// \brief getAnimator Returns the animator playing the clips of a skinned game object,
+    ///                    or nullptr if the model has no skeleton.
+    ///
+    Animator* getAnimator();
+
+    ///
+    /// \brief getModelNodes Returns the node hierarchy of the model file the game
+    ///                      object was loaded from, or nullptr if it has none.
+    ///
+    std::shared_ptr<const ModelNodes> getModelNodes() const;
+
+    /// \name Scene graph
+    ///
+    /// A game object is represented in a SceneGraph by a node whose local transform is
+    /// given by the game object's pose, with a child node for each node of its model.
+    /// Attaching the game object's node to another node (e.g. a model node of another
+    /// game object found with GameObject::findSceneNode()) makes its pose relative to
+    /// that node.
+    ///@{
+
+    ///
+    /// \brief addToSceneGraph Creates the nodes of the game object in a scene graph.
+    /// \param sceneGraph Scene graph to add the game object to.
+    /// \param parent Node to attach the game object to. SceneGraph::INVALID_NODE for none.
+    /// \exception ge::Error Invalid parent node.
+    ///
+    void addToSceneGraph(SceneGraph &sceneGraph, SceneGraph::Node parent = SceneGraph::INVALID_NODE);
+
+    ///
+    /// \brief removeFromSceneGraph Destroys the nodes of the game object in a scene graph.
+    ///
+    /// Game objects attached to the game object are destroyed along with its nodes.
+    ///
+    void removeFromSceneGraph(SceneGraph &sceneGraph);
+
+    ///
+    /// \brief updateSceneGraph Sets the game object's pose as the local transform of its node.
+    ///
+    /// The model nodes of an animated game object are posed by its animator, so that
+    /// game objects attached to them follow the animation.
+    ///
+    /// Should be called after every update, before SceneGraph::update().
+    ///
+    void updateSceneGraph(SceneGraph &sceneGraph) const;
+
+    ///
+    /// \brief addToFramePacket Appends a draw item for every model node with meshes,
+    ///                         using the world transforms of its scene graph node.
+    ///
+    /// Skinned meshes are drawn with the world transform of the game object and the skin
+    /// matrices of the last GameObject::updateAnimation().
+    ///
+    void addToFramePacket(const SceneGraph &sceneGraph, FramePacket &framePacket) const;
+
+    SceneGraph::Node getSceneNode() const;
+
+    ///
+    /// \brief findSceneNode Returns the scene graph node of a model node.
+    /// \param modelNodeName Name of the model node.
+    /// \return The scene graph node or SceneGraph::INVALID_NODE if there is no model
+    ///         node with that name.
+    ///
+    SceneGraph::Node findSceneNode(const std::string &modelNodeName) const;
+    ///@}
+
+    const Model& getModel() const;
+
     glm::mat4 getModelMatrix() const;
 
     ///
@@ -178,16 +377,45 @@ public:
 
     GameObject& setScale(const glm::vec3 &scale);
 
+    ///
+    /// \brief setSpecularExponent Sets the specular exponent of the materials of all meshes.
+    ///
+    /// Meshes loaded from the same model file share their materials, so this also
+    /// affects other game objects loaded from that file.
+    ///
+    /// \param specularExponent Specular exponent to set.
+    ///
     void setSpecularExponent(float specularExponent);
 
+    ///
+    /// \brief getSpecularExponent Returns the specular exponent of the first mesh's material.
+    ///
+    float getSpecularExponent() const;
+
 private:
-    using Meshes = std::vector<std::unique_ptr<Mesh>>;
     Model model;
 
     std::shared_ptr<Meshes> meshes;
-    float specularExponent = 64.0f;
+    std::shared_ptr<const ModelNodes> modelNodes;
+
+    std::shared_ptr<const Skeleton> skeleton;
+    std::shared_ptr<const AnimationClips> animationClips;
+    std::unique_ptr<Animator> animator;
+    std::shared_ptr<const std::vector<glm::mat4>> skinMatrices;
+
+    SceneGraph::Node sceneNode = SceneGraph::INVALID_NODE;
+    std::vector<SceneGraph::Node> modelSceneNodes;
 };
 
+inline std::shared_ptr<GameObject::Meshes> GameObject::getMeshes() const {return this->meshes;}
+inline std::shared_ptr<const GameObject::ModelNodes> GameObject::getModelNodes() const {return this->modelNodes;}
+inline SceneGraph::Node GameObject::getSceneNode() const {return this->sceneNode;}
+inline std::shared_ptr<const Skeleton> GameObject::getSkeleton() const {return this->skeleton;}
+inline std::shared_ptr<const GameObject::AnimationClips> GameObject::getAnimationClips() const {return this->animationClips;}
+inline Animator* GameObject::getAnimator() {return this->animator.get();}
+
+inline const Model& GameObject::getModel() const {return this->model;}
+
 inline glm::mat4 GameObject::getModelMatrix() const {return this->model.getModelMatrix();}
 inline glm::mat3 GameObject::getNormalMatrix() const {return this->model.getNormalMatrix();}
 inline glm::mat4 GameObject::getViewMatrix() const {return this->model.getViewMatrix();}
@@ -255,8 +483,5 @@ inline GameObject& GameObject::setScale(const glm::vec3& scale) {
     return *this;
 }
 
-inline void GameObject::setSpecularExponent(float specularExponent) {
-    this->specularExponent = specularExponent;
-}
 
 } // namespace ge
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace ge {
+
+///
+/// \brief The GpuTimer class measures the time the GPU takes to execute the commands
+/// issued between GpuTimer::begin() and GpuTimer::end().
+///
+/// Results are read a few frames later, once the GPU has finished, so that measuring
+/// never stalls the CPU until every query is in flight. Timers cannot be nested.
+///
+/// Must only be used on the thread that owns the GL context.
+///
+class GpuTimer {
+public:
+    /// Number of measurements that may be in flight.
+    static constexpr size_t NUM_QUERIES = 4;
+
+    GpuTimer();
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer &) = delete;
+    GpuTimer(GpuTimer &&) = delete;
+    GpuTimer& operator=(const GpuTimer &) = delete;
+    GpuTimer& operator=(GpuTimer &&) = delete;
+
+    ///
+    /// \brief begin Starts measuring. Waits for the oldest measurement if all are in flight.
+    ///
+    void begin();
+
+    ///
+    /// \brief end Stops measuring and reads the measurements the GPU has finished.
+    ///
+    void end();
+
+    ///
+    /// \brief getElapsed_ms Returns the latest finished measurement in milliseconds.
+    ///
+    float getElapsed_ms() const;
+
+private:
+    ///
+    /// \brief readOldestQuery Reads the result of the oldest measurement in flight.
+    ///
+    void readOldestQuery();
+
+    std::array<unsigned int, NUM_QUERIES> queries {};
+    size_t firstPendingQuery = 0;
+    size_t numPendingQueries = 0;
+
+    float elapsed_ms = 0.0f;
+};
+
+inline float GpuTimer::getElapsed_ms() const {return this->elapsed_ms;}
+
+} // namespace ge
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ge {
+
+///
+/// \brief The Heightmap class holds a grid of 16-bit heights.
+///
+/// Heights are normalized to [0, 1]. Heightmaps hold no GPU resources, so they may
+/// be loaded and destroyed on any thread.
+///
+class Heightmap {
+public:
+    ///
+    /// \brief Heightmap Loads a heightmap from a grayscale image.
+    ///
+    /// 16-bit images (e.g. 16-bit PNGs) keep their full precision. Color images are
+    /// converted to grayscale.
+    ///
+    /// \param imageFilepath Filepath to the image.
+    /// \exception ge::LoadError Failed to load the image.
+    ///
+    explicit Heightmap(const std::string &imageFilepath);
+
+    ///
+    /// \brief Heightmap Creates a heightmap from heights.
+    /// \param heights Rows of heights, first row first.
+    /// \param width Number of heights per row.
+    /// \param height Number of rows.
+    ///
+    Heightmap(std::vector<std::uint16_t> heights, int width, int height);
+
+    ///
+    /// \brief getValue Returns the normalized height at a sample, clamping the coordinates.
+    ///
+    float getValue(int x, int y) const;
+
+    ///
+    /// \brief sample Bilinearly interpolates the normalized height.
+    /// \param u Horizontal coordinate, 0 at the first column and 1 at the last.
+    /// \param v Vertical coordinate, 0 at the first row and 1 at the last.
+    ///
+    float sample(float u, float v) const;
+
+    int getWidth() const;
+    int getHeight() const;
+    const std::uint16_t* getData() const;
+
+private:
+    std::vector<std::uint16_t> heights;
+    int width;
+    int height;
+};
+
+inline int Heightmap::getWidth() const {return this->width;}
+inline int Heightmap::getHeight() const {return this->height;}
+inline const std::uint16_t* Heightmap::getData() const {return this->heights.data();}
+
+} // namespace ge
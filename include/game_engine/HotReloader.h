@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "FileWatcher.h"
+
+namespace ge {
+
+class ResourceManager;
+
+///
+/// \brief The HotReloader class reloads the shaders, textures and models whose files
+/// change while the game runs.
+///
+/// Reloads are incremental: only the shader programs built from or including a
+/// changed file and the resources loaded from it are rebuilt. Textures and models are
+/// read and decoded on the job system, then replace the previous versions in place on
+/// the render thread between two frames, so their users keep their handles. Resources
+/// that fail to reload keep their previous version and the error is logged.
+///
+/// The reloader must only be used on the thread that owns the GL context.
+///
+class HotReloader {
+public:
+    /// Interval at which the files of newly loaded resources start being watched.
+    static constexpr std::chrono::milliseconds WATCH_INTERVAL {1000};
+
+    ///
+    /// \brief HotReloader Starts watching the files of the loaded resources.
+    /// \param resourceManager Manager of the textures and models to reload.
+    ///
+    explicit HotReloader(std::shared_ptr<ResourceManager> resourceManager);
+
+    ///
+    /// \brief Waits for the files being read on the job system.
+    ///
+    ~HotReloader();
+
+    HotReloader(const HotReloader &) = delete;
+    HotReloader(HotReloader &&) = delete;
+    HotReloader& operator=(const HotReloader &) = delete;
+    HotReloader& operator=(HotReloader &&) = delete;
+
+    ///
+    /// \brief update Starts reloading the files that changed and replaces the resources
+    ///               whose reload finished.
+    ///
+    /// Should be called at the start of every frame, before anything is rendered.
+    ///
+    void update();
+
+    ///
+    /// \brief getNumPendingReloads Returns the number of changed files being read.
+    ///
+    size_t getNumPendingReloads() const;
+
+private:
+    using Commands = std::vector<std::function<void()>>;
+
+    ///
+    /// \brief startReload Releases the unreferenced resources loaded from a changed file
+    ///                    and reads it again for the referenced ones on the job system.
+    ///
+    void startReload(const std::string &filepath);
+
+    ///
+    /// \brief finishReloads Replaces the resources of the files read since the last call.
+    ///
+    void finishReloads();
+
+    std::shared_ptr<ResourceManager> resourceManager;
+
+    FileWatcher fileWatcher;
+    std::chrono::steady_clock::time_point lastWatchTime;
+
+    /// Commands replacing the resources of a changed file, once it is read.
+    std::vector<std::pair<std::string, std::future<Commands>>> pendingReloads;
+};
+
+inline size_t HotReloader::getNumPendingReloads() const {return this->pendingReloads.size();}
+
+} // namespace ge
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "BoundingSphere.h"
+
+namespace ge {
+
+class InstanceCuller;
+class InstancingMesh;
+class ShaderProgram;
+
+///
+/// \brief The Imposter class replaces distant instances of a model by camera-facing quads
+/// showing pictures of the model baked from many directions.
+///
+/// The model is rendered orthographically from numViewsPerSide x numViewsPerSide
+/// directions spread over the upper hemisphere (+z) by a hemi-octahedral mapping. Each
+/// view covers the model's bounding sphere and is stored in one cell of two atlases:
+///
+/// - albedo: the diffuse color, and the coverage in alpha,
+/// - normal and depth: the normal in model space and the depth relative to the plane
+///   through the sphere's center, facing the view.
+///
+/// Quads are drawn with the default shader's INSTANCING and IMPOSTER features, which
+/// blend the 4 views closest to the direction of the camera, light them like the meshes
+/// and offset their depths so that they intersect other geometry correctly.
+///
+/// Baking only renders into framebuffer objects of its own, so it only requires a current
+/// GL context, e.g. of a hidden window, and can run without displaying anything.
+///
+class Imposter {
+public:
+    ///
+    /// \brief Imposter Bakes the atlases of a model.
+    /// \param meshes Meshes of the model, drawn in their bind pose.
+    /// \param boundingSphere Sphere enclosing the meshes in model space.
+    /// \param bakeShader Shader writing the albedo and the normal and depth of the meshes,
+    ///                   see imposter_bake.frag.
+    /// \param numViewsPerSide Number of views along each side of the atlases.
+    /// \param viewResolution_texels Width and height of a view.
+    /// \exception ge::Error The framebuffer of the atlases could not be created.
+    ///
+    Imposter(const std::vector<std::unique_ptr<InstancingMesh>> &meshes, const BoundingSphere &boundingSphere,
+             ShaderProgram *bakeShader, int numViewsPerSide = 8, int viewResolution_texels = 128);
+    ~Imposter();
+
+    Imposter(const Imposter &) = delete;
+    Imposter(Imposter &&) = delete;
+    Imposter& operator=(const Imposter &) = delete;
+    Imposter& operator=(Imposter &&) = delete;
+
+    ///
+    /// \brief setInstanceAttribs Reads the per-instance model and normal matrices of the
+    ///                           quads from attributes 3 to 9, in a culler's culled
+    ///                           instance buffer.
+    ///
+    void setInstanceAttribs(const InstanceCuller &culler);
+
+    ///
+    /// \brief render Draws a quad for every instance that passed the culler's last cull.
+    ///
+    /// The atlases are bound to texture units 6 and 7.
+    ///
+    /// \param shader Active default shader variant with the INSTANCING and IMPOSTER features.
+    /// \param culler Culler of the instances, see Imposter::setInstanceAttribs().
+    ///
+    void render(ShaderProgram *shader, const InstanceCuller &culler) const;
+
+    int getNumViewsPerSide() const;
+    const BoundingSphere& getBoundingSphere() const;
+
+private:
+    BoundingSphere boundingSphere;
+    int numViewsPerSide;
+
+    unsigned int albedoTexture = 0;
+    unsigned int normalDepthTexture = 0;
+
+    /// Quad with corners at (+-1, +-1), and the indices of its 2 triangles.
+    unsigned int vao = 0;
+    unsigned int vbo = 0;
+    unsigned int ebo = 0;
+};
+
+inline int Imposter::getNumViewsPerSide() const {return this->numViewsPerSide;}
+inline const BoundingSphere& Imposter::getBoundingSphere() const {return this->boundingSphere;}
+
+} // namespace ge
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <bitset>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <GLFW/glfw3.h>
+#include <glm/vec2.hpp>
+
+namespace ge {
+
+///
+/// \brief The Input class buffers input events received from GLFW callbacks and
+/// dispatches them once per frame to the objects that subscribed to them.
+///
+/// Besides event subscriptions, Input keeps polling state (keys/buttons held down,
+/// pressed or released this frame, cursor position) and maps named actions and
+/// axes onto keys and mouse buttons.
+///
+/// Consecutive cursor position events and consecutive scroll events are coalesced
+/// so that high rate mice do not increase the number of dispatched events.
+///
+class Input {
+public:
+    using SubscriptionId = unsigned int;
+
+    using KeyCallback = std::function<void(int key, int action, int mods)>;
+    using MouseButtonCallback = std::function<void(int button, int action, int mods)>;
+    using CursorPositionCallback = std::function<void(double cursorX, double cursorY)>;
+    using ScrollCallback = std::function<void(double xOffset, double yOffset)>;
+    using ActionCallback = std::function<void(bool isDown)>;
+
+    /// Subscribes to every key or mouse button.
+    static constexpr int ANY = -1;
+
+    ///
+    /// \brief The Subscription class unsubscribes its callback on destruction.
+    ///
+    /// The Input the subscription was made on must outlive the subscription.
+    ///
+    class Subscription {
+    public:
+        Subscription() = default;
+        Subscription(Input *input, SubscriptionId id);
+        ~Subscription();
+
+        Subscription(const Subscription &) = delete;
+        Subscription& operator=(const Subscription &) = delete;
+        Subscription(Subscription &&other) noexcept;
+        Subscription& operator=(Subscription &&other) noexcept;
+
+        void unsubscribe();
+
+    private:
+        Input *input = nullptr;
+        SubscriptionId id = 0;
+    };
+
+    explicit Input(GLFWwindow *window);
+
+    Input(const Input &) = delete;
+    Input(Input &&) = delete;
+    Input& operator=(const Input &) = delete;
+    Input& operator=(Input &&) = delete;
+
+    /// \name Event Buffering
+    /// Buffers events to be dispatched on the next call of Input::dispatchEvents().
+    /// These are meant to be called from the GLFW callbacks.
+    ///@{
+    void pushKeyEvent(int key, int action, int mods);
+    void pushMouseButtonEvent(int button, int action, int mods);
+    void pushCursorPositionEvent(double cursorX, double cursorY);
+    void pushScrollEvent(double xOffset, double yOffset);
+    ///@}
+
+    ///
+    /// \brief dispatchEvents Updates the polling state and calls the subscribers of
+    ///                       every event buffered since the last call.
+    ///
+    /// This should be called once at the beginning of every update.
+    ///
+    void dispatchEvents();
+
+    /// \name Subscriptions
+    /// Callbacks are only called for the events they subscribed to.
+    /// \exception ge::Error The callback is empty.
+    ///@{
+
+    ///
+    /// \brief subscribeKey Subscribes to the events of a single key.
+    /// \param key GLFW key code or Input::ANY to subscribe to all keys.
+    ///
+    Subscription subscribeKey(int key, KeyCallback callback);
+
+    ///
+    /// \brief subscribeMouseButton Subscribes to the events of a single mouse button.
+    /// \param button GLFW mouse button or Input::ANY to subscribe to all buttons.
+    ///
+    Subscription subscribeMouseButton(int button, MouseButtonCallback callback);
+
+    Subscription subscribeCursorPosition(CursorPositionCallback callback);
+    Subscription subscribeScroll(ScrollCallback callback);
+
+    ///
+    /// \brief subscribeAction Subscribes to changes of an action's down state.
+    ///
+    /// The callback is called when the first mapped key/button of the action is pressed
+    /// and when the last held mapped key/button of the action is released.
+    ///
+    Subscription subscribeAction(const std::string &action, ActionCallback callback);
+    ///@}
+
+    /// \name Action Mappings
+    /// Named actions are down as long as any of their mapped keys or mouse buttons are held down.
+    ///@{
+    Input& mapKeyToAction(const std::string &action, int key);
+    Input& mapMouseButtonToAction(const std::string &action, int button);
+    Input& clearActionMappings(const std::string &action);
+    bool hasActionMappings(const std::string &action) const;
+
+    ///
+    /// \brief mapAxis Maps a named axis onto a pair of actions.
+    ///
+    /// The axis value is 1 if only the positive action is down,
+    /// -1 if only the negative action is down and 0 otherwise.
+    ///
+    Input& mapAxis(const std::string &axis, const std::string &positiveAction,
+                   const std::string &negativeAction);
+    ///@}
+
+    /// \name Polling State
+    /// "Pressed" and "released" refer to the events dispatched by the last call
+    /// of Input::dispatchEvents().
+    ///@{
+    bool isKeyDown(int key) const;
+    bool wasKeyPressed(int key) const;
+    bool wasKeyReleased(int key) const;
+
+    bool isMouseButtonDown(int button) const;
+    bool wasMouseButtonPressed(int button) const;
+    bool wasMouseButtonReleased(int button) const;
+
+    bool isActionDown(const std::string &action) const;
+    bool wasActionPressed(const std::string &action) const;
+    bool wasActionReleased(const std::string &action) const;
+
+    float getAxis(const std::string &axis) const;
+
+    glm::dvec2 getCursorPosition() const;
+    glm::dvec2 getCursorDelta() const;
+    glm::dvec2 getScrollOffset() const;
+    ///@}
+
+    GLFWwindow* getWindow() const;
+
+private:
+    enum class EventType {Key, MouseButton, CursorPosition, Scroll};
+
+    struct Event {
+        EventType type;
+        int code;   ///< Key or mouse button
+        int action;
+        int mods;
+        double x;   ///< Cursor position or scroll offset
+        double y;
+    };
+
+    struct Subscriber {
+        EventType type;
+        int code;
+        std::string action;
+        KeyCallback keyCallback;
+        MouseButtonCallback mouseButtonCallback;
+        CursorPositionCallback cursorPositionCallback;
+        ScrollCallback scrollCallback;
+        ActionCallback actionCallback;
+    };
+
+    struct ActionState {
+        std::vector<int> keys;
+        std::vector<int> mouseButtons;
+        bool isDown = false;
+        bool wasPressed = false;
+        bool wasReleased = false;
+    };
+
+    struct Axis {
+        std::string positiveAction;
+        std::string negativeAction;
+    };
+
+    using ButtonStates = std::bitset<GLFW_KEY_LAST + 1>;
+
+    Subscription addSubscriber(Subscriber subscriber);
+    void unsubscribe(SubscriptionId id);
+
+    void dispatchEvent(const Event &event);
+    void updateActions(const std::vector<std::string> &actions);
+
+    template<typename F>
+    void notifySubscribers(const std::vector<SubscriptionId> &ids, F &&notify);
+
+    static bool isValidCode(int code);
+
+    GLFWwindow *window;
+
+    std::vector<Event> pendingEvents;
+    std::mutex pendingEventsMutex;
+
+    SubscriptionId nextSubscriptionId = 1;
+    std::unordered_map<SubscriptionId, Subscriber> subscribers;
+    std::unordered_map<int, std::vector<SubscriptionId>> keySubscribers;
+    std::unordered_map<int, std::vector<SubscriptionId>> mouseButtonSubscribers;
+    std::vector<SubscriptionId> cursorPositionSubscribers;
+    std::vector<SubscriptionId> scrollSubscribers;
+    std::unordered_map<std::string, std::vector<SubscriptionId>> actionSubscribers;
+
+    std::unordered_map<std::string, ActionState> actions;
+    std::unordered_map<int, std::vector<std::string>> keyActions;
+    std::unordered_map<int, std::vector<std::string>> mouseButtonActions;
+    std::unordered_map<std::string, Axis> axes;
+
+    ButtonStates keysDown;
+    ButtonStates keysPressed;
+    ButtonStates keysReleased;
+    ButtonStates mouseButtonsDown;
+    ButtonStates mouseButtonsPressed;
+    ButtonStates mouseButtonsReleased;
+
+    glm::dvec2 cursorPosition {0.0};
+    glm::dvec2 cursorDelta {0.0};
+    glm::dvec2 scrollOffset {0.0};
+    bool cursorPositionReceived = false;
+};
+
+inline bool Input::isValidCode(int code) {return code >= 0 && code <= GLFW_KEY_LAST;}
+
+inline bool Input::isKeyDown(int key) const {return isValidCode(key) && this->keysDown[key];}
+inline bool Input::wasKeyPressed(int key) const {return isValidCode(key) && this->keysPressed[key];}
+inline bool Input::wasKeyReleased(int key) const {return isValidCode(key) && this->keysReleased[key];}
+
+inline bool Input::isMouseButtonDown(int button) const {
+    return isValidCode(button) && this->mouseButtonsDown[button];
+}
+
+inline bool Input::wasMouseButtonPressed(int button) const {
+    return isValidCode(button) && this->mouseButtonsPressed[button];
+}
+
+inline bool Input::wasMouseButtonReleased(int button) const {
+    return isValidCode(button) && this->mouseButtonsReleased[button];
+}
+
+inline glm::dvec2 Input::getCursorPosition() const {return this->cursorPosition;}
+inline glm::dvec2 Input::getCursorDelta() const {return this->cursorDelta;}
+inline glm::dvec2 Input::getScrollOffset() const {return this->scrollOffset;}
+
+inline GLFWwindow* Input::getWindow() const {return this->window;}
+
+} // namespace ge
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <glm/fwd.hpp>
+#include <glm/vec3.hpp>
+
+#include "BoundingSphere.h"
+
+namespace ge {
+
+///
+/// \brief The InstanceCuller class tests instances against the view frustum and writes
+/// the visible ones into a compacted buffer for instanced drawing.
+///
+/// Instances are read from a buffer of model matrices, a buffer of normal matrices and
+/// an optional buffer of per-instance data (a vec2, e.g. the vertex animation of the
+/// instance), all tightly packed. Every visible instance is written into the culled
+/// instance buffer as a model matrix immediately followed by its normal matrix and data.
+///
+/// Instances may also be selected by their distance to the camera, so that every level of
+/// detail is culled into its own buffer and drawn with one instanced draw.
+///
+/// Instance culling must only be used on the thread that owns the GL context.
+///
+class InstanceCuller {
+public:
+    enum class Backend {
+        /// Reads the instances back and culls them with Frustum. Slow, but serves as a
+        /// reference to test the other backends against.
+        CPU,
+
+        /// Culls in a geometry shader and captures the visible instances with transform
+        /// feedback (OpenGL 3.3). On OpenGL 4.4, a query buffer writes the number of
+        /// visible instances into an indirect draw command. Otherwise it is only known on
+        /// the CPU once culling finished. See InstanceCuller::drawElementsInstanced().
+        TRANSFORM_FEEDBACK,
+
+        /// Culls in a compute shader (OpenGL 4.3). The number of visible instances never
+        /// leaves the GPU since it is written into an indirect draw command.
+        COMPUTE
+    };
+
+    ///
+    /// \brief The DistanceRange struct selects the instances whose bounding sphere centers
+    /// are within a range of distances from the camera.
+    ///
+    struct DistanceRange {
+        /// Keeps all instances.
+        DistanceRange() : viewPosition(0.0f), minDistance(0.0f),
+                          maxDistance(std::numeric_limits<float>::max()) {}
+
+        bool contains(const glm::vec3 &position) const;
+
+        glm::vec3 viewPosition;
+        float minDistance;
+        float maxDistance; ///< Excluded.
+    };
+
+    /// Size of an instance in the culled instance buffer.
+    static constexpr size_t INSTANCE_SIZE_BYTES = (16 + 9 + 2) * sizeof(float);
+
+    /// Offset of the per-instance data in a culled instance.
+    static constexpr size_t INSTANCE_DATA_OFFSET_BYTES = (16 + 9) * sizeof(float);
+
+    ///
+    /// \brief getDefaultBackend Returns the fastest backend supported by the current context.
+    ///
+    static Backend getDefaultBackend();
+
+    ///
+    /// \brief cullOnCpu Returns the indices of the instances whose bounding spheres
+    ///                  intersect the view frustum.
+    /// \param modelMatrices Model matrices of the instances.
+    /// \param boundingSphere Bounding sphere of the instanced meshes in model space.
+    /// \param viewProjectionMatrix Projection matrix multiplied by the view matrix.
+    /// \param distanceRange Distances from the camera of the instances to keep.
+    /// \return Indices of the visible instances in ascending order.
+    ///
+    static std::vector<size_t> cullOnCpu(const std::vector<glm::mat4> &modelMatrices,
+                                         const BoundingSphere &boundingSphere,
+                                         const glm::mat4 &viewProjectionMatrix,
+                                         const DistanceRange &distanceRange = DistanceRange());
+
+    ///
+    /// \brief InstanceCuller Allocates the culled instance buffer and builds the culling shaders.
+    /// \param maxNumInstances Maximum number of instances to cull at once.
+    /// \param backend Backend to cull with.
+    /// \exception ge::BuildError Failed to compile or link the culling shaders.
+    ///
+    explicit InstanceCuller(size_t maxNumInstances, Backend backend = getDefaultBackend());
+    ~InstanceCuller();
+
+    InstanceCuller(const InstanceCuller &) = delete;
+    InstanceCuller(InstanceCuller &&) = delete;
+    InstanceCuller& operator=(const InstanceCuller &) = delete;
+    InstanceCuller& operator=(InstanceCuller &&) = delete;
+
+    ///
+    /// \brief cull Writes the visible instances into the culled instance buffer.
+    ///
+    /// Changes the active shader program.
+    ///
+    /// \param modelMatrixBuffer Buffer of the instances' model matrices.
+    /// \param normalMatrixBuffer Buffer of the instances' normal matrices.
+    /// \param instanceDataBuffer Buffer of the instances' data, or 0 to write zeros.
+    /// \param numInstances Number of instances to cull.
+    /// \param boundingSphere Bounding sphere of the instanced meshes in model space.
+    /// \param viewProjectionMatrix Projection matrix multiplied by the view matrix.
+    /// \param distanceRange Distances from the camera of the instances to keep.
+    /// \exception ge::Error More instances than the maximum number of instances.
+    ///
+    void cull(unsigned int modelMatrixBuffer, unsigned int normalMatrixBuffer, unsigned int instanceDataBuffer,
+              size_t numInstances, const BoundingSphere &boundingSphere, const glm::mat4 &viewProjectionMatrix,
+              const DistanceRange &distanceRange = DistanceRange());
+
+    ///
+    /// \brief drawElementsInstanced Draws the visible instances of the bound vertex array.
+    ///
+    /// The vertex array must read its per-instance attributes from the culled
+    /// instance buffer and draw triangles with unsigned int indices.
+    ///
+    /// With the transform feedback backend before OpenGL 4.4, all culled instances are
+    /// drawn unless the count of the last cull is already available, which is never
+    /// waited for. The instances past the captured ones have all zero matrices, so
+    /// shaders transforming positions by the model matrix collapse them to a point
+    /// without fragments. Visible instances are always drawn.
+    ///
+    /// \param numIndices Number of indices to draw per instance.
+    ///
+    void drawElementsInstanced(unsigned int numIndices) const;
+
+    ///
+    /// \brief getNumVisibleInstances Returns the number of instances that passed the last cull.
+    ///
+    /// With the transform feedback and compute backends, this waits for culling to
+    /// finish and should only be used for debugging.
+    ///
+    size_t getNumVisibleInstances() const;
+
+    unsigned int getCulledInstanceBuffer() const;
+    size_t getMaxNumInstances() const;
+    Backend getBackend() const;
+
+private:
+    void cullWithCpu(unsigned int modelMatrixBuffer, unsigned int normalMatrixBuffer,
+                     unsigned int instanceDataBuffer, size_t numInstances,
+                     const BoundingSphere &boundingSphere, const glm::mat4 &viewProjectionMatrix,
+                     const DistanceRange &distanceRange);
+    void cullWithTransformFeedback(unsigned int modelMatrixBuffer, unsigned int normalMatrixBuffer,
+                                   unsigned int instanceDataBuffer, size_t numInstances);
+    void cullWithCompute(unsigned int modelMatrixBuffer, unsigned int normalMatrixBuffer,
+                         unsigned int instanceDataBuffer, size_t numInstances);
+    void setCullingUniforms(const BoundingSphere &boundingSphere, const glm::mat4 &viewProjectionMatrix,
+                            const DistanceRange &distanceRange);
+
+    Backend backend;
+    size_t maxNumInstances;
+
+    unsigned int culledInstanceBuffer = 0;
+    unsigned int program = 0;
+
+    // Transform feedback. The zero buffer clears the culled instances before OpenGL 4.4.
+    unsigned int vao = 0;
+    unsigned int query = 0;
+    unsigned int zeroBuffer = 0;
+    unsigned int vaoModelMatrixBuffer = 0;
+    unsigned int vaoNormalMatrixBuffer = 0;
+    unsigned int vaoInstanceDataBuffer = 0;
+
+    // Compute, and transform feedback on OpenGL 4.4
+    unsigned int drawCommandBuffer = 0;
+
+    unsigned int numVisibleInstances = 0;
+    unsigned int numDrawnInstances = 0;
+};
+
+inline unsigned int InstanceCuller::getCulledInstanceBuffer() const {return this->culledInstanceBuffer;}
+inline size_t InstanceCuller::getMaxNumInstances() const {return this->maxNumInstances;}
+inline InstanceCuller::Backend InstanceCuller::getBackend() const {return this->backend;}
+
+} // namespace ge
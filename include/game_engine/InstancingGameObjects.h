@@ -1,17 +1,29 @@
 #pragma once
 
 #include <chrono>
+#include <functional>
 #include <memory>
+#include <string>
 #include <unordered_set>
 #include <vector>
 
 #include <assimp/scene.h>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
 
+#include "Animator.h"
+#include "BoundingSphere.h"
+#include "InstanceCuller.h"
 #include "Model.h"
 
 namespace ge {
 
+class AnimationClip;
+class Imposter;
 class InstancingMesh;
+class Skeleton;
+class VertexAnimationTexture;
 
 ///
 /// \brief The InstancingGameObjects class allows drawing lots of models
@@ -26,6 +38,7 @@ public:
     using const_iterator = ModelContainer::const_iterator;
     using reference = ModelContainer::reference;
     using const_reference = ModelContainer::const_reference;
+    using AnimationClips = std::vector<std::shared_ptr<const AnimationClip>>;
 
     ///
     /// \brief InstancingGameObjects Creates a number of game objects
@@ -38,10 +51,165 @@ public:
     explicit InstancingGameObjects(const std::string& modelFilepath, size_t count);
     virtual ~InstancingGameObjects();
 
+    ///
+    /// \brief onUpdate Updates the instances' state.
+    ///
+    /// The base implementation calls InstancingGameObjects::updateAnimations().
+    ///
+    /// \param updateDuration Elapsed time since the last frame.
+    ///
     virtual void onUpdate(std::chrono::duration<float> updateDuration);
 
+    ///
+    /// \brief updateAnimations Advances the animator of every instance of a skinned model
+    ///                         and computes the skin matrices of their poses.
+    ///
+    /// Instances are animated in parallel on the job system. Does nothing if the model
+    /// has no skeleton. Once vertex animations are baked, only advances their time.
+    ///
+    /// \param updateDuration Elapsed time since the last frame.
+    ///
+    void updateAnimations(std::chrono::duration<float> updateDuration);
+
+    ///
+    /// \brief render Draws all instances.
+    ///
+    /// The skin matrices of skinned instances are bound to texture unit 2 as the
+    /// "boneMatrices" texture buffer, with "numBones" matrices per instance. Baked
+    /// vertex animations are bound to texture units 2 and 3 instead, see
+    /// InstancingGameObjects::bakeVertexAnimations().
+    ///
+    /// \param shader Active shader program reading instance matrices from attributes 3 to 9.
+    ///
     void render(ShaderProgram *shader);
 
+    ///
+    /// \brief render Draws the instances whose bounding spheres intersect the view frustum.
+    ///
+    /// Instances are culled on the GPU with InstanceCuller's default backend, so the
+    /// instance matrices are never read back.
+    ///
+    /// Skinned instances look up their skin matrices by instance ID, which culling
+    /// reorders, so they are all drawn as with InstancingGameObjects::render(ShaderProgram*).
+    /// Instances with baked vertex animations are culled along with their animation.
+    ///
+    /// \param shader Shader program reading instance matrices from attributes 3 to 9.
+    ///               It is made active after culling.
+    /// \param viewProjectionMatrix Projection matrix multiplied by the view matrix.
+    ///
+    void render(ShaderProgram *shader, const glm::mat4 &viewProjectionMatrix);
+
+    ///
+    /// \brief render Draws the visible instances closer to the camera than the imposter
+    ///               distance, or all visible instances if no imposters are baked.
+    ///
+    /// Together with InstancingGameObjects::renderImposters() every visible instance is
+    /// drawn exactly once, each group with one instanced draw per mesh.
+    ///
+    /// \param shader Shader program reading instance matrices from attributes 3 to 9.
+    ///               It is made active after culling.
+    /// \param viewProjectionMatrix Projection matrix multiplied by the view matrix.
+    /// \param viewPosition Position of the camera in world space.
+    ///
+    void render(ShaderProgram *shader, const glm::mat4 &viewProjectionMatrix, const glm::vec3 &viewPosition);
+
+    ///
+    /// \brief renderImposters Draws the visible instances at or beyond the imposter
+    ///                        distance as imposters, in one instanced draw.
+    ///
+    /// Does nothing if no imposters are baked. Instances are culled on the GPU as by
+    /// InstancingGameObjects::render(), with a culler of their own. Game::renderInstancing()
+    /// draws both in the depth pre-pass and opaque passes of Game.
+    ///
+    /// \param shader Default shader variant with the INSTANCING and IMPOSTER features and
+    ///               the "viewPosition" uniform set. It is made active after culling.
+    /// \param viewProjectionMatrix Projection matrix multiplied by the view matrix.
+    /// \param viewPosition Position of the camera in world space.
+    ///
+    void renderImposters(ShaderProgram *shader, const glm::mat4 &viewProjectionMatrix,
+                         const glm::vec3 &viewPosition);
+
+    ///
+    /// \brief getSkeleton Returns the skeleton of the model or nullptr if it has no
+    ///                    skinned meshes.
+    ///
+    std::shared_ptr<const Skeleton> getSkeleton() const;
+
+    ///
+    /// \brief getAnimationClips Returns the animations of the model, shared by all
+    ///                          instances, or nullptr if it has no skeleton.
+    ///
+    std::shared_ptr<const AnimationClips> getAnimationClips() const;
+
+    ///
+    /// \brief bakeVertexAnimations Bakes the model's clips into vertex animation textures
+    ///                             and switches every instance to vertex animation.
+    ///
+    /// Instances then drop their animators and skin matrices. Each one only holds the
+    /// index of a baked clip and a phase (see InstancingModel::playVertexAnimation())
+    /// and is animated entirely by the vertex shader, so animated instances cost as
+    /// little CPU as static ones. Draw them with the default shader's INSTANCING and
+    /// VERTEX_ANIMATION features.
+    ///
+    /// \param framesPerSecond Number of frames to bake per second of animation.
+    /// \exception ge::Error The model has meshes that are not skinned or its clips do
+    ///                      not fit in vertex animation textures.
+    ///
+    void bakeVertexAnimations(float framesPerSecond = 30.0f);
+
+    bool hasVertexAnimations() const;
+
+    ///
+    /// \brief bakeImposters Bakes the model into an Imposter, which replaces the instances
+    ///                      beyond the imposter distance.
+    ///
+    /// Skinned and animated meshes are baked in their bind pose. Only requires a current
+    /// GL context, see Imposter.
+    ///
+    /// \param bakeShader Shader writing the albedo and the normal and depth of the meshes,
+    ///                   see imposter_bake.frag.
+    /// \param numViewsPerSide Number of views along each side of the imposter's atlases.
+    /// \param viewResolution_texels Width and height of a view.
+    /// \exception ge::Error The framebuffer of the atlases could not be created.
+    ///
+    void bakeImposters(ShaderProgram *bakeShader, int numViewsPerSide = 8, int viewResolution_texels = 128);
+
+    bool hasImposters() const;
+
+    ///
+    /// \brief setImposterDistance Sets the distance from the camera to the instances'
+    ///                            centers from which they are drawn as imposters.
+    ///
+    InstancingGameObjects& setImposterDistance(float distance);
+    float getImposterDistance() const;
+
+    ///
+    /// \brief getBoundingSphere Returns a sphere enclosing the meshes of every instance
+    ///                          in model space.
+    ///
+    BoundingSphere getBoundingSphere() const;
+
+    ///
+    /// \brief getInstanceCuller Returns the culler used by the culling render function,
+    ///                          or nullptr if it has not been used yet.
+    ///
+    const InstanceCuller* getInstanceCuller() const;
+
+    ///
+    /// \brief prepareReload Reads a model file that changed on the calling thread.
+    ///
+    /// The meshes and materials of the instanced model are replaced in place, see
+    /// GameObject::prepareReload(). Baked vertex animations and imposters are not baked
+    /// again.
+    ///
+    /// \param filepath Canonical path of the model file.
+    /// \return Command replacing the meshes of the loaded model, to run on the render
+    ///         thread, or nullptr if no instanced model was loaded from the file. The
+    ///         command throws ge::LoadError if the meshes of the model changed.
+    /// \exception ge::LoadError Failed to load mesh data from model file.
+    ///
+    static std::function<void()> prepareReload(const std::string &filepath);
+
     /// \name Member Access
     /// Allows accessing individual models to change or access
     /// model data such as pose and scale.
@@ -74,7 +242,42 @@ private:
     /// \exception gl::LoadError Failed to load texture image from file.
     ///
     void loadMeshes(const std::string &modelFilepath);
-    void processNode(const aiNode &node, const aiScene &scene, const std::string &modelDirectory);
+
+    ///
+    /// \brief uploadSkinMatrices Uploads the skin matrices of all instances to the
+    ///                           texture buffer and binds it to texture unit 2.
+    ///
+    void uploadSkinMatrices(ShaderProgram *shader);
+
+    ///
+    /// \brief setVertexAnimationUniforms Sets the baked clips and the animation time.
+    ///
+    void setVertexAnimationUniforms(ShaderProgram *shader);
+
+    ///
+    /// \brief bindVertexAnimationTexture Binds the vertex animation texture of a mesh,
+    ///                                   if vertex animations are baked.
+    ///
+    void bindVertexAnimationTexture(ShaderProgram *shader, size_t meshIndex);
+
+    ///
+    /// \brief uploadChangedModels Uploads the matrices and animations of the changed instances.
+    ///
+    void uploadChangedModels();
+
+    ///
+    /// \brief setInstanceAttribs Makes the meshes read their instance matrices and
+    ///                           animations from the instance buffers or the culled
+    ///                           instance buffer.
+    ///
+    void setInstanceAttribs(bool culled);
+
+    ///
+    /// \brief renderCulled Draws the meshes of the visible instances within a range of
+    ///                     distances from the camera.
+    ///
+    void renderCulled(ShaderProgram *shader, const glm::mat4 &viewProjectionMatrix,
+                      const InstanceCuller::DistanceRange &distanceRange);
 
     ModelContainer models;
     std::unordered_set<size_t> changedModelIndices;
@@ -82,6 +285,25 @@ private:
     unsigned int modelMatrixBufferObject;
     unsigned int normalMatrixBufferObject;
     std::shared_ptr<Meshes> meshes;
+
+    std::unique_ptr<InstanceCuller> instanceCuller;
+    bool culledInstanceAttribs = false;
+
+    std::shared_ptr<const Skeleton> skeleton;
+    std::shared_ptr<const AnimationClips> animationClips;
+    std::vector<Animator> animators;
+    std::vector<glm::mat4> skinMatrices;
+    unsigned int skinMatrixBufferObject = 0;
+    unsigned int skinMatrixTexture = 0;
+
+    std::vector<std::unique_ptr<VertexAnimationTexture>> vertexAnimationTextures;
+    std::vector<glm::vec2> instanceAnimations;
+    unsigned int animationBufferObject = 0;
+    float vertexAnimationTime_s = 0.0f;
+
+    std::unique_ptr<Imposter> imposter;
+    std::unique_ptr<InstanceCuller> imposterCuller;
+    float imposterDistance = 100.0f;
 };
 
 ///
@@ -115,6 +337,20 @@ public:
 
     InstancingModel& setScale(const glm::vec3 &scale);
 
+    ///
+    /// \brief getAnimator Returns the animator of this instance, or nullptr if the
+    ///                    model has no skeleton.
+    ///
+    Animator* getAnimator();
+
+    ///
+    /// \brief playVertexAnimation Plays a baked clip on this instance.
+    /// \param clip Index of the clip in InstancingGameObjects::getAnimationClips().
+    /// \param phase_s Time offset of this instance in the clip, e.g. to desynchronize a crowd.
+    /// \exception ge::Error Vertex animations are not baked or the clip does not exist.
+    ///
+    InstancingModel& playVertexAnimation(size_t clip, float phase_s = 0.0f);
+
 private:
     InstancingModel& notifyModelChanged();
 
@@ -159,6 +395,35 @@ inline size_t InstancingGameObjects::size() const noexcept {
     return this->models.size();
 }
 
+inline const InstanceCuller* InstancingGameObjects::getInstanceCuller() const {
+    return this->instanceCuller.get();
+}
+
+inline std::shared_ptr<const Skeleton> InstancingGameObjects::getSkeleton() const {
+    return this->skeleton;
+}
+
+inline std::shared_ptr<const InstancingGameObjects::AnimationClips> InstancingGameObjects::getAnimationClips() const {
+    return this->animationClips;
+}
+
+inline bool InstancingGameObjects::hasVertexAnimations() const {
+    return !this->vertexAnimationTextures.empty();
+}
+
+inline bool InstancingGameObjects::hasImposters() const {
+    return this->imposter != nullptr;
+}
+
+inline InstancingGameObjects& InstancingGameObjects::setImposterDistance(float distance) {
+    this->imposterDistance = distance;
+    return *this;
+}
+
+inline float InstancingGameObjects::getImposterDistance() const {
+    return this->imposterDistance;
+}
+
 inline glm::mat4 InstancingGameObjects::InstancingModel::getModelMatrix() const {
     return this->model.getModelMatrix();
 }
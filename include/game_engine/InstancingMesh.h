@@ -4,6 +4,8 @@
 
 namespace ge {
 
+class InstanceCuller;
+
 ///
 /// \brief The InstancingMesh class is a proxy class for Mesh that uses
 ///        instanced rendering to optimize drawing many objects sharing
@@ -11,11 +13,77 @@ namespace ge {
 ///
 class InstancingMesh : private Mesh {
 public:
-    InstancingMesh(const aiMesh &mesh, const aiMaterial &material, const std::string &textureDirectory);
-    InstancingMesh& addModelMatrixAttrib(unsigned int modelMatrixBufferObject);
-    InstancingMesh& addNormalMatrixAttrib(unsigned int normalMatrixBufferObject);
+    InstancingMesh(const aiMesh &mesh, const aiMaterial &material, const std::string &textureDirectory,
+                   const Skeleton *skeleton = nullptr);
+
+    ///
+    /// \brief addModelMatrixAttrib Reads per-instance model matrices from attributes 3 to 6.
+    /// \param modelMatrixBufferObject Buffer holding the model matrices.
+    /// \param stride_bytes Distance between the model matrices of consecutive instances.
+    /// \param offset_bytes Offset of the first model matrix.
+    ///
+    InstancingMesh& addModelMatrixAttrib(unsigned int modelMatrixBufferObject,
+                                         size_t stride_bytes = 16 * sizeof(float),
+                                         size_t offset_bytes = 0);
+
+    ///
+    /// \brief addNormalMatrixAttrib Reads per-instance normal matrices from attributes 7 to 9.
+    /// \param normalMatrixBufferObject Buffer holding the normal matrices.
+    /// \param stride_bytes Distance between the normal matrices of consecutive instances.
+    /// \param offset_bytes Offset of the first normal matrix.
+    ///
+    InstancingMesh& addNormalMatrixAttrib(unsigned int normalMatrixBufferObject,
+                                          size_t stride_bytes = 9 * sizeof(float),
+                                          size_t offset_bytes = 0);
+
+    ///
+    /// \brief addAnimationAttrib Reads per-instance vertex animations from attribute 12.
+    /// \param animationBufferObject Buffer holding the baked clip index and phase of
+    ///                              each instance, see VertexAnimationTexture.
+    /// \param stride_bytes Distance between the animations of consecutive instances.
+    /// \param offset_bytes Offset of the first animation.
+    ///
+    InstancingMesh& addAnimationAttrib(unsigned int animationBufferObject,
+                                       size_t stride_bytes = 2 * sizeof(float),
+                                       size_t offset_bytes = 0);
 
     void render(ShaderProgram *shader, size_t numInstances);
+
+    ///
+    /// \brief render Draws the instances that passed the culler's last cull.
+    ///
+    /// The instance attributes must be read from the culler's culled instance buffer.
+    ///
+    /// \param shader Active shader program.
+    /// \param culler Culler of the instances.
+    ///
+    void render(ShaderProgram *shader, const InstanceCuller &culler);
+
+    ///
+    /// \brief swap Exchanges the mesh data of two meshes, see Mesh::swap().
+    ///
+    /// The instance attributes of each mesh are kept, i.e. read from the same buffers
+    /// by its new vertex array.
+    ///
+    void swap(InstancingMesh &other);
+
+    using Mesh::getBoundingSphere;
+    using Mesh::isSkinned;
+    using Mesh::getSkinningData;
+
+private:
+    ///
+    /// \brief The InstanceAttrib struct records where an instance attribute is read from.
+    ///
+    struct InstanceAttrib {
+        unsigned int bufferObject = 0;
+        size_t stride_bytes = 0;
+        size_t offset_bytes = 0;
+    };
+
+    InstanceAttrib modelMatrixAttrib;
+    InstanceAttrib normalMatrixAttrib;
+    InstanceAttrib animationAttrib;
 };
 
 } // namespace ge
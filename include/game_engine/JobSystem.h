@@ -0,0 +1,99 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ge {
+
+///
+/// \brief The JobSystem class is a fixed size pool of worker threads that
+/// runs jobs submitted from any thread.
+///
+class JobSystem {
+public:
+    ///
+    /// \brief JobSystem Starts the worker threads.
+    /// \param numThreads Number of worker threads to start. 0 selects one less
+    ///                   than the number of hardware threads so that the calling
+    ///                   thread may also participate in JobSystem::parallelFor().
+    ///
+    explicit JobSystem(unsigned int numThreads = 0);
+
+    ///
+    /// \brief Finishes all queued jobs and joins the worker threads.
+    ///
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem(JobSystem &&) = delete;
+    JobSystem& operator=(const JobSystem &) = delete;
+    JobSystem& operator=(JobSystem &&) = delete;
+
+    ///
+    /// \brief getInstance Returns the job system shared by the engine.
+    ///
+    /// The shared job system is lazily created on first use.
+    ///
+    /// \return The shared job system.
+    ///
+    static JobSystem& getInstance();
+
+    ///
+    /// \brief submit Queues a job to run on a worker thread.
+    /// \param job Callable taking no arguments.
+    /// \return Future holding the result (or exception) of the job.
+    ///
+    template<typename F>
+    std::future<typename std::result_of<F()>::type> submit(F &&job);
+
+    ///
+    /// \brief parallelFor Splits [0, count) into ranges of at most grainSize elements
+    ///                    and runs fn(begin, end) on every range.
+    ///
+    /// The calling thread also processes ranges, so this may safely be called
+    /// from within another job. Blocks until every range has been processed.
+    /// The first exception thrown by fn is rethrown on the calling thread.
+    ///
+    /// \param count Number of elements.
+    /// \param grainSize Maximum number of elements processed by a single call of fn.
+    /// \param fn Callable with the signature void(size_t begin, size_t end).
+    ///
+    void parallelFor(size_t count, size_t grainSize,
+                     const std::function<void(size_t, size_t)> &fn);
+
+    unsigned int getNumThreads() const;
+
+private:
+    void enqueue(std::function<void()> job);
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    std::mutex jobsMutex;
+    std::condition_variable jobsAvailable;
+    bool stopping = false;
+};
+
+template<typename F>
+std::future<typename std::result_of<F()>::type> JobSystem::submit(F &&job) {
+    using Result = typename std::result_of<F()>::type;
+
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(job));
+    auto future = task->get_future();
+    this->enqueue([task]{(*task)();});
+
+    return future;
+}
+
+inline unsigned int JobSystem::getNumThreads() const {
+    return static_cast<unsigned int>(this->workers.size());
+}
+
+} // namespace ge
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <glm/vec4.hpp>
+
+#include "Texture2D.h"
+
+struct aiMaterial;
+
+namespace ge {
+
+class MaterialRegistry;
+class ShaderProgram;
+
+///
+/// \brief The Material class holds the textures and shading parameters of a surface.
+///
+/// Every material has a stable ID indexing its parameters in the "materials" texture
+/// buffer maintained by MaterialRegistry. Shaders look the material up by the per-draw
+/// "materialId" uniform and sample its textures from the texture arrays bound to the
+/// "diffuseTextures" and "specularTextures" samplers.
+///
+/// Parameters are uploaded by MaterialRegistry::uploadChanges() on the thread that owns
+/// the GL context. The specular exponent may be changed from any thread. Textures must
+/// not be changed while the material may be rendered on another thread.
+///
+class Material {
+public:
+    using Id = unsigned int;
+
+    ///
+    /// \brief Material Creates a material with a white diffuse texture and no specular
+    ///                 highlights.
+    ///
+    Material();
+
+    ///
+    /// \brief Material Loads the first diffuse and specular textures and the shininess
+    ///                 of an Assimp material.
+    /// \param material Assimp material data to load.
+    /// \param textureDirectory Directory path containing all of the textures in this material.
+    /// \exception ge::LoadError Failed to load texture image from file.
+    ///
+    Material(const aiMaterial &material, const std::string &textureDirectory);
+
+    ~Material();
+
+    Material(const Material &) = delete;
+    Material(Material &&) = delete;
+    Material& operator=(const Material &) = delete;
+    Material& operator=(Material &&) = delete;
+
+    ///
+    /// \brief bind Sets the material ID uniform and binds the material's texture arrays
+    ///             to texture units 0 (diffuse) and 1 (specular).
+    /// \param shader Active shader program.
+    ///
+    void bind(ShaderProgram *shader) const;
+
+    Id getId() const;
+
+    void setDiffuseTexture(const Texture2D &texture);
+    const Texture2D& getDiffuseTexture() const;
+
+    void setSpecularTexture(const Texture2D &texture);
+    const Texture2D& getSpecularTexture() const;
+
+    void setSpecularExponent(float specularExponent);
+    float getSpecularExponent() const;
+
+    ///
+    /// \brief hasSpecularTexture Returns whether the material has a specular texture
+    ///                           other than the default black one.
+    ///
+    /// Materials without one have no specular highlights and may be drawn with shaders
+    /// that skip them.
+    ///
+    bool hasSpecularTexture() const;
+
+private:
+    void update();
+
+    std::shared_ptr<MaterialRegistry> registry;
+    Id id;
+
+    Texture2D diffuseTexture;
+    Texture2D specularTexture;
+    float specularExponent = 64.0f;
+};
+
+///
+/// \brief The MaterialRegistry class allocates material IDs and keeps the
+/// "materials" texture buffer up to date.
+///
+/// The buffer grows with the number of materials, up to the maximum size of texture
+/// buffers of the GL implementation (millions of materials on current GPUs). IDs of
+/// deleted materials are reused. The registry is shared by all materials and deleted
+/// with the last of them.
+///
+class MaterialRegistry {
+public:
+    ///
+    /// \brief The MaterialData struct is the layout of a material in the "materials"
+    /// texture buffer, 3 RGBA32F texels per material.
+    ///
+    struct MaterialData {
+        glm::vec4 diffuseUvTransform;
+        glm::vec4 specularUvTransform;
+        float diffuseLayer;
+        float specularLayer;
+        float specularExponent;
+        float padding;
+    };
+
+    ///
+    /// \brief getInstance Returns the registry shared by all materials, creating it
+    ///                    if there is none.
+    ///
+    /// Must be called on the thread that owns the GL context.
+    ///
+    static std::shared_ptr<MaterialRegistry> getInstance();
+
+    MaterialRegistry();
+    ~MaterialRegistry();
+
+    MaterialRegistry(const MaterialRegistry &) = delete;
+    MaterialRegistry(MaterialRegistry &&) = delete;
+    MaterialRegistry& operator=(const MaterialRegistry &) = delete;
+    MaterialRegistry& operator=(MaterialRegistry &&) = delete;
+
+    ///
+    /// \brief uploadChanges Uploads the parameters of materials that were created or
+    ///                      changed since the last call, growing the buffer if needed.
+    ///
+    /// Must be called on the thread that owns the GL context before rendering.
+    ///
+    void uploadChanges();
+
+    ///
+    /// \brief bind Binds the "materials" texture buffer to a texture unit.
+    /// \param textureUnit Texture unit the "materials" sampler of the shader is set to.
+    ///
+    void bind(unsigned int textureUnit) const;
+
+    const Texture2D& getDefaultDiffuseTexture() const;
+    const Texture2D& getDefaultSpecularTexture() const;
+
+private:
+    friend class Material;
+
+    ///
+    /// \brief allocateId Allocates the lowest free material ID.
+    /// \exception ge::Error The materials exceed the maximum size of texture buffers.
+    ///
+    Material::Id allocateId();
+    void releaseId(Material::Id id);
+    void setMaterialData(Material::Id id, const MaterialData &data);
+
+    unsigned int bufferObject;
+    unsigned int texture;
+    /// Number of materials the buffer object has storage for.
+    size_t bufferCapacity = 0;
+    size_t maxNumMaterials;
+
+    Texture2D defaultDiffuseTexture;
+    Texture2D defaultSpecularTexture;
+
+    std::mutex mutex;
+    std::vector<Material::Id> freeIds;
+    std::vector<MaterialData> materialData;
+    Material::Id firstChangedId;
+    Material::Id lastChangedId;
+};
+
+inline Material::Id Material::getId() const {return this->id;}
+inline const Texture2D& Material::getDiffuseTexture() const {return this->diffuseTexture;}
+inline const Texture2D& Material::getSpecularTexture() const {return this->specularTexture;}
+inline float Material::getSpecularExponent() const {return this->specularExponent;}
+
+inline const Texture2D& MaterialRegistry::getDefaultDiffuseTexture() const {return this->defaultDiffuseTexture;}
+inline const Texture2D& MaterialRegistry::getDefaultSpecularTexture() const {return this->defaultSpecularTexture;}
+
+} // namespace ge
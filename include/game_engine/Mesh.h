@@ -1,21 +1,37 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include <assimp/material.h>
 #include <assimp/mesh.h>
 
+#include <glm/vec3.hpp>
+
+#include "BoundingSphere.h"
+#include "Skeleton.h"
+
 namespace ge {
 
+class Material;
 class ShaderProgram;
-class Texture2D;
 
 ///
 /// \brief Aggregates vertex and index data to load onto the GPU
 ///        and render onto the screen.
 ///
 class Mesh {
-public:    
+public:
+    ///
+    /// \brief The SkinningData struct holds the bind pose vertices of a skinned mesh
+    /// for skinning on the CPU, see ge::skinVertices().
+    ///
+    struct SkinningData {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<BoneInfluences> boneInfluences;
+    };
+
     ///
     /// \brief Generates a VAO, VBO and EBO for the mesh data,
     ///        loads texture data from the material and
@@ -24,9 +40,22 @@ public:
     /// \param material Assimp material data to load for this mesh.
     /// \param textureDirectory Directory path containing all of the
     ///                         textures in this material.
+    /// \param skeleton Skeleton of the scene for skinned meshes, see Mesh(const aiMesh&, std::shared_ptr<Material>, const Skeleton*).
     /// \exception ge::LoadError Failed to load texture image from file.
     ///
-    Mesh(const aiMesh &mesh, const aiMaterial &material, const std::string &textureDirectory);
+    Mesh(const aiMesh &mesh, const aiMaterial &material, const std::string &textureDirectory,
+         const Skeleton *skeleton = nullptr);
+
+    ///
+    /// \brief Generates a VAO, VBO and EBO for the mesh data and
+    ///        loads all data onto the GPU.
+    /// \param mesh Assimp mesh data to load.
+    /// \param material Material to render the mesh with. It may be shared with other meshes.
+    /// \param skeleton Skeleton of the scene. If the mesh has bones, the indices and weights
+    ///                 of the bones deforming each vertex are packed into attributes 10
+    ///                 (4 unsigned bytes read as ivec4) and 11 (4 normalized unsigned bytes).
+    ///
+    Mesh(const aiMesh &mesh, std::shared_ptr<Material> material, const Skeleton *skeleton = nullptr);
 
     Mesh(const std::vector<float> &positions,
          const std::vector<float> &normals,
@@ -39,24 +68,70 @@ public:
     ///
     virtual ~Mesh();
 
+    ///
+    /// \brief render Binds the mesh's material and draws the mesh.
+    /// \param shader Active shader program.
+    ///
     void render(ShaderProgram *shader);
 
+    ///
+    /// \brief draw Draws the mesh without binding its material.
+    ///
+    /// Allows renderers to skip binding state shared with the previously drawn mesh.
+    ///
+    void draw();
+
+    std::shared_ptr<Material> getMaterial() const;
+    void setMaterial(std::shared_ptr<Material> material);
+
+    ///
+    /// \brief getBoundingSphere Returns a sphere enclosing the mesh's vertices in model space.
+    ///
+    /// The sphere encloses the bind pose of skinned meshes.
+    ///
+    const BoundingSphere& getBoundingSphere() const;
+
+    ///
+    /// \brief isSkinned Returns true if the mesh is deformed by the bones of a skeleton.
+    ///
+    bool isSkinned() const;
+
+    ///
+    /// \brief getSkinningData Returns the bind pose vertices of a skinned mesh or nullptr.
+    ///
+    const SkinningData* getSkinningData() const;
+
+    ///
+    /// \brief swap Exchanges the GPU data, bounding sphere, material and bind pose of two
+    ///             meshes, e.g. to replace a mesh by one loaded from its changed file
+    ///             while the users of the mesh keep it.
+    ///
+    /// Must be called on the thread that owns the GL context. The meshes must either
+    /// both be skinned or both not be.
+    ///
+    void swap(Mesh &other);
+
 protected:
     unsigned int getNumIndices() const;
     void bindVao();
-    void bindTextures(ShaderProgram *shader);
+    void bindMaterial(ShaderProgram *shader);
 
 private:
     unsigned int vao;
     unsigned int vbo;
     unsigned int ebo;
     unsigned int numIndices;
+    BoundingSphere boundingSphere;
+
+    std::shared_ptr<Material> material;
 
-    std::vector<Texture2D> ambientTextures;
-    std::vector<Texture2D> diffuseTextures;
-    std::vector<Texture2D> specularTextures;
+    std::unique_ptr<SkinningData> skinningData;
 };
 
+inline std::shared_ptr<Material> Mesh::getMaterial() const {return this->material;}
+inline const BoundingSphere& Mesh::getBoundingSphere() const {return this->boundingSphere;}
 inline unsigned int Mesh::getNumIndices() const {return this->numIndices;}
+inline bool Mesh::isSkinned() const {return this->skinningData != nullptr;}
+inline const Mesh::SkinningData* Mesh::getSkinningData() const {return this->skinningData.get();}
 
 } // namespace ge
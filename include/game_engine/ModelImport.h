@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+
+namespace ge {
+
+///
+/// \brief The ImportedModel struct holds a model file read into memory, from which
+/// meshes are then created.
+///
+struct ImportedModel {
+    Assimp::Importer importer;
+    const aiScene *scene = nullptr;
+
+    /// Estimated GPU memory of the meshes created from the model, without textures.
+    size_t meshGpuSize_bytes = 0;
+};
+
+///
+/// \brief importModelFile Reads a model file, or returns it if it was already read.
+///
+/// Imported models are shared through the ResourceManager, so that GameObject and
+/// InstancingGameObjects loading the same model file read it once. May be called from
+/// any thread.
+///
+/// \param modelFilepath Filepath to the model data.
+/// \exception ge::LoadError Failed to load mesh data from model file.
+///
+std::shared_ptr<const ImportedModel> importModelFile(const std::string &modelFilepath);
+
+///
+/// \brief readModelFile Reads a model file without caching it, e.g. to reload it after
+///                      it changed. May be called from any thread.
+/// \param modelFilepath Filepath to the model data.
+/// \exception ge::LoadError Failed to load mesh data from model file.
+///
+std::shared_ptr<const ImportedModel> readModelFile(const std::string &modelFilepath);
+
+} // namespace ge
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+#include "JobSystem.h"
+
+namespace ge {
+
+///
+/// \brief The ParticleForces struct holds the forces acting on every particle of a pool.
+///
+struct ParticleForces {
+    /// Constant acceleration, e.g. gravity or wind.
+    glm::vec3 acceleration {0.0f};
+
+    /// Fraction of the velocity lost per second to air resistance.
+    float drag = 0.0f;
+};
+
+///
+/// \brief The ParticlePool class stores particles as a structure of arrays and
+/// simulates them.
+///
+/// Every attribute is stored in its own array so that updates stream through memory
+/// and process four particles per SSE instruction. Storage for the capacity is
+/// allocated up front and never reallocated.
+///
+/// Expired particles are removed in parallel. Every update job first compacts the live
+/// particles of its range to the start of the range. Prefix sums over the ranges then
+/// give every hole left before the end of the live particles a particle moved in from
+/// the tail, so the order of particles is not stable.
+///
+class ParticlePool {
+public:
+    ///
+    /// \brief The Particle struct holds the initial state of an emitted particle.
+    ///
+    struct Particle {
+        glm::vec3 position {0.0f};
+        glm::vec3 velocity {0.0f};
+        float lifetime_s = 1.0f;
+        float size = 1.0f;
+
+        /// RGBA8 color, red in the lowest byte.
+        std::uint32_t color = 0xFFFFFFFFu;
+    };
+
+    ///
+    /// \brief ParticlePool Allocates storage for a number of particles.
+    /// \param capacity Maximum number of live particles.
+    ///
+    explicit ParticlePool(size_t capacity);
+
+    ///
+    /// \brief emit Adds a particle.
+    /// \param particle Initial state of the particle.
+    /// \return false if the pool is full and the particle was dropped.
+    ///
+    bool emit(const Particle &particle);
+
+    ///
+    /// \brief update Integrates the particles and removes the expired ones.
+    ///
+    /// Particles are integrated in parallel on the job system, with SSE where
+    /// available, using semi-implicit Euler integration. Each job then compacts the
+    /// live particles of its range, and the live particles past the new size are moved
+    /// into the slots left below it in parallel.
+    ///
+    /// \param duration_s Elapsed time since the last update.
+    /// \param forces Forces acting on the particles.
+    /// \param jobSystem Job system to update on.
+    ///
+    void update(float duration_s, const ParticleForces &forces,
+                JobSystem &jobSystem = JobSystem::getInstance());
+
+    void clear();
+
+    size_t size() const;
+    size_t capacity() const;
+
+    /// \name Particle Attributes
+    /// Arrays of at least size() elements, indexed by particle.
+    ///@{
+    const float* getPositionsX() const;
+    const float* getPositionsY() const;
+    const float* getPositionsZ() const;
+    const float* getVelocitiesX() const;
+    const float* getVelocitiesY() const;
+    const float* getVelocitiesZ() const;
+    const float* getAges() const;
+    const float* getLifetimes() const;
+    const float* getSizes() const;
+    const std::uint32_t* getColors() const;
+    ///@}
+
+private:
+    void integrate(size_t begin, size_t end, float duration_s, const ParticleForces &forces);
+
+    ///
+    /// \brief compactRange Moves the live particles of a range to its start.
+    /// \return Number of live particles in the range.
+    ///
+    size_t compactRange(size_t begin, size_t end);
+
+    ///
+    /// \brief removeExpired Gathers the live particles compacted at the start of the
+    ///                      range of every update job at the start of the pool.
+    ///
+    void removeExpired(JobSystem &jobSystem);
+
+    void moveParticle(size_t from, size_t to);
+
+    size_t numParticles = 0;
+
+    /// Number of live particles at the start of every range after compactRange().
+    std::vector<size_t> numLiveParticlesPerRange;
+
+    std::vector<float> positionsX;
+    std::vector<float> positionsY;
+    std::vector<float> positionsZ;
+    std::vector<float> velocitiesX;
+    std::vector<float> velocitiesY;
+    std::vector<float> velocitiesZ;
+    std::vector<float> ages;
+    std::vector<float> lifetimes;
+    std::vector<float> sizes;
+    std::vector<std::uint32_t> colors;
+};
+
+inline void ParticlePool::clear() {this->numParticles = 0;}
+inline size_t ParticlePool::size() const {return this->numParticles;}
+inline size_t ParticlePool::capacity() const {return this->ages.size();}
+inline const float* ParticlePool::getPositionsX() const {return this->positionsX.data();}
+inline const float* ParticlePool::getPositionsY() const {return this->positionsY.data();}
+inline const float* ParticlePool::getPositionsZ() const {return this->positionsZ.data();}
+inline const float* ParticlePool::getVelocitiesX() const {return this->velocitiesX.data();}
+inline const float* ParticlePool::getVelocitiesY() const {return this->velocitiesY.data();}
+inline const float* ParticlePool::getVelocitiesZ() const {return this->velocitiesZ.data();}
+inline const float* ParticlePool::getAges() const {return this->ages.data();}
+inline const float* ParticlePool::getLifetimes() const {return this->lifetimes.data();}
+inline const float* ParticlePool::getSizes() const {return this->sizes.data();}
+inline const std::uint32_t* ParticlePool::getColors() const {return this->colors.data();}
+
+} // namespace ge
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "FramePacket.h"
+#include "ShaderProgram.h"
+
+namespace ge {
+
+///
+/// \brief The ParticleRenderer class draws particle batches as instanced
+/// camera-facing quads.
+///
+/// All particles share a single quad and every particle is an instance reading its
+/// position, size, color and age from a streamed instance buffer. Particles are
+/// depth tested against the frame but never write depth or velocities.
+///
+/// Must only be used on the thread that owns the GL context.
+///
+class ParticleRenderer {
+public:
+    ///
+    /// \brief ParticleRenderer Builds the particle shader and the shared quad.
+    /// \param vertexShaderPath Filepath of the particle vertex shader.
+    /// \param fragmentShaderPath Filepath of the particle fragment shader.
+    /// \exception std::ios_base::failure Failed to open either file.
+    ///
+    ParticleRenderer(const std::string &vertexShaderPath, const std::string &fragmentShaderPath);
+    ~ParticleRenderer();
+
+    ParticleRenderer(const ParticleRenderer &) = delete;
+    ParticleRenderer(ParticleRenderer &&) = delete;
+    ParticleRenderer& operator=(const ParticleRenderer &) = delete;
+    ParticleRenderer& operator=(ParticleRenderer &&) = delete;
+
+    ///
+    /// \brief render Draws particle batches in order with their blend modes.
+    ///
+    /// The view and projection matrices are read from the "Matrices" uniform block.
+    ///
+    /// \param particleBatches Batches to draw.
+    ///
+    void render(const std::vector<FramePacket::ParticleBatch> &particleBatches);
+
+    ShaderProgram& getShader();
+
+private:
+    std::unique_ptr<ShaderProgram> shader;
+
+    unsigned int vao = 0;
+    unsigned int quadBuffer = 0;
+    unsigned int instanceBuffer = 0;
+};
+
+inline ShaderProgram& ParticleRenderer::getShader() {return *this->shader;}
+
+} // namespace ge
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "ParticlePool.h"
+
+namespace ge {
+
+struct FramePacket;
+class Texture2D;
+
+///
+/// \brief The ParticleBlendMode enum lists how particles are blended into the frame.
+///
+enum class ParticleBlendMode {
+    /// Adds the particles' colors, e.g. for fire, sparks and rain. Order independent,
+    /// so particles are never sorted.
+    ADDITIVE,
+
+    /// Blends the particles over each other by their alpha, e.g. for smoke. Particles
+    /// are sorted back to front on every frame, so prefer ADDITIVE for very large counts.
+    ALPHA
+};
+
+///
+/// \brief The ParticleInstance struct is the per-instance data of a particle drawn
+/// as a camera-facing quad.
+///
+struct ParticleInstance {
+    glm::vec3 position;
+    float size;
+
+    /// RGBA8 color, red in the lowest byte.
+    std::uint32_t color;
+
+    /// Age divided by lifetime, in [0, 1].
+    float normalizedAge;
+};
+
+///
+/// \brief The ParticleEmitter struct describes where, how often and which particles
+/// are emitted. Ranges are sampled uniformly for every particle.
+///
+struct ParticleEmitter {
+    glm::vec3 position {0.0f};
+
+    /// Half extents of the box around the position that particles are emitted in.
+    glm::vec3 positionSpread {0.0f};
+
+    glm::vec3 velocity {0.0f};
+    glm::vec3 velocitySpread {0.0f};
+
+    float minLifetime_s = 1.0f;
+    float maxLifetime_s = 1.0f;
+
+    float minSize = 0.1f;
+    float maxSize = 0.1f;
+
+    glm::vec4 color {1.0f};
+
+    /// Particles emitted per second while enabled.
+    float rate_per_s = 0.0f;
+
+    bool enabled = true;
+};
+
+///
+/// \brief The ParticleSystem class emits, simulates and snapshots the particles of
+/// one effect, such as weather or an explosion.
+///
+/// Particles are simulated on the simulation thread by a ParticlePool and drawn by
+/// Game as instanced camera-facing quads that fade out over their lifetime. See
+/// Game::addParticleSystem().
+///
+class ParticleSystem {
+public:
+    ///
+    /// \brief ParticleSystem Creates a particle system without emitters.
+    /// \param capacity Maximum number of live particles.
+    /// \param blendMode How the particles are blended into the frame.
+    /// \param texture Texture of the particles, or nullptr to draw soft round particles.
+    ///
+    explicit ParticleSystem(size_t capacity, ParticleBlendMode blendMode = ParticleBlendMode::ADDITIVE,
+                            std::shared_ptr<const Texture2D> texture = nullptr);
+
+    ///
+    /// \brief addEmitter Adds an emitter.
+    /// \return Index of the emitter.
+    ///
+    size_t addEmitter(const ParticleEmitter &emitter);
+    ParticleEmitter& getEmitter(size_t emitter);
+    size_t getNumEmitters() const;
+
+    ///
+    /// \brief burst Emits a number of particles from an emitter at once, e.g. for explosions.
+    /// \return Number of particles emitted, less than count if the pool is full.
+    ///
+    size_t burst(size_t emitter, size_t count);
+
+    ///
+    /// \brief update Emits the particles of the enabled emitters and simulates all particles.
+    /// \param updateDuration Elapsed time since the last update.
+    ///
+    void update(std::chrono::duration<float> updateDuration);
+
+    ///
+    /// \brief addToFramePacket Adds a snapshot of the particles to a frame packet.
+    ///
+    /// Alpha blended particles are sorted back to front from the packet's view position,
+    /// which must already be set. Snapshots released by the renderer are reused.
+    ///
+    /// \param framePacket Frame packet being built.
+    ///
+    void addToFramePacket(FramePacket &framePacket);
+
+    void setForces(const ParticleForces &forces);
+    const ParticleForces& getForces() const;
+
+    ParticleBlendMode getBlendMode() const;
+    const ParticlePool& getPool() const;
+
+private:
+    bool emit(const ParticleEmitter &emitter);
+
+    ParticlePool pool;
+    ParticleForces forces;
+    ParticleBlendMode blendMode;
+    std::shared_ptr<const Texture2D> texture;
+
+    std::vector<ParticleEmitter> emitters;
+
+    /// Fraction of a particle left over by every emitter in the last update.
+    std::vector<float> emissionRemainders;
+
+    /// Snapshots of the particles, reused once no frame packet holds them anymore.
+    std::vector<std::shared_ptr<std::vector<ParticleInstance>>> snapshots;
+
+    std::minstd_rand randomEngine;
+};
+
+inline ParticleEmitter& ParticleSystem::getEmitter(size_t emitter) {return this->emitters[emitter];}
+inline size_t ParticleSystem::getNumEmitters() const {return this->emitters.size();}
+inline void ParticleSystem::setForces(const ParticleForces &forces) {this->forces = forces;}
+inline const ParticleForces& ParticleSystem::getForces() const {return this->forces;}
+inline ParticleBlendMode ParticleSystem::getBlendMode() const {return this->blendMode;}
+inline const ParticlePool& ParticleSystem::getPool() const {return this->pool;}
+
+} // namespace ge
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+
+#include "RenderGraph.h"
+#include "ShaderProgram.h"
+
+namespace ge {
+
+///
+/// \brief The PostProcessor class adds the passes turning the HDR scene into the
+/// displayed image to a render graph.
+///
+/// - Temporal anti-aliasing: the scene is rendered with a different sub-pixel jitter every
+///   frame, see PostProcessor::getJitter(), and accumulated into a history at the output's
+///   resolution. The history is reprojected with the velocities of the scene and clamped
+///   to the colors around every pixel to reject disoccluded surfaces. As every pixel is
+///   reconstructed from the jittered samples around it, scenes rendered at a lower
+///   resolution are upscaled too. Instances are not accumulated, as their previous
+///   positions are unknown: their velocities reject the history, so they are aliased but
+///   do not ghost.
+/// - Bloom: the parts of the scene brighter than a threshold are downsampled to half
+///   resolution, then blurred down and up a mip chain with dual Kawase filters, each
+///   level taking 4 or 8 bilinear taps.
+/// - Tonemapping: the scene and its bloom are exposed and mapped into the displayable
+///   range with the ACES filmic curve. When disabled, the colors are only clamped.
+/// - Upscaling: when the scene is rendered at a lower resolution than the output, e.g.
+///   by dynamic resolution, and temporal anti-aliasing is disabled, the tonemapped image
+///   is upscaled bilinearly and sharpened with contrast adaptive sharpening to recover
+///   some of the lost detail.
+///
+/// Every pass may be toggled to scale the chain down on slower platforms. The graph
+/// measures the GPU time of the passes, named "temporal anti-aliasing", "bloom
+/// downsample <level>", "bloom upsample <level>", "tonemapping" and "upscaling".
+///
+/// Must only be used on the thread that owns the GL context.
+///
+class PostProcessor {
+public:
+    /// \name Global settings
+    /// These settings should be adjusted prior to rendering any frame.
+    ///@{
+    ///
+    /// \brief sceneFormat Internal format of the HDR scene, GL_RGBA16F or
+    ///                    GL_R11F_G11F_B10F to halve its size at the cost of precision.
+    ///
+    static GLenum sceneFormat;
+    ///@}
+
+    enum Pass {
+        TEMPORAL_ANTI_ALIASING,
+        BLOOM,
+        TONEMAPPING,
+
+        /// Only applies when upscaling, which is not a pass of its own.
+        SHARPENING,
+        NUM_PASSES
+    };
+
+    ///
+    /// \brief PostProcessor Builds the shaders of the passes.
+    /// \param vertexShaderPath Filepath of the vertex shader drawing a fullscreen triangle.
+    /// \param temporalShaderPath Filepath of the fragment shader accumulating the jittered
+    ///                           scene into the history.
+    /// \param bloomShaderPath Filepath of the fragment shader downsampling or upsampling
+    ///                        a bloom level, built with DOWNSAMPLE or UPSAMPLE defined.
+    /// \param tonemapShaderPath Filepath of the fragment shader combining the scene and
+    ///                          its bloom.
+    /// \param upscaleShaderPath Filepath of the fragment shader upscaling and sharpening
+    ///                          the tonemapped scene.
+    /// \exception std::ios_base::failure Failed to open a file.
+    ///
+    PostProcessor(const std::string &vertexShaderPath, const std::string &temporalShaderPath,
+                  const std::string &bloomShaderPath, const std::string &tonemapShaderPath,
+                  const std::string &upscaleShaderPath);
+    ~PostProcessor();
+
+    PostProcessor(const PostProcessor &) = delete;
+    PostProcessor(PostProcessor &&) = delete;
+    PostProcessor& operator=(const PostProcessor &) = delete;
+    PostProcessor& operator=(PostProcessor &&) = delete;
+
+    ///
+    /// \brief addPasses Adds the passes applying the enabled effects to a scene.
+    ///
+    /// Passes of disabled effects are still added but nothing reads their results, so
+    /// the graph culls them.
+    ///
+    /// \param graph Graph of the frame.
+    /// \param scene HDR render target holding the scene, rendered with the projection
+    ///              jittered by PostProcessor::getJitter(). Temporal anti-aliasing also
+    ///              reads its depth and velocity textures.
+    /// \param output Render target or backbuffer receiving the displayable image, which
+    ///               the scene is upscaled to if it is larger.
+    /// \exception ge::Error Temporal anti-aliasing is enabled but the scene has no depth
+    ///                      or velocity texture.
+    ///
+    void addPasses(RenderGraph *graph, RenderGraph::Resource scene, RenderGraph::Resource output);
+
+    ///
+    /// \brief getJitter Returns the offset in normalized device coordinates to translate
+    ///                  the projection of the scene by in this frame, or zero when temporal
+    ///                  anti-aliasing is disabled.
+    ///
+    /// Offsets follow a Halton sequence within a texel of the scene, and move on to the
+    /// next one on every call to PostProcessor::addPasses().
+    ///
+    glm::vec2 getJitter(int sceneWidth, int sceneHeight) const;
+
+    ///
+    /// \brief resetHistory Discards the frames accumulated by temporal anti-aliasing, e.g.
+    ///                     after the camera cut to another view.
+    ///
+    void resetHistory();
+
+    ///
+    /// \brief setPassEnabled Enables or disables a pass from the next frame on.
+    ///
+    PostProcessor& setPassEnabled(Pass pass, bool enabled);
+    bool isPassEnabled(Pass pass) const;
+
+    /// Scales the scene's colors before tonemapping.
+    PostProcessor& setExposure(float exposure);
+    float getExposure() const;
+
+    /// Weight of the current frame in the history, lower values are smoother but ghost more.
+    PostProcessor& setTemporalBlendFactor(float temporalBlendFactor);
+    float getTemporalBlendFactor() const;
+
+    /// Luminance above which colors start blooming.
+    PostProcessor& setBloomThreshold(float bloomThreshold);
+    float getBloomThreshold() const;
+
+    /// Weight of the bloom added to the scene.
+    PostProcessor& setBloomIntensity(float bloomIntensity);
+    float getBloomIntensity() const;
+
+    ///
+    /// \brief setNumBloomLevels Sets the number of levels of the bloom mip chain, starting
+    ///                          at half resolution. Fewer levels give a tighter and
+    ///                          cheaper bloom.
+    ///
+    PostProcessor& setNumBloomLevels(int numBloomLevels);
+    int getNumBloomLevels() const;
+
+    /// Strength of the sharpening applied when upscaling, from 0 to 1.
+    PostProcessor& setSharpness(float sharpness);
+    float getSharpness() const;
+
+private:
+    ///
+    /// \brief addTemporalAntiAliasingPass Adds the pass accumulating a scene into the history.
+    /// \param width Width of the history.
+    /// \param height Height of the history.
+    /// \return Render target holding the history, kept for the next frame.
+    ///
+    RenderGraph::Resource addTemporalAntiAliasingPass(RenderGraph *graph, RenderGraph::Resource scene,
+                                                      int width, int height);
+
+    ///
+    /// \brief addBloomPasses Adds the passes blurring the bright parts of a scene.
+    /// \return Half-resolution render target holding the bloom.
+    ///
+    RenderGraph::Resource addBloomPasses(RenderGraph *graph, RenderGraph::Resource scene);
+
+    ///
+    /// \brief drawFullscreenTriangle Draws a triangle covering the bound render target
+    ///                               without depth testing.
+    ///
+    void drawFullscreenTriangle() const;
+
+    std::unique_ptr<ShaderProgram> temporalShader;
+    std::unique_ptr<ShaderProgram> bloomDownsampleShader;
+    std::unique_ptr<ShaderProgram> bloomUpsampleShader;
+    std::unique_ptr<ShaderProgram> tonemapShader;
+    std::unique_ptr<ShaderProgram> upscaleShader;
+
+    /// Empty vertex array, fullscreen triangles are generated from their vertex IDs.
+    unsigned int vao = 0;
+
+    std::array<bool, NUM_PASSES> passesEnabled;
+
+    /// Accumulated frames, alternately read and written.
+    std::array<std::unique_ptr<RenderTarget>, 2> histories;
+    size_t currentHistory = 0;
+    bool historyValid = false;
+    unsigned int frameIndex = 0;
+
+    float temporalBlendFactor = 0.1f;
+    float exposure = 1.0f;
+    float bloomThreshold = 1.0f;
+    float bloomIntensity = 0.1f;
+    int numBloomLevels = 5;
+    float sharpness = 0.5f;
+};
+
+inline bool PostProcessor::isPassEnabled(Pass pass) const {return this->passesEnabled[pass];}
+
+inline float PostProcessor::getTemporalBlendFactor() const {return this->temporalBlendFactor;}
+inline float PostProcessor::getExposure() const {return this->exposure;}
+inline float PostProcessor::getBloomThreshold() const {return this->bloomThreshold;}
+inline float PostProcessor::getBloomIntensity() const {return this->bloomIntensity;}
+inline int PostProcessor::getNumBloomLevels() const {return this->numBloomLevels;}
+inline float PostProcessor::getSharpness() const {return this->sharpness;}
+
+} // namespace ge
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "GpuTimer.h"
+#include "RenderTargetPool.h"
+
+namespace ge {
+
+///
+/// \brief The RenderGraph class schedules the render passes of a frame from the
+/// resources they declare to read and write.
+///
+/// Every frame, resources and passes are declared in a valid order, then
+/// RenderGraph::execute() compiles and runs them:
+///
+/// - Passes are culled unless they write an output, e.g. the backbuffer, or a resource
+///   read or written by a pass that is not culled.
+/// - Passes are reordered within the dependencies implied by their declaration order,
+///   preferring to keep rendering into the bound framebuffer, which is only rebound
+///   when a pass writes another render target.
+/// - Transient render targets are acquired from a RenderTargetPool right before their
+///   first pass and released right after their last, so that targets with the same
+///   description whose lifetimes do not overlap share the same textures.
+/// - The GPU time of every pass is measured, see RenderGraph::getPassTime_ms().
+///
+/// Passes write at most one render target, which the graph binds before running them,
+/// and must not bind other framebuffers themselves. Imported resources that are not
+/// render targets, e.g. uniform buffers, only order the passes using them.
+///
+/// Must only be used on the thread that owns the GL context.
+///
+class RenderGraph {
+public:
+    using Resource = size_t;
+
+    ///
+    /// \brief RenderGraph Creates an empty graph.
+    /// \param renderTargetPool Pool of the transient render targets.
+    ///
+    explicit RenderGraph(RenderTargetPool *renderTargetPool);
+
+    RenderGraph(const RenderGraph &) = delete;
+    RenderGraph(RenderGraph &&) = delete;
+    RenderGraph& operator=(const RenderGraph &) = delete;
+    RenderGraph& operator=(RenderGraph &&) = delete;
+
+    ///
+    /// \brief createRenderTarget Declares a render target living for this frame only.
+    ///
+    Resource createRenderTarget(const std::string &name, const RenderTargetDesc &desc);
+
+    ///
+    /// \brief importBackbuffer Declares the default framebuffer as an output of the graph.
+    ///
+    Resource importBackbuffer(const std::string &name, int width, int height);
+
+    ///
+    /// \brief importRenderTarget Declares a render target kept across frames, e.g. the
+    ///                           history of a temporal effect.
+    ///
+    /// Passes may read it before any pass writes it, and the pool never recycles it.
+    ///
+    /// \param target Render target, which must outlive the execution of the graph.
+    ///
+    Resource importRenderTarget(const std::string &name, RenderTarget *target);
+
+    ///
+    /// \brief importResource Declares a resource managed outside of the graph, e.g. a
+    ///                       uniform buffer, whose reads and writes order the passes.
+    ///
+    Resource importResource(const std::string &name);
+
+    ///
+    /// \brief markOutput Keeps the passes writing a resource from being culled.
+    ///
+    void markOutput(Resource resource);
+
+    ///
+    /// \brief addPass Declares a pass.
+    /// \param name Name of the pass, under which its GPU time is measured.
+    /// \param reads Resources the pass reads, e.g. the textures it samples.
+    /// \param writes Resources the pass writes, including at most one render target or
+    ///               backbuffer, which is bound when the pass runs.
+    /// \param execute Issues the commands of the pass.
+    ///
+    void addPass(const std::string &name, const std::vector<Resource> &reads,
+                 const std::vector<Resource> &writes, std::function<void()> execute);
+
+    ///
+    /// \brief execute Culls, orders and runs the declared passes, then clears the graph
+    ///                for the next frame.
+    ///
+    /// The default framebuffer is left bound.
+    ///
+    /// \exception ge::Error A pass writes several render targets, or reads a render target
+    ///                      no earlier pass writes.
+    ///
+    void execute();
+
+    const RenderTargetDesc& getDesc(Resource renderTarget) const;
+
+    ///
+    /// \brief getRenderTarget Returns the render target allocated to a resource.
+    ///
+    /// Only valid while the passes reading or writing the resource run.
+    ///
+    const RenderTarget& getRenderTarget(Resource renderTarget) const;
+
+    ///
+    /// \brief getPassTime_ms Returns the latest GPU time of the pass with the given name in
+    ///                       milliseconds, or 0 if it never ran.
+    ///
+    float getPassTime_ms(const std::string &name) const;
+
+    ///
+    /// \brief getFrameTime_ms Returns the sum of the latest GPU times of the passes run by
+    ///                        the last call to RenderGraph::execute() in milliseconds.
+    ///
+    float getFrameTime_ms() const;
+
+    ///
+    /// \brief getExecutedPasses Returns the names of the passes run by the last call to
+    ///                          RenderGraph::execute(), in order.
+    ///
+    const std::vector<std::string>& getExecutedPasses() const;
+
+private:
+    enum ResourceType {
+        RENDER_TARGET,
+        IMPORTED_RENDER_TARGET,
+        BACKBUFFER,
+        IMPORTED
+    };
+
+    struct ResourceEntry {
+        std::string name;
+        ResourceType type;
+        RenderTargetDesc desc;
+        bool output;
+
+        /// Allocated during execution, unless imported.
+        RenderTarget *target;
+    };
+
+    struct Pass {
+        std::string name;
+        std::vector<Resource> reads;
+        std::vector<Resource> writes;
+        std::function<void()> execute;
+    };
+
+    ///
+    /// \brief compile Returns the indices of the passes to run, in order.
+    ///
+    std::vector<size_t> compile() const;
+
+    ///
+    /// \brief findFramebuffer Returns the render target or backbuffer a pass writes, if any.
+    ///
+    const Resource* findFramebuffer(const Pass &pass) const;
+
+    RenderTargetPool *renderTargetPool;
+
+    std::vector<ResourceEntry> resources;
+    std::vector<Pass> passes;
+
+    std::unordered_map<std::string, std::unique_ptr<GpuTimer>> passTimers;
+    std::vector<std::string> executedPasses;
+};
+
+inline const RenderTargetDesc& RenderGraph::getDesc(Resource renderTarget) const {
+    return this->resources[renderTarget].desc;
+}
+
+inline const RenderTarget& RenderGraph::getRenderTarget(Resource renderTarget) const {
+    return *this->resources[renderTarget].target;
+}
+
+inline const std::vector<std::string>& RenderGraph::getExecutedPasses() const {return this->executedPasses;}
+
+} // namespace ge
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace ge {
+
+///
+/// \brief The RenderTargetDesc struct describes the attachments of a render target.
+///
+struct RenderTargetDesc {
+    int width = 0;
+    int height = 0;
+
+    /// Sized internal format of the color texture, e.g. GL_RGBA16F, or 0 for none.
+    GLenum colorFormat = 0;
+
+    /// Sized internal format of the depth texture, e.g. GL_DEPTH_COMPONENT24, or 0 for none.
+    GLenum depthFormat = 0;
+
+    ///
+    /// Sized internal format of a second color texture holding the screen-space motion of
+    /// the pixels since the previous frame, e.g. GL_RG16F, or 0 for none. It is attached
+    /// to the second draw buffer.
+    ///
+    GLenum velocityFormat = 0;
+
+    bool operator==(const RenderTargetDesc &other) const;
+};
+
+///
+/// \brief The RenderTarget class is a framebuffer object with a color, a depth and a
+/// velocity texture, usually created and owned by a RenderTargetPool.
+///
+/// Color textures are filtered linearly and clamped to their edges so that passes may
+/// sample them at other resolutions.
+///
+class RenderTarget {
+public:
+    ///
+    /// \brief RenderTarget Creates the framebuffer object and its textures.
+    /// \exception ge::Error The driver cannot render into the described attachments.
+    ///
+    explicit RenderTarget(const RenderTargetDesc &desc);
+    ~RenderTarget();
+
+    RenderTarget(const RenderTarget &) = delete;
+    RenderTarget(RenderTarget &&) = delete;
+    RenderTarget& operator=(const RenderTarget &) = delete;
+    RenderTarget& operator=(RenderTarget &&) = delete;
+
+    ///
+    /// \brief bind Binds the framebuffer object and sets the viewport to its size.
+    ///
+    void bind() const;
+
+    const RenderTargetDesc& getDesc() const;
+    unsigned int getFramebuffer() const;
+    unsigned int getColorTexture() const;
+    unsigned int getDepthTexture() const;
+    unsigned int getVelocityTexture() const;
+
+private:
+    RenderTargetDesc desc;
+
+    unsigned int framebuffer = 0;
+    unsigned int colorTexture = 0;
+    unsigned int depthTexture = 0;
+    unsigned int velocityTexture = 0;
+};
+
+///
+/// \brief The RenderTargetPool class recycles the transient render targets of the
+/// passes of a frame.
+///
+/// Passes acquire the targets they render into and release them once no later pass
+/// reads them, so that a pass may reuse the framebuffer object and textures of an
+/// earlier pass with the same description instead of allocating its own. Targets
+/// that have not been acquired for a few frames, e.g. after the window was resized,
+/// are deleted.
+///
+/// Must only be used on the thread that owns the GL context.
+///
+class RenderTargetPool {
+public:
+    /// Number of frames an unused target is kept for.
+    static constexpr unsigned int MAX_UNUSED_FRAMES = 3;
+
+    RenderTargetPool() = default;
+
+    RenderTargetPool(const RenderTargetPool &) = delete;
+    RenderTargetPool(RenderTargetPool &&) = delete;
+    RenderTargetPool& operator=(const RenderTargetPool &) = delete;
+    RenderTargetPool& operator=(RenderTargetPool &&) = delete;
+
+    ///
+    /// \brief acquire Returns a released target with the given description or creates one.
+    ///
+    /// The contents of a recycled target are undefined.
+    ///
+    /// \exception ge::Error The driver cannot render into the described attachments.
+    ///
+    RenderTarget& acquire(const RenderTargetDesc &desc);
+
+    ///
+    /// \brief release Makes a target acquired from this pool available to later passes.
+    ///
+    void release(const RenderTarget &target);
+
+    ///
+    /// \brief endFrame Deletes the released targets that were not acquired during the
+    ///                 last MAX_UNUSED_FRAMES frames.
+    ///
+    /// Should be called once at the end of every frame.
+    ///
+    void endFrame();
+
+    size_t getNumTargets() const;
+
+private:
+    struct Entry {
+        std::unique_ptr<RenderTarget> target;
+        bool acquired;
+        unsigned int lastAcquiredFrame;
+    };
+
+    std::vector<Entry> entries;
+    unsigned int frame = 0;
+};
+
+inline bool RenderTargetDesc::operator==(const RenderTargetDesc &other) const {
+    return this->width == other.width && this->height == other.height &&
+            this->colorFormat == other.colorFormat && this->depthFormat == other.depthFormat &&
+            this->velocityFormat == other.velocityFormat;
+}
+
+inline const RenderTargetDesc& RenderTarget::getDesc() const {return this->desc;}
+inline unsigned int RenderTarget::getFramebuffer() const {return this->framebuffer;}
+inline unsigned int RenderTarget::getColorTexture() const {return this->colorTexture;}
+inline unsigned int RenderTarget::getDepthTexture() const {return this->depthTexture;}
+inline unsigned int RenderTarget::getVelocityTexture() const {return this->velocityTexture;}
+
+inline size_t RenderTargetPool::getNumTargets() const {return this->entries.size();}
+
+} // namespace ge
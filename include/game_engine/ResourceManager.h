@@ -0,0 +1,289 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "Exception.h"
+
+namespace ge {
+
+///
+/// \brief The ResourceManager class caches the resources loaded from files, such as
+/// models and textures, and shares them between their users.
+///
+/// Resources are identified by their type and a key, which is the canonical path of
+/// their file or, with ResourceManager::contentHashingEnabled, a hash of its
+/// contents. Handles are shared_ptrs, so a resource stays resident while any handle
+/// to it exists. Unreferenced resources are kept until the memory used by their type
+/// exceeds its budget, least recently used first.
+///
+/// All functions are thread-safe. Threads requesting a resource that another thread
+/// is loading wait for that load instead of loading it again. Resources owning GL
+/// objects must be loaded and released on the thread that owns the GL context.
+///
+class ResourceManager : public std::enable_shared_from_this<ResourceManager> {
+public:
+    /// \name Global settings
+    /// These settings should be adjusted prior to loading resources.
+    ///@{
+    ///
+    /// \brief contentHashingEnabled Keys resources by a hash of their file's contents,
+    ///                              so that copies of a file under different paths are
+    ///                              loaded once.
+    ///
+    /// Files are hashed again only when their size or modification time changes.
+    ///
+    static bool contentHashingEnabled;
+    ///@}
+
+    ///
+    /// \brief The ResourceType enum lists the types of resources, which have their own
+    /// memory budgets.
+    ///
+    /// Resources may only hold handles to resources of later types.
+    ///
+    enum ResourceType {
+        /// Meshes and node hierarchy of a model file loaded by GameObject.
+        MODEL,
+        /// Meshes of a model file loaded by InstancingGameObjects.
+        INSTANCING_MODEL,
+        /// Texture2D loaded from an image file.
+        TEXTURE,
+        /// Model file read into memory before its meshes are created, see importModelFile().
+        IMPORTED_MODEL,
+        /// Image decoded into memory before its texture is created, see Texture2D::decode().
+        DECODED_IMAGE,
+        NUM_RESOURCE_TYPES
+    };
+
+    ///
+    /// \brief The Loaded struct is the result of a resource loader.
+    ///
+    template<typename T>
+    struct Loaded {
+        std::shared_ptr<T> resource;
+
+        /// Estimated memory used by the resource, in GPU memory for GPU resources.
+        size_t size_bytes = 0;
+
+        /// Files the resource was loaded from, see ResourceManager::findLoadedFrom().
+        std::vector<std::string> filepaths;
+    };
+
+    ///
+    /// \brief getInstance Returns the resource manager shared by the engine.
+    ///
+    /// The manager lives as long as references to it, e.g. the one held by Game.
+    /// Unreferenced resources are released with it.
+    ///
+    static std::shared_ptr<ResourceManager> getInstance();
+
+    ResourceManager(const ResourceManager &) = delete;
+    ResourceManager(ResourceManager &&) = delete;
+    ResourceManager& operator=(const ResourceManager &) = delete;
+    ResourceManager& operator=(ResourceManager &&) = delete;
+
+    ///
+    /// \brief getKey Returns the key of the resource loaded from a file.
+    /// \param filepath Filepath to the file.
+    ///
+    static std::string getKey(const std::string &filepath);
+
+    ///
+    /// \brief getCanonicalPath Returns the absolute path of a file without "." and ".."
+    ///                         components or symbolic links.
+    ///
+    static std::string getCanonicalPath(const std::string &filepath);
+
+    ///
+    /// \brief load Returns a resource, loading it if it is not resident.
+    /// \param type Type of the resource.
+    /// \param key Key of the resource, see ResourceManager::getKey().
+    /// \param loader Callable returning a ResourceManager::Loaded<T>. Its exceptions are
+    ///               rethrown to every thread waiting for the resource.
+    /// \exception ge::Error The resource was loaded with another C++ type.
+    ///
+    template<typename T, typename Loader>
+    std::shared_ptr<T> load(ResourceType type, const std::string &key, Loader &&loader);
+
+    ///
+    /// \brief find Returns a resident resource without loading it, or nullptr.
+    /// \exception ge::Error The resource was loaded with another C++ type.
+    ///
+    template<typename T>
+    std::shared_ptr<T> find(ResourceType type, const std::string &key);
+
+    bool isResident(ResourceType type, const std::string &key) const;
+
+    ///
+    /// \brief findLoadedFrom Returns the resident resources of a type loaded from a file,
+    ///                       e.g. to update them after the file changed.
+    /// \param type Type of the resources.
+    /// \param filepath Filepath to the file.
+    /// \exception ge::Error The resources were loaded with another C++ type.
+    ///
+    template<typename T>
+    std::vector<std::shared_ptr<T>> findLoadedFrom(ResourceType type, const std::string &filepath);
+
+    bool isLoadedFrom(ResourceType type, const std::string &filepath) const;
+
+    ///
+    /// \brief getFilepaths Returns the canonical paths of the files the resident
+    ///                     resources were loaded from.
+    ///
+    std::vector<std::string> getFilepaths() const;
+
+    ///
+    /// \brief setBudget Sets the memory that resources of a type may use before
+    ///                  unreferenced ones are released.
+    ///
+    /// By default, unreferenced resources are released right away, except for
+    /// imported models, which are kept so that model files loaded both by GameObject
+    /// and InstancingGameObjects are read once.
+    ///
+    void setBudget(ResourceType type, size_t budget_bytes);
+    size_t getBudget(ResourceType type) const;
+
+    ///
+    /// \brief getMemoryUsage Returns the estimated memory used by the resident
+    ///                       resources of a type.
+    ///
+    size_t getMemoryUsage(ResourceType type) const;
+    size_t getNumResources(ResourceType type) const;
+
+    ///
+    /// \brief releaseUnreferenced Releases the unreferenced resources of a type.
+    ///
+    void releaseUnreferenced(ResourceType type);
+
+    ///
+    /// \brief releaseUnreferenced Releases the unreferenced resources of all types,
+    ///                            e.g. once a level is loaded.
+    ///
+    void releaseUnreferenced();
+
+    ///
+    /// \brief releaseUnreferenced Releases the unreferenced resources loaded from a file,
+    ///                            e.g. after it changed, so that they are loaded from it
+    ///                            again when requested.
+    ///
+    void releaseUnreferenced(const std::string &filepath);
+
+private:
+    using Key = std::pair<ResourceType, std::string>;
+    using Future = std::shared_future<std::shared_ptr<void>>;
+    using TypeErasedLoader = std::function<Loaded<void>()>;
+
+    struct Entry {
+        std::type_index cppType = typeid(void);
+
+        /// Resource without the handles' bookkeeping, owned by the handles while they
+        /// exist and by ResourceManager::Entry::retained while it is unreferenced.
+        std::weak_ptr<void> resource;
+        std::shared_ptr<void> retained;
+
+        /// Handles shared by all users while the resource is referenced.
+        std::weak_ptr<void> handle;
+
+        /// Load in flight, if any.
+        Future loading;
+
+        size_t size_bytes = 0;
+        std::vector<std::string> filepaths;
+        std::uint64_t generation = 0;
+
+        /// Position in ResourceManager::unreferenced while unreferenced.
+        std::list<Key>::iterator unreferencedPosition;
+        bool isUnreferenced = false;
+    };
+
+    struct Usage {
+        size_t budget_bytes = 0;
+        size_t memory_bytes = 0;
+        size_t numResources = 0;
+    };
+
+    using Retained = std::list<std::shared_ptr<void>>;
+
+    ResourceManager();
+
+    std::shared_ptr<void> load(ResourceType type, const std::string &key, const std::type_index &cppType,
+                               const TypeErasedLoader &loader);
+    std::shared_ptr<void> find(ResourceType type, const std::string &key, const std::type_index &cppType);
+    std::vector<std::shared_ptr<void>> findLoadedFrom(ResourceType type, const std::string &filepath,
+                                                      const std::type_index &cppType);
+
+    ///
+    /// \brief makeHandle Returns a handle to a resident resource, creating one if it is
+    ///                   unreferenced. Must be called with the mutex locked.
+    ///
+    std::shared_ptr<void> makeHandle(const Key &key, Entry &entry);
+
+    ///
+    /// \brief onUnreferenced Keeps a resource whose last handle was destroyed, or
+    ///                       releases it if its type is over budget.
+    ///
+    void onUnreferenced(const Key &key, std::uint64_t generation, std::shared_ptr<void> resource);
+
+    ///
+    /// \brief evict Removes unreferenced resources of a type, least recently used first,
+    ///              until it is within budget. Must be called with the mutex locked.
+    /// \param retained Receives the resources to release once the mutex is unlocked.
+    ///
+    void evict(ResourceType type, size_t budget_bytes, Retained *retained);
+
+    ///
+    /// \brief release Removes an unreferenced resource. Must be called with the mutex locked.
+    /// \param retained Receives the resource to release once the mutex is unlocked.
+    ///
+    void release(std::map<Key, Entry>::iterator entry, Retained *retained);
+
+    static void checkType(const Entry &entry, const std::type_index &cppType, const std::string &key);
+
+    mutable std::mutex mutex;
+    std::map<Key, Entry> entries;
+
+    /// Unreferenced resources, least recently used first.
+    std::list<Key> unreferenced;
+
+    std::array<Usage, NUM_RESOURCE_TYPES> usages;
+    std::uint64_t nextGeneration = 1;
+};
+
+template<typename T, typename Loader>
+std::shared_ptr<T> ResourceManager::load(ResourceType type, const std::string &key, Loader &&loader) {
+    auto resource = this->load(type, key, typeid(T), [&loader]{
+        Loaded<T> loaded = loader();
+        return Loaded<void> {std::const_pointer_cast<void>(std::static_pointer_cast<const void>(loaded.resource)),
+                             loaded.size_bytes, std::move(loaded.filepaths)};
+    });
+    return std::static_pointer_cast<T>(resource);
+}
+
+template<typename T>
+std::shared_ptr<T> ResourceManager::find(ResourceType type, const std::string &key) {
+    return std::static_pointer_cast<T>(this->find(type, key, typeid(T)));
+}
+
+template<typename T>
+std::vector<std::shared_ptr<T>> ResourceManager::findLoadedFrom(ResourceType type, const std::string &filepath) {
+    std::vector<std::shared_ptr<T>> resources;
+    for (auto &resource : this->findLoadedFrom(type, filepath, typeid(T))) {
+        resources.push_back(std::static_pointer_cast<T>(std::move(resource)));
+    }
+    return resources;
+}
+
+} // namespace ge
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+
+namespace ge {
+
+///
+/// \brief The SceneGraph class holds a hierarchy of nodes with local and world transforms.
+///
+/// The world transform of a node is the world transform of its parent multiplied by the
+/// node's local transform. Nodes are stored breadth-first in flat arrays, so parents always
+/// come before their children and SceneGraph::update() refreshes all world transforms in a
+/// single linear pass. Only nodes that were changed, and their descendants, are recomputed.
+///
+/// Nodes are referred to by handles that stay valid until the node is destroyed, even though
+/// nodes move around in the arrays when the hierarchy changes.
+///
+class SceneGraph {
+public:
+    using Node = unsigned int;
+
+    /// Handle of no node, e.g. the parent of a root node.
+    static constexpr Node INVALID_NODE = ~0u;
+
+    ///
+    /// \brief createNode Creates a node.
+    /// \param parent Parent of the node. INVALID_NODE to create a root node.
+    /// \param localTransform Transform of the node relative to its parent.
+    /// \return Handle of the new node.
+    /// \exception ge::Error Invalid parent node.
+    ///
+    Node createNode(Node parent = INVALID_NODE, const glm::mat4 &localTransform = glm::mat4(1.0f));
+
+    ///
+    /// \brief destroyNode Destroys a node together with all of its descendants.
+    /// \param node Node to destroy.
+    /// \exception ge::Error Invalid node.
+    ///
+    void destroyNode(Node node);
+
+    ///
+    /// \brief setParent Attaches a node (and its descendants) to a new parent.
+    ///
+    /// The local transform of the node is kept, so it is now relative to the new parent.
+    ///
+    /// \param node Node to attach.
+    /// \param parent New parent. INVALID_NODE to make the node a root node.
+    /// \exception ge::Error Invalid node or parent.
+    /// \exception ge::Error The parent is the node itself or one of its descendants.
+    ///
+    void setParent(Node node, Node parent);
+
+    Node getParent(Node node) const;
+
+    ///
+    /// \brief setLocalTransform Sets the transform of a node relative to its parent.
+    ///
+    /// The node is only marked as changed if the transform differs from the current one.
+    ///
+    /// \param node Node to transform.
+    /// \param localTransform Transform relative to the parent.
+    /// \exception ge::Error Invalid node.
+    ///
+    void setLocalTransform(Node node, const glm::mat4 &localTransform);
+
+    const glm::mat4& getLocalTransform(Node node) const;
+
+    ///
+    /// \brief getWorldTransform Returns the world transform of a node as of the last
+    ///                          SceneGraph::update().
+    ///
+    const glm::mat4& getWorldTransform(Node node) const;
+
+    ///
+    /// \brief getPreviousWorldTransform Returns the world transform of a node as of the
+    ///                                  SceneGraph::update() before the last one, e.g. to
+    ///                                  compute its motion over the last frame.
+    ///
+    /// Nodes created by the last update return their current world transform.
+    ///
+    const glm::mat4& getPreviousWorldTransform(Node node) const;
+
+    ///
+    /// \brief getWorldNormalMatrix Returns the normal matrix of the world transform of a
+    ///                             node as of the last SceneGraph::update().
+    ///
+    const glm::mat3& getWorldNormalMatrix(Node node) const;
+
+    bool isValid(Node node) const;
+
+    ///
+    /// \brief update Recomputes the world transforms of all changed nodes and their descendants.
+    ///
+    void update();
+
+    size_t getNumNodes() const;
+
+private:
+    static constexpr size_t NO_INDEX = ~size_t(0);
+
+    size_t getIndex(Node node) const;
+
+    ///
+    /// \brief sortBreadthFirst Restores the breadth-first order of the node arrays.
+    ///
+    void sortBreadthFirst();
+
+    // Indexed by node handle
+    std::vector<size_t> nodeIndices;
+    std::vector<Node> freeNodes;
+
+    // Indexed by position in breadth-first order
+    std::vector<Node> nodes;
+    std::vector<size_t> parentIndices;
+    std::vector<glm::mat4> localTransforms;
+    std::vector<glm::mat4> worldTransforms;
+    std::vector<glm::mat4> previousWorldTransforms;
+    std::vector<glm::mat3> worldNormalMatrices;
+    std::vector<unsigned char> dirtyFlags;
+
+    /// Whether the world transform changed in the last update, so that the previous
+    /// world transforms of the other nodes are already up to date.
+    std::vector<unsigned char> movedFlags;
+
+    /// Whether the node was created since the last update and has no previous world
+    /// transform yet.
+    std::vector<unsigned char> newFlags;
+
+    bool isSorted = true;
+};
+
+inline size_t SceneGraph::getNumNodes() const {return this->nodes.size();}
+
+} // namespace ge
@@ -1,5 +1,7 @@
 #pragma once
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <glm/fwd.hpp>
 
@@ -8,21 +10,51 @@ namespace ge {
 ///
 /// \brief Manages loading, compiling, linking and working with shader programs.
 ///
+/// Linked programs are cached as driver-specific binaries in
+/// ShaderProgram::binaryCacheDirectory when the context supports program binaries
+/// (OpenGL 4.1 or ARB_get_program_binary), so later launches skip compilation.
+///
+/// Building a program from source does not wait for the driver. Programs that are
+/// still building are finished by ShaderProgram::prewarm() or on their first use, which
+/// lets drivers supporting KHR_parallel_shader_compile build them concurrently.
+///
+/// Programs whose sources changed are rebuilt by ShaderProgram::reload() while the
+/// previous build keeps being used (see HotReloader).
+///
 class ShaderProgram
 {
 public:
+    /// \name Global settings
+    /// These settings should be adjusted prior to creating any shader program.
+    ///@{
+    static std::string binaryCacheDirectory; ///< Empty to disable the program binary cache.
+    ///@}
+
+    ///
+    /// \brief Loads the cached binary of the given shaders or starts compiling and linking
+    ///        them into an OpenGL shader program.
+    ///
+    /// Falls back to the sources if the cached binary is missing or rejected by the driver,
+    /// e.g. after a driver update.
+    ///
+    /// \param[in] vertexShaderPath Filepath of the vertex shader.
+    /// \param[in] fragmentShaderPath Filepath of the fragment shader.
+    /// Shader sources may include other files relative to their directory with
+    /// \c #include "filename" directives.
     ///
-    /// \brief Loads, compiles, and links given shaders into an OpenGL shader program.
     /// \param[in] vertexShaderPath Filepath of the vertex shader.
     /// \param[in] fragmentShaderPath Filepath of the fragment shader.
     /// \param[in] geometryShaderPath Filepath of the geometry shader.
     ///                               Empty string if no geometry shader is used.
+    /// \param[in] defines Preprocessor macros defined after the \c #version directive of
+    ///                    every shader, e.g. "INSTANCING" or "NUM_LIGHTS 4".
     /// \exception std::ios_base::failure Failed to open either file.
-    /// \exception ge::BuildError Failed to compile or link shaders.
+    /// \exception ge::LoadError Failed to open an included file.
     ///
     ShaderProgram(const std::string &vertexShaderPath,
                   const std::string &fragmentShaderPath,
-                  const std::string &geometryShaderPath = "");
+                  const std::string &geometryShaderPath = "",
+                  const std::vector<std::string> &defines = {});
 
     ///
     /// \brief Deletes the OpenGL shader program from the GPU.
@@ -34,11 +66,49 @@ public:
     ShaderProgram& operator=(const ShaderProgram &) = delete;
     ShaderProgram& operator=(ShaderProgram &&) = delete;
 
+    ///
+    /// \brief prewarm Finishes building all shader programs that are still being built.
+    ///
+    /// Programs are finished in the order the driver completes them. Call this after
+    /// creating all shader programs needed by a scene to avoid hitches on first use.
+    ///
+    /// \exception ge::BuildError Failed to compile or link a program's shaders. Programs
+    ///                           that have not been finished yet keep building.
+    ///
+    static void prewarm();
+
+    ///
+    /// \brief getFilepaths Returns the canonical paths of the sources of all shader
+    ///                     programs and of the files they include.
+    ///
+    static std::vector<std::string> getFilepaths();
+
+    ///
+    /// \brief reload Starts rebuilding the programs built from or including the given files.
+    ///
+    /// Programs keep using their previous build until ShaderProgram::finishReloads()
+    /// replaces it. Uniform block bindings are carried over; other uniforms set once
+    /// must be set again.
+    ///
+    /// \param changedFilepaths Canonical paths of the changed files.
+    ///
+    static void reload(const std::vector<std::string> &changedFilepaths);
+
+    ///
+    /// \brief finishReloads Replaces the programs whose rebuild finished.
+    ///
+    /// Does not wait for drivers building programs in the background. Programs that
+    /// fail to build keep their previous build and their errors are logged.
+    ///
+    static void finishReloads();
+
     ///
     /// \brief Sets this program as the current active shader program.
     ///
     /// This is a helper function that calls glUseProgram() on this shader program.
     ///
+    /// \exception ge::BuildError Failed to compile or link shaders.
+    ///
     ShaderProgram& use();
 
     /// \name Uniforms
@@ -53,12 +123,16 @@ public:
     ShaderProgram& setUniform(const std::string &name, float x, float y, float z, float w);
     ShaderProgram& setUniform(const std::string &name, const glm::vec2 &v);
     ShaderProgram& setUniform(const std::string &name, const glm::vec3 &v);
+    ShaderProgram& setUniform(const std::string &name, const glm::vec4 &v);
     ShaderProgram& setUniform(const std::string &name, const glm::mat3 &m);
     ShaderProgram& setUniform(const std::string &name, const glm::mat4 &m);
     ///@}
 
     ///
     /// \brief setUniformBlockBinding Links the uniform block of this shader to the binding point.
+    ///
+    /// The binding is applied once the program is built if it is still building.
+    ///
     /// \param uniformBlockName Name of this shader's uniform block to link.
     /// \param bindingPoint Binding point to link against.
     /// \return This shader program for convenient function chaining.
@@ -66,8 +140,54 @@ public:
     ShaderProgram& setUniformBlockBinding(const std::string &uniformBlockName,
                                           unsigned int bindingPoint);
 
+    ///
+    /// \brief isBuilt Returns whether the program has finished building and can be used.
+    ///
+    bool isBuilt() const;
+
 private:
+    ///
+    /// \brief finishBuild Waits for the program to link, checks for build errors and
+    ///                    stores the program binary in the cache.
+    /// \exception ge::BuildError Failed to compile or link shaders.
+    ///
+    void finishBuild();
+
+    ///
+    /// \brief startReload Starts building the program again from its sources.
+    /// \exception std::ios_base::failure Failed to open a source.
+    /// \exception ge::LoadError Failed to open an included file.
+    ///
+    void startReload();
+
+    ///
+    /// \brief finishReload Replaces the program by its rebuild if it finished.
+    /// \return Whether the rebuild finished, successfully or not.
+    ///
+    bool finishReload();
+
     unsigned int id;
+    bool built = false;
+
+    /// Shaders attached to the program and their filepaths until it is built.
+    std::vector<std::pair<unsigned int, std::string>> shaders;
+    std::vector<std::pair<std::string, unsigned int>> pendingUniformBlockBindings;
+    std::string binaryCachePath;
+
+    /// Sources by shader type and macros, kept to rebuild the program.
+    std::vector<std::pair<unsigned int, std::string>> shaderPaths;
+    std::vector<std::string> defines;
+    std::vector<std::pair<std::string, unsigned int>> uniformBlockBindings;
+
+    /// Canonical paths of the sources and included files, found when first needed.
+    std::vector<std::string> dependencies;
+
+    /// Rebuild of the program and its shaders while it is building, 0 otherwise.
+    unsigned int reloadId = 0;
+    std::vector<std::pair<unsigned int, std::string>> reloadShaders;
+    std::string reloadBinaryCachePath;
 };
 
+inline bool ShaderProgram::isBuilt() const {return this->built;}
+
 } // namespace ge
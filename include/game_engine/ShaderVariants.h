@@ -0,0 +1,82 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ShaderProgram.h"
+
+namespace ge {
+
+///
+/// \brief The ShaderVariants class lazily builds and caches permutations of a shader
+/// program that differ by the feature macros they define.
+///
+/// Each feature is a bit in a ShaderVariants::Features mask. The variant of a mask is
+/// built from the same shader files with the macros of all features in the mask
+/// defined, so shaders can skip unused features with \c #ifdef blocks and draws
+/// only pay for the features they request.
+///
+class ShaderVariants {
+public:
+    using Features = unsigned int;
+
+    ///
+    /// \brief ShaderVariants Sets up the variants of a shader program. No variant is
+    ///                       built until it is requested.
+    /// \param vertexShaderPath Filepath of the vertex shader.
+    /// \param fragmentShaderPath Filepath of the fragment shader.
+    /// \param geometryShaderPath Filepath of the geometry shader.
+    ///                           Empty string if no geometry shader is used.
+    /// \param featureDefines Macro defined for each feature, indexed by the feature's bit.
+    ///
+    ShaderVariants(std::string vertexShaderPath,
+                   std::string fragmentShaderPath,
+                   std::string geometryShaderPath,
+                   std::vector<std::string> featureDefines);
+
+    ShaderVariants(const ShaderVariants &) = delete;
+    ShaderVariants(ShaderVariants &&) = delete;
+    ShaderVariants& operator=(const ShaderVariants &) = delete;
+    ShaderVariants& operator=(ShaderVariants &&) = delete;
+
+    ///
+    /// \brief getVariant Returns the variant with the given features, starting to
+    ///                   build it if it has not been requested before.
+    ///
+    /// The variant may still be building, see ShaderProgram::prewarm().
+    ///
+    /// \param features Mask of the features to enable.
+    /// \return The variant.
+    /// \exception std::ios_base::failure Failed to open a shader file.
+    /// \exception ge::LoadError Failed to open an included file.
+    ///
+    ShaderProgram& getVariant(Features features);
+
+    ///
+    /// \brief setUniformBlockBinding Links a uniform block of all variants, including the
+    ///                               ones built later, to the binding point.
+    /// \param uniformBlockName Name of the uniform block to link.
+    /// \param bindingPoint Binding point to link against.
+    /// \return This object for convenient function chaining.
+    ///
+    ShaderVariants& setUniformBlockBinding(const std::string &uniformBlockName,
+                                           unsigned int bindingPoint);
+
+    size_t getNumVariants() const;
+
+private:
+    std::string vertexShaderPath;
+    std::string fragmentShaderPath;
+    std::string geometryShaderPath;
+    std::vector<std::string> featureDefines;
+
+    std::vector<std::pair<std::string, unsigned int>> uniformBlockBindings;
+    std::unordered_map<Features, std::unique_ptr<ShaderProgram>> variants;
+};
+
+inline size_t ShaderVariants::getNumVariants() const {return this->variants.size();}
+
+} // namespace ge
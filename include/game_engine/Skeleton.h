@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <assimp/mesh.h>
+#include <assimp/scene.h>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+namespace ge {
+
+///
+/// \brief The JointTransform struct is the transform of a joint relative to its parent,
+/// split into components so that it can be interpolated.
+///
+struct JointTransform {
+    glm::vec3 translation {0.0f};
+    glm::quat rotation {1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 scale {1.0f};
+
+    ///
+    /// \brief fromMatrix Decomposes a transform without shear.
+    ///
+    static JointTransform fromMatrix(const glm::mat4 &matrix);
+
+    ///
+    /// \brief interpolateRotation Normalized linear interpolation along the shortest arc.
+    /// \param a Rotation at t = 0.
+    /// \param b Rotation at t = 1.
+    /// \param t Interpolation parameter in [0, 1].
+    ///
+    static glm::quat interpolateRotation(const glm::quat &a, const glm::quat &b, float t);
+
+    glm::mat4 toMatrix() const;
+};
+
+/// Local transforms of all joints of a skeleton, indexed like the joints.
+using Pose = std::vector<JointTransform>;
+
+///
+/// \brief blendPoses Interpolates between two poses of the same skeleton.
+/// \param a Pose at weight 0.
+/// \param b Pose at weight 1.
+/// \param weight Weight of pose b in [0, 1].
+/// \param result Blended pose. May be a or b.
+///
+void blendPoses(const Pose &a, const Pose &b, float weight, Pose *result);
+
+///
+/// \brief The BoneInfluences struct packs the (up to) four bones deforming a vertex
+/// into 8 bytes of the vertex format.
+///
+/// Weights are normalized fixed point values summing to 255.
+///
+struct BoneInfluences {
+    std::array<std::uint8_t, 4> bones {{0, 0, 0, 0}};
+    std::array<std::uint8_t, 4> weights {{0, 0, 0, 0}};
+};
+
+///
+/// \brief The Skeleton class holds the joint hierarchy of a model and the bones that
+/// deform its skinned meshes.
+///
+/// Joints are the nodes of the model file in breadth-first order, so joint i corresponds
+/// to GameObject::ModelNodes[i]. Bones are the joints that deform meshes, together with
+/// the inverse of their model space transform in the bind pose.
+///
+class Skeleton {
+public:
+    /// Maximum number of bones, limited by the size of the "Bones" uniform block.
+    static constexpr size_t MAX_BONES = 128;
+
+    static constexpr size_t NO_JOINT = ~size_t(0);
+
+    ///
+    /// \brief hasBones Returns true if any mesh of the scene is skinned.
+    ///
+    static bool hasBones(const aiScene &scene);
+
+    ///
+    /// \brief Skeleton Creates the joints from the node hierarchy of a scene and a bone
+    ///                 for every node that deforms a mesh.
+    /// \param scene Scene to create the skeleton of.
+    /// \exception ge::LoadError A bone has no matching node.
+    /// \exception ge::LoadError The scene has more than MAX_BONES bones.
+    ///
+    explicit Skeleton(const aiScene &scene);
+
+    ///
+    /// \brief computeBoneInfluences Packs the four most influential bones of every
+    ///                              vertex of a mesh.
+    ///
+    /// Vertices without bone weights are fully deformed by the first bone.
+    ///
+    /// \param mesh Mesh of the scene the skeleton was created from.
+    /// \return Bone influences of every vertex.
+    ///
+    std::vector<BoneInfluences> computeBoneInfluences(const aiMesh &mesh) const;
+
+    ///
+    /// \brief computeModelTransforms Concatenates the local transforms of a pose into
+    ///                               the model space transforms of the joints.
+    /// \param pose Pose of the skeleton.
+    /// \param modelTransforms Resized to the number of joints.
+    ///
+    void computeModelTransforms(const Pose &pose, std::vector<glm::mat4> *modelTransforms) const;
+
+    ///
+    /// \brief computeSkinMatrices Computes the matrices transforming the bind pose
+    ///                            vertices into the posed model space.
+    /// \param modelTransforms Model space transforms of the joints.
+    /// \param skinMatrices Array of getNumBones() matrices to write.
+    ///
+    void computeSkinMatrices(const std::vector<glm::mat4> &modelTransforms, glm::mat4 *skinMatrices) const;
+
+    ///
+    /// \brief findJoint Returns the index of the joint with the given name or NO_JOINT.
+    ///
+    size_t findJoint(const std::string &name) const;
+
+    size_t getNumJoints() const;
+    const std::string& getJointName(size_t joint) const;
+    size_t getJointParent(size_t joint) const;
+    const Pose& getBindPose() const;
+
+    size_t getNumBones() const;
+    size_t getBoneJoint(size_t bone) const;
+
+private:
+    std::vector<std::string> jointNames;
+    std::vector<size_t> jointParents;
+    std::unordered_map<std::string, size_t> jointIndices;
+    Pose bindPose;
+
+    std::vector<size_t> boneJoints;
+    std::vector<glm::mat4> inverseBindMatrices;
+    std::unordered_map<std::string, size_t> boneIndices;
+};
+
+inline size_t Skeleton::getNumJoints() const {return this->jointNames.size();}
+inline const std::string& Skeleton::getJointName(size_t joint) const {return this->jointNames[joint];}
+inline size_t Skeleton::getJointParent(size_t joint) const {return this->jointParents[joint];}
+inline const Pose& Skeleton::getBindPose() const {return this->bindPose;}
+inline size_t Skeleton::getNumBones() const {return this->boneJoints.size();}
+inline size_t Skeleton::getBoneJoint(size_t bone) const {return this->boneJoints[bone];}
+
+} // namespace ge
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include "JobSystem.h"
+#include "Skeleton.h"
+
+namespace ge {
+
+///
+/// \brief skinVertices Deforms vertices on the CPU with linear blend skinning.
+///
+/// Matches the GPU skinning of the default shader. The vertices are split over the
+/// job system and blended with SSE where available. Useful without a GL context (e.g.
+/// for tests) and for passes that only need the deformed positions, such as shadows.
+///
+/// \param positions Bind pose positions.
+/// \param normals Bind pose normals. nullptr to only deform the positions.
+/// \param boneInfluences Bones deforming each vertex.
+/// \param numVertices Number of vertices.
+/// \param skinMatrices Skin matrices indexed by the bones, see Skeleton::computeSkinMatrices().
+/// \param skinnedPositions Array of numVertices positions to write.
+/// \param skinnedNormals Array of numVertices normals to write. Ignored if normals is nullptr.
+/// \param jobSystem Job system to run the skinning on.
+///
+void skinVertices(const glm::vec3 *positions, const glm::vec3 *normals,
+                  const BoneInfluences *boneInfluences, size_t numVertices,
+                  const glm::mat4 *skinMatrices,
+                  glm::vec3 *skinnedPositions, glm::vec3 *skinnedNormals,
+                  JobSystem &jobSystem = JobSystem::getInstance());
+
+} // namespace ge
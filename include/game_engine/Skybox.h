@@ -3,6 +3,8 @@
 #include <string>
 #include <array>
 
+#include "CubemapImage.h"
+
 namespace ge {
 
 class ShaderProgram;
@@ -10,23 +12,88 @@ class ShaderProgram;
 ///
 /// \brief The Skybox class represents a skybox loaded from a cubemap.
 ///
+/// The faces are decoded in parallel on the job system, then prefiltered into mip
+/// levels, an irradiance map, spherical harmonics irradiance and a specular cubemap for
+/// image-based ambient lighting (see CubemapImage). The result is cached in a single
+/// container file, so that later runs only read and upload it.
+///
 class Skybox {
 public:
+    /// \name Global settings
+    /// These settings should be adjusted prior to loading any skybox.
+    ///@{
+    ///
+    /// \brief cacheDirectory Directory of the prefiltered cubemaps. Caching is disabled
+    ///                       if empty.
+    ///
+    /// Cached cubemaps are rebuilt when the size or modification time of a face changes.
+    ///
+    static std::string cacheDirectory;
+
+    ///
+    /// \brief compressionEnabled Compresses the skybox into BC1 (S3TC DXT1) when the
+    ///                           driver supports it, which takes 8 times less memory.
+    ///
+    static bool compressionEnabled;
+
+    static int irradianceMapSize; ///< Width and height of the faces of the irradiance map.
+    static int specularMapSize; ///< Width and height of the faces of the specular map.
+    static int numSpecularMapLevels; ///< Number of roughness levels of the specular map.
+    ///@}
+
     ///
     /// \brief Skybox Creates a cubemap for a skybox.
-    /// \param imageFilepaths 6 images for each side of the skybox in the order of:
-    ///                       right, left, top, bottom, front, back
+    /// \param imageFilepaths 6 square images of the same size for each side of the skybox
+    ///                       in the order of: right, left, top, bottom, front, back
     /// \exception ge::LoadError Failed to load texture data from image file.
     ///
     Skybox(const std::array<std::string, 6> &imageFilepaths);
     ~Skybox();
 
+    Skybox(const Skybox &) = delete;
+    Skybox(Skybox &&) = delete;
+    Skybox& operator=(const Skybox &) = delete;
+    Skybox& operator=(Skybox &&) = delete;
+
     void render(ShaderProgram *shader);
 
+    ///
+    /// \brief bindIrradianceMap Binds the irradiance cubemap to a texture unit.
+    ///
+    /// Sampled with a surface normal, it gives the diffuse ambient light the sky casts
+    /// onto the surface, see computeIrradiance().
+    ///
+    void bindIrradianceMap(unsigned int textureUnit) const;
+
+    ///
+    /// \brief bindSpecularMap Binds the prefiltered specular cubemap to a texture unit.
+    ///
+    /// Sampled with a reflected view direction at the level roughness * (levels - 1), it
+    /// gives the ambient light the sky reflects off the surface, see prefilterSpecular().
+    /// Like the spherical harmonics, it is sampled in linear color space.
+    ///
+    void bindSpecularMap(unsigned int textureUnit) const;
+
+    int getNumSpecularMapLevels() const;
+
+    ///
+    /// \brief getIrradianceSh Returns the irradiance of the sky in spherical harmonics,
+    ///                        see projectIrradianceSh9().
+    ///
+    const ShCoefficients& getIrradianceSh() const;
+
 private:
     unsigned int vao;
     unsigned int vbo;
-    unsigned int texture;
+    unsigned int texture = 0;
+    unsigned int irradianceMap = 0;
+    unsigned int specularMap = 0;
+    int numSpecularLevels = 0;
+    ShCoefficients irradianceSh {};
 };
 
+inline int Skybox::getNumSpecularMapLevels() const {return this->numSpecularLevels;}
+
+inline const ShCoefficients& Skybox::getIrradianceSh() const {return this->irradianceSh;}
+
 } // namespace ge
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include "CubemapImage.h"
+#include "JobSystem.h"
+
+namespace ge {
+
+///
+/// \brief The SoftwareImage struct holds an RGBA8 image in CPU memory, first row first.
+///
+struct SoftwareImage {
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> texels;
+};
+
+///
+/// \brief The SoftwareMesh struct holds a triangle mesh and its material in CPU memory,
+/// to be drawn by SoftwareRasterizer.
+///
+struct SoftwareMesh {
+    struct Vertex {
+        glm::vec3 position;
+        glm::vec3 normal;
+        glm::vec2 textureCoordinates;
+    };
+
+    std::vector<Vertex> vertices;
+    /// 3 indices per triangle.
+    std::vector<unsigned int> indices;
+
+    /// Textures of the material. Missing textures are white and black respectively, like
+    /// the default textures of MaterialRegistry.
+    std::shared_ptr<const SoftwareImage> diffuseTexture;
+    std::shared_ptr<const SoftwareImage> specularTexture;
+    float specularExponent = 64.0f;
+};
+
+///
+/// \brief loadSoftwareMeshes Reads the meshes of a model file and decodes their textures
+///                           without a GL context.
+///
+/// Meshes are transformed by their nodes into model space, so they are drawn the way
+/// GameObject draws the model in its bind pose.
+///
+/// \param modelFilepath Filepath to the model data.
+/// \exception ge::LoadError Failed to load mesh data from model file.
+/// \exception ge::LoadError Failed to load texture image from file.
+///
+std::vector<SoftwareMesh> loadSoftwareMeshes(const std::string &modelFilepath);
+
+///
+/// \brief The SoftwareRasterizer class renders meshes on the CPU, with the lighting of
+/// the default shader and without any GL context.
+///
+/// It allows rendering on machines without a GPU, e.g. thumbnails on a server, and
+/// rendering images that are identical on every machine, e.g. for regression tests and
+/// benchmarks. Triangles are drawn in the order they are queued, and every pixel is
+/// written by a single thread, so images do not depend on the number of threads.
+///
+/// Queued triangles are clipped against the near plane, binned into tiles of
+/// TILE_SIZE_PIXELS x TILE_SIZE_PIXELS pixels and rasterized tile by tile in parallel on
+/// the job system. Coverage is computed 4 pixels at a time with SSE if available.
+///
+/// Pixels are lit like default.frag: ambient light from spherical harmonics, one
+/// directional light and Blinn-Phong highlights where the material has a specular
+/// texture. Both sides of triangles are drawn and the depth test passes for closer
+/// pixels, like Game.
+///
+/// Images differ from the ones of Game, as features of its rendering are missing:
+///     1. ambient occlusion,
+///     2. reflections of the skybox, and the skybox itself,
+///     3. mipmaps, textures are sampled bilinearly from their base level so minified
+///        textures alias,
+///     4. temporal anti-aliasing and its jitter, bloom and dynamic resolution,
+///     5. skinning, vertex animation, instancing, imposters, terrains and particles.
+///
+/// Without them, images match the scene Game renders within the tolerances of
+/// tests/SoftwareRasterizerComparisonTest.cpp.
+///
+class SoftwareRasterizer {
+public:
+    /// Width and height of the tiles rasterized in parallel.
+    static constexpr int TILE_SIZE_PIXELS = 64;
+
+    ///
+    /// \brief SoftwareRasterizer Creates the color and depth buffers.
+    /// \param width Width of the image in pixels.
+    /// \param height Height of the image in pixels.
+    /// \param jobSystem Job system transforming the vertices and rasterizing the tiles.
+    ///
+    SoftwareRasterizer(int width, int height, JobSystem &jobSystem = JobSystem::getInstance());
+
+    SoftwareRasterizer& setCamera(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix,
+                                  const glm::vec3 &viewPosition);
+    SoftwareRasterizer& setDirectionalLight(const glm::vec3 &direction, const glm::vec3 &diffuse,
+                                            const glm::vec3 &specular);
+
+    ///
+    /// \brief setAmbientLight Sets the irradiance divided by pi, e.g. of a skybox, see
+    ///                        Skybox::getIrradianceSh().
+    ///
+    SoftwareRasterizer& setAmbientLight(const ShCoefficients &irradianceSh);
+
+    ///
+    /// \brief setAmbientLight Sets an ambient light coming from every direction, like
+    ///                        Game does without a skybox.
+    ///
+    SoftwareRasterizer& setAmbientLight(const glm::vec3 &ambient);
+
+    ///
+    /// \brief setTonemapping Sets how SoftwareRasterizer::readPixels() maps colors to
+    ///                       8 bits, like the "tonemap" pass of Game.
+    /// \param enabled Whether to apply the ACES filmic curve, or to clamp colors.
+    /// \param exposure Scale of the colors before the curve.
+    ///
+    SoftwareRasterizer& setTonemapping(bool enabled, float exposure = 1.0f);
+
+    ///
+    /// \brief clear Fills the color buffer, resets the depth buffer and drops queued
+    ///              triangles.
+    ///
+    void clear(const glm::vec3 &color = glm::vec3(0.0f));
+
+    ///
+    /// \brief draw Transforms the triangles of a mesh with the current camera and queues
+    ///             them for SoftwareRasterizer::flush().
+    /// \param mesh Mesh to draw, which must stay alive until the next flush.
+    /// \param modelMatrix Transformation of the mesh from model space to world space.
+    ///
+    void draw(const SoftwareMesh &mesh, const glm::mat4 &modelMatrix);
+
+    ///
+    /// \brief flush Rasterizes the queued triangles into the color and depth buffers.
+    ///
+    void flush();
+
+    ///
+    /// \brief readPixels Returns the color buffer in RGBA8, top row first.
+    ///
+    /// Triangles that were not flushed are not in the result.
+    ///
+    std::vector<unsigned char> readPixels() const;
+
+    ///
+    /// \brief getDepthBuffer Returns the depths of the pixels in [0, 1], like the depth
+    ///                       buffer of the default depth range, top row first.
+    ///
+    const std::vector<float>& getDepthBuffer() const;
+
+    int getWidth() const;
+    int getHeight() const;
+
+private:
+    ///
+    /// \brief The Triangle struct holds a triangle set up for rasterization.
+    ///
+    struct Triangle {
+        /// Vertices in pixels from the top left corner of the image, with a positive area.
+        glm::vec2 screenPositions[3];
+        float depths[3];
+        float inverseWs[3];
+
+        /// Attributes divided by w, which are interpolated linearly in screen space.
+        glm::vec3 worldPositions[3];
+        glm::vec3 normals[3];
+        glm::vec2 textureCoordinates[3];
+
+        /// Pixels covered by the bounding box, inclusive.
+        int minX, minY, maxX, maxY;
+
+        const SoftwareMesh *mesh;
+    };
+
+    ///
+    /// \brief The ClipVertex struct holds a vertex being clipped against the near plane.
+    ///
+    struct ClipVertex {
+        glm::vec4 clipPosition;
+        glm::vec3 worldPosition;
+        glm::vec3 normal;
+        glm::vec2 textureCoordinates;
+    };
+
+    void setUpTriangle(const ClipVertex &v0, const ClipVertex &v1, const ClipVertex &v2,
+                       const SoftwareMesh &mesh);
+    void rasterizeTile(size_t tile, const std::vector<std::uint32_t> &triangleIndices);
+    glm::vec3 shade(const Triangle &triangle, const glm::vec3 &barycentrics) const;
+
+    JobSystem &jobSystem;
+    int width;
+    int height;
+    int numTilesX;
+    int numTilesY;
+
+    glm::mat4 viewProjectionMatrix {1.0f};
+    glm::vec3 viewPosition {0.0f};
+    glm::vec3 lightDirection {0.0f, 0.0f, -1.0f};
+    glm::vec3 lightDiffuse {0.0f};
+    glm::vec3 lightSpecular {0.0f};
+    ShCoefficients irradianceSh {};
+    bool tonemappingEnabled = true;
+    float exposure = 1.0f;
+
+    std::vector<glm::vec3> colorBuffer;
+    std::vector<float> depthBuffer;
+    std::vector<Triangle> triangles;
+};
+
+inline const std::vector<float>& SoftwareRasterizer::getDepthBuffer() const {return this->depthBuffer;}
+inline int SoftwareRasterizer::getWidth() const {return this->width;}
+inline int SoftwareRasterizer::getHeight() const {return this->height;}
+
+} // namespace ge
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Archetype.h"
+#include "JobSystem.h"
+
+namespace ge {
+
+class EntityRegistry;
+
+///
+/// \brief The SystemAccess class declares which component types a system reads and writes.
+///
+/// The SystemScheduler uses these declarations to run systems that do not conflict
+/// with each other in parallel.
+///
+class SystemAccess {
+public:
+    template<typename... Ts>
+    SystemAccess& read();
+
+    template<typename... Ts>
+    SystemAccess& write();
+
+    ///
+    /// \brief exclusive Marks the system as requiring exclusive access to the registry
+    ///                  (e.g. it creates/destroys entities, adds/removes components or
+    ///                  issues OpenGL calls).
+    ///
+    /// Exclusive systems always run alone on the thread calling SystemScheduler::run().
+    ///
+    SystemAccess& exclusive();
+
+    bool isExclusive() const;
+
+    ///
+    /// \brief conflictsWith Returns true if the two systems may not run concurrently.
+    ///
+    bool conflictsWith(const SystemAccess &other) const;
+
+private:
+    ComponentMask reads;
+    ComponentMask writes;
+    bool exclusiveAccess = false;
+};
+
+///
+/// \brief The SystemScheduler class runs systems over an EntityRegistry.
+///
+/// Systems are grouped into stages. A system is placed in the stage after the last
+/// stage containing an earlier registered system that it conflicts with, so the
+/// registration order is preserved between conflicting systems while independent
+/// systems in the same stage run in parallel on the job system.
+///
+class SystemScheduler {
+public:
+    using SystemFunction = std::function<void(EntityRegistry&, std::chrono::duration<float>)>;
+
+    explicit SystemScheduler(JobSystem &jobSystem = JobSystem::getInstance());
+
+    ///
+    /// \brief addSystem Registers a system.
+    /// \param name Name of the system for debugging.
+    /// \param access Component types the system reads and writes.
+    /// \param system Function run on every call of SystemScheduler::run().
+    /// \return This scheduler for convenient chaining of function calls.
+    ///
+    SystemScheduler& addSystem(const std::string &name, const SystemAccess &access,
+                               SystemFunction system);
+
+    ///
+    /// \brief run Runs every system once.
+    ///
+    /// The first exception thrown by a system of a stage is rethrown after
+    /// every system of that stage has finished.
+    ///
+    /// \param registry Registry the systems operate on.
+    /// \param updateDuration Elapsed time since the last frame.
+    ///
+    void run(EntityRegistry &registry, std::chrono::duration<float> updateDuration);
+
+    size_t getNumSystems() const;
+    size_t getNumStages();
+
+private:
+    struct System {
+        std::string name;
+        SystemAccess access;
+        SystemFunction function;
+    };
+
+    void buildStages();
+
+    JobSystem &jobSystem;
+    std::vector<System> systems;
+    std::vector<std::vector<size_t>> stages;
+    bool stagesAreValid = true;
+};
+
+template<typename... Ts>
+SystemAccess& SystemAccess::read() {
+    this->reads |= makeComponentMask<Ts...>();
+    return *this;
+}
+
+template<typename... Ts>
+SystemAccess& SystemAccess::write() {
+    this->writes |= makeComponentMask<Ts...>();
+    return *this;
+}
+
+inline SystemAccess& SystemAccess::exclusive() {
+    this->exclusiveAccess = true;
+    return *this;
+}
+
+inline bool SystemAccess::isExclusive() const {return this->exclusiveAccess;}
+
+inline size_t SystemScheduler::getNumSystems() const {return this->systems.size();}
+
+} // namespace ge
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include "Heightmap.h"
+
+namespace ge {
+
+struct FramePacket;
+class Frustum;
+class Texture2D;
+
+///
+/// \brief The TerrainSettings struct describes how a heightmap is laid out in the world.
+///
+/// The terrain lies in the XY plane with heights along Z.
+///
+struct TerrainSettings {
+    /// World position of the first heightmap sample.
+    glm::vec2 origin {0.0f};
+
+    /// World extents covered by the heightmap.
+    glm::vec2 size_m {1024.0f};
+
+    /// Heights of the normalized heights 0 and 1.
+    float minHeight_m = 0.0f;
+    float maxHeight_m = 100.0f;
+
+    /// Number of quads along the edges of the grid drawn for every chunk. Must be even.
+    unsigned int chunkResolution = 32;
+
+    /// Distance up to which the finest level of detail is used. 0 selects twice the
+    /// diagonal of the finest chunks.
+    float finestLodDistance_m = 0.0f;
+
+    /// Ratio between the distances of consecutive levels of detail.
+    float lodDistanceRatio = 2.0f;
+
+    /// Fraction of the range of a level of detail after which it starts morphing into
+    /// the next coarser level.
+    float morphStartRatio = 0.66f;
+
+    /// Texture repeated over the terrain, or nullptr for an untextured terrain.
+    std::shared_ptr<const Texture2D> texture;
+    glm::vec2 numTextureRepeat {1.0f};
+};
+
+///
+/// \brief The TerrainChunk struct is the per-instance data of a chunk of terrain drawn
+/// with the shared grid mesh.
+///
+struct TerrainChunk {
+    /// Minimum corner and size of the chunk in heightmap coordinates ([0, 1]).
+    glm::vec2 origin;
+    float size;
+
+    /// Level of detail of the chunk, 0 being the finest.
+    float lod;
+};
+
+///
+/// \brief The Terrain class draws a heightmap as chunks with continuous distance-dependent
+/// level of detail (CDLOD).
+///
+/// The heightmap is split into a quadtree whose nodes store the height range they
+/// cover. On every frame, nodes are selected by their distance to the camera and culled
+/// against the view frustum. All selected chunks are drawn by displacing the same grid
+/// mesh in the vertex shader, and vertices morph into the next coarser level of detail
+/// before a chunk switches to it, so there are neither cracks nor popping.
+///
+/// Terrains hold no GPU resources other than their texture. The heightmap is uploaded
+/// by the renderer when the terrain is first drawn.
+///
+class Terrain : public std::enable_shared_from_this<Terrain> {
+public:
+    static constexpr size_t MAX_LODS = 16;
+
+    /// Parts of the selected chunks. A chunk is drawn whole or, when only some of its
+    /// children are in range of a finer level of detail, one quadrant at a time.
+    enum ChunkPart {
+        WHOLE_CHUNK,
+        QUADRANT_MIN_U_MIN_V,
+        QUADRANT_MAX_U_MIN_V,
+        QUADRANT_MIN_U_MAX_V,
+        QUADRANT_MAX_U_MAX_V,
+        NUM_CHUNK_PARTS
+    };
+
+    using Selection = std::array<std::vector<TerrainChunk>, NUM_CHUNK_PARTS>;
+
+    ///
+    /// \brief Terrain Builds the quadtree of a heightmap.
+    /// \param heightmap Heights of the terrain.
+    /// \param settings Layout of the terrain.
+    ///
+    explicit Terrain(std::shared_ptr<const Heightmap> heightmap, const TerrainSettings &settings = {});
+
+    ///
+    /// \brief selectChunks Selects the chunks to draw from a viewpoint.
+    /// \param viewPosition Position of the camera.
+    /// \param frustum View frustum of the camera.
+    /// \return Chunks to draw by part.
+    ///
+    Selection selectChunks(const glm::vec3 &viewPosition, const Frustum &frustum) const;
+
+    ///
+    /// \brief addToFramePacket Adds the chunks visible from the packet's camera.
+    ///
+    /// The packet's view position and matrices must already be set. The terrain must
+    /// be owned by a shared_ptr.
+    ///
+    /// \param framePacket Frame packet being built.
+    ///
+    void addToFramePacket(FramePacket &framePacket) const;
+
+    ///
+    /// \brief getHeight Returns the height of the terrain under a world position,
+    ///                  e.g. to place objects on the ground.
+    ///
+    float getHeight(const glm::vec2 &position) const;
+
+    ///
+    /// \brief getMorphRanges Returns the distances between which every level of detail
+    ///                       morphs into the next coarser one.
+    ///
+    const std::vector<glm::vec2>& getMorphRanges() const;
+
+    size_t getNumLods() const;
+    const TerrainSettings& getSettings() const;
+    const std::shared_ptr<const Heightmap>& getHeightmap() const;
+
+private:
+    bool selectNode(size_t lod, size_t x, size_t y, const glm::vec3 &viewPosition,
+                    const Frustum &frustum, Selection *selection) const;
+    void getNodeBounds(size_t lod, size_t x, size_t y, glm::vec3 *boxMin, glm::vec3 *boxMax) const;
+    size_t getNumNodesPerSide(size_t lod) const;
+
+    std::shared_ptr<const Heightmap> heightmap;
+    TerrainSettings settings;
+
+    /// Minimum and maximum normalized heights of the nodes of every level of detail,
+    /// indexed by y * getNumNodesPerSide(lod) + x.
+    std::vector<std::vector<glm::vec2>> nodeHeightRanges;
+
+    std::vector<float> lodDistances;
+    std::vector<glm::vec2> morphRanges;
+};
+
+inline const std::vector<glm::vec2>& Terrain::getMorphRanges() const {return this->morphRanges;}
+inline size_t Terrain::getNumLods() const {return this->nodeHeightRanges.size();}
+inline const TerrainSettings& Terrain::getSettings() const {return this->settings;}
+inline const std::shared_ptr<const Heightmap>& Terrain::getHeightmap() const {return this->heightmap;}
+inline size_t Terrain::getNumNodesPerSide(size_t lod) const {return size_t(1) << (this->getNumLods() - 1 - lod);}
+
+} // namespace ge
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "FramePacket.h"
+#include "ShaderProgram.h"
+
+namespace ge {
+
+///
+/// \brief The TerrainRenderer class draws terrain batches by displacing a shared grid
+/// mesh with the terrains' heightmaps.
+///
+/// Every chunk is an instance of a grid over [0, 1]² whose vertices are moved onto the
+/// chunk and displaced and morphed in the vertex shader, so a whole terrain takes at
+/// most one draw call per chunk part. Grids are built once per chunk resolution and
+/// heightmaps are uploaded as 16-bit textures the first time they are drawn. Textures
+/// of heightmaps that are no longer alive are deleted.
+///
+/// Must only be used on the thread that owns the GL context.
+///
+class TerrainRenderer {
+public:
+    ///
+    /// \brief TerrainRenderer Builds the terrain shader.
+    /// \param vertexShaderPath Filepath of the terrain vertex shader.
+    /// \param fragmentShaderPath Filepath of the terrain fragment shader.
+    /// \exception std::ios_base::failure Failed to open either file.
+    ///
+    TerrainRenderer(const std::string &vertexShaderPath, const std::string &fragmentShaderPath);
+    ~TerrainRenderer();
+
+    TerrainRenderer(const TerrainRenderer &) = delete;
+    TerrainRenderer(TerrainRenderer &&) = delete;
+    TerrainRenderer& operator=(const TerrainRenderer &) = delete;
+    TerrainRenderer& operator=(TerrainRenderer &&) = delete;
+
+    ///
+    /// \brief render Draws the terrain batches of a frame packet.
+    ///
+    /// The view and projection matrices are read from the "Matrices" uniform block.
+    ///
+    /// \param framePacket Frame packet being rendered.
+    ///
+    void render(const FramePacket &framePacket);
+
+    ShaderProgram& getShader();
+
+private:
+    ///
+    /// \brief The Grid struct holds the mesh shared by all chunks of a resolution.
+    ///
+    /// Indices are sorted by quadrant so that every quadrant may be drawn on its own.
+    ///
+    struct Grid {
+        unsigned int vao = 0;
+        unsigned int vertexBuffer = 0;
+        unsigned int indexBuffer = 0;
+        unsigned int numIndicesPerQuadrant = 0;
+    };
+
+    struct HeightmapTexture {
+        std::weak_ptr<const Heightmap> heightmap;
+        unsigned int texture = 0;
+    };
+
+    const Grid& getGrid(unsigned int resolution);
+    unsigned int getHeightmapTexture(const std::shared_ptr<const Heightmap> &heightmap);
+    void deleteExpiredHeightmapTextures();
+
+    std::unique_ptr<ShaderProgram> shader;
+
+    std::unordered_map<unsigned int, Grid> grids;
+    std::unordered_map<const Heightmap*, HeightmapTexture> heightmapTextures;
+
+    unsigned int instanceBuffer = 0;
+};
+
+inline ShaderProgram& TerrainRenderer::getShader() {return *this->shader;}
+
+} // namespace ge
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include "Terrain.h"
+
+namespace ge {
+
+struct FramePacket;
+
+///
+/// \brief The TerrainStreamer class keeps the terrain tiles around the camera loaded,
+/// so that maps far larger than memory can be explored.
+///
+/// The world is split into a grid of equally sized tiles, tile (0, 0) starting at the
+/// world origin. Tiles within the load distance of the camera are loaded on the job
+/// system and tiles beyond the unload distance are dropped. Adjacent tiles must share
+/// their edge samples and use the same chunk resolution and level of detail distances
+/// so that their seams match.
+///
+class TerrainStreamer {
+public:
+    ///
+    /// \brief TileLoader Loads the terrain of a tile on a worker thread.
+    ///
+    /// Returns nullptr for tiles without terrain, e.g. beyond the edges of the map.
+    ///
+    using TileLoader = std::function<std::shared_ptr<Terrain>(int x, int y)>;
+
+    ///
+    /// \brief TerrainStreamer Creates a streamer without loaded tiles.
+    /// \param tileLoader Loader of the tiles, called from worker threads.
+    /// \param tileSize_m World extents of every tile.
+    /// \param loadDistance_m Distance from the camera within which tiles are loaded.
+    /// \param unloadDistance_m Distance from the camera beyond which tiles are unloaded.
+    ///                         Larger than the load distance, so that tiles are not
+    ///                         reloaded when the camera moves back and forth over a border.
+    ///
+    TerrainStreamer(TileLoader tileLoader, const glm::vec2 &tileSize_m, float loadDistance_m,
+                    float unloadDistance_m);
+
+    ///
+    /// \brief Waits for the tiles being loaded.
+    ///
+    ~TerrainStreamer();
+
+    TerrainStreamer(const TerrainStreamer &) = delete;
+    TerrainStreamer(TerrainStreamer &&) = delete;
+    TerrainStreamer& operator=(const TerrainStreamer &) = delete;
+    TerrainStreamer& operator=(TerrainStreamer &&) = delete;
+
+    ///
+    /// \brief fileTileLoader Returns a tile loader reading heightmaps from files.
+    ///
+    /// Tiles whose heightmaps do not exist are empty.
+    ///
+    /// \param filepathPattern Filepath of the heightmaps, in which "{x}" and "{y}" are
+    ///                        replaced by the coordinates of the tile,
+    ///                        e.g. "terrain/tile_{x}_{y}.png".
+    /// \param settings Settings of every tile. The size must be the tile size and the
+    ///                 origin is replaced by the position of the tile.
+    ///
+    static TileLoader fileTileLoader(const std::string &filepathPattern, const TerrainSettings &settings);
+
+    ///
+    /// \brief update Starts loading the tiles in range of the camera, takes over the
+    ///               loaded tiles and drops the tiles out of range.
+    /// \param viewPosition Position of the camera.
+    ///
+    void update(const glm::vec3 &viewPosition);
+
+    ///
+    /// \brief addToFramePacket Adds the loaded tiles visible from the packet's camera.
+    /// \param framePacket Frame packet being built.
+    ///
+    void addToFramePacket(FramePacket &framePacket) const;
+
+    ///
+    /// \brief findTerrain Returns the loaded terrain under a world position, or nullptr.
+    ///
+    std::shared_ptr<const Terrain> findTerrain(const glm::vec2 &position) const;
+
+    /// Maximum number of tiles loading at the same time, closest tiles first.
+    void setMaxNumPendingLoads(size_t maxNumPendingLoads);
+
+    /// Number of loaded tiles, including empty ones.
+    size_t getNumLoadedTiles() const;
+    size_t getNumPendingLoads() const;
+
+private:
+    using TileCoordinates = std::pair<int, int>;
+
+    float getDistance(const TileCoordinates &tile, const glm::vec2 &position) const;
+
+    TileLoader tileLoader;
+    glm::vec2 tileSize_m;
+    float loadDistance_m;
+    float unloadDistance_m;
+    size_t maxNumPendingLoads = 2;
+
+    /// Loaded tiles, nullptr for empty tiles so that they are not loaded again.
+    std::map<TileCoordinates, std::shared_ptr<Terrain>> loadedTiles;
+    std::map<TileCoordinates, std::future<std::shared_ptr<Terrain>>> pendingTiles;
+};
+
+inline void TerrainStreamer::setMaxNumPendingLoads(size_t maxNumPendingLoads) {this->maxNumPendingLoads = maxNumPendingLoads;}
+inline size_t TerrainStreamer::getNumLoadedTiles() const {return this->loadedTiles.size();}
+inline size_t TerrainStreamer::getNumPendingLoads() const {return this->pendingTiles.size();}
+
+} // namespace ge
@@ -1,13 +1,23 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <string>
 
+#include <glm/vec4.hpp>
+
+#include "TextureArray.h"
+
 namespace ge {
 
 ///
 /// \brief 2D Texture data.
 ///
+/// Every texture is a layer of a texture array (see TextureArray). Textures small
+/// enough for TextureAtlas are packed into a shared atlas page. Shaders must then
+/// map texture coordinates through the UV transform of the texture.
+///
 class Texture2D
 {
 public:
@@ -15,21 +25,84 @@ public:
     /// \brief loadTexture Loads and caches texture data from image file.
     ///
     /// Texture2D object will automatically clean up cache and GPU data on
-    /// destruction. Do NOT call glDeleteTextures on this texture's id.
+    /// destruction. Do NOT call glDeleteTextures on this texture's array.
     ///
     /// \param imageFilepath Filepath to the image.
-    /// \return OpenGL's texture ID for the loaded texture.
     /// \exception ge::LoadError Failed to load image data from file.
     ///
     explicit Texture2D(const std::string &imageFilepath);
 
     ///
-    /// \brief bind Binds this texture to the GPU for rendering.
+    /// \brief Texture2D Creates an uncached texture from pixels.
+    /// \param rgbaData RGBA8 pixels of the texture, first row first.
+    /// \param width Texture width in pixels.
+    /// \param height Texture height in pixels.
     ///
-    void bind();
+    Texture2D(const unsigned char *rgbaData, int width, int height);
+
+    ///
+    /// \brief decode Decodes an image file on the calling thread.
+    ///
+    /// Loading the texture on the render thread afterwards then only uploads it, so
+    /// that images may be decoded on background threads. Textures that are already
+    /// loaded are not decoded again.
+    ///
+    /// \param imageFilepath Filepath to the image.
+    /// \param gpuSize_bytes Set to an estimate of the GPU memory the texture will take
+    ///                      when loaded, or 0 if it is already loaded. May be nullptr.
+    /// \return Handle keeping the decoded image alive until the texture is loaded, or
+    ///         nullptr if the texture is already loaded.
+    /// \exception ge::LoadError Failed to load image data from file.
+    ///
+    static std::shared_ptr<const void> decode(const std::string &imageFilepath, size_t *gpuSize_bytes = nullptr);
+
+    ///
+    /// \brief prepareReload Decodes an image file that changed on the calling thread.
+    ///
+    /// Textures are updated in place, so Texture2D objects and the materials using
+    /// them need not be recreated. The image must keep its size.
+    ///
+    /// \param filepath Canonical path of the image.
+    /// \return Command updating the loaded textures, to run on the render thread, or
+    ///         nullptr if no texture was loaded from the file. The command throws
+    ///         ge::LoadError if the size of the image changed.
+    /// \exception ge::LoadError Failed to load image data from file.
+    ///
+    static std::function<void()> prepareReload(const std::string &filepath);
+
+    ///
+    /// \brief bind Binds the texture array holding this texture to the active texture unit.
+    ///
+    void bind() const;
+
+    const TextureArray& getArray() const;
+
+    ///
+    /// \brief getLayer Returns the layer of the texture array holding this texture.
+    ///
+    int getLayer() const;
+
+    ///
+    /// \brief getUvTransform Returns the transform mapping texture coordinates
+    ///                       in [0, 1] onto the texture array layer.
+    ///
+    /// Scale is stored in xy and offset in zw. Texture coordinates outside of [0, 1]
+    /// must be wrapped (fract) before the transform is applied. This is the identity
+    /// transform for textures that are not atlased.
+    ///
+    glm::vec4 getUvTransform() const;
+
+    bool isAtlased() const;
 
 private:
-    std::shared_ptr<unsigned int> id;
+    std::shared_ptr<const TextureArray::Layer> layer;
+    glm::vec4 uvTransform {1.0f, 1.0f, 0.0f, 0.0f};
+    bool atlased = false;
 };
 
+inline const TextureArray& Texture2D::getArray() const {return *this->layer->array;}
+inline int Texture2D::getLayer() const {return this->layer->index;}
+inline glm::vec4 Texture2D::getUvTransform() const {return this->uvTransform;}
+inline bool Texture2D::isAtlased() const {return this->atlased;}
+
 } // namespace ge
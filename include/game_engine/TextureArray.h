@@ -0,0 +1,129 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace ge {
+
+///
+/// \brief The TextureArray class wraps a GL_TEXTURE_2D_ARRAY whose layers are handed
+/// out to textures of the same size and format.
+///
+/// Textures sharing an array are sampled through the same texture binding, so
+/// switching between them only requires selecting another layer in the shader.
+///
+/// Arrays start with a single layer and double their number of layers when they are
+/// full, copying the allocated layers, so they never take more than twice the memory
+/// of their layers. Their texture id changes when they grow.
+///
+/// Texture arrays must only be used on the thread that owns the GL context, except
+/// for releasing layers, which may happen on any thread.
+///
+class TextureArray {
+public:
+    struct Format {
+        int width;
+        int height;
+        unsigned int internalFormat; ///< Sized OpenGL format, e.g. GL_RGBA8.
+        int numMipLevels;
+
+        bool operator==(const Format &other) const;
+    };
+
+    ///
+    /// \brief The Layer struct is a layer allocated in a texture array.
+    ///
+    /// The layer is returned to its array, and the array is deleted once it has no
+    /// allocated layers left, as the last shared_ptr to the layer is destroyed.
+    ///
+    struct Layer {
+        std::shared_ptr<TextureArray> array;
+        int index;
+    };
+
+    /// \name Global settings
+    /// These settings should be adjusted prior to loading any texture.
+    ///@{
+    static size_t maxArraySize_bytes; ///< Limits the number of layers arrays grow to.
+    static int maxNumLayers;
+    ///@}
+
+    ///
+    /// \brief allocateLayer Allocates a layer in an array of the requested format,
+    ///                      growing an array or creating a new one if all existing
+    ///                      ones are full.
+    /// \param format Size and format of the layer.
+    /// \return The allocated layer.
+    ///
+    static std::shared_ptr<const Layer> allocateLayer(const Format &format);
+
+    ///
+    /// \brief TextureArray Allocates storage for all layers and mip levels.
+    ///
+    /// Textures repeat and are sampled with trilinear filtering.
+    ///
+    /// \param format Size and format of every layer.
+    /// \param numLayers Number of layers.
+    ///
+    TextureArray(const Format &format, int numLayers);
+    ~TextureArray();
+
+    TextureArray(const TextureArray &) = delete;
+    TextureArray(TextureArray &&) = delete;
+    TextureArray& operator=(const TextureArray &) = delete;
+    TextureArray& operator=(TextureArray &&) = delete;
+
+    ///
+    /// \brief subImage Uploads pixels into a region of a layer.
+    /// \param layer Layer to upload into.
+    /// \param level Mip level to upload into.
+    /// \param x Left edge of the region.
+    /// \param y Bottom edge of the region.
+    /// \param width Width of the region.
+    /// \param height Height of the region.
+    /// \param format Format of the pixels, e.g. GL_RGBA.
+    /// \param data Tightly packed unsigned byte pixels.
+    ///
+    void subImage(int layer, int level, int x, int y, int width, int height,
+                  unsigned int format, const void *data);
+
+    ///
+    /// \brief generateMipmap Generates all mip levels of a layer from its base level.
+    ///
+    /// Levels are downsampled one after the other with linear filtering on the GPU,
+    /// without touching the other layers.
+    ///
+    /// \param layer Layer to generate the mip levels of.
+    ///
+    void generateMipmap(int layer);
+
+    ///
+    /// \brief bind Binds this texture array to the active texture unit.
+    ///
+    void bind() const;
+
+    unsigned int getId() const;
+    const Format& getFormat() const;
+    int getNumLayers() const;
+
+private:
+    ///
+    /// \brief resize Reallocates storage for more layers and copies the allocated ones.
+    /// \param newNumLayers New number of layers, greater than the current one.
+    ///
+    void resize(int newNumLayers);
+
+    int allocateLayerIndex();
+    void releaseLayerIndex(int index);
+
+    unsigned int id;
+    Format format;
+    int numLayers;
+    std::vector<int> freeLayerIndices;
+};
+
+inline unsigned int TextureArray::getId() const {return this->id;}
+inline const TextureArray::Format& TextureArray::getFormat() const {return this->format;}
+inline int TextureArray::getNumLayers() const {return this->numLayers;}
+
+} // namespace ge
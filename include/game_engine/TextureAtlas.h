@@ -0,0 +1,123 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <glm/vec4.hpp>
+
+#include "TextureArray.h"
+
+namespace ge {
+
+///
+/// \brief The TextureAtlas class packs small textures into shared atlas pages
+/// so that meshes using them bind the same GL texture.
+///
+/// Pages are layers of RGBA8 texture arrays (see TextureArray).
+///
+/// Textures are packed with stb_rect_pack. Each texture is surrounded by a border
+/// of wrapped texels and mipmapped on its own, so repeating texture coordinates and
+/// mipmapping do not bleed into neighbouring textures. The number of mip levels is
+/// limited to log2(padding).
+///
+/// A page is deleted once all textures packed into it are destroyed.
+///
+/// The atlas must only be used on the thread that owns the GL context.
+///
+class TextureAtlas {
+public:
+    ///
+    /// \brief The Region struct locates a packed texture in its atlas page.
+    ///
+    struct Region {
+        /// Texture array layer of the atlas page.
+        std::shared_ptr<const TextureArray::Layer> page;
+
+        /// Maps texture coordinates in [0, 1] onto the page: scale in xy, offset in zw.
+        glm::vec4 uvTransform {1.0f, 1.0f, 0.0f, 0.0f};
+    };
+
+    /// \name Global settings
+    /// These settings should be adjusted prior to loading any texture.
+    ///@{
+    static bool enabled;
+    static int maxTextureSize; ///< Textures with a larger width or height are not atlased.
+    static int defaultPageSize;
+    static int defaultPadding; ///< Must be a power of 2.
+    ///@}
+
+    ///
+    /// \brief getInstance Returns the atlas used when loading Texture2D objects.
+    ///
+    /// The shared atlas is lazily created on first use with the default page size and padding.
+    ///
+    static TextureAtlas& getInstance();
+
+    ///
+    /// \brief TextureAtlas Creates an empty atlas. Pages are allocated as textures are packed.
+    /// \param pageSize Width and height of each page in pixels.
+    /// \param padding Border around each texture in pixels. Must be a power of 2.
+    /// \exception ge::Error Padding is not a power of 2.
+    ///
+    TextureAtlas(int pageSize, int padding);
+    ~TextureAtlas();
+
+    TextureAtlas(const TextureAtlas &) = delete;
+    TextureAtlas(TextureAtlas &&) = delete;
+    TextureAtlas& operator=(const TextureAtlas &) = delete;
+    TextureAtlas& operator=(TextureAtlas &&) = delete;
+
+    ///
+    /// \brief canPack Checks whether a texture is small enough to be atlased.
+    /// \param width Texture width in pixels.
+    /// \param height Texture height in pixels.
+    ///
+    bool canPack(int width, int height) const;
+
+    ///
+    /// \brief pack Uploads a texture into a page with enough free space, creating
+    ///             a new page if needed.
+    /// \param rgbaData RGBA8 pixels of the texture, first row first.
+    /// \param width Texture width in pixels.
+    /// \param height Texture height in pixels.
+    /// \return Region of the page the texture was packed into.
+    /// \exception ge::Error The texture does not fit into a page.
+    ///
+    Region pack(const unsigned char *rgbaData, int width, int height);
+
+    ///
+    /// \brief update Uploads new pixels for a packed texture, e.g. after its file changed.
+    /// \param region Region returned when the texture was packed.
+    /// \param rgbaData RGBA8 pixels of the texture, first row first.
+    /// \param width Texture width in pixels. Must be the packed texture's width.
+    /// \param height Texture height in pixels. Must be the packed texture's height.
+    ///
+    void update(const Region &region, const unsigned char *rgbaData, int width, int height);
+
+    size_t getNumPages() const;
+
+private:
+    struct Page;
+
+    ///
+    /// \brief createPage Allocates an empty page with all of its mip levels.
+    /// \return Texture array layer of the page. The page is released with the last copy.
+    ///
+    std::shared_ptr<const TextureArray::Layer> createPage();
+
+    ///
+    /// \brief upload Uploads a padded texture and its mips into a page.
+    /// \param x Left edge of the padded texture in the page, in pixels.
+    /// \param y Top edge of the padded texture in the page, in pixels.
+    ///
+    void upload(const TextureArray::Layer &pageLayer, int x, int y,
+                const unsigned char *rgbaData, int width, int height);
+
+    int pageSize;
+    int padding;
+    int numMipLevels;
+
+    std::vector<std::unique_ptr<Page>> pages;
+};
+
+} // namespace ge
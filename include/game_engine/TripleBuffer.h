@@ -0,0 +1,167 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+
+namespace ge {
+
+///
+/// \brief The TripleBuffer class hands the latest value produced by one thread
+/// over to a consumer thread without either thread waiting on the other's work.
+///
+/// The producer fills the write buffer and publishes it. The consumer takes the
+/// most recently published buffer. Buffers published with TripleBuffer::publish() in
+/// between are dropped, so the consumer always works on the newest value while the
+/// producer may run ahead. TripleBuffer::waitAndPublish() instead keeps the producer
+/// at most one value ahead of the consumer, so that nothing is dropped.
+///
+/// Only a single producer thread and a single consumer thread are supported.
+///
+template<typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer &) = delete;
+    TripleBuffer(TripleBuffer &&) = delete;
+    TripleBuffer& operator=(const TripleBuffer &) = delete;
+    TripleBuffer& operator=(TripleBuffer &&) = delete;
+
+    ///
+    /// \brief getWriteBuffer Returns the buffer owned by the producer.
+    ///
+    /// The buffer still holds the value it had when it was last published or dropped.
+    ///
+    T& getWriteBuffer();
+
+    ///
+    /// \brief publish Makes the write buffer available to the consumer and hands a
+    ///                new write buffer to the producer.
+    ///
+    void publish();
+
+    ///
+    /// \brief waitAndPublish Blocks until the consumer took the previously published
+    ///                       buffer or TripleBuffer::close() is called and then publishes
+    ///                       the write buffer like TripleBuffer::publish().
+    ///
+    void waitAndPublish();
+
+    ///
+    /// \brief consume Takes the most recently published buffer, if any.
+    /// \return True if the read buffer now holds a newly published value.
+    ///
+    bool consume();
+
+    ///
+    /// \brief waitAndConsume Blocks until a buffer is published or TripleBuffer::close()
+    ///                       is called and then takes the most recently published buffer.
+    /// \return True if the read buffer now holds a newly published value. False if
+    ///         the triple buffer was closed before anything new was published.
+    ///
+    bool waitAndConsume();
+
+    ///
+    /// \brief getReadBuffer Returns the buffer owned by the consumer.
+    ///
+    T& getReadBuffer();
+
+    ///
+    /// \brief close Wakes a consumer blocked in TripleBuffer::waitAndConsume() and a
+    ///              producer blocked in TripleBuffer::waitAndPublish().
+    ///
+    void close();
+
+    ///
+    /// \brief open Allows TripleBuffer::waitAndConsume() and TripleBuffer::waitAndPublish()
+    ///             to block again.
+    ///
+    void open();
+
+private:
+    std::array<T, 3> buffers;
+
+    unsigned int writeIndex = 0;
+    unsigned int readyIndex = 1;
+    unsigned int readIndex = 2;
+
+    bool hasNewValue = false;
+    bool closed = false;
+
+    std::mutex mutex;
+    std::condition_variable newValueCondition;
+    std::condition_variable consumedCondition;
+};
+
+template<typename T>
+inline T& TripleBuffer<T>::getWriteBuffer() {return this->buffers[this->writeIndex];}
+
+template<typename T>
+void TripleBuffer<T>::publish() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        std::swap(this->writeIndex, this->readyIndex);
+        this->hasNewValue = true;
+    }
+    this->newValueCondition.notify_one();
+}
+
+template<typename T>
+void TripleBuffer<T>::waitAndPublish() {
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->consumedCondition.wait(lock, [this]{return !this->hasNewValue || this->closed;});
+        std::swap(this->writeIndex, this->readyIndex);
+        this->hasNewValue = true;
+    }
+    this->newValueCondition.notify_one();
+}
+
+template<typename T>
+bool TripleBuffer<T>::consume() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (!this->hasNewValue) return false;
+
+        std::swap(this->readIndex, this->readyIndex);
+        this->hasNewValue = false;
+    }
+    this->consumedCondition.notify_one();
+    return true;
+}
+
+template<typename T>
+bool TripleBuffer<T>::waitAndConsume() {
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->newValueCondition.wait(lock, [this]{return this->hasNewValue || this->closed;});
+        if (!this->hasNewValue) return false;
+
+        std::swap(this->readIndex, this->readyIndex);
+        this->hasNewValue = false;
+    }
+    this->consumedCondition.notify_one();
+    return true;
+}
+
+template<typename T>
+inline T& TripleBuffer<T>::getReadBuffer() {return this->buffers[this->readIndex];}
+
+template<typename T>
+void TripleBuffer<T>::close() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->closed = true;
+    }
+    this->newValueCondition.notify_all();
+    this->consumedCondition.notify_all();
+}
+
+template<typename T>
+void TripleBuffer<T>::open() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->closed = false;
+}
+
+} // namespace ge
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BoundingSphere.h"
+#include "Mesh.h"
+
+namespace ge {
+
+class AnimationClip;
+class Skeleton;
+
+///
+/// \brief The VertexAnimationTexture class holds the skinned vertices of a mesh baked
+/// for a set of animation clips.
+///
+/// Every frame of every clip is skinned once on the CPU and stored in a position
+/// texture (RGB32F) and a normal texture (RGBA8_SNORM). A frame takes getRowsPerFrame()
+/// rows and vertex v of frame f is at texel (v % getWidth(), f * getRowsPerFrame() + v / getWidth()).
+/// Shaders then animate any number of instances by fetching their vertices by
+/// gl_VertexID, without skeletons or skin matrices. Baked clips always loop.
+///
+/// Must only be created and used on the thread that owns the GL context.
+///
+class VertexAnimationTexture {
+public:
+    ///
+    /// \brief The Clip struct locates the frames of a baked clip.
+    ///
+    struct Clip {
+        std::string name;
+        unsigned int firstFrame;
+        unsigned int numFrames;
+
+        /// Frames per second of the baked clip, adjusted so that its frames evenly
+        /// divide its duration.
+        float framesPerSecond;
+    };
+
+    using AnimationClips = std::vector<std::shared_ptr<const AnimationClip>>;
+
+    /// Maximum number of clips, matching MAX_ANIMATION_CLIPS in vertex_animation.glsl.
+    static constexpr size_t MAX_CLIPS = 32;
+
+    ///
+    /// \brief VertexAnimationTexture Bakes the clips and uploads the textures.
+    /// \param skinningData Bind pose vertices of the mesh to bake.
+    /// \param skeleton Skeleton of the mesh.
+    /// \param clips Clips to bake.
+    /// \param framesPerSecond Number of frames to sample per second of animation.
+    /// \exception ge::Error More than MAX_CLIPS clips or the frames do not fit in a texture.
+    ///
+    VertexAnimationTexture(const Mesh::SkinningData &skinningData, const Skeleton &skeleton,
+                           const AnimationClips &clips, float framesPerSecond = 30.0f);
+    ~VertexAnimationTexture();
+
+    VertexAnimationTexture(const VertexAnimationTexture &) = delete;
+    VertexAnimationTexture(VertexAnimationTexture &&) = delete;
+    VertexAnimationTexture& operator=(const VertexAnimationTexture &) = delete;
+    VertexAnimationTexture& operator=(VertexAnimationTexture &&) = delete;
+
+    ///
+    /// \brief bind Binds the position and normal textures to texture units.
+    /// \param positionTextureUnit Texture unit of the position texture.
+    /// \param normalTextureUnit Texture unit of the normal texture.
+    ///
+    void bind(unsigned int positionTextureUnit, unsigned int normalTextureUnit) const;
+
+    const std::vector<Clip>& getClips() const;
+    size_t getNumVertices() const;
+    unsigned int getNumFrames() const;
+    int getWidth() const;
+    int getRowsPerFrame() const;
+
+    ///
+    /// \brief getBoundingSphere Returns the sphere enclosing the vertices of all frames.
+    ///
+    const BoundingSphere& getBoundingSphere() const;
+
+private:
+    std::vector<Clip> clips;
+    size_t numVertices;
+    unsigned int numFrames = 0;
+    int width;
+    int rowsPerFrame;
+    BoundingSphere boundingSphere;
+
+    unsigned int positionTexture = 0;
+    unsigned int normalTexture = 0;
+};
+
+inline const std::vector<VertexAnimationTexture::Clip>& VertexAnimationTexture::getClips() const {return this->clips;}
+inline size_t VertexAnimationTexture::getNumVertices() const {return this->numVertices;}
+inline unsigned int VertexAnimationTexture::getNumFrames() const {return this->numFrames;}
+inline int VertexAnimationTexture::getWidth() const {return this->width;}
+inline int VertexAnimationTexture::getRowsPerFrame() const {return this->rowsPerFrame;}
+inline const BoundingSphere& VertexAnimationTexture::getBoundingSphere() const {return this->boundingSphere;}
+
+} // namespace ge
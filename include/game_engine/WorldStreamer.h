@@ -0,0 +1,268 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include "SceneGraph.h"
+
+namespace ge {
+
+struct FramePacket;
+class GameObject;
+
+///
+/// \brief The WorldStreamerSettings struct holds the layout of the cells of a streamed
+/// world and the limits of streaming.
+///
+struct WorldStreamerSettings {
+    /// Extents of every cell in the XY plane. Cell (0, 0) starts at the world origin.
+    glm::vec2 cellSize_m {128.0f};
+
+    /// Distance from the camera within which cells are loaded.
+    float loadDistance_m = 256.0f;
+
+    /// Distance from the camera beyond which cells are removed from the world. Larger
+    /// than the load distance, so that cells are not reloaded when the camera moves
+    /// back and forth over a border.
+    float unloadDistance_m = 320.0f;
+
+    /// GPU memory that removed cells may keep resident, so that they come back
+    /// without loading. The least recently used cells are released first.
+    size_t residentBudget_bytes = 512u << 20;
+
+    /// GPU memory uploaded per frame. At least one cell is uploaded per frame.
+    size_t uploadBudgetPerFrame_bytes = 16u << 20;
+
+    /// Number of background threads reading and decoding files.
+    unsigned int numIoThreads = 1;
+};
+
+///
+/// \brief The WorldStreamer class loads the cells of the world around the camera.
+///
+/// The world is partitioned into a grid of cells whose manifests list the game
+/// objects in them. Background I/O threads read the manifests and import the models
+/// and textures of the closest cells first, favoring cells in front of the camera.
+/// Decoded cells are uploaded on the render thread within a per-frame budget and then
+/// added to the world. Cells out of range are removed from the world but stay resident
+/// until the resident budget is exceeded.
+///
+/// Models and textures are shared through the ResourceManager, so assets referenced
+/// by several cells are loaded once and stay resident while any of them is loaded.
+///
+/// Streamed game objects are static scenery: they are not updated.
+///
+class WorldStreamer {
+public:
+    ///
+    /// \brief The CellObject struct describes a game object of a cell.
+    ///
+    struct CellObject {
+        std::string modelFilepath;
+        glm::vec3 position {0.0f};
+
+        /// Rotation around the Z axis.
+        float yaw_rad = 0.0f;
+
+        float scale = 1.0f;
+    };
+
+    using CellManifest = std::vector<CellObject>;
+
+    ///
+    /// \brief ManifestLoader Reads the manifest of a cell on an I/O thread.
+    ///
+    /// Returns an empty manifest for empty cells, e.g. beyond the edges of the world.
+    ///
+    using ManifestLoader = std::function<CellManifest(int x, int y)>;
+
+    using RenderThreadRunner = std::function<void(std::function<void()>)>;
+
+    ///
+    /// \brief WorldStreamer Starts the I/O threads.
+    /// \param manifestLoader Loader of the cell manifests, called from the I/O threads.
+    /// \param settings Layout of the cells and limits of streaming.
+    ///
+    explicit WorldStreamer(ManifestLoader manifestLoader, const WorldStreamerSettings &settings = {});
+
+    ///
+    /// \brief Stops the I/O threads.
+    ///
+    /// Game objects that were not released with WorldStreamer::releaseCells() are
+    /// destroyed here, which then requires the GL context to be current.
+    ///
+    ~WorldStreamer();
+
+    WorldStreamer(const WorldStreamer &) = delete;
+    WorldStreamer(WorldStreamer &&) = delete;
+    WorldStreamer& operator=(const WorldStreamer &) = delete;
+    WorldStreamer& operator=(WorldStreamer &&) = delete;
+
+    ///
+    /// \brief loadManifest Reads a cell manifest from a text file.
+    ///
+    /// Every line lists a game object as
+    ///
+    ///     object <model filepath> <x> <y> <z> [<yaw in degrees> [<scale>]]
+    ///
+    /// Empty lines and lines starting with '#' are ignored.
+    ///
+    /// \param filepath Filepath to the manifest.
+    /// \exception ge::LoadError Failed to open or parse the manifest.
+    ///
+    static CellManifest loadManifest(const std::string &filepath);
+
+    ///
+    /// \brief fileManifestLoader Returns a manifest loader reading files with
+    ///                           WorldStreamer::loadManifest().
+    ///
+    /// Cells whose manifests do not exist are empty.
+    ///
+    /// \param filepathPattern Filepath of the manifests, in which "{x}" and "{y}" are
+    ///                        replaced by the coordinates of the cell,
+    ///                        e.g. "world/cell_{x}_{y}.txt".
+    ///
+    static ManifestLoader fileManifestLoader(const std::string &filepathPattern);
+
+    ///
+    /// \brief update Requests the cells in range of the camera, adds the uploaded cells
+    ///               to the world and removes the cells out of range.
+    ///
+    /// Called on the simulation thread.
+    ///
+    /// \param sceneGraph Scene graph to add the game objects of the cells to.
+    /// \param viewPosition Position of the camera.
+    /// \param viewDirection Direction the camera looks at.
+    /// \param runOnRenderThread Queues commands to run with the GL context current.
+    ///
+    void update(SceneGraph &sceneGraph, const glm::vec3 &viewPosition, const glm::vec3 &viewDirection,
+                const RenderThreadRunner &runOnRenderThread);
+
+    ///
+    /// \brief releaseCells Removes all cells from the world and releases their game
+    ///                     objects on the render thread.
+    ///
+    /// Called on the simulation thread before the streamer is destroyed there, e.g. by
+    /// Game::setWorldStreamer(). Cells still uploading are released once uploaded. The
+    /// streamer must not be updated afterwards.
+    ///
+    /// \param sceneGraph Scene graph the game objects of the cells were added to.
+    /// \param runOnRenderThread Queues commands to run with the GL context current.
+    ///
+    void releaseCells(SceneGraph &sceneGraph, const RenderThreadRunner &runOnRenderThread);
+
+    ///
+    /// \brief addToFramePacket Adds the game objects of the cells in the world.
+    ///
+    void addToFramePacket(const SceneGraph &sceneGraph, FramePacket &framePacket) const;
+
+    /// Number of cells in the world.
+    size_t getNumLoadedCells() const;
+
+    ///
+    /// \brief getResidentSize Returns the estimated GPU memory taken by the cells
+    ///                        uploaded by this streamer.
+    ///
+    size_t getResidentSize_bytes() const;
+
+private:
+    using CellCoordinates = std::pair<int, int>;
+    using GameObjects = std::vector<std::shared_ptr<GameObject>>;
+
+    enum class CellState {
+        /// Waiting for or being read by an I/O thread.
+        DECODING,
+        /// Waiting to be uploaded.
+        DECODED,
+        /// Being uploaded by the render thread.
+        UPLOADING,
+        /// In the world.
+        LOADED,
+        /// Out of the world but resident.
+        CACHED
+    };
+
+    ///
+    /// \brief The DecodedCell struct holds the manifest of a cell and the imported
+    /// models it refers to until the cell is uploaded.
+    ///
+    struct DecodedCell {
+        CellCoordinates coordinates;
+        CellManifest manifest;
+        std::vector<std::shared_ptr<const void>> importedModels;
+        size_t size_bytes = 0;
+    };
+
+    struct Cell {
+        CellState state = CellState::DECODING;
+        bool wanted = true;
+        float priority = 0.0f;
+        size_t size_bytes = 0;
+        std::shared_ptr<const DecodedCell> decodedCell;
+        GameObjects gameObjects;
+        std::list<CellCoordinates>::iterator lruPosition;
+    };
+
+    ///
+    /// \brief The UploadedCells struct is shared with the upload commands, which may
+    /// run after the streamer is destroyed.
+    ///
+    struct UploadedCells {
+        std::mutex mutex;
+        std::vector<std::pair<CellCoordinates, GameObjects>> cells;
+
+        /// Set by WorldStreamer::releaseCells(), after which uploads are dropped on the
+        /// render thread.
+        bool released = false;
+    };
+
+    void ioLoop();
+    DecodedCell decodeCell(const CellCoordinates &coordinates) const;
+    void uploadCells(const RenderThreadRunner &runOnRenderThread);
+    void addUploadedCells(SceneGraph &sceneGraph);
+    void evictCells(const RenderThreadRunner &runOnRenderThread);
+
+    float getDistance(const CellCoordinates &cell, const glm::vec2 &position) const;
+    float getPriority(const CellCoordinates &cell, const glm::vec3 &viewPosition,
+                      const glm::vec3 &viewDirection) const;
+
+    ManifestLoader manifestLoader;
+    WorldStreamerSettings settings;
+
+    /// Cells known to the streamer, accessed by the simulation thread only.
+    std::map<CellCoordinates, Cell> cells;
+
+    /// Cached cells, least recently used first.
+    std::list<CellCoordinates> lruCells;
+
+    size_t numLoadedCells = 0;
+    size_t residentSize_bytes = 0;
+
+    /// Cells for the I/O threads to decode and their results, guarded by ioMutex.
+    std::mutex ioMutex;
+    std::condition_variable ioRequested;
+    std::map<CellCoordinates, float> ioRequests;
+    std::vector<DecodedCell> decodedCells;
+    bool stopping = false;
+
+    std::shared_ptr<UploadedCells> uploadedCells;
+
+    std::vector<std::thread> ioThreads;
+};
+
+inline size_t WorldStreamer::getNumLoadedCells() const {return this->numLoadedCells;}
+inline size_t WorldStreamer::getResidentSize_bytes() const {return this->residentSize_bytes;}
+
+} // namespace ge
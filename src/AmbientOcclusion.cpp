@@ -0,0 +1,132 @@
+#include <game_engine/AmbientOcclusion.h>
+
+#include <algorithm>
+
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include <game_engine/Exception.h>
+
+namespace {
+
+/// Ambient occlusion and linear depth, which needs more precision than 8 bits.
+constexpr GLenum occlusionFormat = GL_RG16F;
+
+/// Number of frames after which animated noise repeats, long enough for temporal
+/// anti-aliasing to have forgotten the first one.
+constexpr unsigned int numNoiseFrames = 64;
+
+///
+/// \brief bindTexture Binds a 2D texture to a texture unit.
+///
+void bindTexture(unsigned int textureUnit, unsigned int texture) {
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+} // namespace
+
+namespace ge {
+
+AmbientOcclusion::AmbientOcclusion(const std::string &vertexShaderPath, const std::string &occlusionShaderPath,
+                                   const std::string &blurShaderPath)
+    : occlusionShader(std::make_unique<ShaderProgram>(vertexShaderPath, occlusionShaderPath)),
+      blurShader(std::make_unique<ShaderProgram>(vertexShaderPath, blurShaderPath)) {
+    glGenVertexArrays(1, &this->vao);
+}
+
+AmbientOcclusion::~AmbientOcclusion() {
+    glDeleteVertexArrays(1, &this->vao);
+}
+
+RenderGraph::Resource AmbientOcclusion::addPasses(RenderGraph *graph, RenderGraph::Resource scene,
+                                                  const glm::mat4 &projectionMatrix, bool temporal) {
+    const auto sceneDesc = graph->getDesc(scene);
+    if (!sceneDesc.depthFormat) {
+        throw Error("Ambient occlusion requires the depth texture of the scene");
+    }
+
+    const auto width = std::max(1, sceneDesc.width / this->downsampleFactor);
+    const auto height = std::max(1, sceneDesc.height / this->downsampleFactor);
+
+    // Positions are reconstructed with the elements of the projection that are not zero,
+    // including the jitter
+    const glm::vec4 projectionParameters {projectionMatrix[0][0], projectionMatrix[1][1],
+                                          projectionMatrix[2][0], projectionMatrix[2][1]};
+    const glm::vec2 depthParameters {projectionMatrix[2][2], projectionMatrix[3][2]};
+
+    const auto noiseFrame = temporal ? static_cast<float>(this->frameIndex++ % numNoiseFrames) : 0.0f;
+
+    const auto occlusion = graph->createRenderTarget("ambient occlusion", {width, height, occlusionFormat, 0});
+    graph->addPass("ambient occlusion", {scene}, {occlusion},
+                   [this, graph, scene, projectionParameters, depthParameters, noiseFrame]{
+        this->occlusionShader->use();
+        this->occlusionShader->setUniform("depthTexture", 0)
+                .setUniform("projectionParameters", projectionParameters)
+                .setUniform("depthParameters", depthParameters)
+                .setUniform("downsampleFactor", this->downsampleFactor)
+                .setUniform("radius", this->radius)
+                .setUniform("intensity", this->intensity)
+                .setUniform("noiseFrame", noiseFrame);
+        bindTexture(0, graph->getRenderTarget(scene).getDepthTexture());
+
+        this->drawFullscreenTriangle();
+
+        bindTexture(0, 0);
+    });
+
+    // Blur horizontally then vertically, the second blur reuses the textures of the occlusion
+    auto source = occlusion;
+    const char *blurPassNames[] = {"ambient occlusion blur horizontal", "ambient occlusion blur vertical"};
+    const glm::vec2 blurDirections[] = {{1.0f, 0.0f}, {0.0f, 1.0f}};
+    for (int i = 0; i < 2; ++i) {
+        const auto target = graph->createRenderTarget(blurPassNames[i], {width, height, occlusionFormat, 0});
+        graph->addPass(blurPassNames[i], {source}, {target}, [this, graph, source, direction = blurDirections[i]]{
+            this->blurShader->use();
+            this->blurShader->setUniform("sourceTexture", 0)
+                    .setUniform("direction", direction);
+            bindTexture(0, graph->getRenderTarget(source).getColorTexture());
+
+            this->drawFullscreenTriangle();
+
+            bindTexture(0, 0);
+        });
+        source = target;
+    }
+
+    return source;
+}
+
+void AmbientOcclusion::drawFullscreenTriangle() const {
+    const auto depthTestEnabled = glIsEnabled(GL_DEPTH_TEST);
+    glDisable(GL_DEPTH_TEST);
+
+    glBindVertexArray(this->vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+
+    if (depthTestEnabled) glEnable(GL_DEPTH_TEST);
+}
+
+AmbientOcclusion& AmbientOcclusion::setEnabled(bool enabled) {
+    this->enabled = enabled;
+    return *this;
+}
+
+AmbientOcclusion& AmbientOcclusion::setRadius(float radius) {
+    this->radius = radius;
+    return *this;
+}
+
+AmbientOcclusion& AmbientOcclusion::setIntensity(float intensity) {
+    this->intensity = intensity;
+    return *this;
+}
+
+AmbientOcclusion& AmbientOcclusion::setDownsampleFactor(int downsampleFactor) {
+    this->downsampleFactor = std::max(downsampleFactor, 1);
+    return *this;
+}
+
+} // namespace ge
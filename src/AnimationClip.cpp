@@ -0,0 +1,251 @@
+#include <game_engine/AnimationClip.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/geometric.hpp>
+
+namespace {
+
+/// The three smallest components of a unit quaternion lie in [-1/sqrt(2), 1/sqrt(2)].
+constexpr float maxSmallestComponent = 0.70710678f;
+constexpr int maxQuantizedComponent = 0x7FFF;
+
+float getRotationDistance(const glm::quat &a, const glm::quat &b) {
+    return 2.0f * std::acos(std::min(1.0f, std::abs(glm::dot(a, b))));
+}
+
+float getVectorDistance(const glm::vec3 &a, const glm::vec3 &b) {
+    return glm::distance(a, b);
+}
+
+glm::vec3 interpolateVector(const glm::vec3 &a, const glm::vec3 &b, float t) {
+    return glm::mix(a, b, t);
+}
+
+double getTicksPerSecond(const aiAnimation &animation) {
+    // Assimp leaves the tick rate at 0 if the file does not specify it
+    return (animation.mTicksPerSecond > 0.0) ? animation.mTicksPerSecond : 25.0;
+}
+
+std::vector<ge::AnimationClip::JointKeyframes> readKeyframes(const aiAnimation &animation,
+                                                             const ge::Skeleton &skeleton) {
+    const auto ticksPerSecond = getTicksPerSecond(animation);
+
+    std::vector<ge::AnimationClip::JointKeyframes> keyframes;
+    for (unsigned int i = 0; i < animation.mNumChannels; ++i) {
+        const auto &channel = *animation.mChannels[i];
+
+        ge::AnimationClip::JointKeyframes jointKeyframes;
+        jointKeyframes.joint = skeleton.findJoint(channel.mNodeName.C_Str());
+        if (jointKeyframes.joint == ge::Skeleton::NO_JOINT) continue;
+
+        for (unsigned int j = 0; j < channel.mNumPositionKeys; ++j) {
+            const auto &key = channel.mPositionKeys[j];
+            jointKeyframes.translations.emplace_back(static_cast<float>(key.mTime / ticksPerSecond),
+                                                     glm::vec3(key.mValue.x, key.mValue.y, key.mValue.z));
+        }
+
+        for (unsigned int j = 0; j < channel.mNumRotationKeys; ++j) {
+            const auto &key = channel.mRotationKeys[j];
+            jointKeyframes.rotations.emplace_back(static_cast<float>(key.mTime / ticksPerSecond),
+                                                  glm::quat(key.mValue.w, key.mValue.x, key.mValue.y, key.mValue.z));
+        }
+
+        for (unsigned int j = 0; j < channel.mNumScalingKeys; ++j) {
+            const auto &key = channel.mScalingKeys[j];
+            jointKeyframes.scales.emplace_back(static_cast<float>(key.mTime / ticksPerSecond),
+                                               glm::vec3(key.mValue.x, key.mValue.y, key.mValue.z));
+        }
+
+        keyframes.push_back(std::move(jointKeyframes));
+    }
+
+    return keyframes;
+}
+
+///
+/// \brief reduceKeyframes Greedily removes keyframes that interpolating between their
+///                        remaining neighbors reproduces within the tolerance.
+/// \return Indices of the remaining keyframes.
+///
+template<typename T, typename Interpolate, typename Distance>
+std::vector<size_t> reduceKeyframes(const std::vector<std::pair<float, T>> &keyframes, float tolerance,
+                                    Interpolate interpolate, Distance distance) {
+    std::vector<size_t> keptIndices;
+    if (keyframes.empty()) return keptIndices;
+
+    keptIndices.push_back(0);
+    for (size_t i = 1; i + 1 < keyframes.size(); ++i) {
+        // Try to skip keyframe i by interpolating from the last kept keyframe to keyframe i + 1
+        const auto &first = keyframes[keptIndices.back()];
+        const auto &last = keyframes[i + 1];
+
+        auto isRedundant = true;
+        for (auto j = keptIndices.back() + 1; j <= i && isRedundant; ++j) {
+            const auto t = (keyframes[j].first - first.first) / (last.first - first.first);
+            isRedundant = distance(interpolate(first.second, last.second, t), keyframes[j].second) <= tolerance;
+        }
+
+        if (!isRedundant) keptIndices.push_back(i);
+    }
+
+    // A constant channel only needs a single keyframe
+    const auto lastIndex = keyframes.size() - 1;
+    if (lastIndex > 0 && (keptIndices.size() > 1 ||
+                          distance(keyframes[0].second, keyframes[lastIndex].second) > tolerance)) {
+        keptIndices.push_back(lastIndex);
+    }
+
+    return keptIndices;
+}
+
+///
+/// \brief findKeyframe Returns the index of the last keyframe at or before a time and
+///                     the interpolation parameter towards the next keyframe.
+///
+size_t findKeyframe(const std::vector<float> &times, float time_s, float *t) {
+    const auto next = std::upper_bound(times.begin(), times.end(), time_s);
+    *t = 0.0f;
+
+    if (next == times.begin()) return 0;
+    if (next == times.end()) return times.size() - 1;
+
+    const auto index = static_cast<size_t>(next - times.begin()) - 1;
+    *t = (time_s - times[index]) / (times[index + 1] - times[index]);
+    return index;
+}
+
+} // namespace
+
+namespace ge {
+
+AnimationClip::QuantizedQuat AnimationClip::QuantizedQuat::quantize(const glm::quat &rotation) {
+    auto q = glm::normalize(rotation);
+
+    // Drop the largest component and make it positive, so that it can be restored
+    // from the unit length
+    auto largestIndex = 0;
+    for (auto i = 1; i < 4; ++i) {
+        if (std::abs(q[i]) > std::abs(q[largestIndex])) largestIndex = i;
+    }
+    if (q[largestIndex] < 0.0f) q = -q;
+
+    QuantizedQuat quantized;
+    for (int i = 0, component = 0; i < 4; ++i) {
+        if (i == largestIndex) continue;
+
+        const auto normalized = glm::clamp(q[i] / maxSmallestComponent * 0.5f + 0.5f, 0.0f, 1.0f);
+        quantized.components[component++] = static_cast<std::uint16_t>(std::round(normalized * maxQuantizedComponent));
+    }
+
+    quantized.components[0] |= static_cast<std::uint16_t>((largestIndex & 1) << 15);
+    quantized.components[1] |= static_cast<std::uint16_t>((largestIndex >> 1) << 15);
+    return quantized;
+}
+
+glm::quat AnimationClip::QuantizedQuat::dequantize() const {
+    const auto largestIndex = (this->components[0] >> 15) | ((this->components[1] >> 15) << 1);
+
+    glm::quat q;
+    auto sumOfSquares = 0.0f;
+    for (int i = 0, component = 0; i < 4; ++i) {
+        if (i == largestIndex) continue;
+
+        const auto normalized = static_cast<float>(this->components[component++] & maxQuantizedComponent) / maxQuantizedComponent;
+        q[i] = (normalized * 2.0f - 1.0f) * maxSmallestComponent;
+        sumOfSquares += q[i] * q[i];
+    }
+
+    q[largestIndex] = std::sqrt(std::max(0.0f, 1.0f - sumOfSquares));
+    return q;
+}
+
+std::vector<std::shared_ptr<const AnimationClip>> AnimationClip::loadAnimationClips(
+        const aiScene &scene, const Skeleton &skeleton, const KeyframeTolerances &tolerances) {
+    std::vector<std::shared_ptr<const AnimationClip>> clips;
+    clips.reserve(scene.mNumAnimations);
+
+    for (unsigned int i = 0; i < scene.mNumAnimations; ++i) {
+        clips.push_back(std::make_shared<const AnimationClip>(*scene.mAnimations[i], skeleton, tolerances));
+    }
+
+    return clips;
+}
+
+AnimationClip::AnimationClip(std::string name, float duration_s,
+                             const std::vector<JointKeyframes> &keyframes,
+                             const KeyframeTolerances &tolerances)
+    : name(std::move(name)), duration_s(duration_s) {
+    this->tracks.reserve(keyframes.size());
+
+    for (const auto &jointKeyframes : keyframes) {
+        Track track;
+        track.joint = jointKeyframes.joint;
+
+        for (auto i : reduceKeyframes(jointKeyframes.translations, tolerances.translation,
+                                      interpolateVector, getVectorDistance)) {
+            track.translations.times.push_back(jointKeyframes.translations[i].first);
+            track.translations.values.push_back(jointKeyframes.translations[i].second);
+        }
+
+        for (auto i : reduceKeyframes(jointKeyframes.rotations, tolerances.rotation_rad,
+                                      JointTransform::interpolateRotation, getRotationDistance)) {
+            track.rotations.times.push_back(jointKeyframes.rotations[i].first);
+            track.rotations.values.push_back(QuantizedQuat::quantize(jointKeyframes.rotations[i].second));
+        }
+
+        for (auto i : reduceKeyframes(jointKeyframes.scales, tolerances.scale,
+                                      interpolateVector, getVectorDistance)) {
+            track.scales.times.push_back(jointKeyframes.scales[i].first);
+            track.scales.values.push_back(jointKeyframes.scales[i].second);
+        }
+
+        this->tracks.push_back(std::move(track));
+    }
+}
+
+AnimationClip::AnimationClip(const aiAnimation &animation, const Skeleton &skeleton,
+                             const KeyframeTolerances &tolerances)
+    : AnimationClip(animation.mName.C_Str(),
+                    static_cast<float>(animation.mDuration / getTicksPerSecond(animation)),
+                    readKeyframes(animation, skeleton), tolerances) {}
+
+void AnimationClip::sample(float time_s, Pose *pose) const {
+    float t;
+
+    for (const auto &track : this->tracks) {
+        auto &transform = (*pose)[track.joint];
+
+        if (!track.translations.times.empty()) {
+            const auto i = findKeyframe(track.translations.times, time_s, &t);
+            const auto &values = track.translations.values;
+            transform.translation = (t > 0.0f) ? glm::mix(values[i], values[i + 1], t) : values[i];
+        }
+
+        if (!track.rotations.times.empty()) {
+            const auto i = findKeyframe(track.rotations.times, time_s, &t);
+            const auto &values = track.rotations.values;
+            transform.rotation = (t > 0.0f) ?
+                        JointTransform::interpolateRotation(values[i].dequantize(), values[i + 1].dequantize(), t) :
+                        values[i].dequantize();
+        }
+
+        if (!track.scales.times.empty()) {
+            const auto i = findKeyframe(track.scales.times, time_s, &t);
+            const auto &values = track.scales.values;
+            transform.scale = (t > 0.0f) ? glm::mix(values[i], values[i + 1], t) : values[i];
+        }
+    }
+}
+
+size_t AnimationClip::getNumKeyframes() const {
+    size_t numKeyframes = 0;
+    for (const auto &track : this->tracks) {
+        numKeyframes += track.translations.times.size() + track.rotations.times.size() + track.scales.times.size();
+    }
+
+    return numKeyframes;
+}
+
+} // namespace ge
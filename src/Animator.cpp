@@ -0,0 +1,75 @@
+#include <game_engine/Animator.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ge {
+
+Animator::Animator(std::shared_ptr<const Skeleton> skeleton)
+    : skeleton(std::move(skeleton)), pose(this->skeleton->getBindPose()) {
+    this->skeleton->computeModelTransforms(this->pose, &this->modelTransforms);
+}
+
+void Animator::play(std::shared_ptr<const AnimationClip> clip,
+                    std::chrono::duration<float> fadeDuration, bool loop) {
+    if (fadeDuration.count() > 0.0f) {
+        this->previous = std::move(this->current);
+        this->fadeDuration_s = fadeDuration.count();
+        this->fadeTime_s = 0.0f;
+    } else {
+        this->previous = Playback();
+        this->fadeDuration_s = 0.0f;
+        this->fadeTime_s = 0.0f;
+    }
+
+    this->current.clip = std::move(clip);
+    this->current.time_s = 0.0f;
+    this->current.loop = loop;
+}
+
+void Animator::update(std::chrono::duration<float> updateDuration) {
+    const auto duration_s = updateDuration.count() * this->speed;
+
+    this->advance(&this->current, duration_s);
+    this->samplePose(this->current, &this->pose);
+
+    // Cross-fade from the previous clip, which keeps playing during the fade
+    if (this->fadeTime_s < this->fadeDuration_s) {
+        this->fadeTime_s += duration_s;
+        this->advance(&this->previous, duration_s);
+        this->samplePose(this->previous, &this->previousPose);
+
+        const auto weight = std::min(this->fadeTime_s / this->fadeDuration_s, 1.0f);
+        blendPoses(this->previousPose, this->pose, weight, &this->pose);
+    } else if (this->previous.clip) {
+        this->previous = Playback();
+    }
+
+    this->skeleton->computeModelTransforms(this->pose, &this->modelTransforms);
+}
+
+void Animator::computeSkinMatrices(glm::mat4 *skinMatrices) const {
+    this->skeleton->computeSkinMatrices(this->modelTransforms, skinMatrices);
+}
+
+void Animator::advance(Playback *playback, float duration_s) const {
+    if (!playback->clip) return;
+
+    const auto clipDuration_s = playback->clip->getDuration();
+    playback->time_s += duration_s;
+
+    if (playback->loop && clipDuration_s > 0.0f) {
+        playback->time_s = std::fmod(playback->time_s, clipDuration_s);
+        if (playback->time_s < 0.0f) playback->time_s += clipDuration_s;
+    } else {
+        playback->time_s = std::max(0.0f, std::min(playback->time_s, clipDuration_s));
+    }
+}
+
+void Animator::samplePose(const Playback &playback, Pose *pose) const {
+    // Joints without keyframes stay in the bind pose
+    *pose = this->skeleton->getBindPose();
+    if (playback.clip) playback.clip->sample(playback.time_s, pose);
+}
+
+} // namespace ge
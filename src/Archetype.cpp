@@ -0,0 +1,153 @@
+#include <game_engine/Archetype.h>
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include <game_engine/Exception.h>
+
+namespace {
+
+std::deque<ge::ComponentInfo> componentInfos;
+std::mutex componentInfosMutex;
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+namespace ge {
+
+/// ----------------------------------------------------
+///            ComponentRegistry Functions
+/// ----------------------------------------------------
+const ComponentInfo& ComponentRegistry::getInfo(ComponentTypeId typeId) {
+    std::lock_guard<std::mutex> lock(componentInfosMutex);
+    return componentInfos[typeId];
+}
+
+ComponentTypeId ComponentRegistry::registerType(const ComponentInfo &info) {
+    std::lock_guard<std::mutex> lock(componentInfosMutex);
+
+    if (componentInfos.size() == MAX_COMPONENT_TYPES) {
+        throw Error("Exceeded the maximum number of component types: " +
+                    std::to_string(MAX_COMPONENT_TYPES));
+    }
+
+    componentInfos.push_back(info);
+    return static_cast<ComponentTypeId>(componentInfos.size() - 1);
+}
+
+/// ----------------------------------------------------
+///                Archetype Functions
+/// ----------------------------------------------------
+Archetype::Archetype(const ComponentMask &mask) : mask(mask) {
+    this->columnIndices.fill(-1);
+
+    size_t rowSize_bytes = sizeof(Entity);
+    for (ComponentTypeId typeId = 0; typeId < MAX_COMPONENT_TYPES; ++typeId) {
+        if (!mask.test(typeId)) continue;
+
+        const auto &info = ComponentRegistry::getInfo(typeId);
+        this->columnIndices[typeId] = static_cast<int>(this->columns.size());
+        this->columns.push_back({typeId, 0, &info});
+        rowSize_bytes += info.size;
+    }
+
+    // Fit as many rows as possible into a chunk while leaving room to align each array
+    const auto alignmentPadding_bytes = this->columns.size() * ComponentRegistry::MAX_ALIGNMENT;
+    this->chunkCapacity = CHUNK_SIZE_BYTES > alignmentPadding_bytes + rowSize_bytes ?
+                (CHUNK_SIZE_BYTES - alignmentPadding_bytes) / rowSize_bytes : 1;
+
+    // Lay out each component array after the entity array
+    auto offset_bytes = this->chunkCapacity * sizeof(Entity);
+    for (auto &column : this->columns) {
+        offset_bytes = alignUp(offset_bytes, column.info->alignment);
+        column.offset_bytes = offset_bytes;
+        offset_bytes += this->chunkCapacity * column.info->size;
+    }
+    this->chunkSize_bytes = offset_bytes;
+}
+
+Archetype::~Archetype() {
+    for (auto &chunk : this->chunks) {
+        for (const auto &column : this->columns) {
+            auto componentArray = chunk.data + column.offset_bytes;
+            for (size_t i = 0; i < chunk.size; ++i) {
+                column.info->destroy(componentArray + i * column.info->size);
+            }
+        }
+    }
+}
+
+size_t Archetype::pushBack(Entity entity) {
+    if (this->chunks.empty() || this->chunks.back().size == this->chunkCapacity) {
+        this->addChunk();
+    }
+
+    auto &chunk = this->chunks.back();
+    reinterpret_cast<Entity*>(chunk.data)[chunk.size++] = entity;
+    return this->numRows++;
+}
+
+Entity Archetype::swapRemove(size_t row) {
+    const auto lastRow = this->numRows - 1;
+
+    for (const auto &column : this->columns) {
+        auto component = this->getComponent(column.typeId, row);
+        column.info->destroy(component);
+
+        if (row != lastRow) {
+            auto lastComponent = this->getComponent(column.typeId, lastRow);
+            column.info->moveConstruct(component, lastComponent);
+            column.info->destroy(lastComponent);
+        }
+    }
+
+    Entity movedEntity;
+    if (row != lastRow) {
+        movedEntity = this->getEntity(lastRow);
+        this->getEntityArray(row / this->chunkCapacity)[row % this->chunkCapacity] = movedEntity;
+    }
+
+    --this->numRows;
+    if (--this->chunks.back().size == 0) {
+        this->chunks.pop_back();
+    }
+
+    return movedEntity;
+}
+
+Archetype* Archetype::getAddEdge(ComponentTypeId typeId) const {
+    auto edge = this->addEdges.find(typeId);
+    return edge == this->addEdges.cend() ? nullptr : edge->second;
+}
+
+Archetype* Archetype::getRemoveEdge(ComponentTypeId typeId) const {
+    auto edge = this->removeEdges.find(typeId);
+    return edge == this->removeEdges.cend() ? nullptr : edge->second;
+}
+
+void Archetype::setAddEdge(ComponentTypeId typeId, Archetype *archetype) {
+    this->addEdges[typeId] = archetype;
+}
+
+void Archetype::setRemoveEdge(ComponentTypeId typeId, Archetype *archetype) {
+    this->removeEdges[typeId] = archetype;
+}
+
+void Archetype::addChunk() {
+    // Over-allocate to align the chunk to a cache line
+    Chunk chunk;
+    chunk.storage.reset(new unsigned char[this->chunkSize_bytes + ComponentRegistry::MAX_ALIGNMENT]);
+
+    const auto address = reinterpret_cast<std::uintptr_t>(chunk.storage.get());
+    chunk.data = chunk.storage.get() + (alignUp(address, ComponentRegistry::MAX_ALIGNMENT) - address);
+    chunk.size = 0;
+
+    this->chunks.push_back(std::move(chunk));
+}
+
+} // namespace ge
@@ -0,0 +1,63 @@
+#include <game_engine/BoundingSphere.h>
+
+#include <algorithm>
+
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+namespace ge {
+
+BoundingSphere BoundingSphere::fromPoints(const float *positions, size_t numPoints) {
+    BoundingSphere sphere;
+    if (numPoints == 0) return sphere;
+
+    glm::vec3 min(positions[0], positions[1], positions[2]);
+    glm::vec3 max = min;
+    for (size_t i = 1; i < numPoints; ++i) {
+        const glm::vec3 point(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]);
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    sphere.center = (min + max) * 0.5f;
+    sphere.radius = 0.0f;
+    for (size_t i = 0; i < numPoints; ++i) {
+        const glm::vec3 point(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]);
+        sphere.radius = std::max(sphere.radius, glm::distance(sphere.center, point));
+    }
+
+    return sphere;
+}
+
+BoundingSphere BoundingSphere::merged(const BoundingSphere &other) const {
+    if (other.isEmpty()) return *this;
+    if (this->isEmpty()) return other;
+
+    const auto offset = other.center - this->center;
+    const auto distance = glm::length(offset);
+
+    // One sphere contains the other
+    if (distance + other.radius <= this->radius) return *this;
+    if (distance + this->radius <= other.radius) return other;
+
+    BoundingSphere sphere;
+    sphere.radius = (distance + this->radius + other.radius) * 0.5f;
+    sphere.center = this->center + offset * ((sphere.radius - this->radius) / distance);
+    return sphere;
+}
+
+BoundingSphere BoundingSphere::transformed(const glm::mat4 &modelMatrix) const {
+    if (this->isEmpty()) return *this;
+
+    const auto maxScale = std::max({glm::length(glm::vec3(modelMatrix[0])),
+                                    glm::length(glm::vec3(modelMatrix[1])),
+                                    glm::length(glm::vec3(modelMatrix[2]))});
+
+    BoundingSphere sphere;
+    sphere.center = glm::vec3(modelMatrix * glm::vec4(this->center, 1.0f));
+    sphere.radius = this->radius * maxScale;
+    return sphere;
+}
+
+} // namespace ge
@@ -22,6 +22,12 @@ void Camera::onUpdate(std::chrono::duration<float> updateDuration) {
     }
 }
 
+void Camera::subscribeToInput(Input &) {}
+
+void Camera::addInputSubscription(Input::Subscription subscription) {
+    this->inputSubscriptions.push_back(std::move(subscription));
+}
+
 void Camera::setMaxFov(float fov_deg) {
     this->maxFov_deg = fov_deg;
 }
@@ -4,43 +4,78 @@
 
 #include <glm/trigonometric.hpp>
 
+namespace {
+const std::string MOVE_FORWARD_ACTION = "MoveForward";
+const std::string MOVE_BACKWARD_ACTION = "MoveBackward";
+const std::string MOVE_LEFT_ACTION = "MoveLeft";
+const std::string MOVE_RIGHT_ACTION = "MoveRight";
+} // namespace
+
 namespace ge {
 
 CameraFPV::CameraFPV(float maxFov_deg, float aspectRatioWidthToHeight, float nearPlane, float farPlane)
     : Camera(maxFov_deg, aspectRatioWidthToHeight, nearPlane, farPlane) {}
 
-void CameraFPV::keyCallback(GLFWwindow *window, int key, int action, int mods) {
-    auto forwardKeyStatus = glfwGetKey(window, GLFW_KEY_W);
-    auto backwardKeyStatus = glfwGetKey(window, GLFW_KEY_S);
-    auto leftKeyStatus = glfwGetKey(window, GLFW_KEY_A);
-    auto rightKeyStatus = glfwGetKey(window, GLFW_KEY_D);
+void CameraFPV::subscribeToInput(Input &input) {
+    const std::pair<const std::string&, int> defaultMappings[] {
+        {MOVE_FORWARD_ACTION, GLFW_KEY_W},
+        {MOVE_BACKWARD_ACTION, GLFW_KEY_S},
+        {MOVE_LEFT_ACTION, GLFW_KEY_A},
+        {MOVE_RIGHT_ACTION, GLFW_KEY_D}
+    };
+
+    for (const auto &mapping : defaultMappings) {
+        if (!input.hasActionMappings(mapping.first)) {
+            input.mapKeyToAction(mapping.first, mapping.second);
+        }
+
+        this->addInputSubscription(input.subscribeAction(mapping.first, [this, &input](bool){
+            this->updateMovement(input);
+        }));
+    }
+
+    this->addInputSubscription(input.subscribeCursorPosition([this](double cursorX, double cursorY){
+        this->rotateTowardsCursor(cursorX, cursorY);
+    }));
+
+    this->addInputSubscription(input.subscribeScroll([this](double, double yOffset){
+        this->setCurrentFov_deg(static_cast<float>(this->getCurrentFov_deg() -
+                                                   this->getScrollSensitivity() * yOffset));
+    }));
+}
+
+void CameraFPV::updateMovement(const Input &input) {
+    const auto forward = input.isActionDown(MOVE_FORWARD_ACTION);
+    const auto backward = input.isActionDown(MOVE_BACKWARD_ACTION);
+    const auto left = input.isActionDown(MOVE_LEFT_ACTION);
+    const auto right = input.isActionDown(MOVE_RIGHT_ACTION);
 
-    if (forwardKeyStatus == GLFW_PRESS && backwardKeyStatus == GLFW_RELEASE) {
+    if (forward && !backward) {
         this->moveForward();
     }
 
-    if (backwardKeyStatus == GLFW_PRESS && forwardKeyStatus == GLFW_RELEASE) {
+    if (backward && !forward) {
         this->moveBackward();
     }
 
-    if (leftKeyStatus == GLFW_PRESS && rightKeyStatus == GLFW_RELEASE) {
+    if (left && !right) {
         this->moveLeft();
     }
 
-    if (rightKeyStatus == GLFW_PRESS && leftKeyStatus == GLFW_RELEASE) {
+    if (right && !left) {
         this->moveRight();
     }
 
-    if (forwardKeyStatus == GLFW_RELEASE && backwardKeyStatus == GLFW_RELEASE) {
+    if (!forward && !backward) {
         this->stopForwardBackwardMovement();
     }
 
-    if (leftKeyStatus == GLFW_RELEASE && rightKeyStatus == GLFW_RELEASE) {
+    if (!left && !right) {
         this->stopSidewaysMovement();
     }
 }
 
-void CameraFPV::cursorPositionCallback(GLFWwindow *window, double cursorX, double cursorY) {
+void CameraFPV::rotateTowardsCursor(double cursorX, double cursorY) {
     if (!firstCursorPositionReceived) {
         this->lastCursorX = cursorX;
         this->lastCursorY = cursorY;
@@ -60,9 +95,4 @@ void CameraFPV::cursorPositionCallback(GLFWwindow *window, double cursorX, doubl
     this->lastCursorY = cursorY;
 }
 
-void CameraFPV::scrollCallback(GLFWwindow *window, double xOffset, double yOffset) {
-    this->setCurrentFov_deg(static_cast<float>(this->getCurrentFov_deg() -
-                                           this->getScrollSensitivity() * yOffset));
-}
-
 } // namespace ge
@@ -9,17 +9,29 @@ namespace ge {
 CameraNav::CameraNav(float maxFov_deg, float aspectRatioWidthToHeight, float nearPlane, float farPlane)
     : Camera(maxFov_deg, aspectRatioWidthToHeight, nearPlane, farPlane) {}
 
-void CameraNav::cursorPositionCallback(GLFWwindow *window, double cursorX, double cursorY) {
-    auto leftMouseButtonState = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT);
-    auto rightMouseButtonState = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT);
+void CameraNav::subscribeToInput(Input &input) {
+    this->addInputSubscription(input.subscribeCursorPosition([this, &input](double cursorX, double cursorY){
+        this->onCursorPosition(input, cursorX, cursorY);
+    }));
+
+    this->addInputSubscription(input.subscribeMouseButton(Input::ANY, [this, &input](int button, int action, int){
+        this->onMouseButton(input, button, action);
+    }));
+
+    this->addInputSubscription(input.subscribeScroll([this](double, double yOffset){
+        this->setLinearSpeed(static_cast<float>(this->getLinearSpeed() +
+                                                this->getScrollSensitivity() * yOffset));
+    }));
+}
 
+void CameraNav::onCursorPosition(const Input &input, double cursorX, double cursorY) {
     auto xOffset = cursorX - this->lastCursorX;
     auto yOffset = cursorY - this->lastCursorY;
 
     auto deltaYaw = static_cast<float>(glm::radians(-xOffset * this->getCursorSensitivity()));
     auto deltaPitch = static_cast<float>(glm::radians(yOffset * this->getCursorSensitivity()));
 
-    if (leftMouseButtonState == GLFW_PRESS || rightMouseButtonState == GLFW_PRESS) {
+    if (input.isMouseButtonDown(GLFW_MOUSE_BUTTON_LEFT) || input.isMouseButtonDown(GLFW_MOUSE_BUTTON_RIGHT)) {
         this->rotate(deltaPitch, this->getOrientationY())
                 .rotate(deltaYaw, this->getHorizontalRotationAxis());
     }
@@ -28,19 +40,19 @@ void CameraNav::cursorPositionCallback(GLFWwindow *window, double cursorX, doubl
     this->lastCursorY = cursorY;
 }
 
-void CameraNav::mouseButtonCallback(GLFWwindow *window, int button, int action, int mods) {
+void CameraNav::onMouseButton(const Input &input, int button, int action) {
     if (action == GLFW_PRESS) {
-        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
+        glfwSetInputMode(input.getWindow(), GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
 
         if (button == GLFW_MOUSE_BUTTON_RIGHT) {
-            if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) {
+            if (input.isKeyDown(GLFW_KEY_LEFT_SHIFT)) {
                 this->moveBackward();
             } else {
                 this->moveForward();
             }
         }
     } else {
-        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+        glfwSetInputMode(input.getWindow(), GLFW_CURSOR, GLFW_CURSOR_NORMAL);
 
         if (button == GLFW_MOUSE_BUTTON_RIGHT) {
             this->stopForwardBackwardMovement();
@@ -48,8 +60,4 @@ void CameraNav::mouseButtonCallback(GLFWwindow *window, int button, int action,
     }
 }
 
-void CameraNav::scrollCallback(GLFWwindow *window, double xOffset, double yOffset) {
-    this->setLinearSpeed(this->getLinearSpeed() + this->getScrollSensitivity() * yOffset);
-}
-
 } // namespace ge
@@ -0,0 +1,57 @@
+#include <game_engine/Components.h>
+
+#include <limits>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <game_engine/EntityRegistry.h>
+#include <game_engine/FramePacket.h>
+
+namespace ge {
+
+MeshRendererComponent::MeshRendererComponent(std::shared_ptr<GameObject::Meshes> meshes)
+    : meshes(std::move(meshes)) {}
+
+MeshRendererComponent::MeshRendererComponent(const std::string &modelFilepath)
+    : meshes(GameObject::loadMeshes(modelFilepath)) {}
+
+glm::mat4 CameraComponent::getProjectionMatrix() const {
+    return glm::perspective(glm::radians(this->fov_deg),
+                            this->aspectRatioWidthToHeight,
+                            this->nearPlane, this->farPlane);
+}
+
+Entity createEntity(EntityRegistry &registry, const GameObject &gameObject) {
+    TransformComponent transform;
+    static_cast<Model&>(transform) = gameObject.getModel();
+
+    return registry.createEntity(std::move(transform),
+                                 MeshRendererComponent(gameObject.getMeshes()));
+}
+
+void addEntitiesToFramePacket(EntityRegistry &registry, FramePacket &framePacket) {
+    registry.forEach<const TransformComponent, const LightComponent>(
+                [&framePacket](Entity, const TransformComponent &transform, const LightComponent &light){
+        framePacket.directionalLight.direction = transform.getLookAtDirection();
+        framePacket.directionalLight.ambient = light.ambient;
+        framePacket.directionalLight.diffuse = light.diffuse;
+        framePacket.directionalLight.specular = light.specular;
+    });
+
+    registry.forEach<const TransformComponent, const MeshRendererComponent>(
+                [&framePacket](Entity, const TransformComponent &transform, const MeshRendererComponent &meshRenderer){
+        if (!meshRenderer.meshes) return;
+
+        // Entities do not keep their previous transform, so only the camera moves them
+        framePacket.drawList.push_back({meshRenderer.meshes,
+                                        transform.getModelMatrix(),
+                                        transform.getNormalMatrix(),
+                                        0,
+                                        std::numeric_limits<size_t>::max(),
+                                        nullptr,
+                                        glm::mat4(0.0f)});
+    });
+}
+
+} // namespace ge
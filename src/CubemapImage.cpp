@@ -0,0 +1,640 @@
+#include <game_engine/CubemapImage.h>
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/vec3.hpp>
+
+#include <stb_image.h>
+
+#define STB_DXT_IMPLEMENTATION
+#include <stb_dxt.h>
+
+#include <game_engine/Exception.h>
+#include <game_engine/JobSystem.h>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define GE_CUBEMAP_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace {
+
+constexpr int numChannels = 4;
+constexpr int bc1BlockSize = 4;
+constexpr size_t bc1BlockSize_bytes = 8;
+
+constexpr char containerMagic[4] = {'G', 'E', 'C', 'M'};
+constexpr std::uint32_t containerVersion = 2;
+
+/// Spherical harmonics only keep low frequencies, so larger levels add no detail.
+constexpr int maxShSourceSize = 64;
+
+/// Texels per range when projecting into spherical harmonics, a multiple of 4 so that
+/// every range but the last is processed entirely with SSE.
+constexpr size_t shGrainSize = 1024;
+
+/// Source texels are integrated for every output texel, so their number is kept low.
+constexpr int maxSpecularSourceSize = 32;
+
+/// Normalization constants of the real spherical harmonics basis functions.
+constexpr float shConstants[9] = {0.282095f, 0.488603f, 0.488603f, 0.488603f,
+                                  1.092548f, 1.092548f, 0.315392f, 1.092548f, 0.546274f};
+
+/// Cosine lobe convolution factors of the bands 0, 1 and 2, divided by pi.
+constexpr float shCosineFactors[9] = {1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f,
+                                      0.25f, 0.25f, 0.25f, 0.25f, 0.25f};
+
+///
+/// \brief The LinearTexels struct holds the texels of a cubemap level in structure of
+/// arrays layout, so that they can be integrated 4 at a time.
+///
+struct LinearTexels {
+    /// Directions of the texel centers.
+    std::vector<float> x, y, z;
+
+    std::vector<float> solidAngles;
+
+    /// Radiance in linear color space.
+    std::vector<float> r, g, b;
+};
+
+///
+/// \brief texelDirection Returns the direction of the center of a cubemap texel.
+/// \param face Face index, +X, -X, +Y, -Y, +Z, -Z.
+/// \param x Column of the texel.
+/// \param y Row of the texel.
+/// \param size Width and height of the face.
+///
+glm::vec3 texelDirection(int face, int x, int y, int size) {
+    const auto s = 2.0f * (x + 0.5f) / size - 1.0f;
+    const auto t = 2.0f * (y + 0.5f) / size - 1.0f;
+
+    switch (face) {
+    case 0: return glm::normalize(glm::vec3(1.0f, -t, -s));
+    case 1: return glm::normalize(glm::vec3(-1.0f, -t, s));
+    case 2: return glm::normalize(glm::vec3(s, 1.0f, t));
+    case 3: return glm::normalize(glm::vec3(s, -1.0f, -t));
+    case 4: return glm::normalize(glm::vec3(s, -t, 1.0f));
+    default: return glm::normalize(glm::vec3(-s, -t, -1.0f));
+    }
+}
+
+///
+/// \brief texelSolidAngle Returns the approximate solid angle covered by a cubemap texel.
+///
+float texelSolidAngle(int x, int y, int size) {
+    const auto s = 2.0f * (x + 0.5f) / size - 1.0f;
+    const auto t = 2.0f * (y + 0.5f) / size - 1.0f;
+    const auto texelArea = 4.0f / (static_cast<float>(size) * size);
+    return texelArea / std::pow(1.0f + s * s + t * t, 1.5f);
+}
+
+float srgbToLinear(unsigned char value) {
+    const auto c = value / 255.0f;
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+///
+/// \brief srgbToLinearTable Returns srgbToLinear() of every 8 bit value.
+///
+const std::array<float, 256>& srgbToLinearTable() {
+    static const auto table = []{
+        std::array<float, 256> table;
+        for (size_t i = 0; i < table.size(); ++i) {
+            table[i] = srgbToLinear(static_cast<unsigned char>(i));
+        }
+        return table;
+    }();
+    return table;
+}
+
+unsigned char linearToSrgb(float value) {
+    const auto c = std::min(std::max(value, 0.0f), 1.0f);
+    const auto srgb = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+    return static_cast<unsigned char>(srgb * 255.0f + 0.5f);
+}
+
+///
+/// \brief downsample Halves the size of a square RGBA8 face with a 2x2 box filter.
+///
+/// The last row and column of odd sizes are repeated.
+///
+ge::CubemapImage::Face downsample(const ge::CubemapImage::Face &face, int size) {
+    const auto halfSize = std::max(1, size / 2);
+    ge::CubemapImage::Face result(static_cast<size_t>(halfSize) * halfSize * numChannels);
+
+    for (int y = 0; y < halfSize; ++y) {
+        for (int x = 0; x < halfSize; ++x) {
+            for (int c = 0; c < numChannels; ++c) {
+                auto texel = [&](int dx, int dy) {
+                    const auto srcX = std::min(2 * x + dx, size - 1);
+                    const auto srcY = std::min(2 * y + dy, size - 1);
+                    return static_cast<unsigned int>(face[(static_cast<size_t>(srcY) * size + srcX) * numChannels + c]);
+                };
+
+                result[(static_cast<size_t>(y) * halfSize + x) * numChannels + c] =
+                        static_cast<unsigned char>((texel(0, 0) + texel(1, 0) + texel(0, 1) + texel(1, 1) + 2) / 4);
+            }
+        }
+    }
+
+    return result;
+}
+
+///
+/// \brief findLevel Returns the largest mip level of an image with at most the given size.
+///
+size_t findLevel(const ge::CubemapImage &image, int maxSize) {
+    size_t level = 0;
+    while (level + 1 < image.levels.size() && image.getLevelSize(level) > maxSize) {
+        ++level;
+    }
+    return level;
+}
+
+///
+/// \brief gatherLinearTexels Returns the texels of an RGBA8 cubemap level.
+///
+LinearTexels gatherLinearTexels(const ge::CubemapImage &image, size_t level) {
+    const auto &table = srgbToLinearTable();
+    const auto size = image.getLevelSize(level);
+
+    LinearTexels texels;
+    const auto numTexels = static_cast<size_t>(ge::CubemapImage::NUM_FACES) * size * size;
+    for (auto values : {&texels.x, &texels.y, &texels.z, &texels.solidAngles, &texels.r, &texels.g, &texels.b}) {
+        values->reserve(numTexels);
+    }
+
+    for (int face = 0; face < ge::CubemapImage::NUM_FACES; ++face) {
+        const auto &data = image.levels[level][face];
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                const auto direction = texelDirection(face, x, y, size);
+                const auto texel = &data[(static_cast<size_t>(y) * size + x) * numChannels];
+                texels.x.push_back(direction.x);
+                texels.y.push_back(direction.y);
+                texels.z.push_back(direction.z);
+                texels.solidAngles.push_back(texelSolidAngle(x, y, size));
+                texels.r.push_back(table[texel[0]]);
+                texels.g.push_back(table[texel[1]]);
+                texels.b.push_back(table[texel[2]]);
+            }
+        }
+    }
+
+    return texels;
+}
+
+#ifdef GE_CUBEMAP_SSE
+float horizontalSum(__m128 values) {
+    float lanes[4];
+    _mm_storeu_ps(lanes, values);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+#endif
+
+///
+/// \brief integrateGgx Returns the radiance reflected along a normal by a GGX lobe.
+///
+/// Since the view direction is assumed to be the normal, the half vector of a light
+/// direction L satisfies dot(N, H)^2 = (1 + dot(N, L)) / 2, so the distribution only
+/// depends on dot(N, L). Its normalization cancels out with the sum of the weights.
+///
+/// \param alphaSquared Square of the GGX alpha, i.e. roughness^4.
+///
+glm::vec3 integrateGgx(const LinearTexels &texels, const glm::vec3 &normal, float alphaSquared) {
+    const auto numTexels = texels.x.size();
+    const auto halfAlphaSquaredMinusOne = 0.5f * (alphaSquared - 1.0f);
+
+    glm::vec3 sum(0.0f);
+    float weightSum = 0.0f;
+
+    size_t i = 0;
+#ifdef GE_CUBEMAP_SSE
+    const auto zero4 = _mm_setzero_ps();
+    const auto one4 = _mm_set1_ps(1.0f);
+    const auto normalX4 = _mm_set1_ps(normal.x);
+    const auto normalY4 = _mm_set1_ps(normal.y);
+    const auto normalZ4 = _mm_set1_ps(normal.z);
+    const auto halfAlphaSquaredMinusOne4 = _mm_set1_ps(halfAlphaSquaredMinusOne);
+
+    auto sumR4 = zero4, sumG4 = zero4, sumB4 = zero4, weightSum4 = zero4;
+    for (; i + 4 <= numTexels; i += 4) {
+        const auto cosine = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&texels.x[i]), normalX4),
+                                                  _mm_mul_ps(_mm_loadu_ps(&texels.y[i]), normalY4)),
+                                       _mm_mul_ps(_mm_loadu_ps(&texels.z[i]), normalZ4));
+        const auto denominator = _mm_add_ps(_mm_mul_ps(_mm_add_ps(one4, cosine), halfAlphaSquaredMinusOne4), one4);
+        const auto weight = _mm_and_ps(_mm_cmpgt_ps(cosine, zero4),
+                                       _mm_div_ps(_mm_mul_ps(cosine, _mm_loadu_ps(&texels.solidAngles[i])),
+                                                  _mm_mul_ps(denominator, denominator)));
+
+        sumR4 = _mm_add_ps(sumR4, _mm_mul_ps(weight, _mm_loadu_ps(&texels.r[i])));
+        sumG4 = _mm_add_ps(sumG4, _mm_mul_ps(weight, _mm_loadu_ps(&texels.g[i])));
+        sumB4 = _mm_add_ps(sumB4, _mm_mul_ps(weight, _mm_loadu_ps(&texels.b[i])));
+        weightSum4 = _mm_add_ps(weightSum4, weight);
+    }
+
+    sum = glm::vec3(horizontalSum(sumR4), horizontalSum(sumG4), horizontalSum(sumB4));
+    weightSum = horizontalSum(weightSum4);
+#endif
+
+    for (; i < numTexels; ++i) {
+        const auto cosine = texels.x[i] * normal.x + texels.y[i] * normal.y + texels.z[i] * normal.z;
+        if (cosine <= 0.0f) continue;
+
+        const auto denominator = (1.0f + cosine) * halfAlphaSquaredMinusOne + 1.0f;
+        const auto weight = cosine * texels.solidAngles[i] / (denominator * denominator);
+        sum += weight * glm::vec3(texels.r[i], texels.g[i], texels.b[i]);
+        weightSum += weight;
+    }
+
+    return weightSum > 0.0f ? sum / weightSum : glm::vec3(0.0f);
+}
+
+///
+/// \brief compressFaceBc1 Compresses a square RGBA8 face into BC1 blocks.
+///
+ge::CubemapImage::Face compressFaceBc1(const ge::CubemapImage::Face &face, int size) {
+    const auto numBlocks = (size + bc1BlockSize - 1) / bc1BlockSize;
+    ge::CubemapImage::Face result(static_cast<size_t>(numBlocks) * numBlocks * bc1BlockSize_bytes);
+
+    unsigned char block[bc1BlockSize * bc1BlockSize * numChannels];
+    for (int blockY = 0; blockY < numBlocks; ++blockY) {
+        for (int blockX = 0; blockX < numBlocks; ++blockX) {
+            for (int y = 0; y < bc1BlockSize; ++y) {
+                for (int x = 0; x < bc1BlockSize; ++x) {
+                    const auto srcX = std::min(blockX * bc1BlockSize + x, size - 1);
+                    const auto srcY = std::min(blockY * bc1BlockSize + y, size - 1);
+                    std::copy_n(&face[(static_cast<size_t>(srcY) * size + srcX) * numChannels], numChannels,
+                                &block[(y * bc1BlockSize + x) * numChannels]);
+                }
+            }
+
+            stb_compress_dxt_block(&result[(static_cast<size_t>(blockY) * numBlocks + blockX) * bc1BlockSize_bytes],
+                                   block, 0, STB_DXT_HIGHQUAL);
+        }
+    }
+
+    return result;
+}
+
+template<typename T>
+void write(std::ofstream &file, const T &value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<typename T>
+bool read(std::ifstream &file, T *value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(value), sizeof(*value)));
+}
+
+} // namespace
+
+namespace ge {
+
+constexpr int CubemapImage::NUM_FACES;
+
+CubemapImage decodeCubemap(const std::array<std::string, 6> &imageFilepaths) {
+    std::array<int, CubemapImage::NUM_FACES> widths {}, heights {};
+
+    CubemapImage image;
+    image.levels.resize(1);
+    JobSystem::getInstance().parallelFor(CubemapImage::NUM_FACES, 1, [&](size_t begin, size_t end){
+        for (auto i = begin; i < end; ++i) {
+            int numFileChannels;
+            std::unique_ptr<unsigned char, void(*)(void*)> data(
+                        stbi_load(imageFilepaths[i].c_str(), &widths[i], &heights[i], &numFileChannels, numChannels),
+                        stbi_image_free);
+
+            if (!data) {
+                throw LoadError("Failed to load texture at " + imageFilepaths[i]);
+            }
+
+            image.levels[0][i].assign(data.get(), data.get() + static_cast<size_t>(widths[i]) * heights[i] * numChannels);
+        }
+    });
+
+    image.size = widths[0];
+    for (int i = 0; i < CubemapImage::NUM_FACES; ++i) {
+        if (widths[i] != image.size || heights[i] != image.size) {
+            throw LoadError("Cubemap face at " + imageFilepaths[i] + " is not square or not the size of the other faces");
+        }
+    }
+
+    return image;
+}
+
+void generateCubemapMipmaps(CubemapImage *image) {
+    image->levels.resize(1);
+    for (auto size = image->size; size > 1; size = std::max(1, size / 2)) {
+        CubemapImage::Level level;
+        JobSystem::getInstance().parallelFor(CubemapImage::NUM_FACES, 1, [&](size_t begin, size_t end){
+            for (auto face = begin; face < end; ++face) {
+                level[face] = downsample(image->levels.back()[face], size);
+            }
+        });
+        image->levels.push_back(std::move(level));
+    }
+}
+
+CubemapImage computeIrradiance(const CubemapImage &radiance, int size) {
+    // Sample the smallest level that still resolves the cosine lobe
+    size_t sourceLevel = 0;
+    while (sourceLevel + 1 < radiance.levels.size() && radiance.getLevelSize(sourceLevel + 1) >= 2 * size) {
+        ++sourceLevel;
+    }
+    const auto sourceSize = radiance.getLevelSize(sourceLevel);
+
+    // Directions weighted by solid angle and linear radiance of every source texel
+    std::vector<glm::vec3> weightedDirections, linearRadiances;
+    for (int face = 0; face < CubemapImage::NUM_FACES; ++face) {
+        const auto &texels = radiance.levels[sourceLevel][face];
+        for (int y = 0; y < sourceSize; ++y) {
+            for (int x = 0; x < sourceSize; ++x) {
+                const auto texel = &texels[(static_cast<size_t>(y) * sourceSize + x) * numChannels];
+                weightedDirections.push_back(texelDirection(face, x, y, sourceSize) * texelSolidAngle(x, y, sourceSize));
+                linearRadiances.emplace_back(srgbToLinear(texel[0]), srgbToLinear(texel[1]), srgbToLinear(texel[2]));
+            }
+        }
+    }
+
+    CubemapImage irradiance;
+    irradiance.size = size;
+    irradiance.levels.resize(1);
+    for (auto &face : irradiance.levels[0]) {
+        face.resize(static_cast<size_t>(size) * size * numChannels);
+    }
+
+    JobSystem::getInstance().parallelFor(static_cast<size_t>(CubemapImage::NUM_FACES) * size, 1,
+                                         [&](size_t begin, size_t end){
+        for (auto row = begin; row < end; ++row) {
+            const auto face = static_cast<int>(row / size);
+            const auto y = static_cast<int>(row % size);
+
+            for (int x = 0; x < size; ++x) {
+                const auto normal = texelDirection(face, x, y, size);
+
+                glm::vec3 sum(0.0f);
+                float weightSum = 0.0f;
+                for (size_t i = 0; i < weightedDirections.size(); ++i) {
+                    const auto weight = glm::dot(normal, weightedDirections[i]);
+                    if (weight <= 0.0f) continue;
+
+                    sum += weight * linearRadiances[i];
+                    weightSum += weight;
+                }
+
+                // The weights sum up to pi over the hemisphere
+                const auto value = weightSum > 0.0f ? sum / weightSum : glm::vec3(0.0f);
+                const auto texel = &irradiance.levels[0][face][(static_cast<size_t>(y) * size + x) * numChannels];
+                texel[0] = linearToSrgb(value.r);
+                texel[1] = linearToSrgb(value.g);
+                texel[2] = linearToSrgb(value.b);
+                texel[3] = 255;
+            }
+        }
+    });
+
+    return irradiance;
+}
+
+ShCoefficients projectIrradianceSh9(const CubemapImage &radiance) {
+    const auto texels = gatherLinearTexels(radiance, findLevel(radiance, maxShSourceSize));
+
+    // Radiance weighted by solid angle and each basis function, then the solid angle
+    constexpr size_t numSums = 9 * 3 + 1;
+    std::array<float, numSums> sums {};
+    std::mutex sumsMutex;
+
+    JobSystem::getInstance().parallelFor(texels.x.size(), shGrainSize, [&](size_t begin, size_t end){
+        std::array<float, numSums> rangeSums {};
+
+        auto i = begin;
+#ifdef GE_CUBEMAP_SSE
+        __m128 sums4[numSums];
+        for (auto &sum4 : sums4) {
+            sum4 = _mm_setzero_ps();
+        }
+
+        for (; i + 4 <= end; i += 4) {
+            const auto x = _mm_loadu_ps(&texels.x[i]);
+            const auto y = _mm_loadu_ps(&texels.y[i]);
+            const auto z = _mm_loadu_ps(&texels.z[i]);
+            const auto solidAngle = _mm_loadu_ps(&texels.solidAngles[i]);
+            const auto r = _mm_mul_ps(_mm_loadu_ps(&texels.r[i]), solidAngle);
+            const auto g = _mm_mul_ps(_mm_loadu_ps(&texels.g[i]), solidAngle);
+            const auto b = _mm_mul_ps(_mm_loadu_ps(&texels.b[i]), solidAngle);
+
+            const __m128 basis[9] = {
+                _mm_set1_ps(shConstants[0]),
+                _mm_mul_ps(_mm_set1_ps(shConstants[1]), y),
+                _mm_mul_ps(_mm_set1_ps(shConstants[2]), z),
+                _mm_mul_ps(_mm_set1_ps(shConstants[3]), x),
+                _mm_mul_ps(_mm_set1_ps(shConstants[4]), _mm_mul_ps(x, y)),
+                _mm_mul_ps(_mm_set1_ps(shConstants[5]), _mm_mul_ps(y, z)),
+                _mm_mul_ps(_mm_set1_ps(shConstants[6]),
+                           _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(3.0f), _mm_mul_ps(z, z)), _mm_set1_ps(1.0f))),
+                _mm_mul_ps(_mm_set1_ps(shConstants[7]), _mm_mul_ps(x, z)),
+                _mm_mul_ps(_mm_set1_ps(shConstants[8]), _mm_sub_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)))
+            };
+
+            for (size_t k = 0; k < 9; ++k) {
+                sums4[3 * k] = _mm_add_ps(sums4[3 * k], _mm_mul_ps(basis[k], r));
+                sums4[3 * k + 1] = _mm_add_ps(sums4[3 * k + 1], _mm_mul_ps(basis[k], g));
+                sums4[3 * k + 2] = _mm_add_ps(sums4[3 * k + 2], _mm_mul_ps(basis[k], b));
+            }
+            sums4[numSums - 1] = _mm_add_ps(sums4[numSums - 1], solidAngle);
+        }
+
+        for (size_t k = 0; k < numSums; ++k) {
+            rangeSums[k] = horizontalSum(sums4[k]);
+        }
+#endif
+
+        for (; i < end; ++i) {
+            const auto x = texels.x[i], y = texels.y[i], z = texels.z[i];
+            const auto solidAngle = texels.solidAngles[i];
+            const float basis[9] = {
+                shConstants[0], shConstants[1] * y, shConstants[2] * z, shConstants[3] * x,
+                shConstants[4] * x * y, shConstants[5] * y * z, shConstants[6] * (3.0f * z * z - 1.0f),
+                shConstants[7] * x * z, shConstants[8] * (x * x - y * y)
+            };
+
+            for (size_t k = 0; k < 9; ++k) {
+                rangeSums[3 * k] += basis[k] * texels.r[i] * solidAngle;
+                rangeSums[3 * k + 1] += basis[k] * texels.g[i] * solidAngle;
+                rangeSums[3 * k + 2] += basis[k] * texels.b[i] * solidAngle;
+            }
+            rangeSums[numSums - 1] += solidAngle;
+        }
+
+        std::lock_guard<std::mutex> lock(sumsMutex);
+        for (size_t k = 0; k < numSums; ++k) {
+            sums[k] += rangeSums[k];
+        }
+    });
+
+    // The solid angles are approximate, rescale them to sum up to the full sphere
+    const auto solidAngleSum = sums[numSums - 1];
+    const auto normalization = solidAngleSum > 0.0f ? 4.0f * glm::pi<float>() / solidAngleSum : 0.0f;
+
+    ShCoefficients coefficients;
+    for (size_t k = 0; k < coefficients.size(); ++k) {
+        coefficients[k] = glm::vec3(sums[3 * k], sums[3 * k + 1], sums[3 * k + 2]) *
+                normalization * shCosineFactors[k];
+    }
+    return coefficients;
+}
+
+CubemapImage prefilterSpecular(const CubemapImage &radiance, int size, int numLevels) {
+    size_t baseLevel = 0;
+    while (baseLevel + 1 < radiance.levels.size() && radiance.getLevelSize(baseLevel + 1) >= size) {
+        ++baseLevel;
+    }
+
+    CubemapImage specular;
+    specular.size = radiance.getLevelSize(baseLevel);
+    specular.levels.resize(static_cast<size_t>(std::max(numLevels, 1)));
+
+    // A perfectly smooth surface reflects the radiance unchanged
+    specular.levels[0] = radiance.levels[baseLevel];
+
+    for (size_t level = 1; level < specular.levels.size(); ++level) {
+        const auto levelSize = specular.getLevelSize(level);
+        const auto roughness = static_cast<float>(level) / (specular.levels.size() - 1);
+        const auto alphaSquared = roughness * roughness * roughness * roughness;
+        const auto texels = gatherLinearTexels(radiance, findLevel(radiance, std::min(levelSize, maxSpecularSourceSize)));
+
+        auto &faces = specular.levels[level];
+        for (auto &face : faces) {
+            face.resize(static_cast<size_t>(levelSize) * levelSize * numChannels);
+        }
+
+        JobSystem::getInstance().parallelFor(static_cast<size_t>(CubemapImage::NUM_FACES) * levelSize, 1,
+                                             [&](size_t begin, size_t end){
+            for (auto row = begin; row < end; ++row) {
+                const auto face = static_cast<int>(row / levelSize);
+                const auto y = static_cast<int>(row % levelSize);
+
+                for (int x = 0; x < levelSize; ++x) {
+                    const auto value = integrateGgx(texels, texelDirection(face, x, y, levelSize), alphaSquared);
+                    const auto texel = &faces[face][(static_cast<size_t>(y) * levelSize + x) * numChannels];
+                    texel[0] = linearToSrgb(value.r);
+                    texel[1] = linearToSrgb(value.g);
+                    texel[2] = linearToSrgb(value.b);
+                    texel[3] = 255;
+                }
+            }
+        });
+    }
+
+    return specular;
+}
+
+CubemapImage compressCubemapBc1(const CubemapImage &image) {
+    // stb_dxt initializes its tables on first use, which is not thread-safe
+    static std::once_flag initFlag;
+    std::call_once(initFlag, []{
+        unsigned char block[bc1BlockSize * bc1BlockSize * numChannels] {};
+        unsigned char compressed[bc1BlockSize_bytes];
+        stb_compress_dxt_block(compressed, block, 0, STB_DXT_HIGHQUAL);
+    });
+
+    CubemapImage compressed;
+    compressed.format = CubemapImage::BC1;
+    compressed.size = image.size;
+    compressed.levels.resize(image.levels.size());
+
+    JobSystem::getInstance().parallelFor(image.levels.size() * CubemapImage::NUM_FACES, 1,
+                                         [&](size_t begin, size_t end){
+        for (auto i = begin; i < end; ++i) {
+            const auto level = i / CubemapImage::NUM_FACES;
+            const auto face = i % CubemapImage::NUM_FACES;
+            compressed.levels[level][face] = compressFaceBc1(image.levels[level][face], image.getLevelSize(level));
+        }
+    });
+
+    return compressed;
+}
+
+void saveCubemaps(const std::string &filepath, const std::vector<CubemapImage> &images,
+                  const std::vector<float> &values) {
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    file.write(containerMagic, sizeof(containerMagic));
+    write(file, containerVersion);
+    write(file, static_cast<std::uint32_t>(images.size()));
+
+    for (const auto &image : images) {
+        write(file, static_cast<std::uint32_t>(image.format));
+        write(file, static_cast<std::uint32_t>(image.size));
+        write(file, static_cast<std::uint32_t>(image.levels.size()));
+
+        for (const auto &level : image.levels) {
+            for (const auto &face : level) {
+                write(file, static_cast<std::uint64_t>(face.size()));
+                file.write(reinterpret_cast<const char*>(face.data()), static_cast<std::streamsize>(face.size()));
+            }
+        }
+    }
+
+    write(file, static_cast<std::uint32_t>(values.size()));
+    file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(float)));
+
+    if (!file) {
+        std::cerr << "Failed to write cubemap cache: " << filepath << "\n";
+    }
+}
+
+std::vector<CubemapImage> loadCubemaps(const std::string &filepath, std::vector<float> *values) {
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return {};
+
+    const auto fileSize_bytes = static_cast<std::uint64_t>(file.tellg());
+    file.seekg(0);
+
+    char magic[sizeof(containerMagic)];
+    std::uint32_t version, numImages;
+    if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), containerMagic) ||
+            !read(file, &version) || version != containerVersion || !read(file, &numImages)) return {};
+
+    std::vector<CubemapImage> images(numImages);
+    for (auto &image : images) {
+        std::uint32_t format, size, numLevels;
+        if (!read(file, &format) || format > CubemapImage::BC1 ||
+                !read(file, &size) || !read(file, &numLevels)) return {};
+
+        image.format = static_cast<CubemapImage::Format>(format);
+        image.size = static_cast<int>(size);
+        image.levels.resize(numLevels);
+
+        for (auto &level : image.levels) {
+            for (auto &face : level) {
+                std::uint64_t faceSize_bytes;
+                if (!read(file, &faceSize_bytes) || faceSize_bytes > fileSize_bytes ||
+                        faceSize_bytes != image.getFaceSize_bytes(&level - image.levels.data())) return {};
+
+                face.resize(static_cast<size_t>(faceSize_bytes));
+                if (!file.read(reinterpret_cast<char*>(face.data()), static_cast<std::streamsize>(face.size()))) return {};
+            }
+        }
+    }
+
+    std::uint32_t numValues;
+    if (!read(file, &numValues) || numValues > fileSize_bytes / sizeof(float)) return {};
+
+    std::vector<float> storedValues(numValues);
+    if (!file.read(reinterpret_cast<char*>(storedValues.data()),
+                   static_cast<std::streamsize>(storedValues.size() * sizeof(float)))) return {};
+
+    if (values) *values = std::move(storedValues);
+    return images;
+}
+
+} // namespace ge
@@ -0,0 +1,76 @@
+#include <game_engine/DynamicResolution.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/// Relative GPU time below the target within which the scale is not raised, so that it
+/// settles on the step under the budget instead of alternating with the one above.
+constexpr float headroom = 0.1f;
+
+} // namespace
+
+namespace ge {
+
+constexpr float DynamicResolution::SCALE_STEP;
+
+void DynamicResolution::update(float gpuFrameTime_ms) {
+    if (!this->enabled || gpuFrameTime_ms <= 0.0f) return;
+
+    // Velocity form: the controller outputs a change of scale, so clamping the scale
+    // keeps it from winding up while the budget cannot be met
+    auto error = (this->targetFrameTime_ms - gpuFrameTime_ms) / this->targetFrameTime_ms;
+    if (error > 0.0f) error = std::max(error - headroom, 0.0f);
+
+    const auto change = this->proportionalGain * (error - this->previousError) +
+            this->integralGain * error +
+            this->derivativeGain * (error - 2.0f * this->previousError + this->secondPreviousError);
+
+    this->secondPreviousError = this->previousError;
+    this->previousError = error;
+
+    this->controlledScale = std::min(std::max(this->controlledScale + change, this->minScale), this->maxScale);
+
+    const auto atBound = this->controlledScale == this->minScale || this->controlledScale == this->maxScale;
+    if (atBound || std::abs(this->controlledScale - this->scale) >= SCALE_STEP) {
+        this->scale = atBound ? this->controlledScale
+                              : std::round(this->controlledScale / SCALE_STEP) * SCALE_STEP;
+        this->scale = std::min(std::max(this->scale, this->minScale), this->maxScale);
+    }
+}
+
+DynamicResolution& DynamicResolution::setEnabled(bool enabled) {
+    if (enabled != this->enabled) this->reset();
+    this->enabled = enabled;
+    return *this;
+}
+
+DynamicResolution& DynamicResolution::setTargetFrameTime_ms(float targetFrameTime_ms) {
+    this->targetFrameTime_ms = targetFrameTime_ms;
+    return *this;
+}
+
+DynamicResolution& DynamicResolution::setScaleRange(float minScale, float maxScale) {
+    this->minScale = minScale;
+    this->maxScale = maxScale;
+    this->controlledScale = std::min(std::max(this->controlledScale, minScale), maxScale);
+    this->scale = std::min(std::max(this->scale, minScale), maxScale);
+    return *this;
+}
+
+DynamicResolution& DynamicResolution::setGains(float proportionalGain, float integralGain, float derivativeGain) {
+    this->proportionalGain = proportionalGain;
+    this->integralGain = integralGain;
+    this->derivativeGain = derivativeGain;
+    return *this;
+}
+
+void DynamicResolution::reset() {
+    this->controlledScale = this->maxScale;
+    this->scale = this->maxScale;
+    this->previousError = 0.0f;
+    this->secondPreviousError = 0.0f;
+}
+
+} // namespace ge
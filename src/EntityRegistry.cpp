@@ -0,0 +1,144 @@
+#include <game_engine/EntityRegistry.h>
+
+namespace ge {
+
+void EntityRegistry::destroyEntity(Entity entity) {
+    if (!this->isAlive(entity)) return;
+
+    auto &record = this->records[entity.index];
+    auto movedEntity = record.archetype->swapRemove(record.row);
+    if (movedEntity.isValid()) {
+        this->records[movedEntity.index].row = record.row;
+    }
+
+    record.archetype = nullptr;
+    ++record.generation;
+    this->freeIndices.push_back(entity.index);
+    --this->numEntities;
+}
+
+bool EntityRegistry::isAlive(Entity entity) const {
+    return entity.index < this->records.size() &&
+            this->records[entity.index].generation == entity.generation &&
+            this->records[entity.index].archetype != nullptr;
+}
+
+void EntityRegistry::clear() {
+    for (std::uint32_t index = 0; index < this->records.size(); ++index) {
+        this->destroyEntity({index, this->records[index].generation});
+    }
+}
+
+Entity EntityRegistry::allocateEntity(Archetype *archetype) {
+    Entity entity;
+    if (this->freeIndices.empty()) {
+        entity.index = static_cast<std::uint32_t>(this->records.size());
+        this->records.emplace_back();
+    } else {
+        entity.index = this->freeIndices.back();
+        this->freeIndices.pop_back();
+    }
+
+    auto &record = this->records[entity.index];
+    entity.generation = record.generation;
+    record.archetype = archetype;
+    record.row = archetype->pushBack(entity);
+
+    ++this->numEntities;
+    return entity;
+}
+
+const EntityRegistry::EntityRecord& EntityRegistry::getRecord(Entity entity) const {
+    if (!this->isAlive(entity)) {
+        throw Error("Entity " + std::to_string(entity.index) + " is not alive");
+    }
+
+    return this->records[entity.index];
+}
+
+Archetype* EntityRegistry::getArchetype(const ComponentMask &mask) {
+    auto &archetype = this->archetypes[mask];
+    if (!archetype) {
+        archetype = std::make_unique<Archetype>(mask);
+        this->archetypeList.push_back(archetype.get());
+    }
+
+    return archetype.get();
+}
+
+Archetype* EntityRegistry::getArchetypeWith(Archetype *source, ComponentTypeId typeId) {
+    auto archetype = source->getAddEdge(typeId);
+    if (!archetype) {
+        archetype = this->getArchetype(ComponentMask(source->getMask()).set(typeId));
+        source->setAddEdge(typeId, archetype);
+        archetype->setRemoveEdge(typeId, source);
+    }
+
+    return archetype;
+}
+
+Archetype* EntityRegistry::getArchetypeWithout(Archetype *source, ComponentTypeId typeId) {
+    auto archetype = source->getRemoveEdge(typeId);
+    if (!archetype) {
+        archetype = this->getArchetype(ComponentMask(source->getMask()).reset(typeId));
+        source->setRemoveEdge(typeId, archetype);
+        archetype->setAddEdge(typeId, source);
+    }
+
+    return archetype;
+}
+
+size_t EntityRegistry::moveEntity(Entity entity, Archetype *destination) {
+    auto &record = this->records[entity.index];
+    auto source = record.archetype;
+    const auto sourceRow = record.row;
+
+    const auto destinationRow = destination->pushBack(entity);
+
+    // Move the components shared by both archetypes
+    const auto sharedMask = source->getMask() & destination->getMask();
+    for (ComponentTypeId typeId = 0; typeId < MAX_COMPONENT_TYPES; ++typeId) {
+        if (!sharedMask.test(typeId)) continue;
+
+        ComponentRegistry::getInfo(typeId).moveConstruct(destination->getComponent(typeId, destinationRow),
+                                                         source->getComponent(typeId, sourceRow));
+    }
+
+    // Destroys the (moved-from) source components and fills the hole
+    auto movedEntity = source->swapRemove(sourceRow);
+    if (movedEntity.isValid()) {
+        this->records[movedEntity.index].row = sourceRow;
+    }
+
+    record.archetype = destination;
+    record.row = destinationRow;
+    return destinationRow;
+}
+
+const std::vector<Archetype*>& EntityRegistry::getMatchingArchetypes(const ComponentMask &mask) {
+    std::lock_guard<std::mutex> lock(this->queryCachesMutex);
+
+    // Only check archetypes created since the last time this query ran
+    auto &cache = this->queryCaches[mask];
+    for (; cache.numArchetypesChecked < this->archetypeList.size(); ++cache.numArchetypesChecked) {
+        auto archetype = this->archetypeList[cache.numArchetypesChecked];
+        if ((archetype->getMask() & mask) == mask) {
+            cache.archetypes.push_back(archetype);
+        }
+    }
+
+    return cache.archetypes;
+}
+
+std::vector<EntityRegistry::ChunkRef> EntityRegistry::getMatchingChunks(const ComponentMask &mask) {
+    std::vector<ChunkRef> chunks;
+    for (auto archetype : this->getMatchingArchetypes(mask)) {
+        for (size_t chunkIdx = 0; chunkIdx < archetype->getNumChunks(); ++chunkIdx) {
+            chunks.push_back({archetype, chunkIdx});
+        }
+    }
+
+    return chunks;
+}
+
+} // namespace ge
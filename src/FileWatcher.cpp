@@ -0,0 +1,114 @@
+#include <game_engine/FileWatcher.h>
+
+#include <iostream>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace {
+
+std::string getDirectory(const std::string &filepath) {
+    const auto filenameIndex = filepath.find_last_of('/');
+    return filenameIndex == std::string::npos ? std::string(".") : filepath.substr(0, filenameIndex);
+}
+
+} // namespace
+#endif
+
+namespace ge {
+
+constexpr std::chrono::milliseconds FileWatcher::POLL_INTERVAL;
+
+FileWatcher::FileWatcher() {
+#ifdef __linux__
+    this->inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (this->inotifyFd < 0) {
+        std::cerr << "Failed to initialize inotify, polling watched files instead\n";
+    }
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+    if (this->inotifyFd >= 0) close(this->inotifyFd);
+#endif
+}
+
+void FileWatcher::watch(const std::vector<std::string> &filepaths) {
+    for (const auto &filepath : filepaths) {
+        if (!this->watchedFiles.emplace(filepath, getStatus(filepath)).second) continue;
+
+#ifdef __linux__
+        const auto directory = getDirectory(filepath);
+        if (this->inotifyFd < 0 || !this->directories.insert(directory).second) continue;
+
+        // Files are often replaced rather than written to, so watch their directory
+        const auto watchDescriptor = inotify_add_watch(this->inotifyFd, directory.c_str(),
+                                                       IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (watchDescriptor < 0) {
+            std::cerr << "Failed to watch directory: " << directory << "\n";
+            continue;
+        }
+        this->watchedDirectories[watchDescriptor] = directory;
+#endif
+    }
+}
+
+std::vector<std::string> FileWatcher::poll() {
+    std::set<std::string> changedFiles;
+
+#ifdef __linux__
+    if (this->inotifyFd >= 0) {
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = read(this->inotifyFd, buffer, sizeof(buffer))) > 0) {
+            for (auto event = buffer; event < buffer + length;) {
+                const auto &inotifyEvent = *reinterpret_cast<const inotify_event*>(event);
+                event += sizeof(inotify_event) + inotifyEvent.len;
+
+                auto directory = this->watchedDirectories.find(inotifyEvent.wd);
+                if (directory == this->watchedDirectories.end() || inotifyEvent.len == 0) continue;
+
+                const auto filepath = directory->second + "/" + inotifyEvent.name;
+                auto watchedFile = this->watchedFiles.find(filepath);
+                if (watchedFile == this->watchedFiles.end()) continue;
+
+                watchedFile->second = getStatus(filepath);
+                changedFiles.insert(filepath);
+            }
+        }
+
+        return {changedFiles.begin(), changedFiles.end()};
+    }
+#endif
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - this->lastPollTime < POLL_INTERVAL) return {};
+    this->lastPollTime = now;
+
+    for (auto &watchedFile : this->watchedFiles) {
+        const auto status = getStatus(watchedFile.first);
+        if (status.modificationTime == watchedFile.second.modificationTime &&
+                status.size_bytes == watchedFile.second.size_bytes) continue;
+
+        watchedFile.second = status;
+
+        // Deleted files are reported once they are written again
+        if (status.size_bytes >= 0) changedFiles.insert(watchedFile.first);
+    }
+
+    return {changedFiles.begin(), changedFiles.end()};
+}
+
+FileWatcher::FileStatus FileWatcher::getStatus(const std::string &filepath) {
+    struct stat status;
+    if (stat(filepath.c_str(), &status) != 0) return {};
+
+    return {status.st_mtime, static_cast<long long>(status.st_size)};
+}
+
+} // namespace ge
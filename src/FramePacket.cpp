@@ -0,0 +1,39 @@
+#include <game_engine/FramePacket.h>
+
+#include <game_engine/Mesh.h>
+#include <game_engine/Skybox.h>
+#include <game_engine/Texture2D.h>
+
+namespace ge {
+
+void FramePacket::reset() {
+    for (auto &drawItem : this->drawList) {
+        this->pendingReleases.push_back(std::move(drawItem.meshes));
+    }
+    this->drawList.clear();
+
+    for (auto &terrainBatch : this->terrainBatches) {
+        this->pendingReleases.push_back(std::move(terrainBatch.terrain));
+    }
+    this->terrainBatches.clear();
+
+    for (auto &particleBatch : this->particleBatches) {
+        if (particleBatch.texture) this->pendingReleases.push_back(std::move(particleBatch.texture));
+    }
+    this->particleBatches.clear();
+
+    if (this->skybox) {
+        this->pendingReleases.push_back(std::move(this->skybox));
+        this->skybox.reset();
+    }
+}
+
+void FramePacket::releaseResources() {
+    this->drawList.clear();
+    this->terrainBatches.clear();
+    this->particleBatches.clear();
+    this->skybox.reset();
+    this->pendingReleases.clear();
+}
+
+} // namespace ge
@@ -0,0 +1,47 @@
+#include <game_engine/Frustum.h>
+
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+namespace ge {
+
+Frustum::Frustum(const glm::mat4 &viewProjectionMatrix) {
+    // Gribb-Hartmann extraction from the rows of the matrix
+    auto row = [&viewProjectionMatrix](int i) {
+        return glm::vec4(viewProjectionMatrix[0][i], viewProjectionMatrix[1][i],
+                         viewProjectionMatrix[2][i], viewProjectionMatrix[3][i]);
+    };
+
+    this->planes = {row(3) + row(0), row(3) - row(0),
+                    row(3) + row(1), row(3) - row(1),
+                    row(3) + row(2), row(3) - row(2)};
+
+    for (auto &plane : this->planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+}
+
+bool Frustum::intersects(const BoundingSphere &sphere) const {
+    if (sphere.isEmpty()) return false;
+
+    for (const auto &plane : this->planes) {
+        if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius) return false;
+    }
+
+    return true;
+}
+
+bool Frustum::intersects(const glm::vec3 &boxMin, const glm::vec3 &boxMax) const {
+    for (const auto &plane : this->planes) {
+        // Test the corner farthest along the plane normal
+        const glm::vec3 corner(plane.x >= 0.0f ? boxMax.x : boxMin.x,
+                               plane.y >= 0.0f ? boxMax.y : boxMin.y,
+                               plane.z >= 0.0f ? boxMax.z : boxMin.z);
+        if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) return false;
+    }
+
+    return true;
+}
+
+} // namespace ge
@@ -1,23 +1,58 @@
 #include <game_engine/Game.h>
 
+#include <algorithm>
+#include <cmath>
+#include <exception>
 #include <iostream>
 #include <memory>
+#include <thread>
 
 #include <glm/mat4x4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 #include <game_engine/CameraNav.h>
+#include <game_engine/Components.h>
 #include <game_engine/Exception.h>
+#include <game_engine/InstancingGameObjects.h>
+#include <game_engine/Mesh.h>
+#include <game_engine/Skeleton.h>
 
 namespace {
 const std::string matricesUboName = "Matrices";
+const std::string bonesUboName = "Bones";
 const auto mat4Size_bytes = sizeof(glm::mat4);
+
+/// Units 0 to 3 hold the material textures, and the skin or vertex animation data.
+constexpr int specularMapTextureUnit = 4;
+constexpr int ambientOcclusionTextureUnit = 5;
+
+/// Units 6 and 7 hold the imposter atlases.
+constexpr int materialsTextureUnit = 8;
+
+const std::string irradianceShNames[] = {
+    "irradianceSh[0]", "irradianceSh[1]", "irradianceSh[2]", "irradianceSh[3]", "irradianceSh[4]",
+    "irradianceSh[5]", "irradianceSh[6]", "irradianceSh[7]", "irradianceSh[8]"
+};
+
+constexpr GLenum sceneDepthFormat = GL_DEPTH_COMPONENT24;
+constexpr GLenum sceneVelocityFormat = GL_RG16F;
+
+/// Value of the constant spherical harmonics basis function.
+constexpr float shConstantBasis = 0.282095f;
+
+glm::mat4 calculateViewMatrix(const glm::mat4 &camWorldTransform) {
+    const auto camPosition = glm::vec3(camWorldTransform[3]);
+    return glm::lookAt(camPosition, camPosition + glm::vec3(camWorldTransform[0]), glm::vec3(camWorldTransform[2]));
+}
 } // namespace
 
 namespace ge {
 
 int Game::glContextMajorVersion = 3;
 int Game::glContextMinorVersion = 3;
+bool Game::renderThreadEnabled = true;
+bool Game::hotReloadEnabled = false;
 
 std::unique_ptr<Game> Game::New(unsigned int windowWidth, unsigned int windowHeight,
                                 const std::string &windowTitle) {
@@ -25,6 +60,9 @@ std::unique_ptr<Game> Game::New(unsigned int windowWidth, unsigned int windowHei
     game->init();
     game->loadWorld();
 
+    // Finish building the shaders created by the game before the first frame
+    ShaderProgram::prewarm();
+
     return game;
 }
 
@@ -62,18 +100,58 @@ Game::Game(unsigned int windowWidth, unsigned int windowHeight, const std::strin
     glViewport(0, 0, this->frameBufferWidth, this->frameBufferHeight);
 
     // Set up shaders
-    this->defaultShader = std::make_unique<ShaderProgram>("shaders/default.vert",
-                                                          "shaders/default.frag");
+    this->defaultShaders = std::make_unique<ShaderVariants>("shaders/default.vert",
+                                                            "shaders/default.frag", "",
+                                                            std::vector<std::string>{"INSTANCING",
+                                                                                     "SPECULAR_MAP",
+                                                                                     "SKINNING",
+                                                                                     "VERTEX_ANIMATION",
+                                                                                     "DEPTH_ONLY",
+                                                                                     "IMPOSTER"});
     this->skyboxShader = std::make_unique<ShaderProgram>("shaders/skybox.vert",
                                                          "shaders/skybox.frag");
-
-    this->matricesUbo = std::make_unique<UniformBuffer>(2 * mat4Size_bytes);
-    this->defaultShader->setUniformBlockBinding(matricesUboName, this->matricesUbo->getBindingPoint());
+    this->terrainRenderer = std::make_unique<TerrainRenderer>("shaders/terrain.vert",
+                                                              "shaders/terrain.frag");
+    this->particleRenderer = std::make_unique<ParticleRenderer>("shaders/particle.vert",
+                                                                "shaders/particle.frag");
+    this->renderTargetPool = std::make_unique<RenderTargetPool>();
+    this->renderGraph = std::make_unique<RenderGraph>(this->renderTargetPool.get());
+    this->postProcessor = std::make_unique<PostProcessor>("shaders/post.vert", "shaders/taa.frag",
+                                                          "shaders/bloom.frag", "shaders/tonemap.frag",
+                                                          "shaders/upscale.frag");
+    this->ambientOcclusion = std::make_unique<AmbientOcclusion>("shaders/post.vert", "shaders/ssao.frag",
+                                                                "shaders/ssao_blur.frag");
+
+    // View, projection and previous view projection matrices, and the jitter padded to a vec4
+    this->matricesUbo = std::make_unique<UniformBuffer>(3 * mat4Size_bytes + sizeof(glm::vec4));
+    this->defaultShaders->setUniformBlockBinding(matricesUboName, this->matricesUbo->getBindingPoint());
     this->skyboxShader->setUniformBlockBinding(matricesUboName, this->matricesUbo->getBindingPoint());
+    this->terrainRenderer->getShader().setUniformBlockBinding(matricesUboName, this->matricesUbo->getBindingPoint());
+    this->particleRenderer->getShader().setUniformBlockBinding(matricesUboName, this->matricesUbo->getBindingPoint());
+
+    // Keep the resource manager and material registry alive for as long as the game
+    this->resourceManager = ResourceManager::getInstance();
+    this->materialRegistry = MaterialRegistry::getInstance();
+
+    if (hotReloadEnabled) {
+        this->hotReloader = std::make_unique<HotReloader>(this->resourceManager);
+    }
+
+    this->bonesUbo = std::make_unique<UniformBuffer>(Skeleton::MAX_BONES * mat4Size_bytes);
+    this->defaultShaders->setUniformBlockBinding(bonesUboName, this->bonesUbo->getBindingPoint());
+
+    // Build the variants used by the draw list up front
+    this->defaultShaders->getVariant(0);
+    this->defaultShaders->getVariant(DEFAULT_SHADER_SPECULAR_MAP);
+    this->defaultShaders->getVariant(DEFAULT_SHADER_DEPTH_ONLY);
+    ShaderProgram::prewarm();
+
+    // Setup input
+    this->input = std::make_unique<Input>(this->window.get());
 
     // Setup camera
-    this->cam = std::make_unique<CameraNav>(45.0f, static_cast<float>(this->frameBufferWidth) / this->frameBufferHeight,
-                                            0.1f, 1000.0f);
+    this->setCam(std::make_unique<CameraNav>(45.0f, static_cast<float>(this->frameBufferWidth) / this->frameBufferHeight,
+                                             0.1f, 1000.0f));
 
     // Setup directional light
     this->directionalLight = std::make_unique<DirectionalLight>(
@@ -85,102 +163,499 @@ Game::Game(unsigned int windowWidth, unsigned int windowHeight, const std::strin
 
 void Game::init() {
     glEnable(GL_DEPTH_TEST);
+
+    // Filter mipmapped cubemaps across the edges of their faces
+    glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
 }
 
 void Game::loadWorld() {}
 
 void Game::startGameLoop() {
+    if (renderThreadEnabled) {
+        this->runMultiThreadedGameLoop();
+    } else {
+        this->runSingleThreadedGameLoop();
+    }
+}
+
+void Game::runSingleThreadedGameLoop() {
     while (!glfwWindowShouldClose(this->window.get())) {
-        // Calculate update duration
-        auto currentUpdateTime = std::chrono::system_clock::now();
-        auto updateDuration = currentUpdateTime - this->lastUpdateTime;
-        this->lastUpdateTime = currentUpdateTime;
+        this->simulateFrame();
 
-        this->update(updateDuration);
-        this->render();
+        this->framePackets.consume();
+        this->renderFrame(this->framePackets.getReadBuffer());
 
-        glfwSwapBuffers(this->window.get());
         glfwPollEvents();
     }
 }
 
+void Game::runMultiThreadedGameLoop() {
+    // Hand the GL context over to the render thread
+    glfwMakeContextCurrent(nullptr);
+    this->framePackets.open();
+
+    std::exception_ptr renderException;
+    std::thread renderThread([this, &renderException]{
+        glfwMakeContextCurrent(this->window.get());
+
+        try {
+            while (this->framePackets.waitAndConsume()) {
+                this->renderFrame(this->framePackets.getReadBuffer());
+            }
+        } catch (...) {
+            renderException = std::current_exception();
+            glfwSetWindowShouldClose(this->window.get(), true);
+
+            // Unblock the simulation waiting for this thread to take its packet
+            this->framePackets.close();
+        }
+
+        glfwMakeContextCurrent(nullptr);
+    });
+
+    auto stopRenderThread = [this, &renderThread]{
+        this->framePackets.close();
+        renderThread.join();
+        glfwMakeContextCurrent(this->window.get());
+    };
+
+    try {
+        // GLFW requires events to be processed on the main thread
+        while (!glfwWindowShouldClose(this->window.get())) {
+            glfwPollEvents();
+            this->simulateFrame();
+        }
+    } catch (...) {
+        stopRenderThread();
+        throw;
+    }
+
+    stopRenderThread();
+
+    if (renderException) {
+        std::rethrow_exception(renderException);
+    }
+}
+
+void Game::simulateFrame() {
+    // Calculate update duration
+    auto currentUpdateTime = std::chrono::system_clock::now();
+    auto updateDuration = currentUpdateTime - this->lastUpdateTime;
+    this->lastUpdateTime = currentUpdateTime;
+
+    this->update(updateDuration);
+
+    auto &framePacket = this->framePackets.getWriteBuffer();
+    framePacket.reset();
+    this->buildFramePacket(framePacket);
+
+    // Stay at most one frame ahead of the render thread, which is paced by the swap
+    // interval, rather than building packets that are dropped unrendered
+    this->framePackets.waitAndPublish();
+}
+
+void Game::renderFrame(FramePacket &framePacket) {
+    std::vector<std::function<void()>> commands;
+    {
+        std::lock_guard<std::mutex> lock(this->renderCommandsMutex);
+        commands.swap(this->renderCommands);
+    }
+
+    for (auto &command : commands) {
+        command();
+    }
+
+    // Swap reloaded resources in between frames
+    if (this->hotReloader) {
+        this->hotReloader->update();
+    }
+
+    this->render(framePacket);
+    glfwSwapBuffers(this->window.get());
+
+    framePacket.releaseResources();
+}
+
 void Game::update(std::chrono::duration<float> updateDuration) {
+    this->input->dispatchEvents();
+
     this->cam->onUpdate(updateDuration);
 
     for (auto &gameObject : this->worldList) {
         gameObject->onUpdate(updateDuration);
+        gameObject->updateAnimation(updateDuration);
     }
-}
 
-void Game::render() {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    this->systemScheduler.run(this->entityRegistry, updateDuration);
 
-    auto viewMatrix = this->cam->getViewMatrix();
-    this->matricesUbo->bufferSubData(0, mat4Size_bytes, glm::value_ptr(viewMatrix))
-            .bufferSubData(mat4Size_bytes, mat4Size_bytes, glm::value_ptr(this->cam->getProjectionMatrix()));
+    for (const auto &particleSystem : this->particleSystems) {
+        particleSystem->update(updateDuration);
+    }
 
-    this->defaultShader->use();
+    this->cam->updateSceneGraph(this->sceneGraph);
+    for (const auto &gameObject : this->worldList) {
+        gameObject->updateSceneGraph(this->sceneGraph);
+    }
 
-    // Render light
-    this->defaultShader->setUniform("viewPosition", this->cam->getPosition());
-    this->directionalLight->render(this->defaultShader.get());
+    // Stream around the camera as of the previous update, so that loaded cells are
+    // placed by this scene graph update. The camera is copied, since adding and removing
+    // scene nodes moves the world transforms.
+    if (this->worldStreamer) {
+        const auto camWorldTransform = this->sceneGraph.getWorldTransform(this->cam->getSceneNode());
+        this->worldStreamer->update(this->sceneGraph, glm::vec3(camWorldTransform[3]), glm::vec3(camWorldTransform[0]),
+                                    [this](std::function<void()> command){
+            this->runOnRenderThread(std::move(command));
+        });
+    }
 
-    // Render world list
-    for (auto &gameObject : this->worldList) {
-        gameObject->render(this->defaultShader.get());
+    this->sceneGraph.update();
+
+    if (this->terrainStreamer) {
+        const auto &camWorldTransform = this->sceneGraph.getWorldTransform(this->cam->getSceneNode());
+        this->terrainStreamer->update(glm::vec3(camWorldTransform[3]));
+    }
+}
+
+void Game::buildFramePacket(FramePacket &framePacket) {
+    framePacket.frameBufferWidth = this->frameBufferWidth;
+    framePacket.frameBufferHeight = this->frameBufferHeight;
+
+    // The camera may be attached to another game object, so view from its world transform
+    const auto &camWorldTransform = this->sceneGraph.getWorldTransform(this->cam->getSceneNode());
+    framePacket.viewMatrix = calculateViewMatrix(camWorldTransform);
+    framePacket.projectionMatrix = this->cam->getProjectionMatrix();
+    framePacket.viewPosition = glm::vec3(camWorldTransform[3]);
+
+    // Motion is measured from the camera of the previous packet
+    framePacket.previousViewMatrix = calculateViewMatrix(
+                this->sceneGraph.getPreviousWorldTransform(this->cam->getSceneNode()));
+    framePacket.previousProjectionMatrix = this->previousProjectionMatrix;
+    this->previousProjectionMatrix = framePacket.projectionMatrix;
+
+    framePacket.directionalLight.direction = this->directionalLight->getLookAtDirection();
+    framePacket.directionalLight.ambient = this->directionalLight->getAmbient();
+    framePacket.directionalLight.diffuse = this->directionalLight->getDiffuse();
+    framePacket.directionalLight.specular = this->directionalLight->getSpecular();
+
+    for (const auto &gameObject : this->worldList) {
+        gameObject->addToFramePacket(this->sceneGraph, framePacket);
+    }
+
+    if (this->worldStreamer) this->worldStreamer->addToFramePacket(this->sceneGraph, framePacket);
+
+    addEntitiesToFramePacket(this->entityRegistry, framePacket);
+
+    for (const auto &terrain : this->terrains) {
+        terrain->addToFramePacket(framePacket);
     }
+    if (this->terrainStreamer) this->terrainStreamer->addToFramePacket(framePacket);
 
-    // Render skybox
-    if (this->skybox) {
-        glDepthFunc(GL_LEQUAL);
-        this->matricesUbo->bufferSubData(0, mat4Size_bytes, glm::value_ptr(glm::mat4(glm::mat3(viewMatrix))));
-        this->skyboxShader->use();
-        this->skybox->render(this->skyboxShader.get());
-        glDepthFunc(GL_LESS);
+    for (const auto &particleSystem : this->particleSystems) {
+        particleSystem->addToFramePacket(framePacket);
     }
+
+    framePacket.skybox = this->skybox;
 }
 
-void Game::frameBufferSizeCallback(GLFWwindow *window, int width, int height) {
-    this->frameBufferWidth = width;
-    this->frameBufferHeight = height;
-    glViewport(0, 0, width, height);
-    this->cam->setAspectRatioWidthToHeight(static_cast<float>(width) / height);
+void Game::render(const FramePacket &framePacket) {
+    this->materialRegistry->uploadChanges();
+
+    // The framebuffer is empty while the window is minimized
+    const auto width = std::max(framePacket.frameBufferWidth, 1);
+    const auto height = std::max(framePacket.frameBufferHeight, 1);
+
+    // The scene is upscaled to the framebuffer by the post processor
+    const auto scale = this->dynamicResolution.getScale();
+    const auto sceneWidth = std::max(static_cast<int>(std::round(width * scale)), 1);
+    const auto sceneHeight = std::max(static_cast<int>(std::round(height * scale)), 1);
+
+    // Temporal anti-aliasing accumulates the scene rendered with a different sub-pixel
+    // offset every frame, and reprojects it with the velocities of the pixels
+    const auto temporalAntiAliasing = this->postProcessor->isPassEnabled(PostProcessor::TEMPORAL_ANTI_ALIASING);
+    const auto jitter = this->postProcessor->getJitter(sceneWidth, sceneHeight);
+    const auto projectionMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(jitter, 0.0f)) *
+            framePacket.projectionMatrix;
+    const auto previousViewProjectionMatrix = framePacket.previousProjectionMatrix * framePacket.previousViewMatrix;
+
+    this->matricesUbo->bufferSubData(0, mat4Size_bytes, glm::value_ptr(framePacket.viewMatrix))
+            .bufferSubData(mat4Size_bytes, mat4Size_bytes, glm::value_ptr(projectionMatrix))
+            .bufferSubData(2 * mat4Size_bytes, mat4Size_bytes, glm::value_ptr(previousViewProjectionMatrix))
+            .bufferSubData(3 * mat4Size_bytes, sizeof(glm::vec2), glm::value_ptr(jitter));
+
+    auto &graph = *this->renderGraph;
+    const auto backbuffer = graph.importBackbuffer("backbuffer", width, height);
+    const auto matrices = graph.importResource("matrices");
+    const auto scene = graph.createRenderTarget("scene", {sceneWidth, sceneHeight, PostProcessor::sceneFormat,
+                                                          sceneDepthFormat,
+                                                          temporalAntiAliasing ? sceneVelocityFormat : 0});
+
+    this->addRenderPasses(framePacket, scene, matrices, projectionMatrix);
+    this->postProcessor->addPasses(&graph, scene, backbuffer);
+
+    graph.execute();
+    this->renderTargetPool->endFrame();
+
+    this->dynamicResolution.update(graph.getFrameTime_ms());
 }
 
-void Game::keyCallback(GLFWwindow *window, int key, int scancode, int action, int mods) {
-    if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
-        glfwSetWindowShouldClose(this->window.get(), true);
+void Game::addRenderPasses(const FramePacket &framePacket, RenderGraph::Resource scene,
+                           RenderGraph::Resource matrices, const glm::mat4 &projectionMatrix) {
+    auto &graph = *this->renderGraph;
+
+    // Ambient occlusion is computed from the depth of the opaque surfaces before they are
+    // shaded, so they are drawn in a depth pre-pass first, which also saves shading the
+    // hidden surfaces
+    const auto ambientOcclusionEnabled = this->ambientOcclusion->isEnabled();
+    auto reads = std::vector<RenderGraph::Resource>{matrices};
+    RenderGraph::Resource ambientOcclusion = 0;
+    if (ambientOcclusionEnabled) {
+        graph.addPass("depth prepass", {matrices}, {scene}, [this, &framePacket]{
+            glClear(GL_DEPTH_BUFFER_BIT);
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            this->renderDrawList(framePacket, true);
+            this->renderOpaque(framePacket, true);
+            this->terrainRenderer->render(framePacket);
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        });
+
+        const auto temporal = this->postProcessor->isPassEnabled(PostProcessor::TEMPORAL_ANTI_ALIASING);
+        ambientOcclusion = this->ambientOcclusion->addPasses(&graph, scene, projectionMatrix, temporal);
+        reads.push_back(ambientOcclusion);
     }
 
-    this->cam->keyCallback(window, key, action, mods);
+    const auto &sceneDesc = graph.getDesc(scene);
+    const auto hasVelocities = sceneDesc.velocityFormat != 0;
+    const auto sceneUvScale = 1.0f / glm::vec2(sceneDesc.width, sceneDesc.height);
+    graph.addPass("opaque", reads, {scene}, [this, &framePacket, hasVelocities, ambientOcclusionEnabled,
+                                             ambientOcclusion, sceneUvScale]{
+        if (ambientOcclusionEnabled) {
+            // Surfaces are drawn again with the depths of the pre-pass
+            glClear(GL_COLOR_BUFFER_BIT);
+            glDepthFunc(GL_LEQUAL);
+
+            glActiveTexture(GL_TEXTURE0 + ambientOcclusionTextureUnit);
+            glBindTexture(GL_TEXTURE_2D, this->renderGraph->getRenderTarget(ambientOcclusion).getColorTexture());
+            glActiveTexture(GL_TEXTURE0);
+            this->ambientOcclusionUvScale = sceneUvScale;
+        } else {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        }
+
+        if (hasVelocities) {
+            const GLfloat noVelocity[] = {0.0f, 0.0f, 0.0f, 0.0f};
+            glClearBufferfv(GL_COLOR, 1, noVelocity);
+        }
+        this->renderDrawList(framePacket);
+        this->renderOpaque(framePacket, false);
+
+        auto &terrainShader = this->terrainRenderer->getShader();
+        terrainShader.use();
+        this->setAmbientOcclusionUniforms(&terrainShader);
+        this->terrainRenderer->render(framePacket);
+
+        if (ambientOcclusionEnabled) {
+            this->ambientOcclusionUvScale = glm::vec2(0.0f);
+            glActiveTexture(GL_TEXTURE0 + ambientOcclusionTextureUnit);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            glActiveTexture(GL_TEXTURE0);
+            glDepthFunc(GL_LESS);
+        }
+    });
+
+    if (framePacket.skybox) {
+        // Drawn behind the opaque world, with the translation removed from the view
+        graph.addPass("skybox", {matrices}, {scene, matrices}, [this, &framePacket]{
+            const auto previousViewProjectionMatrix = framePacket.previousProjectionMatrix *
+                    framePacket.previousViewMatrix;
+            const auto skyboxPreviousViewProjectionMatrix = framePacket.previousProjectionMatrix *
+                    glm::mat4(glm::mat3(framePacket.previousViewMatrix));
+
+            glDepthFunc(GL_LEQUAL);
+            this->matricesUbo->bufferSubData(0, mat4Size_bytes,
+                                             glm::value_ptr(glm::mat4(glm::mat3(framePacket.viewMatrix))))
+                    .bufferSubData(2 * mat4Size_bytes, mat4Size_bytes,
+                                   glm::value_ptr(skyboxPreviousViewProjectionMatrix));
+            this->skyboxShader->use();
+            framePacket.skybox->render(this->skyboxShader.get());
+            glDepthFunc(GL_LESS);
+            this->matricesUbo->bufferSubData(0, mat4Size_bytes, glm::value_ptr(framePacket.viewMatrix))
+                    .bufferSubData(2 * mat4Size_bytes, mat4Size_bytes, glm::value_ptr(previousViewProjectionMatrix));
+        });
+    }
 
-    for (auto &gameObject : this->worldList) {
-        gameObject->keyCallback(window, scancode, action, mods);
+    // Particles are blended over the opaque world
+    graph.addPass("particles", {matrices}, {scene}, [this, &framePacket]{
+        this->particleRenderer->render(framePacket.particleBatches);
+    });
+}
+
+void Game::renderDrawList(const FramePacket &framePacket, bool depthOnly) {
+    if (framePacket.skybox && !depthOnly) {
+        framePacket.skybox->bindSpecularMap(specularMapTextureUnit);
+    }
+
+    // Materials only select their parameters by ID, so texture arrays are rebound only
+    // when a mesh samples from different ones, and shader variants are switched only
+    // when a material needs other features.
+    ShaderProgram *shader = nullptr;
+    auto shaderFeatures = ShaderVariants::Features(0);
+    const TextureArray *boundDiffuseArray = nullptr;
+    const TextureArray *boundSpecularArray = nullptr;
+    for (const auto &drawItem : framePacket.drawList) {
+        auto modelUniformsSet = false;
+
+        if (drawItem.skinMatrices) {
+            this->bonesUbo->bufferSubData(0, drawItem.skinMatrices->size() * mat4Size_bytes,
+                                          drawItem.skinMatrices->data());
+        }
+
+        const auto &meshes = *drawItem.meshes;
+        for (auto i = drawItem.firstMesh; i < meshes.size() && i - drawItem.firstMesh < drawItem.numMeshes; ++i) {
+            const auto &mesh = meshes[i];
+            const auto &material = *mesh->getMaterial();
+
+            auto features = depthOnly ? DEFAULT_SHADER_DEPTH_ONLY
+                                      : (material.hasSpecularTexture() ? DEFAULT_SHADER_SPECULAR_MAP : 0u);
+            if (drawItem.skinMatrices && mesh->isSkinned()) features |= DEFAULT_SHADER_SKINNING;
+
+            if (!shader || features != shaderFeatures) {
+                if (depthOnly) {
+                    shader = &this->defaultShaders->getVariant(features);
+                    shader->use();
+                } else {
+                    shader = &this->useDefaultShader(features, framePacket);
+                }
+                shaderFeatures = features;
+                modelUniformsSet = false;
+            }
+
+            if (!modelUniformsSet) {
+                shader->setUniform("model", drawItem.modelMatrix)
+                        .setUniform("normal", drawItem.normalMatrix)
+                        .setUniform("previousModel", drawItem.previousModelMatrix);
+                modelUniformsSet = true;
+            }
+
+            if (depthOnly) {
+                mesh->draw();
+                continue;
+            }
+
+            shader->setUniform("materialId", static_cast<int>(material.getId()));
+
+            const auto diffuseArray = &material.getDiffuseTexture().getArray();
+            if (diffuseArray != boundDiffuseArray) {
+                glActiveTexture(GL_TEXTURE0);
+                diffuseArray->bind();
+                boundDiffuseArray = diffuseArray;
+            }
+
+            const auto specularArray = &material.getSpecularTexture().getArray();
+            if (specularArray != boundSpecularArray) {
+                glActiveTexture(GL_TEXTURE1);
+                specularArray->bind();
+                boundSpecularArray = specularArray;
+            }
+
+            mesh->draw();
+        }
     }
+    glActiveTexture(GL_TEXTURE0);
 }
 
-void Game::cursorPositionCallback(GLFWwindow *window, double x, double y) {
-    this->cam->cursorPositionCallback(window, x, y);
+void Game::renderOpaque(const FramePacket &, bool) {}
 
-    for (auto &gameObject : this->worldList) {
-        gameObject->cursorPositionCallback(window, x, y);
+void Game::renderInstancing(InstancingGameObjects *gameObjects, const FramePacket &framePacket, bool depthOnly) {
+    auto features = ShaderVariants::Features(DEFAULT_SHADER_INSTANCING);
+    if (gameObjects->hasVertexAnimations()) {
+        features |= DEFAULT_SHADER_VERTEX_ANIMATION;
+    } else if (gameObjects->getSkeleton()) {
+        features |= DEFAULT_SHADER_SKINNING;
+    }
+
+    // Instances share one draw per mesh, so highlights are sampled for every material
+    features |= depthOnly ? DEFAULT_SHADER_DEPTH_ONLY : DEFAULT_SHADER_SPECULAR_MAP;
+
+    const auto viewProjectionMatrix = framePacket.projectionMatrix * framePacket.viewMatrix;
+    auto &shader = this->useDefaultShader(features, framePacket);
+    gameObjects->render(&shader, viewProjectionMatrix, framePacket.viewPosition);
+
+    // Imposters move their depth onto the baked surface in both passes, so the opaque
+    // pass shades them with the depths of the pre-pass and ambient occlusion sees them
+    if (gameObjects->hasImposters()) {
+        const auto imposterFeatures = DEFAULT_SHADER_INSTANCING | DEFAULT_SHADER_IMPOSTER |
+                (depthOnly ? DEFAULT_SHADER_DEPTH_ONLY : 0u);
+        auto &imposterShader = this->useDefaultShader(imposterFeatures, framePacket);
+        gameObjects->renderImposters(&imposterShader, viewProjectionMatrix, framePacket.viewPosition);
     }
 }
 
-void Game::mouseButtonCallback(GLFWwindow *window, int button, int action, int mods) {
-    this->cam->mouseButtonCallback(window, button, action, mods);
+ShaderProgram& Game::useDefaultShader(ShaderVariants::Features features,
+                                      const FramePacket &framePacket) {
+    auto &shader = this->defaultShaders->getVariant(features);
+    shader.use();
+
+    const auto &light = framePacket.directionalLight;
+    this->materialRegistry->bind(materialsTextureUnit);
+    shader.setUniform("materials", materialsTextureUnit)
+            .setUniform("diffuseTextures", 0)
+            .setUniform("specularTextures", 1)
+            .setUniform("viewPosition", framePacket.viewPosition)
+            .setUniform("directionalLight.direction", light.direction)
+            .setUniform("directionalLight.lighting.diffuse", light.diffuse)
+            .setUniform("directionalLight.lighting.specular", light.specular);
+
+    // Ambient light comes from the skybox if there is one
+    const auto &skybox = framePacket.skybox;
+    ShCoefficients irradianceSh {};
+    if (skybox) {
+        irradianceSh = skybox->getIrradianceSh();
+    } else {
+        irradianceSh[0] = light.ambient / shConstantBasis;
+    }
 
-    for (auto &gameObject : this->worldList) {
-        gameObject->mouseButtonCallback(window, button, action, mods);
+    for (size_t i = 0; i < irradianceSh.size(); ++i) {
+        shader.setUniform(irradianceShNames[i], irradianceSh[i]);
     }
+
+    shader.setUniform("hasSpecularMap", skybox != nullptr)
+            .setUniform("specularMap", specularMapTextureUnit)
+            .setUniform("maxSpecularMapLevel", skybox ? static_cast<float>(skybox->getNumSpecularMapLevels() - 1) : 0.0f);
+    this->setAmbientOcclusionUniforms(&shader);
+
+    return shader;
 }
 
-void Game::scrollCallback(GLFWwindow *window, double xOffset, double yOffset) {
-    this->cam->scrollCallback(window, xOffset, yOffset);
+void Game::setAmbientOcclusionUniforms(ShaderProgram *shader) const {
+    shader->setUniform("ambientOcclusionEnabled", this->ambientOcclusionUvScale != glm::vec2(0.0f))
+            .setUniform("ambientOcclusionTexture", ambientOcclusionTextureUnit)
+            .setUniform("ambientOcclusionUvScale", this->ambientOcclusionUvScale);
+}
 
-    for (auto &gameObject : this->worldList) {
-        gameObject->scrollCallback(window, xOffset, yOffset);
+void Game::frameBufferSizeCallback(GLFWwindow *, int width, int height) {
+    this->frameBufferWidth = width;
+    this->frameBufferHeight = height;
+    this->cam->setAspectRatioWidthToHeight(static_cast<float>(width) / height);
+}
+
+void Game::keyCallback(GLFWwindow *, int key, int, int action, int mods) {
+    if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
+        glfwSetWindowShouldClose(this->window.get(), true);
     }
+
+    this->input->pushKeyEvent(key, action, mods);
+}
+
+void Game::cursorPositionCallback(GLFWwindow *, double x, double y) {
+    this->input->pushCursorPositionEvent(x, y);
+}
+
+void Game::mouseButtonCallback(GLFWwindow *, int button, int action, int mods) {
+    this->input->pushMouseButtonEvent(button, action, mods);
+}
+
+void Game::scrollCallback(GLFWwindow *, double xOffset, double yOffset) {
+    this->input->pushScrollEvent(xOffset, yOffset);
 }
 
 GLFWwindow* Game::getWindow() {return this->window.get();}
@@ -189,12 +664,80 @@ void Game::bindMatricesUbo(ShaderProgram *shader) {
     shader->setUniformBlockBinding(matricesUboName, this->matricesUbo->getBindingPoint());
 }
 
+void Game::runOnRenderThread(std::function<void()> command) {
+    std::lock_guard<std::mutex> lock(this->renderCommandsMutex);
+    this->renderCommands.push_back(std::move(command));
+}
+
 void Game::pushBackInWorldList(std::shared_ptr<GameObject> gameObject) {
+    gameObject->addToSceneGraph(this->sceneGraph);
     this->worldList.push_back(std::move(gameObject));
 }
 
+void Game::setWorldStreamer(std::unique_ptr<WorldStreamer> worldStreamer) {
+    if (this->worldStreamer) {
+        this->worldStreamer->releaseCells(this->sceneGraph, [this](std::function<void()> command){
+            this->runOnRenderThread(std::move(command));
+        });
+    }
+    this->worldStreamer = std::move(worldStreamer);
+}
+
+void Game::addTerrain(std::shared_ptr<Terrain> terrain) {
+    this->terrains.push_back(std::move(terrain));
+}
+
+void Game::removeTerrain(const std::shared_ptr<Terrain> &terrain) {
+    this->terrains.erase(std::remove(this->terrains.begin(), this->terrains.end(), terrain),
+                         this->terrains.end());
+}
+
+void Game::setTerrainStreamer(std::unique_ptr<TerrainStreamer> terrainStreamer) {
+    this->terrainStreamer = std::move(terrainStreamer);
+}
+
+void Game::addParticleSystem(std::shared_ptr<ParticleSystem> particleSystem) {
+    this->particleSystems.push_back(std::move(particleSystem));
+}
+
+void Game::removeParticleSystem(const std::shared_ptr<ParticleSystem> &particleSystem) {
+    this->particleSystems.erase(std::remove(this->particleSystems.begin(), this->particleSystems.end(),
+                                            particleSystem),
+                                this->particleSystems.end());
+}
+
+Game::InputCallbackSubscriptions Game::subscribeToInputCallbacks(const std::shared_ptr<GameObject> &gameObject) {
+    auto window = this->input->getWindow();
+    std::weak_ptr<GameObject> weakGameObject = gameObject;
+
+    InputCallbackSubscriptions subscriptions;
+    subscriptions[0] = this->input->subscribeKey(Input::ANY, [weakGameObject, window](int key, int action, int mods){
+        if (auto gameObject = weakGameObject.lock()) gameObject->keyCallback(window, key, action, mods);
+    });
+
+    subscriptions[1] = this->input->subscribeMouseButton(Input::ANY, [weakGameObject, window](int button, int action,
+                                                                                             int mods){
+        if (auto gameObject = weakGameObject.lock()) gameObject->mouseButtonCallback(window, button, action, mods);
+    });
+
+    subscriptions[2] = this->input->subscribeCursorPosition([weakGameObject, window](double cursorX, double cursorY){
+        if (auto gameObject = weakGameObject.lock()) gameObject->cursorPositionCallback(window, cursorX, cursorY);
+    });
+
+    subscriptions[3] = this->input->subscribeScroll([weakGameObject, window](double xOffset, double yOffset){
+        if (auto gameObject = weakGameObject.lock()) gameObject->scrollCallback(window, xOffset, yOffset);
+    });
+
+    return subscriptions;
+}
+
 void Game::setCam(std::unique_ptr<Camera> cam) {
+    if (this->cam) this->cam->removeFromSceneGraph(this->sceneGraph);
+
     this->cam = std::move(cam);
+    this->cam->addToSceneGraph(this->sceneGraph);
+    this->previousProjectionMatrix = this->cam->getProjectionMatrix();
+    this->cam->subscribeToInput(*this->input);
 }
 
 Camera* Game::getCam() {return this->cam.get();}
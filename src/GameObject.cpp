@@ -1,90 +1,217 @@
 #include <game_engine/GameObject.h>
 
 #include <iostream>
-#include <unordered_map>
+#include <limits>
 
-#include <assimp/Importer.hpp>
-#include <assimp/postprocess.h>
 #include <assimp/scene.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
 #include <glm/mat4x4.hpp>
+#include <glm/matrix.hpp>
 
+#include <game_engine/AnimationClip.h>
+#include <game_engine/Animator.h>
 #include <game_engine/Exception.h>
+#include <game_engine/FramePacket.h>
+#include <game_engine/Material.h>
 #include <game_engine/Mesh.h>
+#include <game_engine/ModelImport.h>
+#include <game_engine/ResourceManager.h>
 #include <game_engine/ShaderProgram.h>
+#include <game_engine/Skeleton.h>
+#include <game_engine/Texture2D.h>
 
 namespace {
 
 using Meshes = std::vector<std::unique_ptr<ge::Mesh>>;
-
-std::unordered_map<std::string, std::weak_ptr<Meshes>> cachedMeshes;
+using ModelNodes = ge::GameObject::ModelNodes;
 
 ///
-/// \brief loadMeshes Loads and caches mesh data from model file.
+/// \brief The LoadedModel struct holds the meshes, node hierarchy and animations of a
+/// model file, so that they are cached and released together.
 ///
-/// Mesh caches will automatically be cleaned up as the last
-/// reference to the returned shared_ptr<Meshes> is destroyed.
+struct LoadedModel {
+    Meshes meshes;
+    ModelNodes nodes;
+    std::shared_ptr<const ge::Skeleton> skeleton;
+    ge::GameObject::AnimationClips animationClips;
+};
+
 ///
-/// \param modelFilepath Absolute filepath to the model data.
-/// \return Shared pointer to the model data (meshes).
-/// \exception ge::LoadError Failed to load mesh data from model file.
-/// \exception ge::LoadError Failed to load texture image from file.
+/// \brief The StreamedModel struct holds a model file read by ge::GameObject::importModel()
+/// and the decoded images of its textures.
 ///
-std::shared_ptr<Meshes> loadMeshes(const std::string &modelFilepath);
-void processNode(Meshes *meshes, const aiNode &node, const aiScene &scene, const std::string &modelDirectory);
+struct StreamedModel {
+    std::shared_ptr<const ge::ImportedModel> importedModel;
+    std::vector<std::shared_ptr<const void>> decodedTextures;
+};
+
+using Materials = std::vector<std::shared_ptr<ge::Material>>;
+
+void processNodes(LoadedModel *model, const aiScene &scene, const std::string &modelDirectory) {
+    Materials materials(scene.mNumMaterials);
+
+    // Traverse the hierarchy breadth-first, so that the nodes are stored in the
+    // order expected by ge::SceneGraph.
+    std::vector<const aiNode*> aiNodes {scene.mRootNode};
+    std::vector<size_t> parentIndices {0};
+    for (size_t i = 0; i < aiNodes.size(); ++i) {
+        const auto &aiNode = *aiNodes[i];
+
+        ge::GameObject::ModelNode node;
+        node.name = aiNode.mName.C_Str();
+        node.parent = parentIndices[i];
+        node.localTransform = glm::transpose(glm::make_mat4(&aiNode.mTransformation.a1));
+        node.firstMesh = model->meshes.size();
+        node.numMeshes = aiNode.mNumMeshes;
+        model->nodes.push_back(std::move(node));
 
-std::shared_ptr<Meshes> loadMeshes(const std::string &modelFilepath) {
-    auto modelFilenameIndex = modelFilepath.find_last_of('/');
-    const auto modelDirectory = modelFilepath.substr(0, modelFilenameIndex);
-    const auto modelFilename = modelFilepath.substr(modelFilenameIndex + 1);
+        // Process node's meshes.
+        for (unsigned int j = 0; j < aiNode.mNumMeshes; ++j) {
+            const auto mesh = scene.mMeshes[aiNode.mMeshes[j]];
 
-    // Check cached meshes to avoid reloading
-    auto meshes = cachedMeshes[modelFilename].lock();
-    if (meshes) return meshes;
+            // Meshes with the same material share it
+            auto &material = materials[mesh->mMaterialIndex];
+            if (!material) {
+                material = std::make_shared<ge::Material>(*scene.mMaterials[mesh->mMaterialIndex], modelDirectory);
+            }
 
-    // Load meshes from file
-    Assimp::Importer importer;
-    const auto scene = importer.ReadFile(modelFilepath,
-                                         aiProcess_Triangulate | aiProcess_FlipUVs);
+            model->meshes.push_back(std::make_unique<ge::Mesh>(*mesh, material, model->skeleton.get()));
+        }
 
-    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-        throw ge::LoadError(importer.GetErrorString());
+        for (unsigned int j = 0; j < aiNode.mNumChildren; ++j) {
+            aiNodes.push_back(aiNode.mChildren[j]);
+            parentIndices.push_back(i);
+        }
     }
+}
 
-    auto meshesDeleter = [modelFilename](auto meshes){
-        // Clear cache
-        cachedMeshes.erase(modelFilename);
-        delete meshes;
-    };
-    meshes = std::shared_ptr<Meshes>(new Meshes, meshesDeleter);
+std::shared_ptr<LoadedModel> loadModel(const std::string &modelFilepath) {
+    auto resourceManager = ge::ResourceManager::getInstance();
+
+    return resourceManager->load<LoadedModel>(ge::ResourceManager::MODEL, ge::ResourceManager::getKey(modelFilepath), [&]{
+        const auto modelDirectory = modelFilepath.substr(0, modelFilepath.find_last_of('/'));
+
+        // Load model from file, or use the model if it was already imported
+        const auto importedModel = ge::importModelFile(modelFilepath);
+        const auto &scene = *importedModel->scene;
+
+        auto model = std::make_shared<LoadedModel>();
+        if (ge::Skeleton::hasBones(scene)) {
+            const auto skeleton = std::make_shared<const ge::Skeleton>(scene);
+            model->animationClips = ge::AnimationClip::loadAnimationClips(scene, *skeleton);
+            model->skeleton = skeleton;
+        }
 
-    processNode(meshes.get(), *scene->mRootNode, *scene, modelDirectory);
+        processNodes(model.get(), scene, modelDirectory);
 
-    std::cout << "Successfully loaded model from file: " << modelFilepath << "\n";
-    cachedMeshes[modelFilename] = meshes;
-    return meshes;
+        std::cout << "Successfully loaded model from file: " << modelFilepath << "\n";
+        return ge::ResourceManager::Loaded<LoadedModel> {model, importedModel->meshGpuSize_bytes, {modelFilepath}};
+    });
 }
 
-void processNode(Meshes *meshes, const aiNode &node, const aiScene &scene, const std::string &modelDirectory) {
-    // Process node's meshes.
-    for (unsigned int i = 0; i < node.mNumMeshes; ++i) {
-        const auto mesh = scene.mMeshes[node.mMeshes[i]];
-        const auto material = scene.mMaterials[mesh->mMaterialIndex];
-        meshes->push_back(std::make_unique<ge::Mesh>(*mesh, *material, modelDirectory));
+///
+/// \brief reloadModel Replaces the meshes of a loaded model by those of a model file that
+///                    changed.
+/// \exception ge::LoadError The node hierarchy or meshes of the model file changed.
+///
+void reloadModel(LoadedModel *model, const aiScene &scene, const std::string &modelFilepath) {
+    const auto modelDirectory = modelFilepath.substr(0, modelFilepath.find_last_of('/'));
+    const auto layoutChanged = [&modelFilepath]() {
+        return ge::LoadError("Model at " + modelFilepath + " changed its nodes or meshes, restart to load it");
+    };
+
+    if (ge::Skeleton::hasBones(scene) != (model->skeleton != nullptr)) throw layoutChanged();
+
+    // Skin the new meshes with the skeleton the animators were created with
+    LoadedModel reloaded;
+    reloaded.skeleton = model->skeleton;
+    processNodes(&reloaded, scene, modelDirectory);
+
+    if (reloaded.nodes.size() != model->nodes.size()) throw layoutChanged();
+    for (size_t i = 0; i < model->nodes.size(); ++i) {
+        if (reloaded.nodes[i].firstMesh != model->nodes[i].firstMesh ||
+                reloaded.nodes[i].numMeshes != model->nodes[i].numMeshes) throw layoutChanged();
+    }
+    for (size_t i = 0; i < model->meshes.size(); ++i) {
+        if (reloaded.meshes[i]->isSkinned() != model->meshes[i]->isSkinned()) throw layoutChanged();
     }
 
-    // Recursively process children nodes.
-    for (unsigned int i = 0; i < node.mNumChildren; ++i) {
-        processNode(meshes, *node.mChildren[i], scene, modelDirectory);
+    for (size_t i = 0; i < model->meshes.size(); ++i) {
+        model->meshes[i]->swap(*reloaded.meshes[i]);
     }
+
+    std::cout << "Reloaded model from file: " << modelFilepath << "\n";
 }
 
 } // namespace
 
 namespace ge {
 
+std::shared_ptr<GameObject::Meshes> GameObject::loadMeshes(const std::string &modelFilepath) {
+    auto model = loadModel(modelFilepath);
+    return std::shared_ptr<Meshes>(model, &model->meshes);
+}
+
+std::shared_ptr<const GameObject::ModelNodes> GameObject::loadModelNodes(const std::string &modelFilepath) {
+    auto model = loadModel(modelFilepath);
+    return std::shared_ptr<const ModelNodes>(model, &model->nodes);
+}
+
+std::shared_ptr<const void> GameObject::importModel(const std::string &modelFilepath, size_t *gpuSize_bytes) {
+    auto resourceManager = ResourceManager::getInstance();
+    if (gpuSize_bytes) *gpuSize_bytes = 0;
+
+    if (resourceManager->isResident(ResourceManager::MODEL, ResourceManager::getKey(modelFilepath))) return nullptr;
+
+    auto model = std::make_shared<StreamedModel>();
+    model->importedModel = importModelFile(modelFilepath);
+    if (gpuSize_bytes) *gpuSize_bytes = model->importedModel->meshGpuSize_bytes;
+
+    const auto &scene = *model->importedModel->scene;
+    const auto modelDirectory = modelFilepath.substr(0, modelFilepath.find_last_of('/'));
+    for (unsigned int i = 0; i < scene.mNumMaterials; ++i) {
+        for (const auto type : {aiTextureType_DIFFUSE, aiTextureType_SPECULAR}) {
+            if (scene.mMaterials[i]->GetTextureCount(type) == 0) continue;
+
+            aiString imageFilename;
+            scene.mMaterials[i]->GetTexture(type, 0, &imageFilename);
+
+            size_t textureSize_bytes = 0;
+            auto texture = Texture2D::decode(modelDirectory + "/" + imageFilename.C_Str(), &textureSize_bytes);
+            if (texture) model->decodedTextures.push_back(std::move(texture));
+            if (gpuSize_bytes) *gpuSize_bytes += textureSize_bytes;
+        }
+    }
+
+    return model;
+}
+
+std::function<void()> GameObject::prepareReload(const std::string &filepath) {
+    auto resourceManager = ResourceManager::getInstance();
+    if (!resourceManager->isLoadedFrom(ResourceManager::MODEL, filepath)) return nullptr;
+
+    auto importedModel = readModelFile(filepath);
+
+    return [resourceManager, importedModel, filepath]() {
+        for (const auto &model : resourceManager->findLoadedFrom<LoadedModel>(ResourceManager::MODEL, filepath)) {
+            reloadModel(model.get(), *importedModel->scene, filepath);
+        }
+    };
+}
+
 GameObject::GameObject() : meshes(std::make_shared<Meshes>()) {}
-GameObject::GameObject(const std::string &modelFilepath) : meshes(loadMeshes(modelFilepath)) {}
+GameObject::GameObject(const std::string &modelFilepath) {
+    const auto model = loadModel(modelFilepath);
+    this->meshes = std::shared_ptr<Meshes>(model, &model->meshes);
+    this->modelNodes = std::shared_ptr<const ModelNodes>(model, &model->nodes);
+
+    if (model->skeleton) {
+        this->skeleton = model->skeleton;
+        this->animationClips = std::shared_ptr<const AnimationClips>(model, &model->animationClips);
+        this->animator = std::make_unique<Animator>(this->skeleton);
+    }
+}
 GameObject::GameObject(const std::vector<float> &positions,
                        const std::vector<float> &normals,
                        const std::vector<float> &textureCoords,
@@ -93,15 +220,47 @@ GameObject::GameObject(const std::vector<float> &positions,
     meshes->push_back(std::make_unique<ge::Mesh>(positions, normals, textureCoords, indices, textureFilepath));
 }
 
+GameObject::~GameObject() = default;
+
 void GameObject::onUpdate(std::chrono::duration<float> updateDuration) {}
 
+void GameObject::updateAnimation(std::chrono::duration<float> updateDuration) {
+    if (!this->animator) return;
+
+    this->animator->update(updateDuration);
+
+    // Frame packets in flight may still reference the previous skin matrices
+    auto skinMatrices = std::make_shared<std::vector<glm::mat4>>(this->skeleton->getNumBones());
+    this->animator->computeSkinMatrices(skinMatrices->data());
+    this->skinMatrices = std::move(skinMatrices);
+}
+
 void GameObject::render(ShaderProgram *shader) {
-    this->model.render(shader);
+    if (!this->modelNodes) {
+        this->model.render(shader);
+
+        for (const auto& mesh : *this->meshes) {
+            mesh->render(shader);
+        }
+        return;
+    }
+
+    // Parents come before their children, so their model matrices are always known
+    std::vector<glm::mat4> nodeModelMatrices(this->modelNodes->size());
+    for (size_t i = 0; i < this->modelNodes->size(); ++i) {
+        const auto &node = (*this->modelNodes)[i];
+        const auto parentModelMatrix = (i == 0) ? this->getModelMatrix() : nodeModelMatrices[node.parent];
+        nodeModelMatrices[i] = parentModelMatrix * node.localTransform;
+
+        if (node.numMeshes == 0) continue;
 
-    shader->setUniform("material.specularExponent", this->specularExponent);
+        shader->setUniform("model", nodeModelMatrices[i])
+                .setUniform("normal", glm::transpose(glm::inverse(glm::mat3(nodeModelMatrices[i]))))
+                .setUniform("previousModel", glm::mat4(0.0f));
 
-    for (const auto& mesh : *this->meshes) {
-        mesh->render(shader);
+        for (auto j = node.firstMesh; j < node.firstMesh + node.numMeshes; ++j) {
+            (*this->meshes)[j]->render(shader);
+        }
     }
 }
 
@@ -110,9 +269,109 @@ void GameObject::cursorPositionCallback(GLFWwindow *window, double cursorX, doub
 void GameObject::mouseButtonCallback(GLFWwindow *window, int button, int action, int mods) {}
 void GameObject::scrollCallback(GLFWwindow *window, double xOffset, double yOffset) {}
 
+void GameObject::setSpecularExponent(float specularExponent) {
+    for (const auto &mesh : *this->meshes) {
+        mesh->getMaterial()->setSpecularExponent(specularExponent);
+    }
+}
+
+float GameObject::getSpecularExponent() const {
+    if (this->meshes->empty()) return 64.0f;
+    return this->meshes->front()->getMaterial()->getSpecularExponent();
+}
+
 void GameObject::setMesh(std::unique_ptr<Mesh> mesh) {
     this->meshes->clear();
     this->meshes->push_back(std::move(mesh));
+    this->modelNodes.reset();
+
+    this->skeleton.reset();
+    this->animationClips.reset();
+    this->animator.reset();
+    this->skinMatrices.reset();
+}
+
+std::shared_ptr<const AnimationClip> GameObject::findAnimationClip(const std::string &name) const {
+    if (!this->animationClips) return nullptr;
+
+    for (const auto &clip : *this->animationClips) {
+        if (clip->getName() == name) return clip;
+    }
+
+    return nullptr;
+}
+
+void GameObject::addToSceneGraph(SceneGraph &sceneGraph, SceneGraph::Node parent) {
+    this->sceneNode = sceneGraph.createNode(parent, this->getModelMatrix());
+    this->modelSceneNodes.clear();
+
+    if (!this->modelNodes) return;
+
+    for (const auto &modelNode : *this->modelNodes) {
+        const auto parentNode = this->modelSceneNodes.empty() ?
+                    this->sceneNode : this->modelSceneNodes[modelNode.parent];
+        this->modelSceneNodes.push_back(sceneGraph.createNode(parentNode, modelNode.localTransform));
+    }
+}
+
+void GameObject::removeFromSceneGraph(SceneGraph &sceneGraph) {
+    if (sceneGraph.isValid(this->sceneNode)) {
+        sceneGraph.destroyNode(this->sceneNode);
+    }
+
+    this->sceneNode = SceneGraph::INVALID_NODE;
+    this->modelSceneNodes.clear();
+}
+
+void GameObject::updateSceneGraph(SceneGraph &sceneGraph) const {
+    sceneGraph.setLocalTransform(this->sceneNode, this->getModelMatrix());
+
+    // Joints are the model nodes in the same order
+    if (!this->animator || this->modelSceneNodes.size() != this->animator->getPose().size()) return;
+
+    const auto &pose = this->animator->getPose();
+    for (size_t i = 0; i < pose.size(); ++i) {
+        sceneGraph.setLocalTransform(this->modelSceneNodes[i], pose[i].toMatrix());
+    }
+}
+
+void GameObject::addToFramePacket(const SceneGraph &sceneGraph, FramePacket &framePacket) const {
+    if (!this->modelNodes || this->modelSceneNodes.size() != this->modelNodes->size()) {
+        framePacket.drawList.push_back({this->meshes,
+                                        sceneGraph.getWorldTransform(this->sceneNode),
+                                        sceneGraph.getWorldNormalMatrix(this->sceneNode),
+                                        0,
+                                        std::numeric_limits<size_t>::max(),
+                                        nullptr,
+                                        sceneGraph.getPreviousWorldTransform(this->sceneNode)});
+        return;
+    }
+
+    for (size_t i = 0; i < this->modelNodes->size(); ++i) {
+        const auto &modelNode = (*this->modelNodes)[i];
+        if (modelNode.numMeshes == 0) continue;
+
+        // Skin matrices already contain the transforms of the model nodes
+        const auto isSkinned = this->skinMatrices && (*this->meshes)[modelNode.firstMesh]->isSkinned();
+        const auto node = isSkinned ? this->sceneNode : this->modelSceneNodes[i];
+        framePacket.drawList.push_back({this->meshes,
+                                        sceneGraph.getWorldTransform(node),
+                                        sceneGraph.getWorldNormalMatrix(node),
+                                        modelNode.firstMesh,
+                                        modelNode.numMeshes,
+                                        isSkinned ? this->skinMatrices : nullptr,
+                                        sceneGraph.getPreviousWorldTransform(node)});
+    }
+}
+
+SceneGraph::Node GameObject::findSceneNode(const std::string &modelNodeName) const {
+    if (!this->modelNodes) return SceneGraph::INVALID_NODE;
+
+    for (size_t i = 0; i < this->modelSceneNodes.size(); ++i) {
+        if ((*this->modelNodes)[i].name == modelNodeName) return this->modelSceneNodes[i];
+    }
+
+    return SceneGraph::INVALID_NODE;
 }
 
 } // namespace ge
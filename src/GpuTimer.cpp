@@ -0,0 +1,48 @@
+#include <game_engine/GpuTimer.h>
+
+#include <glad/glad.h>
+
+namespace ge {
+
+constexpr size_t GpuTimer::NUM_QUERIES;
+
+GpuTimer::GpuTimer() {
+    glGenQueries(static_cast<GLsizei>(this->queries.size()), this->queries.data());
+}
+
+GpuTimer::~GpuTimer() {
+    glDeleteQueries(static_cast<GLsizei>(this->queries.size()), this->queries.data());
+}
+
+void GpuTimer::begin() {
+    if (this->numPendingQueries == NUM_QUERIES) {
+        this->readOldestQuery();
+    }
+
+    const auto query = (this->firstPendingQuery + this->numPendingQueries) % NUM_QUERIES;
+    glBeginQuery(GL_TIME_ELAPSED, this->queries[query]);
+}
+
+void GpuTimer::end() {
+    glEndQuery(GL_TIME_ELAPSED);
+    ++this->numPendingQueries;
+
+    while (this->numPendingQueries > 0) {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(this->queries[this->firstPendingQuery], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+
+        this->readOldestQuery();
+    }
+}
+
+void GpuTimer::readOldestQuery() {
+    GLuint64 elapsed_ns = 0;
+    glGetQueryObjectui64v(this->queries[this->firstPendingQuery], GL_QUERY_RESULT, &elapsed_ns);
+    this->elapsed_ms = static_cast<float>(elapsed_ns) / 1e6f;
+
+    this->firstPendingQuery = (this->firstPendingQuery + 1) % NUM_QUERIES;
+    --this->numPendingQueries;
+}
+
+} // namespace ge
@@ -0,0 +1,53 @@
+#include <game_engine/Heightmap.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <stb_image.h>
+
+#include <game_engine/Exception.h>
+
+namespace {
+
+constexpr float maxValue = 65535.0f;
+
+} // namespace
+
+namespace ge {
+
+Heightmap::Heightmap(const std::string &imageFilepath) {
+    int numChannels;
+    auto data = stbi_load_16(imageFilepath.c_str(), &this->width, &this->height, &numChannels, 1);
+
+    if (!data) {
+        throw ge::LoadError("Failed to load heightmap at: " + imageFilepath);
+    }
+
+    this->heights.assign(data, data + static_cast<size_t>(this->width) * this->height);
+    stbi_image_free(data);
+}
+
+Heightmap::Heightmap(std::vector<std::uint16_t> heights, int width, int height)
+    : heights(std::move(heights)), width(width), height(height) {}
+
+float Heightmap::getValue(int x, int y) const {
+    x = std::max(0, std::min(x, this->width - 1));
+    y = std::max(0, std::min(y, this->height - 1));
+    return this->heights[static_cast<size_t>(y) * this->width + x] / maxValue;
+}
+
+float Heightmap::sample(float u, float v) const {
+    const auto x = std::max(0.0f, std::min(u, 1.0f)) * (this->width - 1);
+    const auto y = std::max(0.0f, std::min(v, 1.0f)) * (this->height - 1);
+
+    const auto x0 = static_cast<int>(x);
+    const auto y0 = static_cast<int>(y);
+    const auto tx = x - x0;
+    const auto ty = y - y0;
+
+    const auto top = this->getValue(x0, y0) * (1.0f - tx) + this->getValue(x0 + 1, y0) * tx;
+    const auto bottom = this->getValue(x0, y0 + 1) * (1.0f - tx) + this->getValue(x0 + 1, y0 + 1) * tx;
+    return top * (1.0f - ty) + bottom * ty;
+}
+
+} // namespace ge
@@ -0,0 +1,96 @@
+#include <game_engine/HotReloader.h>
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+#include <game_engine/GameObject.h>
+#include <game_engine/InstancingGameObjects.h>
+#include <game_engine/JobSystem.h>
+#include <game_engine/ResourceManager.h>
+#include <game_engine/ShaderProgram.h>
+#include <game_engine/Texture2D.h>
+
+namespace ge {
+
+constexpr std::chrono::milliseconds HotReloader::WATCH_INTERVAL;
+
+HotReloader::HotReloader(std::shared_ptr<ResourceManager> resourceManager)
+    : resourceManager(std::move(resourceManager)) {
+    std::cout << "Hot reloading enabled, " << (this->fileWatcher.isUsingInotify() ? "watching" : "polling")
+              << " loaded files for changes.\n";
+}
+
+HotReloader::~HotReloader() {
+    // The commands of finished reloads must be destroyed on this thread
+    for (const auto &pendingReload : this->pendingReloads) {
+        pendingReload.second.wait();
+    }
+}
+
+void HotReloader::update() {
+    const auto now = std::chrono::steady_clock::now();
+    if (now - this->lastWatchTime >= WATCH_INTERVAL) {
+        this->lastWatchTime = now;
+        this->fileWatcher.watch(this->resourceManager->getFilepaths());
+        this->fileWatcher.watch(ShaderProgram::getFilepaths());
+    }
+
+    const auto changedFilepaths = this->fileWatcher.poll();
+    if (!changedFilepaths.empty()) {
+        ShaderProgram::reload(changedFilepaths);
+
+        for (const auto &filepath : changedFilepaths) {
+            this->startReload(filepath);
+        }
+    }
+
+    ShaderProgram::finishReloads();
+    this->finishReloads();
+}
+
+void HotReloader::startReload(const std::string &filepath) {
+    // Unreferenced resources are loaded from the file again when requested
+    this->resourceManager->releaseUnreferenced(filepath);
+
+    // A previous read of the file may finish after this one
+    this->pendingReloads.erase(std::remove_if(this->pendingReloads.begin(), this->pendingReloads.end(),
+                                              [&filepath](const auto &pendingReload){
+        return pendingReload.first == filepath;
+    }), this->pendingReloads.end());
+
+    auto commands = JobSystem::getInstance().submit([filepath]{
+        Commands commands;
+        for (const auto prepareReload : {&Texture2D::prepareReload, &GameObject::prepareReload,
+                                         &InstancingGameObjects::prepareReload}) {
+            auto command = prepareReload(filepath);
+            if (command) commands.push_back(std::move(command));
+        }
+        return commands;
+    });
+
+    this->pendingReloads.emplace_back(filepath, std::move(commands));
+}
+
+void HotReloader::finishReloads() {
+    for (auto pendingReload = this->pendingReloads.begin(); pendingReload != this->pendingReloads.end();) {
+        auto &commands = pendingReload->second;
+        if (commands.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++pendingReload;
+            continue;
+        }
+
+        try {
+            for (const auto &command : commands.get()) {
+                command();
+            }
+        } catch (std::exception &e) {
+            std::cerr << "Failed to reload " << pendingReload->first << ", keeping the previous version: "
+                      << e.what() << "\n";
+        }
+
+        pendingReload = this->pendingReloads.erase(pendingReload);
+    }
+}
+
+} // namespace ge
@@ -0,0 +1,225 @@
+#include <game_engine/Imposter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include <glad/glad.h>
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <game_engine/Exception.h>
+#include <game_engine/InstanceCuller.h>
+#include <game_engine/InstancingMesh.h>
+#include <game_engine/Material.h>
+#include <game_engine/ShaderProgram.h>
+
+namespace {
+
+/// Coarsest mip level of the atlases as a number of texels per view, smaller views would
+/// bleed into their neighbors.
+constexpr int minMipViewResolution_texels = 8;
+
+/// Units 0 to 5 hold the material textures, the skin or vertex animation data, the sky
+/// and the ambient occlusion.
+constexpr int albedoTextureUnit = 6;
+constexpr int normalDepthTextureUnit = 7;
+constexpr int materialsTextureUnit = 8;
+
+///
+/// \brief getViewDirection Returns the direction from the model's center towards the
+///                         camera of a view, mapping the views' grid onto the upper
+///                         hemisphere like the IMPOSTER feature of default.vert.
+///
+glm::vec3 getViewDirection(int x, int y, int numViewsPerSide) {
+    const auto gridPosition = (numViewsPerSide > 1) ?
+                glm::vec2(x, y) / static_cast<float>(numViewsPerSide - 1) * 2.0f - 1.0f : glm::vec2(0.0f);
+
+    glm::vec3 direction {0.5f * (gridPosition.x + gridPosition.y), 0.5f * (gridPosition.x - gridPosition.y), 0.0f};
+    direction.z = 1.0f - std::abs(direction.x) - std::abs(direction.y);
+    return glm::normalize(direction);
+}
+
+///
+/// \brief createAtlasTexture Allocates a mipmapped texture for the views of the model.
+///
+unsigned int createAtlasTexture(int size_texels, int maxLevel) {
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size_texels, size_texels, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+} // namespace
+
+namespace ge {
+
+Imposter::Imposter(const std::vector<std::unique_ptr<InstancingMesh>> &meshes, const BoundingSphere &boundingSphere,
+                   ShaderProgram *bakeShader, int numViewsPerSide, int viewResolution_texels)
+    : boundingSphere(boundingSphere), numViewsPerSide(std::max(numViewsPerSide, 1)) {
+    const auto atlasSize_texels = this->numViewsPerSide * viewResolution_texels;
+    const auto maxLevel = std::max(0, static_cast<int>(std::log2(viewResolution_texels / minMipViewResolution_texels)));
+    this->albedoTexture = createAtlasTexture(atlasSize_texels, maxLevel);
+    this->normalDepthTexture = createAtlasTexture(atlasSize_texels, maxLevel);
+
+    // Render into the atlases, keeping the bindings of the caller
+    GLint previousFramebuffer;
+    GLint previousViewport[4];
+    GLfloat previousClearColor[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, previousClearColor);
+    const auto depthTestEnabled = glIsEnabled(GL_DEPTH_TEST);
+
+    unsigned int framebuffer;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->albedoTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, this->normalDepthTexture, 0);
+    const GLenum drawBuffers[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glDrawBuffers(2, drawBuffers);
+
+    unsigned int depthRenderbuffer;
+    glGenRenderbuffers(1, &depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, atlasSize_texels, atlasSize_texels);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+
+    const auto status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer));
+        glDeleteRenderbuffers(1, &depthRenderbuffer);
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteTextures(1, &this->normalDepthTexture);
+        glDeleteTextures(1, &this->albedoTexture);
+        throw Error("Failed to create imposter atlases of " + std::to_string(atlasSize_texels) + "x" +
+                    std::to_string(atlasSize_texels) + ", framebuffer status " + std::to_string(status));
+    }
+
+    // Uncovered texels stay transparent, so that filtering weights colors by their coverage
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glViewport(0, 0, atlasSize_texels, atlasSize_texels);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // The materials may not have been uploaded yet if no frame was rendered
+    auto materialRegistry = MaterialRegistry::getInstance();
+    materialRegistry->uploadChanges();
+    materialRegistry->bind(materialsTextureUnit);
+    bakeShader->use();
+    bakeShader->setUniform("materials", materialsTextureUnit);
+
+    // Every view looks at the center of the sphere, which fits in it
+    const auto &center = boundingSphere.center;
+    const auto radius = boundingSphere.radius;
+    const auto projectionMatrix = glm::ortho(-radius, radius, -radius, radius, 0.0f, 2.0f * radius);
+
+    for (int y = 0; y < this->numViewsPerSide; ++y) {
+        for (int x = 0; x < this->numViewsPerSide; ++x) {
+            const auto direction = getViewDirection(x, y, this->numViewsPerSide);
+            const auto up = (std::abs(direction.z) > 0.999f) ? glm::vec3(0.0f, 1.0f, 0.0f)
+                                                             : glm::vec3(0.0f, 0.0f, 1.0f);
+            const auto viewMatrix = glm::lookAt(center + direction * radius, center, up);
+
+            glViewport(x * viewResolution_texels, y * viewResolution_texels,
+                       viewResolution_texels, viewResolution_texels);
+            bakeShader->setUniform("viewProjection", projectionMatrix * viewMatrix);
+            for (const auto &mesh : meshes) {
+                mesh->render(bakeShader, 1);
+            }
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer));
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+    glClearColor(previousClearColor[0], previousClearColor[1], previousClearColor[2], previousClearColor[3]);
+    if (!depthTestEnabled) glDisable(GL_DEPTH_TEST);
+    glDeleteRenderbuffers(1, &depthRenderbuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+
+    for (auto texture : {this->albedoTexture, this->normalDepthTexture}) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Quad facing the camera, oriented by the vertex shader
+    const float corners[] = {-1.0f, -1.0f, 0.0f,  1.0f, -1.0f, 0.0f,  1.0f, 1.0f, 0.0f,  -1.0f, 1.0f, 0.0f};
+    const unsigned int indices[] = {0, 1, 2, 0, 2, 3};
+
+    glGenVertexArrays(1, &this->vao);
+    glGenBuffers(1, &this->vbo);
+    glGenBuffers(1, &this->ebo);
+
+    glBindVertexArray(this->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, this->vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+Imposter::~Imposter() {
+    glDeleteBuffers(1, &this->ebo);
+    glDeleteBuffers(1, &this->vbo);
+    glDeleteVertexArrays(1, &this->vao);
+    glDeleteTextures(1, &this->normalDepthTexture);
+    glDeleteTextures(1, &this->albedoTexture);
+}
+
+void Imposter::setInstanceAttribs(const InstanceCuller &culler) {
+    glBindVertexArray(this->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, culler.getCulledInstanceBuffer());
+
+    // Model matrix in attributes 3 to 6, normal matrix in attributes 7 to 9
+    for (GLuint column = 0; column < 4; ++column) {
+        glEnableVertexAttribArray(3 + column);
+        glVertexAttribPointer(3 + column, 4, GL_FLOAT, GL_FALSE, InstanceCuller::INSTANCE_SIZE_BYTES,
+                              reinterpret_cast<GLvoid*>(column * sizeof(glm::vec4)));
+        glVertexAttribDivisor(3 + column, 1);
+    }
+    for (GLuint column = 0; column < 3; ++column) {
+        glEnableVertexAttribArray(7 + column);
+        glVertexAttribPointer(7 + column, 3, GL_FLOAT, GL_FALSE, InstanceCuller::INSTANCE_SIZE_BYTES,
+                              reinterpret_cast<GLvoid*>(sizeof(glm::mat4) + column * sizeof(glm::vec3)));
+        glVertexAttribDivisor(7 + column, 1);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void Imposter::render(ShaderProgram *shader, const InstanceCuller &culler) const {
+    const auto &center = this->boundingSphere.center;
+    shader->setUniform("imposterAlbedo", albedoTextureUnit)
+            .setUniform("imposterNormalDepth", normalDepthTextureUnit)
+            .setUniform("imposterBoundingSphere", center.x, center.y, center.z, this->boundingSphere.radius)
+            .setUniform("imposterNumViewsPerSide", static_cast<float>(this->numViewsPerSide));
+
+    glActiveTexture(GL_TEXTURE0 + albedoTextureUnit);
+    glBindTexture(GL_TEXTURE_2D, this->albedoTexture);
+    glActiveTexture(GL_TEXTURE0 + normalDepthTextureUnit);
+    glBindTexture(GL_TEXTURE_2D, this->normalDepthTexture);
+    glActiveTexture(GL_TEXTURE0);
+
+    glBindVertexArray(this->vao);
+    culler.drawElementsInstanced(6);
+    glBindVertexArray(0);
+}
+
+} // namespace ge
@@ -0,0 +1,380 @@
+#include <game_engine/Input.h>
+
+#include <algorithm>
+
+#include <game_engine/Exception.h>
+
+namespace ge {
+
+constexpr int Input::ANY;
+
+/// ----------------------------------------------------
+///          Nested Subscription Functions
+/// ----------------------------------------------------
+Input::Subscription::Subscription(Input *input, SubscriptionId id) : input(input), id(id) {}
+
+Input::Subscription::~Subscription() {
+    this->unsubscribe();
+}
+
+Input::Subscription::Subscription(Subscription &&other) noexcept
+    : input(other.input), id(other.id) {
+    other.input = nullptr;
+}
+
+Input::Subscription& Input::Subscription::operator=(Subscription &&other) noexcept {
+    if (this != &other) {
+        this->unsubscribe();
+        this->input = other.input;
+        this->id = other.id;
+        other.input = nullptr;
+    }
+
+    return *this;
+}
+
+void Input::Subscription::unsubscribe() {
+    if (this->input) {
+        this->input->unsubscribe(this->id);
+        this->input = nullptr;
+    }
+}
+
+/// ----------------------------------------------------
+///                  Input Functions
+/// ----------------------------------------------------
+Input::Input(GLFWwindow *window) : window(window) {}
+
+void Input::pushKeyEvent(int key, int action, int mods) {
+    std::lock_guard<std::mutex> lock(this->pendingEventsMutex);
+    this->pendingEvents.push_back({EventType::Key, key, action, mods, 0.0, 0.0});
+}
+
+void Input::pushMouseButtonEvent(int button, int action, int mods) {
+    std::lock_guard<std::mutex> lock(this->pendingEventsMutex);
+    this->pendingEvents.push_back({EventType::MouseButton, button, action, mods, 0.0, 0.0});
+}
+
+void Input::pushCursorPositionEvent(double cursorX, double cursorY) {
+    std::lock_guard<std::mutex> lock(this->pendingEventsMutex);
+
+    // Only the latest position of consecutive cursor movements matters
+    if (!this->pendingEvents.empty() && this->pendingEvents.back().type == EventType::CursorPosition) {
+        this->pendingEvents.back().x = cursorX;
+        this->pendingEvents.back().y = cursorY;
+    } else {
+        this->pendingEvents.push_back({EventType::CursorPosition, 0, 0, 0, cursorX, cursorY});
+    }
+}
+
+void Input::pushScrollEvent(double xOffset, double yOffset) {
+    std::lock_guard<std::mutex> lock(this->pendingEventsMutex);
+
+    // Accumulate consecutive scroll offsets
+    if (!this->pendingEvents.empty() && this->pendingEvents.back().type == EventType::Scroll) {
+        this->pendingEvents.back().x += xOffset;
+        this->pendingEvents.back().y += yOffset;
+    } else {
+        this->pendingEvents.push_back({EventType::Scroll, 0, 0, 0, xOffset, yOffset});
+    }
+}
+
+void Input::dispatchEvents() {
+    std::vector<Event> events;
+    {
+        std::lock_guard<std::mutex> lock(this->pendingEventsMutex);
+        events.swap(this->pendingEvents);
+    }
+
+    // Reset per frame state
+    this->keysPressed.reset();
+    this->keysReleased.reset();
+    this->mouseButtonsPressed.reset();
+    this->mouseButtonsReleased.reset();
+    this->scrollOffset = glm::dvec2(0.0);
+
+    const auto lastCursorPosition = this->cursorPosition;
+
+    for (auto &action : this->actions) {
+        action.second.wasPressed = false;
+        action.second.wasReleased = false;
+    }
+
+    for (const auto &event : events) {
+        this->dispatchEvent(event);
+    }
+
+    this->cursorDelta = this->cursorPosition - lastCursorPosition;
+}
+
+Input::Subscription Input::subscribeKey(int key, KeyCallback callback) {
+    if (!callback) throw Error("Cannot subscribe an empty key callback");
+
+    Subscriber subscriber {EventType::Key, key, "", std::move(callback), nullptr, nullptr, nullptr, nullptr};
+    return this->addSubscriber(std::move(subscriber));
+}
+
+Input::Subscription Input::subscribeMouseButton(int button, MouseButtonCallback callback) {
+    if (!callback) throw Error("Cannot subscribe an empty mouse button callback");
+
+    Subscriber subscriber {EventType::MouseButton, button, "", nullptr, std::move(callback), nullptr, nullptr, nullptr};
+    return this->addSubscriber(std::move(subscriber));
+}
+
+Input::Subscription Input::subscribeCursorPosition(CursorPositionCallback callback) {
+    if (!callback) throw Error("Cannot subscribe an empty cursor position callback");
+
+    Subscriber subscriber {EventType::CursorPosition, 0, "", nullptr, nullptr, std::move(callback), nullptr, nullptr};
+    return this->addSubscriber(std::move(subscriber));
+}
+
+Input::Subscription Input::subscribeScroll(ScrollCallback callback) {
+    if (!callback) throw Error("Cannot subscribe an empty scroll callback");
+
+    Subscriber subscriber {EventType::Scroll, 0, "", nullptr, nullptr, nullptr, std::move(callback), nullptr};
+    return this->addSubscriber(std::move(subscriber));
+}
+
+Input::Subscription Input::subscribeAction(const std::string &action, ActionCallback callback) {
+    if (!callback) throw Error("Cannot subscribe an empty callback to action " + action);
+
+    // Actions are dispatched while processing key/mouse button events
+    Subscriber subscriber {EventType::Key, 0, action, nullptr, nullptr, nullptr, nullptr, std::move(callback)};
+    return this->addSubscriber(std::move(subscriber));
+}
+
+Input& Input::mapKeyToAction(const std::string &action, int key) {
+    this->actions[action].keys.push_back(key);
+    this->keyActions[key].push_back(action);
+    return *this;
+}
+
+Input& Input::mapMouseButtonToAction(const std::string &action, int button) {
+    this->actions[action].mouseButtons.push_back(button);
+    this->mouseButtonActions[button].push_back(action);
+    return *this;
+}
+
+Input& Input::clearActionMappings(const std::string &action) {
+    auto actionState = this->actions.find(action);
+    if (actionState == this->actions.end()) return *this;
+
+    auto removeAction = [&action](std::vector<std::string> &actions) {
+        actions.erase(std::remove(actions.begin(), actions.end(), action), actions.end());
+    };
+
+    for (auto key : actionState->second.keys) {
+        removeAction(this->keyActions[key]);
+    }
+
+    for (auto button : actionState->second.mouseButtons) {
+        removeAction(this->mouseButtonActions[button]);
+    }
+
+    this->actions.erase(actionState);
+    return *this;
+}
+
+bool Input::hasActionMappings(const std::string &action) const {
+    auto actionState = this->actions.find(action);
+    return actionState != this->actions.cend() &&
+            (!actionState->second.keys.empty() || !actionState->second.mouseButtons.empty());
+}
+
+Input& Input::mapAxis(const std::string &axis, const std::string &positiveAction,
+                      const std::string &negativeAction) {
+    this->axes[axis] = {positiveAction, negativeAction};
+    return *this;
+}
+
+bool Input::isActionDown(const std::string &action) const {
+    auto actionState = this->actions.find(action);
+    return actionState != this->actions.cend() && actionState->second.isDown;
+}
+
+bool Input::wasActionPressed(const std::string &action) const {
+    auto actionState = this->actions.find(action);
+    return actionState != this->actions.cend() && actionState->second.wasPressed;
+}
+
+bool Input::wasActionReleased(const std::string &action) const {
+    auto actionState = this->actions.find(action);
+    return actionState != this->actions.cend() && actionState->second.wasReleased;
+}
+
+float Input::getAxis(const std::string &axis) const {
+    auto axisMapping = this->axes.find(axis);
+    if (axisMapping == this->axes.cend()) return 0.0f;
+
+    auto value = 0.0f;
+    if (this->isActionDown(axisMapping->second.positiveAction)) value += 1.0f;
+    if (this->isActionDown(axisMapping->second.negativeAction)) value -= 1.0f;
+    return value;
+}
+
+Input::Subscription Input::addSubscriber(Subscriber subscriber) {
+    const auto id = this->nextSubscriptionId++;
+
+    if (subscriber.actionCallback) {
+        this->actionSubscribers[subscriber.action].push_back(id);
+    } else {
+        switch (subscriber.type) {
+        case EventType::Key:
+            this->keySubscribers[subscriber.code].push_back(id);
+            break;
+
+        case EventType::MouseButton:
+            this->mouseButtonSubscribers[subscriber.code].push_back(id);
+            break;
+
+        case EventType::CursorPosition:
+            this->cursorPositionSubscribers.push_back(id);
+            break;
+
+        case EventType::Scroll:
+            this->scrollSubscribers.push_back(id);
+            break;
+        }
+    }
+
+    this->subscribers.emplace(id, std::move(subscriber));
+    return Subscription(this, id);
+}
+
+void Input::unsubscribe(SubscriptionId id) {
+    auto subscriber = this->subscribers.find(id);
+    if (subscriber == this->subscribers.end()) return;
+
+    auto removeId = [id](std::vector<SubscriptionId> &ids) {
+        ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+    };
+
+    if (subscriber->second.actionCallback) {
+        removeId(this->actionSubscribers[subscriber->second.action]);
+    } else {
+        switch (subscriber->second.type) {
+        case EventType::Key:
+            removeId(this->keySubscribers[subscriber->second.code]);
+            break;
+
+        case EventType::MouseButton:
+            removeId(this->mouseButtonSubscribers[subscriber->second.code]);
+            break;
+
+        case EventType::CursorPosition:
+            removeId(this->cursorPositionSubscribers);
+            break;
+
+        case EventType::Scroll:
+            removeId(this->scrollSubscribers);
+            break;
+        }
+    }
+
+    this->subscribers.erase(subscriber);
+}
+
+void Input::dispatchEvent(const Event &event) {
+    switch (event.type) {
+    case EventType::Key: {
+        if (isValidCode(event.code)) {
+            if (event.action == GLFW_PRESS) {
+                this->keysDown.set(static_cast<size_t>(event.code));
+                this->keysPressed.set(static_cast<size_t>(event.code));
+            } else if (event.action == GLFW_RELEASE) {
+                this->keysDown.reset(static_cast<size_t>(event.code));
+                this->keysReleased.set(static_cast<size_t>(event.code));
+            }
+        }
+
+        auto notify = [&event](Subscriber &subscriber) {
+            subscriber.keyCallback(event.code, event.action, event.mods);
+        };
+        if (event.code != ANY) this->notifySubscribers(this->keySubscribers[event.code], notify);
+        this->notifySubscribers(this->keySubscribers[ANY], notify);
+
+        auto actions = this->keyActions.find(event.code);
+        if (actions != this->keyActions.end()) this->updateActions(actions->second);
+        break;
+    }
+
+    case EventType::MouseButton: {
+        if (isValidCode(event.code)) {
+            if (event.action == GLFW_PRESS) {
+                this->mouseButtonsDown.set(static_cast<size_t>(event.code));
+                this->mouseButtonsPressed.set(static_cast<size_t>(event.code));
+            } else if (event.action == GLFW_RELEASE) {
+                this->mouseButtonsDown.reset(static_cast<size_t>(event.code));
+                this->mouseButtonsReleased.set(static_cast<size_t>(event.code));
+            }
+        }
+
+        auto notify = [&event](Subscriber &subscriber) {
+            subscriber.mouseButtonCallback(event.code, event.action, event.mods);
+        };
+        if (event.code != ANY) this->notifySubscribers(this->mouseButtonSubscribers[event.code], notify);
+        this->notifySubscribers(this->mouseButtonSubscribers[ANY], notify);
+
+        auto actions = this->mouseButtonActions.find(event.code);
+        if (actions != this->mouseButtonActions.end()) this->updateActions(actions->second);
+        break;
+    }
+
+    case EventType::CursorPosition:
+        this->cursorPosition = glm::dvec2(event.x, event.y);
+        this->notifySubscribers(this->cursorPositionSubscribers, [&event](Subscriber &subscriber) {
+            subscriber.cursorPositionCallback(event.x, event.y);
+        });
+        break;
+
+    case EventType::Scroll:
+        this->scrollOffset += glm::dvec2(event.x, event.y);
+        this->notifySubscribers(this->scrollSubscribers, [&event](Subscriber &subscriber) {
+            subscriber.scrollCallback(event.x, event.y);
+        });
+        break;
+    }
+}
+
+void Input::updateActions(const std::vector<std::string> &actions) {
+    // Copy since subscribers may change action mappings
+    const auto actionNames = actions;
+
+    for (const auto &actionName : actionNames) {
+        auto &action = this->actions[actionName];
+
+        const auto isDown =
+                std::any_of(action.keys.cbegin(), action.keys.cend(),
+                            [this](int key){return this->isKeyDown(key);}) ||
+                std::any_of(action.mouseButtons.cbegin(), action.mouseButtons.cend(),
+                            [this](int button){return this->isMouseButtonDown(button);});
+
+        if (isDown == action.isDown) continue;
+
+        action.isDown = isDown;
+        if (isDown) {
+            action.wasPressed = true;
+        } else {
+            action.wasReleased = true;
+        }
+
+        this->notifySubscribers(this->actionSubscribers[actionName], [isDown](Subscriber &subscriber) {
+            subscriber.actionCallback(isDown);
+        });
+    }
+}
+
+template<typename F>
+void Input::notifySubscribers(const std::vector<SubscriptionId> &ids, F &&notify) {
+    // Copy since callbacks may (un)subscribe
+    const auto subscriberIds = ids;
+
+    for (auto id : subscriberIds) {
+        auto subscriber = this->subscribers.find(id);
+        if (subscriber != this->subscribers.end()) {
+            notify(subscriber->second);
+        }
+    }
+}
+
+} // namespace ge
@@ -0,0 +1,549 @@
+#include <game_engine/InstanceCuller.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include <glad/glad.h>
+#include <glm/geometric.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <game_engine/Exception.h>
+#include <game_engine/Frustum.h>
+
+namespace {
+
+constexpr unsigned int LOG_LENGTH = 1024;
+constexpr unsigned int COMPUTE_GROUP_SIZE = 64;
+
+constexpr auto modelMatrixSize_bytes = sizeof(glm::mat4);
+constexpr auto normalMatrixSize_bytes = sizeof(glm::mat3);
+constexpr auto instanceDataSize_bytes = sizeof(glm::vec2);
+
+///
+/// \brief visibilityTestSource Tests an instance's bounding sphere against the frustum
+///                             exactly like BoundingSphere::transformed() and Frustum::intersects(),
+///                             and its distance like InstanceCuller::DistanceRange::contains().
+///
+const std::string visibilityTestSource = R"glsl(
+uniform vec4 frustumPlanes[6];
+uniform vec4 boundingSphere; // Center and radius in model space
+uniform vec3 viewPosition;
+uniform vec2 distanceRange;
+
+bool isVisible(mat4 model) {
+    vec3 center = vec3(model * vec4(boundingSphere.xyz, 1.0));
+    float viewDistance = distance(center, viewPosition);
+    if (viewDistance < distanceRange.x || viewDistance >= distanceRange.y) return false;
+
+    float scale = max(max(length(model[0].xyz), length(model[1].xyz)), length(model[2].xyz));
+    float radius = boundingSphere.w * scale;
+
+    for (int i = 0; i < 6; ++i) {
+        if (dot(frustumPlanes[i].xyz, center) + frustumPlanes[i].w < -radius) return false;
+    }
+    return true;
+}
+)glsl";
+
+const std::string transformFeedbackVertexSource = R"glsl(#version 330 core
+layout (location = 0) in mat4 instanceModel;
+layout (location = 4) in mat3 instanceNormal;
+layout (location = 7) in vec2 instanceData;
+
+out VS_OUT {
+    mat4 model;
+    mat3 normal;
+    vec2 data;
+    flat int visible;
+} vs_out;
+)glsl" + visibilityTestSource + R"glsl(
+void main(void) {
+    vs_out.model = instanceModel;
+    vs_out.normal = instanceNormal;
+    vs_out.data = instanceData;
+    vs_out.visible = isVisible(instanceModel) ? 1 : 0;
+}
+)glsl";
+
+const std::string transformFeedbackGeometrySource = R"glsl(#version 330 core
+layout (points) in;
+layout (points, max_vertices = 1) out;
+
+in VS_OUT {
+    mat4 model;
+    mat3 normal;
+    vec2 data;
+    flat int visible;
+} gs_in[];
+
+out mat4 culledModel;
+out mat3 culledNormal;
+out vec2 culledData;
+
+void main(void) {
+    // Only visible instances are captured
+    if (gs_in[0].visible != 0) {
+        culledModel = gs_in[0].model;
+        culledNormal = gs_in[0].normal;
+        culledData = gs_in[0].data;
+        EmitVertex();
+        EndPrimitive();
+    }
+}
+)glsl";
+
+const std::string computeSource = R"glsl(#version 430 core
+layout (local_size_x = 64) in;
+
+layout (std430, binding = 0) readonly buffer ModelMatrices {
+    float modelMatrices[];
+};
+
+layout (std430, binding = 1) readonly buffer NormalMatrices {
+    float normalMatrices[];
+};
+
+layout (std430, binding = 2) writeonly buffer CulledInstances {
+    float culledInstances[];
+};
+
+layout (std430, binding = 4) readonly buffer InstanceData {
+    float instanceData[];
+};
+
+layout (std430, binding = 3) buffer DrawCommand {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+uniform uint numInstances;
+uniform bool hasInstanceData;
+)glsl" + visibilityTestSource + R"glsl(
+void main(void) {
+    uint instance = gl_GlobalInvocationID.x;
+    if (instance >= numInstances) return;
+
+    mat4 model;
+    for (uint column = 0u; column < 4u; ++column) {
+        for (uint row = 0u; row < 4u; ++row) {
+            model[column][row] = modelMatrices[instance * 16u + column * 4u + row];
+        }
+    }
+
+    if (!isVisible(model)) return;
+
+    // Append the instance to the culled instances
+    uint culledInstance = atomicAdd(instanceCount, 1u) * 27u;
+    for (uint i = 0u; i < 16u; ++i) {
+        culledInstances[culledInstance + i] = modelMatrices[instance * 16u + i];
+    }
+    for (uint i = 0u; i < 9u; ++i) {
+        culledInstances[culledInstance + 16u + i] = normalMatrices[instance * 9u + i];
+    }
+    for (uint i = 0u; i < 2u; ++i) {
+        culledInstances[culledInstance + 25u + i] = hasInstanceData ? instanceData[instance * 2u + i] : 0.0;
+    }
+}
+)glsl";
+
+///
+/// \brief DrawElementsIndirectCommand Layout of the indirect draw command.
+///
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+///
+/// \brief attachShader Compiles a shader and attaches it to a program.
+/// \exception ge::BuildError Failed to compile the shader.
+///
+void attachShader(unsigned int program, unsigned int shaderType, const std::string &source) {
+    auto shader = glCreateShader(shaderType);
+    auto sourceStr = source.c_str();
+    glShaderSource(shader, 1, &sourceStr, nullptr);
+    glCompileShader(shader);
+
+    int success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        char compileLog[LOG_LENGTH];
+        glGetShaderInfoLog(shader, LOG_LENGTH, nullptr, compileLog);
+        glDeleteShader(shader);
+
+        std::stringstream errorMsg;
+        errorMsg << "Failed to compile instance culling shader\n" << compileLog;
+        throw ge::BuildError(errorMsg.str());
+    }
+
+    // The shader is deleted once it is detached
+    glAttachShader(program, shader);
+    glDeleteShader(shader);
+}
+
+///
+/// \brief linkProgram Links a program and detaches its shaders.
+/// \exception ge::BuildError Failed to link the program.
+///
+void linkProgram(unsigned int program) {
+    glLinkProgram(program);
+
+    GLuint shaders[2];
+    GLsizei numShaders = 0;
+    glGetAttachedShaders(program, 2, &numShaders, shaders);
+    for (GLsizei i = 0; i < numShaders; ++i) {
+        glDetachShader(program, shaders[i]);
+    }
+
+    int success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        char linkLog[LOG_LENGTH];
+        glGetProgramInfoLog(program, LOG_LENGTH, nullptr, linkLog);
+
+        std::stringstream errorMsg;
+        errorMsg << "Failed to link instance culling shaders\n" << linkLog;
+        throw ge::BuildError(errorMsg.str());
+    }
+}
+
+} // namespace
+
+namespace ge {
+
+constexpr size_t InstanceCuller::INSTANCE_SIZE_BYTES;
+constexpr size_t InstanceCuller::INSTANCE_DATA_OFFSET_BYTES;
+
+InstanceCuller::Backend InstanceCuller::getDefaultBackend() {
+    return GLAD_GL_VERSION_4_3 ? Backend::COMPUTE : Backend::TRANSFORM_FEEDBACK;
+}
+
+bool InstanceCuller::DistanceRange::contains(const glm::vec3 &position) const {
+    const auto distance = glm::distance(position, this->viewPosition);
+    return distance >= this->minDistance && distance < this->maxDistance;
+}
+
+std::vector<size_t> InstanceCuller::cullOnCpu(const std::vector<glm::mat4> &modelMatrices,
+                                              const BoundingSphere &boundingSphere,
+                                              const glm::mat4 &viewProjectionMatrix,
+                                              const DistanceRange &distanceRange) {
+    const Frustum frustum(viewProjectionMatrix);
+
+    std::vector<size_t> visibleInstances;
+    for (size_t i = 0; i < modelMatrices.size(); ++i) {
+        const auto sphere = boundingSphere.transformed(modelMatrices[i]);
+        if (distanceRange.contains(sphere.center) && frustum.intersects(sphere)) {
+            visibleInstances.push_back(i);
+        }
+    }
+
+    return visibleInstances;
+}
+
+InstanceCuller::InstanceCuller(size_t maxNumInstances, Backend backend)
+    : backend(backend), maxNumInstances(maxNumInstances) {
+    static_assert(INSTANCE_DATA_OFFSET_BYTES == modelMatrixSize_bytes + normalMatrixSize_bytes &&
+                  INSTANCE_SIZE_BYTES == INSTANCE_DATA_OFFSET_BYTES + instanceDataSize_bytes,
+                  "Culled instances must hold a mat4, a mat3 and a vec2.");
+
+    glGenBuffers(1, &this->culledInstanceBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, this->culledInstanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, maxNumInstances * INSTANCE_SIZE_BYTES, nullptr,
+                 backend == Backend::CPU ? GL_STREAM_DRAW : GL_STREAM_COPY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (backend == Backend::CPU) return;
+
+    this->program = glCreateProgram();
+    try {
+        if (backend == Backend::TRANSFORM_FEEDBACK) {
+            attachShader(this->program, GL_VERTEX_SHADER, transformFeedbackVertexSource);
+            attachShader(this->program, GL_GEOMETRY_SHADER, transformFeedbackGeometrySource);
+
+            const char *varyings[] = {"culledModel", "culledNormal", "culledData"};
+            glTransformFeedbackVaryings(this->program, 3, varyings, GL_INTERLEAVED_ATTRIBS);
+        } else {
+            attachShader(this->program, GL_COMPUTE_SHADER, computeSource);
+        }
+
+        linkProgram(this->program);
+    } catch (std::exception&) {
+        glDeleteProgram(this->program);
+        glDeleteBuffers(1, &this->culledInstanceBuffer);
+        throw;
+    }
+
+    if (backend == Backend::TRANSFORM_FEEDBACK) {
+        glGenVertexArrays(1, &this->vao);
+        glGenQueries(1, &this->query);
+
+        if (!GLAD_GL_VERSION_4_4) {
+            // Clears the culled instances past the captured ones, which are drawn too
+            const std::vector<unsigned char> zeros(maxNumInstances * INSTANCE_SIZE_BYTES, 0);
+            glGenBuffers(1, &this->zeroBuffer);
+            glBindBuffer(GL_COPY_READ_BUFFER, this->zeroBuffer);
+            glBufferData(GL_COPY_READ_BUFFER, static_cast<GLsizeiptr>(zeros.size()), zeros.data(), GL_STATIC_COPY);
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            return;
+        }
+    }
+
+    // The compute shader, or the query of the transform feedback, writes the number of
+    // visible instances into the draw command
+    const DrawElementsIndirectCommand drawCommand {0, 0, 0, 0, 0};
+    glGenBuffers(1, &this->drawCommandBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, this->drawCommandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(drawCommand), &drawCommand, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+InstanceCuller::~InstanceCuller() {
+    glDeleteBuffers(1, &this->drawCommandBuffer);
+    glDeleteBuffers(1, &this->zeroBuffer);
+    glDeleteQueries(1, &this->query);
+    glDeleteVertexArrays(1, &this->vao);
+    glDeleteProgram(this->program);
+    glDeleteBuffers(1, &this->culledInstanceBuffer);
+}
+
+void InstanceCuller::cull(unsigned int modelMatrixBuffer, unsigned int normalMatrixBuffer,
+                          unsigned int instanceDataBuffer, size_t numInstances,
+                          const BoundingSphere &boundingSphere, const glm::mat4 &viewProjectionMatrix,
+                          const DistanceRange &distanceRange) {
+    if (numInstances > this->maxNumInstances) {
+        throw Error("Cannot cull " + std::to_string(numInstances) + " instances, the maximum is " +
+                    std::to_string(this->maxNumInstances) + ".");
+    }
+
+    switch (this->backend) {
+    case Backend::CPU:
+        this->cullWithCpu(modelMatrixBuffer, normalMatrixBuffer, instanceDataBuffer, numInstances,
+                          boundingSphere, viewProjectionMatrix, distanceRange);
+        break;
+
+    case Backend::TRANSFORM_FEEDBACK:
+        this->setCullingUniforms(boundingSphere, viewProjectionMatrix, distanceRange);
+        this->cullWithTransformFeedback(modelMatrixBuffer, normalMatrixBuffer, instanceDataBuffer, numInstances);
+        break;
+
+    case Backend::COMPUTE:
+        this->setCullingUniforms(boundingSphere, viewProjectionMatrix, distanceRange);
+        this->cullWithCompute(modelMatrixBuffer, normalMatrixBuffer, instanceDataBuffer, numInstances);
+        break;
+    }
+}
+
+void InstanceCuller::drawElementsInstanced(unsigned int numIndices) const {
+    if (this->drawCommandBuffer != 0) {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, this->drawCommandBuffer);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, offsetof(DrawElementsIndirectCommand, count),
+                        sizeof(GLuint), &numIndices);
+        glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        return;
+    }
+
+    // Draw the count of the transform feedback if it is known without waiting, and
+    // every culled instance otherwise
+    auto numDrawnInstances = this->numDrawnInstances;
+    if (this->backend == Backend::TRANSFORM_FEEDBACK && numDrawnInstances > 0) {
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(this->query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            glGetQueryObjectuiv(this->query, GL_QUERY_RESULT, &numDrawnInstances);
+        }
+    }
+
+    if (numDrawnInstances == 0) return;
+
+    glDrawElementsInstanced(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, nullptr,
+                            numDrawnInstances);
+}
+
+size_t InstanceCuller::getNumVisibleInstances() const {
+    if (this->backend == Backend::CPU) return this->numVisibleInstances;
+
+    if (this->backend == Backend::TRANSFORM_FEEDBACK) {
+        if (this->numDrawnInstances == 0) return 0;
+
+        GLuint numVisibleInstances;
+        glGetQueryObjectuiv(this->query, GL_QUERY_RESULT, &numVisibleInstances);
+        return numVisibleInstances;
+    }
+
+    DrawElementsIndirectCommand drawCommand;
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, this->drawCommandBuffer);
+    glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(drawCommand), &drawCommand);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    return drawCommand.instanceCount;
+}
+
+void InstanceCuller::cullWithCpu(unsigned int modelMatrixBuffer, unsigned int normalMatrixBuffer,
+                                 unsigned int instanceDataBuffer, size_t numInstances,
+                                 const BoundingSphere &boundingSphere, const glm::mat4 &viewProjectionMatrix,
+                                 const DistanceRange &distanceRange) {
+    std::vector<glm::mat4> modelMatrices(numInstances);
+    glBindBuffer(GL_ARRAY_BUFFER, modelMatrixBuffer);
+    glGetBufferSubData(GL_ARRAY_BUFFER, 0, numInstances * modelMatrixSize_bytes, modelMatrices.data());
+
+    std::vector<glm::mat3> normalMatrices(numInstances);
+    glBindBuffer(GL_ARRAY_BUFFER, normalMatrixBuffer);
+    glGetBufferSubData(GL_ARRAY_BUFFER, 0, numInstances * normalMatrixSize_bytes, normalMatrices.data());
+
+    std::vector<glm::vec2> instanceData(numInstances);
+    if (instanceDataBuffer != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, instanceDataBuffer);
+        glGetBufferSubData(GL_ARRAY_BUFFER, 0, numInstances * instanceDataSize_bytes, instanceData.data());
+    }
+
+    const auto visibleInstances = cullOnCpu(modelMatrices, boundingSphere, viewProjectionMatrix, distanceRange);
+
+    std::vector<unsigned char> culledInstances(visibleInstances.size() * INSTANCE_SIZE_BYTES);
+    for (size_t i = 0; i < visibleInstances.size(); ++i) {
+        auto culledInstance = culledInstances.data() + i * INSTANCE_SIZE_BYTES;
+        std::memcpy(culledInstance, glm::value_ptr(modelMatrices[visibleInstances[i]]), modelMatrixSize_bytes);
+        std::memcpy(culledInstance + modelMatrixSize_bytes,
+                    glm::value_ptr(normalMatrices[visibleInstances[i]]), normalMatrixSize_bytes);
+        std::memcpy(culledInstance + INSTANCE_DATA_OFFSET_BYTES,
+                    glm::value_ptr(instanceData[visibleInstances[i]]), instanceDataSize_bytes);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, this->culledInstanceBuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, culledInstances.size(), culledInstances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    this->numVisibleInstances = static_cast<unsigned int>(visibleInstances.size());
+    this->numDrawnInstances = this->numVisibleInstances;
+}
+
+void InstanceCuller::cullWithTransformFeedback(unsigned int modelMatrixBuffer, unsigned int normalMatrixBuffer,
+                                               unsigned int instanceDataBuffer, size_t numInstances) {
+    glBindVertexArray(this->vao);
+
+    // Read one instance per vertex
+    if (modelMatrixBuffer != this->vaoModelMatrixBuffer) {
+        glBindBuffer(GL_ARRAY_BUFFER, modelMatrixBuffer);
+        for (GLuint column = 0; column < 4; ++column) {
+            glEnableVertexAttribArray(column);
+            glVertexAttribPointer(column, 4, GL_FLOAT, GL_FALSE, modelMatrixSize_bytes,
+                                  reinterpret_cast<GLvoid*>(column * sizeof(glm::vec4)));
+        }
+        this->vaoModelMatrixBuffer = modelMatrixBuffer;
+    }
+
+    if (normalMatrixBuffer != this->vaoNormalMatrixBuffer) {
+        glBindBuffer(GL_ARRAY_BUFFER, normalMatrixBuffer);
+        for (GLuint column = 0; column < 3; ++column) {
+            glEnableVertexAttribArray(4 + column);
+            glVertexAttribPointer(4 + column, 3, GL_FLOAT, GL_FALSE, normalMatrixSize_bytes,
+                                  reinterpret_cast<GLvoid*>(column * sizeof(glm::vec3)));
+        }
+        this->vaoNormalMatrixBuffer = normalMatrixBuffer;
+    }
+
+    if (instanceDataBuffer != this->vaoInstanceDataBuffer) {
+        if (instanceDataBuffer != 0) {
+            glBindBuffer(GL_ARRAY_BUFFER, instanceDataBuffer);
+            glEnableVertexAttribArray(7);
+            glVertexAttribPointer(7, 2, GL_FLOAT, GL_FALSE, instanceDataSize_bytes, nullptr);
+        } else {
+            // Disabled attributes read the current generic value
+            glDisableVertexAttribArray(7);
+            glVertexAttrib2f(7, 0.0f, 0.0f);
+        }
+        this->vaoInstanceDataBuffer = instanceDataBuffer;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Without query buffers, the count only reaches the CPU after culling finished, so
+    // every instance is drawn and the ones past the captured ones have zero matrices
+    this->numDrawnInstances = static_cast<unsigned int>(numInstances);
+    if (this->zeroBuffer != 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, this->zeroBuffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, this->culledInstanceBuffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                            static_cast<GLsizeiptr>(numInstances * INSTANCE_SIZE_BYTES));
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, this->culledInstanceBuffer);
+
+    glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, this->query);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(numInstances));
+    glEndTransformFeedback();
+    glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
+
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glDisable(GL_RASTERIZER_DISCARD);
+    glBindVertexArray(0);
+
+    // OpenGL 4.4 writes the count into the draw command on the GPU
+    if (this->drawCommandBuffer != 0) {
+        glBindBuffer(GL_QUERY_BUFFER, this->drawCommandBuffer);
+        glGetQueryObjectuiv(this->query, GL_QUERY_RESULT,
+                            reinterpret_cast<GLuint*>(offsetof(DrawElementsIndirectCommand, instanceCount)));
+        glBindBuffer(GL_QUERY_BUFFER, 0);
+    }
+}
+
+void InstanceCuller::cullWithCompute(unsigned int modelMatrixBuffer, unsigned int normalMatrixBuffer,
+                                     unsigned int instanceDataBuffer, size_t numInstances) {
+    const DrawElementsIndirectCommand drawCommand {0, 0, 0, 0, 0};
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, this->drawCommandBuffer);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(drawCommand), &drawCommand);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    glUniform1ui(glGetUniformLocation(this->program, "numInstances"), static_cast<GLuint>(numInstances));
+    glUniform1i(glGetUniformLocation(this->program, "hasInstanceData"), instanceDataBuffer != 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, modelMatrixBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, normalMatrixBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, this->culledInstanceBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, this->drawCommandBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, instanceDataBuffer);
+
+    glDispatchCompute(static_cast<GLuint>((numInstances + COMPUTE_GROUP_SIZE - 1) / COMPUTE_GROUP_SIZE), 1, 1);
+
+    for (GLuint binding = 0; binding < 5; ++binding) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, 0);
+    }
+
+    // The culled instances are read as vertex attributes and the instance count as a
+    // draw command after the index count is updated
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+}
+
+void InstanceCuller::setCullingUniforms(const BoundingSphere &boundingSphere,
+                                        const glm::mat4 &viewProjectionMatrix,
+                                        const DistanceRange &distanceRange) {
+    const Frustum frustum(viewProjectionMatrix);
+
+    glUseProgram(this->program);
+    glUniform4fv(glGetUniformLocation(this->program, "frustumPlanes"), 6,
+                 glm::value_ptr(frustum.getPlanes()[0]));
+    glUniform4f(glGetUniformLocation(this->program, "boundingSphere"),
+                boundingSphere.center.x, boundingSphere.center.y, boundingSphere.center.z,
+                boundingSphere.radius);
+    glUniform3fv(glGetUniformLocation(this->program, "viewPosition"), 1,
+                 glm::value_ptr(distanceRange.viewPosition));
+    glUniform2f(glGetUniformLocation(this->program, "distanceRange"),
+                distanceRange.minDistance, distanceRange.maxDistance);
+}
+
+} // namespace ge
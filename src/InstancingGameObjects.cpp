@@ -1,22 +1,91 @@
 #include <game_engine/InstancingGameObjects.h>
 
 #include <iostream>
-#include <unordered_map>
 
-#include <assimp/Importer.hpp>
-#include <assimp/postprocess.h>
+#include <assimp/scene.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/mat3x3.hpp>
 #include <glm/mat4x4.hpp>
 #include <glad/glad.h>
 
+#include <game_engine/AnimationClip.h>
+#include <game_engine/Imposter.h>
+#include <game_engine/InstanceCuller.h>
 #include <game_engine/InstancingMesh.h>
 #include <game_engine/Exception.h>
+#include <game_engine/JobSystem.h>
+#include <game_engine/ModelImport.h>
+#include <game_engine/ResourceManager.h>
+#include <game_engine/ShaderProgram.h>
+#include <game_engine/Skeleton.h>
+#include <game_engine/VertexAnimationTexture.h>
 
 namespace {
 
 using Meshes = std::vector<std::unique_ptr<ge::InstancingMesh>>;
-std::unordered_map<std::string, std::weak_ptr<Meshes>> cachedMeshes;
+
+///
+/// \brief The LoadedModel struct holds what is shared by all instancing game objects
+///        loading the same model file.
+///
+struct LoadedModel {
+    Meshes meshes;
+    std::shared_ptr<const ge::Skeleton> skeleton;
+    ge::InstancingGameObjects::AnimationClips animationClips;
+};
+
+///
+/// \brief createMeshes Creates the meshes of a model's nodes, depth-first.
+///
+void createMeshes(const aiNode &node, const aiScene &scene, const std::string &modelDirectory,
+                  const ge::Skeleton *skeleton, Meshes *meshes) {
+    // Process node's meshes.
+    for (unsigned int i = 0; i < node.mNumMeshes; ++i) {
+        const auto mesh = scene.mMeshes[node.mMeshes[i]];
+        const auto material = scene.mMaterials[mesh->mMaterialIndex];
+
+        meshes->push_back(std::make_unique<ge::InstancingMesh>(*mesh, *material, modelDirectory, skeleton));
+    }
+
+    // Recursively process children nodes.
+    for (unsigned int i = 0; i < node.mNumChildren; ++i) {
+        createMeshes(*node.mChildren[i], scene, modelDirectory, skeleton, meshes);
+    }
+}
+
+///
+/// \brief reloadModel Replaces the meshes of a loaded model by those of a model file that
+///                    changed.
+/// \exception ge::LoadError The meshes of the model file changed.
+///
+void reloadModel(LoadedModel *model, const aiScene &scene, const std::string &modelFilepath) {
+    const auto modelDirectory = modelFilepath.substr(0, modelFilepath.find_last_of('/'));
+    const auto meshesChanged = [&modelFilepath]() {
+        return ge::LoadError("Model at " + modelFilepath + " changed its meshes, restart to load it");
+    };
+
+    if (ge::Skeleton::hasBones(scene) != (model->skeleton != nullptr)) throw meshesChanged();
+
+    // Skin the new meshes with the skeleton the animators were created with
+    Meshes meshes;
+    createMeshes(*scene.mRootNode, scene, modelDirectory, model->skeleton.get(), &meshes);
+
+    if (meshes.size() != model->meshes.size()) throw meshesChanged();
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        if (meshes[i]->isSkinned() != model->meshes[i]->isSkinned()) throw meshesChanged();
+    }
+
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        model->meshes[i]->swap(*meshes[i]);
+    }
+
+    std::cout << "Reloaded model from file: " << modelFilepath << "\n";
+}
+
+constexpr unsigned int skinMatrixTextureUnit = 2;
+constexpr unsigned int animationPositionTextureUnit = 2;
+constexpr unsigned int animationNormalTextureUnit = 3;
+constexpr size_t animationGrainSize = 16;
 
 } // namespace
 
@@ -29,6 +98,9 @@ InstancingGameObjects::InstancingGameObjects(const std::string& modelFilepath, s
     this->models.reserve(count);
     for (auto i = 0ul; i < count; ++i) {
         this->models.emplace_back(*this, i);
+
+        // Upload every instance once so that culling never reads uninitialized matrices
+        this->changedModelIndices.insert(i);
     }
 
     glGenBuffers(1, &this->modelMatrixBufferObject);
@@ -44,61 +116,233 @@ InstancingGameObjects::InstancingGameObjects(const std::string& modelFilepath, s
 }
 
 void InstancingGameObjects::loadMeshes(const std::string &modelFilepath) {
-    auto modelFilenameIndex = modelFilepath.find_last_of('/');
-    const auto modelDirectory = modelFilepath.substr(0, modelFilenameIndex);
-    const auto modelFilename = modelFilepath.substr(modelFilenameIndex + 1);
+    auto resourceManager = ResourceManager::getInstance();
+    const auto key = ResourceManager::getKey(modelFilepath);
+
+    auto model = resourceManager->load<LoadedModel>(ResourceManager::INSTANCING_MODEL, key, [&]{
+        const auto modelDirectory = modelFilepath.substr(0, modelFilepath.find_last_of('/'));
+
+        // Load model from file, or use the model if it was already imported
+        const auto importedModel = importModelFile(modelFilepath);
+        const auto &scene = *importedModel->scene;
+
+        auto model = std::make_shared<LoadedModel>();
+        if (Skeleton::hasBones(scene)) {
+            model->skeleton = std::make_shared<const Skeleton>(scene);
+            model->animationClips = AnimationClip::loadAnimationClips(scene, *model->skeleton);
+        }
+
+        createMeshes(*scene.mRootNode, scene, modelDirectory, model->skeleton.get(), &model->meshes);
+        for (const auto &mesh : model->meshes) {
+            mesh->addModelMatrixAttrib(this->modelMatrixBufferObject);
+            mesh->addNormalMatrixAttrib(this->normalMatrixBufferObject);
+        }
+
+        std::cout << "Successfully loaded model from file: " << modelFilepath << "\n";
+        return ResourceManager::Loaded<LoadedModel> {model, importedModel->meshGpuSize_bytes, {modelFilepath}};
+    });
+
+    this->meshes = std::shared_ptr<Meshes>(model, &model->meshes);
+    this->skeleton = model->skeleton;
+    this->animationClips = std::shared_ptr<const AnimationClips>(model, &model->animationClips);
+    if (!this->skeleton) return;
+
+    // Every instance plays its own animation with the shared skeleton and clips
+    this->animators.assign(this->models.size(), Animator(this->skeleton));
+    this->skinMatrices.resize(this->models.size() * this->skeleton->getNumBones());
+
+    glGenBuffers(1, &this->skinMatrixBufferObject);
+    glGenTextures(1, &this->skinMatrixTexture);
+    glBindBuffer(GL_TEXTURE_BUFFER, this->skinMatrixBufferObject);
+    glBufferData(GL_TEXTURE_BUFFER, this->skinMatrices.size() * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, this->skinMatrixTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, this->skinMatrixBufferObject);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
 
-    // Check cached meshes to avoid reloading
-    this->meshes = cachedMeshes[modelFilename].lock();
-    if (this->meshes) return;
+InstancingGameObjects::~InstancingGameObjects() {
+    glDeleteBuffers(1, &this->animationBufferObject);
+    glDeleteTextures(1, &this->skinMatrixTexture);
+    glDeleteBuffers(1, &this->skinMatrixBufferObject);
+    glDeleteBuffers(1, &this->normalMatrixBufferObject);
+    glDeleteBuffers(1, &this->modelMatrixBufferObject);
+}
 
-    // Load meshes from file
-    Assimp::Importer importer;
-    const auto scene = importer.ReadFile(modelFilepath,
-                                         aiProcess_Triangulate | aiProcess_FlipUVs);
+void InstancingGameObjects::onUpdate(std::chrono::duration<float> updateDuration) {
+    this->updateAnimations(updateDuration);
+}
 
-    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-        throw LoadError(importer.GetErrorString());
+void InstancingGameObjects::updateAnimations(std::chrono::duration<float> updateDuration) {
+    if (this->hasVertexAnimations()) {
+        this->vertexAnimationTime_s += updateDuration.count();
+        return;
     }
 
-    auto meshesDeleter = [modelFilename](auto meshes){
-        // Clear cache
-        cachedMeshes.erase(modelFilename);
-        delete meshes;
-    };
-    this->meshes = std::shared_ptr<Meshes>(new Meshes, meshesDeleter);
+    if (this->animators.empty()) return;
+
+    const auto numBones = this->skeleton->getNumBones();
+    JobSystem::getInstance().parallelFor(this->animators.size(), animationGrainSize,
+                                         [this, updateDuration, numBones](size_t begin, size_t end){
+        for (auto i = begin; i < end; ++i) {
+            this->animators[i].update(updateDuration);
+            this->animators[i].computeSkinMatrices(&this->skinMatrices[i * numBones]);
+        }
+    });
+}
+
+void InstancingGameObjects::bakeVertexAnimations(float framesPerSecond) {
+    for (const auto& mesh : *this->meshes) {
+        if (!mesh->isSkinned()) throw Error("Cannot bake vertex animations of meshes that are not skinned.");
+    }
+
+    decltype(this->vertexAnimationTextures) vertexAnimationTextures;
+    for (const auto& mesh : *this->meshes) {
+        vertexAnimationTextures.push_back(std::make_unique<VertexAnimationTexture>(
+                                              *mesh->getSkinningData(), *this->skeleton,
+                                              *this->animationClips, framesPerSecond));
+    }
+    this->vertexAnimationTextures = std::move(vertexAnimationTextures);
+
+    // The instances no longer need their own skeletal animation state
+    this->animators.clear();
+    this->animators.shrink_to_fit();
+    this->skinMatrices.clear();
+    this->skinMatrices.shrink_to_fit();
+    glDeleteTextures(1, &this->skinMatrixTexture);
+    glDeleteBuffers(1, &this->skinMatrixBufferObject);
+    this->skinMatrixTexture = 0;
+    this->skinMatrixBufferObject = 0;
+
+    this->instanceAnimations.assign(this->models.size(), glm::vec2(0.0f));
+    glGenBuffers(1, &this->animationBufferObject);
+    glBindBuffer(GL_ARRAY_BUFFER, this->animationBufferObject);
+    glBufferData(GL_ARRAY_BUFFER, this->instanceAnimations.size() * sizeof(glm::vec2),
+                 this->instanceAnimations.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    processNode(*scene->mRootNode, *scene, modelDirectory);
+    // Attach the animation buffer on the next draw
+    for (const auto& mesh : *this->meshes) {
+        mesh->addAnimationAttrib(this->animationBufferObject);
+    }
+    this->culledInstanceAttribs = false;
+}
 
-    std::cout << "Successfully loaded model from file: " << modelFilepath << "\n";
-    cachedMeshes[modelFilename] = this->meshes;
+void InstancingGameObjects::render(ShaderProgram *shader) {
+    this->uploadChangedModels();
+    this->setInstanceAttribs(false);
+    if (!this->animators.empty()) this->uploadSkinMatrices(shader);
+    if (this->hasVertexAnimations()) this->setVertexAnimationUniforms(shader);
+
+    for (size_t i = 0; i < this->meshes->size(); ++i) {
+        this->bindVertexAnimationTexture(shader, i);
+        (*this->meshes)[i]->render(shader, this->models.size());
+    }
 }
 
-void InstancingGameObjects::processNode(const aiNode &node, const aiScene &scene, const std::string &modelDirectory) {
-    // Process node's meshes.
-    for (unsigned int i = 0; i < node.mNumMeshes; ++i) {
-        const auto mesh = scene.mMeshes[node.mMeshes[i]];
-        const auto material = scene.mMaterials[mesh->mMaterialIndex];
+void InstancingGameObjects::render(ShaderProgram *shader, const glm::mat4 &viewProjectionMatrix) {
+    this->renderCulled(shader, viewProjectionMatrix, InstanceCuller::DistanceRange());
+}
+
+void InstancingGameObjects::render(ShaderProgram *shader, const glm::mat4 &viewProjectionMatrix,
+                                   const glm::vec3 &viewPosition) {
+    InstanceCuller::DistanceRange distanceRange;
+    distanceRange.viewPosition = viewPosition;
+    if (this->imposter) distanceRange.maxDistance = this->imposterDistance;
+
+    this->renderCulled(shader, viewProjectionMatrix, distanceRange);
+}
 
-        this->meshes->push_back(std::make_unique<InstancingMesh>(*mesh, *material, modelDirectory));
-        this->meshes->back()->addModelMatrixAttrib(this->modelMatrixBufferObject);
-        this->meshes->back()->addNormalMatrixAttrib(this->normalMatrixBufferObject);
+void InstancingGameObjects::renderImposters(ShaderProgram *shader, const glm::mat4 &viewProjectionMatrix,
+                                            const glm::vec3 &viewPosition) {
+    if (!this->imposter) return;
+
+    this->uploadChangedModels();
+
+    if (!this->imposterCuller) {
+        this->imposterCuller = std::make_unique<InstanceCuller>(this->models.size());
+        this->imposter->setInstanceAttribs(*this->imposterCuller);
     }
 
-    // Recursively process children nodes.
-    for (unsigned int i = 0; i < node.mNumChildren; ++i) {
-        processNode(*node.mChildren[i], scene, modelDirectory);
+    InstanceCuller::DistanceRange distanceRange;
+    distanceRange.viewPosition = viewPosition;
+    distanceRange.minDistance = this->imposterDistance;
+
+    this->imposterCuller->cull(this->modelMatrixBufferObject, this->normalMatrixBufferObject,
+                               this->animationBufferObject, this->models.size(),
+                               this->imposter->getBoundingSphere(), viewProjectionMatrix, distanceRange);
+
+    shader->use();
+    this->imposter->render(shader, *this->imposterCuller);
+}
+
+void InstancingGameObjects::bakeImposters(ShaderProgram *bakeShader, int numViewsPerSide,
+                                          int viewResolution_texels) {
+    this->imposter = std::make_unique<Imposter>(*this->meshes, this->getBoundingSphere(), bakeShader,
+                                                numViewsPerSide, viewResolution_texels);
+
+    // The new imposter reads its instances from a new culler
+    this->imposterCuller.reset();
+}
+
+void InstancingGameObjects::renderCulled(ShaderProgram *shader, const glm::mat4 &viewProjectionMatrix,
+                                         const InstanceCuller::DistanceRange &distanceRange) {
+    // Culling would reorder the instances away from their skin matrices
+    if (!this->animators.empty()) {
+        shader->use();
+        this->render(shader);
+        return;
+    }
+
+    this->uploadChangedModels();
+
+    if (!this->instanceCuller) {
+        this->instanceCuller = std::make_unique<InstanceCuller>(this->models.size());
+    }
+
+    this->instanceCuller->cull(this->modelMatrixBufferObject, this->normalMatrixBufferObject,
+                               this->animationBufferObject, this->models.size(),
+                               this->getBoundingSphere(), viewProjectionMatrix, distanceRange);
+    this->setInstanceAttribs(true);
+
+    shader->use();
+    if (this->hasVertexAnimations()) this->setVertexAnimationUniforms(shader);
+
+    for (size_t i = 0; i < this->meshes->size(); ++i) {
+        this->bindVertexAnimationTexture(shader, i);
+        (*this->meshes)[i]->render(shader, *this->instanceCuller);
     }
 }
 
-InstancingGameObjects::~InstancingGameObjects() {
-    glDeleteBuffers(1, &this->normalMatrixBufferObject);
-    glDeleteBuffers(1, &this->modelMatrixBufferObject);
+std::function<void()> InstancingGameObjects::prepareReload(const std::string &filepath) {
+    auto resourceManager = ResourceManager::getInstance();
+    if (!resourceManager->isLoadedFrom(ResourceManager::INSTANCING_MODEL, filepath)) return nullptr;
+
+    auto importedModel = readModelFile(filepath);
+
+    return [resourceManager, importedModel, filepath]() {
+        for (const auto &model : resourceManager->findLoadedFrom<LoadedModel>(ResourceManager::INSTANCING_MODEL,
+                                                                             filepath)) {
+            reloadModel(model.get(), *importedModel->scene, filepath);
+        }
+    };
 }
 
-void InstancingGameObjects::onUpdate(std::chrono::duration<float> updateDuration) {}
+BoundingSphere InstancingGameObjects::getBoundingSphere() const {
+    BoundingSphere boundingSphere;
+    for (const auto& mesh : *this->meshes) {
+        boundingSphere = boundingSphere.merged(mesh->getBoundingSphere());
+    }
+
+    // Animated vertices may leave the bind pose's sphere
+    for (const auto& vertexAnimationTexture : this->vertexAnimationTextures) {
+        boundingSphere = boundingSphere.merged(vertexAnimationTexture->getBoundingSphere());
+    }
 
-void InstancingGameObjects::render(ShaderProgram *shader) {
+    return boundingSphere;
+}
+
+void InstancingGameObjects::uploadChangedModels() {
     constexpr static auto mat3Size_bytes = sizeof(glm::mat3);
     constexpr static auto mat4Size_bytes = sizeof(glm::mat4);
 
@@ -113,14 +357,74 @@ void InstancingGameObjects::render(ShaderProgram *shader) {
         glBindBuffer(GL_ARRAY_BUFFER, this->normalMatrixBufferObject);
         glBufferSubData(GL_ARRAY_BUFFER, idx * mat3Size_bytes, mat3Size_bytes,
                         glm::value_ptr(normalMatrix));
+
+        if (this->animationBufferObject) {
+            glBindBuffer(GL_ARRAY_BUFFER, this->animationBufferObject);
+            glBufferSubData(GL_ARRAY_BUFFER, idx * sizeof(glm::vec2), sizeof(glm::vec2),
+                            glm::value_ptr(this->instanceAnimations[idx]));
+        }
     }
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     this->changedModelIndices.clear();
+}
+
+void InstancingGameObjects::uploadSkinMatrices(ShaderProgram *shader) {
+    glBindBuffer(GL_TEXTURE_BUFFER, this->skinMatrixBufferObject);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, this->skinMatrices.size() * sizeof(glm::mat4),
+                    this->skinMatrices.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glActiveTexture(GL_TEXTURE0 + skinMatrixTextureUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, this->skinMatrixTexture);
+    glActiveTexture(GL_TEXTURE0);
+
+    shader->setUniform("boneMatrices", static_cast<int>(skinMatrixTextureUnit));
+    shader->setUniform("numBones", static_cast<int>(this->skeleton->getNumBones()));
+}
+
+void InstancingGameObjects::setVertexAnimationUniforms(ShaderProgram *shader) {
+    const auto &clips = this->vertexAnimationTextures.front()->getClips();
+    for (size_t i = 0; i < clips.size(); ++i) {
+        shader->setUniform("animationClips[" + std::to_string(i) + "]",
+                           static_cast<float>(clips[i].firstFrame), static_cast<float>(clips[i].numFrames),
+                           clips[i].framesPerSecond);
+    }
+
+    shader->setUniform("animationTime", this->vertexAnimationTime_s);
+    shader->setUniform("animationPositions", static_cast<int>(animationPositionTextureUnit));
+    shader->setUniform("animationNormals", static_cast<int>(animationNormalTextureUnit));
+}
+
+void InstancingGameObjects::bindVertexAnimationTexture(ShaderProgram *shader, size_t meshIndex) {
+    if (!this->hasVertexAnimations()) return;
+
+    const auto &vertexAnimationTexture = *this->vertexAnimationTextures[meshIndex];
+    vertexAnimationTexture.bind(animationPositionTextureUnit, animationNormalTextureUnit);
+    shader->setUniform("animationRowsPerFrame", vertexAnimationTexture.getRowsPerFrame());
+}
+
+void InstancingGameObjects::setInstanceAttribs(bool culled) {
+    if (culled == this->culledInstanceAttribs) return;
 
     for (const auto& mesh : *this->meshes) {
-        mesh->render(shader, this->models.size());
+        if (culled) {
+            const auto culledInstanceBuffer = this->instanceCuller->getCulledInstanceBuffer();
+            mesh->addModelMatrixAttrib(culledInstanceBuffer, InstanceCuller::INSTANCE_SIZE_BYTES, 0);
+            mesh->addNormalMatrixAttrib(culledInstanceBuffer, InstanceCuller::INSTANCE_SIZE_BYTES,
+                                        sizeof(glm::mat4));
+            if (this->animationBufferObject) {
+                mesh->addAnimationAttrib(culledInstanceBuffer, InstanceCuller::INSTANCE_SIZE_BYTES,
+                                         InstanceCuller::INSTANCE_DATA_OFFSET_BYTES);
+            }
+        } else {
+            mesh->addModelMatrixAttrib(this->modelMatrixBufferObject);
+            mesh->addNormalMatrixAttrib(this->normalMatrixBufferObject);
+            if (this->animationBufferObject) mesh->addAnimationAttrib(this->animationBufferObject);
+        }
     }
+
+    this->culledInstanceAttribs = culled;
 }
 
 /// ----------------------------------------------------
@@ -166,6 +470,23 @@ InstancingGameObjects::InstancingModel& InstancingGameObjects::InstancingModel::
     this->notifyModelChanged();
 }
 
+Animator* InstancingGameObjects::InstancingModel::getAnimator() {
+    auto &animators = this->parentGameObject.animators;
+    return (this->idx < animators.size()) ? &animators[this->idx] : nullptr;
+}
+
+InstancingGameObjects::InstancingModel& InstancingGameObjects::InstancingModel::playVertexAnimation(size_t clip,
+                                                                                                  float phase_s) {
+    auto &parent = this->parentGameObject;
+    if (!parent.hasVertexAnimations()) throw Error("Cannot play vertex animations before baking them.");
+    if (clip >= parent.vertexAnimationTextures.front()->getClips().size()) {
+        throw Error("Cannot play vertex animation " + std::to_string(clip) + ", it was not baked.");
+    }
+
+    parent.instanceAnimations[this->idx] = glm::vec2(static_cast<float>(clip), phase_s);
+    return this->notifyModelChanged();
+}
+
 InstancingGameObjects::InstancingModel& InstancingGameObjects::InstancingModel::notifyModelChanged() {
     parentGameObject.changedModelIndices.insert(this->idx);
     return *this;
@@ -5,12 +5,18 @@
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 
+#include <game_engine/InstanceCuller.h>
+
 namespace ge {
 
-InstancingMesh::InstancingMesh(const aiMesh &mesh, const aiMaterial &material, const std::string &textureDirectory)
-    : Mesh(mesh, material, textureDirectory){}
+InstancingMesh::InstancingMesh(const aiMesh &mesh, const aiMaterial &material, const std::string &textureDirectory,
+                               const Skeleton *skeleton)
+    : Mesh(mesh, material, textureDirectory, skeleton){}
+
+InstancingMesh& InstancingMesh::addModelMatrixAttrib(unsigned int modelMatrixBufferObject,
+                                                     size_t stride_bytes, size_t offset_bytes) {
+    this->modelMatrixAttrib = {modelMatrixBufferObject, stride_bytes, offset_bytes};
 
-InstancingMesh& InstancingMesh::addModelMatrixAttrib(unsigned int modelMatrixBufferObject) {
     this->bindVao();
     glBindBuffer(GL_ARRAY_BUFFER, modelMatrixBufferObject);
 
@@ -23,8 +29,8 @@ InstancingMesh& InstancingMesh::addModelMatrixAttrib(unsigned int modelMatrixBuf
          ++attribIdx, ++ptrOffset) {
         glEnableVertexAttribArray(attribIdx);
         glVertexAttribPointer(attribIdx, numAttribElements, GL_FLOAT, GL_FALSE,
-                              numAttribElements * vectorSize,
-                              reinterpret_cast<GLvoid*>(ptrOffset * vectorSize));
+                              stride_bytes,
+                              reinterpret_cast<GLvoid*>(offset_bytes + ptrOffset * vectorSize));
         glVertexAttribDivisor(attribIdx, 1);
     }
 
@@ -33,7 +39,10 @@ InstancingMesh& InstancingMesh::addModelMatrixAttrib(unsigned int modelMatrixBuf
     return *this;
 }
 
-InstancingMesh& InstancingMesh::addNormalMatrixAttrib(unsigned int normalMatrixBufferObject) {
+InstancingMesh& InstancingMesh::addNormalMatrixAttrib(unsigned int normalMatrixBufferObject,
+                                                      size_t stride_bytes, size_t offset_bytes) {
+    this->normalMatrixAttrib = {normalMatrixBufferObject, stride_bytes, offset_bytes};
+
     this->bindVao();
     glBindBuffer(GL_ARRAY_BUFFER, normalMatrixBufferObject);
 
@@ -46,8 +55,8 @@ InstancingMesh& InstancingMesh::addNormalMatrixAttrib(unsigned int normalMatrixB
          ++attribIdx, ++ptrOffset) {
         glEnableVertexAttribArray(attribIdx);
         glVertexAttribPointer(attribIdx, numAttribElements, GL_FLOAT, GL_FALSE,
-                              numAttribElements * vectorSize,
-                              reinterpret_cast<GLvoid*>(ptrOffset * vectorSize));
+                              stride_bytes,
+                              reinterpret_cast<GLvoid*>(offset_bytes + ptrOffset * vectorSize));
         glVertexAttribDivisor(attribIdx, 1);
     }
 
@@ -56,8 +65,28 @@ InstancingMesh& InstancingMesh::addNormalMatrixAttrib(unsigned int normalMatrixB
     return *this;
 }
 
+InstancingMesh& InstancingMesh::addAnimationAttrib(unsigned int animationBufferObject,
+                                                   size_t stride_bytes, size_t offset_bytes) {
+    this->animationAttrib = {animationBufferObject, stride_bytes, offset_bytes};
+
+    this->bindVao();
+    glBindBuffer(GL_ARRAY_BUFFER, animationBufferObject);
+
+    constexpr static auto attribIdx = 12u;
+    constexpr static auto numAttribElements = 2;
+
+    glEnableVertexAttribArray(attribIdx);
+    glVertexAttribPointer(attribIdx, numAttribElements, GL_FLOAT, GL_FALSE,
+                          stride_bytes, reinterpret_cast<GLvoid*>(offset_bytes));
+    glVertexAttribDivisor(attribIdx, 1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    return *this;
+}
+
 void InstancingMesh::render(ShaderProgram *shader, size_t numInstances) {
-    this->bindTextures(shader);
+    this->bindMaterial(shader);
 
     this->bindVao();
     glDrawElementsInstanced(GL_TRIANGLES, this->getNumIndices(),
@@ -66,4 +95,36 @@ void InstancingMesh::render(ShaderProgram *shader, size_t numInstances) {
     glBindVertexArray(0);
 }
 
+void InstancingMesh::render(ShaderProgram *shader, const InstanceCuller &culler) {
+    this->bindMaterial(shader);
+
+    this->bindVao();
+    culler.drawElementsInstanced(this->getNumIndices());
+    glBindVertexArray(0);
+}
+
+void InstancingMesh::swap(InstancingMesh &other) {
+    Mesh::swap(other);
+
+    // Point the exchanged vertex arrays at the instance buffers of their new meshes
+    for (auto mesh : {this, &other}) {
+        const auto &modelMatrixAttrib = mesh->modelMatrixAttrib;
+        const auto &normalMatrixAttrib = mesh->normalMatrixAttrib;
+        const auto &animationAttrib = mesh->animationAttrib;
+
+        if (modelMatrixAttrib.bufferObject) {
+            mesh->addModelMatrixAttrib(modelMatrixAttrib.bufferObject, modelMatrixAttrib.stride_bytes,
+                                       modelMatrixAttrib.offset_bytes);
+        }
+        if (normalMatrixAttrib.bufferObject) {
+            mesh->addNormalMatrixAttrib(normalMatrixAttrib.bufferObject, normalMatrixAttrib.stride_bytes,
+                                        normalMatrixAttrib.offset_bytes);
+        }
+        if (animationAttrib.bufferObject) {
+            mesh->addAnimationAttrib(animationAttrib.bufferObject, animationAttrib.stride_bytes,
+                                     animationAttrib.offset_bytes);
+        }
+    }
+}
+
 } // namespace ge
@@ -0,0 +1,144 @@
+#include <game_engine/JobSystem.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace {
+
+///
+/// \brief The ParallelForState struct is shared between the thread calling
+/// JobSystem::parallelFor() and the helper jobs it spawns.
+///
+/// Helper jobs that start after all ranges have been claimed simply return,
+/// which is why the state is reference counted rather than owned by the caller.
+///
+struct ParallelForState {
+    ParallelForState(size_t count, size_t grainSize, const std::function<void(size_t, size_t)> &fn)
+        : count(count), grainSize(grainSize),
+          numRanges((count + grainSize - 1) / grainSize), fn(fn) {}
+
+    ///
+    /// \brief processRanges Claims and processes ranges until none are left.
+    ///
+    void processRanges() {
+        for (auto range = this->nextRange++; range < this->numRanges; range = this->nextRange++) {
+            const auto begin = range * this->grainSize;
+            const auto end = std::min(begin + this->grainSize, this->count);
+
+            try {
+                this->fn(begin, end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                if (!this->exception) this->exception = std::current_exception();
+            }
+
+            if (++this->numCompletedRanges == this->numRanges) {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->completed.notify_all();
+            }
+        }
+    }
+
+    const size_t count;
+    const size_t grainSize;
+    const size_t numRanges;
+    const std::function<void(size_t, size_t)> fn;
+
+    std::atomic<size_t> nextRange {0};
+    std::atomic<size_t> numCompletedRanges {0};
+
+    std::mutex mutex;
+    std::condition_variable completed;
+    std::exception_ptr exception;
+};
+
+} // namespace
+
+namespace ge {
+
+JobSystem::JobSystem(unsigned int numThreads) {
+    if (numThreads == 0) {
+        const auto numHardwareThreads = std::thread::hardware_concurrency();
+        numThreads = numHardwareThreads > 1 ? numHardwareThreads - 1 : 1;
+    }
+
+    this->workers.reserve(numThreads);
+    for (auto i = 0u; i < numThreads; ++i) {
+        this->workers.emplace_back(&JobSystem::workerLoop, this);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(this->jobsMutex);
+        this->stopping = true;
+    }
+    this->jobsAvailable.notify_all();
+
+    for (auto &worker : this->workers) {
+        worker.join();
+    }
+}
+
+JobSystem& JobSystem::getInstance() {
+    static JobSystem jobSystem;
+    return jobSystem;
+}
+
+void JobSystem::parallelFor(size_t count, size_t grainSize,
+                            const std::function<void(size_t, size_t)> &fn) {
+    if (count == 0) return;
+    grainSize = std::max<size_t>(grainSize, 1);
+
+    // Run small loops inline to avoid the overhead of waking up workers
+    if (count <= grainSize || this->workers.empty()) {
+        fn(0, count);
+        return;
+    }
+
+    auto state = std::make_shared<ParallelForState>(count, grainSize, fn);
+
+    const auto numHelpers = std::min<size_t>(this->workers.size(), state->numRanges - 1);
+    for (auto i = 0u; i < numHelpers; ++i) {
+        this->enqueue([state]{state->processRanges();});
+    }
+
+    state->processRanges();
+
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->completed.wait(lock, [&state]{
+            return state->numCompletedRanges == state->numRanges;
+        });
+    }
+
+    if (state->exception) std::rethrow_exception(state->exception);
+}
+
+void JobSystem::enqueue(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(this->jobsMutex);
+        this->jobs.push_back(std::move(job));
+    }
+    this->jobsAvailable.notify_one();
+}
+
+void JobSystem::workerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(this->jobsMutex);
+            this->jobsAvailable.wait(lock, [this]{return this->stopping || !this->jobs.empty();});
+
+            if (this->jobs.empty()) return;
+
+            job = std::move(this->jobs.front());
+            this->jobs.pop_front();
+        }
+
+        job();
+    }
+}
+
+} // namespace ge
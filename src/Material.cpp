@@ -0,0 +1,232 @@
+#include <game_engine/Material.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#include <assimp/material.h>
+#include <glad/glad.h>
+
+#include <game_engine/Exception.h>
+#include <game_engine/ShaderProgram.h>
+
+namespace {
+
+const std::array<unsigned char, 4> whitePixel {255, 255, 255, 255};
+const std::array<unsigned char, 4> blackPixel {0, 0, 0, 255};
+
+/// Number of RGBA32F texels of the texture buffer per material.
+constexpr size_t texelsPerMaterial = 3;
+
+/// Number of materials the texture buffer is created with.
+constexpr size_t initialBufferCapacity = 256;
+
+/// Marks that no material changed since the last upload.
+constexpr auto noChangedId = std::numeric_limits<ge::Material::Id>::max();
+
+std::mutex instanceMutex;
+std::weak_ptr<ge::MaterialRegistry> instance;
+
+///
+/// \brief loadTexture Loads the first texture of the given type in the material.
+/// \return The loaded texture or the default texture if the material has none.
+///
+ge::Texture2D loadTexture(const aiMaterial &material, aiTextureType type,
+                          const std::string &textureDirectory, const ge::Texture2D &defaultTexture) {
+    if (material.GetTextureCount(type) == 0) return defaultTexture;
+
+    aiString imageFilename;
+    material.GetTexture(type, 0, &imageFilename);
+    return ge::Texture2D(textureDirectory + "/" + imageFilename.C_Str());
+}
+
+} // namespace
+
+namespace ge {
+
+Material::Material()
+    : registry(MaterialRegistry::getInstance()),
+      id(registry->allocateId()),
+      diffuseTexture(registry->getDefaultDiffuseTexture()),
+      specularTexture(registry->getDefaultSpecularTexture()) {
+    this->update();
+}
+
+Material::Material(const aiMaterial &material, const std::string &textureDirectory)
+    : registry(MaterialRegistry::getInstance()),
+      id(registry->allocateId()),
+      diffuseTexture(registry->getDefaultDiffuseTexture()),
+      specularTexture(registry->getDefaultSpecularTexture()) {
+    try {
+        this->diffuseTexture = loadTexture(material, aiTextureType_DIFFUSE, textureDirectory,
+                                           this->registry->getDefaultDiffuseTexture());
+        this->specularTexture = loadTexture(material, aiTextureType_SPECULAR, textureDirectory,
+                                            this->registry->getDefaultSpecularTexture());
+    } catch (std::exception&) {
+        this->registry->releaseId(this->id);
+        throw;
+    }
+
+    float shininess = 0.0f;
+    if (material.Get(AI_MATKEY_SHININESS, shininess) == AI_SUCCESS && shininess > 0.0f) {
+        this->specularExponent = shininess;
+    }
+
+    this->update();
+}
+
+Material::~Material() {
+    this->registry->releaseId(this->id);
+}
+
+void Material::bind(ShaderProgram *shader) const {
+    shader->setUniform("materialId", static_cast<int>(this->id))
+            .setUniform("diffuseTextures", 0)
+            .setUniform("specularTextures", 1);
+
+    glActiveTexture(GL_TEXTURE0);
+    this->diffuseTexture.bind();
+
+    glActiveTexture(GL_TEXTURE1);
+    this->specularTexture.bind();
+
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void Material::setDiffuseTexture(const Texture2D &texture) {
+    this->diffuseTexture = texture;
+    this->update();
+}
+
+void Material::setSpecularTexture(const Texture2D &texture) {
+    this->specularTexture = texture;
+    this->update();
+}
+
+void Material::setSpecularExponent(float specularExponent) {
+    this->specularExponent = specularExponent;
+    this->update();
+}
+
+bool Material::hasSpecularTexture() const {
+    const auto &defaultTexture = this->registry->getDefaultSpecularTexture();
+    return &this->specularTexture.getArray() != &defaultTexture.getArray() ||
+            this->specularTexture.getLayer() != defaultTexture.getLayer();
+}
+
+void Material::update() {
+    MaterialRegistry::MaterialData data;
+    data.diffuseUvTransform = this->diffuseTexture.getUvTransform();
+    data.specularUvTransform = this->specularTexture.getUvTransform();
+    data.diffuseLayer = static_cast<float>(this->diffuseTexture.getLayer());
+    data.specularLayer = static_cast<float>(this->specularTexture.getLayer());
+    data.specularExponent = this->specularExponent;
+    data.padding = 0.0f;
+
+    this->registry->setMaterialData(this->id, data);
+}
+
+std::shared_ptr<MaterialRegistry> MaterialRegistry::getInstance() {
+    std::lock_guard<std::mutex> lock(instanceMutex);
+
+    auto registry = instance.lock();
+    if (!registry) {
+        registry = std::make_shared<MaterialRegistry>();
+        instance = registry;
+    }
+
+    return registry;
+}
+
+MaterialRegistry::MaterialRegistry()
+    : defaultDiffuseTexture(whitePixel.data(), 1, 1),
+      defaultSpecularTexture(blackPixel.data(), 1, 1),
+      firstChangedId(noChangedId),
+      lastChangedId(0) {
+    static_assert(sizeof(MaterialData) == texelsPerMaterial * sizeof(glm::vec4),
+                  "MaterialData must match the texels of a material in the materials texture buffer.");
+
+    GLint maxTextureBufferSize_texels;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTextureBufferSize_texels);
+    this->maxNumMaterials = static_cast<size_t>(maxTextureBufferSize_texels) / texelsPerMaterial;
+    this->bufferCapacity = std::min(initialBufferCapacity, this->maxNumMaterials);
+
+    glGenBuffers(1, &this->bufferObject);
+    glBindBuffer(GL_TEXTURE_BUFFER, this->bufferObject);
+    glBufferData(GL_TEXTURE_BUFFER, this->bufferCapacity * sizeof(MaterialData), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glGenTextures(1, &this->texture);
+    glBindTexture(GL_TEXTURE_BUFFER, this->texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, this->bufferObject);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+MaterialRegistry::~MaterialRegistry() {
+    glDeleteTextures(1, &this->texture);
+    glDeleteBuffers(1, &this->bufferObject);
+}
+
+void MaterialRegistry::uploadChanges() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->firstChangedId > this->lastChangedId) return;
+
+    glBindBuffer(GL_TEXTURE_BUFFER, this->bufferObject);
+    if (this->materialData.size() > this->bufferCapacity) {
+        // Reallocating the data store keeps the buffer object attached to the texture
+        this->bufferCapacity = std::min(std::max(this->materialData.size(), 2 * this->bufferCapacity),
+                                        this->maxNumMaterials);
+        glBufferData(GL_TEXTURE_BUFFER, this->bufferCapacity * sizeof(MaterialData), nullptr, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, this->materialData.size() * sizeof(MaterialData),
+                        this->materialData.data());
+    } else {
+        const auto numChanged = this->lastChangedId - this->firstChangedId + 1;
+        glBufferSubData(GL_TEXTURE_BUFFER, this->firstChangedId * sizeof(MaterialData),
+                        numChanged * sizeof(MaterialData), &this->materialData[this->firstChangedId]);
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    this->firstChangedId = noChangedId;
+    this->lastChangedId = 0;
+}
+
+void MaterialRegistry::bind(unsigned int textureUnit) const {
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, this->texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+Material::Id MaterialRegistry::allocateId() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    // Lowest IDs first to keep the uploaded range small
+    if (!this->freeIds.empty()) {
+        const auto id = this->freeIds.back();
+        this->freeIds.pop_back();
+        return id;
+    }
+
+    if (this->materialData.size() >= this->maxNumMaterials) {
+        throw Error("Exceeded the maximum of " + std::to_string(this->maxNumMaterials) +
+                    " materials of the texture buffer.");
+    }
+
+    this->materialData.emplace_back();
+    return static_cast<Material::Id>(this->materialData.size() - 1);
+}
+
+void MaterialRegistry::releaseId(Material::Id id) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->freeIds.insert(std::upper_bound(this->freeIds.begin(), this->freeIds.end(), id,
+                                          std::greater<Material::Id>()),
+                         id);
+}
+
+void MaterialRegistry::setMaterialData(Material::Id id, const MaterialData &data) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->materialData[id] = data;
+    this->firstChangedId = std::min(this->firstChangedId, id);
+    this->lastChangedId = std::max(this->lastChangedId, id);
+}
+
+} // namespace ge
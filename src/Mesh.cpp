@@ -2,34 +2,37 @@
 
 #include <cstddef>
 #include <iostream>
+#include <utility>
 
 #include <glad/glad.h>
 
 #include <glm/vec2.hpp>
 
+#include <game_engine/Material.h>
 #include <game_engine/ShaderProgram.h>
 #include <game_engine/Texture2D.h>
 
 namespace {
 
-std::vector<ge::Texture2D> loadTexturesFromMaterial(const aiMaterial &material, aiTextureType type, const std::string &modelDirectory) {
-    std::vector<ge::Texture2D> textures;
-    textures.reserve(material.GetTextureCount(type));
-
-    for (unsigned int i = 0; i < material.GetTextureCount(type); ++i) {
-        aiString imageFilename;
-        material.GetTexture(type, i, &imageFilename);
-        textures.emplace_back(modelDirectory + "/" + imageFilename.C_Str());
+std::shared_ptr<ge::Material> createMaterial(const std::string &textureFilepath) {
+    auto material = std::make_shared<ge::Material>();
+    if (!textureFilepath.empty()) {
+        material->setDiffuseTexture(ge::Texture2D(textureFilepath));
     }
 
-    return textures;
+    return material;
 }
 
 } // namespace
 
 namespace ge {
 
-Mesh::Mesh(const aiMesh &mesh, const aiMaterial &material, const std::string &textureDirectory) {
+Mesh::Mesh(const aiMesh &mesh, const aiMaterial &material, const std::string &textureDirectory,
+           const Skeleton *skeleton)
+    : Mesh(mesh, std::make_shared<Material>(material, textureDirectory), skeleton) {}
+
+Mesh::Mesh(const aiMesh &mesh, std::shared_ptr<Material> material, const Skeleton *skeleton)
+    : material(std::move(material)) {
     // Load texture coordinates into appropriate data structure.
     std::vector<glm::vec2> textureCoords;
     textureCoords.reserve(mesh.mNumVertices);
@@ -48,14 +51,34 @@ Mesh::Mesh(const aiMesh &mesh, const aiMaterial &material, const std::string &te
     }
     this->numIndices = indices.size();
 
+    if (mesh.mNumVertices > 0) {
+        this->boundingSphere = BoundingSphere::fromPoints(&mesh.mVertices[0].x, mesh.mNumVertices);
+    }
+
+    // Keep the bind pose of skinned meshes for skinning on the CPU
+    if (skeleton && mesh.HasBones()) {
+        this->skinningData = std::make_unique<SkinningData>();
+        this->skinningData->boneInfluences = skeleton->computeBoneInfluences(mesh);
+        this->skinningData->positions.reserve(mesh.mNumVertices);
+        this->skinningData->normals.reserve(mesh.mNumVertices);
+        for (unsigned int i = 0; i < mesh.mNumVertices; ++i) {
+            this->skinningData->positions.emplace_back(mesh.mVertices[i].x, mesh.mVertices[i].y, mesh.mVertices[i].z);
+            this->skinningData->normals.emplace_back(mesh.mNormals[i].x, mesh.mNormals[i].y, mesh.mNormals[i].z);
+        }
+    }
+
     constexpr static auto positionSize_bytes = sizeof(aiVector3D);
     constexpr static auto normalSize_bytes = sizeof(aiVector3D);
     constexpr static auto textureCoordSize_bytes = sizeof(decltype(textureCoords)::value_type);
+    constexpr static auto boneInfluencesSize_bytes = sizeof(BoneInfluences);
     constexpr static auto indexSize_bytes = sizeof(decltype(indices)::value_type);
 
     const auto positionArraySize_bytes = mesh.mNumVertices * positionSize_bytes;
     const auto normalArraySize_bytes = mesh.mNumVertices * normalSize_bytes;
     const auto textureCoordArraySize_bytes = textureCoords.size() * textureCoordSize_bytes;
+    const auto boneInfluencesArraySize_bytes = this->skinningData ?
+                this->skinningData->boneInfluences.size() * boneInfluencesSize_bytes : 0;
+    const auto boneInfluencesOffset_bytes = positionArraySize_bytes + normalArraySize_bytes + textureCoordArraySize_bytes;
 
     // Load vertex data onto GPU.
     glGenVertexArrays(1, &this->vao);
@@ -65,12 +88,16 @@ Mesh::Mesh(const aiMesh &mesh, const aiMaterial &material, const std::string &te
     glBindVertexArray(this->vao);
     glBindBuffer(GL_ARRAY_BUFFER, this->vbo);
     glBufferData(GL_ARRAY_BUFFER,
-                 positionArraySize_bytes + normalArraySize_bytes + textureCoordArraySize_bytes,
+                 boneInfluencesOffset_bytes + boneInfluencesArraySize_bytes,
                  nullptr, GL_STATIC_DRAW);
     glBufferSubData(GL_ARRAY_BUFFER, 0, positionArraySize_bytes, mesh.mVertices);
     glBufferSubData(GL_ARRAY_BUFFER, positionArraySize_bytes, normalArraySize_bytes, mesh.mNormals);
     glBufferSubData(GL_ARRAY_BUFFER, positionArraySize_bytes + normalArraySize_bytes,
                     textureCoordArraySize_bytes, textureCoords.data());
+    if (this->skinningData) {
+        glBufferSubData(GL_ARRAY_BUFFER, boneInfluencesOffset_bytes, boneInfluencesArraySize_bytes,
+                        this->skinningData->boneInfluences.data());
+    }
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->ebo);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER,
@@ -92,28 +119,28 @@ Mesh::Mesh(const aiMesh &mesh, const aiMaterial &material, const std::string &te
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, textureCoordSize_bytes,
                           reinterpret_cast<GLvoid*>(positionArraySize_bytes + normalArraySize_bytes));
 
+    if (this->skinningData) {
+        // Define bone index attribute.
+        glEnableVertexAttribArray(10);
+        glVertexAttribIPointer(10, 4, GL_UNSIGNED_BYTE, boneInfluencesSize_bytes,
+                               reinterpret_cast<GLvoid*>(boneInfluencesOffset_bytes + offsetof(BoneInfluences, bones)));
+
+        // Define bone weight attribute.
+        glEnableVertexAttribArray(11);
+        glVertexAttribPointer(11, 4, GL_UNSIGNED_BYTE, GL_TRUE, boneInfluencesSize_bytes,
+                              reinterpret_cast<GLvoid*>(boneInfluencesOffset_bytes + offsetof(BoneInfluences, weights)));
+    }
+
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-    // Load textures.
-    try {
-        this->ambientTextures = loadTexturesFromMaterial(material, aiTextureType_AMBIENT, textureDirectory);
-        this->diffuseTextures = loadTexturesFromMaterial(material, aiTextureType_DIFFUSE, textureDirectory);
-        this->specularTextures = loadTexturesFromMaterial(material, aiTextureType_SPECULAR, textureDirectory);
-    } catch (std::exception&) {
-        glDeleteVertexArrays(1, &this->vao);
-        glDeleteBuffers(1, &this->vbo);
-        glDeleteBuffers(1, &this->ebo);
-        throw;
-    }
 }
 
 Mesh::Mesh(const std::vector<float> &positions,
            const std::vector<float> &normals,
            const std::vector<float> &textureCoords,
            const std::vector<unsigned int> &indices,
-           const std::string &textureFilepath) {
+           const std::string &textureFilepath) : material(createMaterial(textureFilepath)) {
     constexpr static auto positionSize_bytes = 3 * sizeof(float);
     constexpr static auto normalSize_bytes = 3 * sizeof(float);
     constexpr static auto textureCoordSize_bytes = 2 * sizeof(float);
@@ -124,6 +151,7 @@ Mesh::Mesh(const std::vector<float> &positions,
     const auto textureCoordArraySize_bytes = textureCoords.size() * sizeof(float);
 
     this->numIndices = indices.size();
+    this->boundingSphere = BoundingSphere::fromPoints(positions.data(), positions.size() / 3);
 
     // Load vertex data onto GPU
     glGenVertexArrays(1, &this->vao);
@@ -165,20 +193,6 @@ Mesh::Mesh(const std::vector<float> &positions,
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-    // Load textures
-    if (!textureFilepath.empty()) {
-        try {
-            ge::Texture2D texture(textureFilepath);
-            this->ambientTextures.push_back(texture);
-            this->diffuseTextures.push_back(texture);
-        } catch (std::exception&) {
-            glDeleteVertexArrays(1, &this->vao);
-            glDeleteBuffers(1, &this->vbo);
-            glDeleteBuffers(1, &this->ebo);
-            throw;
-        }
-    }
 }
 
 Mesh::~Mesh() {
@@ -188,42 +202,43 @@ Mesh::~Mesh() {
 }
 
 void Mesh::render(ShaderProgram *shader) {
-    this->bindTextures(shader);
+    this->bindMaterial(shader);
+    this->draw();
+}
 
-    // Draw mesh
+void Mesh::draw() {
     glBindVertexArray(this->vao);
     glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(this->numIndices),
                    GL_UNSIGNED_INT, reinterpret_cast<const GLvoid*>(0));
     glBindVertexArray(0);
 }
 
-void Mesh::bindVao() {
-    glBindVertexArray(this->vao);
-}
-
-void Mesh::bindTextures(ShaderProgram *shader) {
-    // Bind textures
-    int textureUnit = 0;
-
-    for (size_t i = 0; i < this->ambientTextures.size(); ++i, ++textureUnit) {
-        glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(textureUnit));
-        shader->setUniform("material.ambientTexture" + std::to_string(i), textureUnit);
-        this->ambientTextures[i].bind();
+void Mesh::swap(Mesh &other) {
+    std::swap(this->vao, other.vao);
+    std::swap(this->vbo, other.vbo);
+    std::swap(this->ebo, other.ebo);
+    std::swap(this->numIndices, other.numIndices);
+    std::swap(this->boundingSphere, other.boundingSphere);
+    std::swap(this->material, other.material);
+
+    // Swap the bind poses rather than the pointers, which other threads check with isSkinned()
+    if (this->skinningData && other.skinningData) {
+        std::swap(*this->skinningData, *other.skinningData);
+    } else {
+        std::swap(this->skinningData, other.skinningData);
     }
+}
 
-    for (size_t i = 0; i < this->diffuseTextures.size(); ++i, ++textureUnit) {
-        glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(textureUnit));
-        shader->setUniform("material.diffuseTexture" + std::to_string(i), textureUnit);
-        this->diffuseTextures[i].bind();
-    }
+void Mesh::setMaterial(std::shared_ptr<Material> material) {
+    this->material = std::move(material);
+}
 
-    for (size_t i = 0; i < this->specularTextures.size(); ++i, ++textureUnit) {
-        glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(textureUnit));
-        shader->setUniform("material.specularTexture" + std::to_string(i), textureUnit);
-        this->specularTextures[i].bind();
-    }
+void Mesh::bindVao() {
+    glBindVertexArray(this->vao);
+}
 
-    glActiveTexture(GL_TEXTURE0);
+void Mesh::bindMaterial(ShaderProgram *shader) {
+    this->material->bind(shader);
 }
 
 } // namespace ge
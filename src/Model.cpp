@@ -109,8 +109,10 @@ Model& Model::setScale(const glm::vec3 &scale) {
 }
 
 void Model::render(ShaderProgram *shader) {
+    // The previous transform is unknown, so only the camera moves the meshes
     shader->setUniform("model", this->getModelMatrix())
-            .setUniform("normal", this->getNormalMatrix());
+            .setUniform("normal", this->getNormalMatrix())
+            .setUniform("previousModel", glm::mat4(0.0f));
 }
 
 } // namespace ge
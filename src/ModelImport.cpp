@@ -0,0 +1,41 @@
+#include <game_engine/ModelImport.h>
+
+#include <assimp/postprocess.h>
+
+#include <game_engine/Exception.h>
+#include <game_engine/ResourceManager.h>
+
+namespace ge {
+
+std::shared_ptr<const ImportedModel> importModelFile(const std::string &modelFilepath) {
+    auto resourceManager = ResourceManager::getInstance();
+
+    return resourceManager->load<const ImportedModel>(ResourceManager::IMPORTED_MODEL,
+                                                      ResourceManager::getKey(modelFilepath), [&]{
+        auto model = readModelFile(modelFilepath);
+
+        // The imported scene takes about as much memory as the meshes created from it
+        return ResourceManager::Loaded<const ImportedModel> {model, model->meshGpuSize_bytes, {modelFilepath}};
+    });
+}
+
+std::shared_ptr<const ImportedModel> readModelFile(const std::string &modelFilepath) {
+    auto model = std::make_shared<ImportedModel>();
+    model->scene = model->importer.ReadFile(modelFilepath, aiProcess_Triangulate | aiProcess_FlipUVs);
+
+    const auto scene = model->scene;
+    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+        throw LoadError(model->importer.GetErrorString());
+    }
+
+    // Positions, normals and texture coordinates, bone influences and indices
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        const auto &mesh = *scene->mMeshes[i];
+        const auto vertexSize_bytes = 8 * sizeof(float) + (mesh.HasBones() ? 8 : 0);
+        model->meshGpuSize_bytes += mesh.mNumVertices * vertexSize_bytes + mesh.mNumFaces * 3 * sizeof(unsigned int);
+    }
+
+    return model;
+}
+
+} // namespace ge
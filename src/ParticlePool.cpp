@@ -0,0 +1,180 @@
+#include <game_engine/ParticlePool.h>
+
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define GE_PARTICLES_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace {
+
+/// Multiple of 4 so that every range but the last is processed entirely with SSE.
+constexpr size_t integrationGrainSize = 16384;
+
+} // namespace
+
+namespace ge {
+
+ParticlePool::ParticlePool(size_t capacity)
+    : positionsX(capacity), positionsY(capacity), positionsZ(capacity),
+      velocitiesX(capacity), velocitiesY(capacity), velocitiesZ(capacity),
+      ages(capacity), lifetimes(capacity), sizes(capacity), colors(capacity) {}
+
+bool ParticlePool::emit(const Particle &particle) {
+    if (this->numParticles == this->capacity()) return false;
+
+    const auto i = this->numParticles++;
+    this->positionsX[i] = particle.position.x;
+    this->positionsY[i] = particle.position.y;
+    this->positionsZ[i] = particle.position.z;
+    this->velocitiesX[i] = particle.velocity.x;
+    this->velocitiesY[i] = particle.velocity.y;
+    this->velocitiesZ[i] = particle.velocity.z;
+    this->ages[i] = 0.0f;
+    this->lifetimes[i] = particle.lifetime_s;
+    this->sizes[i] = particle.size;
+    this->colors[i] = particle.color;
+    return true;
+}
+
+void ParticlePool::update(float duration_s, const ParticleForces &forces, JobSystem &jobSystem) {
+    const auto numRanges = (this->numParticles + integrationGrainSize - 1) / integrationGrainSize;
+    this->numLiveParticlesPerRange.resize(numRanges);
+
+    jobSystem.parallelFor(this->numParticles, integrationGrainSize, [&](size_t begin, size_t end){
+        this->integrate(begin, end, duration_s, forces);
+        this->numLiveParticlesPerRange[begin / integrationGrainSize] = this->compactRange(begin, end);
+    });
+
+    this->removeExpired(jobSystem);
+}
+
+void ParticlePool::integrate(size_t begin, size_t end, float duration_s, const ParticleForces &forces) {
+    // v' = v * (1 - drag * dt) + a * dt, p' = p + v' * dt
+    const auto damping = std::max(0.0f, 1.0f - forces.drag * duration_s);
+    const auto deltaVelocity = forces.acceleration * duration_s;
+
+    auto i = begin;
+
+#ifdef GE_PARTICLES_SSE
+    const auto dt4 = _mm_set1_ps(duration_s);
+    const auto damping4 = _mm_set1_ps(damping);
+    const auto deltaVelocityX4 = _mm_set1_ps(deltaVelocity.x);
+    const auto deltaVelocityY4 = _mm_set1_ps(deltaVelocity.y);
+    const auto deltaVelocityZ4 = _mm_set1_ps(deltaVelocity.z);
+
+    for (; i + 4 <= end; i += 4) {
+        const auto velocityX = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&this->velocitiesX[i]), damping4), deltaVelocityX4);
+        const auto velocityY = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&this->velocitiesY[i]), damping4), deltaVelocityY4);
+        const auto velocityZ = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&this->velocitiesZ[i]), damping4), deltaVelocityZ4);
+        _mm_storeu_ps(&this->velocitiesX[i], velocityX);
+        _mm_storeu_ps(&this->velocitiesY[i], velocityY);
+        _mm_storeu_ps(&this->velocitiesZ[i], velocityZ);
+
+        _mm_storeu_ps(&this->positionsX[i], _mm_add_ps(_mm_loadu_ps(&this->positionsX[i]), _mm_mul_ps(velocityX, dt4)));
+        _mm_storeu_ps(&this->positionsY[i], _mm_add_ps(_mm_loadu_ps(&this->positionsY[i]), _mm_mul_ps(velocityY, dt4)));
+        _mm_storeu_ps(&this->positionsZ[i], _mm_add_ps(_mm_loadu_ps(&this->positionsZ[i]), _mm_mul_ps(velocityZ, dt4)));
+
+        _mm_storeu_ps(&this->ages[i], _mm_add_ps(_mm_loadu_ps(&this->ages[i]), dt4));
+    }
+#endif
+
+    for (; i < end; ++i) {
+        this->velocitiesX[i] = this->velocitiesX[i] * damping + deltaVelocity.x;
+        this->velocitiesY[i] = this->velocitiesY[i] * damping + deltaVelocity.y;
+        this->velocitiesZ[i] = this->velocitiesZ[i] * damping + deltaVelocity.z;
+
+        this->positionsX[i] += this->velocitiesX[i] * duration_s;
+        this->positionsY[i] += this->velocitiesY[i] * duration_s;
+        this->positionsZ[i] += this->velocitiesZ[i] * duration_s;
+
+        this->ages[i] += duration_s;
+    }
+}
+
+size_t ParticlePool::compactRange(size_t begin, size_t end) {
+    auto i = begin;
+
+#ifdef GE_PARTICLES_SSE
+    // Nothing moves until the first expired particle, so skip four live particles at a time
+    while (i + 4 <= end &&
+           _mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(&this->ages[i]), _mm_loadu_ps(&this->lifetimes[i]))) == 0) {
+        i += 4;
+    }
+#endif
+
+    auto numLive = i - begin;
+    for (; i < end; ++i) {
+        if (this->ages[i] >= this->lifetimes[i]) continue;
+
+        const auto to = begin + numLive++;
+        if (to != i) this->moveParticle(i, to);
+    }
+
+    return numLive;
+}
+
+void ParticlePool::removeExpired(JobSystem &jobSystem) {
+    const auto numRanges = this->numLiveParticlesPerRange.size();
+
+    // Every range holds its live particles first, then expired ones. The expired slots
+    // below the new size are holes, which the live particles past it fill in order.
+    // Prefix sums number both per range, so every live particle finds its hole without
+    // the ranges waiting on each other, and no hole is also read from.
+    size_t newSize = 0;
+    for (const auto numLive : this->numLiveParticlesPerRange) {
+        newSize += numLive;
+    }
+
+    std::vector<size_t> firstHoles(numRanges + 1, 0);
+    std::vector<size_t> firstMovers(numRanges + 1, 0);
+    for (size_t range = 0; range < numRanges; ++range) {
+        const auto begin = range * integrationGrainSize;
+        const auto end = std::min(begin + integrationGrainSize, this->numParticles);
+        const auto liveEnd = begin + this->numLiveParticlesPerRange[range];
+
+        const auto numHoles = liveEnd < newSize ? std::min(end, newSize) - liveEnd : 0;
+        const auto numMovers = liveEnd > newSize ? liveEnd - std::max(begin, newSize) : 0;
+        firstHoles[range + 1] = firstHoles[range] + numHoles;
+        firstMovers[range + 1] = firstMovers[range] + numMovers;
+    }
+
+    jobSystem.parallelFor(numRanges, 1, [&](size_t firstRange, size_t lastRange){
+        for (auto range = firstRange; range < lastRange; ++range) {
+            const auto numMovers = firstMovers[range + 1] - firstMovers[range];
+            if (numMovers == 0) continue;
+
+            // Range of the first hole to fill, then the holes in order
+            auto mover = firstMovers[range];
+            auto holeRange = static_cast<size_t>(std::upper_bound(firstHoles.cbegin(), firstHoles.cend(), mover) -
+                                                 firstHoles.cbegin()) - 1;
+
+            const auto begin = range * integrationGrainSize;
+            const auto liveEnd = begin + this->numLiveParticlesPerRange[range];
+            for (auto from = std::max(begin, newSize); from < liveEnd; ++from, ++mover) {
+                while (mover >= firstHoles[holeRange + 1]) ++holeRange;
+
+                const auto holeBegin = holeRange * integrationGrainSize + this->numLiveParticlesPerRange[holeRange];
+                this->moveParticle(from, holeBegin + (mover - firstHoles[holeRange]));
+            }
+        }
+    });
+
+    this->numParticles = newSize;
+}
+
+void ParticlePool::moveParticle(size_t from, size_t to) {
+    this->positionsX[to] = this->positionsX[from];
+    this->positionsY[to] = this->positionsY[from];
+    this->positionsZ[to] = this->positionsZ[from];
+    this->velocitiesX[to] = this->velocitiesX[from];
+    this->velocitiesY[to] = this->velocitiesY[from];
+    this->velocitiesZ[to] = this->velocitiesZ[from];
+    this->ages[to] = this->ages[from];
+    this->lifetimes[to] = this->lifetimes[from];
+    this->sizes[to] = this->sizes[from];
+    this->colors[to] = this->colors[from];
+}
+
+} // namespace ge
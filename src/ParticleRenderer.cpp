@@ -0,0 +1,102 @@
+#include <game_engine/ParticleRenderer.h>
+
+#include <cstddef>
+
+#include <game_engine/Texture2D.h>
+
+namespace {
+
+/// Corners of the quad shared by all particles, drawn as a triangle strip.
+const float quadCorners[] {
+    -0.5f, -0.5f,
+     0.5f, -0.5f,
+    -0.5f,  0.5f,
+     0.5f,  0.5f
+};
+
+} // namespace
+
+namespace ge {
+
+ParticleRenderer::ParticleRenderer(const std::string &vertexShaderPath, const std::string &fragmentShaderPath)
+    : shader(std::make_unique<ShaderProgram>(vertexShaderPath, fragmentShaderPath)) {
+    glGenVertexArrays(1, &this->vao);
+    glBindVertexArray(this->vao);
+
+    glGenBuffers(1, &this->quadBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, this->quadBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadCorners), quadCorners, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+
+    // Position and size, color and age of every particle
+    glGenBuffers(1, &this->instanceBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, this->instanceBuffer);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance),
+                          reinterpret_cast<GLvoid*>(offsetof(ParticleInstance, position)));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ParticleInstance),
+                          reinterpret_cast<GLvoid*>(offsetof(ParticleInstance, color)));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance),
+                          reinterpret_cast<GLvoid*>(offsetof(ParticleInstance, normalizedAge)));
+    glVertexAttribDivisor(3, 1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+ParticleRenderer::~ParticleRenderer() {
+    glDeleteBuffers(1, &this->instanceBuffer);
+    glDeleteBuffers(1, &this->quadBuffer);
+    glDeleteVertexArrays(1, &this->vao);
+}
+
+void ParticleRenderer::render(const std::vector<FramePacket::ParticleBatch> &particleBatches) {
+    if (particleBatches.empty()) return;
+
+    this->shader->use();
+    this->shader->setUniform("particleTexture", 0);
+
+    // Particles keep the velocities of the surfaces behind them in the second draw buffer
+    glEnable(GL_BLEND);
+    glDepthMask(GL_FALSE);
+    glColorMaski(1, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glBindVertexArray(this->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, this->instanceBuffer);
+
+    for (const auto &particleBatch : particleBatches) {
+        const auto &instances = *particleBatch.instances;
+
+        // Orphan the previous instances instead of waiting for their draw to finish
+        glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(ParticleInstance), instances.data(),
+                     GL_STREAM_DRAW);
+
+        if (particleBatch.blendMode == ParticleBlendMode::ADDITIVE) {
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+        } else {
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        }
+
+        this->shader->setUniform("hasTexture", particleBatch.texture != nullptr);
+        if (particleBatch.texture) {
+            glActiveTexture(GL_TEXTURE0);
+            particleBatch.texture->bind();
+            this->shader->setUniform("uvTransform", particleBatch.texture->getUvTransform())
+                    .setUniform("textureLayer", static_cast<float>(particleBatch.texture->getLayer()));
+        }
+
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(instances.size()));
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glColorMaski(1, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+}
+
+} // namespace ge
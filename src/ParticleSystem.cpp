@@ -0,0 +1,137 @@
+#include <game_engine/ParticleSystem.h>
+
+#include <algorithm>
+#include <numeric>
+
+#include <glm/common.hpp>
+#include <glm/packing.hpp>
+
+#include <game_engine/FramePacket.h>
+#include <game_engine/JobSystem.h>
+
+namespace {
+
+constexpr size_t packingGrainSize = 16384;
+
+} // namespace
+
+namespace ge {
+
+ParticleSystem::ParticleSystem(size_t capacity, ParticleBlendMode blendMode,
+                               std::shared_ptr<const Texture2D> texture)
+    : pool(capacity), blendMode(blendMode), texture(std::move(texture)) {}
+
+size_t ParticleSystem::addEmitter(const ParticleEmitter &emitter) {
+    this->emitters.push_back(emitter);
+    this->emissionRemainders.push_back(0.0f);
+    return this->emitters.size() - 1;
+}
+
+size_t ParticleSystem::burst(size_t emitter, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (!this->emit(this->emitters[emitter])) return i;
+    }
+
+    return count;
+}
+
+void ParticleSystem::update(std::chrono::duration<float> updateDuration) {
+    const auto duration_s = updateDuration.count();
+
+    for (size_t i = 0; i < this->emitters.size(); ++i) {
+        const auto &emitter = this->emitters[i];
+        if (!emitter.enabled) continue;
+
+        // Carry fractions of particles over so that low rates still emit
+        auto &remainder = this->emissionRemainders[i];
+        remainder += emitter.rate_per_s * duration_s;
+        const auto numParticles = static_cast<size_t>(remainder);
+        remainder -= numParticles;
+
+        for (size_t j = 0; j < numParticles; ++j) {
+            if (!this->emit(emitter)) {
+                remainder = 0.0f;
+                break;
+            }
+        }
+    }
+
+    this->pool.update(duration_s, this->forces);
+}
+
+void ParticleSystem::addToFramePacket(FramePacket &framePacket) {
+    const auto numParticles = this->pool.size();
+    if (numParticles == 0) return;
+
+    const auto positionsX = this->pool.getPositionsX();
+    const auto positionsY = this->pool.getPositionsY();
+    const auto positionsZ = this->pool.getPositionsZ();
+    auto &jobSystem = JobSystem::getInstance();
+
+    // Alpha blending needs the farthest particles drawn first
+    std::vector<size_t> order;
+    if (this->blendMode == ParticleBlendMode::ALPHA) {
+        const auto viewPosition = framePacket.viewPosition;
+        std::vector<float> squaredDistances(numParticles);
+        jobSystem.parallelFor(numParticles, packingGrainSize, [&](size_t begin, size_t end){
+            for (auto i = begin; i < end; ++i) {
+                const glm::vec3 offset(positionsX[i] - viewPosition.x, positionsY[i] - viewPosition.y,
+                                       positionsZ[i] - viewPosition.z);
+                squaredDistances[i] = offset.x * offset.x + offset.y * offset.y + offset.z * offset.z;
+            }
+        });
+
+        order.resize(numParticles);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&squaredDistances](size_t a, size_t b){
+            return squaredDistances[a] > squaredDistances[b];
+        });
+    }
+
+    // Reuse a snapshot the renderer is done with to avoid reallocating it on every frame
+    auto snapshot = std::find_if(this->snapshots.begin(), this->snapshots.end(), [](const auto &snapshot){
+        return snapshot.use_count() == 1;
+    });
+    if (snapshot == this->snapshots.end()) {
+        snapshot = this->snapshots.insert(snapshot, std::make_shared<std::vector<ParticleInstance>>());
+    }
+
+    auto instances = *snapshot;
+    instances->resize(numParticles);
+    jobSystem.parallelFor(numParticles, packingGrainSize, [&](size_t begin, size_t end){
+        const auto ages = this->pool.getAges();
+        const auto lifetimes = this->pool.getLifetimes();
+        const auto sizes = this->pool.getSizes();
+        const auto colors = this->pool.getColors();
+
+        for (auto i = begin; i < end; ++i) {
+            const auto particle = order.empty() ? i : order[i];
+            auto &instance = (*instances)[i];
+            instance.position = glm::vec3(positionsX[particle], positionsY[particle], positionsZ[particle]);
+            instance.size = sizes[particle];
+            instance.color = colors[particle];
+            instance.normalizedAge = std::min(ages[particle] / lifetimes[particle], 1.0f);
+        }
+    });
+
+    framePacket.particleBatches.push_back({std::move(instances), this->texture, this->blendMode});
+}
+
+bool ParticleSystem::emit(const ParticleEmitter &emitter) {
+    std::uniform_real_distribution<float> signedUnit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    auto &random = this->randomEngine;
+
+    ParticlePool::Particle particle;
+    particle.position = emitter.position +
+            emitter.positionSpread * glm::vec3(signedUnit(random), signedUnit(random), signedUnit(random));
+    particle.velocity = emitter.velocity +
+            emitter.velocitySpread * glm::vec3(signedUnit(random), signedUnit(random), signedUnit(random));
+    particle.lifetime_s = glm::mix(emitter.minLifetime_s, emitter.maxLifetime_s, unit(random));
+    particle.size = glm::mix(emitter.minSize, emitter.maxSize, unit(random));
+    particle.color = glm::packUnorm4x8(glm::clamp(emitter.color, 0.0f, 1.0f));
+
+    return this->pool.emit(particle);
+}
+
+} // namespace ge
@@ -0,0 +1,291 @@
+#include <game_engine/PostProcessor.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <game_engine/Exception.h>
+
+namespace {
+
+/// Length of the sequence of jitter offsets. Longer sequences converge to finer details
+/// but take longer to do so.
+constexpr unsigned int numJitterOffsets = 16;
+
+/// Bloom is blurry, so it is stored without alpha at lower precision.
+constexpr GLenum bloomFormat = GL_R11F_G11F_B10F;
+
+/// Format of the tonemapped scene before upscaling, which is in the displayable range.
+constexpr GLenum tonemappedFormat = GL_RGBA8;
+
+///
+/// \brief bindTexture Binds a 2D texture to a texture unit.
+///
+void bindTexture(unsigned int textureUnit, unsigned int texture) {
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+///
+/// \brief halton Returns an element of the Halton sequence in [0, 1) with the given base.
+///
+float halton(unsigned int index, unsigned int base) {
+    auto fraction = 1.0f;
+    auto result = 0.0f;
+    for (; index > 0; index /= base) {
+        fraction /= static_cast<float>(base);
+        result += fraction * static_cast<float>(index % base);
+    }
+    return result;
+}
+
+glm::vec2 getTexelSize(const ge::RenderTarget &target) {
+    return {1.0f / target.getDesc().width, 1.0f / target.getDesc().height};
+}
+
+} // namespace
+
+namespace ge {
+
+GLenum PostProcessor::sceneFormat = GL_RGBA16F;
+
+PostProcessor::PostProcessor(const std::string &vertexShaderPath, const std::string &temporalShaderPath,
+                             const std::string &bloomShaderPath, const std::string &tonemapShaderPath,
+                             const std::string &upscaleShaderPath)
+    : temporalShader(std::make_unique<ShaderProgram>(vertexShaderPath, temporalShaderPath)),
+      bloomDownsampleShader(std::make_unique<ShaderProgram>(vertexShaderPath, bloomShaderPath, "",
+                                                            std::vector<std::string>{"DOWNSAMPLE"})),
+      bloomUpsampleShader(std::make_unique<ShaderProgram>(vertexShaderPath, bloomShaderPath, "",
+                                                          std::vector<std::string>{"UPSAMPLE"})),
+      tonemapShader(std::make_unique<ShaderProgram>(vertexShaderPath, tonemapShaderPath)),
+      upscaleShader(std::make_unique<ShaderProgram>(vertexShaderPath, upscaleShaderPath)) {
+    glGenVertexArrays(1, &this->vao);
+
+    this->passesEnabled.fill(true);
+}
+
+PostProcessor::~PostProcessor() {
+    glDeleteVertexArrays(1, &this->vao);
+}
+
+void PostProcessor::addPasses(RenderGraph *graph, RenderGraph::Resource scene, RenderGraph::Resource output) {
+    // Temporal anti-aliasing resolves the scene at the output's resolution
+    auto source = scene;
+    if (this->passesEnabled[TEMPORAL_ANTI_ALIASING]) {
+        source = this->addTemporalAntiAliasingPass(graph, scene, graph->getDesc(output).width,
+                                                   graph->getDesc(output).height);
+    } else {
+        this->historyValid = false;
+    }
+
+    const auto sourceWidth = graph->getDesc(source).width;
+    const auto sourceHeight = graph->getDesc(source).height;
+    const auto upscaling = sourceWidth != graph->getDesc(output).width ||
+            sourceHeight != graph->getDesc(output).height;
+
+    const auto bloom = this->addBloomPasses(graph, source);
+    const auto bloomEnabled = this->passesEnabled[BLOOM];
+
+    // Combine the scene and its bloom, at the scene's resolution when upscaling
+    auto reads = std::vector<RenderGraph::Resource>{source};
+    if (bloomEnabled) reads.push_back(bloom);
+
+    const auto tonemapped = upscaling ? graph->createRenderTarget("tonemapped", {sourceWidth, sourceHeight,
+                                                                                 tonemappedFormat, 0})
+                                      : output;
+
+    graph->addPass("tonemapping", reads, {tonemapped}, [this, graph, source, bloom, bloomEnabled]{
+        this->tonemapShader->use();
+        this->tonemapShader->setUniform("sceneTexture", 0)
+                .setUniform("bloomTexture", 1)
+                .setUniform("bloomEnabled", bloomEnabled)
+                .setUniform("bloomIntensity", this->bloomIntensity)
+                .setUniform("tonemappingEnabled", this->passesEnabled[TONEMAPPING])
+                .setUniform("exposure", this->exposure);
+        bindTexture(0, graph->getRenderTarget(source).getColorTexture());
+        if (bloomEnabled) bindTexture(1, graph->getRenderTarget(bloom).getColorTexture());
+
+        this->drawFullscreenTriangle();
+
+        bindTexture(1, 0);
+        bindTexture(0, 0);
+    });
+
+    if (upscaling) {
+        graph->addPass("upscaling", {tonemapped}, {output}, [this, graph, tonemapped]{
+            this->upscaleShader->use();
+            this->upscaleShader->setUniform("sourceTexture", 0)
+                    .setUniform("texelSize", getTexelSize(graph->getRenderTarget(tonemapped)))
+                    .setUniform("sharpeningEnabled", this->passesEnabled[SHARPENING])
+                    .setUniform("sharpness", this->sharpness);
+            bindTexture(0, graph->getRenderTarget(tonemapped).getColorTexture());
+
+            this->drawFullscreenTriangle();
+
+            bindTexture(0, 0);
+        });
+    }
+}
+
+glm::vec2 PostProcessor::getJitter(int sceneWidth, int sceneHeight) const {
+    if (!this->passesEnabled[TEMPORAL_ANTI_ALIASING]) return glm::vec2(0.0f);
+
+    // Bases 2 and 3 cover the texel evenly with few offsets
+    const auto index = this->frameIndex % numJitterOffsets + 1;
+    const auto jitter = glm::vec2(halton(index, 2), halton(index, 3)) - 0.5f;
+    return jitter * 2.0f / glm::vec2(sceneWidth, sceneHeight);
+}
+
+void PostProcessor::resetHistory() {
+    this->historyValid = false;
+}
+
+RenderGraph::Resource PostProcessor::addTemporalAntiAliasingPass(RenderGraph *graph, RenderGraph::Resource scene,
+                                                                 int width, int height) {
+    const auto sceneDesc = graph->getDesc(scene);
+    if (!sceneDesc.depthFormat || !sceneDesc.velocityFormat) {
+        throw Error("Temporal anti-aliasing requires the depth and velocity textures of the scene");
+    }
+
+    const auto jitter_texels = this->getJitter(sceneDesc.width, sceneDesc.height) * 0.5f *
+            glm::vec2(sceneDesc.width, sceneDesc.height);
+    ++this->frameIndex;
+
+    // The history is kept across frames, so it is not recycled by the graph
+    const RenderTargetDesc historyDesc {width, height, sceneFormat, 0};
+    if (!this->histories[0] || !(this->histories[0]->getDesc() == historyDesc)) {
+        for (auto &history : this->histories) {
+            history = std::make_unique<RenderTarget>(historyDesc);
+        }
+        this->historyValid = false;
+    }
+
+    const auto history = graph->importRenderTarget("history", this->histories[this->currentHistory].get());
+    this->currentHistory = 1 - this->currentHistory;
+    const auto resolved = graph->importRenderTarget("resolved history",
+                                                    this->histories[this->currentHistory].get());
+    graph->markOutput(resolved);
+
+    graph->addPass("temporal anti-aliasing", {scene, history}, {resolved},
+                   [this, graph, scene, history, jitter_texels, historyValid = this->historyValid]{
+        const auto &sceneTarget = graph->getRenderTarget(scene);
+        this->temporalShader->use();
+        this->temporalShader->setUniform("sceneTexture", 0)
+                .setUniform("velocityTexture", 1)
+                .setUniform("depthTexture", 2)
+                .setUniform("historyTexture", 3)
+                .setUniform("historyValid", historyValid)
+                .setUniform("jitter", jitter_texels)
+                .setUniform("blendFactor", this->temporalBlendFactor);
+        bindTexture(0, sceneTarget.getColorTexture());
+        bindTexture(1, sceneTarget.getVelocityTexture());
+        bindTexture(2, sceneTarget.getDepthTexture());
+        bindTexture(3, graph->getRenderTarget(history).getColorTexture());
+
+        this->drawFullscreenTriangle();
+
+        bindTexture(3, 0);
+        bindTexture(2, 0);
+        bindTexture(1, 0);
+        bindTexture(0, 0);
+    });
+    this->historyValid = true;
+
+    return resolved;
+}
+
+RenderGraph::Resource PostProcessor::addBloomPasses(RenderGraph *graph, RenderGraph::Resource scene) {
+    // Downsample the bright parts of the scene into the mip chain
+    std::vector<RenderGraph::Resource> levels;
+    auto source = scene;
+
+    for (int level = 0; level < std::max(this->numBloomLevels, 1); ++level) {
+        const auto &sourceDesc = graph->getDesc(source);
+        const auto width = std::max(1, sourceDesc.width / 2);
+        const auto height = std::max(1, sourceDesc.height / 2);
+        if (level > 0 && width == sourceDesc.width && height == sourceDesc.height) break;
+
+        const auto name = "bloom downsample " + std::to_string(level);
+        const auto target = graph->createRenderTarget(name, {width, height, bloomFormat, 0});
+        graph->addPass(name, {source}, {target}, [this, graph, source, level]{
+            this->bloomDownsampleShader->use();
+            this->bloomDownsampleShader->setUniform("sourceTexture", 0)
+                    .setUniform("threshold", this->bloomThreshold)
+                    .setUniform("texelSize", getTexelSize(graph->getRenderTarget(source)))
+                    .setUniform("prefilter", level == 0);
+            bindTexture(0, graph->getRenderTarget(source).getColorTexture());
+
+            this->drawFullscreenTriangle();
+        });
+
+        levels.push_back(target);
+        source = target;
+    }
+
+    // Upsample back up the chain, adding every level onto the next larger one
+    for (auto level = levels.size() - 1; level > 0; --level) {
+        const auto source = levels[level];
+        graph->addPass("bloom upsample " + std::to_string(level), {source}, {levels[level - 1]},
+                       [this, graph, source]{
+            this->bloomUpsampleShader->use();
+            this->bloomUpsampleShader->setUniform("sourceTexture", 0)
+                    .setUniform("texelSize", getTexelSize(graph->getRenderTarget(source)));
+            bindTexture(0, graph->getRenderTarget(source).getColorTexture());
+
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_ONE, GL_ONE);
+            this->drawFullscreenTriangle();
+            glDisable(GL_BLEND);
+        });
+    }
+
+    return levels[0];
+}
+
+void PostProcessor::drawFullscreenTriangle() const {
+    const auto depthTestEnabled = glIsEnabled(GL_DEPTH_TEST);
+    glDisable(GL_DEPTH_TEST);
+
+    glBindVertexArray(this->vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+
+    if (depthTestEnabled) glEnable(GL_DEPTH_TEST);
+}
+
+PostProcessor& PostProcessor::setPassEnabled(Pass pass, bool enabled) {
+    this->passesEnabled[pass] = enabled;
+    return *this;
+}
+
+PostProcessor& PostProcessor::setTemporalBlendFactor(float temporalBlendFactor) {
+    this->temporalBlendFactor = temporalBlendFactor;
+    return *this;
+}
+
+PostProcessor& PostProcessor::setExposure(float exposure) {
+    this->exposure = exposure;
+    return *this;
+}
+
+PostProcessor& PostProcessor::setBloomThreshold(float bloomThreshold) {
+    this->bloomThreshold = bloomThreshold;
+    return *this;
+}
+
+PostProcessor& PostProcessor::setBloomIntensity(float bloomIntensity) {
+    this->bloomIntensity = bloomIntensity;
+    return *this;
+}
+
+PostProcessor& PostProcessor::setNumBloomLevels(int numBloomLevels) {
+    this->numBloomLevels = numBloomLevels;
+    return *this;
+}
+
+PostProcessor& PostProcessor::setSharpness(float sharpness) {
+    this->sharpness = sharpness;
+    return *this;
+}
+
+} // namespace ge
@@ -0,0 +1,271 @@
+#include <game_engine/RenderGraph.h>
+
+#include <algorithm>
+#include <limits>
+
+#include <glad/glad.h>
+
+#include <game_engine/Exception.h>
+
+namespace {
+
+constexpr auto none = std::numeric_limits<size_t>::max();
+
+} // namespace
+
+namespace ge {
+
+RenderGraph::RenderGraph(RenderTargetPool *renderTargetPool)
+    : renderTargetPool(renderTargetPool) {}
+
+RenderGraph::Resource RenderGraph::createRenderTarget(const std::string &name, const RenderTargetDesc &desc) {
+    this->resources.push_back({name, RENDER_TARGET, desc, false, nullptr});
+    return this->resources.size() - 1;
+}
+
+RenderGraph::Resource RenderGraph::importBackbuffer(const std::string &name, int width, int height) {
+    this->resources.push_back({name, BACKBUFFER, {width, height, 0, 0}, true, nullptr});
+    return this->resources.size() - 1;
+}
+
+RenderGraph::Resource RenderGraph::importRenderTarget(const std::string &name, RenderTarget *target) {
+    this->resources.push_back({name, IMPORTED_RENDER_TARGET, target->getDesc(), false, target});
+    return this->resources.size() - 1;
+}
+
+RenderGraph::Resource RenderGraph::importResource(const std::string &name) {
+    this->resources.push_back({name, IMPORTED, {}, false, nullptr});
+    return this->resources.size() - 1;
+}
+
+void RenderGraph::markOutput(Resource resource) {
+    this->resources[resource].output = true;
+}
+
+void RenderGraph::addPass(const std::string &name, const std::vector<Resource> &reads,
+                          const std::vector<Resource> &writes, std::function<void()> execute) {
+    this->passes.push_back({name, reads, writes, std::move(execute)});
+}
+
+void RenderGraph::execute() {
+    std::vector<size_t> order;
+    try {
+        order = this->compile();
+    } catch (...) {
+        this->resources.clear();
+        this->passes.clear();
+        throw;
+    }
+
+    // Render targets live from the first to the last pass using them
+    std::vector<size_t> firstUses(this->resources.size(), none), lastUses(this->resources.size(), none);
+    for (size_t i = 0; i < order.size(); ++i) {
+        const auto &pass = this->passes[order[i]];
+        for (const auto resourceList : {&pass.reads, &pass.writes}) {
+            for (const auto resource : *resourceList) {
+                if (this->resources[resource].type != RENDER_TARGET) continue;
+                if (firstUses[resource] == none) firstUses[resource] = i;
+                lastUses[resource] = i;
+            }
+        }
+    }
+
+    this->executedPasses.clear();
+    GpuTimer *activeTimer = nullptr;
+    try {
+        auto boundFramebuffer = none;
+        for (size_t i = 0; i < order.size(); ++i) {
+            const auto &pass = this->passes[order[i]];
+
+            for (size_t resource = 0; resource < this->resources.size(); ++resource) {
+                if (firstUses[resource] == i) {
+                    auto &entry = this->resources[resource];
+                    entry.target = &this->renderTargetPool->acquire(entry.desc);
+                }
+            }
+
+            const auto framebuffer = this->findFramebuffer(pass);
+            if (framebuffer && *framebuffer != boundFramebuffer) {
+                const auto &entry = this->resources[*framebuffer];
+                if (entry.type == BACKBUFFER) {
+                    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                    glViewport(0, 0, entry.desc.width, entry.desc.height);
+                } else {
+                    entry.target->bind();
+                }
+                boundFramebuffer = *framebuffer;
+            }
+
+            auto &passTimer = this->passTimers[pass.name];
+            if (!passTimer) passTimer = std::make_unique<GpuTimer>();
+
+            activeTimer = passTimer.get();
+            activeTimer->begin();
+            pass.execute();
+            activeTimer->end();
+            activeTimer = nullptr;
+
+            this->executedPasses.push_back(pass.name);
+
+            for (size_t resource = 0; resource < this->resources.size(); ++resource) {
+                if (lastUses[resource] == i) {
+                    auto &entry = this->resources[resource];
+                    this->renderTargetPool->release(*entry.target);
+                    entry.target = nullptr;
+                }
+            }
+        }
+    } catch (...) {
+        if (activeTimer) activeTimer->end();
+
+        for (const auto &entry : this->resources) {
+            if (entry.type == RENDER_TARGET && entry.target) this->renderTargetPool->release(*entry.target);
+        }
+        this->resources.clear();
+        this->passes.clear();
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        throw;
+    }
+
+    this->resources.clear();
+    this->passes.clear();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+float RenderGraph::getPassTime_ms(const std::string &name) const {
+    const auto passTimer = this->passTimers.find(name);
+    return passTimer == this->passTimers.end() ? 0.0f : passTimer->second->getElapsed_ms();
+}
+
+float RenderGraph::getFrameTime_ms() const {
+    auto frameTime_ms = 0.0f;
+    for (const auto &name : this->executedPasses) {
+        frameTime_ms += this->getPassTime_ms(name);
+    }
+    return frameTime_ms;
+}
+
+std::vector<size_t> RenderGraph::compile() const {
+    const auto numPasses = this->passes.size();
+
+    // Reading or writing a resource requires its last writer to run first, since
+    // passes draw over the previous contents of their render targets. Writing must
+    // also wait for the passes reading the previous contents.
+    std::vector<std::vector<size_t>> requiredPasses(numPasses), precedingPasses(numPasses);
+    std::vector<size_t> lastWriters(this->resources.size(), none);
+    std::vector<std::vector<size_t>> readersSinceWrite(this->resources.size());
+
+    for (size_t pass = 0; pass < numPasses; ++pass) {
+        const auto &reads = this->passes[pass].reads;
+        const auto &writes = this->passes[pass].writes;
+
+        const auto numFramebuffers = std::count_if(writes.begin(), writes.end(), [this](Resource resource){
+            return this->resources[resource].type != IMPORTED;
+        });
+        if (numFramebuffers > 1) {
+            throw Error("Render pass " + this->passes[pass].name + " writes several render targets");
+        }
+
+        for (const auto resource : reads) {
+            if (lastWriters[resource] != none) {
+                requiredPasses[pass].push_back(lastWriters[resource]);
+            } else if (this->resources[resource].type == RENDER_TARGET) {
+                throw Error("Render pass " + this->passes[pass].name + " reads render target " +
+                            this->resources[resource].name + " before any pass writes it");
+            }
+            readersSinceWrite[resource].push_back(pass);
+        }
+
+        for (const auto resource : writes) {
+            if (lastWriters[resource] != none) {
+                requiredPasses[pass].push_back(lastWriters[resource]);
+            }
+            for (const auto reader : readersSinceWrite[resource]) {
+                if (reader != pass) precedingPasses[pass].push_back(reader);
+            }
+            readersSinceWrite[resource].clear();
+            lastWriters[resource] = pass;
+        }
+    }
+
+    // Cull the passes that do not contribute to an output
+    std::vector<bool> used(numPasses, false);
+    std::vector<size_t> stack;
+    for (size_t pass = 0; pass < numPasses; ++pass) {
+        for (const auto resource : this->passes[pass].writes) {
+            if (this->resources[resource].output && !used[pass]) {
+                used[pass] = true;
+                stack.push_back(pass);
+            }
+        }
+    }
+    while (!stack.empty()) {
+        const auto pass = stack.back();
+        stack.pop_back();
+        for (const auto requiredPass : requiredPasses[pass]) {
+            if (!used[requiredPass]) {
+                used[requiredPass] = true;
+                stack.push_back(requiredPass);
+            }
+        }
+    }
+
+    // Order the used passes topologically
+    std::vector<std::vector<size_t>> dependentPasses(numPasses);
+    std::vector<size_t> numDependencies(numPasses, 0);
+    for (size_t pass = 0; pass < numPasses; ++pass) {
+        if (!used[pass]) continue;
+
+        for (const auto dependencies : {&requiredPasses[pass], &precedingPasses[pass]}) {
+            for (const auto dependency : *dependencies) {
+                if (!used[dependency]) continue;
+                dependentPasses[dependency].push_back(pass);
+                ++numDependencies[pass];
+            }
+        }
+    }
+
+    std::vector<size_t> readyPasses;
+    for (size_t pass = 0; pass < numPasses; ++pass) {
+        if (used[pass] && numDependencies[pass] == 0) readyPasses.push_back(pass);
+    }
+
+    std::vector<size_t> order;
+    auto boundFramebuffer = none;
+    while (!readyPasses.empty()) {
+        // Prefer the first declared pass rendering into the bound framebuffer
+        auto next = readyPasses.begin();
+        for (auto readyPass = readyPasses.begin(); readyPass != readyPasses.end(); ++readyPass) {
+            const auto framebuffer = this->findFramebuffer(this->passes[*readyPass]);
+            if (framebuffer && *framebuffer == boundFramebuffer) {
+                next = readyPass;
+                break;
+            }
+        }
+
+        const auto pass = *next;
+        readyPasses.erase(next);
+        order.push_back(pass);
+
+        const auto framebuffer = this->findFramebuffer(this->passes[pass]);
+        if (framebuffer) boundFramebuffer = *framebuffer;
+
+        for (const auto dependentPass : dependentPasses[pass]) {
+            if (--numDependencies[dependentPass] == 0) {
+                readyPasses.insert(std::upper_bound(readyPasses.begin(), readyPasses.end(), dependentPass),
+                                   dependentPass);
+            }
+        }
+    }
+
+    return order;
+}
+
+const RenderGraph::Resource* RenderGraph::findFramebuffer(const Pass &pass) const {
+    const auto framebuffer = std::find_if(pass.writes.begin(), pass.writes.end(), [this](Resource resource){
+        return this->resources[resource].type != IMPORTED;
+    });
+    return framebuffer == pass.writes.end() ? nullptr : &*framebuffer;
+}
+
+} // namespace ge
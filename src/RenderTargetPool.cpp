@@ -0,0 +1,114 @@
+#include <game_engine/RenderTargetPool.h>
+
+#include <algorithm>
+#include <string>
+
+#include <game_engine/Exception.h>
+
+namespace {
+
+///
+/// \brief createTexture Allocates an uninitialized 2D texture without mip levels.
+///
+unsigned int createTexture(const ge::RenderTargetDesc &desc, GLenum internalFormat, GLenum format, GLint filter) {
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(internalFormat), desc.width, desc.height, 0,
+                 format, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+} // namespace
+
+namespace ge {
+
+constexpr unsigned int RenderTargetPool::MAX_UNUSED_FRAMES;
+
+RenderTarget::RenderTarget(const RenderTargetDesc &desc)
+    : desc(desc) {
+    glGenFramebuffers(1, &this->framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer);
+
+    if (desc.colorFormat) {
+        this->colorTexture = createTexture(desc, desc.colorFormat, GL_RGBA, GL_LINEAR);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->colorTexture, 0);
+    } else {
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+    }
+
+    if (desc.depthFormat) {
+        this->depthTexture = createTexture(desc, desc.depthFormat, GL_DEPTH_COMPONENT, GL_NEAREST);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, this->depthTexture, 0);
+    }
+
+    if (desc.velocityFormat) {
+        this->velocityTexture = createTexture(desc, desc.velocityFormat, GL_RG, GL_NEAREST);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, this->velocityTexture, 0);
+
+        const GLenum drawBuffers[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+        glDrawBuffers(2, drawBuffers);
+    }
+
+    const auto status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        glDeleteTextures(1, &this->velocityTexture);
+        glDeleteTextures(1, &this->depthTexture);
+        glDeleteTextures(1, &this->colorTexture);
+        glDeleteFramebuffers(1, &this->framebuffer);
+        throw Error("Failed to create render target of " + std::to_string(desc.width) + "x" +
+                    std::to_string(desc.height) + ", framebuffer status " + std::to_string(status));
+    }
+}
+
+RenderTarget::~RenderTarget() {
+    glDeleteTextures(1, &this->velocityTexture);
+    glDeleteTextures(1, &this->depthTexture);
+    glDeleteTextures(1, &this->colorTexture);
+    glDeleteFramebuffers(1, &this->framebuffer);
+}
+
+void RenderTarget::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer);
+    glViewport(0, 0, this->desc.width, this->desc.height);
+}
+
+RenderTarget& RenderTargetPool::acquire(const RenderTargetDesc &desc) {
+    for (auto &entry : this->entries) {
+        if (!entry.acquired && entry.target->getDesc() == desc) {
+            entry.acquired = true;
+            entry.lastAcquiredFrame = this->frame;
+            return *entry.target;
+        }
+    }
+
+    this->entries.push_back({std::make_unique<RenderTarget>(desc), true, this->frame});
+    return *this->entries.back().target;
+}
+
+void RenderTargetPool::release(const RenderTarget &target) {
+    for (auto &entry : this->entries) {
+        if (entry.target.get() == &target) {
+            entry.acquired = false;
+            return;
+        }
+    }
+}
+
+void RenderTargetPool::endFrame() {
+    this->entries.erase(std::remove_if(this->entries.begin(), this->entries.end(), [this](const Entry &entry){
+        return !entry.acquired && this->frame - entry.lastAcquiredFrame >= MAX_UNUSED_FRAMES;
+    }), this->entries.end());
+
+    ++this->frame;
+}
+
+} // namespace ge
@@ -0,0 +1,444 @@
+#include <game_engine/ResourceManager.h>
+
+#include <cstdlib>
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+namespace {
+
+constexpr size_t DEFAULT_IMPORTED_MODEL_BUDGET_BYTES = 256u << 20;
+
+std::mutex instanceMutex;
+std::weak_ptr<ge::ResourceManager> instance;
+
+struct FileHash {
+    std::time_t modificationTime;
+    long long size_bytes;
+    std::uint64_t hash;
+};
+
+/// Hashes of the files read so far, by canonical path.
+std::mutex fileHashesMutex;
+std::unordered_map<std::string, FileHash> fileHashes;
+
+///
+/// \brief hashFile Returns the FNV-1a hash of the contents of a file.
+///
+std::uint64_t hashFile(std::ifstream &file) {
+    std::uint64_t hash = 14695981039346656037ull;
+    std::vector<char> buffer(1 << 16);
+
+    while (file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        const auto numRead = static_cast<size_t>(file.gcount());
+        for (size_t i = 0; i < numRead; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(buffer[i])) * 1099511628211ull;
+        }
+    }
+
+    return hash;
+}
+
+///
+/// \brief getContentKey Returns a key derived from the contents of a file, or an empty
+///                      string if the file cannot be read.
+/// \param canonicalPath Canonical path to the file.
+///
+std::string getContentKey(const std::string &canonicalPath) {
+    struct stat status;
+    if (stat(canonicalPath.c_str(), &status) != 0) return {};
+
+    FileHash fileHash {status.st_mtime, static_cast<long long>(status.st_size), 0};
+    bool hashed = false;
+    {
+        std::lock_guard<std::mutex> lock(fileHashesMutex);
+        auto found = fileHashes.find(canonicalPath);
+        if (found != fileHashes.end() && found->second.modificationTime == fileHash.modificationTime &&
+                found->second.size_bytes == fileHash.size_bytes) {
+            fileHash.hash = found->second.hash;
+            hashed = true;
+        }
+    }
+
+    if (!hashed) {
+        std::ifstream file(canonicalPath, std::ios::binary);
+        if (!file) return {};
+        fileHash.hash = hashFile(file);
+
+        std::lock_guard<std::mutex> lock(fileHashesMutex);
+        fileHashes[canonicalPath] = fileHash;
+    }
+
+    // Keep the size in the key to make collisions between files even less likely
+    std::ostringstream key;
+    key << "hash:" << std::hex << std::setw(16) << std::setfill('0') << fileHash.hash
+        << ":" << std::dec << fileHash.size_bytes;
+    return key.str();
+}
+
+///
+/// \brief normalizePath Removes "." and ".." components and repeated separators from
+///                      a path without accessing the file system.
+///
+std::string normalizePath(const std::string &path) {
+    const bool absolute = !path.empty() && path[0] == '/';
+
+    std::vector<std::string> components;
+    std::istringstream stream(path);
+    std::string component;
+    while (std::getline(stream, component, '/')) {
+        if (component.empty() || component == ".") continue;
+
+        if (component == ".." && !components.empty() && components.back() != "..") {
+            components.pop_back();
+        } else if (component != ".." || !absolute) {
+            components.push_back(component);
+        }
+    }
+
+    std::string normalized = absolute ? "/" : "";
+    for (size_t i = 0; i < components.size(); ++i) {
+        if (i > 0) normalized += '/';
+        normalized += components[i];
+    }
+
+    return normalized.empty() ? "." : normalized;
+}
+
+///
+/// \brief The HandleDeleter struct gives a resource back to its manager when the last
+/// handle to it is destroyed.
+///
+template<typename OnUnreferenced>
+struct HandleDeleter {
+    OnUnreferenced onUnreferenced;
+
+    void operator()(void*) {
+        // The deleter lives as long as weak handles do, so move its state out
+        auto onUnreferenced = std::move(this->onUnreferenced);
+        onUnreferenced();
+    }
+};
+
+template<typename OnUnreferenced>
+HandleDeleter<OnUnreferenced> makeHandleDeleter(OnUnreferenced &&onUnreferenced) {
+    return {std::forward<OnUnreferenced>(onUnreferenced)};
+}
+
+} // namespace
+
+namespace ge {
+
+bool ResourceManager::contentHashingEnabled = false;
+
+std::shared_ptr<ResourceManager> ResourceManager::getInstance() {
+    std::lock_guard<std::mutex> lock(instanceMutex);
+
+    auto manager = instance.lock();
+    if (!manager) {
+        manager = std::shared_ptr<ResourceManager>(new ResourceManager());
+        instance = manager;
+    }
+
+    return manager;
+}
+
+ResourceManager::ResourceManager() {
+    this->usages[IMPORTED_MODEL].budget_bytes = DEFAULT_IMPORTED_MODEL_BUDGET_BYTES;
+}
+
+std::string ResourceManager::getKey(const std::string &filepath) {
+    auto canonicalPath = getCanonicalPath(filepath);
+    if (!contentHashingEnabled) return canonicalPath;
+
+    auto contentKey = getContentKey(canonicalPath);
+    return contentKey.empty() ? canonicalPath : contentKey;
+}
+
+std::string ResourceManager::getCanonicalPath(const std::string &filepath) {
+#ifdef _WIN32
+    char fullPath[_MAX_PATH];
+    if (_fullpath(fullPath, filepath.c_str(), _MAX_PATH)) {
+        std::string path(fullPath);
+        for (auto &c : path) {
+            if (c == '\\') c = '/';
+        }
+        return path;
+    }
+#else
+    std::unique_ptr<char, void(*)(void*)> realPath(realpath(filepath.c_str(), nullptr), std::free);
+    if (realPath) return realPath.get();
+#endif
+
+    // The file does not exist, so its path is only cleaned up
+    return normalizePath(filepath);
+}
+
+bool ResourceManager::isResident(ResourceType type, const std::string &key) const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto entry = this->entries.find({type, key});
+    return entry != this->entries.end() && !entry->second.loading.valid();
+}
+
+void ResourceManager::setBudget(ResourceType type, size_t budget_bytes) {
+    Retained released;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->usages[type].budget_bytes = budget_bytes;
+    this->evict(type, budget_bytes, &released);
+}
+
+size_t ResourceManager::getBudget(ResourceType type) const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->usages[type].budget_bytes;
+}
+
+size_t ResourceManager::getMemoryUsage(ResourceType type) const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->usages[type].memory_bytes;
+}
+
+size_t ResourceManager::getNumResources(ResourceType type) const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->usages[type].numResources;
+}
+
+void ResourceManager::releaseUnreferenced(ResourceType type) {
+    Retained released;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->evict(type, 0, &released);
+}
+
+void ResourceManager::releaseUnreferenced() {
+    // Resources only refer to resources of later types, which are then released too
+    for (int type = 0; type < NUM_RESOURCE_TYPES; ++type) {
+        this->releaseUnreferenced(static_cast<ResourceType>(type));
+    }
+}
+
+void ResourceManager::releaseUnreferenced(const std::string &filepath) {
+    const auto canonicalPath = getCanonicalPath(filepath);
+    Retained released;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto key = this->unreferenced.begin();
+    while (key != this->unreferenced.end()) {
+        auto entry = this->entries.find(*key++);
+
+        const auto &filepaths = entry->second.filepaths;
+        if (std::find(filepaths.begin(), filepaths.end(), canonicalPath) != filepaths.end()) {
+            this->release(entry, &released);
+        }
+    }
+}
+
+bool ResourceManager::isLoadedFrom(ResourceType type, const std::string &filepath) const {
+    const auto canonicalPath = getCanonicalPath(filepath);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (const auto &entry : this->entries) {
+        if (entry.first.first != type || entry.second.loading.valid()) continue;
+
+        const auto &filepaths = entry.second.filepaths;
+        if (std::find(filepaths.begin(), filepaths.end(), canonicalPath) != filepaths.end()) return true;
+    }
+
+    return false;
+}
+
+std::vector<std::string> ResourceManager::getFilepaths() const {
+    std::set<std::string> filepaths;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (const auto &entry : this->entries) {
+        filepaths.insert(entry.second.filepaths.begin(), entry.second.filepaths.end());
+    }
+
+    return {filepaths.begin(), filepaths.end()};
+}
+
+std::shared_ptr<void> ResourceManager::load(ResourceType type, const std::string &key, const std::type_index &cppType,
+                                            const TypeErasedLoader &loader) {
+    const Key entryKey(type, key);
+    std::promise<std::shared_ptr<void>> promise;
+
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        auto found = this->entries.find(entryKey);
+        if (found != this->entries.end()) {
+            checkType(found->second, cppType, key);
+            if (!found->second.loading.valid()) return this->makeHandle(entryKey, found->second);
+
+            // Wait for the thread loading the resource
+            auto loading = found->second.loading;
+            lock.unlock();
+            return loading.get();
+        }
+
+        auto &entry = this->entries[entryKey];
+        entry.cppType = cppType;
+        entry.loading = promise.get_future().share();
+    }
+
+    // Load without holding the mutex, so that loaders may load other resources
+    Loaded<void> loaded;
+    try {
+        loaded = loader();
+        for (auto &filepath : loaded.filepaths) {
+            filepath = getCanonicalPath(filepath);
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->entries.erase(entryKey);
+        }
+
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    std::shared_ptr<void> handle;
+    Retained released;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        auto &entry = this->entries.at(entryKey);
+        entry.loading = Future();
+        entry.resource = loaded.resource;
+        entry.size_bytes = loaded.size_bytes;
+        entry.filepaths = std::move(loaded.filepaths);
+
+        auto &usage = this->usages[type];
+        usage.memory_bytes += entry.size_bytes;
+        ++usage.numResources;
+
+        handle = this->makeHandle(entryKey, entry);
+        this->evict(type, usage.budget_bytes, &released);
+    }
+
+    promise.set_value(handle);
+    return handle;
+}
+
+std::shared_ptr<void> ResourceManager::find(ResourceType type, const std::string &key, const std::type_index &cppType) {
+    const Key entryKey(type, key);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto found = this->entries.find(entryKey);
+    if (found == this->entries.end() || found->second.loading.valid()) return nullptr;
+
+    checkType(found->second, cppType, key);
+    return this->makeHandle(entryKey, found->second);
+}
+
+std::vector<std::shared_ptr<void>> ResourceManager::findLoadedFrom(ResourceType type, const std::string &filepath,
+                                                                   const std::type_index &cppType) {
+    const auto canonicalPath = getCanonicalPath(filepath);
+    std::vector<std::shared_ptr<void>> resources;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (auto &entry : this->entries) {
+        if (entry.first.first != type || entry.second.loading.valid()) continue;
+
+        const auto &filepaths = entry.second.filepaths;
+        if (std::find(filepaths.begin(), filepaths.end(), canonicalPath) == filepaths.end()) continue;
+
+        checkType(entry.second, cppType, entry.first.second);
+        resources.push_back(this->makeHandle(entry.first, entry.second));
+    }
+
+    return resources;
+}
+
+std::shared_ptr<void> ResourceManager::makeHandle(const Key &key, Entry &entry) {
+    auto handle = entry.handle.lock();
+
+    if (!handle) {
+        // The resource is either retained or still held by the deleter of the last
+        // handle, which then finds that the resource is referenced again
+        auto resource = entry.resource.lock();
+        if (entry.isUnreferenced) {
+            this->unreferenced.erase(entry.unreferencedPosition);
+            entry.isUnreferenced = false;
+            entry.retained.reset();
+        }
+
+        const auto generation = this->nextGeneration++;
+        entry.generation = generation;
+
+        // Resources outliving the manager are released with their last handle
+        std::weak_ptr<ResourceManager> weakManager = this->shared_from_this();
+        auto deleter = makeHandleDeleter([weakManager, key, generation, resource]() mutable {
+            auto manager = weakManager.lock();
+            if (manager) manager->onUnreferenced(key, generation, std::move(resource));
+        });
+
+        auto *pointer = resource.get();
+        handle = std::shared_ptr<void>(pointer, std::move(deleter));
+        entry.handle = handle;
+    }
+
+    return handle;
+}
+
+void ResourceManager::onUnreferenced(const Key &key, std::uint64_t generation, std::shared_ptr<void> resource) {
+    Retained released;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    // The resource may have been referenced again meanwhile
+    auto found = this->entries.find(key);
+    if (found == this->entries.end() || found->second.generation != generation) return;
+
+    auto &entry = found->second;
+    entry.retained = std::move(resource);
+    entry.unreferencedPosition = this->unreferenced.insert(this->unreferenced.end(), key);
+    entry.isUnreferenced = true;
+
+    this->evict(key.first, this->usages[key.first].budget_bytes, &released);
+}
+
+void ResourceManager::evict(ResourceType type, size_t budget_bytes, Retained *retained) {
+    auto &usage = this->usages[type];
+
+    auto key = this->unreferenced.begin();
+    while (key != this->unreferenced.end()) {
+        // A budget of 0 keeps no unreferenced resources, even those of unknown size
+        if (budget_bytes != 0 && usage.memory_bytes <= budget_bytes) break;
+
+        if (key->first != type) {
+            ++key;
+            continue;
+        }
+
+        this->release(this->entries.find(*key++), retained);
+    }
+}
+
+void ResourceManager::release(std::map<Key, Entry>::iterator entry, Retained *retained) {
+    auto &usage = this->usages[entry->first.first];
+    usage.memory_bytes -= entry->second.size_bytes;
+    --usage.numResources;
+
+    this->unreferenced.erase(entry->second.unreferencedPosition);
+    retained->push_back(std::move(entry->second.retained));
+    this->entries.erase(entry);
+}
+
+void ResourceManager::checkType(const Entry &entry, const std::type_index &cppType, const std::string &key) {
+    if (entry.cppType != cppType) {
+        throw Error("Resource loaded with another type: " + key);
+    }
+}
+
+} // namespace ge
@@ -0,0 +1,256 @@
+#include <game_engine/SceneGraph.h>
+
+#include <algorithm>
+
+#include <glm/matrix.hpp>
+
+#include <game_engine/Exception.h>
+
+namespace {
+
+template<typename T>
+void permute(std::vector<T> *values, const std::vector<size_t> &order) {
+    std::vector<T> permutedValues;
+    permutedValues.reserve(order.size());
+
+    for (auto index : order) {
+        permutedValues.push_back(std::move((*values)[index]));
+    }
+
+    *values = std::move(permutedValues);
+}
+
+} // namespace
+
+namespace ge {
+
+constexpr SceneGraph::Node SceneGraph::INVALID_NODE;
+constexpr size_t SceneGraph::NO_INDEX;
+
+SceneGraph::Node SceneGraph::createNode(Node parent, const glm::mat4 &localTransform) {
+    const auto parentIndex = (parent == INVALID_NODE) ? NO_INDEX : this->getIndex(parent);
+
+    Node node;
+    if (this->freeNodes.empty()) {
+        node = static_cast<Node>(this->nodeIndices.size());
+        this->nodeIndices.push_back(NO_INDEX);
+    } else {
+        node = this->freeNodes.back();
+        this->freeNodes.pop_back();
+    }
+
+    // Appending keeps parents in front of their children, but may break the breadth-first order
+    this->nodeIndices[node] = this->nodes.size();
+    if (!this->nodes.empty() && parentIndex != this->parentIndices.back()) {
+        this->isSorted = false;
+    }
+
+    const auto worldTransform = (parentIndex == NO_INDEX) ?
+                localTransform : this->worldTransforms[parentIndex] * localTransform;
+
+    this->nodes.push_back(node);
+    this->parentIndices.push_back(parentIndex);
+    this->localTransforms.push_back(localTransform);
+    this->worldTransforms.push_back(worldTransform);
+    this->previousWorldTransforms.push_back(worldTransform);
+    this->worldNormalMatrices.push_back(glm::transpose(glm::inverse(glm::mat3(worldTransform))));
+    this->dirtyFlags.push_back(true);
+    this->movedFlags.push_back(false);
+    this->newFlags.push_back(true);
+
+    return node;
+}
+
+void SceneGraph::destroyNode(Node node) {
+    if (!this->isSorted) this->sortBreadthFirst();
+
+    // Descendants come after the node in breadth-first order, so they are found in one pass
+    const auto firstIndex = this->getIndex(node);
+    std::vector<size_t> newIndices(this->nodes.size() - firstIndex, NO_INDEX);
+    std::vector<unsigned char> destroyed(this->nodes.size() - firstIndex, false);
+    destroyed[0] = true;
+
+    auto numNodes = firstIndex;
+    for (auto i = firstIndex; i < this->nodes.size(); ++i) {
+        auto parentIndex = this->parentIndices[i];
+        const auto parentIsMoved = (parentIndex != NO_INDEX && parentIndex >= firstIndex);
+
+        if (destroyed[i - firstIndex] || (parentIsMoved && destroyed[parentIndex - firstIndex])) {
+            destroyed[i - firstIndex] = true;
+            this->nodeIndices[this->nodes[i]] = NO_INDEX;
+            this->freeNodes.push_back(this->nodes[i]);
+            continue;
+        }
+
+        // Compact the remaining nodes, which keeps their breadth-first order
+        if (parentIsMoved) parentIndex = newIndices[parentIndex - firstIndex];
+        newIndices[i - firstIndex] = numNodes;
+
+        this->nodes[numNodes] = this->nodes[i];
+        this->parentIndices[numNodes] = parentIndex;
+        this->localTransforms[numNodes] = this->localTransforms[i];
+        this->worldTransforms[numNodes] = this->worldTransforms[i];
+        this->previousWorldTransforms[numNodes] = this->previousWorldTransforms[i];
+        this->worldNormalMatrices[numNodes] = this->worldNormalMatrices[i];
+        this->dirtyFlags[numNodes] = this->dirtyFlags[i];
+        this->movedFlags[numNodes] = this->movedFlags[i];
+        this->newFlags[numNodes] = this->newFlags[i];
+        this->nodeIndices[this->nodes[numNodes]] = numNodes;
+        ++numNodes;
+    }
+
+    this->nodes.resize(numNodes);
+    this->parentIndices.resize(numNodes);
+    this->localTransforms.resize(numNodes);
+    this->worldTransforms.resize(numNodes);
+    this->previousWorldTransforms.resize(numNodes);
+    this->worldNormalMatrices.resize(numNodes);
+    this->dirtyFlags.resize(numNodes);
+    this->movedFlags.resize(numNodes);
+    this->newFlags.resize(numNodes);
+}
+
+void SceneGraph::setParent(Node node, Node parent) {
+    const auto index = this->getIndex(node);
+    const auto parentIndex = (parent == INVALID_NODE) ? NO_INDEX : this->getIndex(parent);
+
+    for (auto ancestorIndex = parentIndex; ancestorIndex != NO_INDEX;
+         ancestorIndex = this->parentIndices[ancestorIndex]) {
+        if (ancestorIndex == index) {
+            throw Error("Failed to attach scene graph node: a node cannot be attached to itself or its descendants.");
+        }
+    }
+
+    this->parentIndices[index] = parentIndex;
+    this->dirtyFlags[index] = true;
+    this->isSorted = false;
+}
+
+SceneGraph::Node SceneGraph::getParent(Node node) const {
+    const auto parentIndex = this->parentIndices[this->getIndex(node)];
+    return (parentIndex == NO_INDEX) ? INVALID_NODE : this->nodes[parentIndex];
+}
+
+void SceneGraph::setLocalTransform(Node node, const glm::mat4 &localTransform) {
+    const auto index = this->getIndex(node);
+    if (this->localTransforms[index] == localTransform) return;
+
+    this->localTransforms[index] = localTransform;
+    this->dirtyFlags[index] = true;
+}
+
+const glm::mat4& SceneGraph::getLocalTransform(Node node) const {
+    return this->localTransforms[this->getIndex(node)];
+}
+
+const glm::mat4& SceneGraph::getWorldTransform(Node node) const {
+    return this->worldTransforms[this->getIndex(node)];
+}
+
+const glm::mat4& SceneGraph::getPreviousWorldTransform(Node node) const {
+    return this->previousWorldTransforms[this->getIndex(node)];
+}
+
+const glm::mat3& SceneGraph::getWorldNormalMatrix(Node node) const {
+    return this->worldNormalMatrices[this->getIndex(node)];
+}
+
+bool SceneGraph::isValid(Node node) const {
+    return node < this->nodeIndices.size() && this->nodeIndices[node] != NO_INDEX;
+}
+
+void SceneGraph::update() {
+    if (!this->isSorted) this->sortBreadthFirst();
+
+    // Parents are updated before their children, so a dirty parent marks its
+    // children dirty before they are visited.
+    for (size_t i = 0; i < this->nodes.size(); ++i) {
+        const auto parentIndex = this->parentIndices[i];
+        if (parentIndex != NO_INDEX && this->dirtyFlags[parentIndex]) {
+            this->dirtyFlags[i] = true;
+        }
+
+        // Nodes that did not move in the last update already have their previous transform
+        if (this->dirtyFlags[i] || this->movedFlags[i]) {
+            this->previousWorldTransforms[i] = this->worldTransforms[i];
+        }
+        this->movedFlags[i] = this->dirtyFlags[i];
+
+        if (!this->dirtyFlags[i]) continue;
+
+        this->worldTransforms[i] = (parentIndex == NO_INDEX) ?
+                    this->localTransforms[i] : this->worldTransforms[parentIndex] * this->localTransforms[i];
+        this->worldNormalMatrices[i] = glm::transpose(glm::inverse(glm::mat3(this->worldTransforms[i])));
+
+        if (this->newFlags[i]) {
+            this->previousWorldTransforms[i] = this->worldTransforms[i];
+            this->newFlags[i] = false;
+        }
+    }
+
+    std::fill(this->dirtyFlags.begin(), this->dirtyFlags.end(), false);
+}
+
+size_t SceneGraph::getIndex(Node node) const {
+    if (!this->isValid(node)) {
+        throw Error("Invalid scene graph node.");
+    }
+
+    return this->nodeIndices[node];
+}
+
+void SceneGraph::sortBreadthFirst() {
+    const auto numNodes = this->nodes.size();
+
+    // Link the children of every node, in their current order
+    std::vector<size_t> firstChildIndices(numNodes, NO_INDEX);
+    std::vector<size_t> nextSiblingIndices(numNodes, NO_INDEX);
+    for (auto i = numNodes; i-- > 0;) {
+        const auto parentIndex = this->parentIndices[i];
+        if (parentIndex == NO_INDEX) continue;
+
+        nextSiblingIndices[i] = firstChildIndices[parentIndex];
+        firstChildIndices[parentIndex] = i;
+    }
+
+    // Traverse the forest breadth-first, starting with all root nodes
+    std::vector<size_t> order;
+    order.reserve(numNodes);
+    for (size_t i = 0; i < numNodes; ++i) {
+        if (this->parentIndices[i] == NO_INDEX) order.push_back(i);
+    }
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        for (auto childIndex = firstChildIndices[order[i]]; childIndex != NO_INDEX;
+             childIndex = nextSiblingIndices[childIndex]) {
+            order.push_back(childIndex);
+        }
+    }
+
+    std::vector<size_t> newIndices(numNodes);
+    for (size_t i = 0; i < numNodes; ++i) {
+        newIndices[order[i]] = i;
+    }
+
+    for (auto &parentIndex : this->parentIndices) {
+        if (parentIndex != NO_INDEX) parentIndex = newIndices[parentIndex];
+    }
+
+    permute(&this->nodes, order);
+    permute(&this->parentIndices, order);
+    permute(&this->localTransforms, order);
+    permute(&this->worldTransforms, order);
+    permute(&this->previousWorldTransforms, order);
+    permute(&this->worldNormalMatrices, order);
+    permute(&this->dirtyFlags, order);
+    permute(&this->movedFlags, order);
+    permute(&this->newFlags, order);
+
+    for (size_t i = 0; i < numNodes; ++i) {
+        this->nodeIndices[this->nodes[i]] = i;
+    }
+
+    this->isSorted = true;
+}
+
+} // namespace ge
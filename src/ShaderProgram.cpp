@@ -1,21 +1,57 @@
 #include <game_engine/ShaderProgram.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <iomanip>
+#include <memory>
+#include <set>
 #include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
 
 #include <glad/glad.h>
+#include <GLFW/glfw3.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/mat3x3.hpp>
 #include <glm/mat4x4.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#define STB_INCLUDE_IMPLEMENTATION
+#define STB_INCLUDE_LINE_GLSL
+#include <stb_include.h>
 
 #include <game_engine/Exception.h>
+#include <game_engine/ResourceManager.h>
 
 namespace {
 constexpr unsigned int LOG_LENGTH = 1024;
 
+// KHR_parallel_shader_compile and ARB_parallel_shader_compile share these enums
+constexpr GLenum COMPLETION_STATUS = 0x91B1;
+constexpr GLuint MAX_SHADER_COMPILER_THREADS_DEFAULT = 0xFFFFFFFF;
+
+///
+/// \brief pendingPrograms Shader programs that have not finished building.
+///
+std::vector<ge::ShaderProgram*> pendingPrograms;
+
+///
+/// \brief programs All shader programs, to rebuild those whose sources changed.
+///
+std::vector<ge::ShaderProgram*> programs;
+
+using Shaders = std::vector<std::pair<unsigned int, std::string>>;
+
 ///
 /// \brief readFile Reads and returns a file's contents.
 /// \param filepath Filepath of the file to read from.
@@ -25,33 +61,97 @@ constexpr unsigned int LOG_LENGTH = 1024;
 std::string readFile(const std::string &filepath);
 
 ///
-/// \brief compileShader Compiles a shader.
-/// \param shaderType Type of shader to be created.
+/// \brief loadShaderCode Reads a shader's source code, resolves its includes and
+///                       adds the given macro definitions.
 /// \param shaderPath Filepath of the shader's source code.
-/// \return Compiled shader object.
-/// \exception ge::BuildError Failed to compile shader.
+/// \param defines Macros to define after the \c #version directive.
+/// \return Preprocessed source code.
+/// \exception std::ios_base::failure Failed to open the file.
+/// \exception ge::LoadError Failed to open an included file.
+///
+std::string loadShaderCode(const std::string &shaderPath, const std::vector<std::string> &defines);
+
+///
+/// \brief findIncludes Adds a shader source and the files it includes to a set.
+/// \param filepath Filepath of the source.
+/// \param includeDirectory Directory included files are relative to.
+/// \param filepaths Canonical paths of the files found so far.
+///
+void findIncludes(const std::string &filepath, const std::string &includeDirectory, std::set<std::string> *filepaths);
+
+///
+/// \brief startBuildingProgram Creates a program and starts compiling and linking its
+///                             shaders. The driver may do so in the background.
+/// \param shaderPaths Filepaths of the shaders by type.
+/// \param shaderCodes Source code of the shaders.
+/// \param retrievable Whether the binary of the program will be retrieved.
+/// \param shaders Receives the shaders attached to the program and their filepaths.
+/// \return Program object.
+///
+unsigned int startBuildingProgram(const Shaders &shaderPaths, const std::vector<std::string> &shaderCodes,
+                                  bool retrievable, Shaders *shaders);
+
+///
+/// \brief getBuildErrors Returns the compile and link errors of a program whose build
+///                       completed, or an empty string if it was built successfully.
+///
+std::string getBuildErrors(unsigned int program, const Shaders &shaders);
+
+///
+/// \brief deleteShaders Detaches and deletes the shaders of a program.
 ///
-unsigned int compileShader(unsigned int shaderType, const std::string &shaderPath);
+void deleteShaders(unsigned int program, Shaders *shaders);
 
 ///
-/// \brief linkShaderProgram Links shaders to create a shader program.
+/// \brief isBuildComplete Returns whether the driver finished building a program.
 ///
-/// This function does NOT delete the given shaders.
+bool isBuildComplete(unsigned int program);
+
+///
+/// \brief startCompilingShader Creates a shader and starts compiling it.
+///
+/// Compile errors are only checked once the program is built.
+///
+/// \param shaderType Type of shader to be created.
+/// \param shaderCode Source code of the shader.
+/// \return Shader object.
+///
+unsigned int startCompilingShader(unsigned int shaderType, const std::string &shaderCode);
+
+///
+/// \brief isProgramBinarySupported Returns whether program binaries can be retrieved
+///                                 and loaded with the current context.
+///
+bool isProgramBinarySupported();
+
+///
+/// \brief isParallelCompileSupported Returns whether the driver compiles shaders in the
+///                                   background and reports their completion status.
+///
+bool isParallelCompileSupported();
+
+///
+/// \brief getBinaryCachePath Returns the cache filepath of the program built from the
+///                           given sources with the current driver.
+///
+std::string getBinaryCachePath(const std::vector<std::string> &sources);
+
+///
+/// \brief loadProgramBinary Creates a program from a cached binary.
+/// \return Linked program or 0 if there is no cached binary or the driver rejected it.
+///
+unsigned int loadProgramBinary(const std::string &binaryCachePath);
+
+///
+/// \brief saveProgramBinary Stores the binary of a linked program in the cache.
 ///
-/// \param vertexShader Compiled vertex shader object.
-/// \param fragmentShader Compiled fragment shader object.
-/// \param geometryShader Compiled geometry shader object.
-///                       0 if no geometry shader is used.
-/// \return Linked shader program.
-/// \exception ge::BuildError Failed to link shader.
-///                           This function does NOT delete the given shaders.
+/// Failing to store the binary is not an error since the program can always be
+/// built from source.
 ///
-unsigned int linkShaderProgram(unsigned int vertexShader,
-                               unsigned int fragmentShader,
-                               unsigned int geometryShader);
+void saveProgramBinary(unsigned int program, const std::string &binaryCachePath);
 
 std::string readFile(const std::string& filepath) {
-    std::ifstream file(filepath);
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
 
     // Check for valid file
     if (!file.is_open()) {
@@ -61,129 +161,396 @@ std::string readFile(const std::string& filepath) {
     }
 
     // Read file
-    std::stringstream filestream;
-    filestream << file.rdbuf();
+    std::string contents(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    file.read(&contents[0], static_cast<std::streamsize>(contents.size()));
 
-    return filestream.str();
+    return contents;
 }
 
-unsigned int compileShader(unsigned int shaderType, const std::string &shaderPath) {
+std::string loadShaderCode(const std::string &shaderPath, const std::vector<std::string> &defines) {
     auto shaderCode = readFile(shaderPath);
 
-    // Compile shader
-    auto shader = glCreateShader(shaderType);
-    auto shaderCodeStr = shaderCode.c_str();
-    glShaderSource(shader, 1, &shaderCodeStr, nullptr);
-    glCompileShader(shader);
+    // Resolve includes relative to the shader's directory
+    const auto filenameIndex = shaderPath.find_last_of('/');
+    auto includeDirectory = filenameIndex == std::string::npos ? std::string(".")
+                                                               : shaderPath.substr(0, filenameIndex);
+    auto filename = shaderPath;
+    char error[256] = {};
+
+    std::unique_ptr<char, decltype(&std::free)> includedCode(
+                stb_include_string(&shaderCode[0], nullptr, &includeDirectory[0], &filename[0], error),
+                &std::free);
+    if (!includedCode) {
+        throw ge::LoadError("Failed to resolve includes of " + shaderPath + ": " + error);
+    }
+    shaderCode = includedCode.get();
+
+    if (defines.empty()) return shaderCode;
+
+    // The #version directive must come first
+    std::string defineLines;
+    for (const auto &define : defines) {
+        defineLines += "#define " + define + "\n";
+    }
+
+    auto versionLineEnd = shaderCode.compare(0, 8, "#version") == 0 ? shaderCode.find('\n')
+                                                                    : std::string::npos;
+    if (versionLineEnd == std::string::npos) {
+        return defineLines + "#line 1\n" + shaderCode;
+    }
+
+    return shaderCode.insert(versionLineEnd + 1, defineLines + "#line 2\n");
+}
+
+void findIncludes(const std::string &filepath, const std::string &includeDirectory, std::set<std::string> *filepaths) {
+    if (!filepaths->insert(ge::ResourceManager::getCanonicalPath(filepath)).second) return;
+
+    std::ifstream file(filepath);
+    std::string line;
+    while (std::getline(file, line)) {
+        // Same syntax as stb_include: #include "filename"
+        const auto directive = line.find_first_not_of(" \t");
+        if (directive == std::string::npos || line.compare(directive, 8, "#include") != 0) continue;
+
+        const auto filenameBegin = line.find('"', directive + 8);
+        const auto filenameEnd = filenameBegin == std::string::npos ? filenameBegin : line.find('"', filenameBegin + 1);
+        if (filenameEnd == std::string::npos) continue;
+
+        const auto filename = line.substr(filenameBegin + 1, filenameEnd - filenameBegin - 1);
+        findIncludes(includeDirectory + "/" + filename, includeDirectory, filepaths);
+    }
+}
+
+unsigned int startBuildingProgram(const Shaders &shaderPaths, const std::vector<std::string> &shaderCodes,
+                                  bool retrievable, Shaders *shaders) {
+    isParallelCompileSupported();
+
+    auto program = glCreateProgram();
+    for (size_t i = 0; i < shaderPaths.size(); ++i) {
+        auto shader = startCompilingShader(shaderPaths[i].first, shaderCodes[i]);
+        glAttachShader(program, shader);
+        shaders->emplace_back(shader, shaderPaths[i].second);
+    }
+
+    if (retrievable) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glLinkProgram(program);
+
+    return program;
+}
 
+std::string getBuildErrors(unsigned int program, const Shaders &shaders) {
     // Check for compilation errors
+    for (const auto &shader : shaders) {
+        int success;
+        glGetShaderiv(shader.first, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            char compileLog[LOG_LENGTH];
+            glGetShaderInfoLog(shader.first, LOG_LENGTH, nullptr, compileLog);
+
+            std::stringstream errorMsg;
+            errorMsg << "Failed to compile " << shader.second << "\n" << compileLog;
+            return errorMsg.str();
+        }
+    }
+
+    // Check for linking errors
     int success;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
     if (!success) {
-        char compileLog[LOG_LENGTH];
-        glGetShaderInfoLog(shader, LOG_LENGTH, nullptr, compileLog);
+        char linkLog[LOG_LENGTH];
+        glGetProgramInfoLog(program, LOG_LENGTH, nullptr, linkLog);
 
         std::stringstream errorMsg;
-        errorMsg << "Failed to compile " << shaderPath << "\n" << compileLog;
+        errorMsg << "Failed to link shaders\n" << linkLog;
+        return errorMsg.str();
+    }
 
-        glDeleteShader(shader);
+    return {};
+}
 
-        throw ge::BuildError(errorMsg.str());
+void deleteShaders(unsigned int program, Shaders *shaders) {
+    for (const auto &shader : *shaders) {
+        glDetachShader(program, shader.first);
+        glDeleteShader(shader.first);
     }
+    shaders->clear();
+}
+
+bool isBuildComplete(unsigned int program) {
+    if (!isParallelCompileSupported()) return true;
+
+    int completed;
+    glGetProgramiv(program, COMPLETION_STATUS, &completed);
+    return completed;
+}
+
+unsigned int startCompilingShader(unsigned int shaderType, const std::string &shaderCode) {
+    auto shader = glCreateShader(shaderType);
+    auto shaderCodeStr = shaderCode.c_str();
+    glShaderSource(shader, 1, &shaderCodeStr, nullptr);
+    glCompileShader(shader);
 
     return shader;
 }
 
-unsigned int linkShaderProgram(unsigned int vertexShader,
-                               unsigned int fragmentShader,
-                               unsigned int geometryShader) {
-    auto shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    if (geometryShader) glAttachShader(shaderProgram, geometryShader);
+bool isProgramBinarySupported() {
+    static const bool supported = [] {
+        if (!GLAD_GL_VERSION_4_1) {
+            if (!glfwExtensionSupported("GL_ARB_get_program_binary")) return false;
+
+            glad_glGetProgramBinary = reinterpret_cast<PFNGLGETPROGRAMBINARYPROC>(
+                        glfwGetProcAddress("glGetProgramBinary"));
+            glad_glProgramBinary = reinterpret_cast<PFNGLPROGRAMBINARYPROC>(
+                        glfwGetProcAddress("glProgramBinary"));
+            glad_glProgramParameteri = reinterpret_cast<PFNGLPROGRAMPARAMETERIPROC>(
+                        glfwGetProcAddress("glProgramParameteri"));
+            if (!glGetProgramBinary || !glProgramBinary || !glProgramParameteri) return false;
+        }
+
+        GLint numBinaryFormats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numBinaryFormats);
+        return numBinaryFormats > 0;
+    }();
+
+    return supported;
+}
+
+bool isParallelCompileSupported() {
+    static const bool supported = [] {
+        using MaxShaderCompilerThreadsProc = void (*)(GLuint);
+
+        MaxShaderCompilerThreadsProc maxShaderCompilerThreads = nullptr;
+        if (glfwExtensionSupported("GL_KHR_parallel_shader_compile")) {
+            maxShaderCompilerThreads = reinterpret_cast<MaxShaderCompilerThreadsProc>(
+                        glfwGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+        } else if (glfwExtensionSupported("GL_ARB_parallel_shader_compile")) {
+            maxShaderCompilerThreads = reinterpret_cast<MaxShaderCompilerThreadsProc>(
+                        glfwGetProcAddress("glMaxShaderCompilerThreadsARB"));
+        }
+        if (!maxShaderCompilerThreads) return false;
+
+        // Let the driver choose the number of compiler threads
+        maxShaderCompilerThreads(MAX_SHADER_COMPILER_THREADS_DEFAULT);
+        return true;
+    }();
+
+    return supported;
+}
+
+std::string getBinaryCachePath(const std::vector<std::string> &sources) {
+    // FNV-1a hash of the driver identification and shader sources
+    std::uint64_t hash = 14695981039346656037ull;
+    auto hashString = [&hash](const char *str) {
+        for (; str && *str; ++str) {
+            hash = (hash ^ static_cast<unsigned char>(*str)) * 1099511628211ull;
+        }
+        hash = (hash ^ 0xFFu) * 1099511628211ull;
+    };
+
+    hashString(reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+    hashString(reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    hashString(reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+    for (const auto &source : sources) {
+        hashString(source.c_str());
+    }
+
+    std::stringstream path;
+    path << ge::ShaderProgram::binaryCacheDirectory << "/"
+         << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+    return path.str();
+}
+
+unsigned int loadProgramBinary(const std::string &binaryCachePath) {
+    std::ifstream file(binaryCachePath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return 0;
+
+    const auto fileSize = static_cast<size_t>(file.tellg());
+    GLenum binaryFormat;
+    if (fileSize <= sizeof(binaryFormat)) return 0;
+
+    std::vector<char> binary(fileSize - sizeof(binaryFormat));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(&binaryFormat), sizeof(binaryFormat));
+    file.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+    if (!file) return 0;
+
+    auto program = glCreateProgram();
+    glProgramBinary(program, binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
 
     int success;
-    glLinkProgram(shaderProgram);
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
     if (!success) {
-        glDetachShader(shaderProgram, vertexShader);
-        glDetachShader(shaderProgram, fragmentShader);
-        if (geometryShader) glDetachShader(shaderProgram, geometryShader);
+        glDeleteProgram(program);
+        return 0;
+    }
 
-        char linkLog[LOG_LENGTH];
-        glGetProgramInfoLog(shaderProgram, LOG_LENGTH, nullptr, linkLog);
+    return program;
+}
 
-        std::stringstream errorMsg;
-        errorMsg << "Failed to link shaders\n" << linkLog;
+void saveProgramBinary(unsigned int program, const std::string &binaryCachePath) {
+    GLint binaryLength = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (binaryLength <= 0) return;
 
-        throw ge::BuildError(errorMsg.str());
-    }
+    std::vector<char> binary(static_cast<size_t>(binaryLength));
+    GLenum binaryFormat;
+    glGetProgramBinary(program, binaryLength, nullptr, &binaryFormat, binary.data());
+
+#ifdef _WIN32
+    _mkdir(ge::ShaderProgram::binaryCacheDirectory.c_str());
+#else
+    mkdir(ge::ShaderProgram::binaryCacheDirectory.c_str(), 0755);
+#endif
 
-    glDetachShader(shaderProgram, vertexShader);
-    glDetachShader(shaderProgram, fragmentShader);
-    if (geometryShader) glDetachShader(shaderProgram, geometryShader);
+    std::ofstream file(binaryCachePath, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&binaryFormat), sizeof(binaryFormat));
+    file.write(binary.data(), static_cast<std::streamsize>(binary.size()));
 
-    return shaderProgram;
+    if (!file) {
+        std::cerr << "Failed to write shader program binary cache: " << binaryCachePath << "\n";
+    }
 }
 
 } // namespace
 
 namespace ge {
+
+std::string ShaderProgram::binaryCacheDirectory = "shader_cache";
+
 ShaderProgram::ShaderProgram(const std::string &vertexShaderPath,
                              const std::string &fragmentShaderPath,
-                             const std::string &geometryShaderPath) {
-    // Compile shaders
-    auto vertexShader = compileShader(GL_VERTEX_SHADER, vertexShaderPath);
+                             const std::string &geometryShaderPath,
+                             const std::vector<std::string> &defines)
+    : shaderPaths{{GL_VERTEX_SHADER, vertexShaderPath}, {GL_FRAGMENT_SHADER, fragmentShaderPath}},
+      defines(defines) {
+    if (!geometryShaderPath.empty()) {
+        this->shaderPaths.emplace_back(GL_GEOMETRY_SHADER, geometryShaderPath);
+    }
 
-    unsigned int fragmentShader;
-    try {
-        fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentShaderPath);
-    } catch (std::exception&) {
-        glDeleteShader(vertexShader);
-        throw;
+    std::vector<std::string> shaderCodes;
+    for (const auto &shaderPath : this->shaderPaths) {
+        shaderCodes.push_back(loadShaderCode(shaderPath.second, defines));
     }
 
-    auto geometryShader = 0u;
-    if (!geometryShaderPath.empty()) {
-        try {
-            geometryShader = compileShader(GL_GEOMETRY_SHADER, geometryShaderPath);
-        } catch (std::exception&) {
-            glDeleteShader(vertexShader);
-            glDeleteShader(fragmentShader);
-            throw;
+    programs.push_back(this);
+
+    // Load cached program binary
+    const auto useBinaryCache = !binaryCacheDirectory.empty() && isProgramBinarySupported();
+    if (useBinaryCache) {
+        this->binaryCachePath = getBinaryCachePath(shaderCodes);
+        this->id = loadProgramBinary(this->binaryCachePath);
+
+        if (this->id) {
+            this->built = true;
+            std::cout << "Loaded cached shader program binary:\n"
+                      << vertexShaderPath << "\n" << fragmentShaderPath << "\n";
+            if (!geometryShaderPath.empty()) std::cout << geometryShaderPath << "\n";
+            std::cout << "\n";
+            return;
         }
     }
 
-    // Link shaders
-    try {
-        this->id = linkShaderProgram(vertexShader, fragmentShader, geometryShader);
-    } catch (std::exception&) {
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-        if (geometryShader) glDeleteShader(geometryShader);
-        throw;
-    }
-    std::cout << "Successfully compiled and linked shaders:\n"
-              << vertexShaderPath << "\n" << fragmentShaderPath << "\n";
-    if (geometryShader) std::cout << geometryShaderPath << "\n";
-    std::cout << "\n";
+    // Start compiling and linking shaders. The driver may do so in the background.
+    this->id = startBuildingProgram(this->shaderPaths, shaderCodes, useBinaryCache, &this->shaders);
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-    if (geometryShader) glDeleteShader(geometryShader);
+    pendingPrograms.push_back(this);
 }
 
 ShaderProgram::~ShaderProgram() {
+    pendingPrograms.erase(std::remove(pendingPrograms.begin(), pendingPrograms.end(), this),
+                          pendingPrograms.end());
+    programs.erase(std::remove(programs.begin(), programs.end(), this), programs.end());
+
+    for (const auto &shader : this->shaders) {
+        glDeleteShader(shader.first);
+    }
     glDeleteProgram(this->id);
+
+    if (this->reloadId) {
+        deleteShaders(this->reloadId, &this->reloadShaders);
+        glDeleteProgram(this->reloadId);
+    }
+}
+
+void ShaderProgram::prewarm() {
+    while (!pendingPrograms.empty()) {
+        auto program = pendingPrograms.begin();
+
+        if (isParallelCompileSupported()) {
+            program = std::find_if(pendingPrograms.begin(), pendingPrograms.end(),
+                                   [](const ShaderProgram *pendingProgram) {
+                int completed;
+                glGetProgramiv(pendingProgram->id, COMPLETION_STATUS, &completed);
+                return completed;
+            });
+
+            if (program == pendingPrograms.end()) {
+                std::this_thread::yield();
+                continue;
+            }
+        }
+
+        (*program)->finishBuild();
+    }
+}
+
+std::vector<std::string> ShaderProgram::getFilepaths() {
+    std::set<std::string> filepaths;
+    for (auto program : programs) {
+        if (program->dependencies.empty()) {
+            std::set<std::string> dependencies;
+            for (const auto &shaderPath : program->shaderPaths) {
+                const auto filenameIndex = shaderPath.second.find_last_of('/');
+                findIncludes(shaderPath.second, filenameIndex == std::string::npos ? std::string(".")
+                                                                                  : shaderPath.second.substr(0, filenameIndex),
+                             &dependencies);
+            }
+            program->dependencies.assign(dependencies.begin(), dependencies.end());
+        }
+
+        filepaths.insert(program->dependencies.begin(), program->dependencies.end());
+    }
+
+    return {filepaths.begin(), filepaths.end()};
+}
+
+void ShaderProgram::reload(const std::vector<std::string> &changedFilepaths) {
+    // Find the dependencies of programs created since they were last looked up
+    getFilepaths();
+
+    for (auto program : programs) {
+        const auto &dependencies = program->dependencies;
+        const auto changed = std::any_of(changedFilepaths.begin(), changedFilepaths.end(),
+                                         [&dependencies](const std::string &filepath) {
+            return std::binary_search(dependencies.begin(), dependencies.end(), filepath);
+        });
+        if (!changed) continue;
+
+        try {
+            program->startReload();
+        } catch (std::exception &e) {
+            std::cerr << "Failed to reload shaders: " << e.what() << "\n";
+        }
+    }
+}
+
+void ShaderProgram::finishReloads() {
+    for (auto program : programs) {
+        if (program->reloadId) program->finishReload();
+    }
 }
 
 ShaderProgram& ShaderProgram::use() {
+    this->finishBuild();
     glUseProgram(this->id);
     return *this;
 }
 
 ShaderProgram& ShaderProgram::setUniform(const std::string &name, bool value) {
-    this->setUniform(name, value);
+    glUniform1i(glGetUniformLocation(this->id, name.c_str()), value);
     return *this;
 }
 
@@ -217,6 +584,11 @@ ShaderProgram& ShaderProgram::setUniform(const std::string &name, const glm::vec
     return *this;
 }
 
+ShaderProgram& ShaderProgram::setUniform(const std::string &name, const glm::vec4 &v) {
+    glUniform4f(glGetUniformLocation(this->id, name.c_str()), v.x, v.y, v.z, v.w);
+    return *this;
+}
+
 ShaderProgram& ShaderProgram::setUniform(const std::string &name, const glm::mat3 &m) {
     glUniformMatrix3fv(glGetUniformLocation(this->id, name.c_str()), 1, GL_FALSE, glm::value_ptr(m));
     return *this;
@@ -229,7 +601,116 @@ ShaderProgram& ShaderProgram::setUniform(const std::string &name, const glm::mat
 
 ShaderProgram& ShaderProgram::setUniformBlockBinding(const std::string &uniformBlockName,
                                                      unsigned int bindingPoint) {
+    // Kept to bind the blocks of rebuilt programs
+    auto binding = std::find_if(this->uniformBlockBindings.begin(), this->uniformBlockBindings.end(),
+                                [&uniformBlockName](const auto &binding){return binding.first == uniformBlockName;});
+    if (binding != this->uniformBlockBindings.end()) {
+        binding->second = bindingPoint;
+    } else {
+        this->uniformBlockBindings.emplace_back(uniformBlockName, bindingPoint);
+    }
+
+    if (!this->built) {
+        this->pendingUniformBlockBindings.emplace_back(uniformBlockName, bindingPoint);
+        return *this;
+    }
+
     glUniformBlockBinding(this->id, glGetUniformBlockIndex(this->id, uniformBlockName.c_str()), bindingPoint);
     return *this;
 }
+
+void ShaderProgram::finishBuild() {
+    if (this->built) return;
+
+    pendingPrograms.erase(std::remove(pendingPrograms.begin(), pendingPrograms.end(), this),
+                          pendingPrograms.end());
+
+    const auto errors = getBuildErrors(this->id, this->shaders);
+    if (!errors.empty()) {
+        deleteShaders(this->id, &this->shaders);
+        throw BuildError(errors);
+    }
+
+    std::cout << "Successfully compiled and linked shaders:\n";
+    for (const auto &shader : this->shaders) {
+        std::cout << shader.second << "\n";
+    }
+    std::cout << "\n";
+
+    deleteShaders(this->id, &this->shaders);
+
+    if (!this->binaryCachePath.empty()) {
+        saveProgramBinary(this->id, this->binaryCachePath);
+    }
+
+    this->built = true;
+
+    for (const auto &binding : this->pendingUniformBlockBindings) {
+        this->setUniformBlockBinding(binding.first, binding.second);
+    }
+    this->pendingUniformBlockBindings.clear();
+}
+
+void ShaderProgram::startReload() {
+    std::vector<std::string> shaderCodes;
+    for (const auto &shaderPath : this->shaderPaths) {
+        shaderCodes.push_back(loadShaderCode(shaderPath.second, this->defines));
+    }
+
+    // Includes may have changed too
+    this->dependencies.clear();
+
+    // Supersede a rebuild of older sources
+    if (this->reloadId) {
+        deleteShaders(this->reloadId, &this->reloadShaders);
+        glDeleteProgram(this->reloadId);
+    }
+
+    const auto useBinaryCache = !binaryCacheDirectory.empty() && isProgramBinarySupported();
+    this->reloadBinaryCachePath = useBinaryCache ? getBinaryCachePath(shaderCodes) : std::string();
+    this->reloadId = startBuildingProgram(this->shaderPaths, shaderCodes, useBinaryCache, &this->reloadShaders);
+}
+
+bool ShaderProgram::finishReload() {
+    if (!isBuildComplete(this->reloadId)) return false;
+
+    const auto reloadId = this->reloadId;
+    this->reloadId = 0;
+
+    const auto errors = getBuildErrors(reloadId, this->reloadShaders);
+    deleteShaders(reloadId, &this->reloadShaders);
+
+    if (!errors.empty()) {
+        std::cerr << "Failed to reload shaders, keeping the previous build:\n" << errors << "\n";
+        glDeleteProgram(reloadId);
+        return true;
+    }
+
+    // Replace the program, even if its previous build has not finished
+    pendingPrograms.erase(std::remove(pendingPrograms.begin(), pendingPrograms.end(), this),
+                          pendingPrograms.end());
+    deleteShaders(this->id, &this->shaders);
+    glDeleteProgram(this->id);
+
+    this->id = reloadId;
+    this->built = true;
+    this->pendingUniformBlockBindings.clear();
+    for (const auto &binding : this->uniformBlockBindings) {
+        glUniformBlockBinding(this->id, glGetUniformBlockIndex(this->id, binding.first.c_str()), binding.second);
+    }
+
+    this->binaryCachePath = this->reloadBinaryCachePath;
+    if (!this->binaryCachePath.empty()) {
+        saveProgramBinary(this->id, this->binaryCachePath);
+    }
+
+    std::cout << "Reloaded shaders:\n";
+    for (const auto &shaderPath : this->shaderPaths) {
+        std::cout << shaderPath.second << "\n";
+    }
+    std::cout << "\n";
+
+    return true;
+}
+
 } // namespace ge
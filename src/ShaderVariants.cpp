@@ -0,0 +1,55 @@
+#include <game_engine/ShaderVariants.h>
+
+#include <game_engine/Exception.h>
+
+namespace ge {
+
+ShaderVariants::ShaderVariants(std::string vertexShaderPath,
+                               std::string fragmentShaderPath,
+                               std::string geometryShaderPath,
+                               std::vector<std::string> featureDefines)
+    : vertexShaderPath(std::move(vertexShaderPath)),
+      fragmentShaderPath(std::move(fragmentShaderPath)),
+      geometryShaderPath(std::move(geometryShaderPath)),
+      featureDefines(std::move(featureDefines)) {
+    if (this->featureDefines.size() > sizeof(Features) * 8) {
+        throw Error("Too many shader features for the feature mask.");
+    }
+}
+
+ShaderProgram& ShaderVariants::getVariant(Features features) {
+    auto &variant = this->variants[features];
+    if (variant) return *variant;
+
+    std::vector<std::string> defines;
+    for (size_t i = 0; i < this->featureDefines.size(); ++i) {
+        if (features & (1u << i)) defines.push_back(this->featureDefines[i]);
+    }
+
+    try {
+        variant = std::make_unique<ShaderProgram>(this->vertexShaderPath, this->fragmentShaderPath,
+                                                  this->geometryShaderPath, defines);
+    } catch (std::exception&) {
+        this->variants.erase(features);
+        throw;
+    }
+
+    for (const auto &binding : this->uniformBlockBindings) {
+        variant->setUniformBlockBinding(binding.first, binding.second);
+    }
+
+    return *variant;
+}
+
+ShaderVariants& ShaderVariants::setUniformBlockBinding(const std::string &uniformBlockName,
+                                                       unsigned int bindingPoint) {
+    this->uniformBlockBindings.emplace_back(uniformBlockName, bindingPoint);
+
+    for (auto &variant : this->variants) {
+        variant.second->setUniformBlockBinding(uniformBlockName, bindingPoint);
+    }
+
+    return *this;
+}
+
+} // namespace ge
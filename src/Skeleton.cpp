@@ -0,0 +1,196 @@
+#include <game_engine/Skeleton.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/matrix.hpp>
+
+#include <game_engine/Exception.h>
+
+namespace {
+
+glm::mat4 toMat4(const aiMatrix4x4 &matrix) {
+    // Assimp matrices are row major
+    return glm::transpose(glm::make_mat4(&matrix.a1));
+}
+
+} // namespace
+
+namespace ge {
+
+constexpr size_t Skeleton::MAX_BONES;
+constexpr size_t Skeleton::NO_JOINT;
+
+JointTransform JointTransform::fromMatrix(const glm::mat4 &matrix) {
+    JointTransform transform;
+    transform.translation = glm::vec3(matrix[3]);
+
+    glm::mat3 rotation(matrix);
+    for (int i = 0; i < 3; ++i) {
+        transform.scale[i] = glm::length(rotation[i]);
+        rotation[i] /= transform.scale[i];
+    }
+
+    // Mirroring transforms are represented by a negative scale
+    if (glm::determinant(rotation) < 0.0f) {
+        transform.scale.x = -transform.scale.x;
+        rotation[0] = -rotation[0];
+    }
+
+    transform.rotation = glm::normalize(glm::quat_cast(rotation));
+    return transform;
+}
+
+glm::quat JointTransform::interpolateRotation(const glm::quat &a, const glm::quat &b, float t) {
+    // q and -q are the same rotation, so interpolate towards the closer one
+    const auto closestB = (glm::dot(a, b) < 0.0f) ? -b : b;
+    return glm::normalize(a * (1.0f - t) + closestB * t);
+}
+
+glm::mat4 JointTransform::toMatrix() const {
+    auto matrix = glm::mat4_cast(this->rotation);
+    matrix[0] *= this->scale.x;
+    matrix[1] *= this->scale.y;
+    matrix[2] *= this->scale.z;
+    matrix[3] = glm::vec4(this->translation, 1.0f);
+    return matrix;
+}
+
+void blendPoses(const Pose &a, const Pose &b, float weight, Pose *result) {
+    result->resize(a.size());
+
+    for (size_t i = 0; i < a.size(); ++i) {
+        (*result)[i].translation = glm::mix(a[i].translation, b[i].translation, weight);
+        (*result)[i].rotation = JointTransform::interpolateRotation(a[i].rotation, b[i].rotation, weight);
+        (*result)[i].scale = glm::mix(a[i].scale, b[i].scale, weight);
+    }
+}
+
+bool Skeleton::hasBones(const aiScene &scene) {
+    for (unsigned int i = 0; i < scene.mNumMeshes; ++i) {
+        if (scene.mMeshes[i]->HasBones()) return true;
+    }
+
+    return false;
+}
+
+Skeleton::Skeleton(const aiScene &scene) {
+    // Traverse the hierarchy breadth-first like GameObject::loadModelNodes()
+    std::vector<const aiNode*> nodes {scene.mRootNode};
+    this->jointParents.push_back(NO_JOINT);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const auto &node = *nodes[i];
+
+        this->jointNames.emplace_back(node.mName.C_Str());
+        this->jointIndices.emplace(this->jointNames.back(), i);
+        this->bindPose.push_back(JointTransform::fromMatrix(toMat4(node.mTransformation)));
+
+        for (unsigned int j = 0; j < node.mNumChildren; ++j) {
+            nodes.push_back(node.mChildren[j]);
+            this->jointParents.push_back(i);
+        }
+    }
+
+    // Bones are shared by all meshes, so that a single skin matrix palette deforms the whole model
+    for (unsigned int i = 0; i < scene.mNumMeshes; ++i) {
+        const auto &mesh = *scene.mMeshes[i];
+
+        for (unsigned int j = 0; j < mesh.mNumBones; ++j) {
+            const auto &bone = *mesh.mBones[j];
+            const std::string boneName = bone.mName.C_Str();
+            if (this->boneIndices.count(boneName)) continue;
+
+            const auto joint = this->findJoint(boneName);
+            if (joint == NO_JOINT) {
+                throw LoadError("Failed to find the node of bone " + boneName + ".");
+            }
+
+            if (this->boneJoints.size() == MAX_BONES) {
+                throw LoadError("Failed to load skeleton: more than " + std::to_string(MAX_BONES) + " bones.");
+            }
+
+            this->boneIndices.emplace(boneName, this->boneJoints.size());
+            this->boneJoints.push_back(joint);
+            this->inverseBindMatrices.push_back(toMat4(bone.mOffsetMatrix));
+        }
+    }
+}
+
+std::vector<BoneInfluences> Skeleton::computeBoneInfluences(const aiMesh &mesh) const {
+    constexpr static auto maxInfluences = 4u;
+
+    // Keep the most influential bones of every vertex, sorted by descending weight
+    std::vector<std::array<std::pair<float, size_t>, maxInfluences>> vertexWeights(mesh.mNumVertices);
+    for (auto &weights : vertexWeights) {
+        weights.fill({0.0f, 0});
+    }
+
+    for (unsigned int i = 0; i < mesh.mNumBones; ++i) {
+        const auto &bone = *mesh.mBones[i];
+        const auto boneIndex = this->boneIndices.at(bone.mName.C_Str());
+
+        for (unsigned int j = 0; j < bone.mNumWeights; ++j) {
+            auto &weights = vertexWeights[bone.mWeights[j].mVertexId];
+            const std::pair<float, size_t> influence(bone.mWeights[j].mWeight, boneIndex);
+
+            if (influence.first <= weights.back().first) continue;
+            weights.back() = influence;
+            std::sort(weights.begin(), weights.end(), [](const auto &a, const auto &b){
+                return a.first > b.first;
+            });
+        }
+    }
+
+    std::vector<BoneInfluences> influences(mesh.mNumVertices);
+    for (size_t i = 0; i < influences.size(); ++i) {
+        const auto &weights = vertexWeights[i];
+
+        auto weightSum = 0.0f;
+        for (const auto &weight : weights) {
+            weightSum += weight.first;
+        }
+
+        if (weightSum <= 0.0f) {
+            influences[i].weights[0] = 255;
+            continue;
+        }
+
+        // Quantize the normalized weights and give the rounding error to the largest weight
+        auto quantizedSum = 0;
+        for (unsigned int j = 0; j < maxInfluences; ++j) {
+            influences[i].bones[j] = static_cast<std::uint8_t>(weights[j].second);
+            influences[i].weights[j] = static_cast<std::uint8_t>(std::round(weights[j].first / weightSum * 255.0f));
+            quantizedSum += influences[i].weights[j];
+        }
+        influences[i].weights[0] = static_cast<std::uint8_t>(influences[i].weights[0] + 255 - quantizedSum);
+    }
+
+    return influences;
+}
+
+void Skeleton::computeModelTransforms(const Pose &pose, std::vector<glm::mat4> *modelTransforms) const {
+    modelTransforms->resize(this->jointNames.size());
+
+    // Parents come before their children
+    for (size_t i = 0; i < this->jointNames.size(); ++i) {
+        const auto localTransform = pose[i].toMatrix();
+        const auto parent = this->jointParents[i];
+        (*modelTransforms)[i] = (parent == NO_JOINT) ? localTransform : (*modelTransforms)[parent] * localTransform;
+    }
+}
+
+void Skeleton::computeSkinMatrices(const std::vector<glm::mat4> &modelTransforms, glm::mat4 *skinMatrices) const {
+    for (size_t i = 0; i < this->boneJoints.size(); ++i) {
+        skinMatrices[i] = modelTransforms[this->boneJoints[i]] * this->inverseBindMatrices[i];
+    }
+}
+
+size_t Skeleton::findJoint(const std::string &name) const {
+    const auto joint = this->jointIndices.find(name);
+    return (joint == this->jointIndices.end()) ? NO_JOINT : joint->second;
+}
+
+} // namespace ge
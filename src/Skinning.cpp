@@ -0,0 +1,100 @@
+#include <game_engine/Skinning.h>
+
+#include <cmath>
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/mat3x3.hpp>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define GE_SKINNING_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace {
+
+constexpr size_t skinningGrainSize = 1024;
+constexpr float weightScale = 1.0f / 255.0f;
+
+#ifdef GE_SKINNING_SSE
+
+void skinRange(const glm::vec3 *positions, const glm::vec3 *normals,
+               const ge::BoneInfluences *boneInfluences, const glm::mat4 *skinMatrices,
+               glm::vec3 *skinnedPositions, glm::vec3 *skinnedNormals, size_t begin, size_t end) {
+    alignas(16) float result[4];
+
+    for (auto i = begin; i < end; ++i) {
+        // Blend the columns of the skin matrices
+        auto column0 = _mm_setzero_ps();
+        auto column1 = _mm_setzero_ps();
+        auto column2 = _mm_setzero_ps();
+        auto column3 = _mm_setzero_ps();
+
+        const auto &influences = boneInfluences[i];
+        for (size_t j = 0; j < influences.bones.size(); ++j) {
+            if (influences.weights[j] == 0) continue;
+
+            const auto weight = _mm_set1_ps(influences.weights[j] * weightScale);
+            const auto matrix = glm::value_ptr(skinMatrices[influences.bones[j]]);
+            column0 = _mm_add_ps(column0, _mm_mul_ps(weight, _mm_loadu_ps(matrix)));
+            column1 = _mm_add_ps(column1, _mm_mul_ps(weight, _mm_loadu_ps(matrix + 4)));
+            column2 = _mm_add_ps(column2, _mm_mul_ps(weight, _mm_loadu_ps(matrix + 8)));
+            column3 = _mm_add_ps(column3, _mm_mul_ps(weight, _mm_loadu_ps(matrix + 12)));
+        }
+
+        const auto &position = positions[i];
+        auto skinnedPosition = _mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(position.x)),
+                                          _mm_mul_ps(column1, _mm_set1_ps(position.y)));
+        skinnedPosition = _mm_add_ps(skinnedPosition, _mm_mul_ps(column2, _mm_set1_ps(position.z)));
+        skinnedPosition = _mm_add_ps(skinnedPosition, column3);
+        _mm_store_ps(result, skinnedPosition);
+        skinnedPositions[i] = glm::vec3(result[0], result[1], result[2]);
+
+        if (!normals) continue;
+
+        const auto &normal = normals[i];
+        auto skinnedNormal = _mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(normal.x)),
+                                        _mm_mul_ps(column1, _mm_set1_ps(normal.y)));
+        skinnedNormal = _mm_add_ps(skinnedNormal, _mm_mul_ps(column2, _mm_set1_ps(normal.z)));
+        _mm_store_ps(result, skinnedNormal);
+        skinnedNormals[i] = glm::normalize(glm::vec3(result[0], result[1], result[2]));
+    }
+}
+
+#else
+
+void skinRange(const glm::vec3 *positions, const glm::vec3 *normals,
+               const ge::BoneInfluences *boneInfluences, const glm::mat4 *skinMatrices,
+               glm::vec3 *skinnedPositions, glm::vec3 *skinnedNormals, size_t begin, size_t end) {
+    for (auto i = begin; i < end; ++i) {
+        glm::mat4 skinMatrix(0.0f);
+
+        const auto &influences = boneInfluences[i];
+        for (size_t j = 0; j < influences.bones.size(); ++j) {
+            if (influences.weights[j] == 0) continue;
+            skinMatrix += skinMatrices[influences.bones[j]] * (influences.weights[j] * weightScale);
+        }
+
+        skinnedPositions[i] = glm::vec3(skinMatrix * glm::vec4(positions[i], 1.0f));
+        if (normals) skinnedNormals[i] = glm::normalize(glm::mat3(skinMatrix) * normals[i]);
+    }
+}
+
+#endif
+
+} // namespace
+
+namespace ge {
+
+void skinVertices(const glm::vec3 *positions, const glm::vec3 *normals,
+                  const BoneInfluences *boneInfluences, size_t numVertices,
+                  const glm::mat4 *skinMatrices,
+                  glm::vec3 *skinnedPositions, glm::vec3 *skinnedNormals,
+                  JobSystem &jobSystem) {
+    jobSystem.parallelFor(numVertices, skinningGrainSize, [=](size_t begin, size_t end){
+        skinRange(positions, normals, boneInfluences, skinMatrices,
+                  skinnedPositions, skinnedNormals, begin, end);
+    });
+}
+
+} // namespace ge
@@ -1,11 +1,22 @@
 #include <game_engine/Skybox.h>
 
-#include <glad/glad.h>
-#include <stb_image.h>
-
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
 #include <vector>
 
+#ifdef _WIN32
+#include <direct.h>
+#endif
+#include <sys/stat.h>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <game_engine/CubemapImage.h>
 #include <game_engine/Exception.h>
+#include <game_engine/ResourceManager.h>
 #include <game_engine/ShaderProgram.h>
 
 namespace {
@@ -55,31 +66,135 @@ const std::vector<float> skyboxVertices {
       1.0f, -1.0f,  1.0f
 };
 
-unsigned int loadCubemapTexture(const std::array<std::string, 6> &imageFilepaths) {
+constexpr GLenum COMPRESSED_RGB_S3TC_DXT1 = 0x83F0;
+
+bool isBc1Supported() {
+    static const bool supported = glfwExtensionSupported("GL_EXT_texture_compression_s3tc") ||
+            glfwExtensionSupported("GL_EXT_texture_compression_dxt1");
+    return supported;
+}
+
+///
+/// \brief getCachePath Returns the cache filepath of the cubemaps prefiltered from the
+///                     given faces with the current settings.
+///
+std::string getCachePath(const std::array<std::string, 6> &imageFilepaths, bool compressed) {
+    // FNV-1a hash of the faces' paths, sizes and modification times
+    std::uint64_t hash = 14695981039346656037ull;
+    auto hashBytes = [&hash](const void *data, size_t size_bytes) {
+        for (size_t i = 0; i < size_bytes; ++i) {
+            hash = (hash ^ static_cast<const unsigned char*>(data)[i]) * 1099511628211ull;
+        }
+        hash = (hash ^ 0xFFu) * 1099511628211ull;
+    };
+
+    for (const auto &imageFilepath : imageFilepaths) {
+        const auto canonicalPath = ge::ResourceManager::getCanonicalPath(imageFilepath);
+        hashBytes(canonicalPath.data(), canonicalPath.size());
+
+        struct stat status {};
+        stat(imageFilepath.c_str(), &status);
+        const std::int64_t size_bytes = status.st_size, modificationTime = status.st_mtime;
+        hashBytes(&size_bytes, sizeof(size_bytes));
+        hashBytes(&modificationTime, sizeof(modificationTime));
+    }
+
+    hashBytes(&compressed, sizeof(compressed));
+    hashBytes(&ge::Skybox::irradianceMapSize, sizeof(ge::Skybox::irradianceMapSize));
+    hashBytes(&ge::Skybox::specularMapSize, sizeof(ge::Skybox::specularMapSize));
+    hashBytes(&ge::Skybox::numSpecularMapLevels, sizeof(ge::Skybox::numSpecularMapLevels));
+
+    std::stringstream path;
+    path << ge::Skybox::cacheDirectory << "/"
+         << std::hex << std::setw(16) << std::setfill('0') << hash << ".cubemap";
+    return path.str();
+}
+
+///
+/// \brief loadPrefilteredCubemaps Returns the mipmapped cubemap of a skybox, its
+///                                irradiance map and specular map, from the cache if
+///                                possible.
+/// \param irradianceSh Receives the irradiance of the skybox in spherical harmonics.
+/// \exception ge::LoadError Failed to load texture data from image file.
+///
+std::vector<ge::CubemapImage> loadPrefilteredCubemaps(const std::array<std::string, 6> &imageFilepaths,
+                                                      ge::ShCoefficients *irradianceSh) {
+    const auto compressed = ge::Skybox::compressionEnabled && isBc1Supported();
+    const auto cachePath = ge::Skybox::cacheDirectory.empty() ? std::string()
+                                                              : getCachePath(imageFilepaths, compressed);
+
+    // The coefficients are stored as the values of the container
+    if (!cachePath.empty()) {
+        std::vector<float> values;
+        auto cubemaps = ge::loadCubemaps(cachePath, &values);
+        if (cubemaps.size() == 3 && values.size() == irradianceSh->size() * 3) {
+            for (size_t i = 0; i < irradianceSh->size(); ++i) {
+                (*irradianceSh)[i] = glm::vec3(values[3 * i], values[3 * i + 1], values[3 * i + 2]);
+            }
+            std::cout << "Loaded cached skybox: " << cachePath << "\n";
+            return cubemaps;
+        }
+    }
+
+    auto radiance = ge::decodeCubemap(imageFilepaths);
+    ge::generateCubemapMipmaps(&radiance);
+    auto irradiance = ge::computeIrradiance(radiance, ge::Skybox::irradianceMapSize);
+    auto specular = ge::prefilterSpecular(radiance, ge::Skybox::specularMapSize, ge::Skybox::numSpecularMapLevels);
+    *irradianceSh = ge::projectIrradianceSh9(radiance);
+
+    std::vector<ge::CubemapImage> cubemaps;
+    cubemaps.push_back(compressed ? ge::compressCubemapBc1(radiance) : std::move(radiance));
+    cubemaps.push_back(std::move(irradiance));
+    // Small enough to keep uncompressed, and it must be decoded from sRGB when sampled
+    cubemaps.push_back(std::move(specular));
+
+    if (!cachePath.empty()) {
+#ifdef _WIN32
+        _mkdir(ge::Skybox::cacheDirectory.c_str());
+#else
+        mkdir(ge::Skybox::cacheDirectory.c_str(), 0755);
+#endif
+        std::vector<float> values;
+        for (const auto &coefficient : *irradianceSh) {
+            values.insert(values.end(), {coefficient.r, coefficient.g, coefficient.b});
+        }
+        ge::saveCubemaps(cachePath, cubemaps, values);
+    }
+
+    return cubemaps;
+}
+
+///
+/// \brief createCubemapTexture Uploads every level of a cubemap.
+/// \param srgb Whether RGBA8 texels are converted to linear color space when sampled.
+/// \return Cubemap texture.
+///
+unsigned int createCubemapTexture(const ge::CubemapImage &image, bool srgb = false) {
     unsigned int texture;
     glGenTextures(1, &texture);
 
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
 
-    int width, height, numChannels;
-    for (auto i = 0u; i < imageFilepaths.size(); ++i) {
-        auto image = stbi_load(imageFilepaths[i].c_str(),
-                               &width, &height, &numChannels, 0);
-
-        if (image) {
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                         0, GL_RGB, width, height,
-                         0, GL_RGB, GL_UNSIGNED_BYTE, image);
-            stbi_image_free(image);
-        } else {
-            stbi_image_free(image);
-            glDeleteTextures(1, &texture);
-            throw ge::LoadError("Failed to load texture at " + imageFilepaths[i]);
+    for (size_t level = 0; level < image.levels.size(); ++level) {
+        const auto size = image.getLevelSize(level);
+        for (auto face = 0u; face < image.levels[level].size(); ++face) {
+            const auto &data = image.levels[level][face];
+            if (image.format == ge::CubemapImage::BC1) {
+                glCompressedTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, static_cast<GLint>(level),
+                                       COMPRESSED_RGB_S3TC_DXT1, size, size, 0,
+                                       static_cast<GLsizei>(data.size()), data.data());
+            } else {
+                glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, static_cast<GLint>(level),
+                             srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                             data.data());
+            }
         }
     }
 
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(image.levels.size()) - 1);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER,
+                    image.levels.size() > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -93,6 +208,12 @@ unsigned int loadCubemapTexture(const std::array<std::string, 6> &imageFilepaths
 
 namespace ge {
 
+std::string Skybox::cacheDirectory = "skybox_cache";
+bool Skybox::compressionEnabled = false;
+int Skybox::irradianceMapSize = 16;
+int Skybox::specularMapSize = 128;
+int Skybox::numSpecularMapLevels = 6;
+
 Skybox::Skybox(const std::array<std::string, 6> &imageFilepaths) {
     // Load vertex data
     glGenVertexArrays(1, &this->vao);
@@ -112,14 +233,23 @@ Skybox::Skybox(const std::array<std::string, 6> &imageFilepaths) {
 
     // Load textures
     try {
-        this->texture = loadCubemapTexture(imageFilepaths);
+        const auto cubemaps = loadPrefilteredCubemaps(imageFilepaths, &this->irradianceSh);
+        this->texture = createCubemapTexture(cubemaps[0]);
+        this->irradianceMap = createCubemapTexture(cubemaps[1]);
+        this->specularMap = createCubemapTexture(cubemaps[2], true);
+        this->numSpecularLevels = static_cast<int>(cubemaps[2].levels.size());
     } catch (std::exception&) {
+        glDeleteTextures(1, &this->irradianceMap);
+        glDeleteTextures(1, &this->texture);
         glDeleteBuffers(1, &this->vbo);
         glDeleteVertexArrays(1, &this->vao);
+        throw;
     }
 }
 
 Skybox::~Skybox() {
+    glDeleteTextures(1, &this->specularMap);
+    glDeleteTextures(1, &this->irradianceMap);
     glDeleteTextures(1, &this->texture);
     glDeleteBuffers(1, &this->vbo);
     glDeleteVertexArrays(1, &this->vao);
@@ -135,4 +265,16 @@ void Skybox::render(ShaderProgram *shader) {
     glBindVertexArray(0);
 }
 
+void Skybox::bindIrradianceMap(unsigned int textureUnit) const {
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, this->irradianceMap);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void Skybox::bindSpecularMap(unsigned int textureUnit) const {
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, this->specularMap);
+    glActiveTexture(GL_TEXTURE0);
+}
+
 } // namespace ge
@@ -0,0 +1,521 @@
+#include <game_engine/SoftwareRasterizer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <assimp/scene.h>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/matrix.hpp>
+#include <glm/vec4.hpp>
+
+#include <stb_image.h>
+
+#include <game_engine/Exception.h>
+#include <game_engine/JobSystem.h>
+#include <game_engine/ModelImport.h>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define GE_RASTERIZER_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace {
+
+constexpr int numChannels = 4;
+
+/// Elements per range when transforming vertices and binning triangles.
+constexpr size_t vertexGrainSize = 4096;
+constexpr size_t binningGrainSize = 4096;
+
+/// Vertices are snapped to 1/16 of a pixel like on GPUs, so that edge functions of
+/// nearly degenerate triangles stay well conditioned.
+constexpr float subpixelSteps = 16.0f;
+
+/// Constant basis function of the spherical harmonics.
+constexpr float shConstantBasis = 0.282095f;
+
+///
+/// \brief The LoadedMaterial struct holds the textures of a material shared by its meshes.
+///
+struct LoadedMaterial {
+    std::shared_ptr<const ge::SoftwareImage> diffuseTexture;
+    std::shared_ptr<const ge::SoftwareImage> specularTexture;
+    float specularExponent = 64.0f;
+};
+
+glm::mat4 toMat4(const aiMatrix4x4 &matrix) {
+    // Assimp matrices are row major
+    return glm::transpose(glm::make_mat4(&matrix.a1));
+}
+
+///
+/// \brief loadImage Decodes the first texture of the given type in the material.
+///
+/// Channels are expanded to RGBA the way OpenGL expands the formats of Texture2D.
+///
+/// \return The image, or nullptr if the material has no texture of the type.
+/// \exception ge::LoadError Failed to load image data from file.
+///
+std::shared_ptr<const ge::SoftwareImage> loadImage(const aiMaterial &material, aiTextureType type,
+                                                   const std::string &textureDirectory) {
+    if (material.GetTextureCount(type) == 0) return nullptr;
+
+    aiString imageFilename;
+    material.GetTexture(type, 0, &imageFilename);
+    const auto imageFilepath = textureDirectory + "/" + imageFilename.C_Str();
+
+    auto image = std::make_shared<ge::SoftwareImage>();
+    int numFileChannels;
+    std::unique_ptr<unsigned char, void(*)(void*)> data(
+                stbi_load(imageFilepath.c_str(), &image->width, &image->height, &numFileChannels, 0),
+                stbi_image_free);
+
+    if (!data) {
+        throw ge::LoadError("Failed to load texture at: " + imageFilepath);
+    }
+
+    const auto numPixels = static_cast<size_t>(image->width) * image->height;
+    image->texels.resize(numPixels * numChannels);
+    for (size_t i = 0; i < numPixels; ++i) {
+        const auto pixel = data.get() + i * numFileChannels;
+        image->texels[i * numChannels + 0] = pixel[0];
+        image->texels[i * numChannels + 1] = numFileChannels >= 3 ? pixel[1] : 0;
+        image->texels[i * numChannels + 2] = numFileChannels >= 3 ? pixel[2] : 0;
+        image->texels[i * numChannels + 3] = numFileChannels == 4 ? pixel[3] : 255;
+    }
+
+    return image;
+}
+
+///
+/// \brief addNodeMeshes Appends the triangles of the meshes of a node and its children,
+///                      transformed into model space.
+///
+void addNodeMeshes(const aiScene &scene, const aiNode &node, const glm::mat4 &parentTransform,
+                   const std::vector<LoadedMaterial> &materials, std::vector<ge::SoftwareMesh> *meshes) {
+    const auto transform = parentTransform * toMat4(node.mTransformation);
+    const auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+
+    for (unsigned int i = 0; i < node.mNumMeshes; ++i) {
+        const auto &mesh = *scene.mMeshes[node.mMeshes[i]];
+
+        ge::SoftwareMesh softwareMesh;
+        softwareMesh.vertices.resize(mesh.mNumVertices);
+        for (unsigned int j = 0; j < mesh.mNumVertices; ++j) {
+            auto &vertex = softwareMesh.vertices[j];
+            const auto &position = mesh.mVertices[j];
+            vertex.position = glm::vec3(transform * glm::vec4(position.x, position.y, position.z, 1.0f));
+            vertex.normal = mesh.mNormals ? normalMatrix * glm::vec3(mesh.mNormals[j].x, mesh.mNormals[j].y,
+                                                                     mesh.mNormals[j].z)
+                                          : glm::vec3(0.0f, 0.0f, 1.0f);
+            vertex.textureCoordinates = mesh.mTextureCoords[0] ? glm::vec2(mesh.mTextureCoords[0][j].x,
+                                                                           mesh.mTextureCoords[0][j].y)
+                                                               : glm::vec2(0.0f);
+        }
+
+        // Points and lines are not drawn
+        for (unsigned int j = 0; j < mesh.mNumFaces; ++j) {
+            const auto &face = mesh.mFaces[j];
+            if (face.mNumIndices != 3) continue;
+            softwareMesh.indices.insert(softwareMesh.indices.end(), face.mIndices, face.mIndices + 3);
+        }
+        if (softwareMesh.indices.empty()) continue;
+
+        const auto &material = materials[mesh.mMaterialIndex];
+        softwareMesh.diffuseTexture = material.diffuseTexture;
+        softwareMesh.specularTexture = material.specularTexture;
+        softwareMesh.specularExponent = material.specularExponent;
+        meshes->push_back(std::move(softwareMesh));
+    }
+
+    for (unsigned int i = 0; i < node.mNumChildren; ++i) {
+        addNodeMeshes(scene, *node.mChildren[i], transform, materials, meshes);
+    }
+}
+
+///
+/// \brief sampleImage Samples an RGBA8 image like a repeating, bilinearly filtered
+///                    sampler without mipmaps.
+///
+glm::vec3 sampleImage(const ge::SoftwareImage &image, const glm::vec2 &textureCoordinates) {
+    const auto size = glm::vec2(image.width, image.height);
+    const auto position = glm::fract(textureCoordinates) * size - 0.5f;
+    const auto base = glm::floor(position);
+    const auto f = position - base;
+
+    glm::vec3 result(0.0f);
+    for (int y = 0; y <= 1; ++y) {
+        for (int x = 0; x <= 1; ++x) {
+            const auto texelX = ((static_cast<int>(base.x) + x) % image.width + image.width) % image.width;
+            const auto texelY = ((static_cast<int>(base.y) + y) % image.height + image.height) % image.height;
+            const auto texel = &image.texels[(static_cast<size_t>(texelY) * image.width + texelX) * numChannels];
+
+            const auto weight = (x ? f.x : 1.0f - f.x) * (y ? f.y : 1.0f - f.y);
+            result += glm::vec3(texel[0], texel[1], texel[2]) * (weight / 255.0f);
+        }
+    }
+
+    return result;
+}
+
+glm::vec3 calculateIrradiance(const ge::ShCoefficients &irradianceSh, const glm::vec3 &normal) {
+    // Evaluates the spherical harmonics of the irradiance divided by pi, see default.frag
+    return irradianceSh[0] * shConstantBasis
+            + irradianceSh[1] * (0.488603f * normal.y)
+            + irradianceSh[2] * (0.488603f * normal.z)
+            + irradianceSh[3] * (0.488603f * normal.x)
+            + irradianceSh[4] * (1.092548f * normal.x * normal.y)
+            + irradianceSh[5] * (1.092548f * normal.y * normal.z)
+            + irradianceSh[6] * (0.315392f * (3.0f * normal.z * normal.z - 1.0f))
+            + irradianceSh[7] * (1.092548f * normal.x * normal.z)
+            + irradianceSh[8] * (0.546274f * (normal.x * normal.x - normal.y * normal.y));
+}
+
+glm::vec3 tonemapAces(const glm::vec3 &color) {
+    // Narkowicz's fit of the ACES filmic curve, see tonemap.frag
+    return glm::clamp((color * (2.51f * color + 0.03f)) / (color * (2.43f * color + 0.59f) + 0.14f), 0.0f, 1.0f);
+}
+
+} // namespace
+
+namespace ge {
+
+constexpr int SoftwareRasterizer::TILE_SIZE_PIXELS;
+
+std::vector<SoftwareMesh> loadSoftwareMeshes(const std::string &modelFilepath) {
+    // Read without caching, since the imported model is only needed here
+    const auto importedModel = readModelFile(modelFilepath);
+    const auto &scene = *importedModel->scene;
+    const auto textureDirectory = modelFilepath.substr(0, modelFilepath.find_last_of('/'));
+
+    std::vector<LoadedMaterial> materials(scene.mNumMaterials);
+    for (unsigned int i = 0; i < scene.mNumMaterials; ++i) {
+        const auto &material = *scene.mMaterials[i];
+        materials[i].diffuseTexture = loadImage(material, aiTextureType_DIFFUSE, textureDirectory);
+        materials[i].specularTexture = loadImage(material, aiTextureType_SPECULAR, textureDirectory);
+
+        float shininess = 0.0f;
+        if (material.Get(AI_MATKEY_SHININESS, shininess) == AI_SUCCESS && shininess > 0.0f) {
+            materials[i].specularExponent = shininess;
+        }
+    }
+
+    std::vector<SoftwareMesh> meshes;
+    if (scene.mRootNode) addNodeMeshes(scene, *scene.mRootNode, glm::mat4(1.0f), materials, &meshes);
+
+    return meshes;
+}
+
+SoftwareRasterizer::SoftwareRasterizer(int width, int height, JobSystem &jobSystem)
+    : jobSystem(jobSystem), width(std::max(width, 1)), height(std::max(height, 1)),
+      numTilesX((this->width + TILE_SIZE_PIXELS - 1) / TILE_SIZE_PIXELS),
+      numTilesY((this->height + TILE_SIZE_PIXELS - 1) / TILE_SIZE_PIXELS) {
+    this->clear();
+}
+
+SoftwareRasterizer& SoftwareRasterizer::setCamera(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix,
+                                                  const glm::vec3 &viewPosition) {
+    this->viewProjectionMatrix = projectionMatrix * viewMatrix;
+    this->viewPosition = viewPosition;
+    return *this;
+}
+
+SoftwareRasterizer& SoftwareRasterizer::setDirectionalLight(const glm::vec3 &direction, const glm::vec3 &diffuse,
+                                                            const glm::vec3 &specular) {
+    this->lightDirection = glm::normalize(direction);
+    this->lightDiffuse = diffuse;
+    this->lightSpecular = specular;
+    return *this;
+}
+
+SoftwareRasterizer& SoftwareRasterizer::setAmbientLight(const ShCoefficients &irradianceSh) {
+    this->irradianceSh = irradianceSh;
+    return *this;
+}
+
+SoftwareRasterizer& SoftwareRasterizer::setAmbientLight(const glm::vec3 &ambient) {
+    this->irradianceSh = ShCoefficients {};
+    this->irradianceSh[0] = ambient / shConstantBasis;
+    return *this;
+}
+
+SoftwareRasterizer& SoftwareRasterizer::setTonemapping(bool enabled, float exposure) {
+    this->tonemappingEnabled = enabled;
+    this->exposure = exposure;
+    return *this;
+}
+
+void SoftwareRasterizer::clear(const glm::vec3 &color) {
+    const auto numPixels = static_cast<size_t>(this->width) * this->height;
+    this->colorBuffer.assign(numPixels, color);
+    this->depthBuffer.assign(numPixels, 1.0f);
+    this->triangles.clear();
+}
+
+void SoftwareRasterizer::draw(const SoftwareMesh &mesh, const glm::mat4 &modelMatrix) {
+    const auto modelViewProjectionMatrix = this->viewProjectionMatrix * modelMatrix;
+    const auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelMatrix)));
+
+    std::vector<ClipVertex> vertices(mesh.vertices.size());
+    this->jobSystem.parallelFor(vertices.size(), vertexGrainSize, [&](size_t begin, size_t end){
+        for (auto i = begin; i < end; ++i) {
+            const auto &vertex = mesh.vertices[i];
+            vertices[i].clipPosition = modelViewProjectionMatrix * glm::vec4(vertex.position, 1.0f);
+            vertices[i].worldPosition = glm::vec3(modelMatrix * glm::vec4(vertex.position, 1.0f));
+            vertices[i].normal = normalMatrix * vertex.normal;
+            vertices[i].textureCoordinates = vertex.textureCoordinates;
+        }
+    });
+
+    const auto interpolate = [](const ClipVertex &a, const ClipVertex &b, float t){
+        ClipVertex result;
+        result.clipPosition = glm::mix(a.clipPosition, b.clipPosition, t);
+        result.worldPosition = glm::mix(a.worldPosition, b.worldPosition, t);
+        result.normal = glm::mix(a.normal, b.normal, t);
+        result.textureCoordinates = glm::mix(a.textureCoordinates, b.textureCoordinates, t);
+        return result;
+    };
+
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        const ClipVertex *corners[3] = {&vertices[mesh.indices[i]], &vertices[mesh.indices[i + 1]],
+                                        &vertices[mesh.indices[i + 2]]};
+
+        // Clip against the near plane, z >= -w, which cuts off at most one corner. The
+        // other planes are handled by the bounding boxes and the depth range.
+        ClipVertex polygon[4];
+        int numVertices = 0;
+        for (int j = 0; j < 3; ++j) {
+            const auto &current = *corners[j];
+            const auto &next = *corners[(j + 1) % 3];
+            const auto currentDistance = current.clipPosition.z + current.clipPosition.w;
+            const auto nextDistance = next.clipPosition.z + next.clipPosition.w;
+
+            if (currentDistance >= 0.0f) polygon[numVertices++] = current;
+            if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f)) {
+                polygon[numVertices++] = interpolate(current, next, currentDistance / (currentDistance - nextDistance));
+            }
+        }
+
+        for (int j = 2; j < numVertices; ++j) {
+            this->setUpTriangle(polygon[0], polygon[j - 1], polygon[j], mesh);
+        }
+    }
+}
+
+void SoftwareRasterizer::flush() {
+    const auto numTiles = static_cast<size_t>(this->numTilesX) * this->numTilesY;
+    const auto numRanges = (this->triangles.size() + binningGrainSize - 1) / binningGrainSize;
+
+    // Every range of triangles is binned separately and the bins are concatenated in
+    // order, so that every tile draws its triangles in the order they were queued
+    std::vector<std::vector<std::vector<std::uint32_t>>> rangeBins(
+                numRanges, std::vector<std::vector<std::uint32_t>>(numTiles));
+    this->jobSystem.parallelFor(this->triangles.size(), binningGrainSize, [&](size_t begin, size_t end){
+        auto &bins = rangeBins[begin / binningGrainSize];
+        for (auto i = begin; i < end; ++i) {
+            const auto &triangle = this->triangles[i];
+            for (int tileY = triangle.minY / TILE_SIZE_PIXELS; tileY <= triangle.maxY / TILE_SIZE_PIXELS; ++tileY) {
+                for (int tileX = triangle.minX / TILE_SIZE_PIXELS; tileX <= triangle.maxX / TILE_SIZE_PIXELS; ++tileX) {
+                    bins[static_cast<size_t>(tileY) * this->numTilesX + tileX].push_back(static_cast<std::uint32_t>(i));
+                }
+            }
+        }
+    });
+
+    // Tiles cover distinct pixels, so they are rasterized without synchronization
+    this->jobSystem.parallelFor(numTiles, 1, [&](size_t begin, size_t end){
+        std::vector<std::uint32_t> triangleIndices;
+        for (auto tile = begin; tile < end; ++tile) {
+            triangleIndices.clear();
+            for (const auto &bins : rangeBins) {
+                triangleIndices.insert(triangleIndices.end(), bins[tile].begin(), bins[tile].end());
+            }
+
+            this->rasterizeTile(tile, triangleIndices);
+        }
+    });
+
+    this->triangles.clear();
+}
+
+std::vector<unsigned char> SoftwareRasterizer::readPixels() const {
+    std::vector<unsigned char> pixels(this->colorBuffer.size() * numChannels);
+    for (size_t i = 0; i < this->colorBuffer.size(); ++i) {
+        const auto color = this->tonemappingEnabled ? tonemapAces(this->colorBuffer[i] * this->exposure)
+                                                    : glm::clamp(this->colorBuffer[i], 0.0f, 1.0f);
+
+        for (int channel = 0; channel < 3; ++channel) {
+            pixels[i * numChannels + channel] = static_cast<unsigned char>(std::lround(color[channel] * 255.0f));
+        }
+        pixels[i * numChannels + 3] = 255;
+    }
+
+    return pixels;
+}
+
+void SoftwareRasterizer::setUpTriangle(const ClipVertex &v0, const ClipVertex &v1, const ClipVertex &v2,
+                                       const SoftwareMesh &mesh) {
+    const ClipVertex *vertices[3] = {&v0, &v1, &v2};
+
+    Triangle triangle;
+    for (int i = 0; i < 3; ++i) {
+        const auto &vertex = *vertices[i];
+        const auto inverseW = 1.0f / vertex.clipPosition.w;
+        const auto ndc = glm::vec3(vertex.clipPosition) * inverseW;
+
+        const glm::vec2 screenPosition((ndc.x * 0.5f + 0.5f) * this->width, (0.5f - ndc.y * 0.5f) * this->height);
+        triangle.screenPositions[i] = glm::round(screenPosition * subpixelSteps) / subpixelSteps;
+        triangle.depths[i] = ndc.z * 0.5f + 0.5f;
+        triangle.inverseWs[i] = inverseW;
+        triangle.worldPositions[i] = vertex.worldPosition * inverseW;
+        triangle.normals[i] = vertex.normal * inverseW;
+        triangle.textureCoordinates[i] = vertex.textureCoordinates * inverseW;
+    }
+
+    // Both sides are drawn, so back faces are turned around to get a positive area
+    const auto &p = triangle.screenPositions;
+    const auto area = (p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[1].y - p[0].y) * (p[2].x - p[0].x);
+    if (area == 0.0f || !std::isfinite(area)) return;
+    if (area < 0.0f) {
+        std::swap(triangle.screenPositions[1], triangle.screenPositions[2]);
+        std::swap(triangle.depths[1], triangle.depths[2]);
+        std::swap(triangle.inverseWs[1], triangle.inverseWs[2]);
+        std::swap(triangle.worldPositions[1], triangle.worldPositions[2]);
+        std::swap(triangle.normals[1], triangle.normals[2]);
+        std::swap(triangle.textureCoordinates[1], triangle.textureCoordinates[2]);
+    }
+
+    // Pixels whose centers may be covered, clamped to the image before converting to int
+    const auto minPosition = glm::min(glm::min(p[0], p[1]), p[2]);
+    const auto maxPosition = glm::max(glm::max(p[0], p[1]), p[2]);
+    if (maxPosition.x < 0.0f || maxPosition.y < 0.0f ||
+            minPosition.x >= this->width || minPosition.y >= this->height) return;
+
+    triangle.minX = static_cast<int>(std::max(std::floor(minPosition.x), 0.0f));
+    triangle.minY = static_cast<int>(std::max(std::floor(minPosition.y), 0.0f));
+    triangle.maxX = static_cast<int>(std::min(std::ceil(maxPosition.x), static_cast<float>(this->width - 1)));
+    triangle.maxY = static_cast<int>(std::min(std::ceil(maxPosition.y), static_cast<float>(this->height - 1)));
+    triangle.mesh = &mesh;
+
+    this->triangles.push_back(triangle);
+}
+
+void SoftwareRasterizer::rasterizeTile(size_t tile, const std::vector<std::uint32_t> &triangleIndices) {
+    const auto tileMinX = static_cast<int>(tile % this->numTilesX) * TILE_SIZE_PIXELS;
+    const auto tileMinY = static_cast<int>(tile / this->numTilesX) * TILE_SIZE_PIXELS;
+    const auto tileMaxX = std::min(tileMinX + TILE_SIZE_PIXELS, this->width) - 1;
+    const auto tileMaxY = std::min(tileMinY + TILE_SIZE_PIXELS, this->height) - 1;
+
+    for (const auto index : triangleIndices) {
+        const auto &triangle = this->triangles[index];
+        const auto minX = std::max(triangle.minX, tileMinX);
+        const auto minY = std::max(triangle.minY, tileMinY);
+        const auto maxX = std::min(triangle.maxX, tileMaxX);
+        const auto maxY = std::min(triangle.maxY, tileMaxY);
+
+        // Edge function of the edge opposite to every vertex, positive inside:
+        // e(x, y) = dx * (y - edgeY) - dy * (x - edgeX). Pixels on an edge belong to the
+        // triangle if the edge is a top or left edge, so that shared edges are drawn once.
+        const auto &p = triangle.screenPositions;
+        float edgeX[3], edgeY[3], edgeDx[3], edgeDy[3];
+        bool topLeft[3];
+        for (int i = 0; i < 3; ++i) {
+            const auto &a = p[(i + 1) % 3];
+            const auto &b = p[(i + 2) % 3];
+            edgeX[i] = a.x;
+            edgeY[i] = a.y;
+            edgeDx[i] = b.x - a.x;
+            edgeDy[i] = b.y - a.y;
+            topLeft[i] = edgeDy[i] < 0.0f || (edgeDy[i] == 0.0f && edgeDx[i] > 0.0f);
+        }
+        const auto inverseArea = 1.0f / (edgeDx[0] * (p[0].y - edgeY[0]) - edgeDy[0] * (p[0].x - edgeX[0]));
+
+        for (int y = minY; y <= maxY; ++y) {
+            const auto pixelY = static_cast<float>(y) + 0.5f;
+
+            for (int x = minX; x <= maxX; x += 4) {
+                // Edge functions and coverage of 4 pixels of the row
+                float edges[3][4];
+                unsigned int coverage = 0;
+#ifdef GE_RASTERIZER_SSE
+                const auto zero = _mm_setzero_ps();
+                const auto pixelX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f));
+                auto inside = _mm_cmplt_ps(pixelX, _mm_set1_ps(static_cast<float>(maxX + 1)));
+                for (int i = 0; i < 3; ++i) {
+                    const auto edge = _mm_sub_ps(_mm_set1_ps(edgeDx[i] * (pixelY - edgeY[i])),
+                                                 _mm_mul_ps(_mm_set1_ps(edgeDy[i]), _mm_sub_ps(pixelX, _mm_set1_ps(edgeX[i]))));
+                    inside = _mm_and_ps(inside, topLeft[i] ? _mm_cmpge_ps(edge, zero) : _mm_cmpgt_ps(edge, zero));
+                    _mm_storeu_ps(edges[i], edge);
+                }
+                coverage = static_cast<unsigned int>(_mm_movemask_ps(inside));
+#else
+                for (int lane = 0; lane < 4; ++lane) {
+                    const auto pixelX = static_cast<float>(x + lane) + 0.5f;
+                    auto inside = x + lane <= maxX;
+                    for (int i = 0; i < 3; ++i) {
+                        edges[i][lane] = edgeDx[i] * (pixelY - edgeY[i]) - edgeDy[i] * (pixelX - edgeX[i]);
+                        inside = inside && (topLeft[i] ? edges[i][lane] >= 0.0f : edges[i][lane] > 0.0f);
+                    }
+                    if (inside) coverage |= 1u << lane;
+                }
+#endif
+                if (coverage == 0) continue;
+
+                for (int lane = 0; lane < 4; ++lane) {
+                    if (!(coverage & (1u << lane))) continue;
+
+                    const glm::vec3 barycentrics = glm::vec3(edges[0][lane], edges[1][lane], edges[2][lane]) * inverseArea;
+
+                    // Window depths are affine in screen space, so they are interpolated
+                    // without perspective correction
+                    const auto depth = glm::dot(barycentrics, glm::vec3(triangle.depths[0], triangle.depths[1],
+                                                                        triangle.depths[2]));
+                    const auto pixel = static_cast<size_t>(y) * this->width + x + lane;
+                    if (depth < 0.0f || depth > 1.0f || depth >= this->depthBuffer[pixel]) continue;
+
+                    this->depthBuffer[pixel] = depth;
+                    this->colorBuffer[pixel] = this->shade(triangle, barycentrics);
+                }
+            }
+        }
+    }
+}
+
+glm::vec3 SoftwareRasterizer::shade(const Triangle &triangle, const glm::vec3 &barycentrics) const {
+    // Attributes divided by w are affine in screen space
+    const auto w = 1.0f / glm::dot(barycentrics, glm::vec3(triangle.inverseWs[0], triangle.inverseWs[1],
+                                                           triangle.inverseWs[2]));
+    const auto interpolate = [&](const auto &values){
+        return (values[0] * barycentrics.x + values[1] * barycentrics.y + values[2] * barycentrics.z) * w;
+    };
+    const auto worldPosition = interpolate(triangle.worldPositions);
+    const auto textureCoordinates = interpolate(triangle.textureCoordinates);
+    auto normal = interpolate(triangle.normals);
+    const auto normalLength = glm::length(normal);
+    normal = normalLength > 0.0f ? normal / normalLength : glm::vec3(0.0f, 0.0f, 1.0f);
+
+    // Blinn-Phong lighting of default.frag
+    const auto &mesh = *triangle.mesh;
+    const auto materialDiffuse = mesh.diffuseTexture ? sampleImage(*mesh.diffuseTexture, textureCoordinates)
+                                                     : glm::vec3(1.0f);
+
+    const auto ambient = calculateIrradiance(this->irradianceSh, normal) * materialDiffuse;
+    const auto diffuse = this->lightDiffuse * std::max(glm::dot(normal, -this->lightDirection), 0.0f) * materialDiffuse;
+
+    glm::vec3 specular(0.0f);
+    if (mesh.specularTexture) {
+        const auto viewDirection = glm::normalize(this->viewPosition - worldPosition);
+        const auto halfwayDirection = glm::normalize(-this->lightDirection + viewDirection);
+        const auto specularAngle = glm::dot(halfwayDirection, normal);
+        specular = this->lightSpecular * std::pow(std::max(specularAngle, 0.0f), mesh.specularExponent) *
+                sampleImage(*mesh.specularTexture, textureCoordinates);
+    }
+
+    return ambient + diffuse + specular;
+}
+
+} // namespace ge
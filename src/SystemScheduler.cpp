@@ -0,0 +1,91 @@
+#include <game_engine/SystemScheduler.h>
+
+#include <algorithm>
+#include <exception>
+#include <future>
+
+#include <game_engine/EntityRegistry.h>
+
+namespace ge {
+
+/// ----------------------------------------------------
+///               SystemAccess Functions
+/// ----------------------------------------------------
+bool SystemAccess::conflictsWith(const SystemAccess &other) const {
+    if (this->exclusiveAccess || other.exclusiveAccess) return true;
+
+    return (this->writes & (other.reads | other.writes)).any() ||
+            (other.writes & this->reads).any();
+}
+
+/// ----------------------------------------------------
+///              SystemScheduler Functions
+/// ----------------------------------------------------
+SystemScheduler::SystemScheduler(JobSystem &jobSystem) : jobSystem(jobSystem) {}
+
+SystemScheduler& SystemScheduler::addSystem(const std::string &name, const SystemAccess &access,
+                                            SystemFunction system) {
+    this->systems.push_back({name, access, std::move(system)});
+    this->stagesAreValid = false;
+    return *this;
+}
+
+void SystemScheduler::run(EntityRegistry &registry, std::chrono::duration<float> updateDuration) {
+    if (!this->stagesAreValid) this->buildStages();
+
+    for (const auto &stage : this->stages) {
+        // Run all but the first system of the stage on workers and the first one on this thread
+        std::vector<std::future<void>> results;
+        results.reserve(stage.size() - 1);
+        for (auto i = 1u; i < stage.size(); ++i) {
+            auto &system = this->systems[stage[i]];
+            results.push_back(this->jobSystem.submit([&system, &registry, updateDuration]{
+                system.function(registry, updateDuration);
+            }));
+        }
+
+        std::exception_ptr exception;
+        try {
+            this->systems[stage.front()].function(registry, updateDuration);
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        for (auto &result : results) {
+            try {
+                result.get();
+            } catch (...) {
+                if (!exception) exception = std::current_exception();
+            }
+        }
+
+        if (exception) std::rethrow_exception(exception);
+    }
+}
+
+size_t SystemScheduler::getNumStages() {
+    if (!this->stagesAreValid) this->buildStages();
+    return this->stages.size();
+}
+
+void SystemScheduler::buildStages() {
+    this->stages.clear();
+
+    std::vector<size_t> systemStages(this->systems.size());
+    for (size_t i = 0; i < this->systems.size(); ++i) {
+        size_t stage = 0;
+        for (size_t j = 0; j < i; ++j) {
+            if (this->systems[i].access.conflictsWith(this->systems[j].access)) {
+                stage = std::max(stage, systemStages[j] + 1);
+            }
+        }
+
+        systemStages[i] = stage;
+        if (stage == this->stages.size()) this->stages.emplace_back();
+        this->stages[stage].push_back(i);
+    }
+
+    this->stagesAreValid = true;
+}
+
+} // namespace ge
@@ -0,0 +1,177 @@
+#include <game_engine/Terrain.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/geometric.hpp>
+
+#include <game_engine/FramePacket.h>
+#include <game_engine/Frustum.h>
+
+namespace {
+
+///
+/// \brief boxIntersectsSphere Returns whether an axis-aligned box is at least partially
+///                            within a distance of a point.
+///
+bool boxIntersectsSphere(const glm::vec3 &boxMin, const glm::vec3 &boxMax,
+                         const glm::vec3 &center, float radius) {
+    const auto closestPoint = glm::clamp(center, boxMin, boxMax);
+    const auto offset = closestPoint - center;
+    return glm::dot(offset, offset) <= radius * radius;
+}
+
+} // namespace
+
+namespace ge {
+
+constexpr size_t Terrain::MAX_LODS;
+
+Terrain::Terrain(std::shared_ptr<const Heightmap> heightmap, const TerrainSettings &settings)
+    : heightmap(std::move(heightmap)), settings(settings) {
+    // Morphing halves the grid, so it needs an even resolution
+    this->settings.chunkResolution = std::max(2u, this->settings.chunkResolution & ~1u);
+    const auto chunkResolution = this->settings.chunkResolution;
+
+    // Add levels until the finest chunks have about one grid quad per heightmap texel
+    const auto width = this->heightmap->getWidth();
+    const auto height = this->heightmap->getHeight();
+    const auto numTexels = static_cast<size_t>(std::max(std::max(width, height) - 1, 1));
+    size_t numLods = 1;
+    while (numLods < MAX_LODS && (chunkResolution << (numLods - 1)) < numTexels) ++numLods;
+    this->nodeHeightRanges.resize(numLods);
+
+    // Height ranges of the finest nodes cover every texel their bilinear samples may read
+    const auto numLeavesPerSide = this->getNumNodesPerSide(0);
+    auto &leafHeightRanges = this->nodeHeightRanges[0];
+    leafHeightRanges.resize(numLeavesPerSide * numLeavesPerSide);
+    for (size_t y = 0; y < numLeavesPerSide; ++y) {
+        const auto firstRow = static_cast<int>(std::floor(float(y) / numLeavesPerSide * (height - 1)));
+        const auto lastRow = static_cast<int>(std::ceil(float(y + 1) / numLeavesPerSide * (height - 1)));
+
+        for (size_t x = 0; x < numLeavesPerSide; ++x) {
+            const auto firstColumn = static_cast<int>(std::floor(float(x) / numLeavesPerSide * (width - 1)));
+            const auto lastColumn = static_cast<int>(std::ceil(float(x + 1) / numLeavesPerSide * (width - 1)));
+
+            glm::vec2 range(1.0f, 0.0f);
+            for (auto row = firstRow; row <= lastRow; ++row) {
+                for (auto column = firstColumn; column <= lastColumn; ++column) {
+                    const auto value = this->heightmap->getValue(column, row);
+                    range.x = std::min(range.x, value);
+                    range.y = std::max(range.y, value);
+                }
+            }
+            leafHeightRanges[y * numLeavesPerSide + x] = range;
+        }
+    }
+
+    // Coarser nodes merge the ranges of their children
+    for (size_t lod = 1; lod < numLods; ++lod) {
+        const auto numNodesPerSide = this->getNumNodesPerSide(lod);
+        const auto &childHeightRanges = this->nodeHeightRanges[lod - 1];
+        auto &heightRanges = this->nodeHeightRanges[lod];
+        heightRanges.resize(numNodesPerSide * numNodesPerSide);
+
+        for (size_t y = 0; y < numNodesPerSide; ++y) {
+            for (size_t x = 0; x < numNodesPerSide; ++x) {
+                glm::vec2 range(1.0f, 0.0f);
+                for (size_t child = 0; child < 4; ++child) {
+                    const auto &childRange = childHeightRanges[(2 * y + child / 2) * 2 * numNodesPerSide +
+                                                               2 * x + child % 2];
+                    range.x = std::min(range.x, childRange.x);
+                    range.y = std::max(range.y, childRange.y);
+                }
+                heightRanges[y * numNodesPerSide + x] = range;
+            }
+        }
+    }
+
+    // Every level is used up to a distance proportional to the size of its nodes
+    auto lodDistance_m = this->settings.finestLodDistance_m;
+    if (lodDistance_m <= 0.0f) {
+        lodDistance_m = 2.0f * glm::length(this->settings.size_m / static_cast<float>(numLeavesPerSide));
+    }
+
+    this->lodDistances.resize(numLods);
+    this->morphRanges.resize(numLods);
+    auto previousLodDistance_m = 0.0f;
+    for (size_t lod = 0; lod < numLods; ++lod) {
+        this->lodDistances[lod] = lodDistance_m;
+        this->morphRanges[lod] = {glm::mix(previousLodDistance_m, lodDistance_m, this->settings.morphStartRatio),
+                                  lodDistance_m};
+
+        previousLodDistance_m = lodDistance_m;
+        lodDistance_m *= this->settings.lodDistanceRatio;
+    }
+}
+
+Terrain::Selection Terrain::selectChunks(const glm::vec3 &viewPosition, const Frustum &frustum) const {
+    Selection selection;
+
+    // Beyond the range of the coarsest level, the whole terrain is drawn at that level
+    const auto root = this->getNumLods() - 1;
+    if (!this->selectNode(root, 0, 0, viewPosition, frustum, &selection)) {
+        selection[WHOLE_CHUNK].push_back({glm::vec2(0.0f), 1.0f, static_cast<float>(root)});
+    }
+
+    return selection;
+}
+
+void Terrain::addToFramePacket(FramePacket &framePacket) const {
+    const Frustum frustum(framePacket.projectionMatrix * framePacket.viewMatrix);
+    auto selection = this->selectChunks(framePacket.viewPosition, frustum);
+
+    const auto isEmpty = std::all_of(selection.begin(), selection.end(), [](const auto &chunks){
+        return chunks.empty();
+    });
+    if (isEmpty) return;
+
+    framePacket.terrainBatches.push_back({this->shared_from_this(), std::move(selection)});
+}
+
+float Terrain::getHeight(const glm::vec2 &position) const {
+    const auto uv = (position - this->settings.origin) / this->settings.size_m;
+    return glm::mix(this->settings.minHeight_m, this->settings.maxHeight_m, this->heightmap->sample(uv.x, uv.y));
+}
+
+bool Terrain::selectNode(size_t lod, size_t x, size_t y, const glm::vec3 &viewPosition,
+                         const Frustum &frustum, Selection *selection) const {
+    glm::vec3 boxMin, boxMax;
+    this->getNodeBounds(lod, x, y, &boxMin, &boxMax);
+
+    // Invisible nodes are handled by not drawing anything
+    if (!frustum.intersects(boxMin, boxMax)) return true;
+
+    // Let the parent cover nodes out of the range of their level
+    if (!boxIntersectsSphere(boxMin, boxMax, viewPosition, this->lodDistances[lod])) return false;
+
+    const auto nodeSize = 1.0f / this->getNumNodesPerSide(lod);
+    const TerrainChunk chunk {glm::vec2(x, y) * nodeSize, nodeSize, static_cast<float>(lod)};
+
+    if (lod == 0 || !boxIntersectsSphere(boxMin, boxMax, viewPosition, this->lodDistances[lod - 1])) {
+        (*selection)[WHOLE_CHUNK].push_back(chunk);
+        return true;
+    }
+
+    // Draw the quadrants whose children are out of range at this level
+    for (size_t child = 0; child < 4; ++child) {
+        if (!this->selectNode(lod - 1, 2 * x + child % 2, 2 * y + child / 2, viewPosition, frustum, selection)) {
+            (*selection)[QUADRANT_MIN_U_MIN_V + child].push_back(chunk);
+        }
+    }
+
+    return true;
+}
+
+void Terrain::getNodeBounds(size_t lod, size_t x, size_t y, glm::vec3 *boxMin, glm::vec3 *boxMax) const {
+    const auto numNodesPerSide = this->getNumNodesPerSide(lod);
+    const auto nodeSize_m = this->settings.size_m / static_cast<float>(numNodesPerSide);
+    const auto nodeMin = this->settings.origin + glm::vec2(x, y) * nodeSize_m;
+    const auto &heightRange = this->nodeHeightRanges[lod][y * numNodesPerSide + x];
+
+    *boxMin = glm::vec3(nodeMin, glm::mix(this->settings.minHeight_m, this->settings.maxHeight_m, heightRange.x));
+    *boxMax = glm::vec3(nodeMin + nodeSize_m,
+                        glm::mix(this->settings.minHeight_m, this->settings.maxHeight_m, heightRange.y));
+}
+
+} // namespace ge
@@ -0,0 +1,200 @@
+#include <game_engine/TerrainRenderer.h>
+
+#include <string>
+
+#include <game_engine/Texture2D.h>
+
+namespace {
+
+constexpr GLint heightmapTextureUnit = 1;
+
+} // namespace
+
+namespace ge {
+
+TerrainRenderer::TerrainRenderer(const std::string &vertexShaderPath, const std::string &fragmentShaderPath)
+    : shader(std::make_unique<ShaderProgram>(vertexShaderPath, fragmentShaderPath)) {
+    glGenBuffers(1, &this->instanceBuffer);
+}
+
+TerrainRenderer::~TerrainRenderer() {
+    for (const auto &heightmapTexture : this->heightmapTextures) {
+        glDeleteTextures(1, &heightmapTexture.second.texture);
+    }
+
+    for (const auto &grid : this->grids) {
+        glDeleteBuffers(1, &grid.second.indexBuffer);
+        glDeleteBuffers(1, &grid.second.vertexBuffer);
+        glDeleteVertexArrays(1, &grid.second.vao);
+    }
+
+    glDeleteBuffers(1, &this->instanceBuffer);
+}
+
+void TerrainRenderer::render(const FramePacket &framePacket) {
+    this->deleteExpiredHeightmapTextures();
+    if (framePacket.terrainBatches.empty()) return;
+
+    const auto &light = framePacket.directionalLight;
+    this->shader->use();
+    this->shader->setUniform("heightmap", heightmapTextureUnit)
+            .setUniform("terrainTexture", 0)
+            .setUniform("viewPosition", framePacket.viewPosition)
+            .setUniform("directionalLight.direction", light.direction)
+            .setUniform("directionalLight.lighting.ambient", light.ambient)
+            .setUniform("directionalLight.lighting.diffuse", light.diffuse);
+
+    for (const auto &terrainBatch : framePacket.terrainBatches) {
+        const auto &terrain = *terrainBatch.terrain;
+        const auto &settings = terrain.getSettings();
+        const auto &grid = this->getGrid(settings.chunkResolution);
+
+        glActiveTexture(GL_TEXTURE0 + heightmapTextureUnit);
+        glBindTexture(GL_TEXTURE_2D, this->getHeightmapTexture(terrain.getHeightmap()));
+        glActiveTexture(GL_TEXTURE0);
+
+        this->shader->setUniform("terrainOrigin", settings.origin)
+                .setUniform("terrainSize", settings.size_m)
+                .setUniform("heightRange", glm::vec2(settings.minHeight_m, settings.maxHeight_m))
+                .setUniform("chunkResolution", static_cast<float>(settings.chunkResolution))
+                .setUniform("hasTexture", settings.texture != nullptr);
+
+        const auto &morphRanges = terrain.getMorphRanges();
+        for (size_t i = 0; i < morphRanges.size(); ++i) {
+            this->shader->setUniform("morphRanges[" + std::to_string(i) + "]", morphRanges[i]);
+        }
+
+        if (settings.texture) {
+            settings.texture->bind();
+            this->shader->setUniform("uvTransform", settings.texture->getUvTransform())
+                    .setUniform("textureLayer", static_cast<float>(settings.texture->getLayer()))
+                    .setUniform("numTextureRepeat", settings.numTextureRepeat);
+        }
+
+        // Upload the chunks of all parts at once, orphaning the previous ones
+        size_t numChunks = 0;
+        for (const auto &chunks : terrainBatch.chunks) numChunks += chunks.size();
+
+        glBindVertexArray(grid.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, this->instanceBuffer);
+        glBufferData(GL_ARRAY_BUFFER, numChunks * sizeof(TerrainChunk), nullptr, GL_STREAM_DRAW);
+
+        size_t firstChunk = 0;
+        for (size_t part = 0; part < Terrain::NUM_CHUNK_PARTS; ++part) {
+            const auto &chunks = terrainBatch.chunks[part];
+            if (chunks.empty()) continue;
+
+            const auto offset_bytes = firstChunk * sizeof(TerrainChunk);
+            glBufferSubData(GL_ARRAY_BUFFER, offset_bytes, chunks.size() * sizeof(TerrainChunk), chunks.data());
+            glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(TerrainChunk),
+                                  reinterpret_cast<GLvoid*>(offset_bytes));
+
+            // Whole chunks draw all four quadrants, which are stored consecutively
+            const auto firstQuadrant = part == Terrain::WHOLE_CHUNK ? 0 : part - Terrain::QUADRANT_MIN_U_MIN_V;
+            const auto numQuadrants = part == Terrain::WHOLE_CHUNK ? 4 : 1;
+            glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(numQuadrants * grid.numIndicesPerQuadrant),
+                                    GL_UNSIGNED_INT,
+                                    reinterpret_cast<GLvoid*>(firstQuadrant * grid.numIndicesPerQuadrant *
+                                                              sizeof(GLuint)),
+                                    static_cast<GLsizei>(chunks.size()));
+
+            firstChunk += chunks.size();
+        }
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+const TerrainRenderer::Grid& TerrainRenderer::getGrid(unsigned int resolution) {
+    auto grid = this->grids.find(resolution);
+    if (grid != this->grids.end()) return grid->second;
+
+    std::vector<float> vertices;
+    vertices.reserve(2 * (resolution + 1) * (resolution + 1));
+    for (auto y = 0u; y <= resolution; ++y) {
+        for (auto x = 0u; x <= resolution; ++x) {
+            vertices.push_back(static_cast<float>(x) / resolution);
+            vertices.push_back(static_cast<float>(y) / resolution);
+        }
+    }
+
+    // Two triangles per quad, one quadrant after the other
+    const auto halfResolution = resolution / 2;
+    std::vector<GLuint> indices;
+    indices.reserve(6 * resolution * resolution);
+    for (auto quadrant = 0u; quadrant < 4; ++quadrant) {
+        const auto firstX = quadrant % 2 * halfResolution;
+        const auto firstY = quadrant / 2 * halfResolution;
+
+        for (auto y = firstY; y < firstY + halfResolution; ++y) {
+            for (auto x = firstX; x < firstX + halfResolution; ++x) {
+                const auto corner = y * (resolution + 1) + x;
+                indices.insert(indices.end(), {corner, corner + 1, corner + resolution + 2,
+                                               corner, corner + resolution + 2, corner + resolution + 1});
+            }
+        }
+    }
+
+    Grid newGrid;
+    newGrid.numIndicesPerQuadrant = static_cast<unsigned int>(indices.size() / 4);
+
+    glGenVertexArrays(1, &newGrid.vao);
+    glBindVertexArray(newGrid.vao);
+
+    glGenBuffers(1, &newGrid.vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, newGrid.vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+
+    glGenBuffers(1, &newGrid.indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, newGrid.indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+    // The chunk attribute points into the instance buffer when drawing
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return this->grids.emplace(resolution, newGrid).first->second;
+}
+
+unsigned int TerrainRenderer::getHeightmapTexture(const std::shared_ptr<const Heightmap> &heightmap) {
+    auto &heightmapTexture = this->heightmapTextures[heightmap.get()];
+
+    // A new heightmap may reuse the address of a destroyed one
+    if (heightmapTexture.texture != 0 && heightmapTexture.heightmap.lock() == heightmap) {
+        return heightmapTexture.texture;
+    }
+
+    if (heightmapTexture.texture == 0) glGenTextures(1, &heightmapTexture.texture);
+    heightmapTexture.heightmap = heightmap;
+
+    glBindTexture(GL_TEXTURE_2D, heightmapTexture.texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R16, heightmap->getWidth(), heightmap->getHeight(), 0,
+                 GL_RED, GL_UNSIGNED_SHORT, heightmap->getData());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    return heightmapTexture.texture;
+}
+
+void TerrainRenderer::deleteExpiredHeightmapTextures() {
+    for (auto heightmapTexture = this->heightmapTextures.begin(); heightmapTexture != this->heightmapTextures.end();) {
+        if (heightmapTexture->second.heightmap.expired()) {
+            glDeleteTextures(1, &heightmapTexture->second.texture);
+            heightmapTexture = this->heightmapTextures.erase(heightmapTexture);
+        } else {
+            ++heightmapTexture;
+        }
+    }
+}
+
+} // namespace ge
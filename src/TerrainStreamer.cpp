@@ -0,0 +1,130 @@
+#include <game_engine/TerrainStreamer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <game_engine/JobSystem.h>
+
+namespace {
+
+void replaceAll(std::string &string, const std::string &pattern, const std::string &replacement) {
+    for (auto position = string.find(pattern); position != std::string::npos;
+         position = string.find(pattern, position + replacement.size())) {
+        string.replace(position, pattern.size(), replacement);
+    }
+}
+
+} // namespace
+
+namespace ge {
+
+TerrainStreamer::TerrainStreamer(TileLoader tileLoader, const glm::vec2 &tileSize_m, float loadDistance_m,
+                                 float unloadDistance_m)
+    : tileLoader(std::move(tileLoader)), tileSize_m(tileSize_m), loadDistance_m(loadDistance_m),
+      unloadDistance_m(std::max(unloadDistance_m, loadDistance_m)) {}
+
+TerrainStreamer::~TerrainStreamer() {
+    // Loads refer to the tile loader
+    for (const auto &pendingTile : this->pendingTiles) {
+        pendingTile.second.wait();
+    }
+}
+
+TerrainStreamer::TileLoader TerrainStreamer::fileTileLoader(const std::string &filepathPattern,
+                                                            const TerrainSettings &settings) {
+    return [filepathPattern, settings](int x, int y) -> std::shared_ptr<Terrain> {
+        auto filepath = filepathPattern;
+        replaceAll(filepath, "{x}", std::to_string(x));
+        replaceAll(filepath, "{y}", std::to_string(y));
+        if (!std::ifstream(filepath)) return nullptr;
+
+        auto tileSettings = settings;
+        tileSettings.origin = glm::vec2(x, y) * settings.size_m;
+        return std::make_shared<Terrain>(std::make_shared<Heightmap>(filepath), tileSettings);
+    };
+}
+
+void TerrainStreamer::update(const glm::vec3 &viewPosition) {
+    const glm::vec2 position(viewPosition);
+
+    // Take over the finished loads
+    for (auto pendingTile = this->pendingTiles.begin(); pendingTile != this->pendingTiles.end();) {
+        if (pendingTile->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++pendingTile;
+            continue;
+        }
+
+        std::shared_ptr<Terrain> terrain;
+        try {
+            terrain = pendingTile->second.get();
+        } catch (const std::exception &exception) {
+            std::cerr << "Failed to load terrain tile (" << pendingTile->first.first << ", "
+                      << pendingTile->first.second << "): " << exception.what() << "\n";
+        }
+
+        this->loadedTiles[pendingTile->first] = std::move(terrain);
+        pendingTile = this->pendingTiles.erase(pendingTile);
+    }
+
+    // Drop the tiles out of range
+    for (auto loadedTile = this->loadedTiles.begin(); loadedTile != this->loadedTiles.end();) {
+        if (this->getDistance(loadedTile->first, position) > this->unloadDistance_m) {
+            loadedTile = this->loadedTiles.erase(loadedTile);
+        } else {
+            ++loadedTile;
+        }
+    }
+
+    // Load the missing tiles in range, closest first
+    const auto minTile = glm::floor((position - this->loadDistance_m) / this->tileSize_m);
+    const auto maxTile = glm::floor((position + this->loadDistance_m) / this->tileSize_m);
+    std::vector<std::pair<float, TileCoordinates>> missingTiles;
+    for (auto y = static_cast<int>(minTile.y); y <= static_cast<int>(maxTile.y); ++y) {
+        for (auto x = static_cast<int>(minTile.x); x <= static_cast<int>(maxTile.x); ++x) {
+            const TileCoordinates tile(x, y);
+            const auto distance_m = this->getDistance(tile, position);
+            if (distance_m <= this->loadDistance_m && !this->loadedTiles.count(tile) &&
+                    !this->pendingTiles.count(tile)) {
+                missingTiles.emplace_back(distance_m, tile);
+            }
+        }
+    }
+    std::sort(missingTiles.begin(), missingTiles.end());
+
+    auto &jobSystem = JobSystem::getInstance();
+    for (const auto &missingTile : missingTiles) {
+        if (this->pendingTiles.size() >= this->maxNumPendingLoads) break;
+
+        const auto tile = missingTile.second;
+        this->pendingTiles.emplace(tile, jobSystem.submit([this, tile]{
+            return this->tileLoader(tile.first, tile.second);
+        }));
+    }
+}
+
+void TerrainStreamer::addToFramePacket(FramePacket &framePacket) const {
+    for (const auto &loadedTile : this->loadedTiles) {
+        if (loadedTile.second) loadedTile.second->addToFramePacket(framePacket);
+    }
+}
+
+std::shared_ptr<const Terrain> TerrainStreamer::findTerrain(const glm::vec2 &position) const {
+    const auto tile = glm::floor(position / this->tileSize_m);
+    const auto loadedTile = this->loadedTiles.find({static_cast<int>(tile.x), static_cast<int>(tile.y)});
+    return loadedTile != this->loadedTiles.end() ? loadedTile->second : nullptr;
+}
+
+float TerrainStreamer::getDistance(const TileCoordinates &tile, const glm::vec2 &position) const {
+    const auto tileMin = glm::vec2(tile.first, tile.second) * this->tileSize_m;
+    return glm::distance(glm::clamp(position, tileMin, tileMin + this->tileSize_m), position);
+}
+
+} // namespace ge
@@ -1,6 +1,7 @@
 #include <game_engine/Texture2D.h>
 
-#include <unordered_map>
+#include <algorithm>
+#include <vector>
 
 #include <glad/glad.h>
 
@@ -8,35 +9,83 @@
 #include <stb_image.h>
 
 #include <game_engine/Exception.h>
-#include <iostream>
+#include <game_engine/ResourceManager.h>
+#include <game_engine/TextureAtlas.h>
 
 namespace {
 
-std::unordered_map<std::string, std::weak_ptr<unsigned int>> cachedTextureIds;
+struct LoadedTexture {
+    std::shared_ptr<const ge::TextureArray::Layer> layer;
+    glm::vec4 uvTransform;
+    bool atlased;
+    int width;
+    int height;
+};
 
 ///
-/// \brief loadTexture Loads and caches texture data from image file.
-/// \param imageFilepath Filepath to the image.
-/// \return OpenGL's texture ID for the loaded texture.
+/// \brief The DecodedImage struct holds an image decoded by ge::Texture2D::decode().
+///
+struct DecodedImage {
+    std::unique_ptr<unsigned char, void(*)(void*)> data {nullptr, stbi_image_free};
+    int width = 0;
+    int height = 0;
+    int numChannels = 0;
+};
+
+///
+/// \brief decodeImage Decodes an image file.
 /// \exception ge::LoadError Failed to load image data from file.
 ///
-std::shared_ptr<unsigned int> loadTexture(const std::string &imageFilepath) {
-    const auto imageFilename = imageFilepath.substr(imageFilepath.find_last_of('/') + 1);
+std::shared_ptr<const DecodedImage> decodeImage(const std::string &imageFilepath) {
+    auto image = std::make_shared<DecodedImage>();
+    image->data.reset(stbi_load(imageFilepath.c_str(), &image->width, &image->height, &image->numChannels, 0));
+
+    if (!image->data) {
+        throw ge::LoadError("Failed to load texture at: " + imageFilepath);
+    }
 
-    // Check cache to avoid reloading
-    auto textureId = cachedTextureIds[imageFilename].lock();
-    if (textureId) return textureId;
+    return image;
+}
 
-    // Load image from file
-    int width, height, numChannels;
-    auto data = stbi_load(imageFilepath.c_str(), &width, &height, &numChannels, 0);
+///
+/// \brief getGpuSize Returns an estimate of the GPU memory taken by a texture.
+///
+size_t getGpuSize(int width, int height) {
+    // RGBA8 with mipmaps, or packed into an atlas page without its own mipmaps
+    return static_cast<size_t>(width) * height * 4 * 4 / 3;
+}
 
-    if (!data) {
-        stbi_image_free(data);
-        throw ge::LoadError("Failed to load texture at: " + imageFilepath);
+///
+/// \brief toRgba Expands image data to 4 channels the same way OpenGL expands
+///               the formats picked by createTexture() when sampling.
+///
+std::vector<unsigned char> toRgba(const unsigned char *data, int width, int height, int numChannels) {
+    const auto numPixels = static_cast<size_t>(width) * height;
+    std::vector<unsigned char> rgba(numPixels * 4);
+
+    for (size_t i = 0; i < numPixels; ++i) {
+        const auto pixel = data + i * numChannels;
+        rgba[i * 4 + 0] = pixel[0];
+        rgba[i * 4 + 1] = numChannels >= 3 ? pixel[1] : 0;
+        rgba[i * 4 + 2] = numChannels >= 3 ? pixel[2] : 0;
+        rgba[i * 4 + 3] = numChannels == 4 ? pixel[3] : 255;
     }
 
+    return rgba;
+}
+
+///
+/// \brief uploadTexture Uploads image data into a texture array layer and generates
+///                      its mipmaps.
+/// \param data Image data, first row first.
+/// \param width Image width in pixels.
+/// \param height Image height in pixels.
+/// \param numChannels Number of 8 bit channels per pixel.
+///
+void uploadTexture(const ge::TextureArray::Layer &layer, const unsigned char *data,
+                   int width, int height, int numChannels) {
     GLenum format;
+    std::vector<unsigned char> rgbaData;
     switch (numChannels) {
     case 1:
         format = GL_RED;
@@ -51,49 +100,151 @@ std::shared_ptr<unsigned int> loadTexture(const std::string &imageFilepath) {
         break;
 
     default:
-        format = GL_RGB;
+        rgbaData = toRgba(data, width, height, numChannels);
+        data = rgbaData.data();
+        format = GL_RGBA;
         break;
     }
 
-    // Clean up texture data on GPU and clear cache
-    auto textureIdDeleter = [imageFilename](auto textureId) {
-        glDeleteTextures(1, textureId);
+    layer.array->subImage(layer.index, 0, 0, 0, width, height, format, data);
+    layer.array->generateMipmap(layer.index);
+}
 
-        cachedTextureIds.erase(imageFilename);
-        delete textureId;
-    };
-    textureId = std::shared_ptr<unsigned int>(new unsigned int, textureIdDeleter);
+///
+/// \brief createTexture Uploads image data into the shared atlas or, for larger
+///                      textures, into a layer of a texture array.
+/// \param data Image data, first row first.
+/// \param width Image width in pixels.
+/// \param height Image height in pixels.
+/// \param numChannels Number of 8 bit channels per pixel.
+/// \return Texture array layer and UV transform of the texture.
+///
+LoadedTexture createTexture(const unsigned char *data, int width, int height, int numChannels) {
+    // Pack small textures into the shared atlas
+    auto &atlas = ge::TextureAtlas::getInstance();
+    if (ge::TextureAtlas::enabled && atlas.canPack(width, height)) {
+        auto region = atlas.pack(toRgba(data, width, height, numChannels).data(), width, height);
+        return {std::move(region.page), region.uvTransform, true, width, height};
+    }
+
+    GLenum internalFormat;
+    switch (numChannels) {
+    case 1:
+        internalFormat = GL_R8;
+        break;
+
+    case 3:
+        internalFormat = GL_RGB8;
+        break;
+
+    default:
+        internalFormat = GL_RGBA8;
+        break;
+    }
+
+    int numMipLevels = 1;
+    while ((std::max(width, height) >> numMipLevels) > 0) {
+        ++numMipLevels;
+    }
 
     // Load texture data onto GPU
-    glGenTextures(1, textureId.get());
-    glBindTexture(GL_TEXTURE_2D, *textureId);
+    auto layer = ge::TextureArray::allocateLayer({width, height, internalFormat, numMipLevels});
+    uploadTexture(*layer, data, width, height, numChannels);
 
-    glTexImage2D(GL_TEXTURE_2D,
-                 0, static_cast<GLint>(format), width, height, 0,
-                 format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    return {std::move(layer), glm::vec4(1.0f, 1.0f, 0.0f, 0.0f), false, width, height};
+}
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+///
+/// \brief updateTexture Uploads new image data for a loaded texture.
+/// \exception ge::LoadError The image does not have the size of the texture.
+///
+void updateTexture(const LoadedTexture &texture, const unsigned char *data, int width, int height, int numChannels,
+                   const std::string &imageFilepath) {
+    if (width != texture.width || height != texture.height) {
+        throw ge::LoadError("Texture at " + imageFilepath + " changed size, restart to load it");
+    }
 
-    cachedTextureIds[imageFilename] = textureId;
+    if (texture.atlased) {
+        ge::TextureAtlas::getInstance().update({texture.layer, texture.uvTransform},
+                                               toRgba(data, width, height, numChannels).data(), width, height);
+    } else {
+        uploadTexture(*texture.layer, data, width, height, numChannels);
+    }
+}
 
-    glBindTexture(GL_TEXTURE_2D, 0);
-    stbi_image_free(data);
-    return textureId;
+///
+/// \brief loadTexture Loads and caches texture data from image file.
+/// \param imageFilepath Filepath to the image.
+/// \return Texture array layer and UV transform of the loaded texture.
+/// \exception ge::LoadError Failed to load image data from file.
+///
+std::shared_ptr<const LoadedTexture> loadTexture(const std::string &imageFilepath) {
+    auto resourceManager = ge::ResourceManager::getInstance();
+    const auto key = ge::ResourceManager::getKey(imageFilepath);
+
+    return resourceManager->load<const LoadedTexture>(ge::ResourceManager::TEXTURE, key, [&]{
+        // Use the image if it was already decoded
+        auto image = resourceManager->find<const DecodedImage>(ge::ResourceManager::DECODED_IMAGE, key);
+        if (!image) image = decodeImage(imageFilepath);
+
+        auto texture = std::make_shared<const LoadedTexture>(
+                    createTexture(image->data.get(), image->width, image->height, image->numChannels));
+        return ge::ResourceManager::Loaded<const LoadedTexture> {texture, getGpuSize(image->width, image->height),
+                                                                 {imageFilepath}};
+    });
 }
 
 } // namespace
 
 namespace ge {
 
-Texture2D::Texture2D(const std::string &imageFilepath)
-    : id(loadTexture(imageFilepath)) {}
+Texture2D::Texture2D(const std::string &imageFilepath) {
+    auto texture = loadTexture(imageFilepath);
+    this->layer = std::shared_ptr<const TextureArray::Layer>(texture, texture->layer.get());
+    this->uvTransform = texture->uvTransform;
+    this->atlased = texture->atlased;
+}
+
+Texture2D::Texture2D(const unsigned char *rgbaData, int width, int height) {
+    auto texture = createTexture(rgbaData, width, height, 4);
+    this->layer = std::move(texture.layer);
+    this->uvTransform = texture.uvTransform;
+    this->atlased = texture.atlased;
+}
+
+std::shared_ptr<const void> Texture2D::decode(const std::string &imageFilepath, size_t *gpuSize_bytes) {
+    auto resourceManager = ResourceManager::getInstance();
+    const auto key = ResourceManager::getKey(imageFilepath);
+    if (gpuSize_bytes) *gpuSize_bytes = 0;
+
+    if (resourceManager->isResident(ResourceManager::TEXTURE, key)) return nullptr;
+
+    auto image = resourceManager->load<const DecodedImage>(ResourceManager::DECODED_IMAGE, key, [&]{
+        auto image = decodeImage(imageFilepath);
+        const auto size_bytes = static_cast<size_t>(image->width) * image->height * image->numChannels;
+        return ResourceManager::Loaded<const DecodedImage> {std::move(image), size_bytes, {imageFilepath}};
+    });
+
+    if (gpuSize_bytes) *gpuSize_bytes = getGpuSize(image->width, image->height);
+    return image;
+}
+
+std::function<void()> Texture2D::prepareReload(const std::string &filepath) {
+    auto resourceManager = ResourceManager::getInstance();
+    if (!resourceManager->isLoadedFrom(ResourceManager::TEXTURE, filepath)) return nullptr;
+
+    std::shared_ptr<const DecodedImage> image = decodeImage(filepath);
+
+    return [resourceManager, image, filepath]() {
+        for (const auto &texture : resourceManager->findLoadedFrom<const LoadedTexture>(ResourceManager::TEXTURE,
+                                                                                       filepath)) {
+            updateTexture(*texture, image->data.get(), image->width, image->height, image->numChannels, filepath);
+        }
+    };
+}
 
-void Texture2D::bind() {
-    glBindTexture(GL_TEXTURE_2D, *this->id);
+void Texture2D::bind() const {
+    this->layer->array->bind();
 }
 
 } // namespace ge
@@ -0,0 +1,254 @@
+#include <game_engine/TextureArray.h>
+
+#include <algorithm>
+#include <mutex>
+
+#include <glad/glad.h>
+
+namespace {
+
+/// Guards textureArrays and the free layers of every array, since layers are
+/// released on whichever thread drops the last reference to them.
+std::mutex textureArraysMutex;
+std::vector<std::weak_ptr<ge::TextureArray>> textureArrays;
+
+size_t getBytesPerPixel(unsigned int internalFormat) {
+    switch (internalFormat) {
+    case GL_R8:
+        return 1;
+
+    case GL_RG8:
+        return 2;
+
+    case GL_RGB8:
+        return 3;
+
+    default:
+        return 4;
+    }
+}
+
+///
+/// \brief getMaxNumLayers Returns the number of layers an array of a format may grow to.
+///
+int getMaxNumLayers(const ge::TextureArray::Format &format) {
+    // Mip levels add up to a third of the base level
+    const auto layerSize_bytes = static_cast<size_t>(format.width) * format.height *
+            getBytesPerPixel(format.internalFormat) * 4 / 3;
+    return std::max(1, std::min(ge::TextureArray::maxNumLayers,
+                                static_cast<int>(ge::TextureArray::maxArraySize_bytes / layerSize_bytes)));
+}
+
+///
+/// \brief createArrayTexture Creates a texture array with storage for all layers and
+///                           mip levels, which repeats and is sampled with trilinear
+///                           filtering.
+///
+GLuint createArrayTexture(const ge::TextureArray::Format &format, int numLayers) {
+    GLuint id;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, id);
+
+    for (int level = 0; level < format.numMipLevels; ++level) {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, level, static_cast<GLint>(format.internalFormat),
+                     std::max(1, format.width >> level), std::max(1, format.height >> level), numLayers,
+                     0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, format.numMipLevels - 1);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    return id;
+}
+
+///
+/// \brief The LayerBlitter class copies mip levels of texture array layers with
+/// framebuffer blits, which OpenGL 3.3 provides unlike glCopyImageSubData().
+///
+/// The framebuffer bindings are restored when the blitter is destroyed.
+///
+class LayerBlitter {
+public:
+    LayerBlitter() {
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &this->previousReadFramebuffer);
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &this->previousDrawFramebuffer);
+        glGenFramebuffers(1, &this->readFramebuffer);
+        glGenFramebuffers(1, &this->drawFramebuffer);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, this->readFramebuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, this->drawFramebuffer);
+    }
+
+    ~LayerBlitter() {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<GLuint>(this->previousReadFramebuffer));
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(this->previousDrawFramebuffer));
+        glDeleteFramebuffers(1, &this->readFramebuffer);
+        glDeleteFramebuffers(1, &this->drawFramebuffer);
+    }
+
+    LayerBlitter(const LayerBlitter &) = delete;
+    LayerBlitter(LayerBlitter &&) = delete;
+    LayerBlitter& operator=(const LayerBlitter &) = delete;
+    LayerBlitter& operator=(LayerBlitter &&) = delete;
+
+    ///
+    /// \brief blit Copies a mip level of a layer into a mip level of another layer,
+    ///             scaling it to the size of the destination.
+    /// \param filter GL_NEAREST for exact copies, GL_LINEAR for downsampling.
+    ///
+    void blit(GLuint sourceTexture, int sourceLayer, int sourceLevel, int sourceWidth, int sourceHeight,
+              GLuint destinationTexture, int destinationLayer, int destinationLevel,
+              int destinationWidth, int destinationHeight, GLenum filter) {
+        glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, sourceTexture,
+                                  sourceLevel, sourceLayer);
+        glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, destinationTexture,
+                                  destinationLevel, destinationLayer);
+        glBlitFramebuffer(0, 0, sourceWidth, sourceHeight, 0, 0, destinationWidth, destinationHeight,
+                          GL_COLOR_BUFFER_BIT, filter);
+    }
+
+private:
+    GLint previousReadFramebuffer = 0;
+    GLint previousDrawFramebuffer = 0;
+    GLuint readFramebuffer = 0;
+    GLuint drawFramebuffer = 0;
+};
+
+} // namespace
+
+namespace ge {
+
+size_t TextureArray::maxArraySize_bytes = 64 * 1024 * 1024;
+int TextureArray::maxNumLayers = 64;
+
+bool TextureArray::Format::operator==(const Format &other) const {
+    return this->width == other.width && this->height == other.height &&
+            this->internalFormat == other.internalFormat && this->numMipLevels == other.numMipLevels;
+}
+
+std::shared_ptr<const TextureArray::Layer> TextureArray::allocateLayer(const Format &format) {
+    std::lock_guard<std::mutex> lock(textureArraysMutex);
+
+    // Drop arrays whose layers were all released
+    textureArrays.erase(std::remove_if(textureArrays.begin(), textureArrays.end(),
+                                       [](const auto &array){return array.expired();}),
+                        textureArrays.end());
+
+    // Prefer an array with a free layer, then an array that may still grow
+    const auto maxNumLayersOfFormat = getMaxNumLayers(format);
+    std::shared_ptr<TextureArray> array;
+    for (const auto &candidate : textureArrays) {
+        // Arrays may still expire, as their last layer is deleted outside of the lock
+        auto lockedCandidate = candidate.lock();
+        if (!lockedCandidate || !(lockedCandidate->getFormat() == format)) continue;
+
+        if (!lockedCandidate->freeLayerIndices.empty()) {
+            array = std::move(lockedCandidate);
+            break;
+        }
+
+        if (!array && lockedCandidate->getNumLayers() < maxNumLayersOfFormat) {
+            array = std::move(lockedCandidate);
+        }
+    }
+
+    if (!array) {
+        array = std::make_shared<TextureArray>(format, 1);
+        textureArrays.push_back(array);
+    } else if (array->freeLayerIndices.empty()) {
+        array->resize(std::min(maxNumLayersOfFormat, 2 * array->getNumLayers()));
+    }
+
+    auto layerDeleter = [](const Layer *layer) {
+        {
+            std::lock_guard<std::mutex> lock(textureArraysMutex);
+            layer->array->releaseLayerIndex(layer->index);
+        }
+        delete layer;
+    };
+    const auto index = array->allocateLayerIndex();
+    return std::shared_ptr<const Layer>(new Layer{std::move(array), index}, layerDeleter);
+}
+
+TextureArray::TextureArray(const Format &format, int numLayers)
+    : format(format), numLayers(numLayers) {
+    this->freeLayerIndices.reserve(static_cast<size_t>(numLayers));
+    for (int i = numLayers - 1; i >= 0; --i) {
+        this->freeLayerIndices.push_back(i);
+    }
+
+    this->id = createArrayTexture(format, numLayers);
+}
+
+TextureArray::~TextureArray() {
+    glDeleteTextures(1, &this->id);
+}
+
+void TextureArray::subImage(int layer, int level, int x, int y, int width, int height,
+                            unsigned int format, const void *data) {
+    glBindTexture(GL_TEXTURE_2D_ARRAY, this->id);
+
+    // Rows of tightly packed RGB or single channel images are not 4 byte aligned
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, x, y, layer, width, height, 1,
+                    format, GL_UNSIGNED_BYTE, data);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void TextureArray::generateMipmap(int layer) {
+    LayerBlitter blitter;
+    for (int level = 1; level < this->format.numMipLevels; ++level) {
+        blitter.blit(this->id, layer, level - 1,
+                     std::max(1, this->format.width >> (level - 1)), std::max(1, this->format.height >> (level - 1)),
+                     this->id, layer, level,
+                     std::max(1, this->format.width >> level), std::max(1, this->format.height >> level),
+                     GL_LINEAR);
+    }
+}
+
+void TextureArray::bind() const {
+    glBindTexture(GL_TEXTURE_2D_ARRAY, this->id);
+}
+
+void TextureArray::resize(int newNumLayers) {
+    const auto newId = createArrayTexture(this->format, newNumLayers);
+
+    // Layers keep their index, so copy every level of every layer in place
+    {
+        LayerBlitter blitter;
+        for (int level = 0; level < this->format.numMipLevels; ++level) {
+            const auto width = std::max(1, this->format.width >> level);
+            const auto height = std::max(1, this->format.height >> level);
+            for (int layer = 0; layer < this->numLayers; ++layer) {
+                blitter.blit(this->id, layer, level, width, height, newId, layer, level, width, height, GL_NEAREST);
+            }
+        }
+    }
+
+    glDeleteTextures(1, &this->id);
+    this->id = newId;
+
+    // The array was full, so the new layers are the only free ones
+    for (int i = newNumLayers - 1; i >= this->numLayers; --i) {
+        this->freeLayerIndices.push_back(i);
+    }
+    this->numLayers = newNumLayers;
+}
+
+int TextureArray::allocateLayerIndex() {
+    const auto index = this->freeLayerIndices.back();
+    this->freeLayerIndices.pop_back();
+    return index;
+}
+
+void TextureArray::releaseLayerIndex(int index) {
+    this->freeLayerIndices.push_back(index);
+}
+
+} // namespace ge
@@ -0,0 +1,200 @@
+#include <game_engine/TextureAtlas.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include <glad/glad.h>
+
+#define STB_RECT_PACK_IMPLEMENTATION
+#include <stb_rect_pack.h>
+
+#include <game_engine/Exception.h>
+
+namespace {
+
+constexpr int numChannels = 4;
+
+int roundUp(int value, int multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+int floorLog2(int powerOfTwo) {
+    int result = 0;
+    while (powerOfTwo > 1) {
+        powerOfTwo >>= 1;
+        ++result;
+    }
+    return result;
+}
+
+///
+/// \brief wrapPad Copies a texture into a larger image, filling the border with
+///                texels wrapped around from the opposite edges.
+///
+std::vector<unsigned char> wrapPad(const unsigned char *rgbaData, int width, int height,
+                                   int padding, int paddedWidth, int paddedHeight) {
+    std::vector<unsigned char> padded(static_cast<size_t>(paddedWidth) * paddedHeight * numChannels);
+
+    for (int y = 0; y < paddedHeight; ++y) {
+        const auto srcY = ((y - padding) % height + height) % height;
+
+        for (int x = 0; x < paddedWidth; ++x) {
+            const auto srcX = ((x - padding) % width + width) % width;
+
+            std::copy_n(rgbaData + (static_cast<size_t>(srcY) * width + srcX) * numChannels, numChannels,
+                        padded.data() + (static_cast<size_t>(y) * paddedWidth + x) * numChannels);
+        }
+    }
+
+    return padded;
+}
+
+///
+/// \brief downsample Halves the size of an image with a 2x2 box filter.
+///
+std::vector<unsigned char> downsample(const std::vector<unsigned char> &image, int width, int height) {
+    const auto halfWidth = width / 2;
+    const auto halfHeight = height / 2;
+    std::vector<unsigned char> result(static_cast<size_t>(halfWidth) * halfHeight * numChannels);
+
+    for (int y = 0; y < halfHeight; ++y) {
+        for (int x = 0; x < halfWidth; ++x) {
+            for (int c = 0; c < numChannels; ++c) {
+                auto texel = [&](int dx, int dy) {
+                    return static_cast<unsigned int>(
+                                image[(static_cast<size_t>(2 * y + dy) * width + 2 * x + dx) * numChannels + c]);
+                };
+
+                result[(static_cast<size_t>(y) * halfWidth + x) * numChannels + c] =
+                        static_cast<unsigned char>((texel(0, 0) + texel(1, 0) + texel(0, 1) + texel(1, 1) + 2) / 4);
+            }
+        }
+    }
+
+    return result;
+}
+
+} // namespace
+
+namespace ge {
+
+bool TextureAtlas::enabled = true;
+int TextureAtlas::maxTextureSize = 256;
+int TextureAtlas::defaultPageSize = 2048;
+int TextureAtlas::defaultPadding = 8;
+
+struct TextureAtlas::Page {
+    std::weak_ptr<const TextureArray::Layer> layer;
+    stbrp_context context;
+    std::vector<stbrp_node> nodes;
+};
+
+TextureAtlas& TextureAtlas::getInstance() {
+    static TextureAtlas atlas(defaultPageSize, defaultPadding);
+    return atlas;
+}
+
+TextureAtlas::TextureAtlas(int pageSize, int padding)
+    : pageSize(pageSize), padding(padding), numMipLevels(floorLog2(padding) + 1) {
+    if (padding < 1 || (padding & (padding - 1)) != 0) {
+        throw Error("Texture atlas padding must be a power of 2.");
+    }
+}
+
+TextureAtlas::~TextureAtlas() = default;
+
+bool TextureAtlas::canPack(int width, int height) const {
+    return width > 0 && height > 0 &&
+            width <= maxTextureSize && height <= maxTextureSize &&
+            roundUp(width + 2 * this->padding, this->padding) <= this->pageSize &&
+            roundUp(height + 2 * this->padding, this->padding) <= this->pageSize;
+}
+
+TextureAtlas::Region TextureAtlas::pack(const unsigned char *rgbaData, int width, int height) {
+    // Sizes are multiples of the padding so that every packed position stays
+    // texel aligned down to the smallest mip level.
+    const auto paddedWidth = roundUp(width + 2 * this->padding, this->padding);
+    const auto paddedHeight = roundUp(height + 2 * this->padding, this->padding);
+
+    if (paddedWidth > this->pageSize || paddedHeight > this->pageSize) {
+        throw Error("Texture of size " + std::to_string(width) + "x" + std::to_string(height) +
+                    " does not fit into a texture atlas page.");
+    }
+
+    // Drop pages whose textures were all destroyed
+    this->pages.erase(std::remove_if(this->pages.begin(), this->pages.end(),
+                                     [](const auto &page){return page->layer.expired();}),
+                      this->pages.end());
+
+    stbrp_rect rect {};
+    rect.w = static_cast<stbrp_coord>(paddedWidth);
+    rect.h = static_cast<stbrp_coord>(paddedHeight);
+
+    std::shared_ptr<const TextureArray::Layer> pageLayer;
+    for (auto &page : this->pages) {
+        if (stbrp_pack_rects(&page->context, &rect, 1)) {
+            pageLayer = page->layer.lock();
+            break;
+        }
+    }
+
+    if (!pageLayer) {
+        pageLayer = this->createPage();
+        stbrp_pack_rects(&this->pages.back()->context, &rect, 1);
+    }
+
+    this->upload(*pageLayer, rect.x, rect.y, rgbaData, width, height);
+
+    const auto pageSize = static_cast<float>(this->pageSize);
+
+    Region region;
+    region.page = std::move(pageLayer);
+    region.uvTransform = {width / pageSize, height / pageSize,
+                          (rect.x + this->padding) / pageSize, (rect.y + this->padding) / pageSize};
+    return region;
+}
+
+void TextureAtlas::update(const Region &region, const unsigned char *rgbaData, int width, int height) {
+    const auto x = static_cast<int>(std::lround(region.uvTransform.z * this->pageSize)) - this->padding;
+    const auto y = static_cast<int>(std::lround(region.uvTransform.w * this->pageSize)) - this->padding;
+    this->upload(*region.page, x, y, rgbaData, width, height);
+}
+
+size_t TextureAtlas::getNumPages() const {
+    return std::count_if(this->pages.cbegin(), this->pages.cend(),
+                         [](const auto &page){return !page->layer.expired();});
+}
+
+std::shared_ptr<const TextureArray::Layer> TextureAtlas::createPage() {
+    auto layer = TextureArray::allocateLayer({this->pageSize, this->pageSize, GL_RGBA8, this->numMipLevels});
+
+    auto page = std::make_unique<Page>();
+    page->layer = layer;
+    page->nodes.resize(static_cast<size_t>(this->pageSize));
+    stbrp_init_target(&page->context, this->pageSize, this->pageSize,
+                      page->nodes.data(), static_cast<int>(page->nodes.size()));
+
+    this->pages.push_back(std::move(page));
+
+    return layer;
+}
+
+void TextureAtlas::upload(const TextureArray::Layer &pageLayer, int x, int y,
+                          const unsigned char *rgbaData, int width, int height) {
+    const auto paddedWidth = roundUp(width + 2 * this->padding, this->padding);
+    const auto paddedHeight = roundUp(height + 2 * this->padding, this->padding);
+
+    auto image = wrapPad(rgbaData, width, height, this->padding, paddedWidth, paddedHeight);
+    for (int level = 0; level < this->numMipLevels; ++level) {
+        if (level > 0) {
+            image = downsample(image, paddedWidth >> (level - 1), paddedHeight >> (level - 1));
+        }
+
+        pageLayer.array->subImage(pageLayer.index, level, x >> level, y >> level,
+                                  paddedWidth >> level, paddedHeight >> level,
+                                  GL_RGBA, image.data());
+    }
+}
+
+} // namespace ge
@@ -0,0 +1,127 @@
+#include <game_engine/VertexAnimationTexture.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <game_engine/AnimationClip.h>
+#include <game_engine/Exception.h>
+#include <game_engine/Skeleton.h>
+#include <game_engine/Skinning.h>
+
+namespace {
+
+void createTexture(unsigned int *texture, int internalFormat, int width, int height,
+                   unsigned int format, unsigned int type, const void *data) {
+    glGenTextures(1, texture);
+    glBindTexture(GL_TEXTURE_2D, *texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, data);
+
+    // Texels are fetched individually
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+} // namespace
+
+namespace ge {
+
+constexpr size_t VertexAnimationTexture::MAX_CLIPS;
+
+VertexAnimationTexture::VertexAnimationTexture(const Mesh::SkinningData &skinningData, const Skeleton &skeleton,
+                                               const AnimationClips &clips, float framesPerSecond)
+    : numVertices(skinningData.positions.size()) {
+    if (clips.size() > MAX_CLIPS) {
+        throw Error("Cannot bake " + std::to_string(clips.size()) + " clips, the maximum is " +
+                    std::to_string(MAX_CLIPS) + ".");
+    }
+
+    GLint maxTextureSize;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+
+    // Wrap large meshes over several rows
+    this->width = static_cast<int>(std::max<size_t>(1, std::min<size_t>(this->numVertices, maxTextureSize)));
+    this->rowsPerFrame = std::max(1, static_cast<int>((this->numVertices + this->width - 1) / this->width));
+
+    // Fit a whole number of frames in every clip so that looping is seamless
+    this->clips.reserve(clips.size());
+    for (const auto &clip : clips) {
+        const auto duration_s = clip->getDuration();
+        const auto numFrames = std::max(1u, static_cast<unsigned int>(std::lround(duration_s * framesPerSecond)));
+
+        this->clips.push_back({clip->getName(), this->numFrames, numFrames,
+                               (duration_s > 0.0f) ? numFrames / duration_s : framesPerSecond});
+        this->numFrames += numFrames;
+    }
+
+    const auto height = static_cast<size_t>(this->numFrames) * this->rowsPerFrame;
+    if (height > static_cast<size_t>(maxTextureSize)) {
+        throw Error("Cannot bake " + std::to_string(this->numFrames) + " frames of " +
+                    std::to_string(this->numVertices) + " vertices, the maximum texture size is " +
+                    std::to_string(maxTextureSize) + ".");
+    }
+
+    // Skin every frame
+    const auto texelsPerFrame = static_cast<size_t>(this->width) * this->rowsPerFrame;
+    const auto normals = skinningData.normals.empty() ? nullptr : skinningData.normals.data();
+    std::vector<glm::vec3> framePositions(this->numFrames * texelsPerFrame);
+    std::vector<glm::vec3> frameNormals(this->numFrames * texelsPerFrame);
+
+    Pose pose;
+    std::vector<glm::mat4> modelTransforms;
+    std::vector<glm::mat4> skinMatrices(skeleton.getNumBones());
+
+    for (size_t i = 0; i < clips.size(); ++i) {
+        const auto &clip = this->clips[i];
+
+        for (unsigned int frame = 0; frame < clip.numFrames; ++frame) {
+            pose = skeleton.getBindPose();
+            clips[i]->sample(frame / clip.framesPerSecond, &pose);
+            skeleton.computeModelTransforms(pose, &modelTransforms);
+            skeleton.computeSkinMatrices(modelTransforms, skinMatrices.data());
+
+            const auto firstTexel = (clip.firstFrame + frame) * texelsPerFrame;
+            skinVertices(skinningData.positions.data(), normals, skinningData.boneInfluences.data(),
+                         this->numVertices, skinMatrices.data(),
+                         &framePositions[firstTexel], &frameNormals[firstTexel]);
+
+            if (this->numVertices > 0) {
+                this->boundingSphere = this->boundingSphere.merged(
+                            BoundingSphere::fromPoints(&framePositions[firstTexel].x, this->numVertices));
+            }
+        }
+    }
+
+    std::vector<std::int8_t> packedNormals(4 * frameNormals.size());
+    for (size_t i = 0; i < frameNormals.size(); ++i) {
+        for (auto j = 0; j < 3; ++j) {
+            packedNormals[4 * i + j] = static_cast<std::int8_t>(std::lround(frameNormals[i][j] * 127.0f));
+        }
+    }
+
+    createTexture(&this->positionTexture, GL_RGB32F, this->width, static_cast<int>(height),
+                  GL_RGB, GL_FLOAT, framePositions.data());
+    createTexture(&this->normalTexture, GL_RGBA8_SNORM, this->width, static_cast<int>(height),
+                  GL_RGBA, GL_BYTE, packedNormals.data());
+}
+
+VertexAnimationTexture::~VertexAnimationTexture() {
+    glDeleteTextures(1, &this->normalTexture);
+    glDeleteTextures(1, &this->positionTexture);
+}
+
+void VertexAnimationTexture::bind(unsigned int positionTextureUnit, unsigned int normalTextureUnit) const {
+    glActiveTexture(GL_TEXTURE0 + positionTextureUnit);
+    glBindTexture(GL_TEXTURE_2D, this->positionTexture);
+    glActiveTexture(GL_TEXTURE0 + normalTextureUnit);
+    glBindTexture(GL_TEXTURE_2D, this->normalTexture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+} // namespace ge
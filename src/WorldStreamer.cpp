@@ -0,0 +1,380 @@
+#include <game_engine/WorldStreamer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <sstream>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <game_engine/Exception.h>
+#include <game_engine/GameObject.h>
+
+namespace {
+
+void replaceAll(std::string &string, const std::string &pattern, const std::string &replacement) {
+    for (auto position = string.find(pattern); position != std::string::npos;
+         position = string.find(pattern, position + replacement.size())) {
+        string.replace(position, pattern.size(), replacement);
+    }
+}
+
+} // namespace
+
+namespace ge {
+
+WorldStreamer::WorldStreamer(ManifestLoader manifestLoader, const WorldStreamerSettings &settings)
+    : manifestLoader(std::move(manifestLoader)), settings(settings),
+      uploadedCells(std::make_shared<UploadedCells>()) {
+    this->settings.unloadDistance_m = std::max(this->settings.unloadDistance_m, this->settings.loadDistance_m);
+
+    const auto numIoThreads = std::max(this->settings.numIoThreads, 1u);
+    for (auto i = 0u; i < numIoThreads; ++i) {
+        this->ioThreads.emplace_back(&WorldStreamer::ioLoop, this);
+    }
+}
+
+WorldStreamer::~WorldStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(this->ioMutex);
+        this->stopping = true;
+    }
+    this->ioRequested.notify_all();
+
+    for (auto &ioThread : this->ioThreads) {
+        ioThread.join();
+    }
+}
+
+WorldStreamer::CellManifest WorldStreamer::loadManifest(const std::string &filepath) {
+    std::ifstream file(filepath);
+    if (!file) throw ge::LoadError("Failed to open cell manifest at: " + filepath);
+
+    CellManifest manifest;
+    std::string line;
+    for (auto lineNumber = 1; std::getline(file, line); ++lineNumber) {
+        std::istringstream lineStream(line);
+        std::string keyword;
+        if (!(lineStream >> keyword) || keyword[0] == '#') continue;
+
+        CellObject object;
+        auto yaw_deg = 0.0f;
+        if (keyword != "object" ||
+                !(lineStream >> object.modelFilepath >> object.position.x >> object.position.y >> object.position.z)) {
+            throw ge::LoadError("Invalid object in cell manifest " + filepath + ":" + std::to_string(lineNumber));
+        }
+
+        if (lineStream >> yaw_deg) lineStream >> object.scale;
+        object.yaw_rad = glm::radians(yaw_deg);
+        manifest.push_back(std::move(object));
+    }
+
+    return manifest;
+}
+
+WorldStreamer::ManifestLoader WorldStreamer::fileManifestLoader(const std::string &filepathPattern) {
+    return [filepathPattern](int x, int y){
+        auto filepath = filepathPattern;
+        replaceAll(filepath, "{x}", std::to_string(x));
+        replaceAll(filepath, "{y}", std::to_string(y));
+        return std::ifstream(filepath) ? loadManifest(filepath) : CellManifest();
+    };
+}
+
+void WorldStreamer::update(SceneGraph &sceneGraph, const glm::vec3 &viewPosition, const glm::vec3 &viewDirection,
+                           const RenderThreadRunner &runOnRenderThread) {
+    // Take over the decoded cells that are still wanted
+    std::vector<DecodedCell> decodedCells;
+    {
+        std::lock_guard<std::mutex> lock(this->ioMutex);
+        decodedCells.swap(this->decodedCells);
+    }
+
+    for (auto &decodedCell : decodedCells) {
+        auto cell = this->cells.find(decodedCell.coordinates);
+        if (cell == this->cells.end() || cell->second.state != CellState::DECODING) continue;
+
+        cell->second.state = CellState::DECODED;
+        cell->second.size_bytes = decodedCell.size_bytes;
+        cell->second.decodedCell = std::make_shared<const DecodedCell>(std::move(decodedCell));
+    }
+
+    this->addUploadedCells(sceneGraph);
+
+    // Remove the cells out of range from the world
+    const glm::vec2 position(viewPosition);
+    for (auto cell = this->cells.begin(); cell != this->cells.end();) {
+        auto &state = cell->second;
+        if (this->getDistance(cell->first, position) <= this->settings.unloadDistance_m) {
+            ++cell;
+            continue;
+        }
+
+        state.wanted = false;
+        if (state.state == CellState::LOADED) {
+            for (const auto &gameObject : state.gameObjects) {
+                gameObject->removeFromSceneGraph(sceneGraph);
+            }
+            state.state = CellState::CACHED;
+            state.lruPosition = this->lruCells.insert(this->lruCells.end(), cell->first);
+            --this->numLoadedCells;
+        } else if (state.state == CellState::DECODING || state.state == CellState::DECODED) {
+            // Cells being decoded are dropped when they arrive
+            std::lock_guard<std::mutex> lock(this->ioMutex);
+            this->ioRequests.erase(cell->first);
+            cell = this->cells.erase(cell);
+            continue;
+        }
+
+        ++cell;
+    }
+
+    // Request the cells in range, or bring them back if they are resident
+    const auto minCell = glm::floor((position - this->settings.loadDistance_m) / this->settings.cellSize_m);
+    const auto maxCell = glm::floor((position + this->settings.loadDistance_m) / this->settings.cellSize_m);
+    {
+        std::lock_guard<std::mutex> lock(this->ioMutex);
+        for (auto y = static_cast<int>(minCell.y); y <= static_cast<int>(maxCell.y); ++y) {
+            for (auto x = static_cast<int>(minCell.x); x <= static_cast<int>(maxCell.x); ++x) {
+                const CellCoordinates coordinates(x, y);
+                if (this->getDistance(coordinates, position) > this->settings.loadDistance_m) continue;
+
+                const auto priority = this->getPriority(coordinates, viewPosition, viewDirection);
+                auto inserted = this->cells.emplace(coordinates, Cell());
+                auto &cell = inserted.first->second;
+                cell.wanted = true;
+                cell.priority = priority;
+
+                if (cell.state == CellState::DECODING) {
+                    // Reprioritize the cells that are still queued
+                    auto request = this->ioRequests.find(coordinates);
+                    if (inserted.second) {
+                        this->ioRequests.emplace(coordinates, priority);
+                    } else if (request != this->ioRequests.end()) {
+                        request->second = priority;
+                    }
+                } else if (cell.state == CellState::CACHED) {
+                    for (const auto &gameObject : cell.gameObjects) {
+                        gameObject->addToSceneGraph(sceneGraph);
+                    }
+                    cell.state = CellState::LOADED;
+                    this->lruCells.erase(cell.lruPosition);
+                    ++this->numLoadedCells;
+                }
+            }
+        }
+    }
+    this->ioRequested.notify_all();
+
+    this->uploadCells(runOnRenderThread);
+    this->evictCells(runOnRenderThread);
+}
+
+void WorldStreamer::releaseCells(SceneGraph &sceneGraph, const RenderThreadRunner &runOnRenderThread) {
+    {
+        std::lock_guard<std::mutex> lock(this->ioMutex);
+        this->ioRequests.clear();
+        this->decodedCells.clear();
+    }
+
+    // Game objects own GL objects, so release them on the render thread
+    auto gameObjects = std::make_shared<GameObjects>();
+    for (auto &cell : this->cells) {
+        if (cell.second.state == CellState::LOADED) {
+            for (const auto &gameObject : cell.second.gameObjects) {
+                gameObject->removeFromSceneGraph(sceneGraph);
+            }
+        }
+
+        std::move(cell.second.gameObjects.begin(), cell.second.gameObjects.end(), std::back_inserter(*gameObjects));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->uploadedCells->mutex);
+        for (auto &uploadedCell : this->uploadedCells->cells) {
+            std::move(uploadedCell.second.begin(), uploadedCell.second.end(), std::back_inserter(*gameObjects));
+        }
+        this->uploadedCells->cells.clear();
+        this->uploadedCells->released = true;
+    }
+    runOnRenderThread([gameObjects]{});
+
+    this->cells.clear();
+    this->lruCells.clear();
+    this->numLoadedCells = 0;
+    this->residentSize_bytes = 0;
+}
+
+void WorldStreamer::addToFramePacket(const SceneGraph &sceneGraph, FramePacket &framePacket) const {
+    for (const auto &cell : this->cells) {
+        if (cell.second.state != CellState::LOADED) continue;
+
+        for (const auto &gameObject : cell.second.gameObjects) {
+            gameObject->addToFramePacket(sceneGraph, framePacket);
+        }
+    }
+}
+
+void WorldStreamer::ioLoop() {
+    for (;;) {
+        CellCoordinates coordinates;
+        {
+            std::unique_lock<std::mutex> lock(this->ioMutex);
+            this->ioRequested.wait(lock, [this]{return this->stopping || !this->ioRequests.empty();});
+            if (this->stopping) return;
+
+            // Decode the most important cell first
+            const auto request = std::min_element(this->ioRequests.begin(), this->ioRequests.end(),
+                                                  [](const auto &a, const auto &b){return a.second < b.second;});
+            coordinates = request->first;
+            this->ioRequests.erase(request);
+        }
+
+        auto decodedCell = this->decodeCell(coordinates);
+
+        std::lock_guard<std::mutex> lock(this->ioMutex);
+        this->decodedCells.push_back(std::move(decodedCell));
+    }
+}
+
+WorldStreamer::DecodedCell WorldStreamer::decodeCell(const CellCoordinates &coordinates) const {
+    DecodedCell decodedCell;
+    decodedCell.coordinates = coordinates;
+
+    try {
+        decodedCell.manifest = this->manifestLoader(coordinates.first, coordinates.second);
+    } catch (const std::exception &exception) {
+        std::cerr << "Failed to load cell (" << coordinates.first << ", " << coordinates.second << "): "
+                  << exception.what() << "\n";
+        return decodedCell;
+    }
+
+    // Models placed several times in a cell are imported once
+    std::set<std::string> modelFilepaths;
+    for (const auto &object : decodedCell.manifest) {
+        modelFilepaths.insert(object.modelFilepath);
+    }
+
+    for (const auto &modelFilepath : modelFilepaths) {
+        try {
+            size_t modelSize_bytes = 0;
+            auto importedModel = GameObject::importModel(modelFilepath, &modelSize_bytes);
+            if (importedModel) decodedCell.importedModels.push_back(std::move(importedModel));
+            decodedCell.size_bytes += modelSize_bytes;
+        } catch (const std::exception &exception) {
+            std::cerr << "Failed to import model " << modelFilepath << ": " << exception.what() << "\n";
+        }
+    }
+
+    return decodedCell;
+}
+
+void WorldStreamer::uploadCells(const RenderThreadRunner &runOnRenderThread) {
+    std::vector<std::pair<float, CellCoordinates>> decodedCells;
+    for (const auto &cell : this->cells) {
+        if (cell.second.state == CellState::DECODED) decodedCells.emplace_back(cell.second.priority, cell.first);
+    }
+    std::sort(decodedCells.begin(), decodedCells.end());
+
+    size_t uploadSize_bytes = 0;
+    for (const auto &decodedCell : decodedCells) {
+        auto &cell = this->cells.at(decodedCell.second);
+        if (uploadSize_bytes > 0 && uploadSize_bytes + cell.size_bytes > this->settings.uploadBudgetPerFrame_bytes) {
+            break;
+        }
+
+        uploadSize_bytes += cell.size_bytes;
+        this->residentSize_bytes += cell.size_bytes;
+        cell.state = CellState::UPLOADING;
+
+        // Loading the models consumes their imported data
+        runOnRenderThread([coordinates = decodedCell.second, decoded = std::move(cell.decodedCell),
+                           uploadedCells = this->uploadedCells]{
+            GameObjects gameObjects;
+            for (const auto &object : decoded->manifest) {
+                try {
+                    auto gameObject = std::make_shared<GameObject>(object.modelFilepath);
+                    gameObject->setPosition(object.position)
+                            .rotate(object.yaw_rad, glm::vec3(0.0f, 0.0f, 1.0f))
+                            .setScale(glm::vec3(object.scale));
+                    gameObjects.push_back(std::move(gameObject));
+                } catch (const std::exception &exception) {
+                    std::cerr << "Failed to load model " << object.modelFilepath << ": " << exception.what() << "\n";
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(uploadedCells->mutex);
+            if (!uploadedCells->released) {
+                uploadedCells->cells.emplace_back(coordinates, std::move(gameObjects));
+            }
+        });
+    }
+}
+
+void WorldStreamer::addUploadedCells(SceneGraph &sceneGraph) {
+    std::vector<std::pair<CellCoordinates, GameObjects>> uploadedCells;
+    {
+        std::lock_guard<std::mutex> lock(this->uploadedCells->mutex);
+        uploadedCells.swap(this->uploadedCells->cells);
+    }
+
+    for (auto &uploadedCell : uploadedCells) {
+        auto &cell = this->cells.at(uploadedCell.first);
+        cell.gameObjects = std::move(uploadedCell.second);
+
+        // Cells that went out of range while uploading stay resident
+        if (cell.wanted) {
+            for (const auto &gameObject : cell.gameObjects) {
+                gameObject->addToSceneGraph(sceneGraph);
+            }
+            cell.state = CellState::LOADED;
+            ++this->numLoadedCells;
+        } else {
+            cell.state = CellState::CACHED;
+            cell.lruPosition = this->lruCells.insert(this->lruCells.end(), uploadedCell.first);
+        }
+    }
+}
+
+void WorldStreamer::evictCells(const RenderThreadRunner &runOnRenderThread) {
+    while (this->residentSize_bytes > this->settings.residentBudget_bytes && !this->lruCells.empty()) {
+        auto cell = this->cells.find(this->lruCells.front());
+        this->lruCells.pop_front();
+
+        // Game objects own GL objects, so release them on the render thread
+        auto gameObjects = std::make_shared<GameObjects>(std::move(cell->second.gameObjects));
+        runOnRenderThread([gameObjects]{});
+
+        this->residentSize_bytes -= cell->second.size_bytes;
+        this->cells.erase(cell);
+    }
+}
+
+float WorldStreamer::getDistance(const CellCoordinates &cell, const glm::vec2 &position) const {
+    const auto cellMin = glm::vec2(cell.first, cell.second) * this->settings.cellSize_m;
+    return glm::distance(glm::clamp(position, cellMin, cellMin + this->settings.cellSize_m), position);
+}
+
+float WorldStreamer::getPriority(const CellCoordinates &cell, const glm::vec3 &viewPosition,
+                                 const glm::vec3 &viewDirection) const {
+    // Lower is more important. Cells behind the camera count as twice as far away.
+    const glm::vec2 position(viewPosition);
+    const auto cellCenter = (glm::vec2(cell.first, cell.second) + 0.5f) * this->settings.cellSize_m;
+    const auto toCell = cellCenter - position;
+    const glm::vec2 direction(viewDirection);
+
+    auto facing = 0.0f;
+    if (glm::dot(toCell, toCell) > 0.0f && glm::dot(direction, direction) > 0.0f) {
+        facing = glm::dot(glm::normalize(toCell), glm::normalize(direction));
+    }
+
+    return this->getDistance(cell, position) * (1.5f - 0.5f * facing);
+}
+
+} // namespace ge
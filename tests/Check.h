@@ -0,0 +1,38 @@
+#pragma once
+
+#include <iostream>
+
+///
+/// \brief GE_CHECK Reports a failed condition without stopping the test, so that every
+///                 failure of a run is listed. Tests return ge_test::numFailures.
+///
+#define GE_CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++ge_test::numFailures; \
+        } \
+    } while (false)
+
+///
+/// \brief GE_CHECK_THROWS Checks that an expression throws an exception of the given type.
+///
+#define GE_CHECK_THROWS(expression, Exception) \
+    do { \
+        bool thrown = false; \
+        try { \
+            static_cast<void>(expression); \
+        } catch (const Exception&) { \
+            thrown = true; \
+        } \
+        if (!thrown) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " #expression " did not throw " #Exception << std::endl; \
+            ++ge_test::numFailures; \
+        } \
+    } while (false)
+
+namespace ge_test {
+
+extern int numFailures;
+
+} // namespace ge_test
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <game_engine/EntityRegistry.h>
+
+namespace {
+
+constexpr size_t numEntities = 1000000;
+constexpr int numRuns = 50;
+
+/// Time allowed to update every entity once.
+constexpr std::chrono::duration<double, std::milli> budget(4.0);
+
+struct Position {
+    float x;
+    float y;
+    float z;
+};
+
+struct Velocity {
+    float x;
+    float y;
+    float z;
+};
+
+} // namespace
+
+///
+/// Updates the positions of 1M entities from their velocities in parallel and fails if
+/// the median update takes longer than the budget.
+///
+int main() {
+    ge::EntityRegistry registry;
+    for (size_t i = 0; i < numEntities; ++i) {
+        const auto f = static_cast<float>(i);
+        registry.createEntity(Position{f, 0.0f, 0.0f}, Velocity{1.0f, 0.5f, 0.25f});
+    }
+
+    const auto update = [&registry]{
+        const auto dt = 1.0f / 60.0f;
+        registry.parallelForEachChunk<Position, const Velocity>([dt](size_t count, const ge::Entity*,
+                                                                     Position *positions, const Velocity *velocities){
+            for (size_t i = 0; i < count; ++i) {
+                positions[i].x += velocities[i].x * dt;
+                positions[i].y += velocities[i].y * dt;
+                positions[i].z += velocities[i].z * dt;
+            }
+        });
+    };
+
+    // Warm up the job system's threads and the query cache
+    update();
+
+    std::vector<std::chrono::duration<double, std::milli>> durations;
+    for (int i = 0; i < numRuns; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        update();
+        durations.push_back(std::chrono::steady_clock::now() - start);
+    }
+
+    std::sort(durations.begin(), durations.end());
+    const auto median = durations[durations.size() / 2];
+    std::cout << "Updated " << numEntities << " entities in " << median.count() << " ms (median of "
+              << numRuns << " runs, min " << durations.front().count() << " ms, budget "
+              << budget.count() << " ms)" << std::endl;
+
+    return median <= budget ? 0 : 1;
+}
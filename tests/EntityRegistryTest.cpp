@@ -0,0 +1,210 @@
+#include <stdexcept>
+#include <vector>
+
+#include <game_engine/EntityRegistry.h>
+
+#include "Check.h"
+
+int ge_test::numFailures = 0;
+
+namespace {
+
+struct Position {
+    float x;
+    float y;
+};
+
+struct Velocity {
+    float x;
+    float y;
+};
+
+///
+/// \brief The Tracked struct counts its live instances, so that leaked or doubly
+/// destroyed components show up as a wrong count.
+///
+struct Tracked {
+    static int numAlive;
+
+    explicit Tracked(int value = 0) : value(value) {++numAlive;}
+    Tracked(const Tracked &other) : value(other.value) {++numAlive;}
+    Tracked(Tracked &&other) noexcept : value(other.value) {++numAlive;}
+    ~Tracked() {--numAlive;}
+
+    int value;
+};
+
+int Tracked::numAlive = 0;
+
+///
+/// \brief The Throwing struct throws when copied, like a component whose resources
+/// cannot be allocated.
+///
+struct Throwing {
+    Throwing() = default;
+    Throwing(const Throwing &) {throw std::runtime_error("copy failed");}
+    Throwing(Throwing &&) noexcept = default;
+};
+
+void testCreateAndGet() {
+    ge::EntityRegistry registry;
+    const auto entity = registry.createEntity(Position{1.0f, 2.0f}, Velocity{3.0f, 4.0f});
+
+    GE_CHECK(registry.isAlive(entity));
+    GE_CHECK(registry.size() == 1);
+    GE_CHECK(registry.hasComponent<Position>(entity));
+    GE_CHECK(!registry.hasComponent<Tracked>(entity));
+    GE_CHECK(registry.getComponent<Position>(entity).y == 2.0f);
+    GE_CHECK(registry.getComponent<Velocity>(entity).x == 3.0f);
+    GE_CHECK_THROWS(registry.getComponent<Tracked>(entity), ge::Error);
+}
+
+void testSwapRemoveKeepsOtherRows() {
+    ge::EntityRegistry registry;
+    std::vector<ge::Entity> entities;
+    for (int i = 0; i < 1000; ++i) {
+        entities.push_back(registry.createEntity(Position{static_cast<float>(i), 0.0f}, Tracked(i)));
+    }
+
+    // Removing rows moves the last rows into the holes, across chunks
+    for (size_t i = 0; i < entities.size(); i += 3) {
+        registry.destroyEntity(entities[i]);
+    }
+
+    for (size_t i = 0; i < entities.size(); ++i) {
+        if (i % 3 == 0) {
+            GE_CHECK(!registry.isAlive(entities[i]));
+            continue;
+        }
+
+        GE_CHECK(registry.getComponent<Position>(entities[i]).x == static_cast<float>(i));
+        GE_CHECK(registry.getComponent<Tracked>(entities[i]).value == static_cast<int>(i));
+    }
+
+    GE_CHECK(registry.size() == 666);
+    GE_CHECK(Tracked::numAlive == 666);
+
+    size_t numVisited = 0;
+    registry.forEach<const Position, const Tracked>([&](ge::Entity entity, const Position &position,
+                                                        const Tracked &tracked){
+        GE_CHECK(static_cast<int>(position.x) == tracked.value);
+        GE_CHECK(registry.getComponent<Tracked>(entity).value == tracked.value);
+        ++numVisited;
+    });
+    GE_CHECK(numVisited == 666);
+
+    registry.clear();
+    GE_CHECK(registry.size() == 0);
+    GE_CHECK(Tracked::numAlive == 0);
+}
+
+void testGenerationReuse() {
+    ge::EntityRegistry registry;
+    const auto first = registry.createEntity(Position{1.0f, 1.0f});
+    registry.destroyEntity(first);
+
+    const auto second = registry.createEntity(Position{2.0f, 2.0f});
+    GE_CHECK(second.index == first.index);
+    GE_CHECK(second.generation == first.generation + 1);
+    GE_CHECK(second != first);
+
+    // The stale handle does not reach the new entity
+    GE_CHECK(!registry.isAlive(first));
+    GE_CHECK(!registry.hasComponent<Position>(first));
+    GE_CHECK_THROWS(registry.getComponent<Position>(first), ge::Error);
+    GE_CHECK_THROWS(registry.addComponent<Velocity>(first), ge::Error);
+
+    registry.destroyEntity(first);
+    GE_CHECK(registry.isAlive(second));
+    GE_CHECK(registry.getComponent<Position>(second).x == 2.0f);
+}
+
+void testArchetypeMoves() {
+    ge::EntityRegistry registry;
+    const auto a = registry.createEntity(Position{1.0f, 0.0f}, Tracked(1));
+    const auto b = registry.createEntity(Position{2.0f, 0.0f}, Tracked(2));
+    const auto c = registry.createEntity(Position{3.0f, 0.0f}, Tracked(3));
+
+    // Moving a out of its archetype moves c into its row
+    registry.addComponent<Velocity>(a, 5.0f, 6.0f);
+    GE_CHECK(registry.getComponent<Position>(a).x == 1.0f);
+    GE_CHECK(registry.getComponent<Tracked>(a).value == 1);
+    GE_CHECK(registry.getComponent<Velocity>(a).y == 6.0f);
+    GE_CHECK(registry.getComponent<Tracked>(b).value == 2);
+    GE_CHECK(registry.getComponent<Tracked>(c).value == 3);
+
+    // Replacing a component keeps the archetype
+    registry.addComponent<Tracked>(a, 10);
+    GE_CHECK(registry.getComponent<Tracked>(a).value == 10);
+    GE_CHECK(Tracked::numAlive == 3);
+
+    registry.removeComponent<Tracked>(b);
+    GE_CHECK(!registry.hasComponent<Tracked>(b));
+    GE_CHECK(registry.getComponent<Position>(b).x == 2.0f);
+    GE_CHECK(registry.getComponent<Tracked>(c).value == 3);
+    GE_CHECK(Tracked::numAlive == 2);
+
+    // Removing a missing component does nothing
+    registry.removeComponent<Velocity>(b);
+    GE_CHECK(registry.getComponent<Position>(b).x == 2.0f);
+
+    size_t numWithVelocity = 0;
+    registry.forEach<Position, Velocity>([&](ge::Entity entity, Position&, Velocity&){
+        GE_CHECK(entity == a);
+        ++numWithVelocity;
+    });
+    GE_CHECK(numWithVelocity == 1);
+
+    registry.clear();
+    GE_CHECK(Tracked::numAlive == 0);
+}
+
+void testThrowingConstructorLeavesRegistryUnchanged() {
+    ge::EntityRegistry registry;
+    const auto entity = registry.createEntity(Position{1.0f, 0.0f}, Tracked(1));
+
+    const Throwing throwing;
+    GE_CHECK_THROWS(registry.createEntity(Tracked(2), throwing), std::runtime_error);
+    GE_CHECK(registry.size() == 1);
+    GE_CHECK(Tracked::numAlive == 1);
+
+    GE_CHECK_THROWS(registry.addComponent<Throwing>(entity, throwing), std::runtime_error);
+    GE_CHECK(!registry.hasComponent<Throwing>(entity));
+    GE_CHECK(registry.getComponent<Tracked>(entity).value == 1);
+
+    // The index of the failed entity was never taken
+    const auto next = registry.createEntity(Position{2.0f, 0.0f});
+    GE_CHECK(next.index == entity.index + 1);
+    GE_CHECK(next.generation == 0);
+}
+
+void testParallelForEach() {
+    ge::EntityRegistry registry;
+    for (int i = 0; i < 100000; ++i) {
+        registry.createEntity(Position{0.0f, 0.0f}, Velocity{1.0f, 2.0f});
+    }
+
+    registry.parallelForEach<Position, const Velocity>([](ge::Entity, Position &position, const Velocity &velocity){
+        position.x += velocity.x;
+        position.y += velocity.y;
+    });
+
+    size_t numMoved = 0;
+    registry.forEach<const Position>([&](ge::Entity, const Position &position){
+        if (position.x == 1.0f && position.y == 2.0f) ++numMoved;
+    });
+    GE_CHECK(numMoved == 100000);
+}
+
+} // namespace
+
+int main() {
+    testCreateAndGet();
+    testSwapRemoveKeepsOtherRows();
+    testGenerationReuse();
+    testArchetypeMoves();
+    testThrowingConstructorLeavesRegistryUnchanged();
+    testParallelForEach();
+
+    return ge_test::numFailures == 0 ? 0 : 1;
+}
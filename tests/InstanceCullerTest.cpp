@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <game_engine/InstanceCuller.h>
+
+#include "Check.h"
+
+int ge_test::numFailures = 0;
+
+namespace {
+
+/// Exit code reported to ctest when no OpenGL context can be created.
+constexpr int skipReturnCode = 77;
+
+constexpr size_t numInstances = 2000;
+
+/// The GPU tests spheres in single precision in another order than Frustum, so only
+/// instances whose radius or distance is this close to a limit may be culled differently.
+constexpr float tolerance = 1e-3f;
+
+struct Instances {
+    std::vector<glm::mat4> modelMatrices;
+    std::vector<glm::mat3> normalMatrices;
+    std::vector<glm::vec2> data;
+};
+
+///
+/// \brief createInstances Scatters rotated and scaled instances around the camera, each
+///                        with its index as data.
+///
+Instances createInstances() {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> angle_rad(0.0f, 6.28f);
+    std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+    Instances instances;
+    for (size_t i = 0; i < numInstances; ++i) {
+        auto modelMatrix = glm::translate(glm::mat4(1.0f), {position(generator), position(generator), position(generator)});
+        modelMatrix = glm::rotate(modelMatrix, angle_rad(generator), glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f)));
+        modelMatrix = glm::scale(modelMatrix, glm::vec3(scale(generator), scale(generator), scale(generator)));
+
+        instances.modelMatrices.push_back(modelMatrix);
+        instances.normalMatrices.push_back(glm::mat3(glm::transpose(glm::inverse(modelMatrix))));
+        instances.data.emplace_back(static_cast<float>(i), 0.0f);
+    }
+    return instances;
+}
+
+unsigned int createBuffer(const void *data, size_t size_bytes) {
+    unsigned int buffer;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(size_bytes), data, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return buffer;
+}
+
+std::string getBackendName(ge::InstanceCuller::Backend backend) {
+    switch (backend) {
+    case ge::InstanceCuller::Backend::CPU:
+        return "CPU";
+
+    case ge::InstanceCuller::Backend::TRANSFORM_FEEDBACK:
+        return "transform feedback";
+
+    default:
+        return "compute";
+    }
+}
+
+///
+/// \brief testBackendMatchesCpuReference Culls the instances with a backend and checks
+///                                       that it keeps the instances cullOnCpu() keeps,
+///                                       except the ones within the tolerance of a limit.
+///
+void testBackendMatchesCpuReference(ge::InstanceCuller::Backend backend, const Instances &instances,
+                                    unsigned int modelMatrixBuffer, unsigned int normalMatrixBuffer,
+                                    unsigned int instanceDataBuffer, const ge::InstanceCuller::DistanceRange &distanceRange) {
+    const auto viewProjectionMatrix = glm::perspective(glm::radians(60.0f), 1.5f, 0.1f, 100.0f) *
+            glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.2f, 0.1f), glm::vec3(0.0f, 0.0f, 1.0f));
+
+    ge::BoundingSphere boundingSphere;
+    boundingSphere.center = {0.2f, 0.0f, 0.5f};
+    boundingSphere.radius = 1.5f;
+
+    ge::InstanceCuller culler(numInstances, backend);
+    culler.cull(modelMatrixBuffer, normalMatrixBuffer, instanceDataBuffer, numInstances,
+                boundingSphere, viewProjectionMatrix, distanceRange);
+
+    const auto numVisibleInstances = culler.getNumVisibleInstances();
+    std::vector<float> culledInstances(numInstances * ge::InstanceCuller::INSTANCE_SIZE_BYTES / sizeof(float));
+    glBindBuffer(GL_ARRAY_BUFFER, culler.getCulledInstanceBuffer());
+    glGetBufferSubData(GL_ARRAY_BUFFER, 0, numInstances * ge::InstanceCuller::INSTANCE_SIZE_BYTES,
+                       culledInstances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // The compute backend appends the instances in any order
+    std::vector<size_t> culledIndices;
+    const auto instanceSize_floats = ge::InstanceCuller::INSTANCE_SIZE_BYTES / sizeof(float);
+    const auto dataOffset_floats = ge::InstanceCuller::INSTANCE_DATA_OFFSET_BYTES / sizeof(float);
+    auto instancesCopied = true;
+    for (size_t i = 0; i < numVisibleInstances; ++i) {
+        const auto culledInstance = &culledInstances[i * instanceSize_floats];
+        const auto index = static_cast<size_t>(culledInstance[dataOffset_floats]);
+        culledIndices.push_back(index);
+
+        instancesCopied = instancesCopied && index < numInstances &&
+                std::memcmp(culledInstance, glm::value_ptr(instances.modelMatrices[index]), sizeof(glm::mat4)) == 0 &&
+                std::memcmp(culledInstance + 16, glm::value_ptr(instances.normalMatrices[index]), sizeof(glm::mat3)) == 0;
+    }
+    std::sort(culledIndices.begin(), culledIndices.end());
+
+    // Instances the reference keeps with a smaller sphere must be kept, and instances it
+    // drops with a larger one must be dropped
+    auto shrunkSphere = boundingSphere;
+    shrunkSphere.radius *= 1.0f - tolerance;
+    auto shrunkRange = distanceRange;
+    shrunkRange.minDistance *= 1.0f + tolerance;
+    shrunkRange.maxDistance *= 1.0f - tolerance;
+    const auto mustKeep = ge::InstanceCuller::cullOnCpu(instances.modelMatrices, shrunkSphere,
+                                                        viewProjectionMatrix, shrunkRange);
+
+    auto grownSphere = boundingSphere;
+    grownSphere.radius *= 1.0f + tolerance;
+    auto grownRange = distanceRange;
+    grownRange.minDistance *= 1.0f - tolerance;
+    grownRange.maxDistance = std::min(grownRange.maxDistance * (1.0f + tolerance), std::numeric_limits<float>::max());
+    const auto mayKeep = ge::InstanceCuller::cullOnCpu(instances.modelMatrices, grownSphere,
+                                                       viewProjectionMatrix, grownRange);
+
+    std::cout << getBackendName(backend) << ": " << numVisibleInstances << " of " << numInstances
+              << " instances visible, reference " << mustKeep.size() << " to " << mayKeep.size() << std::endl;
+
+    GE_CHECK(!mustKeep.empty());
+    GE_CHECK(mayKeep.size() < numInstances);
+    GE_CHECK(instancesCopied);
+    GE_CHECK(std::adjacent_find(culledIndices.begin(), culledIndices.end()) == culledIndices.end());
+    GE_CHECK(std::includes(culledIndices.begin(), culledIndices.end(), mustKeep.begin(), mustKeep.end()));
+    GE_CHECK(std::includes(mayKeep.begin(), mayKeep.end(), culledIndices.begin(), culledIndices.end()));
+
+    // Without query buffers, every instance is drawn, so the ones past the culled ones
+    // must collapse to a point
+    if (backend == ge::InstanceCuller::Backend::TRANSFORM_FEEDBACK && !GLAD_GL_VERSION_4_4) {
+        GE_CHECK(std::all_of(culledInstances.begin() + static_cast<std::ptrdiff_t>(numVisibleInstances * instanceSize_floats),
+                             culledInstances.end(), [](float value){return value == 0.0f;}));
+    }
+}
+
+} // namespace
+
+int main() {
+    // Culls without showing a window. Machines without a display or OpenGL 3.3 skip the test.
+    if (!glfwInit()) {
+        std::cerr << "Skipped, failed to initialize GLFW" << std::endl;
+        return skipReturnCode;
+    }
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    auto window = glfwCreateWindow(64, 64, "Instance culler test", nullptr, nullptr);
+    if (!window) {
+        std::cerr << "Skipped, no OpenGL 3.3 context" << std::endl;
+        glfwTerminate();
+        return skipReturnCode;
+    }
+
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
+        std::cerr << "Skipped, failed to load OpenGL" << std::endl;
+        glfwTerminate();
+        return skipReturnCode;
+    }
+
+    {
+        const auto instances = createInstances();
+        const auto modelMatrixBuffer = createBuffer(instances.modelMatrices.data(), numInstances * sizeof(glm::mat4));
+        const auto normalMatrixBuffer = createBuffer(instances.normalMatrices.data(), numInstances * sizeof(glm::mat3));
+        const auto instanceDataBuffer = createBuffer(instances.data.data(), numInstances * sizeof(glm::vec2));
+
+        std::vector<ge::InstanceCuller::Backend> backends {ge::InstanceCuller::Backend::CPU,
+                                                           ge::InstanceCuller::Backend::TRANSFORM_FEEDBACK};
+        if (GLAD_GL_VERSION_4_3) backends.push_back(ge::InstanceCuller::Backend::COMPUTE);
+
+        ge::InstanceCuller::DistanceRange levelOfDetail;
+        levelOfDetail.minDistance = 10.0f;
+        levelOfDetail.maxDistance = 40.0f;
+
+        for (auto backend : backends) {
+            testBackendMatchesCpuReference(backend, instances, modelMatrixBuffer, normalMatrixBuffer,
+                                           instanceDataBuffer, ge::InstanceCuller::DistanceRange());
+            testBackendMatchesCpuReference(backend, instances, modelMatrixBuffer, normalMatrixBuffer,
+                                           instanceDataBuffer, levelOfDetail);
+        }
+
+        glDeleteBuffers(1, &instanceDataBuffer);
+        glDeleteBuffers(1, &normalMatrixBuffer);
+        glDeleteBuffers(1, &modelMatrixBuffer);
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+
+    return ge_test::numFailures == 0 ? 0 : 1;
+}
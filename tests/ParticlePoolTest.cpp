@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <game_engine/JobSystem.h>
+#include <game_engine/ParticlePool.h>
+
+#include "Check.h"
+
+int ge_test::numFailures = 0;
+
+namespace {
+
+///
+/// \brief colorsOf Returns the colors of the particles of a pool, which tests use as
+///                 particle IDs, in ascending order.
+///
+std::vector<std::uint32_t> colorsOf(const ge::ParticlePool &pool) {
+    std::vector<std::uint32_t> colors(pool.getColors(), pool.getColors() + pool.size());
+    std::sort(colors.begin(), colors.end());
+    return colors;
+}
+
+void testIntegration() {
+    ge::JobSystem jobSystem(2);
+    ge::ParticlePool pool(1);
+
+    ge::ParticlePool::Particle particle;
+    particle.velocity = {1.0f, 0.0f, 0.0f};
+    particle.lifetime_s = 10.0f;
+    GE_CHECK(pool.emit(particle));
+    GE_CHECK(!pool.emit(particle));
+
+    ge::ParticleForces forces;
+    forces.acceleration = {0.0f, -10.0f, 0.0f};
+    pool.update(0.5f, forces, jobSystem);
+
+    // Semi-implicit Euler moves by the new velocity
+    GE_CHECK(pool.size() == 1);
+    GE_CHECK(pool.getVelocitiesY()[0] == -5.0f);
+    GE_CHECK(pool.getPositionsX()[0] == 0.5f);
+    GE_CHECK(pool.getPositionsY()[0] == -2.5f);
+    GE_CHECK(pool.getAges()[0] == 0.5f);
+}
+
+void testRemoveExpiredAcrossRanges() {
+    // Several update jobs' worth of particles with patterns of expiry that leave
+    // ranges full, empty or partly live, so live particles move between ranges
+    constexpr std::uint32_t numParticles = 100000;
+
+    ge::JobSystem jobSystem(4);
+    ge::ParticlePool pool(numParticles);
+    std::vector<std::uint32_t> expectedColors;
+
+    for (std::uint32_t i = 0; i < numParticles; ++i) {
+        const auto expires = (i / 16384 == 1) || (i / 16384 == 3 && i % 3 != 0) || (i % 7 == 0);
+
+        ge::ParticlePool::Particle particle;
+        particle.lifetime_s = expires ? 0.5f : 2.0f;
+        particle.position = {static_cast<float>(i), 0.0f, 0.0f};
+        particle.color = i;
+        GE_CHECK(pool.emit(particle));
+
+        if (!expires) expectedColors.push_back(i);
+    }
+
+    pool.update(1.0f, ge::ParticleForces(), jobSystem);
+
+    GE_CHECK(pool.size() == expectedColors.size());
+    GE_CHECK(colorsOf(pool) == expectedColors);
+
+    // Attributes move along with their particle
+    auto attributesMatch = true;
+    for (size_t i = 0; i < pool.size(); ++i) {
+        attributesMatch = attributesMatch && pool.getPositionsX()[i] == static_cast<float>(pool.getColors()[i]) &&
+                pool.getLifetimes()[i] == 2.0f && pool.getAges()[i] == 1.0f;
+    }
+    GE_CHECK(attributesMatch);
+
+    // Every particle expires
+    pool.update(1.5f, ge::ParticleForces(), jobSystem);
+    GE_CHECK(pool.size() == 0);
+}
+
+} // namespace
+
+int main() {
+    testIntegration();
+    testRemoveExpiredAcrossRanges();
+
+    return ge_test::numFailures == 0 ? 0 : 1;
+}
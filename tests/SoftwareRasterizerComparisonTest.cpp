@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/trigonometric.hpp>
+
+#include <game_engine/CameraFPV.h>
+#include <game_engine/Exception.h>
+#include <game_engine/Game.h>
+#include <game_engine/SoftwareRasterizer.h>
+
+#include "Check.h"
+
+int ge_test::numFailures = 0;
+
+namespace {
+
+/// Exit code reported to ctest when no OpenGL context can be created.
+constexpr int skipReturnCode = 77;
+
+const std::string modelFilepath = "models/nanosuit/nanosuit.obj";
+
+/// The rasterizer samples textures without mipmaps, so minified textures alias where
+/// OpenGL blurs them, and covers slightly different pixels along silhouettes. Both
+/// only affect a few pixels each, while wrong lighting or transformations move the
+/// mean error across the whole model.
+constexpr double maxMeanError = 6.0;
+constexpr int outlierError = 48;
+constexpr double maxOutlierFraction = 0.03;
+
+///
+/// \brief The ReferenceGame class renders a model with the default shaders of Game and
+/// captures the HDR scene right after the opaque pass shaded it, before post-processing.
+///
+/// Features the rasterizer lacks are left out: ambient occlusion and temporal
+/// anti-aliasing (and its jitter) are disabled, and no skybox is set, so the ambient
+/// light is constant and nothing reflects the sky.
+///
+class ReferenceGame : public ge::Game {
+public:
+    static std::unique_ptr<ReferenceGame> New(unsigned int width, unsigned int height) {
+        std::unique_ptr<ReferenceGame> game(new ReferenceGame(width, height));
+        game->init();
+        game->loadWorld();
+        return game;
+    }
+
+    /// Scene in RGBA32F, bottom row first, or empty if no frame was rendered.
+    std::vector<float> scenePixels;
+    int sceneWidth = 0;
+    int sceneHeight = 0;
+    glm::vec3 clearColor {0.0f};
+    glm::mat4 viewMatrix {1.0f};
+    glm::mat4 projectionMatrix {1.0f};
+    glm::vec3 viewPosition {0.0f};
+    ge::FramePacket::DirectionalLightData directionalLight;
+    std::shared_ptr<ge::GameObject> model;
+
+private:
+    ReferenceGame(unsigned int width, unsigned int height) : Game(width, height, "Software rasterizer comparison") {}
+
+    void init() override {
+        Game::init();
+
+        this->setCam(std::make_unique<ge::CameraFPV>(45.0f, static_cast<float>(this->getFrameBufferWidth()) /
+                                                     this->getFrameBufferHeight(), 0.1f, 100.0f));
+        this->getCam()->setPosition({-3.0f, 0.0f, 3.0f});
+
+        this->getAmbientOcclusion().setEnabled(false);
+        this->getPostProcessor().setPassEnabled(ge::PostProcessor::TEMPORAL_ANTI_ALIASING, false);
+    }
+
+    void loadWorld() override {
+        // Placed like in the example game
+        this->model = std::make_shared<ge::GameObject>(modelFilepath);
+        this->model->setScale(glm::vec3{0.3f})
+                .rotate(glm::radians(90.0f), {1.0f, 0.0f, 0.0f})
+                .rotate(glm::radians(-90.0f), {0.0f, 0.0f, 1.0f})
+                .setPosition({3.0f, 0.0f, 0.0f});
+        this->pushBackInWorldList(this->model);
+    }
+
+    void renderOpaque(const ge::FramePacket &framePacket, bool depthOnly) override {
+        if (depthOnly || !this->scenePixels.empty()) return;
+
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        this->sceneWidth = viewport[2];
+        this->sceneHeight = viewport[3];
+
+        GLfloat clearColor[4];
+        glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+        this->clearColor = {clearColor[0], clearColor[1], clearColor[2]};
+
+        this->scenePixels.resize(static_cast<size_t>(this->sceneWidth) * this->sceneHeight * 4);
+        glReadPixels(0, 0, this->sceneWidth, this->sceneHeight, GL_RGBA, GL_FLOAT, this->scenePixels.data());
+
+        this->viewMatrix = framePacket.viewMatrix;
+        this->projectionMatrix = framePacket.projectionMatrix;
+        this->viewPosition = framePacket.viewPosition;
+        this->directionalLight = framePacket.directionalLight;
+
+        glfwSetWindowShouldClose(this->getWindow(), true);
+    }
+};
+
+} // namespace
+
+int main() {
+    ge::Game::renderThreadEnabled = false;
+
+    // Render without showing a window. Machines without a display or OpenGL 3.3 skip
+    // the comparison.
+    glfwInit();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    std::unique_ptr<ReferenceGame> game;
+    try {
+        game = ReferenceGame::New(512, 512);
+    } catch (const ge::WindowingSystemError &error) {
+        std::cerr << "Skipped, no OpenGL context: " << error.what() << std::endl;
+        return skipReturnCode;
+    } catch (const ge::GlExtensionLoadingError &error) {
+        std::cerr << "Skipped, no OpenGL context: " << error.what() << std::endl;
+        return skipReturnCode;
+    }
+
+    game->startGameLoop();
+    GE_CHECK(!game->scenePixels.empty());
+    if (game->scenePixels.empty()) return 1;
+
+    const auto &light = game->directionalLight;
+    ge::SoftwareRasterizer rasterizer(game->sceneWidth, game->sceneHeight);
+    rasterizer.setCamera(game->viewMatrix, game->projectionMatrix, game->viewPosition)
+            .setDirectionalLight(light.direction, light.diffuse, light.specular)
+            .setAmbientLight(light.ambient)
+            .setTonemapping(false);
+    rasterizer.clear(game->clearColor);
+
+    // The meshes are loaded with the transforms of their nodes, like GameObject draws them
+    const auto meshes = ge::loadSoftwareMeshes(modelFilepath);
+    for (const auto &mesh : meshes) {
+        rasterizer.draw(mesh, game->model->getModelMatrix());
+    }
+    rasterizer.flush();
+    const auto softwarePixels = rasterizer.readPixels();
+
+    // Compare clamped 8 bit colors, flipping the OpenGL rows to top row first
+    const auto width = static_cast<size_t>(game->sceneWidth);
+    const auto height = static_cast<size_t>(game->sceneHeight);
+    double totalError = 0.0;
+    size_t numOutliers = 0;
+    size_t numCoveredPixels = 0;
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            const auto glPixel = &game->scenePixels[((height - 1 - y) * width + x) * 4];
+            const auto softwarePixel = &softwarePixels[(y * width + x) * 4];
+
+            auto maxError = 0;
+            for (size_t c = 0; c < 3; ++c) {
+                const auto glValue = static_cast<int>(std::lround(std::min(std::max(glPixel[c], 0.0f), 1.0f) *
+                                                                  255.0f));
+                const auto error = std::abs(glValue - static_cast<int>(softwarePixel[c]));
+                totalError += error;
+                maxError = std::max(maxError, error);
+            }
+
+            if (maxError > outlierError) ++numOutliers;
+            if (rasterizer.getDepthBuffer()[y * width + x] < 1.0f) ++numCoveredPixels;
+        }
+    }
+
+    // Errors are averaged over the model, not the empty background
+    const auto numComparedPixels = std::max<size_t>(numCoveredPixels, 1);
+    const auto meanError = totalError / (3.0 * numComparedPixels);
+    const auto outlierFraction = static_cast<double>(numOutliers) / numComparedPixels;
+    std::cout << "Covered pixels: " << numCoveredPixels << ", mean error: " << meanError
+              << ", outliers: " << outlierFraction * 100.0 << "%" << std::endl;
+
+    GE_CHECK(numCoveredPixels > width * height / 50);
+    GE_CHECK(meanError <= maxMeanError);
+    GE_CHECK(outlierFraction <= maxOutlierFraction);
+
+    return ge_test::numFailures == 0 ? 0 : 1;
+}
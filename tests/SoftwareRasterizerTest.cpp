@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <game_engine/JobSystem.h>
+#include <game_engine/SoftwareRasterizer.h>
+
+#include "Check.h"
+
+int ge_test::numFailures = 0;
+
+namespace {
+
+/// 2 x 2 tiles, so that triangles are binned into several tiles.
+constexpr int imageSize = 2 * ge::SoftwareRasterizer::TILE_SIZE_PIXELS;
+
+/// Corners of the quad in pixels, on pixel centers, so that its edges pass through the
+/// centers of a row and a column of pixels on every side.
+constexpr float quadMin = 32.5f;
+constexpr float quadMax = 96.5f;
+
+/// Pixels covered by the quad: the first row and column are on its top and left edges,
+/// while the last ones are on its bottom and right edges and are left out.
+constexpr int quadMinPixel = 32;
+constexpr int quadMaxPixel = 95;
+
+constexpr float depthTolerance = 1e-5f;
+
+///
+/// \brief toNdc Returns the normalized device coordinates of a point of the image in
+///              pixels from its top left corner, which the identity camera draws there.
+///
+glm::vec3 toNdc(float x, float y, float z) {
+    return {x / imageSize * 2.0f - 1.0f, 1.0f - y / imageSize * 2.0f, z};
+}
+
+ge::SoftwareMesh::Vertex createVertex(const glm::vec3 &position) {
+    ge::SoftwareMesh::Vertex vertex;
+    vertex.position = position;
+    vertex.normal = {0.0f, 0.0f, 1.0f};
+    vertex.textureCoordinates = glm::vec2(0.0f);
+    return vertex;
+}
+
+///
+/// \brief createTriangle Creates a mesh of a triangle given in pixels.
+///
+ge::SoftwareMesh createTriangle(const glm::vec2 &a, const glm::vec2 &b, const glm::vec2 &c, float z = 0.0f) {
+    ge::SoftwareMesh mesh;
+    for (const auto &corner : {a, b, c}) {
+        mesh.vertices.push_back(createVertex(toNdc(corner.x, corner.y, z)));
+    }
+    mesh.indices = {0, 1, 2};
+    return mesh;
+}
+
+///
+/// \brief createRasterizer Creates a rasterizer whose camera draws positions at their
+///                         normalized device coordinates, with a gray ambient light.
+///
+ge::SoftwareRasterizer createRasterizer(ge::JobSystem &jobSystem = ge::JobSystem::getInstance()) {
+    ge::SoftwareRasterizer rasterizer(imageSize, imageSize, jobSystem);
+    rasterizer.setCamera(glm::mat4(1.0f), glm::mat4(1.0f), {0.0f, 0.0f, 1.0f})
+            .setAmbientLight(glm::vec3(0.4f))
+            .setTonemapping(false);
+    rasterizer.clear();
+    return rasterizer;
+}
+
+///
+/// \brief getCoverage Returns whether every pixel was drawn, top row first.
+///
+std::vector<bool> getCoverage(const ge::SoftwareRasterizer &rasterizer) {
+    std::vector<bool> coverage;
+    for (const auto depth : rasterizer.getDepthBuffer()) {
+        coverage.push_back(depth < 1.0f);
+    }
+    return coverage;
+}
+
+bool isInQuad(int x, int y) {
+    return x >= quadMinPixel && x <= quadMaxPixel && y >= quadMinPixel && y <= quadMaxPixel;
+}
+
+void testCoverage() {
+    auto rasterizer = createRasterizer();
+    const auto quad = createTriangle({quadMin, quadMin}, {quadMax, quadMin}, {quadMax, quadMax});
+    const auto otherHalf = createTriangle({quadMin, quadMin}, {quadMax, quadMax}, {quadMin, quadMax});
+    rasterizer.draw(quad, glm::mat4(1.0f));
+    rasterizer.draw(otherHalf, glm::mat4(1.0f));
+    rasterizer.flush();
+
+    const auto coverage = getCoverage(rasterizer);
+    const auto pixels = rasterizer.readPixels();
+    auto coveredAsExpected = true;
+    auto shadedAsExpected = true;
+    for (int y = 0; y < imageSize; ++y) {
+        for (int x = 0; x < imageSize; ++x) {
+            const auto pixel = static_cast<size_t>(y) * imageSize + x;
+            coveredAsExpected = coveredAsExpected && coverage[pixel] == isInQuad(x, y);
+
+            // White surfaces lit by the ambient light only, on black
+            const auto expectedValue = isInQuad(x, y) ? 102 : 0;
+            for (size_t channel = 0; channel < 3; ++channel) {
+                shadedAsExpected = shadedAsExpected && pixels[pixel * 4 + channel] == expectedValue;
+            }
+            shadedAsExpected = shadedAsExpected && pixels[pixel * 4 + 3] == 255;
+        }
+    }
+
+    GE_CHECK(coveredAsExpected);
+    GE_CHECK(shadedAsExpected);
+}
+
+void testSharedEdgeIsDrawnOnce() {
+    // The diagonal from the top left to the bottom right corner of the quad passes
+    // through the centers of its pixels, and is a left edge of the upper triangle only
+    auto rasterizer = createRasterizer();
+    const auto upperTriangle = createTriangle({quadMin, quadMin}, {quadMax, quadMin}, {quadMax, quadMax});
+    rasterizer.draw(upperTriangle, glm::mat4(1.0f));
+    rasterizer.flush();
+    const auto upperCoverage = getCoverage(rasterizer);
+
+    rasterizer.clear();
+    const auto lowerTriangle = createTriangle({quadMin, quadMin}, {quadMax, quadMax}, {quadMin, quadMax});
+    rasterizer.draw(lowerTriangle, glm::mat4(1.0f));
+    rasterizer.flush();
+    const auto lowerCoverage = getCoverage(rasterizer);
+
+    auto drawnOnce = true;
+    auto diagonalInUpperTriangle = true;
+    for (int y = 0; y < imageSize; ++y) {
+        for (int x = 0; x < imageSize; ++x) {
+            const auto pixel = static_cast<size_t>(y) * imageSize + x;
+            const auto numDraws = (upperCoverage[pixel] ? 1 : 0) + (lowerCoverage[pixel] ? 1 : 0);
+            drawnOnce = drawnOnce && numDraws == (isInQuad(x, y) ? 1 : 0);
+            if (x == y && isInQuad(x, y)) {
+                diagonalInUpperTriangle = diagonalInUpperTriangle && upperCoverage[pixel];
+            }
+        }
+    }
+
+    GE_CHECK(drawnOnce);
+    GE_CHECK(diagonalInUpperTriangle);
+}
+
+void testDepth() {
+    // A quad sloping away to the right, then a flat triangle over the whole image at its
+    // middle depth, which is in front of its right half only
+    auto rasterizer = createRasterizer();
+    ge::SoftwareMesh slope;
+    for (const auto &corner : {glm::vec2(quadMin, quadMin), glm::vec2(quadMax, quadMin),
+                               glm::vec2(quadMax, quadMax), glm::vec2(quadMin, quadMax)}) {
+        auto position = toNdc(corner.x, corner.y, 0.0f);
+        position.z = position.x * 0.5f;
+        slope.vertices.push_back(createVertex(position));
+    }
+    slope.indices = {0, 1, 2, 0, 2, 3};
+    rasterizer.draw(slope, glm::mat4(1.0f));
+    rasterizer.flush();
+
+    const auto &depthBuffer = rasterizer.getDepthBuffer();
+    auto slopeDepthsExpected = true;
+    for (int y = quadMinPixel; y <= quadMaxPixel; ++y) {
+        for (int x = quadMinPixel; x <= quadMaxPixel; ++x) {
+            const auto ndcX = toNdc(x + 0.5f, y + 0.5f, 0.0f).x;
+            const auto expectedDepth = ndcX * 0.25f + 0.5f;
+            slopeDepthsExpected = slopeDepthsExpected &&
+                    std::abs(depthBuffer[static_cast<size_t>(y) * imageSize + x] - expectedDepth) <= depthTolerance;
+        }
+    }
+    GE_CHECK(slopeDepthsExpected);
+
+    const auto slopeDepths = depthBuffer;
+    const auto flatDepth = 0.5f;
+    const auto flat = createTriangle({0.0f, 0.0f}, {2.0f * imageSize, 0.0f}, {0.0f, 2.0f * imageSize},
+                                     flatDepth * 2.0f - 1.0f);
+    rasterizer.draw(flat, glm::mat4(1.0f));
+    rasterizer.flush();
+
+    auto closestDepthsKept = true;
+    for (size_t pixel = 0; pixel < depthBuffer.size(); ++pixel) {
+        const auto expectedDepth = std::min(slopeDepths[pixel], flatDepth);
+        closestDepthsKept = closestDepthsKept && std::abs(depthBuffer[pixel] - expectedDepth) <= depthTolerance;
+    }
+    GE_CHECK(closestDepthsKept);
+}
+
+///
+/// \brief createRandomMesh Creates overlapping triangles across the image, with random
+///                         depths and normals, more than are binned in a single range.
+///
+ge::SoftwareMesh createRandomMesh() {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> coordinate(-1.2f, 1.2f);
+    std::uniform_real_distribution<float> offset(-0.2f, 0.2f);
+    std::uniform_real_distribution<float> depth(-0.9f, 0.9f);
+
+    ge::SoftwareMesh mesh;
+    for (unsigned int i = 0; i < 3 * 10000; i += 3) {
+        const glm::vec3 center(coordinate(generator), coordinate(generator), depth(generator));
+        for (int corner = 0; corner < 3; ++corner) {
+            auto vertex = createVertex(center + glm::vec3(offset(generator), offset(generator), offset(generator)));
+            vertex.normal = glm::normalize(glm::vec3(offset(generator), offset(generator), 0.5f));
+            mesh.vertices.push_back(vertex);
+            mesh.indices.push_back(i + corner);
+        }
+    }
+    return mesh;
+}
+
+void testImageDoesNotDependOnThreads() {
+    const auto mesh = createRandomMesh();
+
+    ge::JobSystem singleWorker(1);
+    ge::JobSystem manyWorkers(8);
+    std::vector<std::vector<unsigned char>> images;
+    std::vector<std::vector<float>> depthBuffers;
+    for (auto jobSystem : {&singleWorker, &manyWorkers}) {
+        auto rasterizer = createRasterizer(*jobSystem);
+        rasterizer.setDirectionalLight(glm::normalize(glm::vec3(1.0f, -1.0f, -2.0f)), glm::vec3(0.8f), glm::vec3(0.0f));
+        rasterizer.draw(mesh, glm::mat4(1.0f));
+        rasterizer.flush();
+
+        images.push_back(rasterizer.readPixels());
+        depthBuffers.push_back(rasterizer.getDepthBuffer());
+    }
+
+    GE_CHECK(images[0] == images[1]);
+    GE_CHECK(depthBuffers[0] == depthBuffers[1]);
+}
+
+} // namespace
+
+int main() {
+    testCoverage();
+    testSharedEdgeIsDrawnOnce();
+    testDepth();
+    testImageDoesNotDependOnThreads();
+
+    return ge_test::numFailures == 0 ? 0 : 1;
+}
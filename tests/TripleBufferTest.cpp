@@ -0,0 +1,76 @@
+#include <chrono>
+#include <thread>
+
+#include <game_engine/TripleBuffer.h>
+
+#include "Check.h"
+
+int ge_test::numFailures = 0;
+
+namespace {
+
+void testPublishDropsUnconsumedValues() {
+    ge::TripleBuffer<int> buffer;
+    GE_CHECK(!buffer.consume());
+
+    for (int i = 1; i <= 3; ++i) {
+        buffer.getWriteBuffer() = i;
+        buffer.publish();
+    }
+
+    GE_CHECK(buffer.consume());
+    GE_CHECK(buffer.getReadBuffer() == 3);
+    GE_CHECK(!buffer.consume());
+}
+
+void testWaitAndPublishDropsNothing() {
+    constexpr int numValues = 1000;
+
+    ge::TripleBuffer<int> buffer;
+    int numConsumed = 0;
+    bool inOrder = true;
+
+    // A slow consumer, like a render thread waiting for vsync
+    std::thread consumer([&buffer, &numConsumed, &inOrder]{
+        while (buffer.waitAndConsume()) {
+            ++numConsumed;
+            inOrder = inOrder && buffer.getReadBuffer() == numConsumed;
+            if (numConsumed == numValues) break;
+
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+    });
+
+    for (int i = 1; i <= numValues; ++i) {
+        buffer.getWriteBuffer() = i;
+        buffer.waitAndPublish();
+    }
+
+    consumer.join();
+    GE_CHECK(numConsumed == numValues);
+    GE_CHECK(inOrder);
+}
+
+void testCloseUnblocksProducer() {
+    ge::TripleBuffer<int> buffer;
+    buffer.waitAndPublish();
+
+    // Nothing consumes the first value, so the second publish waits for close()
+    std::thread producer([&buffer]{buffer.waitAndPublish();});
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    buffer.close();
+    producer.join();
+
+    GE_CHECK(buffer.consume());
+    GE_CHECK(!buffer.waitAndConsume());
+}
+
+} // namespace
+
+int main() {
+    testPublishDropsUnconsumedValues();
+    testWaitAndPublishDropsNothing();
+    testCloseUnblocksProducer();
+
+    return ge_test::numFailures == 0 ? 0 : 1;
+}